@@ -73,6 +73,10 @@ option(ASAN_ENABLED "Build this target with AddressSanitizer" OFF)
 option(BUILD_STATIC_LIBRARY "Build using static libraries" OFF)
 option(SPEED_UP_BUILD_UNITY "Compile using build unity for speed up build" ON)
 option(USE_PRECOMPILED_HEADER "Compile using precompiled header" ON)
+option(FEATURE_TIMING_WHEEL "Use a hierarchical timing wheel for the dispatcher scheduled events" OFF)
+option(FEATURE_ASTAR_BINARY_HEAP "Use a binary heap instead of the vector scan for the A* open list" OFF)
+option(FEATURE_IO_URING "Use io_uring instead of epoll for the network on Linux (requires liburing)" OFF)
+option(DEBUG_TILE_FLAGS "Check the cached tile flags against the tile items on every change" OFF)
 
 # === TOGGLE_BIN_FOLDER ===
 if(TOGGLE_BIN_FOLDER)
@@ -97,6 +101,45 @@ else()
     log_option_disabled("DEBUG LOG")
 endif(DEBUG_LOG)
 
+# === DEBUG_TILE_FLAGS ===
+if(DEBUG_TILE_FLAGS)
+    add_definitions(-DDEBUG_TILE_FLAGS)
+    log_option_enabled("DEBUG_TILE_FLAGS")
+else()
+    log_option_disabled("DEBUG_TILE_FLAGS")
+endif(DEBUG_TILE_FLAGS)
+
+# === FEATURE_TIMING_WHEEL ===
+if(FEATURE_TIMING_WHEEL)
+    add_definitions(-DFEATURE_TIMING_WHEEL)
+    log_option_enabled("FEATURE_TIMING_WHEEL")
+else()
+    log_option_disabled("FEATURE_TIMING_WHEEL")
+endif(FEATURE_TIMING_WHEEL)
+
+# === FEATURE_ASTAR_BINARY_HEAP ===
+if(FEATURE_ASTAR_BINARY_HEAP)
+    add_definitions(-DFEATURE_ASTAR_BINARY_HEAP)
+    log_option_enabled("FEATURE_ASTAR_BINARY_HEAP")
+else()
+    log_option_disabled("FEATURE_ASTAR_BINARY_HEAP")
+endif(FEATURE_ASTAR_BINARY_HEAP)
+
+# === FEATURE_IO_URING ===
+if(FEATURE_IO_URING AND NOT CMAKE_SYSTEM_NAME STREQUAL "Linux")
+    log_war("FEATURE_IO_URING is only supported on Linux, keeping the default reactor")
+    set(FEATURE_IO_URING OFF)
+endif()
+if(FEATURE_IO_URING)
+    # Asio switches its reactor and socket operations to io_uring, completions are reaped in batches
+    find_package(PkgConfig REQUIRED)
+    pkg_check_modules(LIBURING REQUIRED IMPORTED_TARGET liburing)
+    add_definitions(-DASIO_HAS_IO_URING -DASIO_DISABLE_EPOLL)
+    log_option_enabled("FEATURE_IO_URING")
+else()
+    log_option_disabled("FEATURE_IO_URING")
+endif(FEATURE_IO_URING)
+
 # === ASAN ===
 if(ASAN_ENABLED)
     log_option_enabled("asan")
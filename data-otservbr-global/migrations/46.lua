@@ -1,3 +1,26 @@
 function onUpdateDatabase()
-	return false -- true = There are others migrations file | false = this is the last migration file
+	logger.info("Updating database to version 47 (feat: market statistics rollup)")
+
+	db.query([[
+		CREATE TABLE IF NOT EXISTS `market_statistics` (
+			`sale` tinyint(1) NOT NULL DEFAULT '0',
+			`itemtype` int(10) UNSIGNED NOT NULL,
+			`tier` tinyint UNSIGNED NOT NULL DEFAULT '0',
+			`num` int(10) UNSIGNED NOT NULL DEFAULT '0',
+			`min` bigint(20) UNSIGNED NOT NULL DEFAULT '0',
+			`max` bigint(20) UNSIGNED NOT NULL DEFAULT '0',
+			`sum` bigint(20) UNSIGNED NOT NULL DEFAULT '0',
+			CONSTRAINT `market_statistics_pk` PRIMARY KEY (`sale`, `itemtype`, `tier`)
+		) ENGINE=InnoDB DEFAULT CHARSET=utf8;
+	]])
+
+	-- The one full scan of the history, the server keeps the rollup up to date from now on
+	db.query([[
+		INSERT INTO `market_statistics` (`sale`, `itemtype`, `tier`, `num`, `min`, `max`, `sum`)
+		SELECT `sale`, `itemtype`, `tier`, COUNT(`price`), MIN(`price`), MAX(`price`), SUM(`price`)
+		FROM `market_history` WHERE `state` = 3
+		GROUP BY `itemtype`, `sale`, `tier`;
+	]])
+
+	return true
 end
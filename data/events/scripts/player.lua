@@ -588,27 +588,12 @@ function Player:onGainSkillTries(skill, tries)
 		return tries
 	end
 
-	-- Event scheduler skill rate
-	local STAGES_DEFAULT = nil
-	if configManager.getBoolean(configKeys.RATE_USE_STAGES) then
-		STAGES_DEFAULT = skillsStages
-	end
-	local SKILL_DEFAULT = self:getSkillLevel(skill)
-	local RATE_DEFAULT = configManager.getNumber(configKeys.RATE_SKILL)
-
+	-- Skill or magic level stage multiplier with the event scheduler rate
+	local skillOrMagicRate
 	if skill == SKILL_MAGLEVEL then
-		-- Magic Level
-		if configManager.getBoolean(configKeys.RATE_USE_STAGES) then
-			STAGES_DEFAULT = magicLevelStages
-		end
-		SKILL_DEFAULT = self:getBaseMagicLevel()
-		RATE_DEFAULT = configManager.getNumber(configKeys.RATE_MAGIC)
-	end
-
-	local skillOrMagicRate = getRateFromTable(STAGES_DEFAULT, SKILL_DEFAULT, RATE_DEFAULT)
-
-	if SCHEDULE_SKILL_RATE ~= 100 then
-		skillOrMagicRate = math.max(0, (skillOrMagicRate * SCHEDULE_SKILL_RATE) / 100)
+		skillOrMagicRate = EffectiveRates.getMagic(self:getBaseMagicLevel())
+	else
+		skillOrMagicRate = EffectiveRates.getSkill(self:getSkillLevel(skill))
 	end
 
 	if configManager.getBoolean(configKeys.VIP_SYSTEM_ENABLED) then
@@ -0,0 +1,57 @@
+-- Hot getters taking ids instead of userdata.
+-- On LuaJIT they call the engine through the FFI, so the loops using them stay JIT compiled;
+-- elsewhere they fall back to the regular methods with the same results.
+FastPath = {}
+
+local ok, ffi = pcall(require, "ffi")
+if ok and FFI_FAST_PATH_CDEF then
+	ffi.cdef(FFI_FAST_PATH_CDEF)
+	local C = ffi.C
+	local position = ffi.new("uint16_t[3]")
+
+	-- Returns x, y, z or nil when the creature does not exist
+	function FastPath.getCreaturePosition(creatureId)
+		if C.canary_creature_get_position(creatureId, position) == 0 then
+			return nil
+		end
+		return position[0], position[1], position[2]
+	end
+
+	function FastPath.getPlayerStorageValue(playerId, key)
+		return C.canary_player_get_storage_value(playerId, key)
+	end
+
+	-- Takes the uid of Item:getUniqueId, returns 0 when the item does not exist
+	function FastPath.getItemId(uid)
+		return C.canary_item_get_id(uid)
+	end
+
+	-- Returns -1 when there is no tile
+	function FastPath.getTileCreatureCount(x, y, z)
+		return C.canary_tile_get_creature_count(x, y, z)
+	end
+else
+	function FastPath.getCreaturePosition(creatureId)
+		local creature = Creature(creatureId)
+		if not creature then
+			return nil
+		end
+		local pos = creature:getPosition()
+		return pos.x, pos.y, pos.z
+	end
+
+	function FastPath.getPlayerStorageValue(playerId, key)
+		local player = Player(playerId)
+		return player and player:getStorageValue(key) or -1
+	end
+
+	function FastPath.getItemId(uid)
+		local item = Item(uid)
+		return item and item:getId() or 0
+	end
+
+	function FastPath.getTileCreatureCount(x, y, z)
+		local tile = Tile(x, y, z)
+		return tile and tile:getCreatureCount() or -1
+	end
+end
@@ -6,6 +6,7 @@ dofile(CORE_DIRECTORY .. "/libs/functions/combat.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/constants.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/container.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/creature.lua")
+dofile(CORE_DIRECTORY .. "/libs/functions/fast_path.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/fs.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/functions.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/game.lua")
@@ -22,6 +23,7 @@ dofile(CORE_DIRECTORY .. "/libs/functions/position.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/pronouns.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/quests.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/queue.lua")
+dofile(CORE_DIRECTORY .. "/libs/functions/rates.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/revscriptsys.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/set.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/spawn.lua")
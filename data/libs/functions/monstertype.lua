@@ -14,10 +14,13 @@ function MonsterType:generateLootRoll(config, resultTable, player)
 		factor = factor * SCHEDULE_BOSS_LOOT_RATE / 100
 	end
 
+	-- Same roll as getLootRandom, with the loot rate read once for the whole table
+	local lootRate = math.max(1, configManager.getNumber(configKeys.RATE_LOOT) * SCHEDULE_LOOT_RATE * factor)
+
 	local result = resultTable or {}
 	for _, item in ipairs(monsterLoot) do
-		local iType = ItemType(item.itemId)
-		if config.filter and not config.filter(iType, item.unique) then
+		-- The entries carry their item type flags, an ItemType is only built for the filter
+		if config.filter and not config.filter(ItemType(item.itemId), item.unique) then
 			goto continue
 		end
 		if uniqueItems[item.itemId] then
@@ -28,25 +31,24 @@ function MonsterType:generateLootRoll(config, resultTable, player)
 		end
 
 		local chance = item.chance
-		if iType:getId() == SoulWarQuest.bagYouDesireItemId then
+		if item.itemId == SoulWarQuest.bagYouDesireItemId then
 			result[item.itemId].chance = self:calculateBagYouDesireChance(player, chance)
 			logger.debug("Final chance for bag you desire: {}, original chance: {}", result[item.itemId].chance, chance)
 		end
 
-		if config.gut and iType:getType() == ITEM_TYPE_CREATUREPRODUCT then
+		if config.gut and item.creatureProduct then
 			chance = math.ceil((chance * GLOBAL_CHARM_GUT) / 100)
 		end
 
-		local randValue = getLootRandom(factor)
+		local randValue = math.random(0, MAX_LOOTCHANCE) * 100 / lootRate
 		if randValue >= chance then
 			goto continue
 		end
 
 		local count = 0
-		local charges = iType:getCharges()
-		if charges > 0 then
-			count = charges
-		elseif iType:isStackable() then
+		if item.charges > 0 then
+			count = item.charges
+		elseif item.stackable then
 			local maxc, minc = item.maxCount or 1, item.minCount or 1
 			count = math.max(0, randValue % (maxc - minc + 1)) + minc
 		else
@@ -54,7 +56,7 @@ function MonsterType:generateLootRoll(config, resultTable, player)
 		end
 
 		result[item.itemId].count = result[item.itemId].count + count
-		result[item.itemId].gut = config.gut and iType:getType() == ITEM_TYPE_CREATUREPRODUCT
+		result[item.itemId].gut = config.gut and item.creatureProduct
 		result[item.itemId].unique = item.unique
 		result[item.itemId].subType = item.subType
 		result[item.itemId].text = item.text
@@ -405,19 +405,8 @@ function Player:dispellFamiliar()
 end
 
 function Player.getFinalBaseRateExperience(self)
-	-- Experience Stage Multiplier
-	local baseRate
-	local rateExperience = configManager.getNumber(configKeys.RATE_EXPERIENCE)
-	if configManager.getBoolean(configKeys.RATE_USE_STAGES) then
-		baseRate = getRateFromTable(experienceStages, self:getLevel(), rateExperience)
-	else
-		baseRate = rateExperience
-	end
-	-- Event scheduler
-	if SCHEDULE_EXP_RATE ~= 100 then
-		baseRate = math.max(0, (baseRate * SCHEDULE_EXP_RATE) / 100)
-	end
-	return baseRate
+	-- Experience stage multiplier with the event scheduler rate
+	return EffectiveRates.getExperience(self:getLevel())
 end
 
 function Player.getFinalBonusStamina(self)
@@ -0,0 +1,75 @@
+-- Effective experience, skill and magic level rates, the stages of stages.lua combined with the
+-- rates of config.lua and of the active events. Each kill and skill try only indexes the current
+-- snapshot, which is rebuilt when the config is reloaded or the event rates change.
+EffectiveRates = {}
+
+local snapshot = nil
+
+local function buildSnapshot(revision)
+	local useStages = configManager.getBoolean(configKeys.RATE_USE_STAGES)
+	return {
+		revision = revision,
+		expSchedule = SCHEDULE_EXP_RATE,
+		skillSchedule = SCHEDULE_SKILL_RATE,
+		experienceStages = useStages and experienceStages or nil,
+		skillsStages = useStages and skillsStages or nil,
+		magicLevelStages = useStages and magicLevelStages or nil,
+		rateExperience = configManager.getNumber(configKeys.RATE_EXPERIENCE),
+		rateSkill = configManager.getNumber(configKeys.RATE_SKILL),
+		rateMagic = configManager.getNumber(configKeys.RATE_MAGIC),
+		-- Filled by level as they are asked for, a snapshot is never changed otherwise
+		experience = {},
+		skill = {},
+		magic = {},
+	}
+end
+
+local function getSnapshot()
+	local revision = configManager.getRevision()
+	if not snapshot or snapshot.revision ~= revision or snapshot.expSchedule ~= SCHEDULE_EXP_RATE or snapshot.skillSchedule ~= SCHEDULE_SKILL_RATE then
+		snapshot = buildSnapshot(revision)
+	end
+	return snapshot
+end
+
+local function applySchedule(rate, schedule)
+	if schedule ~= 100 then
+		return math.max(0, (rate * schedule) / 100)
+	end
+	return rate
+end
+
+-- Drops the current snapshot, for the callers that change the stages tables at runtime
+function EffectiveRates.invalidate()
+	snapshot = nil
+end
+
+function EffectiveRates.getExperience(level)
+	local rates = getSnapshot()
+	local rate = rates.experience[level]
+	if not rate then
+		rate = applySchedule(getRateFromTable(rates.experienceStages, level, rates.rateExperience), rates.expSchedule)
+		rates.experience[level] = rate
+	end
+	return rate
+end
+
+function EffectiveRates.getSkill(skillLevel)
+	local rates = getSnapshot()
+	local rate = rates.skill[skillLevel]
+	if not rate then
+		rate = applySchedule(getRateFromTable(rates.skillsStages, skillLevel, rates.rateSkill), rates.skillSchedule)
+		rates.skill[skillLevel] = rate
+	end
+	return rate
+end
+
+function EffectiveRates.getMagic(magicLevel)
+	local rates = getSnapshot()
+	local rate = rates.magic[magicLevel]
+	if not rate then
+		rate = applySchedule(getRateFromTable(rates.magicLevelStages, magicLevel, rates.rateMagic), rates.skillSchedule)
+		rates.magic[magicLevel] = rate
+	end
+	return rate
+end
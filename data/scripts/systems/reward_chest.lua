@@ -63,19 +63,16 @@ function bossDeath.onDeath(creature, corpse, killer, mostDamageKiller, lastHitUn
 		end)
 
 		local expectedScore = 1 / participants
+		local isBoostedBoss = creature:getName():lower() == (Game.getBoostedBoss()):lower()
 
 		for _, con in ipairs(scores) do
 			-- Ignoring stamina for now because I heard you get receive rewards even when it's depleted
-			if con.score ~= 0 then
-				local reward, stamina, player
-				if con.player then
-					player = con.player
-				else
-					player = Game.getOfflinePlayer(con.guid)
-				end
-				reward = player:getReward(rewardId, true)
-				stamina = player:getStamina()
-
+			local player = con.player
+			if con.score ~= 0 and not player then
+				-- Only read to roll the loot, the bag is written straight to the database below
+				player = Game.getOfflinePlayer(con.guid)
+			end
+			if con.score ~= 0 and player then
 				local lootFactor = 1
 				-- Tone down the loot a notch if there are many participants
 				lootFactor = lootFactor / participants ^ (1 / 3)
@@ -83,7 +80,6 @@ function bossDeath.onDeath(creature, corpse, killer, mostDamageKiller, lastHitUn
 				lootFactor = lootFactor * (1 + lootFactor) ^ (con.score / expectedScore)
 				-- Bosstiary Loot Bonus
 				local rolls = 1
-				local isBoostedBoss = creature:getName():lower() == (Game.getBoostedBoss()):lower()
 				local bossRaceIds = { player:getSlotBossId(1), player:getSlotBossId(2) }
 				local isBoss = table.contains(bossRaceIds, monsterType:raceId()) or isBoostedBoss
 				if isBoss and monsterType:raceId() ~= 0 then
@@ -108,20 +104,22 @@ function bossDeath.onDeath(creature, corpse, killer, mostDamageKiller, lastHitUn
 					playerLoot = monsterType:getBossReward(lootFactor, false, true, playerLoot, player)
 				end
 
-				-- Add droped items to reward container
-				reward:addRewardBossItems(playerLoot)
-
 				if con.player then
+					-- Add droped items to reward container
+					local reward = player:getReward(rewardId, true)
+					reward:addRewardBossItems(playerLoot)
+
 					local lootMessage = ("The following items dropped by %s are available in your reward chest: %s"):format(creature:getName(), reward:getContentDescription())
 					if rolls > 1 then
 						lootMessage = lootMessage .. " (boss bonus)"
 					end
-					if stamina > 840 then
+					if player:getStamina() > 840 then
 						reward:getContentDescription(lootMessage)
 					end
 					player:sendTextMessage(MESSAGE_LOOT, lootMessage)
 				else
-					player:save()
+					-- Appends the bag to the player's rewards instead of saving the whole offline player
+					InsertRewardItems(con.guid, rewardId, playerLoot)
 				end
 			end
 		end
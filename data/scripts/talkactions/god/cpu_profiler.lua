@@ -0,0 +1,43 @@
+local cpuProfiler = TalkAction("/cpuprofiler")
+
+function cpuProfiler.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	local params = param:split(",")
+	local action = params[1] and params[1]:trim():lower() or ""
+	local argument = params[2] and params[2]:trim() or nil
+
+	if action == "start" then
+		local frequency = tonumber(argument) or 100
+		if Game.startSamplingProfiler(frequency) then
+			player:sendTextMessage(MESSAGE_ADMINISTRATOR, "CPU profiler started, " .. frequency .. " samples per second.")
+		else
+			player:sendTextMessage(MESSAGE_ADMINISTRATOR, "The CPU profiler is not available on this platform.")
+		end
+	elseif action == "stop" then
+		Game.stopSamplingProfiler()
+		local samples, dropped = Game.getSamplingProfilerSamples()
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "CPU profiler stopped, " .. samples .. " samples taken, " .. dropped .. " dropped.")
+	elseif action == "reset" then
+		if Game.resetSamplingProfiler() then
+			player:sendTextMessage(MESSAGE_ADMINISTRATOR, "CPU profiler samples cleared.")
+		else
+			player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Stop the CPU profiler before clearing its samples.")
+		end
+	elseif action == "dump" then
+		local path = argument or "cpu_profile.folded"
+		if Game.dumpSamplingProfiler(path) then
+			player:sendTextMessage(MESSAGE_ADMINISTRATOR, "CPU profiler samples written to " .. path .. ".")
+		else
+			player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Could not write the CPU profiler samples to " .. path .. ".")
+		end
+	else
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Usage: /cpuprofiler start[, frequency], stop, reset or dump[, file]")
+	end
+	return true
+end
+
+cpuProfiler:separator(" ")
+cpuProfiler:groupType("god")
+cpuProfiler:register()
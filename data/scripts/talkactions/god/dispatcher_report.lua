@@ -0,0 +1,23 @@
+local dispatcherReport = TalkAction("/dispatcher")
+
+function dispatcherReport.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	local params = param:split(",")
+	local action = params[1] and params[1]:trim():lower() or ""
+	local argument = params[2] and params[2]:trim() or nil
+
+	if action == "report" then
+		local report = Game.getDispatcherReport(tonumber(argument) or 0)
+		logger.info("[FlightRecorder] - Report:\n{}", report)
+		player:showTextDialog(2019, report)
+	else
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Usage: /dispatcher report[, cycles]")
+	end
+	return true
+end
+
+dispatcherReport:separator(" ")
+dispatcherReport:groupType("god")
+dispatcherReport:register()
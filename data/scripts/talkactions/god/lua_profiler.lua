@@ -0,0 +1,39 @@
+local luaProfiler = TalkAction("/luaprofiler")
+
+function luaProfiler.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	local params = param:split(",")
+	local action = params[1] and params[1]:trim():lower() or ""
+	local argument = params[2] and params[2]:trim() or nil
+
+	if action == "start" then
+		Game.startLuaProfiler()
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Lua profiler started.")
+	elseif action == "stop" then
+		Game.stopLuaProfiler()
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Lua profiler stopped.")
+	elseif action == "reset" then
+		Game.resetLuaProfiler()
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Lua profiler samples cleared.")
+	elseif action == "report" then
+		local report = Game.getLuaProfilerReport(tonumber(argument) or 20)
+		logger.info("[LuaProfiler] - Report:\n{}", report)
+		player:showTextDialog(2019, report)
+	elseif action == "dump" then
+		local path = argument or "lua_profile.folded"
+		if Game.dumpLuaProfiler(path) then
+			player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Lua profiler samples written to " .. path .. ".")
+		else
+			player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Could not write the Lua profiler samples to " .. path .. ".")
+		end
+	else
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Usage: /luaprofiler start, stop, reset, report[, lines] or dump[, file]")
+	end
+	return true
+end
+
+luaProfiler:separator(" ")
+luaProfiler:groupType("god")
+luaProfiler:register()
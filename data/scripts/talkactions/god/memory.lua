@@ -0,0 +1,15 @@
+local memory = TalkAction("/memory")
+
+function memory.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	local report = Game.getMemoryReport()
+	logger.info("[MemoryAccounting] - Report:\n{}", report)
+	player:showTextDialog(2019, report)
+	return true
+end
+
+memory:separator(" ")
+memory:groupType("god")
+memory:register()
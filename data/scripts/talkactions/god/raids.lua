@@ -102,3 +102,17 @@ end
 listRaid:separator(" ")
 listRaid:groupType("god")
 listRaid:register()
+
+local raidSchedule = TalkAction("/raidschedule")
+
+function raidSchedule.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	player:showTextDialog(2019, Game.getRaidSchedule())
+	return true
+end
+
+raidSchedule:separator(" ")
+raidSchedule:groupType("god")
+raidSchedule:register()
@@ -0,0 +1,19 @@
+local traffic = TalkAction("/traffic")
+
+function traffic.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	local params = param:split(",")
+	local target = params[1] and params[1]:trim() or ""
+	local limit = params[2] and tonumber(params[2]:trim()) or 20
+
+	local report = Game.getTrafficReport(target, limit)
+	logger.info("[Traffic] - Report:\n{}", report)
+	player:showTextDialog(2019, report)
+	return true
+end
+
+traffic:separator(" ")
+traffic:groupType("god")
+traffic:register()
@@ -7,7 +7,7 @@ CREATE TABLE IF NOT EXISTS `server_config` (
     CONSTRAINT `server_config_pk` PRIMARY KEY (`config`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8;
 
-INSERT INTO `server_config` (`config`, `value`) VALUES ('db_version', '46'), ('motd_hash', ''), ('motd_num', '0'), ('players_record', '0');
+INSERT INTO `server_config` (`config`, `value`) VALUES ('db_version', '47'), ('motd_hash', ''), ('motd_num', '0'), ('players_record', '0');
 
 -- Table structure `accounts`
 CREATE TABLE IF NOT EXISTS `accounts` (
@@ -539,6 +539,18 @@ CREATE TABLE IF NOT EXISTS `market_offers` (
         ON DELETE CASCADE
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8;
 
+-- Table structure `market_statistics`
+CREATE TABLE IF NOT EXISTS `market_statistics` (
+    `sale` tinyint(1) NOT NULL DEFAULT '0',
+    `itemtype` int(10) UNSIGNED NOT NULL,
+    `tier` tinyint UNSIGNED NOT NULL DEFAULT '0',
+    `num` int(10) UNSIGNED NOT NULL DEFAULT '0',
+    `min` bigint(20) UNSIGNED NOT NULL DEFAULT '0',
+    `max` bigint(20) UNSIGNED NOT NULL DEFAULT '0',
+    `sum` bigint(20) UNSIGNED NOT NULL DEFAULT '0',
+    CONSTRAINT `market_statistics_pk` PRIMARY KEY (`sale`, `itemtype`, `tier`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8;
+
 -- Table structure `players_online`
 CREATE TABLE IF NOT EXISTS `players_online` (
     `player_id` int(11) NOT NULL,
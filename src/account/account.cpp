@@ -38,6 +38,9 @@ Account::Account(std::string descriptor) :
 	m_account.accountType = ACCOUNT_TYPE_NORMAL;
 }
 
+std::mutex Account::verifiedPasswordsMutex;
+phmap::flat_hash_map<uint32_t, Account::VerifiedPassword> Account::verifiedPasswords;
+
 uint8_t Account::load() {
 	if (m_account.id != 0 && g_accountRepository().loadByID(m_account.id, m_account)) {
 		m_accLoaded = true;
@@ -280,18 +283,49 @@ bool Account::authenticateSession() {
 }
 
 bool Account::authenticatePassword(const std::string &password) {
-	if (Argon2 {}.argon(password.c_str(), getPassword())) {
+	const auto storedPassword = getPassword();
+	const auto cacheDuration = static_cast<int64_t>(g_configManager().getNumber(AUTH_CACHE_DURATION, __FUNCTION__)) * 1000;
+	// Salted with the stored hash, a changed password never matches the remembered one
+	const auto digest = cacheDuration > 0 ? transformToSHA1(storedPassword + password) : std::string();
+	if (cacheDuration > 0 && isPasswordVerified(digest)) {
 		return true;
 	}
 
-	if (transformToSHA1(password) == getPassword()) {
+	if (Argon2 {}.argon(password.c_str(), storedPassword) || transformToSHA1(password) == storedPassword) {
+		if (cacheDuration > 0) {
+			setPasswordVerified(digest, cacheDuration);
+		}
 		return true;
 	}
 
-	g_logger().error("Password '{}' doesn't match any account", getPassword());
+	g_logger().error("Password '{}' doesn't match any account", storedPassword);
 	return false;
 }
 
+bool Account::isPasswordVerified(const std::string &digest) const {
+	std::scoped_lock lock(verifiedPasswordsMutex);
+	const auto it = verifiedPasswords.find(m_account.id);
+	if (it == verifiedPasswords.end()) {
+		return false;
+	}
+	if (it->second.expiresAt < OTSYS_TIME()) {
+		verifiedPasswords.erase(it);
+		return false;
+	}
+	return it->second.digest == digest;
+}
+
+void Account::setPasswordVerified(const std::string &digest, int64_t duration) const {
+	std::scoped_lock lock(verifiedPasswordsMutex);
+	const auto now = OTSYS_TIME();
+	if (verifiedPasswords.size() >= 4096) {
+		phmap::erase_if(verifiedPasswords, [now](const auto &entry) {
+			return entry.second.expiresAt < now;
+		});
+	}
+	verifiedPasswords[m_account.id] = { digest, now + duration };
+}
+
 uint32_t Account::getAccountAgeInDays() const {
 	return static_cast<uint32_t>(std::ceil((getTimeNow() - m_account.creationTime) / 86400));
 }
@@ -125,6 +125,18 @@ public:
 	bool authenticatePassword(const std::string &password);
 
 private:
+	// Passwords verified in the last authCacheDuration, shared by every Account of the process
+	struct VerifiedPassword {
+		std::string digest;
+		int64_t expiresAt = 0;
+	};
+
+	bool isPasswordVerified(const std::string &digest) const;
+	void setPasswordVerified(const std::string &digest, int64_t duration) const;
+
+	static std::mutex verifiedPasswordsMutex;
+	static phmap::flat_hash_map<uint32_t, VerifiedPassword> verifiedPasswords;
+
 	std::string m_descriptor;
 	AccountInfo m_account;
 	bool m_accLoaded = false;
@@ -15,10 +15,13 @@
 #include "creatures/players/grouping/familiars.hpp"
 #include "creatures/players/storages/storages.hpp"
 #include "database/databasemanager.hpp"
+#include "database/databasetasks.hpp"
 #include "game/game.hpp"
 #include "game/zones/zone.hpp"
+#include "game/highscores/highscores.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/events_scheduler.hpp"
+#include "io/iojournal.hpp"
 #include "io/iomarket.hpp"
 #include "lib/thread/thread_pool.hpp"
 #include "lua/creature/events.hpp"
@@ -28,6 +31,7 @@
 #include "server/network/protocol/protocollogin.hpp"
 #include "server/network/protocol/protocolstatus.hpp"
 #include "server/network/webhook/webhook.hpp"
+#include "server/startup_graph.hpp"
 #include "io/ioprey.hpp"
 #include "io/io_bosstiary.hpp"
 
@@ -59,6 +63,11 @@ int CanaryServer::run() {
 		[this] {
 			try {
 				loadConfigLua();
+				inject<ThreadPool>().applyAffinity();
+				if (const auto randomSeed = g_configManager().getNumber(RANDOM_SEED, __FUNCTION__); randomSeed != 0) {
+					seedRandomGenerators(static_cast<uint64_t>(randomSeed));
+					logger.warn("Random rolls seeded with {}, they repeat on every run", randomSeed);
+				}
 
 				logger.info("Server protocol: {}.{}{}", CLIENT_VERSION_UPPER, CLIENT_VERSION_LOWER, g_configManager().getBoolean(OLD_PROTOCOL, __FUNCTION__) ? " and 10x allowed!" : "");
 #ifdef FEATURE_METRICS
@@ -74,10 +83,18 @@ int CanaryServer::run() {
 				g_metrics().init(metricsOptions);
 #endif
 				rsa.start();
-				initializeDatabase();
-				loadModules();
 				setWorldType();
-				loadMaps();
+
+				StartupGraph startup;
+				addModulePhases(startup);
+				addMapPhases(startup);
+				startup.run(g_configManager().getBoolean(PARALLEL_STARTUP, __FUNCTION__));
+				logger.info(startup.getReport());
+
+				IOMarket::getInstance().loadOffers();
+				if (g_configManager().getBoolean(HIGHSCORES_IN_MEMORY, __FUNCTION__)) {
+					g_highscores().load();
+				}
 
 				logger.info("Initializing gamestate...");
 				g_game().setGameState(GAME_STATE_INIT);
@@ -162,18 +179,28 @@ void CanaryServer::setWorldType() {
 	logger.debug("World type set as {}", asUpperCaseString(worldType));
 }
 
-void CanaryServer::loadMaps() const {
-	try {
-		g_game().loadMainMap(g_configManager().getString(MAP_NAME, __FUNCTION__));
-
-		// If "mapCustomEnabled" is true on config.lua, then load the custom map
-		if (g_configManager().getBoolean(TOGGLE_MAP_CUSTOM, __FUNCTION__)) {
-			g_game().loadCustomMaps(g_configManager().getString(DATA_DIRECTORY, __FUNCTION__) + "/world/custom/");
+void CanaryServer::addMapPhases(StartupGraph &startup) const {
+	// The tiles only need the items, the spawns need the monsters and npcs
+	startup.add("map file", { "items" }, StartupGraph::Thread::Background, [] {
+		try {
+			g_game().loadMainMapFile(g_configManager().getString(MAP_NAME, __FUNCTION__));
+		} catch (const std::exception &err) {
+			throw FailedToInitializeCanary(err.what());
 		}
-		Zone::refreshAll();
-	} catch (const std::exception &err) {
-		throw FailedToInitializeCanary(err.what());
-	}
+	});
+	startup.add("map data", { "map file", "npcs" }, StartupGraph::Thread::Dispatcher, [] {
+		try {
+			g_game().loadMainMapData();
+
+			// If "mapCustomEnabled" is true on config.lua, then load the custom map
+			if (g_configManager().getBoolean(TOGGLE_MAP_CUSTOM, __FUNCTION__)) {
+				g_game().loadCustomMaps(g_configManager().getString(DATA_DIRECTORY, __FUNCTION__) + "/world/custom/");
+			}
+			Zone::refreshAll();
+		} catch (const std::exception &err) {
+			throw FailedToInitializeCanary(err.what());
+		}
+	});
 }
 
 void CanaryServer::setupHousesRent() {
@@ -308,22 +335,34 @@ void CanaryServer::initializeDatabase() {
 	logger.debug("MySQL Version: {}", Database::getClientVersion());
 
 	logger.debug("Running database manager...");
-	if (!DatabaseManager::isDatabaseSetup()) {
+	const auto schema = DatabaseManager::getSchemaState();
+	if (schema.tables == 0) {
 		throw FailedToInitializeCanary(fmt::format(
 			"The database you have specified in {} is empty, please import the schema.sql to your database.",
 			g_configManager().getConfigFileLua()
 		));
 	}
 
-	DatabaseManager::updateDatabase();
+	DatabaseManager::updateDatabase(schema);
+
+	// Replays what a crash left in the journal before anything reads the tables
+	if (const auto &journalFile = g_configManager().getString(SAVE_JOURNAL_FILE, __FUNCTION__); !journalFile.empty()) {
+		if (!g_configManager().getBoolean(TOGGLE_SAVE_ASYNC, __FUNCTION__)) {
+			logger.warn("The save journal needs toggleSaveAsync, it stays disabled");
+		} else if (!g_ioJournal().open(journalFile)) {
+			throw FailedToInitializeCanary(fmt::format("Failed to open the save journal {}!", journalFile));
+		}
+	}
 
 	if (g_configManager().getBoolean(OPTIMIZE_DATABASE, __FUNCTION__)
 	    && !DatabaseManager::optimizeTables()) {
 		logger.debug("No tables were optimized");
 	}
+
+	g_databaseTasks().init();
 }
 
-void CanaryServer::loadModules() {
+void CanaryServer::addModulePhases(StartupGraph &startup) {
 	// If "USE_ANY_DATAPACK_FOLDER" is set to true then you can choose any datapack folder for your server
 	const auto useAnyDatapack = g_configManager().getBoolean(USE_ANY_DATAPACK_FOLDER, __FUNCTION__);
 	auto datapackName = g_configManager().getString(DATA_DIRECTORY, __FUNCTION__);
@@ -336,48 +375,65 @@ void CanaryServer::loadModules() {
 		));
 	}
 
-	logger.debug("Initializing lua environment...");
-	if (!g_luaEnvironment().getLuaState()) {
-		g_luaEnvironment().initState();
-	}
+	const auto coreFolder = g_configManager().getString(CORE_DIRECTORY, __FUNCTION__);
+	const auto datapackFolder = g_configManager().getString(DATA_DIRECTORY, __FUNCTION__);
 
-	auto coreFolder = g_configManager().getString(CORE_DIRECTORY, __FUNCTION__);
-	// Load appearances.dat first
-	modulesLoadHelper((g_game().loadAppearanceProtobuf(coreFolder + "/items/appearances.dat") == ERROR_NONE), "appearances.dat");
+	startup.add("database", {}, StartupGraph::Thread::Background, [this] { initializeDatabase(); });
+	// The migrations use the script environment of the main state
+	startup.add("lua", { "database" }, StartupGraph::Thread::Dispatcher, [this] {
+		logger.debug("Initializing lua environment...");
+		if (!g_luaEnvironment().getLuaState()) {
+			g_luaEnvironment().initState();
+		}
+	});
 
+	// Load appearances.dat first
+	startup.add("appearances", {}, StartupGraph::Thread::Background, [this, coreFolder] {
+		modulesLoadHelper((g_game().loadAppearanceProtobuf(coreFolder + "/items/appearances.dat") == ERROR_NONE), "appearances.dat");
+	});
 	// Load XML folder dependencies (order matters)
-	modulesLoadHelper(g_vocations().loadFromXml(), "XML/vocations.xml");
-	modulesLoadHelper(g_eventsScheduler().loadScheduleEventFromXml(), "XML/events.xml");
-	modulesLoadHelper(Outfits::getInstance().loadFromXml(), "XML/outfits.xml");
-	modulesLoadHelper(Familiars::getInstance().loadFromXml(), "XML/familiars.xml");
-	modulesLoadHelper(g_imbuements().loadFromXml(), "XML/imbuements.xml");
-	modulesLoadHelper(g_storages().loadFromXML(), "XML/storages.xml");
-
-	modulesLoadHelper(Item::items.loadFromXml(), "items.xml");
-
-	const auto datapackFolder = g_configManager().getString(DATA_DIRECTORY, __FUNCTION__);
-	logger.debug("Loading core scripts on folder: {}/", coreFolder);
-	// Load first core Lua libs
-	modulesLoadHelper((g_luaEnvironment().loadFile(coreFolder + "/core.lua", "core.lua") == 0), "core.lua");
-	modulesLoadHelper(g_scripts().loadScripts(coreFolder + "/scripts/lib", true, false), coreFolder + "/scripts/libs");
-	modulesLoadHelper(g_scripts().loadScripts(coreFolder + "/scripts", false, false), coreFolder + "/scripts");
-	modulesLoadHelper((g_npcs().load(true, false)), "npclib");
-
-	modulesLoadHelper(g_events().loadFromXml(), "events/events.xml");
-	modulesLoadHelper(g_modules().loadFromXml(), "modules/modules.xml");
-
-	logger.debug("Loading datapack scripts on folder: {}/", datapackName);
-	modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/scripts/lib", true, false), datapackFolder + "/scripts/libs");
-	// Load scripts
-	modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/scripts", false, false), datapackFolder + "/scripts");
+	startup.add("xml", { "appearances" }, StartupGraph::Thread::Background, [this] {
+		modulesLoadHelper(g_vocations().loadFromXml(), "XML/vocations.xml");
+		modulesLoadHelper(g_eventsScheduler().loadScheduleEventFromXml(), "XML/events.xml");
+		modulesLoadHelper(Outfits::getInstance().loadFromXml(), "XML/outfits.xml");
+		modulesLoadHelper(Familiars::getInstance().loadFromXml(), "XML/familiars.xml");
+		modulesLoadHelper(g_imbuements().loadFromXml(), "XML/imbuements.xml");
+		modulesLoadHelper(g_storages().loadFromXML(), "XML/storages.xml");
+	});
+	startup.add("items", { "xml" }, StartupGraph::Thread::Background, [this] {
+		modulesLoadHelper(Item::items.loadFromXml(), "items.xml");
+	});
+
+	startup.add("core scripts", { "lua", "items" }, StartupGraph::Thread::Dispatcher, [this, coreFolder] {
+		logger.debug("Loading core scripts on folder: {}/", coreFolder);
+		// Load first core Lua libs
+		modulesLoadHelper((g_luaEnvironment().loadFile(coreFolder + "/core.lua", "core.lua") == 0), "core.lua");
+		modulesLoadHelper(g_scripts().loadScripts(coreFolder + "/scripts/lib", true, false), coreFolder + "/scripts/libs");
+		modulesLoadHelper(g_scripts().loadScripts(coreFolder + "/scripts", false, false), coreFolder + "/scripts");
+		modulesLoadHelper((g_npcs().load(true, false)), "npclib");
+
+		modulesLoadHelper(g_events().loadFromXml(), "events/events.xml");
+		modulesLoadHelper(g_modules().loadFromXml(), "modules/modules.xml");
+	});
+
+	startup.add("datapack scripts", { "core scripts" }, StartupGraph::Thread::Dispatcher, [this, datapackName, datapackFolder] {
+		logger.debug("Loading datapack scripts on folder: {}/", datapackName);
+		modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/scripts/lib", true, false), datapackFolder + "/scripts/libs");
+		// Load scripts
+		modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/scripts", false, false), datapackFolder + "/scripts");
+	});
 	// Load monsters
-	modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/monster", false, false), datapackFolder + "/monster");
-	modulesLoadHelper((g_npcs().load(false, true)), "npc");
-
-	g_game().loadBoostedCreature();
-	g_ioBosstiary().loadBoostedBoss();
-	g_ioprey().initializeTaskHuntOptions();
-	g_game().logCyclopediaStats();
+	startup.add("monsters", { "datapack scripts" }, StartupGraph::Thread::Dispatcher, [this, datapackFolder] {
+		modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/monster", false, false), datapackFolder + "/monster");
+	});
+	startup.add("npcs", { "monsters" }, StartupGraph::Thread::Dispatcher, [this] {
+		modulesLoadHelper((g_npcs().load(false, true)), "npc");
+
+		g_game().loadBoostedCreature();
+		g_ioBosstiary().loadBoostedBoss();
+		g_ioprey().initializeTaskHuntOptions();
+		g_game().logCyclopediaStats();
+	});
 }
 
 void CanaryServer::modulesLoadHelper(bool loaded, std::string moduleName) {
@@ -389,6 +445,7 @@ void CanaryServer::modulesLoadHelper(bool loaded, std::string moduleName) {
 
 void CanaryServer::shutdown() {
 	g_dispatcher().shutdown();
+	g_databaseTasks().shutdown();
 	g_metrics().shutdown();
 	inject<ThreadPool>().shutdown();
 	std::exit(0);
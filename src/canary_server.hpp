@@ -13,6 +13,7 @@
 #include "server/server.hpp"
 
 class Logger;
+class StartupGraph;
 
 class FailedToInitializeCanary : public std::exception {
 private:
@@ -62,9 +63,9 @@ private:
 
 	void loadConfigLua();
 	void initializeDatabase();
-	void loadModules();
+	void addModulePhases(StartupGraph &startup);
 	void setWorldType();
-	void loadMaps() const;
+	void addMapPhases(StartupGraph &startup) const;
 	void setupHousesRent();
 	void modulesLoadHelper(bool loaded, std::string moduleName);
 };
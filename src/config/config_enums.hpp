@@ -12,6 +12,9 @@
 // Enum
 enum ConfigKey_t : uint16_t {
 	ACTIONS_DELAY_INTERVAL,
+	ADMIN_HTTP_ADDRESS,
+	ADMIN_HTTP_PORT,
+	ADMIN_HTTP_TOKEN,
 	ADVENTURERSBLESSING_LEVEL,
 	AIMBOT_HOTKEY_ENABLED,
 	ALLOW_CHANGEOUTFIT,
@@ -19,9 +22,11 @@ enum ConfigKey_t : uint16_t {
 	AUGMENT_INCREASED_DAMAGE_PERCENT,
 	AUGMENT_POWERFUL_IMPACT_PERCENT,
 	AUGMENT_STRONG_IMPACT_PERCENT,
+	AUTH_CACHE_DURATION,
 	AUTH_TYPE,
 	AUTOBANK,
 	AUTOLOOT,
+	AUTOSEND_FLUSH_SIZE,
 	BESTIARY_KILL_MULTIPLIER,
 	BESTIARY_RATE_CHARM_SHOP_PRICE,
 	BIND_ONLY_GLOBAL_ADDRESS,
@@ -34,7 +39,9 @@ enum ConfigKey_t : uint16_t {
 	BOSSTIARY_KILL_MULTIPLIER,
 	BUY_AOL_COMMAND_FEE,
 	BUY_BLESS_COMMAND_FEE,
+	CACHE_SPELL_FORMULA_VALUES,
 	CHECK_EXPIRED_MARKET_OFFERS_EACH_MINUTES,
+	COALESCE_PLAYER_STATS,
 	CLASSIC_ATTACK_SPEED,
 	CLEAN_PROTECTION_ZONES,
 	COMBAT_CHAIN_DELAY,
@@ -43,16 +50,22 @@ enum ConfigKey_t : uint16_t {
 	COMBAT_CHAIN_SKILL_FORMULA_SWORD,
 	COMBAT_CHAIN_TARGETS,
 	COMPRESSION_LEVEL,
+	COMPRESSION_MAX_RATIO,
+	COMPRESSION_MIN_SIZE,
+	COMPRESSION_STREAMING,
 	CONVERT_UNSAFE_SCRIPTS,
 	CORE_DIRECTORY,
 	CRITICALCHANCE,
 	DATA_DIRECTORY,
+	DATABASE_COALESCE_WINDOW,
+	DATABASE_WORKERS,
 	DAY_KILLS_TO_RED,
 	DEATH_LOSE_PERCENT,
 	DEFAULT_RESPAWN_TIME,
 	DEFAULT_DESPAWNRADIUS,
 	DEFAULT_DESPAWNRANGE,
 	DEFAULT_PRIORITY,
+	DEFER_MONSTER_MOVE_EVENTS,
 	DEPOT_BOXES,
 	DEPOTCHEST,
 	DISABLE_LEGACY_RAIDS,
@@ -60,6 +73,9 @@ enum ConfigKey_t : uint16_t {
 	DISCORD_SEND_FOOTER,
 	DISCORD_WEBHOOK_DELAY_MS,
 	DISCORD_WEBHOOK_URL,
+	DISPATCHER_CPUS,
+	DISPATCHER_LATENCY_TARGET,
+	DISPATCHER_SLOW_CYCLE_THRESHOLD,
 	EMOTE_SPELLS,
 	ENABLE_PLAYER_PUT_ITEM_IN_AMMO_SLOT,
 	ENABLE_SUPPORT_OUTFIT,
@@ -91,6 +107,7 @@ enum ConfigKey_t : uint16_t {
 	FREE_PREMIUM,
 	FREE_QUEST_STAGE,
 	GAME_PORT,
+	GAME_SNAPSHOT_INTERVAL,
 	GLOBAL_SERVER_SAVE_CLEAN_MAP,
 	GLOBAL_SERVER_SAVE_CLOSE,
 	GLOBAL_SERVER_SAVE_NOTIFY_DURATION,
@@ -110,6 +127,7 @@ enum ConfigKey_t : uint16_t {
 	HAZARD_PODS_TIME_TO_DAMAGE,
 	HAZARD_PODS_TIME_TO_SPAWN,
 	HAZARD_SPAWN_PLUNDER_MULTIPLIER,
+	HIGHSCORES_IN_MEMORY,
 	HOUSE_BUY_LEVEL,
 	HOUSE_LOSE_AFTER_INACTIVITY,
 	HOUSE_OWNED_BY_ACCOUNT,
@@ -121,6 +139,8 @@ enum ConfigKey_t : uint16_t {
 	INVENTORY_GLOW,
 	IP,
 	KICK_AFTER_MINUTES,
+	KV_WRITE_BEHIND_INTERVAL,
+	LAZY_DEPOT_LOADING,
 	LOCATION,
 	LOGIN_PORT,
 	LOGLEVEL,
@@ -131,11 +151,19 @@ enum ConfigKey_t : uint16_t {
 	LOYALTY_POINTS_PER_CREATION_DAY,
 	LOYALTY_POINTS_PER_PREMIUM_DAY_PURCHASED,
 	LOYALTY_POINTS_PER_PREMIUM_DAY_SPENT,
+	LUA_CALL_BUDGET,
+	LUA_GC_STEP_BUDGET,
+	LUA_GC_STEP_SIZE,
+	LUA_GLOBALEVENT_CALL_BUDGET,
+	LUA_TIMER_EVENT_CALL_BUDGET,
 	M_CONST,
 	MAINTAIN_MODE_MESSAGE,
 	MAP_AUTHOR,
+	MAP_CLEAN_STEP_BUDGET,
 	MAP_DOWNLOAD_URL,
+	MAP_IDLE_TILE_MINUTES,
 	MAP_NAME,
+	MAP_SNAPSHOT,
 	MARKET_OFFER_DURATION,
 	MARKET_REFRESH_PRICES,
 	MARKET_PREMIUM,
@@ -145,6 +173,7 @@ enum ConfigKey_t : uint16_t {
 	MAX_DAMAGE_REFLECTION,
 	MAX_ELEMENTAL_RESISTANCE,
 	MAX_MARKET_OFFERS_AT_A_TIME_PER_PLAYER,
+	MAX_LOGIN_ATTEMPTS_PER_MINUTE,
 	MAX_MESSAGEBUFFER,
 	MAX_PACKETS_PER_SECOND,
 	MAX_PLAYERS_OUTSIDE_PZ_PER_ACCOUNT,
@@ -161,6 +190,8 @@ enum ConfigKey_t : uint16_t {
 	MOMENTUM_CHANCE_FORMULA_A,
 	MOMENTUM_CHANCE_FORMULA_B,
 	MOMENTUM_CHANCE_FORMULA_C,
+	MONSTER_IDLE_THINK_INTERVAL,
+	MONSTER_UNSEEN_THINK_INTERVAL,
 	MONTH_KILLS_TO_RED,
 	MULTIPLIER_ATTACKONFIST,
 	MYSQL_DB,
@@ -168,6 +199,8 @@ enum ConfigKey_t : uint16_t {
 	MYSQL_PASS,
 	MYSQL_SOCK,
 	MYSQL_USER,
+	NETWORK_CPUS,
+	NETWORK_THREADS,
 	OLD_PROTOCOL,
 	ONE_PLAYER_ON_ACCOUNT,
 	ONLY_INVITED_CAN_MOVE_HOUSE_ITEMS,
@@ -179,12 +212,19 @@ enum ConfigKey_t : uint16_t {
 	ORANGE_SKULL_DURATION,
 	OWNER_EMAIL,
 	OWNER_NAME,
+	PACKET_CAPTURE,
+	PACKET_CAPTURE_DIRECTORY,
 	PARALLELISM,
+	PARALLEL_CREATURE_THINK,
+	PARALLEL_PACKET_ENCODING,
+	PARALLEL_STARTUP,
 	PARTY_AUTO_SHARE_EXPERIENCE,
 	PARTY_SHARE_RANGE_MULTIPLIER,
 	PARTY_LIST_MAX_DISTANCE,
 	PARTY_SHARE_LOOT_BOOSTS_DIMINISHING_FACTOR,
 	PARTY_SHARE_LOOT_BOOSTS,
+	PLAYER_TRAFFIC_METRICS_TOP,
+	PREFETCH_LOGIN_QUERIES,
 	PREMIUM_DEPOT_LIMIT,
 	PREY_BONUS_REROLL_PRICE,
 	PREY_BONUS_TIME,
@@ -202,6 +242,7 @@ enum ConfigKey_t : uint16_t {
 	PVP_RATE_DAMAGE_TAKEN_PER_LEVEL,
 	PZ_LOCKED,
 	RANDOM_MONSTER_SPAWN,
+	RANDOM_SEED,
 	RATE_ATTACK_SPEED,
 	RATE_BOSS_ATTACK,
 	RATE_BOSS_DEFENSE,
@@ -242,6 +283,8 @@ enum ConfigKey_t : uint16_t {
 	RUSE_CHANCE_FORMULA_C,
 	SAVE_INTERVAL_TIME,
 	SAVE_INTERVAL_TYPE,
+	SAVE_JOURNAL_FILE,
+	SAVE_JOURNAL_PLAYERS_INTERVAL,
 	SCRIPTS_CONSOLE_LOGS,
 	SERVER_MOTD,
 	SERVER_NAME,
@@ -276,6 +319,7 @@ enum ConfigKey_t : uint16_t {
 	TASK_HUNTING_SELECTION_LIST_PRICE,
 	TELEPORT_PLAYER_TO_VOCATION_ROOM,
 	TELEPORT_SUMMONS,
+	THREAD_POOL_CPUS,
 	TIBIADROME_CONCOCTION_COOLDOWN,
 	TIBIADROME_CONCOCTION_DURATION,
 	TIBIADROME_CONCOCTION_TICK_TYPE,
@@ -324,5 +368,8 @@ enum ConfigKey_t : uint16_t {
 	WHEEL_POINTS_PER_LEVEL,
 	WHITE_SKULL_TIME,
 	WORLD_TYPE,
-	XP_DISPLAY_MODE
+	XP_DISPLAY_MODE,
+
+	// Number of keys, must stay the last one
+	CONFIG_KEY_COUNT
 };
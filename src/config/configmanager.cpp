@@ -19,6 +19,11 @@
 	#define lua_strlen lua_rawlen
 #endif
 
+ConfigManager::ConfigManager() {
+	// Reads before the first load find no value of the right type instead of a null snapshot
+	current = snapshots.emplace_back(std::make_unique<Snapshot>()).get();
+}
+
 ConfigManager &ConfigManager::getInstance() {
 	return inject<ConfigManager>();
 }
@@ -37,6 +42,8 @@ bool ConfigManager::load() {
 		return false;
 	}
 
+	building = std::make_unique<Snapshot>(snapshot());
+
 #ifndef DEBUG_LOG
 	g_logger().setLevel(loadStringConfig(L, LOGLEVEL, "logLevel", "info"));
 #endif
@@ -46,6 +53,7 @@ bool ConfigManager::load() {
 	if (!loaded) {
 		loadBoolConfig(L, BIND_ONLY_GLOBAL_ADDRESS, "bindOnlyGlobalAddress", false);
 		loadBoolConfig(L, DISABLE_LEGACY_RAIDS, "disableLegacyRaids", false);
+		loadBoolConfig(L, MAP_SNAPSHOT, "mapSnapshot", false);
 		loadBoolConfig(L, OLD_PROTOCOL, "allowOldProtocol", true);
 		loadBoolConfig(L, OPTIMIZE_DATABASE, "startupDatabaseOptimization", true);
 		loadBoolConfig(L, RANDOM_MONSTER_SPAWN, "randomMonsterSpawn", false);
@@ -56,17 +64,23 @@ bool ConfigManager::load() {
 		loadFloatConfig(L, HOUSE_PRICE_RENT_MULTIPLIER, "housePriceRentMultiplier", 1.0);
 		loadFloatConfig(L, HOUSE_RENT_RATE, "houseRentRate", 1.0);
 
+		loadIntConfig(L, ADMIN_HTTP_PORT, "adminHttpPort", 0);
+		loadIntConfig(L, DATABASE_WORKERS, "databaseWorkers", 0);
 		loadIntConfig(L, DEPOT_BOXES, "depotBoxes", 20);
 		loadIntConfig(L, FREE_DEPOT_LIMIT, "freeDepotLimit", 2000);
 		loadIntConfig(L, GAME_PORT, "gameProtocolPort", 7172);
 		loadIntConfig(L, LOGIN_PORT, "loginProtocolPort", 7171);
 		loadIntConfig(L, MARKET_OFFER_DURATION, "marketOfferDuration", 30 * 24 * 60 * 60);
+		loadIntConfig(L, MAP_IDLE_TILE_MINUTES, "mapIdleTileMinutes", 0);
 		loadIntConfig(L, MARKET_REFRESH_PRICES, "marketRefreshPricesInterval", 30);
+		loadIntConfig(L, NETWORK_THREADS, "networkThreads", 0);
 		loadIntConfig(L, PREMIUM_DEPOT_LIMIT, "premiumDepotLimit", 8000);
+		loadIntConfig(L, RANDOM_SEED, "randomSeed", 0);
 		loadIntConfig(L, SQL_PORT, "mysqlPort", 3306);
 		loadIntConfig(L, STASH_ITEMS, "stashItemCount", 5000);
 		loadIntConfig(L, STATUS_PORT, "statusProtocolPort", 7171);
 
+		loadStringConfig(L, ADMIN_HTTP_ADDRESS, "adminHttpAddress", "127.0.0.1");
 		loadStringConfig(L, AUTH_TYPE, "authType", "password");
 		loadStringConfig(L, HOUSE_RENT_PERIOD, "houseRentPeriod", "never");
 		loadStringConfig(L, IP, "ip", "127.0.0.1");
@@ -87,9 +101,14 @@ bool ConfigManager::load() {
 	loadBoolConfig(L, AUTOBANK, "autoBank", false);
 	loadBoolConfig(L, AUTOLOOT, "autoLoot", false);
 	loadBoolConfig(L, BOOSTED_BOSS_SLOT, "boostedBossSlot", true);
+	loadBoolConfig(L, CACHE_SPELL_FORMULA_VALUES, "cacheSpellFormulaValues", true);
+	loadBoolConfig(L, COALESCE_PLAYER_STATS, "coalescePlayerStats", true);
+	loadBoolConfig(L, HIGHSCORES_IN_MEMORY, "highscoresInMemory", true);
 	loadBoolConfig(L, CLASSIC_ATTACK_SPEED, "classicAttackSpeed", false);
 	loadBoolConfig(L, CLEAN_PROTECTION_ZONES, "cleanProtectionZones", false);
+	loadBoolConfig(L, COMPRESSION_STREAMING, "packetCompressionStreaming", false);
 	loadBoolConfig(L, CONVERT_UNSAFE_SCRIPTS, "convertUnsafeScripts", true);
+	loadBoolConfig(L, DEFER_MONSTER_MOVE_EVENTS, "deferMonsterMoveEvents", true);
 	loadBoolConfig(L, DISABLE_MONSTER_ARMOR, "disableMonsterArmor", false);
 	loadBoolConfig(L, DISCORD_SEND_FOOTER, "discordSendFooter", true);
 	loadBoolConfig(L, EMOTE_SPELLS, "emoteSpells", false);
@@ -104,14 +123,20 @@ bool ConfigManager::load() {
 	loadBoolConfig(L, HOUSE_OWNED_BY_ACCOUNT, "houseOwnedByAccount", false);
 	loadBoolConfig(L, HOUSE_PURSHASED_SHOW_PRICE, "housePurchasedShowPrice", false);
 	loadBoolConfig(L, INVENTORY_GLOW, "inventoryGlowOnFiveBless", false);
+	loadBoolConfig(L, LAZY_DEPOT_LOADING, "lazyDepotLoading", true);
 	loadBoolConfig(L, LOYALTY_ENABLED, "loyaltyEnabled", true);
 	loadBoolConfig(L, MARKET_PREMIUM, "premiumToCreateMarketOffer", true);
 	loadBoolConfig(L, METRICS_ENABLE_OSTREAM, "metricsEnableOstream", false);
 	loadBoolConfig(L, METRICS_ENABLE_PROMETHEUS, "metricsEnablePrometheus", false);
 	loadBoolConfig(L, ONLY_INVITED_CAN_MOVE_HOUSE_ITEMS, "onlyInvitedCanMoveHouseItems", true);
 	loadBoolConfig(L, ONLY_PREMIUM_ACCOUNT, "onlyPremiumAccount", false);
+	loadBoolConfig(L, PACKET_CAPTURE, "packetCapture", false);
+	loadBoolConfig(L, PARALLEL_CREATURE_THINK, "parallelCreatureThink", false);
+	loadBoolConfig(L, PARALLEL_PACKET_ENCODING, "parallelPacketEncoding", false);
+	loadBoolConfig(L, PARALLEL_STARTUP, "parallelStartup", false);
 	loadBoolConfig(L, PARTY_AUTO_SHARE_EXPERIENCE, "partyAutoShareExperience", true);
 	loadBoolConfig(L, PARTY_SHARE_LOOT_BOOSTS, "partyShareLootBoosts", true);
+	loadBoolConfig(L, PREFETCH_LOGIN_QUERIES, "prefetchLoginQueries", true);
 	loadBoolConfig(L, PREY_ENABLED, "preySystemEnabled", true);
 	loadBoolConfig(L, PREY_FREE_THIRD_SLOT, "preyFreeThirdSlot", false);
 	loadBoolConfig(L, PUSH_WHEN_ATTACKING, "pushWhenAttacking", false);
@@ -204,6 +229,8 @@ bool ConfigManager::load() {
 
 	loadIntConfig(L, ACTIONS_DELAY_INTERVAL, "timeBetweenActions", 200);
 	loadIntConfig(L, ADVENTURERSBLESSING_LEVEL, "adventurersBlessingLevel", 21);
+	loadIntConfig(L, AUTH_CACHE_DURATION, "authCacheDuration", 60);
+	loadIntConfig(L, AUTOSEND_FLUSH_SIZE, "autosendFlushSize", 0);
 	loadIntConfig(L, BESTIARY_KILL_MULTIPLIER, "bestiaryKillMultiplier", 1);
 	loadIntConfig(L, BLACK_SKULL_DURATION, "blackSkullDuration", 45);
 	loadIntConfig(L, BOOSTED_BOSS_KILL_BONUS, "boostedBossKillBonus", 3);
@@ -217,7 +244,10 @@ bool ConfigManager::load() {
 	loadIntConfig(L, COMBAT_CHAIN_DELAY, "combatChainDelay", 50);
 	loadIntConfig(L, COMBAT_CHAIN_TARGETS, "combatChainTargets", 5);
 	loadIntConfig(L, COMPRESSION_LEVEL, "packetCompressionLevel", 6);
+	loadIntConfig(L, COMPRESSION_MAX_RATIO, "packetCompressionMaxRatio", 90);
+	loadIntConfig(L, COMPRESSION_MIN_SIZE, "packetCompressionMinSize", 128);
 	loadIntConfig(L, CRITICALCHANCE, "criticalChance", 10);
+	loadIntConfig(L, DATABASE_COALESCE_WINDOW, "databaseCoalesceWindow", 5);
 	loadIntConfig(L, DAY_KILLS_TO_RED, "dayKillsToRedSkull", 3);
 	loadIntConfig(L, DEATH_LOSE_PERCENT, "deathLosePercent", -1);
 	loadIntConfig(L, DEFAULT_RESPAWN_TIME, "defaultRespawnTime", 60);
@@ -225,6 +255,8 @@ bool ConfigManager::load() {
 	loadIntConfig(L, DEFAULT_DESPAWNRANGE, "deSpawnRange", 2);
 	loadIntConfig(L, DEPOTCHEST, "depotChest", 4);
 	loadIntConfig(L, DISCORD_WEBHOOK_DELAY_MS, "discordWebhookDelayMs", Webhook::DEFAULT_DELAY_MS);
+	loadIntConfig(L, DISPATCHER_LATENCY_TARGET, "dispatcherLatencyTarget", 0);
+	loadIntConfig(L, DISPATCHER_SLOW_CYCLE_THRESHOLD, "dispatcherSlowCycleThreshold", 100);
 	loadIntConfig(L, EX_ACTIONS_DELAY_INTERVAL, "timeBetweenExActions", 1000);
 	loadIntConfig(L, EXP_FROM_PLAYERS_LEVEL_RANGE, "expFromPlayersLevelRange", 75);
 	loadIntConfig(L, FAMILIAR_TIME, "familiarTime", 30);
@@ -246,6 +278,7 @@ bool ConfigManager::load() {
 	loadIntConfig(L, FORGE_TRANSFER_DUST_COST, "forgeTransferDustCost", 100);
 	loadIntConfig(L, FRAG_TIME, "timeToDecreaseFrags", 24 * 60 * 60 * 1000);
 	loadIntConfig(L, FREE_QUEST_STAGE, "freeQuestStage", 1);
+	loadIntConfig(L, GAME_SNAPSHOT_INTERVAL, "gameSnapshotInterval", 1000);
 	loadIntConfig(L, GLOBAL_SERVER_SAVE_NOTIFY_DURATION, "globalServerSaveNotifyDuration", 5);
 	loadIntConfig(L, HAZARD_CRITICAL_CHANCE, "hazardCriticalChance", 750);
 	loadIntConfig(L, HAZARD_CRITICAL_INTERVAL, "hazardCriticalInterval", 2000);
@@ -263,11 +296,18 @@ bool ConfigManager::load() {
 	loadIntConfig(L, HOUSE_LOSE_AFTER_INACTIVITY, "houseLoseAfterInactivity", 0);
 	loadIntConfig(L, HOUSE_PRICE_PER_SQM, "housePriceEachSQM", 1000);
 	loadIntConfig(L, KICK_AFTER_MINUTES, "kickIdlePlayerAfterMinutes", 15);
+	loadIntConfig(L, KV_WRITE_BEHIND_INTERVAL, "kvWriteBehindInterval", 5000);
 	loadIntConfig(L, LOOTPOUCH_MAXLIMIT, "lootPouchMaxLimit", 2000);
 	loadIntConfig(L, LOW_LEVEL_BONUS_EXP, "lowLevelBonusExp", 50);
 	loadIntConfig(L, LOYALTY_POINTS_PER_CREATION_DAY, "loyaltyPointsPerCreationDay", 1);
 	loadIntConfig(L, LOYALTY_POINTS_PER_PREMIUM_DAY_PURCHASED, "loyaltyPointsPerPremiumDayPurchased", 0);
 	loadIntConfig(L, LOYALTY_POINTS_PER_PREMIUM_DAY_SPENT, "loyaltyPointsPerPremiumDaySpent", 0);
+	loadIntConfig(L, LUA_CALL_BUDGET, "luaCallBudget", 100);
+	loadIntConfig(L, LUA_GC_STEP_BUDGET, "luaGarbageCollectionStepBudget", 0);
+	loadIntConfig(L, LUA_GC_STEP_SIZE, "luaGarbageCollectionStepSize", 64);
+	loadIntConfig(L, LUA_GLOBALEVENT_CALL_BUDGET, "luaGlobalEventCallBudget", 500);
+	loadIntConfig(L, LUA_TIMER_EVENT_CALL_BUDGET, "luaTimerEventCallBudget", 100);
+	loadIntConfig(L, MAP_CLEAN_STEP_BUDGET, "mapCleanStepBudget", 0);
 	loadIntConfig(L, MAX_ALLOWED_ON_A_DUMMY, "maxAllowedOnADummy", 1);
 	loadIntConfig(L, MAX_CONTAINER_ITEM, "maxItem", 5000);
 	loadIntConfig(L, MAX_CONTAINER, "maxContainer", 500);
@@ -276,6 +316,7 @@ bool ConfigManager::load() {
 	loadIntConfig(L, MAX_MARKET_OFFERS_AT_A_TIME_PER_PLAYER, "maxMarketOffersAtATimePerPlayer", 100);
 	loadIntConfig(L, MAX_MESSAGEBUFFER, "maxMessageBuffer", 4);
 	loadIntConfig(L, MAX_PACKETS_PER_SECOND, "maxPacketsPerSecond", 25);
+	loadIntConfig(L, MAX_LOGIN_ATTEMPTS_PER_MINUTE, "maxLoginAttemptsPerMinute", 20);
 	loadIntConfig(L, MAX_PLAYERS_OUTSIDE_PZ_PER_ACCOUNT, "maxPlayersOutsidePZPerAccount", 1);
 	loadIntConfig(L, MAX_PLAYERS_PER_ACCOUNT, "maxPlayersOnlinePerAccount", 1);
 	loadIntConfig(L, MAX_PLAYERS, "maxPlayers", 0);
@@ -284,11 +325,14 @@ bool ConfigManager::load() {
 	loadIntConfig(L, MIN_DELAY_BETWEEN_CONDITIONS, "minDelayBetweenConditions", 0);
 	loadIntConfig(L, MIN_ELEMENTAL_RESISTANCE, "minElementalResistance", -200);
 	loadIntConfig(L, MIN_TOWN_ID_TO_BANK_TRANSFER_FROM_MAIN, "minTownIdToBankTransferFromMain", 4);
+	loadIntConfig(L, MONSTER_IDLE_THINK_INTERVAL, "monsterIdleThinkInterval", 2000);
+	loadIntConfig(L, MONSTER_UNSEEN_THINK_INTERVAL, "monsterUnseenThinkInterval", 3000);
 	loadIntConfig(L, MONTH_KILLS_TO_RED, "monthKillsToRedSkull", 10);
 	loadIntConfig(L, MULTIPLIER_ATTACKONFIST, "multiplierSpeedOnFist", 5);
 	loadIntConfig(L, ORANGE_SKULL_DURATION, "orangeSkullDuration", 7);
 	loadIntConfig(L, PARALLELISM, "parallelism", 2);
 	loadIntConfig(L, PARTY_LIST_MAX_DISTANCE, "partyListMaxDistance", 0);
+	loadIntConfig(L, PLAYER_TRAFFIC_METRICS_TOP, "playerTrafficMetricsTop", 10);
 	loadIntConfig(L, PREY_BONUS_REROLL_PRICE, "preyBonusRerollPrice", 1);
 	loadIntConfig(L, PREY_BONUS_TIME, "preyBonusTime", 7200);
 	loadIntConfig(L, PREY_FREE_REROLL_TIME, "preyFreeRerollTime", 72000);
@@ -308,6 +352,7 @@ bool ConfigManager::load() {
 	loadIntConfig(L, RED_SKULL_DURATION, "redSkullDuration", 30);
 	loadIntConfig(L, REWARD_CHEST_MAX_COLLECT_ITEMS, "rewardChestMaxCollectItems", 200);
 	loadIntConfig(L, SAVE_INTERVAL_TIME, "saveIntervalTime", 1);
+	loadIntConfig(L, SAVE_JOURNAL_PLAYERS_INTERVAL, "saveJournalPlayersInterval", 60);
 	loadIntConfig(L, STAIRHOP_DELAY, "stairJumpExhaustion", 2000);
 	loadIntConfig(L, STAMINA_GREEN_DELAY, "staminaGreenDelay", 5);
 	loadIntConfig(L, STAMINA_ORANGE_DELAY, "staminaOrangeDelay", 1);
@@ -345,28 +390,38 @@ bool ConfigManager::load() {
 	loadIntConfig(L, AUGMENT_POWERFUL_IMPACT_PERCENT, "augmentPowerfulImpactPercent", 10);
 	loadIntConfig(L, AUGMENT_STRONG_IMPACT_PERCENT, "augmentStrongImpactPercent", 7);
 
+	loadStringConfig(L, ADMIN_HTTP_TOKEN, "adminHttpToken", "");
 	loadStringConfig(L, CORE_DIRECTORY, "coreDirectory", "data");
 	loadStringConfig(L, DATA_DIRECTORY, "dataPackDirectory", "data-otservbr-global");
 	loadStringConfig(L, DEFAULT_PRIORITY, "defaultPriority", "high");
 	loadStringConfig(L, DISCORD_WEBHOOK_URL, "discordWebhookURL", "");
+	loadStringConfig(L, DISPATCHER_CPUS, "dispatcherCpus", "");
 	loadStringConfig(L, FORGE_FIENDISH_INTERVAL_TIME, "forgeFiendishIntervalTime", "1");
 	loadStringConfig(L, FORGE_FIENDISH_INTERVAL_TYPE, "forgeFiendishIntervalType", "hour");
 	loadStringConfig(L, GLOBAL_SERVER_SAVE_TIME, "globalServerSaveTime", "06:00");
 	loadStringConfig(L, LOCATION, "location", "");
 	loadStringConfig(L, M_CONST, "memoryConst", "1<<16");
 	loadStringConfig(L, METRICS_PROMETHEUS_ADDRESS, "metricsPrometheusAddress", "localhost:9464");
+	loadStringConfig(L, NETWORK_CPUS, "networkCpus", "");
 	loadStringConfig(L, OWNER_EMAIL, "ownerEmail", "");
 	loadStringConfig(L, OWNER_NAME, "ownerName", "");
+	loadStringConfig(L, PACKET_CAPTURE_DIRECTORY, "packetCaptureDirectory", "packet-captures");
 	loadStringConfig(L, SAVE_INTERVAL_TYPE, "saveIntervalType", "");
+	loadStringConfig(L, SAVE_JOURNAL_FILE, "saveJournalFile", "");
 	loadStringConfig(L, SERVER_MOTD, "serverMotd", "");
 	loadStringConfig(L, SERVER_NAME, "serverName", "");
 	loadStringConfig(L, STORE_IMAGES_URL, "coinImagesURL", "");
+	loadStringConfig(L, THREAD_POOL_CPUS, "threadPoolCpus", "");
 	loadStringConfig(L, TIBIADROME_CONCOCTION_TICK_TYPE, "tibiadromeConcoctionTickType", "online");
 	loadStringConfig(L, URL, "url", "");
 	loadStringConfig(L, WORLD_TYPE, "worldType", "pvp");
 
 	loaded = true;
 	lua_close(L);
+
+	current.store(building.get(), std::memory_order_release);
+	snapshots.emplace_back(std::move(building));
+	revision.fetch_add(1, std::memory_order_release);
 	return true;
 }
 
@@ -390,7 +445,8 @@ std::string ConfigManager::loadStringConfig(lua_State* L, const ConfigKey_t &key
 	} else {
 		missingConfigWarning(identifier);
 	}
-	configs[key] = value;
+	building->types[key] = ConfigType::String;
+	building->strings[key] = value;
 	lua_pop(L, 1);
 	return value;
 }
@@ -403,7 +459,8 @@ int32_t ConfigManager::loadIntConfig(lua_State* L, const ConfigKey_t &key, const
 	} else {
 		missingConfigWarning(identifier);
 	}
-	configs[key] = value;
+	building->types[key] = ConfigType::Number;
+	building->numbers[key] = value;
 	lua_pop(L, 1);
 	return value;
 }
@@ -416,7 +473,8 @@ bool ConfigManager::loadBoolConfig(lua_State* L, const ConfigKey_t &key, const c
 	} else {
 		missingConfigWarning(identifier);
 	}
-	configs[key] = value;
+	building->types[key] = ConfigType::Boolean;
+	building->booleans[key] = value;
 	lua_pop(L, 1);
 	return value;
 }
@@ -429,40 +487,12 @@ float ConfigManager::loadFloatConfig(lua_State* L, const ConfigKey_t &key, const
 	} else {
 		missingConfigWarning(identifier);
 	}
-	configs[key] = value;
+	building->types[key] = ConfigType::Float;
+	building->floats[key] = value;
 	lua_pop(L, 1);
 	return value;
 }
 
-const std::string &ConfigManager::getString(const ConfigKey_t &key, std::string_view context) const {
-	static const std::string dummyStr;
-	if (configs.contains(key) && std::holds_alternative<std::string>(configs.at(key))) {
-		return std::get<std::string>(configs.at(key));
-	}
-	g_logger().warn("[ConfigManager::getString] - Accessing invalid or wrong type index: {}[{}], Function: {}", magic_enum::enum_name(key), fmt::underlying(key), context);
-	return dummyStr;
-}
-
-int32_t ConfigManager::getNumber(const ConfigKey_t &key, std::string_view context) const {
-	if (configs.contains(key) && std::holds_alternative<int32_t>(configs.at(key))) {
-		return std::get<int32_t>(configs.at(key));
-	}
-	g_logger().warn("[ConfigManager::getNumber] - Accessing invalid or wrong type index: {}[{}], Function: {}", magic_enum::enum_name(key), fmt::underlying(key), context);
-	return 0;
-}
-
-bool ConfigManager::getBoolean(const ConfigKey_t &key, std::string_view context) const {
-	if (configs.contains(key) && std::holds_alternative<bool>(configs.at(key))) {
-		return std::get<bool>(configs.at(key));
-	}
-	g_logger().warn("[ConfigManager::getBoolean] - Accessing invalid or wrong type index: {}[{}], Function: {}", magic_enum::enum_name(key), fmt::underlying(key), context);
-	return false;
-}
-
-float ConfigManager::getFloat(const ConfigKey_t &key, std::string_view context) const {
-	if (configs.contains(key) && std::holds_alternative<float>(configs.at(key))) {
-		return std::get<float>(configs.at(key));
-	}
-	g_logger().warn("[ConfigManager::getFloat] - Accessing invalid or wrong type index: {}[{}], Function: {}", magic_enum::enum_name(key), fmt::underlying(key), context);
-	return 0.0f;
+void ConfigManager::wrongTypeWarning(std::string_view accessor, const ConfigKey_t &key, std::string_view context) const {
+	g_logger().warn("[ConfigManager::{}] - Accessing invalid or wrong type index: {}[{}], Function: {}", accessor, magic_enum::enum_name(key), fmt::underlying(key), context);
 }
@@ -11,11 +11,9 @@
 
 #include "config_enums.hpp"
 
-using ConfigValue = std::variant<std::string, int32_t, bool, float>;
-
 class ConfigManager {
 public:
-	ConfigManager() = default;
+	ConfigManager();
 
 	// Singleton - ensures we don't accidentally copy it
 	ConfigManager(const ConfigManager &) = delete;
@@ -36,13 +34,86 @@ public:
 		return configFileLua;
 	};
 
-	[[nodiscard]] const std::string &getString(const ConfigKey_t &key, std::string_view context) const;
-	[[nodiscard]] int32_t getNumber(const ConfigKey_t &key, std::string_view context) const;
-	[[nodiscard]] bool getBoolean(const ConfigKey_t &key, std::string_view context) const;
-	[[nodiscard]] float getFloat(const ConfigKey_t &key, std::string_view context) const;
+	// The context is only read to name the caller when the key has another type
+	[[nodiscard]] const std::string &getString(const ConfigKey_t &key, std::string_view context) const {
+		static const std::string dummyStr;
+		const auto &values = snapshot();
+		if (key < CONFIG_KEY_COUNT && values.types[key] == ConfigType::String) [[likely]] {
+			return values.strings[key];
+		}
+		wrongTypeWarning("getString", key, context);
+		return dummyStr;
+	}
+
+	[[nodiscard]] int32_t getNumber(const ConfigKey_t &key, std::string_view context) const {
+		const auto &values = snapshot();
+		if (key < CONFIG_KEY_COUNT && values.types[key] == ConfigType::Number) [[likely]] {
+			return values.numbers[key];
+		}
+		wrongTypeWarning("getNumber", key, context);
+		return 0;
+	}
+
+	[[nodiscard]] bool getBoolean(const ConfigKey_t &key, std::string_view context) const {
+		const auto &values = snapshot();
+		if (key < CONFIG_KEY_COUNT && values.types[key] == ConfigType::Boolean) [[likely]] {
+			return values.booleans[key];
+		}
+		wrongTypeWarning("getBoolean", key, context);
+		return false;
+	}
+
+	// Incremented each time a load publishes new values, caches of derived values compare it to know they are stale
+	[[nodiscard]] uint32_t getRevision() const {
+		return revision.load(std::memory_order_acquire);
+	}
+
+	[[nodiscard]] float getFloat(const ConfigKey_t &key, std::string_view context) const {
+		const auto &values = snapshot();
+		if (key < CONFIG_KEY_COUNT && values.types[key] == ConfigType::Float) [[likely]] {
+			return values.floats[key];
+		}
+		wrongTypeWarning("getFloat", key, context);
+		return 0.0f;
+	}
 
 private:
-	phmap::flat_hash_map<ConfigKey_t, ConfigValue> configs;
+	enum class ConfigType : uint8_t {
+		None,
+		String,
+		Number,
+		Boolean,
+		Float,
+	};
+
+	/**
+	 * Every value indexed by its key, with the type it was loaded as.
+	 *
+	 * A published snapshot is never changed: a reload fills a copy of the
+	 * current one, so the values loaded only once are kept, and swaps it in.
+	 * The old snapshots stay alive until shutdown, which keeps valid the
+	 * string references handed out before the reload.
+	 */
+	struct Snapshot {
+		std::array<ConfigType, CONFIG_KEY_COUNT> types {};
+		std::array<int32_t, CONFIG_KEY_COUNT> numbers {};
+		std::array<float, CONFIG_KEY_COUNT> floats {};
+		std::array<bool, CONFIG_KEY_COUNT> booleans {};
+		std::array<std::string, CONFIG_KEY_COUNT> strings;
+	};
+
+	const Snapshot &snapshot() const {
+		return *current.load(std::memory_order_acquire);
+	}
+
+	void wrongTypeWarning(std::string_view accessor, const ConfigKey_t &key, std::string_view context) const;
+
+	std::atomic<const Snapshot*> current = nullptr;
+	std::atomic<uint32_t> revision = 0;
+	std::vector<std::unique_ptr<Snapshot>> snapshots;
+	// Filled by load, published when it succeeds
+	std::unique_ptr<Snapshot> building;
+
 	std::string loadStringConfig(lua_State* L, const ConfigKey_t &key, const char* identifier, const std::string &defaultValue);
 	int32_t loadIntConfig(lua_State* L, const ConfigKey_t &key, const char* identifier, const int32_t &defaultValue);
 	bool loadBoolConfig(lua_State* L, const ConfigKey_t &key, const char* identifier, const bool &defaultValue);
@@ -33,7 +33,7 @@ int32_t Combat::getLevelFormula(std::shared_ptr<Player> player, const std::share
 
 	uint32_t magicLevelSkill = player->getMagicLevel();
 	// Wheel of destiny - Runic Mastery
-	if (player->wheel()->getInstant("Runic Mastery") && wheelSpell && damage.instantSpellName.empty() && normal_random(0, 100) <= 25) {
+	if (player->wheel()->getInstant(WheelInstant_t::RUNIC_MASTERY) && wheelSpell && damage.instantSpellName.empty() && normal_random(0, 100) <= 25) {
 		const auto conjuringSpell = g_spells().getInstantSpellByName(damage.runeSpellName);
 		if (conjuringSpell && conjuringSpell != wheelSpell) {
 			uint32_t castResult = conjuringSpell->canCast(player) ? 20 : 10;
@@ -186,7 +186,7 @@ ConditionType_t Combat::DamageToConditionType(CombatType_t type) {
 	}
 }
 
-bool Combat::isPlayerCombat(std::shared_ptr<Creature> target) {
+bool Combat::isPlayerCombat(const std::shared_ptr<Creature> &target) {
 	if (target->getPlayer()) {
 		return true;
 	}
@@ -198,7 +198,7 @@ bool Combat::isPlayerCombat(std::shared_ptr<Creature> target) {
 	return false;
 }
 
-ReturnValue Combat::canTargetCreature(std::shared_ptr<Player> player, std::shared_ptr<Creature> target) {
+ReturnValue Combat::canTargetCreature(const std::shared_ptr<Player> &player, const std::shared_ptr<Creature> &target) {
 	if (player == target) {
 		return RETURNVALUE_YOUMAYNOTATTACKTHISPLAYER;
 	}
@@ -246,7 +246,7 @@ ReturnValue Combat::canTargetCreature(std::shared_ptr<Player> player, std::share
 	return Combat::canDoCombat(player, target, true);
 }
 
-ReturnValue Combat::canDoCombat(std::shared_ptr<Creature> caster, std::shared_ptr<Tile> tile, bool aggressive) {
+ReturnValue Combat::canDoCombat(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Tile> &tile, bool aggressive) {
 	if (tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
 		return RETURNVALUE_NOTENOUGHROOM;
 	}
@@ -284,11 +284,11 @@ ReturnValue Combat::canDoCombat(std::shared_ptr<Creature> caster, std::shared_pt
 	return ret;
 }
 
-bool Combat::isInPvpZone(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target) {
+bool Combat::isInPvpZone(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target) {
 	return attacker->getZoneType() == ZONE_PVP && target->getZoneType() == ZONE_PVP;
 }
 
-bool Combat::isProtected(std::shared_ptr<Player> attacker, std::shared_ptr<Player> target) {
+bool Combat::isProtected(const std::shared_ptr<Player> &attacker, const std::shared_ptr<Player> &target) {
 	uint32_t protectionLevel = g_configManager().getNumber(PROTECTION_LEVEL, __FUNCTION__);
 	if (target->getLevel() < protectionLevel || attacker->getLevel() < protectionLevel) {
 		return true;
@@ -305,7 +305,7 @@ bool Combat::isProtected(std::shared_ptr<Player> attacker, std::shared_ptr<Playe
 	return false;
 }
 
-ReturnValue Combat::canDoCombat(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, bool aggressive) {
+ReturnValue Combat::canDoCombat(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, bool aggressive) {
 	if (!aggressive) {
 		return RETURNVALUE_NOERROR;
 	}
@@ -568,7 +568,7 @@ CallBack* Combat::getCallback(CallBackParam_t key) {
 	return nullptr;
 }
 
-void Combat::CombatHealthFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage* data) {
+void Combat::CombatHealthFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage* data) {
 	if (!data) {
 		g_logger().error("[{}]: CombatDamage is nullptr", __FUNCTION__);
 		return;
@@ -693,7 +693,7 @@ CombatDamage Combat::applyImbuementElementalDamage(std::shared_ptr<Player> attac
 	return damage;
 }
 
-void Combat::CombatManaFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage* data) {
+void Combat::CombatManaFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage* data) {
 	if (!data) {
 		g_logger().error("[{}]: CombatDamage is nullptr", __FUNCTION__);
 		return;
@@ -740,7 +740,7 @@ bool Combat::checkFearConditionAffected(std::shared_ptr<Player> player) {
 	return true;
 }
 
-void Combat::CombatConditionFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage* data) {
+void Combat::CombatConditionFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage* data) {
 	if (params.origin == ORIGIN_MELEE && data && data->primary.value == 0 && data->secondary.value == 0) {
 		return;
 	}
@@ -793,18 +793,18 @@ void Combat::CombatConditionFunc(std::shared_ptr<Creature> caster, std::shared_p
 	}
 }
 
-void Combat::CombatDispelFunc(std::shared_ptr<Creature>, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage*) {
+void Combat::CombatDispelFunc(const std::shared_ptr<Creature> &, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage*) {
 	if (target) {
 		target->removeCombatCondition(params.dispelType);
 	}
 }
 
-void Combat::CombatNullFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage*) {
+void Combat::CombatNullFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage*) {
 	CombatConditionFunc(caster, target, params, nullptr);
 	CombatDispelFunc(caster, target, params, nullptr);
 }
 
-void Combat::combatTileEffects(const CreatureVector &spectators, std::shared_ptr<Creature> caster, std::shared_ptr<Tile> tile, const CombatParams &params) {
+void Combat::combatTileEffects(const CreatureVector &spectators, const std::shared_ptr<Creature> &caster, const std::shared_ptr<Tile> &tile, const CombatParams &params) {
 	if (params.itemId != 0) {
 		uint16_t itemId = params.itemId;
 		switch (itemId) {
@@ -893,7 +893,7 @@ void Combat::combatTileEffects(const CreatureVector &spectators, std::shared_ptr
 	}
 }
 
-void Combat::postCombatEffects(std::shared_ptr<Creature> caster, const Position &origin, const Position &pos, const CombatParams &params) {
+void Combat::postCombatEffects(const std::shared_ptr<Creature> &caster, const Position &origin, const Position &pos, const CombatParams &params) {
 	if (caster && params.distanceEffect != CONST_ANI_NONE) {
 		addDistanceEffect(caster, origin, pos, params.distanceEffect);
 	}
@@ -905,7 +905,7 @@ void Combat::postCombatEffects(std::shared_ptr<Creature> caster, const Position
 	}
 }
 
-void Combat::addDistanceEffect(std::shared_ptr<Creature> caster, const Position &fromPos, const Position &toPos, uint16_t effect) {
+void Combat::addDistanceEffect(const std::shared_ptr<Creature> &caster, const Position &fromPos, const Position &toPos, uint16_t effect) {
 	if (effect == CONST_ANI_WEAPONTYPE) {
 		if (!caster) {
 			return;
@@ -1129,7 +1129,7 @@ bool Combat::doCombat(std::shared_ptr<Creature> caster, const Position &position
 	return true;
 }
 
-void Combat::CombatFunc(std::shared_ptr<Creature> caster, const Position &origin, const Position &pos, const std::unique_ptr<AreaCombat> &area, const CombatParams &params, CombatFunction func, CombatDamage* data) {
+void Combat::CombatFunc(const std::shared_ptr<Creature> &caster, const Position &origin, const Position &pos, const std::unique_ptr<AreaCombat> &area, const CombatParams &params, CombatFunction func, CombatDamage* data) {
 	std::vector<std::shared_ptr<Tile>> tileList;
 
 	if (caster) {
@@ -1215,6 +1215,7 @@ void Combat::CombatFunc(std::shared_ptr<Creature> caster, const Position &origin
 	std::shared_ptr<Player> casterPlayer = caster ? caster->getPlayer() : nullptr;
 	uint8_t beamAffectedTotal = casterPlayer ? casterPlayer->wheel()->getBeamAffectedTotal(tmpDamage) : 0;
 	uint8_t beamAffectedCurrent = 0;
+	Game::AreaCombatScope areaCombatScope(spectators.data(), pos, rangeX, rangeY);
 
 	tmpDamage.affected = affected;
 	for (const std::shared_ptr<Tile> &tile : tileList) {
@@ -1264,11 +1265,11 @@ void Combat::CombatFunc(std::shared_ptr<Creature> caster, const Position &origin
 	postCombatEffects(caster, origin, pos, params);
 }
 
-void Combat::doCombatHealth(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, CombatDamage &damage, const CombatParams &params) {
-	doCombatHealth(caster, std::move(target), caster ? caster->getPosition() : Position(), damage, params);
+void Combat::doCombatHealth(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, CombatDamage &damage, const CombatParams &params) {
+	doCombatHealth(caster, target, caster ? caster->getPosition() : Position(), damage, params);
 }
 
-void Combat::doCombatHealth(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const Position &origin, CombatDamage &damage, const CombatParams &params) {
+void Combat::doCombatHealth(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const Position &origin, CombatDamage &damage, const CombatParams &params) {
 	bool canCombat = !params.aggressive || (caster != target && Combat::canDoCombat(caster, target, params.aggressive) == RETURNVALUE_NOERROR);
 	if ((caster && target)
 	    && (caster == target || canCombat)
@@ -1302,17 +1303,17 @@ void Combat::doCombatHealth(std::shared_ptr<Creature> caster, std::shared_ptr<Cr
 	}
 }
 
-void Combat::doCombatHealth(std::shared_ptr<Creature> caster, const Position &position, const std::unique_ptr<AreaCombat> &area, CombatDamage &damage, const CombatParams &params) {
+void Combat::doCombatHealth(const std::shared_ptr<Creature> &caster, const Position &position, const std::unique_ptr<AreaCombat> &area, CombatDamage &damage, const CombatParams &params) {
 	applyExtensions(caster, nullptr, damage, params);
 	const auto origin = caster ? caster->getPosition() : Position();
 	CombatFunc(caster, origin, position, area, params, CombatHealthFunc, &damage);
 }
 
-void Combat::doCombatMana(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, CombatDamage &damage, const CombatParams &params) {
+void Combat::doCombatMana(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, CombatDamage &damage, const CombatParams &params) {
 	doCombatMana(caster, target, caster ? caster->getPosition() : Position(), damage, params);
 }
 
-void Combat::doCombatMana(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const Position &origin, CombatDamage &damage, const CombatParams &params) {
+void Combat::doCombatMana(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const Position &origin, CombatDamage &damage, const CombatParams &params) {
 	bool canCombat = !params.aggressive || (caster != target && Combat::canDoCombat(caster, target, params.aggressive) == RETURNVALUE_NOERROR);
 	if ((caster && target)
 	    && (caster == target || canCombat)
@@ -1340,18 +1341,18 @@ void Combat::doCombatMana(std::shared_ptr<Creature> caster, std::shared_ptr<Crea
 	}
 }
 
-void Combat::doCombatMana(std::shared_ptr<Creature> caster, const Position &position, const std::unique_ptr<AreaCombat> &area, CombatDamage &damage, const CombatParams &params) {
+void Combat::doCombatMana(const std::shared_ptr<Creature> &caster, const Position &position, const std::unique_ptr<AreaCombat> &area, CombatDamage &damage, const CombatParams &params) {
 	applyExtensions(caster, nullptr, damage, params);
 	const auto origin = caster ? caster->getPosition() : Position();
 	CombatFunc(caster, origin, position, area, params, CombatManaFunc, &damage);
 }
 
-void Combat::doCombatCondition(std::shared_ptr<Creature> caster, const Position &position, const std::unique_ptr<AreaCombat> &area, const CombatParams &params) {
+void Combat::doCombatCondition(const std::shared_ptr<Creature> &caster, const Position &position, const std::unique_ptr<AreaCombat> &area, const CombatParams &params) {
 	const auto origin = caster ? caster->getPosition() : Position();
 	CombatFunc(caster, origin, position, area, params, CombatConditionFunc, nullptr);
 }
 
-void Combat::doCombatCondition(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params) {
+void Combat::doCombatCondition(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params) {
 	bool canCombat = !params.aggressive || (caster != target && Combat::canDoCombat(caster, target, params.aggressive) == RETURNVALUE_NOERROR);
 	if ((caster == target || canCombat) && params.impactEffect != CONST_ME_NONE) {
 		g_game().addMagicEffect(target->getPosition(), params.impactEffect);
@@ -1375,12 +1376,12 @@ void Combat::doCombatCondition(std::shared_ptr<Creature> caster, std::shared_ptr
 	}
 }
 
-void Combat::doCombatDispel(std::shared_ptr<Creature> caster, const Position &position, const std::unique_ptr<AreaCombat> &area, const CombatParams &params) {
+void Combat::doCombatDispel(const std::shared_ptr<Creature> &caster, const Position &position, const std::unique_ptr<AreaCombat> &area, const CombatParams &params) {
 	const auto origin = caster ? caster->getPosition() : Position();
 	CombatFunc(caster, origin, position, area, params, CombatDispelFunc, nullptr);
 }
 
-void Combat::doCombatDispel(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params) {
+void Combat::doCombatDispel(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params) {
 	bool canCombat = !params.aggressive || (caster != target && Combat::canDoCombat(caster, target, params.aggressive) == RETURNVALUE_NOERROR);
 	if ((caster && target)
 	    && (caster == target || canCombat)
@@ -1406,11 +1407,11 @@ void Combat::doCombatDispel(std::shared_ptr<Creature> caster, std::shared_ptr<Cr
 	}
 }
 
-[[maybe_unused]] void Combat::doCombatDefault(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params) {
+[[maybe_unused]] void Combat::doCombatDefault(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params) {
 	doCombatDefault(caster, target, caster ? caster->getPosition() : Position(), params);
 }
 
-void Combat::doCombatDefault(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const Position &origin, const CombatParams &params) {
+void Combat::doCombatDefault(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const Position &origin, const CombatParams &params) {
 	if (!params.aggressive || (caster != target && Combat::canDoCombat(caster, target, params.aggressive) == RETURNVALUE_NOERROR)) {
 		auto spectators = Spectators().find<Player>(target->getPosition(), true);
 
@@ -1538,7 +1539,7 @@ uint32_t ValueCallback::getMagicLevelSkill(std::shared_ptr<Player> player, const
 
 	uint32_t magicLevelSkill = player->getMagicLevel();
 	// Wheel of destiny
-	if (player && player->wheel()->getInstant("Runic Mastery") && damage.instantSpellName.empty()) {
+	if (player && player->wheel()->getInstant(WheelInstant_t::RUNIC_MASTERY) && damage.instantSpellName.empty()) {
 		const std::shared_ptr<Spell> spell = g_spells().getRuneSpellByName(damage.runeSpellName);
 		// Rune conjuring spell have the same name as the rune item spell.
 		const std::shared_ptr<InstantSpell> conjuringSpell = g_spells().getInstantSpellByName(damage.runeSpellName);
@@ -1553,42 +1554,21 @@ uint32_t ValueCallback::getMagicLevelSkill(std::shared_ptr<Player> player, const
 
 void ValueCallback::getMinMaxValues(std::shared_ptr<Player> player, CombatDamage &damage, bool useCharges) const {
 	// onGetPlayerMinMaxValues(...)
-	if (!scriptInterface->reserveScriptEnv()) {
-		g_logger().error("[ValueCallback::getMinMaxValues - Player {} formula {}] "
-		                 "Call stack overflow. Too many lua script calls being nested.",
-		                 player->getName(), fmt::underlying(type));
-		return;
-	}
-
-	ScriptEnvironment* env = scriptInterface->getScriptEnv();
-	if (!env->setCallbackId(scriptId, scriptInterface)) {
-		scriptInterface->resetScriptEnv();
-		return;
-	}
-
-	lua_State* L = scriptInterface->getLuaState();
-
-	scriptInterface->pushFunction(scriptId);
-
-	LuaScriptInterface::pushUserdata<Player>(L, player);
-	LuaScriptInterface::setMetatable(L, -1, "Player");
+	FormulaArguments arguments;
+	arguments.level = player->getLevel();
+	arguments.wheelVersion = player->wheel()->getSpellsVersion();
 
 	int16_t elementAttack = 0; // To calculate elemental damage after executing spell script and get real damage.
 	int32_t attackValue = 7; // default start attack value
-	int parameters = 1;
 	bool shouldCalculateSecondaryDamage = false;
 
 	switch (type) {
 		case COMBAT_FORMULA_LEVELMAGIC: {
-			// onGetPlayerMinMaxValues(player, level, maglevel)
-			lua_pushnumber(L, player->getLevel());
-			lua_pushnumber(L, getMagicLevelSkill(player, damage));
-			parameters += 2;
+			arguments.skill = getMagicLevelSkill(player, damage);
 			break;
 		}
 
 		case COMBAT_FORMULA_SKILL: {
-			// onGetPlayerMinMaxValues(player, attackSkill, attackValue, attackFactor)
 			std::shared_ptr<Item> tool = player->getWeapon();
 			const auto &weapon = g_weapons().getWeapon(tool);
 			int32_t attackSkill = 0;
@@ -1597,28 +1577,20 @@ void ValueCallback::getMinMaxValues(std::shared_ptr<Player> player, CombatDamage
 				shouldCalculateSecondaryDamage = weapon->calculateSkillFormula(player, attackSkill, attackValue, attackFactor, elementAttack, damage, useCharges);
 			}
 
-			lua_pushnumber(L, attackSkill);
-			lua_pushnumber(L, attackValue);
-			lua_pushnumber(L, attackFactor);
-			parameters += 3;
+			arguments.skill = attackSkill;
+			arguments.attackValue = attackValue;
+			arguments.attackFactor = attackFactor;
 			break;
 		}
 
 		default: {
 			g_logger().warn("[ValueCallback::getMinMaxValues] - Unknown callback type");
-			scriptInterface->resetScriptEnv();
 			return;
 		}
 	}
 
-	int size0 = lua_gettop(L);
-	if (lua_pcall(L, parameters, 2, 0) != 0) {
-		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(L));
-	} else {
-		int32_t defaultDmg = normal_random(
-			LuaScriptInterface::getNumber<int32_t>(L, -2),
-			LuaScriptInterface::getNumber<int32_t>(L, -1)
-		);
+	const auto setDamage = [&](int32_t min, int32_t max) {
+		int32_t defaultDmg = normal_random(min, max);
 
 		if (shouldCalculateSecondaryDamage) {
 			double factor = (double)elementAttack / (double)attackValue; // attack value here is phys dmg + element dmg
@@ -1631,6 +1603,65 @@ void ValueCallback::getMinMaxValues(std::shared_ptr<Player> player, CombatDamage
 			damage.secondary.type = COMBAT_NONE;
 			damage.secondary.value = 0;
 		}
+	};
+
+	const bool useCache = g_configManager().getBoolean(CACHE_SPELL_FORMULA_VALUES, __FUNCTION__);
+	if (useCache) {
+		if (const auto it = formulaValues.find(player->getID()); it != formulaValues.end() && it->second.arguments == arguments) {
+			setDamage(it->second.min, it->second.max);
+			return;
+		}
+	}
+
+	if (!scriptInterface->reserveScriptEnv()) {
+		g_logger().error("[ValueCallback::getMinMaxValues - Player {} formula {}] "
+		                 "Call stack overflow. Too many lua script calls being nested.",
+		                 player->getName(), fmt::underlying(type));
+		return;
+	}
+
+	ScriptEnvironment* env = scriptInterface->getScriptEnv();
+	if (!env->setCallbackId(scriptId, scriptInterface)) {
+		scriptInterface->resetScriptEnv();
+		return;
+	}
+
+	lua_State* L = scriptInterface->getLuaState();
+
+	scriptInterface->pushFunction(scriptId);
+
+	LuaScriptInterface::pushUserdata<Player>(L, player);
+	LuaScriptInterface::setMetatable(L, -1, "Player");
+
+	int parameters = 1;
+	if (type == COMBAT_FORMULA_LEVELMAGIC) {
+		// onGetPlayerMinMaxValues(player, level, maglevel)
+		lua_pushnumber(L, arguments.level);
+		lua_pushnumber(L, arguments.skill);
+		parameters += 2;
+	} else {
+		// onGetPlayerMinMaxValues(player, attackSkill, attackValue, attackFactor)
+		lua_pushnumber(L, arguments.skill);
+		lua_pushnumber(L, arguments.attackValue);
+		lua_pushnumber(L, arguments.attackFactor);
+		parameters += 3;
+	}
+
+	int size0 = lua_gettop(L);
+	if (lua_pcall(L, parameters, 2, 0) != 0) {
+		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(L));
+	} else {
+		const auto min = LuaScriptInterface::getNumber<int32_t>(L, -2);
+		const auto max = LuaScriptInterface::getNumber<int32_t>(L, -1);
+		setDamage(min, max);
+
+		if (useCache) {
+			// Entries of players gone are only dropped all at once
+			if (formulaValues.size() >= MAX_FORMULA_VALUES) {
+				formulaValues.clear();
+			}
+			formulaValues[player->getID()] = { arguments, min, max };
+		}
 
 		lua_pop(L, 2);
 	}
@@ -1831,6 +1862,9 @@ bool ChainPickerCallback::onChainCombat(std::shared_ptr<Creature> creature, std:
 
 void AreaCombat::clear() {
 	std::ranges::fill(areas, nullptr);
+	for (auto &areaOffsets : offsets) {
+		areaOffsets.clear();
+	}
 }
 
 AreaCombat::AreaCombat(const AreaCombat &rhs) {
@@ -1840,32 +1874,58 @@ AreaCombat::AreaCombat(const AreaCombat &rhs) {
 			areas[i] = area->clone();
 		}
 	}
+	offsets = rhs.offsets;
 }
 
-void AreaCombat::getList(const Position &centerPos, const Position &targetPos, std::vector<std::shared_ptr<Tile>> &list) const {
-	const std::unique_ptr<MatrixArea> &area = getArea(centerPos, targetPos);
-	if (!area) {
-		return;
-	}
+void AreaCombat::setupOffsets() {
+	for (uint_fast8_t i = 0; i <= Direction::DIRECTION_LAST; ++i) {
+		auto &areaOffsets = offsets[i];
+		areaOffsets.clear();
 
-	uint32_t centerY;
-	uint32_t centerX;
-	area->getCenter(centerY, centerX);
+		const auto &area = areas[i];
+		if (!area) {
+			continue;
+		}
 
-	const uint32_t rows = area->getRows();
-	const uint32_t cols = area->getCols();
-	list.reserve(rows * cols);
+		uint32_t centerY;
+		uint32_t centerX;
+		area->getCenter(centerY, centerX);
 
-	Position tmpPos(targetPos.x - centerX, targetPos.y - centerY, targetPos.z);
-	for (uint32_t y = 0; y < rows; ++y, ++tmpPos.y, tmpPos.x -= cols) {
-		for (uint32_t x = 0; x < cols; ++x, ++tmpPos.x) {
-			if (area->getValue(y, x) != 0) {
-				if (g_game().isSightClear(targetPos, tmpPos, true)) {
-					list.emplace_back(g_game().map.getOrCreateTile(tmpPos));
+		// The rotated areas are twice as large as the original, most of their cells are empty
+		for (uint32_t y = 0; y < area->getRows(); ++y) {
+			for (uint32_t x = 0; x < area->getCols(); ++x) {
+				if (area->getValue(y, x)) {
+					areaOffsets.emplace_back(static_cast<int32_t>(x) - static_cast<int32_t>(centerX), static_cast<int32_t>(y) - static_cast<int32_t>(centerY));
 				}
 			}
 		}
+		areaOffsets.shrink_to_fit();
+	}
+}
+
+void AreaCombat::getList(const Position &centerPos, const Position &targetPos, std::vector<std::shared_ptr<Tile>> &list) const {
+	const auto &areaOffsets = offsets[getDirection(centerPos, targetPos)];
+	if (areaOffsets.empty()) {
+		return;
+	}
+
+	std::vector<Position> positions;
+	positions.reserve(areaOffsets.size());
+	for (const auto &[dx, dy] : areaOffsets) {
+		const int32_t x = targetPos.x + dx;
+		const int32_t y = targetPos.y + dy;
+		if (x < 0 || y < 0 || x > std::numeric_limits<uint16_t>::max() || y > std::numeric_limits<uint16_t>::max()) {
+			continue;
+		}
+
+		const Position pos(static_cast<uint16_t>(x), static_cast<uint16_t>(y), targetPos.z);
+		if (g_game().isSightClear(targetPos, pos, true)) {
+			positions.emplace_back(pos);
+		}
 	}
+
+	// The offsets run row by row, so neighbour positions share their map sector
+	g_game().map.getOrCreateTiles(positions, list);
 }
 
 void AreaCombat::copyArea(const std::unique_ptr<MatrixArea> &input, const std::unique_ptr<MatrixArea> &output, MatrixOperation_t op) const {
@@ -1999,6 +2059,8 @@ void AreaCombat::setupArea(const std::list<uint32_t> &list, uint32_t rows) {
 	areas[DIRECTION_SOUTH] = std::move(southArea);
 	areas[DIRECTION_EAST] = std::move(eastArea);
 	areas[DIRECTION_WEST] = std::move(westArea);
+
+	setupOffsets();
 }
 
 void AreaCombat::setupArea(int32_t length, int32_t spread) {
@@ -2097,6 +2159,8 @@ void AreaCombat::setupExtArea(const std::list<uint32_t> &list, uint32_t rows) {
 	areas[DIRECTION_SOUTHWEST] = std::move(swArea);
 	areas[DIRECTION_NORTHEAST] = std::move(neArea);
 	areas[DIRECTION_SOUTHEAST] = std::move(seArea);
+
+	setupOffsets();
 }
 
 //**********************************************************//
@@ -2150,7 +2214,7 @@ void MagicField::onStepInField(const std::shared_ptr<Creature> &creature) {
 	}
 }
 
-void Combat::applyExtensions(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, CombatDamage &damage, const CombatParams &params) {
+void Combat::applyExtensions(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, CombatDamage &damage, const CombatParams &params) {
 	metrics::method_latency measure(__METHOD_NAME__);
 	if (damage.extension || !caster || damage.primary.type == COMBAT_HEALING) {
 		return;
@@ -157,7 +157,7 @@ void Condition::serialize(PropWriteStream &propWriteStream) {
 	propWriteStream.write<uint32_t>(id);
 
 	propWriteStream.write<uint8_t>(CONDITIONATTR_TICKS);
-	propWriteStream.write<uint32_t>(ticks);
+	propWriteStream.write<uint32_t>(getTicks());
 
 	propWriteStream.write<uint8_t>(CONDITIONATTR_ISBUFF);
 	propWriteStream.write<uint8_t>(isBuff);
@@ -178,6 +178,19 @@ void Condition::serialize(PropWriteStream &propWriteStream) {
 void Condition::setTicks(int32_t newTicks) {
 	ticks = newTicks;
 	endTime = ticks + OTSYS_TIME();
+	// The new end is checked on the next creature check
+	sleepTicks = 0;
+	skippedTicks = 0;
+}
+
+void Condition::sleepUntilEnd() {
+	if (tickSound != SoundEffect_t::SILENCE) {
+		sleepTicks = 0;
+	} else if (ticks == -1) {
+		sleepTicks = SLEEP_UNTIL_REMOVED;
+	} else {
+		sleepTicks = static_cast<int32_t>(std::clamp<int64_t>(endTime - OTSYS_TIME(), 0, SLEEP_UNTIL_REMOVED - 1));
+	}
 }
 
 bool Condition::executeCondition(std::shared_ptr<Creature> creature, int32_t interval) {
@@ -395,7 +408,12 @@ bool ConditionGeneric::startCondition(std::shared_ptr<Creature> creature) {
 }
 
 bool ConditionGeneric::executeCondition(std::shared_ptr<Creature> creature, int32_t interval) {
-	return Condition::executeCondition(creature, interval);
+	if (!Condition::executeCondition(creature, interval)) {
+		return false;
+	}
+
+	sleepUntilEnd();
+	return true;
 }
 
 void ConditionGeneric::endCondition(std::shared_ptr<Creature>) {
@@ -1272,7 +1290,16 @@ bool ConditionRegeneration::executeCondition(std::shared_ptr<Creature> creature,
 		}
 	}
 
-	return ConditionGeneric::executeCondition(creature, interval);
+	if (!ConditionGeneric::executeCondition(creature, interval)) {
+		return false;
+	}
+
+	// Due again at its next gain
+	if (sleepTicks != 0) {
+		const int64_t nextGain = std::min<int64_t>(static_cast<int64_t>(getHealthTicks(creature)) - internalHealthTicks, static_cast<int64_t>(getManaTicks(creature)) - internalManaTicks);
+		sleepTicks = static_cast<int32_t>(std::clamp<int64_t>(nextGain, 0, sleepTicks));
+	}
+	return true;
 }
 
 bool ConditionRegeneration::setParam(ConditionParam_t param, int32_t value) {
@@ -1444,7 +1471,14 @@ bool ConditionSoul::executeCondition(std::shared_ptr<Creature> creature, int32_t
 		}
 	}
 
-	return ConditionGeneric::executeCondition(creature, interval);
+	if (!ConditionGeneric::executeCondition(creature, interval)) {
+		return false;
+	}
+
+	if (sleepTicks != 0) {
+		sleepTicks = static_cast<int32_t>(std::clamp<int64_t>(static_cast<int64_t>(soulTicks) - internalSoulTicks, 0, sleepTicks));
+	}
+	return true;
 }
 
 bool ConditionSoul::setParam(ConditionParam_t param, int32_t value) {
@@ -2221,7 +2255,12 @@ bool ConditionSpeed::startCondition(std::shared_ptr<Creature> creature) {
 }
 
 bool ConditionSpeed::executeCondition(std::shared_ptr<Creature> creature, int32_t interval) {
-	return Condition::executeCondition(creature, interval);
+	if (!Condition::executeCondition(creature, interval)) {
+		return false;
+	}
+
+	sleepUntilEnd();
+	return true;
 }
 
 void ConditionSpeed::endCondition(std::shared_ptr<Creature> creature) {
@@ -2352,7 +2391,12 @@ bool ConditionOutfit::startCondition(std::shared_ptr<Creature> creature) {
 }
 
 bool ConditionOutfit::executeCondition(std::shared_ptr<Creature> creature, int32_t interval) {
-	return Condition::executeCondition(creature, interval);
+	if (!Condition::executeCondition(creature, interval)) {
+		return false;
+	}
+
+	sleepUntilEnd();
+	return true;
 }
 
 void ConditionOutfit::endCondition(std::shared_ptr<Creature> creature) {
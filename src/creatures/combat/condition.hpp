@@ -47,10 +47,30 @@ public:
 		return endTime;
 	}
 	int32_t getTicks() const {
-		return ticks;
+		return ticks == -1 ? ticks : std::max<int32_t>(0, ticks - skippedTicks);
 	}
 	void setTicks(int32_t newTicks);
 
+	/**
+	 * @brief Counts a creature check down, for the conditions with nothing to do until a later check.
+	 * @return Interval to execute the condition with, or 0 while it still sleeps.
+	 */
+	int32_t wake(int32_t interval) {
+		if (sleepTicks == SLEEP_UNTIL_REMOVED) {
+			return 0;
+		}
+
+		skippedTicks += interval;
+		if (skippedTicks < sleepTicks) {
+			return 0;
+		}
+
+		const int32_t elapsed = skippedTicks;
+		skippedTicks = 0;
+		sleepTicks = 0;
+		return elapsed;
+	}
+
 	static std::shared_ptr<Condition> createCondition(ConditionId_t id, ConditionType_t type, int32_t ticks, int32_t param = 0, bool buff = false, uint32_t subId = 0, bool isPersistent = false);
 	static std::shared_ptr<Condition> createCondition(PropStream &propStream);
 
@@ -77,7 +97,19 @@ protected:
 
 	virtual bool updateCondition(std::shared_ptr<Condition> addCondition);
 
+	static constexpr int32_t SLEEP_UNTIL_REMOVED = std::numeric_limits<int32_t>::max();
+
+	/**
+	 * @brief Lets the creature checks skip the condition until it ends, when it has nothing to do on each tick.
+	 */
+	void sleepUntilEnd();
+
+	// Time of creature checks the condition can skip, counted down by wake
+	int32_t sleepTicks = 0;
+
 private:
+	int32_t skippedTicks = 0;
+
 	SoundEffect_t tickSound = SoundEffect_t::SILENCE;
 	SoundEffect_t addSound = SoundEffect_t::SILENCE;
 
@@ -103,9 +103,44 @@ TalkActionResult_t Spells::playerSaySpell(std::shared_ptr<Player> player, std::s
 
 void Spells::clear() {
 	instants.clear();
+	instantWords.assign(1, {});
 	runes.clear();
 }
 
+void Spells::clearScriptFile(const std::string &file) {
+	const auto ownedBy = [&file](const auto &entry) { return entry.second->getScriptFile() == file; };
+	if (std::erase_if(instants, ownedBy) > 0) {
+		instantWords.assign(1, {});
+		for (const auto &[words, instant] : instants) {
+			addInstantWords(words, instant);
+		}
+	}
+	std::erase_if(runes, ownedBy);
+}
+
+void Spells::addInstantWords(const std::string &words, const std::shared_ptr<InstantSpell> &instant) {
+	uint32_t node = 0;
+	for (const char character : words) {
+		const char lower = static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+		const auto &children = instantWords[node].children;
+		const auto child = std::ranges::find(children, lower, &std::pair<char, uint32_t>::first);
+		if (child != children.end()) {
+			node = child->second;
+			continue;
+		}
+
+		const auto next = static_cast<uint32_t>(instantWords.size());
+		instantWords[node].children.emplace_back(lower, next);
+		instantWords.emplace_back();
+		node = next;
+	}
+
+	// Words only differing in case keep the first spell registered
+	if (!instantWords[node].spell) {
+		instantWords[node].spell = instant;
+	}
+}
+
 bool Spells::hasInstantSpell(const std::string &word) const {
 	if (auto iterate = instants.find(word);
 	    iterate != instants.end()) {
@@ -204,38 +239,41 @@ std::shared_ptr<RuneSpell> Spells::getRuneSpellByName(const std::string &name) {
 	return nullptr;
 }
 
-std::shared_ptr<InstantSpell> Spells::getInstantSpell(const std::string &words) {
-	std::shared_ptr<InstantSpell> result = nullptr;
+std::shared_ptr<InstantSpell> Spells::getInstantSpell(std::string_view words) const {
+	const WordsNode* result = nullptr;
+	size_t spellLen = 0;
+
+	uint32_t node = 0;
+	for (size_t i = 0; i < words.length(); ++i) {
+		const char lower = static_cast<char>(std::tolower(static_cast<unsigned char>(words[i])));
+		const auto &children = instantWords[node].children;
+		const auto child = std::ranges::find(children, lower, &std::pair<char, uint32_t>::first);
+		if (child == children.end()) {
+			break;
+		}
 
-	for (auto &it : instants) {
-		const std::string &instantSpellWords = it.second->getWords();
-		size_t spellLen = instantSpellWords.length();
-		if (strncasecmp(instantSpellWords.c_str(), words.c_str(), spellLen) == 0) {
-			if (!result || spellLen > result->getWords().length()) {
-				result = it.second;
-				if (words.length() == spellLen) {
-					break;
-				}
-			}
+		node = child->second;
+		if (instantWords[node].spell) {
+			result = &instantWords[node];
+			spellLen = i + 1;
 		}
 	}
 
-	if (result) {
-		const std::string &resultWords = result->getWords();
-		if (words.length() > resultWords.length()) {
-			if (!result->getHasParam()) {
-				return nullptr;
-			}
+	if (!result) {
+		return nullptr;
+	}
 
-			size_t spellLen = resultWords.length();
-			size_t paramLen = words.length() - spellLen;
-			if (paramLen < 2 || words[spellLen] != ' ') {
-				return nullptr;
-			}
+	if (words.length() > spellLen) {
+		if (!result->spell->getHasParam()) {
+			return nullptr;
+		}
+
+		size_t paramLen = words.length() - spellLen;
+		if (paramLen < 2 || words[spellLen] != ' ') {
+			return nullptr;
 		}
-		return result;
 	}
-	return nullptr;
+	return result->spell;
 }
 
 std::shared_ptr<InstantSpell> Spells::getInstantSpellById(uint16_t spellId) {
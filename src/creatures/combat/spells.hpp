@@ -41,7 +41,11 @@ public:
 	std::shared_ptr<RuneSpell> getRuneSpell(uint16_t id);
 	std::shared_ptr<RuneSpell> getRuneSpellByName(const std::string &name);
 
-	std::shared_ptr<InstantSpell> getInstantSpell(const std::string &words);
+	/**
+	 * @brief Instant spell whose words, ignoring case, are the longest prefix of what was said.
+	 * Text after the words is only accepted as the parameter of a spell that takes one.
+	 */
+	std::shared_ptr<InstantSpell> getInstantSpell(std::string_view words) const;
 	std::shared_ptr<InstantSpell> getInstantSpellByName(const std::string &name);
 
 	std::shared_ptr<InstantSpell> getInstantSpellById(uint16_t spellId);
@@ -59,16 +63,29 @@ public:
 	[[nodiscard]] bool hasInstantSpell(const std::string &word) const;
 
 	void setInstantSpell(const std::string &word, const std::shared_ptr<InstantSpell> instant) {
-		instants.try_emplace(word, instant);
+		if (instants.try_emplace(word, instant).second) {
+			addInstantWords(word, instant);
+		}
 	}
 
 	void clear();
+	void clearScriptFile(const std::string &file);
 	bool registerInstantLuaEvent(std::shared_ptr<InstantSpell> instant);
 	bool registerRuneLuaEvent(std::shared_ptr<RuneSpell> rune);
 
 private:
+	struct WordsNode {
+		// Lower case character and index of the next node, few per node
+		std::vector<std::pair<char, uint32_t>> children;
+		std::shared_ptr<InstantSpell> spell;
+	};
+
+	void addInstantWords(const std::string &words, const std::shared_ptr<InstantSpell> &instant);
+
 	std::map<uint16_t, std::shared_ptr<RuneSpell>> runes;
 	std::map<std::string, std::shared_ptr<InstantSpell>> instants;
+	// Trie of the instant spell words, walked once per said text without lower casing it
+	std::vector<WordsNode> instantWords { 1 };
 
 	friend class CombatSpell;
 };
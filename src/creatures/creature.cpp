@@ -18,6 +18,8 @@
 #include "map/spectators.hpp"
 #include "lib/metrics/metrics.hpp"
 
+std::atomic_uint32_t Creature::queuedPathfinders = 0;
+
 Creature::Creature() {
 	onIdleStatus();
 }
@@ -91,11 +93,6 @@ int32_t Creature::getWalkSize() {
 
 void Creature::onThink(uint32_t interval) {
 	metrics::method_latency measure(__METHOD_NAME__);
-	if (!isMapLoaded && useCacheMap()) {
-		isMapLoaded = true;
-		updateMapCache();
-	}
-
 	auto followCreature = getFollowCreature();
 	auto master = getMaster();
 	if (followCreature && master != followCreature && !canSeeCreature(followCreature)) {
@@ -113,7 +110,10 @@ void Creature::onThink(uint32_t interval) {
 		blockTicks = 0;
 	}
 
-	if (followCreature) {
+	if (followPathPrepared) {
+		// The path was already refreshed by the parallel phase of Game::checkCreatures
+		followPathPrepared = false;
+	} else if (followCreature) {
 		walkUpdateTicks += interval;
 		if (forceUpdateFollowPath || walkUpdateTicks >= 2000) {
 			walkUpdateTicks = 0;
@@ -124,6 +124,9 @@ void Creature::onThink(uint32_t interval) {
 
 	auto onThink = [self = getCreature(), interval] {
 		// scripting event - onThink
+		if (!self->hasEventRegistered(CREATURE_EVENT_THINK)) {
+			return;
+		}
 		const auto &thinkEvents = self->getCreatureEvents(CREATURE_EVENT_THINK);
 		for (const auto &creatureEventPtr : thinkEvents) {
 			creatureEventPtr->executeOnThink(self->static_self_cast<Creature>(), interval);
@@ -148,14 +151,26 @@ void Creature::onAttacking(uint32_t interval) {
 	onAttacked();
 	attackedCreature->onAttacked();
 
-	if (g_game().isSightClear(getPosition(), attackedCreature->getPosition(), true)) {
+	if (isSightClearTo(getPosition(), attackedCreature->getPosition())) {
 		doAttacking(interval);
 	}
 }
 
+bool Creature::isSightClearTo(const Position &fromPos, const Position &toPos) const {
+	const auto cycle = g_dispatcher().getDispatcherCycle();
+	if (sight.cycle != cycle || sight.fromPos != fromPos || sight.toPos != toPos) {
+		sight.cycle = cycle;
+		sight.fromPos = fromPos;
+		sight.toPos = toPos;
+		sight.clear = g_game().isSightClear(fromPos, toPos, true);
+	}
+	return sight.clear;
+}
+
 void Creature::onIdleStatus() {
 	if (getHealth() > 0) {
 		damageMap.clear();
+		damageTotal = 0;
 		lastHitCreatureId = 0;
 	}
 }
@@ -258,65 +273,24 @@ void Creature::addEventWalk(bool firstStep) {
 				g_game().checkCreatureWalk(self->getID());
 			}
 
-			self->eventWalk = g_dispatcher().scheduleEvent(
-				static_cast<uint32_t>(ticks),
-				[creatureId = self->getID()] {
-					g_game().checkCreatureWalk(creatureId);
-				},
-				"Game::checkCreatureWalk"
-			);
+			self->eventWalk = g_game().scheduleCreatureWalk(self, static_cast<uint32_t>(ticks));
 		},
 		"Game::checkCreatureWalk"
 	);
 }
 
 void Creature::stopEventWalk() {
-	if (eventWalk != 0) {
-		g_dispatcher().stopEvent(eventWalk);
-		eventWalk = 0;
-	}
-}
-
-void Creature::updateMapCache() {
-	metrics::method_latency measure(__METHOD_NAME__);
-	std::shared_ptr<Tile> newTile;
-	const Position &myPos = getPosition();
-	Position pos(0, 0, myPos.z);
-
-	for (int32_t y = -maxWalkCacheHeight; y <= maxWalkCacheHeight; ++y) {
-		for (int32_t x = -maxWalkCacheWidth; x <= maxWalkCacheWidth; ++x) {
-			pos.x = myPos.getX() + x;
-			pos.y = myPos.getY() + y;
-			newTile = g_game().map.getTile(pos);
-			updateTileCache(newTile, pos);
-		}
-	}
-}
-
-void Creature::updateTileCache(std::shared_ptr<Tile> newTile, int32_t dx, int32_t dy) {
-	metrics::method_latency measure(__METHOD_NAME__);
-	if (std::abs(dx) <= maxWalkCacheWidth && std::abs(dy) <= maxWalkCacheHeight) {
-		localMapCache[maxWalkCacheHeight + dy][maxWalkCacheWidth + dx] = newTile && newTile->queryAdd(0, getCreature(), 1, FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE) == RETURNVALUE_NOERROR;
-	}
-}
-
-void Creature::updateTileCache(std::shared_ptr<Tile> upTile, const Position &pos) {
-	const Position &myPos = getPosition();
-	if (pos.z == myPos.z) {
-		int32_t dx = Position::getOffsetX(pos, myPos);
-		int32_t dy = Position::getOffsetY(pos, myPos);
-		updateTileCache(std::move(upTile), dx, dy);
-	}
+	// The walk batch skips the creature once its token is gone
+	eventWalk = 0;
 }
 
 int32_t Creature::getWalkCache(const Position &pos) {
-	metrics::method_latency measure(__METHOD_NAME__);
 	if (!useCacheMap()) {
 		return 2;
 	}
 
 	const Position &myPos = getPosition();
-	if (myPos.z != pos.z) {
+	if (myPos.z != pos.z || isMoveLocked()) {
 		return 0;
 	}
 
@@ -324,74 +298,39 @@ int32_t Creature::getWalkCache(const Position &pos) {
 		return 1;
 	}
 
-	int32_t dx = Position::getOffsetX(pos, myPos);
-	if (std::abs(dx) <= maxWalkCacheWidth) {
-		int32_t dy = Position::getOffsetY(pos, myPos);
-		if (std::abs(dy) <= maxWalkCacheHeight) {
-			return localMapCache[maxWalkCacheHeight + dy][maxWalkCacheWidth + dx];
-		}
-	}
-
-	// out of range
-	return 2;
-}
-
-void Creature::onAddTileItem(std::shared_ptr<Tile> tileItem, const Position &pos) {
-	if (isMapLoaded && pos.z == getPosition().z) {
-		updateTileCache(std::move(tileItem), pos);
-	}
-}
-
-void Creature::onUpdateTileItem(std::shared_ptr<Tile> updateTile, const Position &pos, std::shared_ptr<Item>, const ItemType &oldType, std::shared_ptr<Item>, const ItemType &newType) {
-	if (!isMapLoaded) {
-		return;
+	const auto sector = g_game().map.getMapSector(pos.x, pos.y);
+	const auto &floor = sector ? sector->getFloor(pos.z) : nullptr;
+	if (!floor) {
+		return 0;
 	}
 
-	if (oldType.blockSolid || oldType.blockPathFind || newType.blockPathFind || newType.blockSolid) {
-		if (pos.z == getPosition().z) {
-			updateTileCache(std::move(updateTile), pos);
-		}
+	const uint8_t flags = floor->getPathFlags(pos.x, pos.y);
+	if (!(flags & Floor::PATH_TILE)) {
+		// Not loaded yet, the tile itself has to answer
+		return 2;
 	}
-}
 
-void Creature::onRemoveTileItem(std::shared_ptr<Tile> updateTile, const Position &pos, const ItemType &iType, std::shared_ptr<Item>) {
-	if (!isMapLoaded) {
-		return;
+	if (flags & Floor::PATH_BLOCKMONSTER) {
+		return 0;
 	}
 
-	if (iType.blockSolid || iType.blockPathFind || iType.isGroundTile()) {
-		if (pos.z == getPosition().z) {
-			updateTileCache(std::move(updateTile), pos);
-		}
+	// Creatures, fields and the rules that depend on the monster are checked on the tile
+	if (flags & (Floor::PATH_CREATURE | Floor::PATH_FIELD | Floor::PATH_CHECKMONSTER)) {
+		return 2;
 	}
+	return 1;
 }
 
 void Creature::onCreatureAppear(std::shared_ptr<Creature> creature, bool isLogin) {
 	metrics::method_latency measure(__METHOD_NAME__);
-	if (creature == getCreature()) {
-		if (useCacheMap()) {
-			isMapLoaded = true;
-			updateMapCache();
-		}
-
-		if (isLogin) {
-			setLastPosition(getPosition());
-		}
-	} else if (isMapLoaded) {
-		if (creature->getPosition().z == getPosition().z) {
-			updateTileCache(creature->getTile(), creature->getPosition());
-		}
+	if (creature == getCreature() && isLogin) {
+		setLastPosition(getPosition());
 	}
 }
 
 void Creature::onRemoveCreature(std::shared_ptr<Creature> creature, bool) {
 	metrics::method_latency measure(__METHOD_NAME__);
 	onCreatureDisappear(creature, true);
-	if (creature != getCreature() && isMapLoaded) {
-		if (creature->getPosition().z == getPosition().z) {
-			updateTileCache(creature->getTile(), creature->getPosition());
-		}
-	}
 
 	// Update player from monster target list (avoid memory usage after clean)
 	if (auto monster = getMonster(); monster && monster->getAttackedCreature() == creature) {
@@ -490,6 +429,15 @@ void Creature::onCreatureMove(const std::shared_ptr<Creature> &creature, const s
 			stopEventWalk();
 		}
 
+		if (teleport || oldPos.z != newPos.z || !hasSummons()) {
+			stepTrail.clear();
+		} else {
+			if (stepTrail.size() == STEP_TRAIL_SIZE) {
+				stepTrail.erase(stepTrail.begin());
+			}
+			stepTrail.push_back(oldPos);
+		}
+
 		bool configTeleportSummons = g_configManager().getBoolean(TELEPORT_SUMMONS, __FUNCTION__);
 		checkSummonMove(newPos, configTeleportSummons);
 		if (isLostSummon()) {
@@ -505,101 +453,6 @@ void Creature::onCreatureMove(const std::shared_ptr<Creature> &creature, const s
 		if (newTile->getZoneType() != oldTile->getZoneType()) {
 			onChangeZone(getZoneType());
 		}
-
-		// update map cache
-		if (isMapLoaded) {
-			if (teleport || oldPos.z != newPos.z) {
-				updateMapCache();
-			} else {
-				const Position &myPos = getPosition();
-
-				if (oldPos.y > newPos.y) { // north
-					// shift y south
-					for (int32_t y = mapWalkHeight - 1; --y >= 0;) {
-						memcpy(localMapCache[y + 1], localMapCache[y], sizeof(localMapCache[y]));
-					}
-
-					// update 0
-					for (int32_t x = -maxWalkCacheWidth; x <= maxWalkCacheWidth; ++x) {
-						const auto &cacheTile = g_game().map.getTile(static_cast<uint16_t>(myPos.getX() + x), static_cast<uint16_t>(myPos.getY() - maxWalkCacheHeight), myPos.z);
-						updateTileCache(cacheTile, x, -maxWalkCacheHeight);
-					}
-				} else if (oldPos.y < newPos.y) { // south
-					// shift y north
-					for (int32_t y = 0; y <= mapWalkHeight - 2; ++y) {
-						memcpy(localMapCache[y], localMapCache[y + 1], sizeof(localMapCache[y]));
-					}
-
-					// update mapWalkHeight - 1
-					for (int32_t x = -maxWalkCacheWidth; x <= maxWalkCacheWidth; ++x) {
-						const auto &cacheTile = g_game().map.getTile(static_cast<uint16_t>(myPos.getX() + x), static_cast<uint16_t>(myPos.getY() + maxWalkCacheHeight), myPos.z);
-						updateTileCache(cacheTile, x, maxWalkCacheHeight);
-					}
-				}
-
-				if (oldPos.x < newPos.x) { // east
-					// shift y west
-					int32_t starty = 0;
-					int32_t endy = mapWalkHeight - 1;
-					int32_t dy = Position::getDistanceY(oldPos, newPos);
-
-					if (dy < 0) {
-						endy += dy;
-					} else if (dy > 0) {
-						starty = dy;
-					}
-
-					for (int32_t y = starty; y <= endy; ++y) {
-						for (int32_t x = 0; x <= mapWalkWidth - 2; ++x) {
-							localMapCache[y][x] = localMapCache[y][x + 1];
-						}
-					}
-
-					// update mapWalkWidth - 1
-					for (int32_t y = -maxWalkCacheHeight; y <= maxWalkCacheHeight; ++y) {
-						const auto &cacheTile = g_game().map.getTile(myPos.x + maxWalkCacheWidth, static_cast<uint16_t>(myPos.y + y), myPos.z);
-						updateTileCache(cacheTile, maxWalkCacheWidth, y);
-					}
-				} else if (oldPos.x > newPos.x) { // west
-					// shift y east
-					int32_t starty = 0;
-					int32_t endy = mapWalkHeight - 1;
-					int32_t dy = Position::getDistanceY(oldPos, newPos);
-
-					if (dy < 0) {
-						endy += dy;
-					} else if (dy > 0) {
-						starty = dy;
-					}
-
-					for (int32_t y = starty; y <= endy; ++y) {
-						for (int32_t x = mapWalkWidth - 1; --x >= 0;) {
-							localMapCache[y][x + 1] = localMapCache[y][x];
-						}
-					}
-
-					// update 0
-					for (int32_t y = -maxWalkCacheHeight; y <= maxWalkCacheHeight; ++y) {
-						std::shared_ptr<Tile> cacheTile = g_game().map.getTile(myPos.x - maxWalkCacheWidth, static_cast<uint16_t>(myPos.y + y), myPos.z);
-						updateTileCache(cacheTile, -maxWalkCacheWidth, y);
-					}
-				}
-
-				updateTileCache(oldTile, oldPos);
-			}
-		}
-	} else {
-		if (isMapLoaded) {
-			const Position &myPos = getPosition();
-
-			if (newPos.z == myPos.z) {
-				updateTileCache(newTile, newPos);
-			}
-
-			if (oldPos.z == myPos.z) {
-				updateTileCache(oldTile, oldPos);
-			}
-		}
 	}
 
 	const auto &followCreature = getFollowCreature();
@@ -653,41 +506,67 @@ void Creature::onDeath() {
 	const int64_t timeNow = OTSYS_TIME();
 	const uint32_t inFightTicks = g_configManager().getNumber(PZ_LOCKED, __FUNCTION__);
 	int32_t mostDamage = 0;
+
+	// Share of every attacker, a boss fought by many players computes them in one batch before the serial part
+	struct DeathShare {
+		std::shared_ptr<Creature> attacker;
+		CountBlock_t block;
+		uint64_t gainExp = 0;
+	};
+	constexpr size_t batchShares = 50;
+	std::vector<DeathShare> shares;
+	shares.reserve(damageMap.size());
+	for (const auto &[attackerId, block] : damageMap) {
+		if (auto attacker = g_game().getCreatureByID(attackerId)) {
+			shares.emplace_back(DeathShare { std::move(attacker), block });
+		}
+	}
+
+	const auto computeShare = [this, &shares](size_t i) {
+		auto &share = shares[i];
+		if (share.attacker.get() != this) {
+			share.gainExp = getGainedExperience(share.attacker);
+		}
+	};
+	if (shares.size() >= batchShares) {
+		g_dispatcher().asyncWait(shares.size(), computeShare);
+	} else {
+		for (size_t i = 0; i < shares.size(); ++i) {
+			computeShare(i);
+		}
+	}
+
 	std::map<std::shared_ptr<Creature>, uint64_t> experienceMap;
 	std::unordered_set<std::shared_ptr<Player>> killers;
-	for (const auto &it : damageMap) {
-		if (auto attacker = g_game().getCreatureByID(it.first)) {
-			CountBlock_t cb = it.second;
-			if ((cb.total > mostDamage && (timeNow - cb.ticks <= inFightTicks))) {
-				mostDamage = cb.total;
-				mostDamageCreature = attacker;
-			}
-
-			if (attacker != getCreature()) {
-				uint64_t gainExp = getGainedExperience(attacker);
-				auto attackerMaster = attacker->getMaster() ? attacker->getMaster() : attacker;
-				if (auto attackerPlayer = attackerMaster->getPlayer()) {
-					attackerPlayer->removeAttacked(getPlayer());
-
-					auto party = attackerPlayer->getParty();
-					killers.insert(attackerPlayer);
-					if (party && party->getLeader() && party->isSharedExperienceActive() && party->isSharedExperienceEnabled()) {
-						attacker = party->getLeader();
-						killers.insert(party->getLeader());
-						mostDamageCreature = attacker;
-
-						for (const auto &partyMember : party->getMembers()) {
-							killers.insert(partyMember);
-						}
+	for (auto &[attacker, cb, gainExp] : shares) {
+		if ((cb.total > mostDamage && (timeNow - cb.ticks <= inFightTicks))) {
+			mostDamage = cb.total;
+			mostDamageCreature = attacker;
+		}
+
+		if (attacker.get() != this) {
+			auto attackerMaster = attacker->getMaster() ? attacker->getMaster() : attacker;
+			if (auto attackerPlayer = attackerMaster->getPlayer()) {
+				attackerPlayer->removeAttacked(getPlayer());
+
+				auto party = attackerPlayer->getParty();
+				killers.insert(attackerPlayer);
+				if (party && party->getLeader() && party->isSharedExperienceActive() && party->isSharedExperienceEnabled()) {
+					attacker = party->getLeader();
+					killers.insert(party->getLeader());
+					mostDamageCreature = attacker;
+
+					for (const auto &partyMember : party->getMembers()) {
+						killers.insert(partyMember);
 					}
 				}
+			}
 
-				auto tmpIt = experienceMap.find(attacker);
-				if (tmpIt == experienceMap.end()) {
-					experienceMap[attacker] = gainExp;
-				} else {
-					tmpIt->second += gainExp;
-				}
+			auto tmpIt = experienceMap.find(attacker);
+			if (tmpIt == experienceMap.end()) {
+				experienceMap[attacker] = gainExp;
+			} else {
+				tmpIt->second += gainExp;
 			}
 		}
 	}
@@ -1054,19 +933,29 @@ void Creature::getPathSearchParams(const std::shared_ptr<Creature> &, FindPathPa
 
 void Creature::goToFollowCreature_async(std::function<void()> &&onComplete) {
 	metrics::method_latency measure(__METHOD_NAME__);
-	if (pathfinderRunning.load()) {
+	// One request per creature, the follow path is refreshed again on a later think
+	if (pathfinderRunning.exchange(true)) {
 		return;
 	}
 
-	pathfinderRunning.store(true);
-	g_dispatcher().asyncEvent([self = getCreature()] {
-		if (!self || self->isRemoved()) {
-			return;
-		}
-
-		self->goToFollowCreature();
-		self->pathfinderRunning.store(false);
-	});
+	if (queuedPathfinders.fetch_add(1) >= MAX_QUEUED_PATHFINDERS) {
+		queuedPathfinders.fetch_sub(1);
+		pathfinderRunning.store(false);
+		g_metrics().addCounter("pathfinder_dropped", 1);
+	} else {
+		g_metrics().addUpDownCounter("pathfinder_queue_depth", 1);
+		g_dispatcher().asyncEvent(
+			[self = getCreature()] {
+				queuedPathfinders.fetch_sub(1);
+				g_metrics().addUpDownCounter("pathfinder_queue_depth", -1);
+				if (!self->isRemoved()) {
+					self->goToFollowCreature();
+				}
+				self->pathfinderRunning.store(false);
+			},
+			TaskGroup::Walk
+		);
+	}
 
 	if (onComplete) {
 		g_dispatcher().context().addEvent(std::move(onComplete), __FUNCTION__);
@@ -1109,7 +998,13 @@ void Creature::goToFollowCreature() {
 	}
 
 	if (listDir.empty()) {
-		hasFollowPath = getPathTo(followCreature->getPosition(), listDir, fpp);
+		if (followCreature == getMaster() && getPathAlongTrail(followCreature, fpp, listDir)) {
+			hasFollowPath = true;
+		} else if (monster && g_game().map.followPathCache.getPath(monster, followCreature->getPosition(), fpp, listDir)) {
+			hasFollowPath = true;
+		} else {
+			hasFollowPath = getPathTo(followCreature->getPosition(), listDir, fpp);
+		}
 	}
 
 	startAutoWalk(listDir);
@@ -1119,6 +1014,24 @@ void Creature::goToFollowCreature() {
 	}
 }
 
+void Creature::prepareFollowPath(uint32_t interval) {
+	if (!getFollowCreature() || pathfinderRunning.load()) {
+		return;
+	}
+
+	if (!forceUpdateFollowPath && walkUpdateTicks + interval < 2000) {
+		return;
+	}
+
+	walkUpdateTicks = 0;
+	forceUpdateFollowPath = false;
+	followPathPrepared = true;
+
+	pathfinderRunning.store(true);
+	goToFollowCreature();
+	pathfinderRunning.store(false);
+}
+
 bool Creature::canFollowMaster() {
 	auto master = getMaster();
 	if (!master) {
@@ -1165,22 +1078,13 @@ bool Creature::setFollowCreature(std::shared_ptr<Creature> creature) {
 }
 
 double Creature::getDamageRatio(std::shared_ptr<Creature> attacker) const {
-	uint32_t totalDamage = 0;
-	uint32_t attackerDamage = 0;
-
-	for (const auto &it : damageMap) {
-		const CountBlock_t &cb = it.second;
-		totalDamage += cb.total;
-		if (it.first == attacker->getID()) {
-			attackerDamage += cb.total;
-		}
-	}
-
-	if (totalDamage == 0) {
+	if (damageTotal == 0) {
 		return 0;
 	}
 
-	return (static_cast<double>(attackerDamage) / totalDamage);
+	const auto it = damageMap.find(attacker->getID());
+	const uint32_t attackerDamage = it != damageMap.end() ? it->second.total : 0;
+	return (static_cast<double>(attackerDamage) / damageTotal);
 }
 
 uint64_t Creature::getGainedExperience(std::shared_ptr<Creature> attacker) const {
@@ -1204,6 +1108,7 @@ void Creature::addDamagePoints(std::shared_ptr<Creature> attacker, int32_t damag
 		it->second.total += damagePoints;
 		it->second.ticks = OTSYS_TIME();
 	}
+	damageTotal += damagePoints;
 
 	lastHitCreatureId = attackerId;
 }
@@ -1499,8 +1404,15 @@ void Creature::executeConditions(uint32_t interval) {
 	metrics::method_latency measure(__METHOD_NAME__);
 	auto it = conditions.begin(), end = conditions.end();
 	while (it != end) {
+		// Buffs waiting for their end only count the check down
+		const int32_t elapsed = (*it)->wake(static_cast<int32_t>(interval));
+		if (elapsed == 0) {
+			++it;
+			continue;
+		}
+
 		std::shared_ptr<Condition> condition = *it;
-		if (!condition->executeCondition(getCreature(), interval)) {
+		if (!condition->executeCondition(getCreature(), elapsed)) {
 			ConditionType_t type = condition->getType();
 
 			it = conditions.erase(it);
@@ -1603,17 +1515,17 @@ bool Creature::registerCreatureEvent(const std::string &name) {
 	}
 
 	CreatureEventType_t type = event->getEventType();
-	if (hasEventRegistered(type)) {
-		for (const auto &creatureEventPtr : eventsList) {
-			if (creatureEventPtr == event) {
-				return false;
-			}
-		}
-	} else {
-		scriptEventsBitField |= static_cast<uint32_t>(1) << type;
+	if (type >= CREATURE_EVENT_LAST) {
+		return false;
 	}
 
-	eventsList.push_back(event);
+	auto &events = eventsByType[type];
+	if (std::ranges::find(events, event) != events.end()) {
+		return false;
+	}
+
+	events.push_back(event);
+	scriptEventsBitField |= static_cast<uint32_t>(1) << type;
 	return true;
 }
 
@@ -1628,42 +1540,21 @@ bool Creature::unregisterCreatureEvent(const std::string &name) {
 		return false;
 	}
 
-	bool resetTypeBit = true;
-
-	auto it = eventsList.begin(), end = eventsList.end();
-	while (it != end) {
-		const auto curEvent = *it;
-		if (curEvent == event) {
-			it = eventsList.erase(it);
-			continue;
-		}
-
-		if (curEvent->getEventType() == type) {
-			resetTypeBit = false;
-		}
-		++it;
-	}
-
-	if (resetTypeBit) {
+	auto &events = eventsByType[type];
+	std::erase(events, event);
+	if (events.empty()) {
 		scriptEventsBitField &= ~(static_cast<uint32_t>(1) << type);
 	}
 	return true;
 }
 
 CreatureEventList Creature::getCreatureEvents(CreatureEventType_t type) {
-	CreatureEventList tmpEventList;
-
 	if (!hasEventRegistered(type)) {
-		return tmpEventList;
+		return {};
 	}
 
-	for (const auto &creatureEventPtr : eventsList) {
-		if (creatureEventPtr->getEventType() == type) {
-			tmpEventList.push_back(creatureEventPtr);
-		}
-	}
-
-	return tmpEventList;
+	// A copy, the scripts it runs may unregister events
+	return eventsByType[type];
 }
 
 bool FrozenPathingConditionCall::isInRange(const Position &startPos, const Position &testPos, const FindPathParams &fpp) const {
@@ -1750,10 +1641,60 @@ bool Creature::isInvisible() const {
 
 bool Creature::getPathTo(const Position &targetPos, std::vector<Direction> &dirList, const FindPathParams &fpp) {
 	metrics::method_latency measure(__METHOD_NAME__);
+	bool found;
 	if (fpp.maxSearchDist != 0 || fpp.keepDistance) {
-		return g_game().map.getPathMatchingCond(getCreature(), targetPos, dirList, FrozenPathingConditionCall(targetPos), fpp);
+		found = g_game().map.getPathMatchingCond(getCreature(), targetPos, dirList, FrozenPathingConditionCall(targetPos), fpp);
+	} else {
+		found = g_game().map.getPathMatching(getCreature(), targetPos, dirList, FrozenPathingConditionCall(targetPos), fpp);
 	}
-	return g_game().map.getPathMatching(getCreature(), targetPos, dirList, FrozenPathingConditionCall(targetPos), fpp);
+
+	// The local search gives up after a few hundred nodes, longer routes go over the sector graph.
+	// Monsters are left out: their walkability (protection zones, fields) is not modelled there
+	if (found || fpp.keepDistance || getMonster() || Position::getDistanceX(getPosition(), targetPos) + Position::getDistanceY(getPosition(), targetPos) < SECTOR_SIZE) {
+		return found;
+	}
+	return g_game().map.sectorGraph.findPath(g_game().map, getPosition(), targetPos, fpp, dirList);
+}
+
+bool Creature::getPathAlongTrail(const std::shared_ptr<Creature> &leader, const FindPathParams &fpp, std::vector<Direction> &dirList) {
+	// Read during the walk tasks, while no creature moves
+	const auto &trail = leader->stepTrail;
+	const Position &startPos = getPosition();
+	const Position &targetPos = leader->getPosition();
+	if (trail.empty() || fpp.keepDistance || startPos.z != targetPos.z) {
+		return false;
+	}
+
+	const auto isNear = [](const Position &from, const Position &to, int32_t distance) {
+		return Position::getDistanceX(from, to) <= distance && Position::getDistanceY(from, to) <= distance;
+	};
+
+	// Joins the trail at its newest tile next to the follower, for the shortest way
+	auto joined = std::find_if(trail.rbegin(), trail.rend(), [&](const Position &pos) { return isNear(pos, startPos, 1); });
+	if (joined == trail.rend()) {
+		return false;
+	}
+
+	std::vector<Direction> steps;
+	Position pos = startPos;
+	for (auto it = joined.base() - 1; it != trail.end() && !isNear(pos, targetPos, fpp.maxTargetDist); ++it) {
+		if (*it == pos) {
+			continue;
+		}
+		if (*it == targetPos || !g_game().map.canWalkTo(getCreature(), *it)) {
+			return false;
+		}
+		steps.emplace_back(getDirectionTo(pos, *it));
+		pos = *it;
+	}
+
+	if (steps.empty() || !isNear(pos, targetPos, fpp.maxTargetDist)) {
+		return false;
+	}
+
+	g_metrics().addCounter("pathfinding_trail_hits", 1);
+	dirList.insert(dirList.end(), steps.rbegin(), steps.rend());
+	return true;
 }
 
 bool Creature::getPathTo(const Position &targetPos, std::vector<Direction> &dirList, int32_t minTargetDist, int32_t maxTargetDist, bool fullPathSearch /*= true*/, bool clearSight /*= true*/, int32_t maxSearchDist /*= 7*/) {
@@ -1897,11 +1838,11 @@ void Creature::setIncreasePercent(CombatType_t combat, int32_t value) {
 	}
 }
 
-std::unordered_set<std::shared_ptr<Zone>> Creature::getZones() {
+ZoneSet::Ptr Creature::getZones() {
 	if (const auto &tile = getTile()) {
 		return tile->getZones();
 	}
-	return {};
+	return ZoneSet::empty();
 }
 
 void Creature::iconChanged() {
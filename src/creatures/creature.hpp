@@ -18,7 +18,7 @@
 #include "items/tile.hpp"
 
 using ConditionList = std::list<std::shared_ptr<Condition>>;
-using CreatureEventList = std::list<std::shared_ptr<CreatureEvent>>;
+using CreatureEventList = std::vector<std::shared_ptr<CreatureEvent>>;
 
 class Map;
 class Thing;
@@ -58,7 +58,7 @@ private:
 // Defines the Base class for all creatures and base functions which
 // every creature has
 
-class Creature : virtual public Thing, public SharedObject {
+class Creature : virtual public Thing, public SharedObject, private MemoryTracked<Creature, MemoryCategory::Creatures> {
 protected:
 	Creature();
 
@@ -298,7 +298,7 @@ public:
 		return ZONE_NORMAL;
 	}
 
-	std::unordered_set<std::shared_ptr<Zone>> getZones();
+	ZoneSet::Ptr getZones();
 
 	// walk functions
 	void startAutoWalk(const std::vector<Direction> &listDir, bool ignoreConditions = false);
@@ -308,6 +308,12 @@ public:
 	void goToFollowCreature_async(std::function<void()> &&onComplete = nullptr);
 	virtual void goToFollowCreature();
 
+	/**
+	 * @brief Refreshes the follow path ahead of onThink when it is due, called from the parallel phase of Game::checkCreatures.
+	 * @param interval The think interval that onThink will be called with.
+	 */
+	void prepareFollowPath(uint32_t interval);
+
 	// walk events
 	virtual void onWalk(Direction &dir);
 	virtual void onWalkAborted() { }
@@ -476,14 +482,17 @@ public:
 
 	virtual void onThink(uint32_t interval);
 	void onAttacking(uint32_t interval);
+	virtual ThinkTier_t getThinkTier() {
+		return ThinkTier_t::Full;
+	}
 	virtual void onCreatureWalk();
 	virtual bool getNextStep(Direction &dir, uint32_t &flags);
 
 	virtual void turnToCreature(std::shared_ptr<Creature> creature);
 
-	void onAddTileItem(std::shared_ptr<Tile> tile, const Position &pos);
-	virtual void onUpdateTileItem(std::shared_ptr<Tile> tile, const Position &pos, std::shared_ptr<Item> oldItem, const ItemType &oldType, std::shared_ptr<Item> newItem, const ItemType &newType);
-	virtual void onRemoveTileItem(std::shared_ptr<Tile> tile, const Position &pos, const ItemType &iType, std::shared_ptr<Item> item);
+	void onAddTileItem(std::shared_ptr<Tile>, const Position &) { }
+	virtual void onUpdateTileItem(std::shared_ptr<Tile>, const Position &, std::shared_ptr<Item>, const ItemType &, std::shared_ptr<Item>, const ItemType &) { }
+	virtual void onRemoveTileItem(std::shared_ptr<Tile>, const Position &, const ItemType &, std::shared_ptr<Item>) { }
 
 	virtual void onCreatureAppear(std::shared_ptr<Creature> creature, bool isLogin);
 	virtual void onRemoveCreature(std::shared_ptr<Creature> creature, bool isLogout);
@@ -590,6 +599,11 @@ public:
 
 	bool getPathTo(const Position &targetPos, std::vector<Direction> &dirList, const FindPathParams &fpp);
 	bool getPathTo(const Position &targetPos, std::vector<Direction> &dirList, int32_t minTargetDist, int32_t maxTargetDist, bool fullPathSearch = true, bool clearSight = true, int32_t maxSearchDist = 7);
+	/**
+	 * @brief Fills the path of a follower along the last steps of the creature it follows, in the same reversed order as getPathTo.
+	 * @return false when the follower is not next to the trail or a tile of it is blocked, it then runs its own search.
+	 */
+	bool getPathAlongTrail(const std::shared_ptr<Creature> &leader, const FindPathParams &fpp, std::vector<Direction> &dirList);
 
 	struct CountBlock_t {
 		int32_t total;
@@ -715,20 +729,26 @@ protected:
 		return false;
 	}
 
-	static constexpr int32_t mapWalkWidth = MAP_MAX_VIEW_PORT_X * 2 + 1;
-	static constexpr int32_t mapWalkHeight = MAP_MAX_VIEW_PORT_Y * 2 + 1;
-	static constexpr int32_t maxWalkCacheWidth = (mapWalkWidth - 1) / 2;
-	static constexpr int32_t maxWalkCacheHeight = (mapWalkHeight - 1) / 2;
+	/**
+	 * @brief Game::isSightClear with a floor check, remembered for the rest of the dispatcher task.
+	 * The think and attack steps ask it several times for the same creature and target.
+	 */
+	bool isSightClearTo(const Position &fromPos, const Position &toPos) const;
 
 	Position position;
 
 	CountMap damageMap;
+	// Sum of the damage map, every attacker share is read against it
+	uint32_t damageTotal = 0;
 
 	std::vector<std::shared_ptr<Creature>> m_summons;
-	CreatureEventList eventsList;
+	// Registered events by type, scriptEventsBitField has the bit of every non empty list
+	std::array<CreatureEventList, CREATURE_EVENT_LAST> eventsByType;
 	ConditionList conditions;
 
 	std::vector<Direction> listWalkDir;
+	// Positions walked from, oldest first, only kept while there are summons to walk them
+	std::vector<Position> stepTrail;
 
 	std::weak_ptr<Tile> m_tile;
 	std::weak_ptr<Creature> m_attackedCreature;
@@ -780,11 +800,12 @@ protected:
 	Direction direction = DIRECTION_SOUTH;
 	Skulls_t skull = SKULL_NONE;
 
-	bool localMapCache[mapWalkHeight][mapWalkWidth] = { { false } };
 	bool isInternalRemoved = false;
-	bool isMapLoaded = false;
 	bool isUpdatingPath = false;
+	bool followPathPrepared = false;
 	bool creatureCheck = false;
+	// Check time gathered since the last onThink, for the creatures that think less often
+	uint32_t pendingThinkInterval = 0;
 	bool inCheckCreaturesVector = false;
 	bool skillLoss = true;
 	bool lootDrop = true;
@@ -802,6 +823,12 @@ protected:
 
 	std::atomic_bool pathfinderRunning = false;
 
+	// Follow path searches waiting for the Walk task group, past the limit a creature retries on a later think
+	static constexpr uint32_t MAX_QUEUED_PATHFINDERS = 4096;
+	static std::atomic_uint32_t queuedPathfinders;
+	// Steps of the trail summons can follow before they need their own search
+	static constexpr size_t STEP_TRAIL_SIZE = 16;
+
 	// use map here instead of phmap to keep the keys in a predictable order
 	std::map<std::string, CreatureIcon> creatureIcons = {};
 
@@ -811,9 +838,6 @@ protected:
 	}
 	CreatureEventList getCreatureEvents(CreatureEventType_t type);
 
-	void updateMapCache();
-	void updateTileCache(std::shared_ptr<Tile> tile, int32_t dx, int32_t dy);
-	void updateTileCache(std::shared_ptr<Tile> tile, const Position &pos);
 	void onCreatureDisappear(std::shared_ptr<Creature> creature, bool isLogout);
 	virtual void doAttacking(uint32_t) { }
 	virtual bool hasExtraSwing() {
@@ -854,6 +878,13 @@ private:
 		}
 	} walk;
 
+	mutable struct {
+		uint64_t cycle { std::numeric_limits<uint64_t>::max() };
+		Position fromPos;
+		Position toPos;
+		bool clear { false };
+	} sight;
+
 	void updateCalculatedStepSpeed() {
 		const auto stepSpeed = getStepSpeed();
 		walk.calculatedStepSpeed = 1;
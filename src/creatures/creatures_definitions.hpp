@@ -714,6 +714,16 @@ enum ChannelEvent_t : uint8_t {
 	CHANNELEVENT_EXCLUDE = 3,
 };
 
+// How often a creature needs its onThink, from Game::checkCreatures
+enum class ThinkTier_t : uint8_t {
+	// In combat, each check
+	Full = 0,
+	// With opponents in sight but nothing to do
+	Idle = 1,
+	// Nobody around
+	Unseen = 2,
+};
+
 enum class VipStatus_t : uint8_t {
 	Offline = 0,
 	Online = 1,
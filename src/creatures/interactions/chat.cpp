@@ -120,8 +120,9 @@ bool ChatChannel::hasUser(const std::shared_ptr<Player> &player) {
 }
 
 void ChatChannel::sendToAll(const std::string &message, SpeakClasses type) const {
+	BroadcastMessage broadcast;
 	for (const auto &it : users) {
-		it.second->sendChannelMessage("", message, type, id);
+		it.second->sendChannelMessage("", message, type, id, &broadcast);
 	}
 }
 
@@ -130,8 +131,10 @@ bool ChatChannel::talk(const std::shared_ptr<Player> &fromPlayer, SpeakClasses t
 		return false;
 	}
 
+	// Encoded once per client protocol and copied to every member
+	BroadcastMessage broadcast;
 	for (const auto &it : users) {
-		it.second->sendToChannel(fromPlayer, type, text, id);
+		it.second->sendToChannel(fromPlayer, type, text, id, &broadcast);
 	}
 	return true;
 }
@@ -16,7 +16,8 @@
 class Party;
 class Player;
 
-using UsersMap = std::map<uint32_t, std::shared_ptr<Player>>;
+// Open addressing, a message to a channel of thousands walks one contiguous array
+using UsersMap = phmap::flat_hash_map<uint32_t, std::shared_ptr<Player>>;
 using InvitedMap = std::map<uint32_t, std::shared_ptr<Player>>;
 
 class ChatChannel {
@@ -21,7 +21,6 @@
 int32_t Monster::despawnRange;
 int32_t Monster::despawnRadius;
 
-uint32_t Monster::monsterAutoID = 0x50000001;
 
 std::shared_ptr<Monster> Monster::createMonster(const std::string &name) {
 	const auto mType = g_monsters().getMonsterType(name);
@@ -56,6 +55,12 @@ Monster::Monster(const std::shared_ptr<MonsterType> mType) :
 	}
 }
 
+void Monster::setID() {
+	if (id == 0) {
+		id = g_game().getNextMonsterId();
+	}
+}
+
 void Monster::addList() {
 	g_game().addMonster(static_self_cast<Monster>());
 }
@@ -288,40 +293,101 @@ void Monster::onCreatureMove(const std::shared_ptr<Creature> &creature, const st
 		updateTargetList();
 		updateIdleStatus();
 	} else {
-		bool canSeeNewPos = canSee(newPos);
-		bool canSeeOldPos = canSee(oldPos);
+		onSeenCreatureMove(creature, newPos, oldPos);
+	}
+}
 
-		if (canSeeNewPos && !canSeeOldPos) {
-			onCreatureEnter(creature);
-		} else if (!canSeeNewPos && canSeeOldPos) {
-			onCreatureLeave(creature);
-		}
+void Monster::onSeenCreatureMove(const std::shared_ptr<Creature> &creature, const Position &newPos, const Position &oldPos) {
+	bool canSeeNewPos = canSee(newPos);
+	bool canSeeOldPos = canSee(oldPos);
 
-		updateIdleStatus();
+	if (canSeeNewPos && !canSeeOldPos) {
+		onCreatureEnter(creature);
+	} else if (!canSeeNewPos && canSeeOldPos) {
+		onCreatureLeave(creature);
+	}
 
-		if (!isSummon()) {
-			if (const auto &followCreature = getFollowCreature()) {
-				const Position &followPosition = followCreature->getPosition();
-				const Position &pos = getPosition();
-
-				int32_t offset_x = Position::getDistanceX(followPosition, pos);
-				int32_t offset_y = Position::getDistanceY(followPosition, pos);
-				if ((offset_x > 1 || offset_y > 1) && mType->info.changeTargetChance > 0) {
-					Direction dir = getDirectionTo(pos, followPosition);
-					const auto &checkPosition = getNextPosition(dir, pos);
-
-					if (const auto &nextTile = g_game().map.getTile(checkPosition)) {
-						const auto &topCreature = nextTile->getTopCreature();
-						if (followCreature != topCreature && isOpponent(topCreature)) {
-							selectTarget(topCreature);
-						}
+	updateIdleStatus();
+
+	if (!isSummon()) {
+		if (const auto &followCreature = getFollowCreature()) {
+			const Position &followPosition = followCreature->getPosition();
+			const Position &pos = getPosition();
+
+			int32_t offset_x = Position::getDistanceX(followPosition, pos);
+			int32_t offset_y = Position::getDistanceY(followPosition, pos);
+			if ((offset_x > 1 || offset_y > 1) && mType->info.changeTargetChance > 0) {
+				Direction dir = getDirectionTo(pos, followPosition);
+				const auto &checkPosition = getNextPosition(dir, pos);
+
+				if (const auto &nextTile = g_game().map.getTile(checkPosition)) {
+					const auto &topCreature = nextTile->getTopCreature();
+					if (followCreature != topCreature && isOpponent(topCreature)) {
+						selectTarget(topCreature);
 					}
 				}
-			} else if (isOpponent(creature)) {
-				// we have no target lets try pick this one
-				selectTarget(creature);
 			}
+		} else if (isOpponent(creature)) {
+			// we have no target lets try pick this one
+			selectTarget(creature);
+		}
+	}
+}
+
+namespace {
+	// Monsters with deferred moves, flushed by one dispatcher task
+	std::vector<std::shared_ptr<Monster>> deferredMoveMonsters;
+}
+
+bool Monster::deferCreatureMove(const std::shared_ptr<Creature> &creature, const Position &oldPos) {
+	// Followed, attacked and scripted moves keep their immediate handling, as do the summons
+	if (creature.get() == this || isSummon() || mType->info.creatureMoveEvent != -1 || creature->getMaster().get() == this) {
+		return false;
+	}
+
+	if (getFollowCreature() == creature || getAttackedCreature() == creature) {
+		return false;
+	}
+
+	// Later steps of the same creature only move its current position
+	const uint32_t creatureId = creature->getID();
+	if (std::ranges::any_of(deferredMoves, [creatureId](const DeferredMove &move) { return move.creatureId == creatureId; })) {
+		return true;
+	}
+
+	if (deferredMoves.empty()) {
+		if (deferredMoveMonsters.empty()) {
+			g_dispatcher().addEvent(&Monster::flushDeferredCreatureMoves, "Monster::flushDeferredCreatureMoves");
+		}
+		deferredMoveMonsters.emplace_back(getMonster());
+	}
+	deferredMoves.emplace_back(creature, creatureId, oldPos);
+	return true;
+}
+
+void Monster::flushDeferredCreatureMoves() {
+	metrics::method_latency measure(__METHOD_NAME__);
+	const auto monsters = std::move(deferredMoveMonsters);
+	deferredMoveMonsters.clear();
+	for (const auto &monster : monsters) {
+		monster->handleDeferredMoves();
+	}
+}
+
+void Monster::handleDeferredMoves() {
+	const auto moves = std::move(deferredMoves);
+	deferredMoves.clear();
+	if (isRemoved()) {
+		return;
+	}
+
+	for (const auto &move : moves) {
+		const auto &creature = move.creature.lock();
+		if (!creature || creature->isRemoved()) {
+			continue;
 		}
+
+		onSeenCreatureMove(creature, creature->getPosition(), move.oldPos);
 	}
 }
 
@@ -845,10 +911,7 @@ void Monster::onAddCondition(ConditionType_t type) {
 	onConditionStatusChange(type);
 }
 
-void Monster::onConditionStatusChange(const ConditionType_t &type) {
-	if (type == CONDITION_FIRE || type == CONDITION_ENERGY || type == CONDITION_POISON) {
-		updateMapCache();
-	}
+void Monster::onConditionStatusChange(const ConditionType_t &) {
 	updateIdleStatus();
 }
 
@@ -856,6 +919,14 @@ void Monster::onEndCondition(ConditionType_t type) {
 	onConditionStatusChange(type);
 }
 
+ThinkTier_t Monster::getThinkTier() {
+	// Scripted thinks and summons keep the full rate, they may count on it
+	if (isSummon() || mType->info.thinkEvent != -1 || getAttackedCreature() || getFollowCreature()) {
+		return ThinkTier_t::Full;
+	}
+	return targetList.empty() ? ThinkTier_t::Unseen : ThinkTier_t::Idle;
+}
+
 void Monster::onThink(uint32_t interval) {
 	Creature::onThink(interval);
 
@@ -959,6 +1030,12 @@ void Monster::doAttacking(uint32_t interval) {
 	const Position &myPos = getPosition();
 	const Position &targetPos = attackedCreature->getPosition();
 
+	// No spell is due before the fastest one, the round goes on without evaluating them
+	if (!extraMeleeAttack && !isFleeing() && attackTicks < mType->info.attackSpellsMinSpeed) {
+		updateLookDirection();
+		return;
+	}
+
 	for (const spellBlock_t &spellBlock : mType->info.attackSpells) {
 		bool inRange = false;
 
@@ -1009,7 +1086,7 @@ bool Monster::canUseAttack(const Position &pos, const std::shared_ptr<Creature>
 		uint32_t distance = std::max<uint32_t>(Position::getDistanceX(pos, targetPos), Position::getDistanceY(pos, targetPos));
 		for (const spellBlock_t &spellBlock : mType->info.attackSpells) {
 			if (spellBlock.range != 0 && distance <= spellBlock.range) {
-				return g_game().isSightClear(pos, targetPos, true);
+				return isSightClearTo(pos, targetPos);
 			}
 		}
 		return false;
@@ -1335,10 +1412,7 @@ void Monster::doWalkBack(uint32_t &flags, Direction &nextDirection, bool &result
 	if (result) {
 		flags |= FLAG_PATHFINDING;
 	} else {
-		if (ignoreFieldDamage) {
-			ignoreFieldDamage = false;
-			updateMapCache();
-		}
+		ignoreFieldDamage = false;
 
 		int32_t distance = std::max<int32_t>(Position::getDistanceX(position, masterPos), Position::getDistanceY(position, masterPos));
 		if (distance == 0) {
@@ -1361,10 +1435,7 @@ void Monster::doFollowCreature(uint32_t &flags, Direction &nextDirection, bool &
 	if (result) {
 		flags |= FLAG_PATHFINDING;
 	} else {
-		if (ignoreFieldDamage) {
-			ignoreFieldDamage = false;
-			updateMapCache();
-		}
+		ignoreFieldDamage = false;
 		// target dancing
 		auto attackedCreature = getAttackedCreature();
 		auto followCreature = getFollowCreature();
@@ -1491,7 +1562,7 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 	int_fast32_t dx = Position::getDistanceX(creaturePos, targetPos);
 	int_fast32_t dy = Position::getDistanceY(creaturePos, targetPos);
 
-	if (int32_t distance = std::max<int32_t>(static_cast<int32_t>(dx), static_cast<int32_t>(dy)); !flee && (distance > targetDistance || !g_game().isSightClear(creaturePos, targetPos, true))) {
+	if (int32_t distance = std::max<int32_t>(static_cast<int32_t>(dx), static_cast<int32_t>(dy)); !flee && (distance > targetDistance || !isSightClearTo(creaturePos, targetPos))) {
 		return false; // let the A* calculate it
 	} else if (!flee && distance == targetDistance) {
 		return true; // we don't really care here, since it's what we wanted to reach (a dancestep will take of dancing in that position)
@@ -2160,7 +2231,6 @@ void Monster::drainHealth(std::shared_ptr<Creature> attacker, int32_t damage) {
 
 	if (damage > 0 && randomStepping) {
 		ignoreFieldDamage = true;
-		updateMapCache();
 	}
 
 	if (isInvisible()) {
@@ -35,11 +35,7 @@ public:
 		return static_self_cast<Monster>();
 	}
 
-	void setID() override {
-		if (id == 0) {
-			id = monsterAutoID++;
-		}
-	}
+	void setID() override;
 
 	void addList() override;
 	void removeList() override;
@@ -145,6 +141,11 @@ public:
 	void onCreatureAppear(std::shared_ptr<Creature> creature, bool isLogin) override;
 	void onRemoveCreature(std::shared_ptr<Creature> creature, bool isLogout) override;
 	void onCreatureMove(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Tile> &newTile, const Position &newPos, const std::shared_ptr<Tile> &oldTile, const Position &oldPos, bool teleport) override;
+	/**
+	 * @brief Queues the move of a creature the monster neither follows nor attacks, handled with the next flush.
+	 * @return false when the move has to be handled right away through onCreatureMove.
+	 */
+	bool deferCreatureMove(const std::shared_ptr<Creature> &creature, const Position &oldPos);
 	void onCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text) override;
 	void onAttackedByPlayer(std::shared_ptr<Player> attackerPlayer);
 	void onSpawn();
@@ -155,6 +156,7 @@ public:
 	void onFollowCreatureComplete(const std::shared_ptr<Creature> &creature) override;
 
 	void onThink(uint32_t interval) override;
+	ThinkTier_t getThinkTier() override;
 
 	bool challengeCreature(std::shared_ptr<Creature> creature, int targetChangeCooldown) override;
 
@@ -288,7 +290,8 @@ public:
 
 	BlockType_t blockHit(std::shared_ptr<Creature> attacker, CombatType_t combatType, int32_t &damage, bool checkDefense = false, bool checkArmor = false, bool field = false) override;
 
-	static uint32_t monsterAutoID;
+	static constexpr uint32_t FIRST_ID = 0x50000001;
+	static constexpr uint32_t LAST_ID = 0x7FFFFFFF;
 
 	void configureForgeSystem();
 
@@ -366,6 +369,16 @@ public:
 	}
 
 private:
+	struct DeferredMove {
+		std::weak_ptr<Creature> creature;
+		uint32_t creatureId;
+		Position oldPos;
+	};
+
+	static void flushDeferredCreatureMoves();
+	void handleDeferredMoves();
+	void onSeenCreatureMove(const std::shared_ptr<Creature> &creature, const Position &newPos, const Position &oldPos);
+
 	auto getTargetIterator(const std::shared_ptr<Creature> &creature) {
 		return std::ranges::find_if(targetList.begin(), targetList.end(), [id = creature->getID()](const std::weak_ptr<Creature> &ref) {
 			const auto &target = ref.lock();
@@ -375,6 +388,8 @@ private:
 
 	std::unordered_map<uint32_t, std::weak_ptr<Creature>> friendList;
 	std::deque<std::weak_ptr<Creature>> targetList;
+	// First position of each creature moved since the last flush
+	std::vector<DeferredMove> deferredMoves;
 
 	time_t timeToChangeFiendish = 0;
 
@@ -480,11 +495,8 @@ private:
 	void dropLoot(std::shared_ptr<Container> corpse, std::shared_ptr<Creature> lastHitCreature) override;
 	void getPathSearchParams(const std::shared_ptr<Creature> &creature, FindPathParams &fpp) override;
 	bool useCacheMap() const override {
-		// return !randomStepping;
-		//  As the map cache is done synchronously for each movement that a monster makes, it is better to disable it,
-		//  as the pathfinder, which is one of the resources that uses this cache the most,
-		//  is multithreding and thus the processing cost is divided between the threads.
-		return false;
+		// Answered by the path flags of the floors, shared by every monster and kept up to date by the tiles
+		return true;
 	}
 
 	friend class MonsterFunctions;
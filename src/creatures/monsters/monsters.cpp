@@ -309,42 +309,58 @@ bool MonsterType::loadCallback(LuaScriptInterface* scriptInterface) {
 	return true;
 }
 
-std::shared_ptr<MonsterType> Monsters::getMonsterType(const std::string &name, bool silent /* = false*/) const {
-	std::string lowerCaseName = asLowerCaseString(name);
-	if (auto it = monsters.find(lowerCaseName);
-	    it != monsters.end()
-	    // We will only return the MonsterType if it match the exact name of the monster
-	    && it->first.find(lowerCaseName) != it->first.npos) {
+std::shared_ptr<MonsterType> Monsters::getMonsterType(std::string_view name, bool silent /* = false*/) const {
+	if (auto it = monsters.find(name);
+	    it != monsters.end()) {
 		return it->second;
 	}
 	if (!silent) {
-		g_logger().error("[Monsters::getMonsterType] - Monster with name {} not exist", lowerCaseName);
+		g_logger().error("[Monsters::getMonsterType] - Monster with name {} not exist", asLowerCaseString(std::string(name)));
 	}
 	return nullptr;
 }
 
 std::shared_ptr<MonsterType> Monsters::getMonsterTypeByRaceId(uint16_t raceId, bool isBoss /* = false*/) const {
-	auto bossType = g_ioBosstiary().getMonsterTypeByBossRaceId(raceId);
-	if (isBoss && bossType) {
-		return bossType;
+	if (isBoss) {
+		if (auto bossType = getBossTypeByRaceId(raceId)) {
+			return bossType;
+		}
 	}
 
-	auto monster_race_map = g_game().getBestiaryList();
-	auto it = monster_race_map.find(raceId);
-	if (it == monster_race_map.end()) {
-		return nullptr;
-	}
+	return raceId < typesByRaceId.size() ? typesByRaceId[raceId] : nullptr;
+}
 
-	return g_monsters().getMonsterType(it->second);
+std::shared_ptr<MonsterType> Monsters::getBossTypeByRaceId(uint16_t raceId) const {
+	return raceId < bossTypesByRaceId.size() ? bossTypesByRaceId[raceId] : nullptr;
 }
 
 bool Monsters::tryAddMonsterType(const std::string &name, const std::shared_ptr<MonsterType> mType) {
 	std::string lowerName = asLowerCaseString(name);
-	if (monsters.find(lowerName) != monsters.end()) {
+	if (monsters.contains(lowerName)) {
 		g_logger().debug("[{}] the monster with name '{}' already exist", __FUNCTION__, name);
 		return false;
 	}
 
-	monsters[lowerName] = mType;
+	monsters.emplace(std::move(lowerName), mType);
 	return true;
 }
+
+void Monsters::addRaceId(uint16_t raceId, const std::shared_ptr<MonsterType> &mType) {
+	setRaceId(typesByRaceId, raceId, mType);
+}
+
+void Monsters::addBossRaceId(uint16_t raceId, const std::shared_ptr<MonsterType> &mType) {
+	setRaceId(bossTypesByRaceId, raceId, mType);
+}
+
+void Monsters::setRaceId(std::vector<std::shared_ptr<MonsterType>> &types, uint16_t raceId, const std::shared_ptr<MonsterType> &mType) {
+	if (raceId == 0) {
+		return;
+	}
+	if (raceId >= types.size()) {
+		types.resize(raceId + 1);
+	}
+	if (!types[raceId]) {
+		types[raceId] = mType;
+	}
+}
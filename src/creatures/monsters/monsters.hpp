@@ -69,6 +69,8 @@ class MonsterType {
 		// We need to keep the order of scripts, so we use a set isntead of an unordered_set
 		std::set<std::string> scripts;
 		std::vector<spellBlock_t> attackSpells;
+		// Speed of the fastest attack spell, 0 without any
+		uint32_t attackSpellsMinSpeed = 0;
 		std::vector<spellBlock_t> defenseSpells;
 		std::vector<summonBlock_t> summons;
 
@@ -271,17 +273,49 @@ public:
 
 	void clear() {
 		monsters.clear();
+		typesByRaceId.clear();
+		bossTypesByRaceId.clear();
 	}
 
-	std::shared_ptr<MonsterType> getMonsterType(const std::string &name, bool silent = false) const;
+	std::shared_ptr<MonsterType> getMonsterType(std::string_view name, bool silent = false) const;
 	std::shared_ptr<MonsterType> getMonsterTypeByRaceId(uint16_t raceId, bool isBoss = false) const;
+	std::shared_ptr<MonsterType> getBossTypeByRaceId(uint16_t raceId) const;
 	bool tryAddMonsterType(const std::string &name, std::shared_ptr<MonsterType> mType);
+	// The first type given a race id keeps it, like the bestiary and bosstiary lists
+	void addRaceId(uint16_t raceId, const std::shared_ptr<MonsterType> &mType);
+	void addBossRaceId(uint16_t raceId, const std::shared_ptr<MonsterType> &mType);
 	bool deserializeSpell(std::shared_ptr<MonsterSpell> spell, spellBlock_t &sb, const std::string &description = "");
 
+	// Looks the lower case keys up by any case, without copying the name
+	struct CaseInsensitiveHash {
+		using is_transparent = void;
+		size_t operator()(std::string_view name) const {
+			size_t hash = 14695981039346656037ull;
+			for (const char character : name) {
+				hash = (hash ^ static_cast<uint8_t>(std::tolower(static_cast<unsigned char>(character)))) * 1099511628211ull;
+			}
+			return hash;
+		}
+	};
+	struct CaseInsensitiveEqual {
+		using is_transparent = void;
+		bool operator()(std::string_view a, std::string_view b) const {
+			return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+				return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+			});
+		}
+	};
+
 	std::unique_ptr<LuaScriptInterface> scriptInterface;
-	std::map<std::string, std::shared_ptr<MonsterType>> monsters;
+	phmap::flat_hash_map<std::string, std::shared_ptr<MonsterType>, CaseInsensitiveHash, CaseInsensitiveEqual> monsters;
 
 private:
+	static void setRaceId(std::vector<std::shared_ptr<MonsterType>> &types, uint16_t raceId, const std::shared_ptr<MonsterType> &mType);
+
+	// Indexed by race id, the ids are dense and below a few thousands
+	std::vector<std::shared_ptr<MonsterType>> typesByRaceId;
+	std::vector<std::shared_ptr<MonsterType>> bossTypesByRaceId;
+
 	std::shared_ptr<ConditionDamage> getDamageCondition(ConditionType_t conditionType, int32_t maxDamage, int32_t minDamage, int32_t startDamage, uint32_t tickInterval);
 };
 
@@ -24,6 +24,84 @@
 static constexpr int32_t MONSTER_MINSPAWN_INTERVAL = 1000; // 1 second
 static constexpr int32_t MONSTER_MAXSPAWN_INTERVAL = 86400000; // 1 day
 
+namespace {
+	struct ParsedSpawnMonster {
+		std::string name;
+		Position pos;
+		Direction dir = DIRECTION_NORTH;
+		uint32_t weight = 1;
+		uint32_t scheduleInterval = 0;
+		// The spawntime that could not be read, warned about when the spawn is built
+		std::optional<std::string> invalidInterval;
+	};
+
+	struct ParsedSpawn {
+		Position centerPos;
+		int32_t radius = -1;
+		bool empty = false;
+		std::vector<ParsedSpawnMonster> monsters;
+		std::exception_ptr exception;
+	};
+
+	void parseSpawnMonster(const pugi::xml_node &spawnMonsterNode, uint32_t defaultInterval, ParsedSpawn &parsed) {
+		parsed.centerPos = Position(
+			pugi::cast<uint16_t>(spawnMonsterNode.attribute("centerx").value()),
+			pugi::cast<uint16_t>(spawnMonsterNode.attribute("centery").value()),
+			pugi::cast<uint16_t>(spawnMonsterNode.attribute("centerz").value())
+		);
+
+		pugi::xml_attribute radiusAttribute = spawnMonsterNode.attribute("radius");
+		if (radiusAttribute) {
+			parsed.radius = pugi::cast<int32_t>(radiusAttribute.value());
+		}
+
+		if (!spawnMonsterNode.first_child()) {
+			parsed.empty = true;
+			return;
+		}
+
+		const auto &centerPos = parsed.centerPos;
+		for (auto childMonsterNode : spawnMonsterNode.children()) {
+			if (strcasecmp(childMonsterNode.name(), "monster") != 0) {
+				continue;
+			}
+
+			pugi::xml_attribute nameAttribute = childMonsterNode.attribute("name");
+			if (!nameAttribute) {
+				continue;
+			}
+
+			auto &monster = parsed.monsters.emplace_back();
+			monster.name = nameAttribute.as_string();
+
+			pugi::xml_attribute directionAttribute = childMonsterNode.attribute("direction");
+			if (directionAttribute) {
+				monster.dir = static_cast<Direction>(pugi::cast<uint16_t>(directionAttribute.value()));
+			}
+
+			auto xOffset = pugi::cast<int16_t>(childMonsterNode.attribute("x").value());
+			auto yOffset = pugi::cast<int16_t>(childMonsterNode.attribute("y").value());
+			monster.pos = Position(
+				static_cast<uint16_t>(centerPos.x + xOffset),
+				static_cast<uint16_t>(centerPos.y + yOffset),
+				centerPos.z
+			);
+
+			pugi::xml_attribute weightAttribute = childMonsterNode.attribute("weight");
+			if (weightAttribute) {
+				monster.weight = pugi::cast<uint32_t>(weightAttribute.value());
+			}
+
+			try {
+				monster.scheduleInterval = pugi::cast<uint32_t>(childMonsterNode.attribute("spawntime").value());
+			} catch (...) {
+				monster.scheduleInterval = defaultInterval;
+				monster.invalidInterval = childMonsterNode.attribute("spawntime").value();
+			}
+		}
+	}
+}
+
 bool SpawnsMonster::loadFromXML(const std::string &filemonstername) {
 	if (isLoaded()) {
 		return true;
@@ -39,70 +117,39 @@ bool SpawnsMonster::loadFromXML(const std::string &filemonstername) {
 	this->filemonstername = filemonstername;
 	loaded = true;
 
-	std::string boostedNameGet = g_game().getBoostedMonsterName();
-
+	std::vector<pugi::xml_node> spawnMonsterNodes;
 	for (auto spawnMonsterNode : doc.child("monsters").children()) {
-		Position centerPos(
-			pugi::cast<uint16_t>(spawnMonsterNode.attribute("centerx").value()),
-			pugi::cast<uint16_t>(spawnMonsterNode.attribute("centery").value()),
-			pugi::cast<uint16_t>(spawnMonsterNode.attribute("centerz").value())
-		);
+		spawnMonsterNodes.emplace_back(spawnMonsterNode);
+	}
 
-		int32_t radius;
-		pugi::xml_attribute radiusAttribute = spawnMonsterNode.attribute("radius");
-		if (radiusAttribute) {
-			radius = pugi::cast<int32_t>(radiusAttribute.value());
-		} else {
-			radius = -1;
+	// The document is only read by the workers; the spawns are built in file order afterwards, since adding a monster looks up zones and monster types
+	const uint32_t defaultInterval = g_configManager().getNumber(DEFAULT_RESPAWN_TIME, __FUNCTION__);
+	std::vector<ParsedSpawn> parsedSpawns(spawnMonsterNodes.size());
+	g_dispatcher().asyncWait(spawnMonsterNodes.size(), [&](size_t i) {
+		try {
+			parseSpawnMonster(spawnMonsterNodes[i], defaultInterval, parsedSpawns[i]);
+		} catch (...) {
+			parsedSpawns[i].exception = std::current_exception();
 		}
+	});
 
-		if (!spawnMonsterNode.first_child()) {
-			g_logger().warn("[SpawnsMonster::loadFromXml] - Empty spawn at position: {} with radius: {}", centerPos.toString(), radius);
-			continue;
+	spawnMonsterList.reserve(spawnMonsterList.size() + parsedSpawns.size());
+	for (const auto &parsed : parsedSpawns) {
+		if (parsed.exception) {
+			std::rethrow_exception(parsed.exception);
 		}
 
-		SpawnMonster &spawnMonster = spawnMonsterList.emplace_back(centerPos, radius);
-
-		for (auto childMonsterNode : spawnMonsterNode.children()) {
-			if (strcasecmp(childMonsterNode.name(), "monster") == 0) {
-				pugi::xml_attribute nameAttribute = childMonsterNode.attribute("name");
-				if (!nameAttribute) {
-					continue;
-				}
-
-				Direction dir;
-
-				pugi::xml_attribute directionAttribute = childMonsterNode.attribute("direction");
-				if (directionAttribute) {
-					dir = static_cast<Direction>(pugi::cast<uint16_t>(directionAttribute.value()));
-				} else {
-					dir = DIRECTION_NORTH;
-				}
-
-				auto xOffset = pugi::cast<int16_t>(childMonsterNode.attribute("x").value());
-				auto yOffset = pugi::cast<int16_t>(childMonsterNode.attribute("y").value());
-				Position pos(
-					static_cast<uint16_t>(centerPos.x + xOffset),
-					static_cast<uint16_t>(centerPos.y + yOffset),
-					centerPos.z
-				);
-
-				pugi::xml_attribute weightAttribute = childMonsterNode.attribute("weight");
-				uint32_t weight = 1;
-				if (weightAttribute) {
-					weight = pugi::cast<uint32_t>(weightAttribute.value());
-				}
-
-				uint32_t scheduleInterval = g_configManager().getNumber(DEFAULT_RESPAWN_TIME, __FUNCTION__);
-
-				try {
-					scheduleInterval = pugi::cast<uint32_t>(childMonsterNode.attribute("spawntime").value());
-				} catch (...) {
-					g_logger().warn("Failed to add schedule interval to monster: {}, interval: {}. Setting to default respawn time: {}", nameAttribute.value(), childMonsterNode.attribute("spawntime").value(), scheduleInterval);
-				}
+		if (parsed.empty) {
+			g_logger().warn("[SpawnsMonster::loadFromXml] - Empty spawn at position: {} with radius: {}", parsed.centerPos.toString(), parsed.radius);
+			continue;
+		}
 
-				spawnMonster.addMonster(nameAttribute.as_string(), pos, dir, scheduleInterval * 1000, weight);
+		SpawnMonster &spawnMonster = spawnMonsterList.emplace_back(parsed.centerPos, parsed.radius);
+		for (const auto &monster : parsed.monsters) {
+			if (monster.invalidInterval) {
+				g_logger().warn("Failed to add schedule interval to monster: {}, interval: {}. Setting to default respawn time: {}", monster.name, *monster.invalidInterval, monster.scheduleInterval);
 			}
+			spawnMonster.addMonster(monster.name, monster.pos, monster.dir, monster.scheduleInterval * 1000, monster.weight);
 		}
 	}
 	return true;
@@ -156,6 +203,11 @@ SpawnMonster::~SpawnMonster() {
 }
 
 bool SpawnMonster::findPlayer(const Position &pos) {
+	// Most spawns have nobody around, the sector counts answer without a spectators lookup
+	if (!g_game().map.hasNearbyPlayers(pos.x, pos.y)) {
+		return false;
+	}
+
 	auto spectators = Spectators().find<Player>(pos);
 	return std::ranges::any_of(spectators, [](const auto &spectator) {
 		return !spectator->getPlayer()->hasFlag(PlayerFlags_t::IgnoredByMonsters);
@@ -21,8 +21,6 @@
 int32_t Npc::despawnRange;
 int32_t Npc::despawnRadius;
 
-uint32_t Npc::npcAutoID = 0x80000000;
-
 std::shared_ptr<Npc> Npc::createNpc(const std::string &name) {
 	const auto &npcType = g_npcs().getNpcType(name);
 	if (!npcType) {
@@ -52,6 +50,12 @@ Npc::Npc(const std::shared_ptr<NpcType> &npcType) :
 	}
 }
 
+void Npc::setID() {
+	if (id == 0) {
+		id = g_game().getNextNpcId();
+	}
+}
+
 void Npc::addList() {
 	g_game().addNpc(static_self_cast<Npc>());
 }
@@ -137,8 +141,10 @@ void Npc::onCreatureMove(const std::shared_ptr<Creature> &creature, const std::s
 }
 
 void Npc::manageIdle() {
-	if (creatureCheck && playerSpectators.empty()) {
-		Game::removeCreatureCheck(static_self_cast<Npc>());
+	if (playerSpectators.empty()) {
+		if (creatureCheck) {
+			Game::removeCreatureCheck(static_self_cast<Npc>());
+		}
 	} else if (!creatureCheck) {
 		g_game().addCreatureCheck(static_self_cast<Npc>());
 	}
@@ -531,14 +537,24 @@ void Npc::onThinkWalk(uint32_t interval) {
 
 void Npc::onCreatureWalk() {
 	Creature::onCreatureWalk();
+	const auto spectators = playerSpectators.size();
 	phmap::erase_if(playerSpectators, [this](const auto &creature) { return !this->canSee(creature->getPosition()); });
+	if (playerSpectators.size() != spectators) {
+		manageIdle();
+	}
 }
 
 void Npc::onPlacedCreature() {
 	loadPlayerSpectators();
+	// Npcs placed away from every player leave the creature checks until one comes close
+	manageIdle();
 }
 
 void Npc::loadPlayerSpectators() {
+	if (!g_game().map.hasNearbyPlayers(position.x, position.y)) {
+		return;
+	}
+
 	auto spec = Spectators().find<Player>(position, true);
 	for (const auto &creature : spec) {
 		if (!creature->getPlayer()->hasFlag(PlayerFlags_t::IgnoredByNpcs)) {
@@ -43,11 +43,7 @@ public:
 		return static_self_cast<Npc>();
 	}
 
-	void setID() override {
-		if (id == 0) {
-			id = npcAutoID++;
-		}
-	}
+	void setID() override;
 
 	void removeList() override;
 	void addList() override;
@@ -105,6 +101,10 @@ public:
 
 		return npcType->info.shopItemVector;
 	}
+	// Encoding of the shop of the type, shared by the players without a list of their own
+	EncodedShop &getEncodedShop() {
+		return npcType->info.encodedShop;
+	}
 
 	bool isPushable() override {
 		return npcType->info.pushable;
@@ -171,7 +171,8 @@ public:
 	void removeShopPlayer(uint32_t playerGUID);
 	void closeAllShopWindows();
 
-	static uint32_t npcAutoID;
+	static constexpr uint32_t FIRST_ID = 0x80000000;
+	static constexpr uint32_t LAST_ID = 0xFFFFFFFE;
 
 	void onCreatureWalk() override;
 
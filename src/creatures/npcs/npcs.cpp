@@ -99,6 +99,7 @@ void NpcType::loadShop(const std::shared_ptr<NpcType> &npcType, ShopBlock shopBl
 		}
 	}
 	npcType->info.shopItemVector.push_back(shopBlock);
+	npcType->info.encodedShop = {};
 
 	info.speechBubble = SPEECHBUBBLE_TRADE;
 }
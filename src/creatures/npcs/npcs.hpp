@@ -23,6 +23,13 @@ public:
 	ShopBlock shopBlock;
 };
 
+// The shop items of a npc type as ProtocolGame::sendShop writes them, the same for every player
+struct EncodedShop {
+	std::string bytes;
+	// Start of each item in bytes, followed by the end of the last one
+	std::vector<uint32_t> offsets;
+};
+
 class NpcType : public SharedObject {
 	struct NpcInfo {
 		LuaScriptInterface* scriptInterface {};
@@ -69,6 +76,8 @@ class NpcType : public SharedObject {
 		// We need to keep the order of scripts, so we use a set isntead of an unordered_set
 		std::set<std::string> scripts;
 		std::vector<ShopBlock> shopItemVector;
+		// Built on the first trade, dropped when the shop changes
+		EncodedShop encodedShop;
 
 		NpcsEvent_t eventType = NPCS_EVENT_NONE;
 	};
@@ -85,11 +85,13 @@ uint16_t PlayerAchievement::getPoints() const {
 }
 
 void PlayerAchievement::addPoints(uint16_t toAddPoints) {
+	m_player.invalidateCyclopediaCache();
 	auto oldPoints = getPoints();
 	m_player.kv()->scoped("achievements")->set("points", oldPoints + toAddPoints);
 }
 
 void PlayerAchievement::removePoints(uint16_t points) {
+	m_player.invalidateCyclopediaCache();
 	auto oldPoints = getPoints();
 	m_player.kv()->scoped("achievements")->set("points", oldPoints - std::min<uint16_t>(oldPoints, points));
 }
@@ -12,45 +12,25 @@
 #include "player_cyclopedia.hpp"
 
 #include "database/databasetasks.hpp"
+#include "game/scheduling/coroutine.hpp"
 #include "creatures/players/player.hpp"
 #include "game/game.hpp"
 #include "kv/kv.hpp"
 
 #include "enums/player_blessings.hpp"
 
-PlayerCyclopedia::PlayerCyclopedia(Player &player) :
-	m_player(player) { }
-
-Summary PlayerCyclopedia::getSummary() {
-	return { getAmount(Summary_t::PREY_CARDS),
-		     getAmount(Summary_t::INSTANT_REWARDS),
-		     getAmount(Summary_t::HIRELINGS) };
-}
-
-void PlayerCyclopedia::loadSummaryData() {
-	DBResult_ptr result = g_database().storeQuery(fmt::format("SELECT COUNT(*) as `count` FROM `player_hirelings` WHERE `player_id` = {}", m_player.getGUID()));
-	auto kvScoped = m_player.kv()->scoped("summary")->scoped(g_game().getSummaryKeyByType(static_cast<uint8_t>(Summary_t::HIRELINGS)));
-	if (result && !kvScoped->get("amount").has_value()) {
-		kvScoped->set("amount", result->getNumber<int16_t>("count"));
-	}
-}
-
-void PlayerCyclopedia::loadDeathHistory(uint16_t page, uint16_t entriesPerPage) {
-	Benchmark bm_check;
-	uint32_t offset = static_cast<uint32_t>(page - 1) * entriesPerPage;
-	auto query = fmt::format("SELECT `time`, `level`, `killed_by`, `mostdamage_by`, (select count(*) FROM `player_deaths` WHERE `player_id` = {}) as `entries` FROM `player_deaths` WHERE `player_id` = {} AND `time` >= UNIX_TIMESTAMP(DATE_SUB(NOW(), INTERVAL 30 DAY)) ORDER BY `time` DESC LIMIT {}, {}", m_player.getGUID(), m_player.getGUID(), offset, entriesPerPage);
-
-	uint32_t playerID = m_player.getID();
-	std::function<void(DBResult_ptr, bool)> callback = [playerID, page, entriesPerPage](const DBResult_ptr &result, bool) {
+namespace {
+	AsyncTask<> loadRecentDeathsAsync(uint32_t playerID, std::string query, uint16_t page, uint16_t entriesPerPage) {
+		const auto result = co_await storeQueryAsync(std::move(query));
 		std::shared_ptr<Player> player = g_game().getPlayerByID(playerID);
 		if (!player) {
-			return;
+			co_return;
 		}
 
 		player->resetAsyncOngoingTask(PlayerAsyncTask_RecentDeaths);
 		if (!result) {
 			player->sendCyclopediaCharacterRecentDeaths(0, 0, {});
-			return;
+			co_return;
 		}
 
 		auto pages = result->getNumber<uint32_t>("entries");
@@ -76,31 +56,19 @@ void PlayerCyclopedia::loadDeathHistory(uint16_t page, uint16_t entriesPerPage)
 			entries.emplace_back(cause, result->getNumber<uint32_t>("time"));
 		} while (result->next());
 		player->sendCyclopediaCharacterRecentDeaths(page, static_cast<uint16_t>(pages), entries);
-	};
-	g_databaseTasks().store(query, callback);
-	m_player.addAsyncOngoingTask(PlayerAsyncTask_RecentDeaths);
-
-	g_logger().debug("Loading death history from the player {} took {} milliseconds.", m_player.getName(), bm_check.duration());
-}
-
-void PlayerCyclopedia::loadRecentKills(uint16_t page, uint16_t entriesPerPage) {
-	Benchmark bm_check;
-
-	const std::string &escapedName = g_database().escapeString(m_player.getName());
-	uint32_t offset = static_cast<uint32_t>(page - 1) * entriesPerPage;
-	auto query = fmt::format("SELECT `d`.`time`, `d`.`killed_by`, `d`.`mostdamage_by`, `d`.`unjustified`, `d`.`mostdamage_unjustified`, `p`.`name`, (select count(*) FROM `player_deaths` WHERE ((`killed_by` = {} AND `is_player` = 1) OR (`mostdamage_by` = {} AND `mostdamage_is_player` = 1))) as `entries` FROM `player_deaths` AS `d` INNER JOIN `players` AS `p` ON `d`.`player_id` = `p`.`id` WHERE ((`d`.`killed_by` = {} AND `d`.`is_player` = 1) OR (`d`.`mostdamage_by` = {} AND `d`.`mostdamage_is_player` = 1)) AND `time` >= UNIX_TIMESTAMP(DATE_SUB(NOW(), INTERVAL 70 DAY)) ORDER BY `time` DESC LIMIT {}, {}", escapedName, escapedName, escapedName, escapedName, offset, entriesPerPage);
+	}
 
-	uint32_t playerID = m_player.getID();
-	std::function<void(DBResult_ptr, bool)> callback = [playerID, page, entriesPerPage](const DBResult_ptr &result, bool) {
+	AsyncTask<> loadRecentKillsAsync(uint32_t playerID, std::string query, uint16_t page, uint16_t entriesPerPage) {
+		const auto result = co_await storeQueryAsync(std::move(query));
 		std::shared_ptr<Player> player = g_game().getPlayerByID(playerID);
 		if (!player) {
-			return;
+			co_return;
 		}
 
 		player->resetAsyncOngoingTask(PlayerAsyncTask_RecentPvPKills);
 		if (!result) {
 			player->sendCyclopediaCharacterRecentPvPKills(0, 0, {});
-			return;
+			co_return;
 		}
 
 		auto pages = result->getNumber<uint32_t>("entries");
@@ -128,8 +96,45 @@ void PlayerCyclopedia::loadRecentKills(uint16_t page, uint16_t entriesPerPage) {
 			entries.emplace_back(fmt::format("Killed {}.", name), result->getNumber<uint32_t>("time"), status);
 		} while (result->next());
 		player->sendCyclopediaCharacterRecentPvPKills(page, static_cast<uint16_t>(pages), entries);
-	};
-	g_databaseTasks().store(query, callback);
+	}
+}
+
+PlayerCyclopedia::PlayerCyclopedia(Player &player) :
+	m_player(player) { }
+
+Summary PlayerCyclopedia::getSummary() {
+	return { getAmount(Summary_t::PREY_CARDS),
+		     getAmount(Summary_t::INSTANT_REWARDS),
+		     getAmount(Summary_t::HIRELINGS) };
+}
+
+void PlayerCyclopedia::loadSummaryData() {
+	DBResult_ptr result = g_database().storeQuery(fmt::format("SELECT COUNT(*) as `count` FROM `player_hirelings` WHERE `player_id` = {}", m_player.getGUID()));
+	auto kvScoped = m_player.kv()->scoped("summary")->scoped(g_game().getSummaryKeyByType(static_cast<uint8_t>(Summary_t::HIRELINGS)));
+	if (result && !kvScoped->get("amount").has_value()) {
+		kvScoped->set("amount", result->getNumber<int16_t>("count"));
+	}
+}
+
+void PlayerCyclopedia::loadDeathHistory(uint16_t page, uint16_t entriesPerPage) {
+	Benchmark bm_check;
+	uint32_t offset = static_cast<uint32_t>(page - 1) * entriesPerPage;
+	auto query = fmt::format("SELECT `time`, `level`, `killed_by`, `mostdamage_by`, (select count(*) FROM `player_deaths` WHERE `player_id` = {}) as `entries` FROM `player_deaths` WHERE `player_id` = {} AND `time` >= UNIX_TIMESTAMP(DATE_SUB(NOW(), INTERVAL 30 DAY)) ORDER BY `time` DESC LIMIT {}, {}", m_player.getGUID(), m_player.getGUID(), offset, entriesPerPage);
+
+	loadRecentDeathsAsync(m_player.getID(), std::move(query), page, entriesPerPage).detach();
+	m_player.addAsyncOngoingTask(PlayerAsyncTask_RecentDeaths);
+
+	g_logger().debug("Loading death history from the player {} took {} milliseconds.", m_player.getName(), bm_check.duration());
+}
+
+void PlayerCyclopedia::loadRecentKills(uint16_t page, uint16_t entriesPerPage) {
+	Benchmark bm_check;
+
+	const std::string &escapedName = g_database().escapeString(m_player.getName());
+	uint32_t offset = static_cast<uint32_t>(page - 1) * entriesPerPage;
+	auto query = fmt::format("SELECT `d`.`time`, `d`.`killed_by`, `d`.`mostdamage_by`, `d`.`unjustified`, `d`.`mostdamage_unjustified`, `p`.`name`, (select count(*) FROM `player_deaths` WHERE ((`killed_by` = {} AND `is_player` = 1) OR (`mostdamage_by` = {} AND `mostdamage_is_player` = 1))) as `entries` FROM `player_deaths` AS `d` INNER JOIN `players` AS `p` ON `d`.`player_id` = `p`.`id` WHERE ((`d`.`killed_by` = {} AND `d`.`is_player` = 1) OR (`d`.`mostdamage_by` = {} AND `d`.`mostdamage_is_player` = 1)) AND `time` >= UNIX_TIMESTAMP(DATE_SUB(NOW(), INTERVAL 70 DAY)) ORDER BY `time` DESC LIMIT {}, {}", escapedName, escapedName, escapedName, escapedName, offset, entriesPerPage);
+
+	loadRecentKillsAsync(m_player.getID(), std::move(query), page, entriesPerPage).detach();
 	m_player.addAsyncOngoingTask(PlayerAsyncTask_RecentPvPKills);
 
 	g_logger().debug("Loading recent kills from the player {} took {} milliseconds.", m_player.getName(), bm_check.duration());
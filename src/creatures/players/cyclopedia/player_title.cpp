@@ -15,6 +15,19 @@
 #include "game/game.hpp"
 #include "kv/kv.hpp"
 
+namespace {
+	// The leader of a highscore changes rarely, while every login checks all the highscore titles
+	constexpr int64_t HIGHSCORE_LEADER_CACHE_TIME = 60 * 1000;
+
+	struct HighscoreLeader {
+		uint32_t guid = 0;
+		int64_t expiresAt = 0;
+	};
+
+	std::mutex highscoreLeadersMutex;
+	phmap::flat_hash_map<uint8_t, HighscoreLeader> highscoreLeaders;
+}
+
 PlayerTitle::PlayerTitle(Player &player) :
 	m_player(player) { }
 
@@ -98,7 +111,7 @@ std::string PlayerTitle::getCurrentTitleName() {
 		return "";
 	}
 
-	auto title = g_game().getTitleById(currentTitle);
+	const auto &title = g_game().getTitleById(currentTitle);
 	if (title.m_id == 0) {
 		return "";
 	}
@@ -201,6 +214,14 @@ bool PlayerTitle::checkLevel(uint32_t amount) {
 }
 
 bool PlayerTitle::checkHighscore(uint8_t skill) {
+	const auto now = OTSYS_TIME();
+	{
+		std::scoped_lock lock(highscoreLeadersMutex);
+		if (const auto it = highscoreLeaders.find(skill); it != highscoreLeaders.end() && it->second.expiresAt > now) {
+			return it->second.guid == m_player.getGUID();
+		}
+	}
+
 	Database &db = Database::getInstance();
 	std::string query;
 	std::string fieldCheck = "id";
@@ -229,11 +250,15 @@ bool PlayerTitle::checkHighscore(uint8_t skill) {
 	}
 
 	DBResult_ptr result = db.storeQuery(query);
+	const auto resultValue = result ? result->getNumber<uint32_t>(fieldCheck) : 0;
+	{
+		std::scoped_lock lock(highscoreLeadersMutex);
+		highscoreLeaders[skill] = { resultValue, now + HIGHSCORE_LEADER_CACHE_TIME };
+	}
 	if (!result) {
 		return false;
 	}
 
-	auto resultValue = result->getNumber<uint32_t>(fieldCheck);
 	g_logger().debug("top id: {}, player id: {}", resultValue, m_player.getGUID());
 
 	return resultValue == m_player.getGUID();
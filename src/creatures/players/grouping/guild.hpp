@@ -49,7 +49,7 @@ public:
 	const std::string &getName() const {
 		return name;
 	}
-	std::list<std::shared_ptr<Player>> getMembersOnline() const {
+	const std::list<std::shared_ptr<Player>> &getMembersOnline() const {
 		return membersOnline;
 	}
 	uint32_t getMemberCountOnline() const {
@@ -13,6 +13,7 @@
 
 #include "creatures/players/grouping/party.hpp"
 #include "game/game.hpp"
+#include "game/scheduling/dispatcher.hpp"
 #include "lua/creature/events.hpp"
 #include "lua/callbacks/event_callback.hpp"
 #include "lua/callbacks/events_callbacks.hpp"
@@ -128,6 +129,7 @@ bool Party::leaveParty(std::shared_ptr<Player> player) {
 	if (it != memberList.end()) {
 		memberList.erase(it);
 	}
+	invalidateHazardSystemPoints();
 
 	player->setParty(nullptr);
 	player->sendClosePrivate(CHANNEL_PARTY);
@@ -245,6 +247,7 @@ bool Party::joinParty(const std::shared_ptr<Player> &player) {
 	player->sendPlayerPartyIcons(leader);
 
 	memberList.push_back(player);
+	invalidateHazardSystemPoints();
 
 	g_game().updatePlayerHelpers(player);
 
@@ -356,6 +359,8 @@ bool Party::isPlayerInvited(const std::shared_ptr<Player> &player) const {
 }
 
 void Party::updateAllPartyIcons() {
+	// Every pair of members reads the status of both, they are computed once for the whole refresh
+	invalidateSharedExperienceStatus();
 	auto leader = getLeader();
 	if (!leader) {
 		return;
@@ -392,6 +397,34 @@ void Party::broadcastPartyMessage(MessageClasses msgClass, const std::string &ms
 }
 
 void Party::updateSharedExperience() {
+	invalidateSharedExperienceStatus();
+	if (!sharedExpActive) {
+		return;
+	}
+
+	if (!g_configManager().getBoolean(COALESCE_PLAYER_STATS, __FUNCTION__)) {
+		refreshSharedExperience();
+		return;
+	}
+
+	// Every step of a member asks for it, the party is checked once after the task
+	if (sharedExpUpdatePending) {
+		return;
+	}
+
+	sharedExpUpdatePending = true;
+	g_dispatcher().addEvent(
+		[weak = std::weak_ptr<Party>(getParty())] {
+			if (const auto party = weak.lock()) {
+				party->sharedExpUpdatePending = false;
+				party->refreshSharedExperience();
+			}
+		},
+		__FUNCTION__
+	);
+}
+
+void Party::refreshSharedExperience() {
 	if (sharedExpActive) {
 		bool result = getSharedExperienceStatus() == SHAREDEXP_OK;
 		if (result != sharedExpEnabled) {
@@ -401,6 +434,25 @@ void Party::updateSharedExperience() {
 	}
 }
 
+uint16_t Party::getLowestHazardSystemPoints() {
+	if (!cachedHazardSystemPoints) {
+		const auto &leader = getLeader();
+		uint16_t points = leader ? leader->getHazardSystemPoints() : 0;
+		for (const auto &member : memberList) {
+			if (member) {
+				points = std::min(points, member->getHazardSystemPoints());
+			}
+		}
+		cachedHazardSystemPoints = points;
+	}
+	return *cachedHazardSystemPoints;
+}
+
+void Party::invalidateSharedExperienceStatus() {
+	sharedExpStatusCache.clear();
+	cachedMinLevel.reset();
+}
+
 const char* Party::getSharedExpReturnMessage(SharedExpStatus_t value) {
 	switch (value) {
 		case SHAREDEXP_OK:
@@ -475,7 +527,32 @@ SharedExpStatus_t Party::getMemberSharedExperienceStatus(std::shared_ptr<Player>
 		return SHAREDEXP_EMPTYPARTY;
 	}
 
-	uint32_t minLevel = getMinLevel();
+	// Only the serial tasks share the cache, the members can't move under them
+	if (g_dispatcher().context().isAsync()) {
+		return computeMemberSharedExperienceStatus(player, getMinLevel());
+	}
+
+	const auto cycle = g_dispatcher().getDispatcherCycle();
+	if (sharedExpStatusCycle != cycle) {
+		sharedExpStatusCycle = cycle;
+		invalidateSharedExperienceStatus();
+	}
+
+	if (const auto it = sharedExpStatusCache.find(player->getID()); it != sharedExpStatusCache.end()) {
+		return it->second;
+	}
+
+	if (!cachedMinLevel) {
+		cachedMinLevel = getMinLevel();
+	}
+	const auto status = computeMemberSharedExperienceStatus(player, *cachedMinLevel);
+	sharedExpStatusCache.emplace(player->getID(), status);
+	return status;
+}
+
+SharedExpStatus_t Party::computeMemberSharedExperienceStatus(const std::shared_ptr<Player> &player, uint32_t minLevel) {
+	auto leader = getLeader();
+
 	if (player->getLevel() < minLevel) {
 		return SHAREDEXP_LEVELDIFFTOOLARGE;
 	}
@@ -643,6 +720,8 @@ void Party::updatePlayerStatus(std::shared_ptr<Player> player, const Position &o
 		return;
 	}
 
+	invalidateSharedExperienceStatus();
+
 	int32_t maxDistance = g_configManager().getNumber(PARTY_LIST_MAX_DISTANCE, __FUNCTION__);
 	if (maxDistance != 0) {
 		for (const auto &member : getMembers()) {
@@ -666,6 +745,64 @@ void Party::updatePlayerStatus(std::shared_ptr<Player> player, const Position &o
 }
 
 void Party::updatePlayerHealth(std::shared_ptr<Player> player, std::shared_ptr<Creature> target, uint8_t healthPercent) {
+	if (!g_configManager().getBoolean(COALESCE_PLAYER_STATS, __FUNCTION__)) {
+		sendPlayerHealth(player, target, healthPercent);
+		return;
+	}
+
+	// Only the last percent of the task is sent, a burst of hits costs one packet per member
+	pendingHealth[target->getID()] = { player, target, healthPercent };
+	scheduleStatusUpdate();
+}
+
+void Party::updatePlayerMana(std::shared_ptr<Player> player, uint8_t manaPercent) {
+	if (!g_configManager().getBoolean(COALESCE_PLAYER_STATS, __FUNCTION__)) {
+		sendPlayerMana(player, manaPercent);
+		return;
+	}
+
+	pendingMana[player->getID()] = { player, manaPercent };
+	scheduleStatusUpdate();
+}
+
+void Party::scheduleStatusUpdate() {
+	if (statusUpdatePending) {
+		return;
+	}
+
+	statusUpdatePending = true;
+	g_dispatcher().addEvent(
+		[weak = std::weak_ptr<Party>(getParty())] {
+			const auto party = weak.lock();
+			if (!party) {
+				return;
+			}
+
+			party->statusUpdatePending = false;
+			const auto health = std::move(party->pendingHealth);
+			const auto mana = std::move(party->pendingMana);
+			party->pendingHealth.clear();
+			party->pendingMana.clear();
+			for (const auto &[id, pending] : health) {
+				const auto player = pending.player.lock();
+				const auto target = pending.target.lock();
+				// A member that left the party in the meantime no longer shows in its list
+				if (player && target && player->getParty() == party) {
+					party->sendPlayerHealth(player, target, pending.healthPercent);
+				}
+			}
+			for (const auto &[id, pending] : mana) {
+				const auto player = pending.player.lock();
+				if (player && player->getParty() == party) {
+					party->sendPlayerMana(player, pending.manaPercent);
+				}
+			}
+		},
+		__FUNCTION__
+	);
+}
+
+void Party::sendPlayerHealth(const std::shared_ptr<Player> &player, const std::shared_ptr<Creature> &target, uint8_t healthPercent) {
 	auto leader = getLeader();
 	if (!leader) {
 		return;
@@ -687,7 +824,7 @@ void Party::updatePlayerHealth(std::shared_ptr<Player> player, std::shared_ptr<C
 	}
 }
 
-void Party::updatePlayerMana(std::shared_ptr<Player> player, uint8_t manaPercent) {
+void Party::sendPlayerMana(const std::shared_ptr<Player> &player, uint8_t manaPercent) {
 	auto leader = getLeader();
 	if (!leader) {
 		return;
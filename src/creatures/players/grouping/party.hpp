@@ -85,6 +85,14 @@ public:
 	SharedExpStatus_t getMemberSharedExperienceStatus(std::shared_ptr<Player> player);
 	void updateSharedExperience();
 
+	/**
+	 * @brief Lowest hazard points of the leader and the members, the ones the party hunts with.
+	 */
+	uint16_t getLowestHazardSystemPoints();
+	void invalidateHazardSystemPoints() {
+		cachedHazardSystemPoints.reset();
+	}
+
 	void updatePlayerTicks(std::shared_ptr<Player> player, uint32_t points);
 	void clearPlayerPoints(std::shared_ptr<Player> player);
 
@@ -128,12 +136,29 @@ public:
 private:
 	const char* getSharedExpReturnMessage(SharedExpStatus_t value);
 	bool isPlayerActive(std::shared_ptr<Player> player);
+	SharedExpStatus_t computeMemberSharedExperienceStatus(const std::shared_ptr<Player> &player, uint32_t minLevel);
 	SharedExpStatus_t getSharedExperienceStatus();
 	uint32_t getHighestLevel();
 	uint32_t getLowestLevel();
 	uint32_t getMinLevel();
 	uint32_t getMaxLevel();
 	float shareRangeMultiplier() const;
+	void invalidateSharedExperienceStatus();
+	void refreshSharedExperience();
+	void scheduleStatusUpdate();
+	void sendPlayerHealth(const std::shared_ptr<Player> &player, const std::shared_ptr<Creature> &target, uint8_t healthPercent);
+	void sendPlayerMana(const std::shared_ptr<Player> &player, uint8_t manaPercent);
+
+	struct PendingHealth {
+		std::weak_ptr<Player> player;
+		std::weak_ptr<Creature> target;
+		uint8_t healthPercent;
+	};
+
+	struct PendingMana {
+		std::weak_ptr<Player> player;
+		uint8_t manaPercent;
+	};
 
 	std::map<uint32_t, int64_t> ticksMap;
 
@@ -144,4 +169,17 @@ private:
 
 	bool sharedExpActive = false;
 	bool sharedExpEnabled = false;
+
+	// Health and mana changed by the current task, sent to the members once by a queued event (by creature id)
+	phmap::flat_hash_map<uint32_t, PendingHealth> pendingHealth;
+	phmap::flat_hash_map<uint32_t, PendingMana> pendingMana;
+	bool statusUpdatePending = false;
+	bool sharedExpUpdatePending = false;
+
+	// Shared experience status of the members for the current task, dropped when a member moves, levels or joins
+	phmap::flat_hash_map<uint32_t, SharedExpStatus_t> sharedExpStatusCache;
+	std::optional<uint32_t> cachedMinLevel;
+	uint64_t sharedExpStatusCycle = std::numeric_limits<uint64_t>::max();
+	// Dropped when a member joins, leaves or has its hazard points changed
+	std::optional<uint16_t> cachedHazardSystemPoints;
 };
@@ -10,6 +10,7 @@
 #include "pch.hpp"
 
 #include "creatures/players/management/ban.hpp"
+#include "config/configmanager.hpp"
 #include "database/database.hpp"
 #include "database/databasetasks.hpp"
 #include "utils/tools.hpp"
@@ -47,6 +48,30 @@ bool Ban::acceptConnection(uint32_t clientIP) {
 	return true;
 }
 
+bool Ban::acceptLogin(uint32_t clientIP) {
+	const auto maxAttempts = g_configManager().getNumber(MAX_LOGIN_ATTEMPTS_PER_MINUTE, __FUNCTION__);
+	if (maxAttempts <= 0) {
+		return true;
+	}
+
+	constexpr uint64_t window = 60 * 1000;
+	std::scoped_lock<std::recursive_mutex> lockClass(lock);
+
+	const uint64_t currentTime = OTSYS_TIME();
+	// Reconnect storms come from many addresses, the finished windows are dropped once there are enough of them
+	if (loginWindows.size() >= 4096) {
+		phmap::erase_if(loginWindows, [currentTime](const auto &entry) {
+			return currentTime - entry.second.start >= window;
+		});
+	}
+
+	auto &loginWindow = loginWindows[clientIP];
+	if (currentTime - loginWindow.start >= window) {
+		loginWindow = { currentTime, 0 };
+	}
+	return ++loginWindow.count <= static_cast<uint32_t>(maxAttempts);
+}
+
 bool IOBan::isAccountBanned(uint32_t accountId, BanInfo &banInfo) {
 	Database &db = Database::getInstance();
 
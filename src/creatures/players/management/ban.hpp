@@ -29,9 +29,17 @@ using IpConnectMap = std::map<uint32_t, ConnectBlock>;
 class Ban {
 public:
 	bool acceptConnection(uint32_t clientIP);
+	// Counts a login of the ip against maxLoginAttemptsPerMinute, from any thread
+	bool acceptLogin(uint32_t clientIP);
 
 private:
+	struct LoginWindow {
+		uint64_t start = 0;
+		uint32_t count = 0;
+	};
+
 	IpConnectMap ipConnectMap;
+	phmap::flat_hash_map<uint32_t, LoginWindow> loginWindows;
 	std::recursive_mutex lock;
 };
 
@@ -0,0 +1,111 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "creatures/players/offline_player.hpp"
+
+#include "account/account.hpp"
+#include "config/configmanager.hpp"
+#include "enums/account_errors.hpp"
+#include "io/functions/iologindata_save_player.hpp"
+#include "utils/tools.hpp"
+
+namespace {
+	constexpr std::string_view OFFLINE_PLAYER_QUERY = "SELECT `p`.`id`, `p`.`name`, `p`.`account_id`, `p`.`balance`, `p`.`lastlogin`, `a`.`lastday` FROM `players` AS `p` INNER JOIN `accounts` AS `a` ON `a`.`id` = `p`.`account_id`";
+}
+
+std::optional<OfflinePlayer> OfflinePlayer::load(uint32_t guid) {
+	if (guid == 0) {
+		return std::nullopt;
+	}
+	static const std::string query = fmt::format("{} WHERE `p`.`id` = ?", OFFLINE_PLAYER_QUERY);
+	return fromResult(Database::getInstance().storeStatement(query, { guid }));
+}
+
+std::optional<OfflinePlayer> OfflinePlayer::loadByName(const std::string &name) {
+	if (name.empty()) {
+		return std::nullopt;
+	}
+	static const std::string query = fmt::format("{} WHERE `p`.`name` = ?", OFFLINE_PLAYER_QUERY);
+	return fromResult(Database::getInstance().storeStatement(query, { name }));
+}
+
+phmap::flat_hash_map<uint32_t, OfflinePlayer> OfflinePlayer::loadAll(const std::vector<uint32_t> &guids) {
+	phmap::flat_hash_map<uint32_t, OfflinePlayer> players;
+	if (guids.empty()) {
+		return players;
+	}
+
+	players.reserve(guids.size());
+	auto result = Database::getInstance().storeQuery(fmt::format("{} WHERE `p`.`id` IN ({})", OFFLINE_PLAYER_QUERY, fmt::join(guids, ",")));
+	if (result) {
+		do {
+			auto player = fromRow(result);
+			players.emplace(player.guid, std::move(player));
+		} while (result->next());
+	}
+	return players;
+}
+
+std::optional<OfflinePlayer> OfflinePlayer::fromResult(const DBResult_ptr &result) {
+	if (!result) {
+		return std::nullopt;
+	}
+	return fromRow(result);
+}
+
+OfflinePlayer OfflinePlayer::fromRow(const DBResult_ptr &result) {
+	OfflinePlayer player;
+	player.guid = result->getNumber<uint32_t>("id");
+	player.name = result->getString("name");
+	player.accountId = result->getNumber<uint32_t>("account_id");
+	player.bankBalance = result->getNumber<uint64_t>("balance");
+	player.lastLoginSaved = result->getNumber<time_t>("lastlogin");
+	player.premiumLastDay = result->getNumber<time_t>("lastday");
+	return player;
+}
+
+std::shared_ptr<Account> OfflinePlayer::getAccount() {
+	if (!accountLoaded) {
+		accountLoaded = true;
+		auto loaded = std::make_shared<Account>(accountId);
+		if (AccountErrors_t::Ok == enumFromValue<AccountErrors_t>(loaded->load())) {
+			account = std::move(loaded);
+		}
+	}
+	return account;
+}
+
+bool OfflinePlayer::isVip() const {
+	// The remaining premium days of an account are counted from its last day
+	return g_configManager().getBoolean(VIP_SYSTEM_ENABLED, __FUNCTION__) && premiumLastDay > getTimeNow();
+}
+
+void OfflinePlayer::increaseBankBalance(uint64_t amount) {
+	IOLoginData::increaseBankBalance(guid, amount);
+	bankBalance += amount;
+}
+
+bool OfflinePlayer::decreaseBankBalance(uint64_t amount) {
+	if (bankBalance < amount) {
+		return false;
+	}
+
+	// The balance read on load is checked again by the update itself
+	if (!Database::getInstance().executeStatement("UPDATE `players` SET `balance` = `balance` - ? WHERE `id` = ? AND `balance` >= ?", { amount, guid, amount })) {
+		return false;
+	}
+	bankBalance -= amount;
+	return true;
+}
+
+bool OfflinePlayer::appendInboxItems(const std::vector<std::shared_ptr<Item>> &items) const {
+	return IOLoginDataSave::appendInboxItems(guid, items);
+}
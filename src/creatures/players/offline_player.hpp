@@ -0,0 +1,82 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "database/database.hpp"
+
+class Account;
+class Item;
+
+/**
+ * Character that is not online, read and changed with narrow queries
+ * instead of loading a Player.
+ *
+ * Loading it reads a few columns of its players and accounts rows, the
+ * account itself is only loaded on first use. Changes are written to the database right away and
+ * only touch what they change, so nothing is left to save and the rows that
+ * weren't loaded are never rewritten. Must not be used for a player that is
+ * online, the server owns its rows until it logs out.
+ */
+class OfflinePlayer {
+public:
+	static std::optional<OfflinePlayer> load(uint32_t guid);
+	static std::optional<OfflinePlayer> loadByName(const std::string &name);
+	/**
+	 * @brief Loads the players of the guids that exist with one query, by guid.
+	 */
+	static phmap::flat_hash_map<uint32_t, OfflinePlayer> loadAll(const std::vector<uint32_t> &guids);
+
+	uint32_t getGUID() const {
+		return guid;
+	}
+	const std::string &getName() const {
+		return name;
+	}
+	uint32_t getAccountId() const {
+		return accountId;
+	}
+	uint64_t getBankBalance() const {
+		return bankBalance;
+	}
+	time_t getLastLoginSaved() const {
+		return lastLoginSaved;
+	}
+
+	/**
+	 * @brief Loads the account on the first call, nullptr when it can't be loaded.
+	 */
+	std::shared_ptr<Account> getAccount();
+	bool isVip() const;
+
+	void increaseBankBalance(uint64_t amount);
+	/**
+	 * @brief Takes the amount from the bank balance, only when the balance covers it.
+	 */
+	bool decreaseBankBalance(uint64_t amount);
+	/**
+	 * @brief Stores the items in the inbox, after the ones already there.
+	 */
+	bool appendInboxItems(const std::vector<std::shared_ptr<Item>> &items) const;
+
+private:
+	OfflinePlayer() = default;
+
+	static std::optional<OfflinePlayer> fromResult(const DBResult_ptr &result);
+	static OfflinePlayer fromRow(const DBResult_ptr &result);
+
+	uint32_t guid = 0;
+	std::string name;
+	uint32_t accountId = 0;
+	uint64_t bankBalance = 0;
+	time_t lastLoginSaved = 0;
+	time_t premiumLastDay = 0;
+	std::shared_ptr<Account> account;
+	bool accountLoaded = false;
+};
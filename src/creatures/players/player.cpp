@@ -21,6 +21,7 @@
 #include "creatures/players/cyclopedia/player_title.hpp"
 #include "creatures/players/storages/storages.hpp"
 #include "game/game.hpp"
+#include "game/highscores/highscores.hpp"
 #include "game/modal_window/modal_window.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/task.hpp"
@@ -32,8 +33,11 @@
 #include "lua/callbacks/events_callbacks.hpp"
 #include "lua/creature/movement.hpp"
 #include "io/iologindata.hpp"
+#include "io/functions/iologindata_load_player.hpp"
+#include "database/databasetasks.hpp"
 #include "items/bed.hpp"
 #include "items/weapons/weapons.hpp"
+#include "items/itempool.hpp"
 #include "core.hpp"
 #include "map/spectators.hpp"
 #include "lib/metrics/metrics.hpp"
@@ -49,7 +53,7 @@ Player::Player(ProtocolGame_ptr p) :
 	Creature(),
 	lastPing(OTSYS_TIME()),
 	lastPong(lastPing),
-	inbox(std::make_shared<Inbox>(ITEM_INBOX)),
+	inbox(makePooledItem<Inbox>("inbox", ITEM_INBOX)),
 	client(std::move(p)) {
 	m_playerVIP = std::make_unique<PlayerVIP>(*this);
 	m_wheelPlayer = std::make_unique<PlayerWheel>(*this);
@@ -99,7 +103,7 @@ bool Player::isPushable() {
 }
 
 std::shared_ptr<Task> Player::createPlayerTask(uint32_t delay, std::function<void(void)> f, std::string context) {
-	return std::make_shared<Task>(std::move(f), std::move(context), delay);
+	return Task::makeShared(std::move(f), std::move(context), delay);
 }
 
 uint32_t Player::playerFirstID = 0x10000000;
@@ -519,6 +523,28 @@ void Player::addMonsterToCyclopediaTrackerList(const std::shared_ptr<MonsterType
 	}
 }
 
+void Player::refreshCyclopediaMonsterTrackerOnKill(const std::shared_ptr<MonsterType> &mtype, bool isBoss) {
+	if (!client || !getCyclopediaMonsterTrackerSet(isBoss).contains(mtype)) {
+		return;
+	}
+
+	auto &pending = isBoss ? m_bosstiaryTrackerRefreshPending : m_bestiaryTrackerRefreshPending;
+	if (pending) {
+		return;
+	}
+
+	pending = true;
+	g_dispatcher().addEvent(
+		[weak = std::weak_ptr<Player>(getPlayer()), isBoss] {
+			if (const auto &player = weak.lock()) {
+				(isBoss ? player->m_bosstiaryTrackerRefreshPending : player->m_bestiaryTrackerRefreshPending) = false;
+				player->refreshCyclopediaMonsterTracker(isBoss);
+			}
+		},
+		"Player::refreshCyclopediaMonsterTrackerOnKill"
+	);
+}
+
 void Player::removeMonsterFromCyclopediaTrackerList(std::shared_ptr<MonsterType> mtype, bool isBoss, bool reloadClient /* = false */) {
 	if (!client) {
 		return;
@@ -558,7 +584,7 @@ void Player::updateInventoryWeight() {
 	}
 }
 
-void Player::updateInventoryImbuement() {
+bool Player::updateInventoryImbuement() {
 	// Get the tile the player is currently on
 	std::shared_ptr<Tile> playerTile = getTile();
 	// Check if the player is in a protection zone
@@ -566,6 +592,8 @@ void Player::updateInventoryImbuement() {
 	// Check if the player is in fight mode
 	bool isInFightMode = hasCondition(CONDITION_INFIGHT);
 	bool nonAggressiveFightOnly = g_configManager().getBoolean(TOGGLE_IMBUEMENT_NON_AGGRESSIVE_FIGHT_ONLY, __FUNCTION__);
+	// Paused imbuements keep the player registered, except in protection zones, which are only left through onChangeZone
+	bool keepTicking = false;
 
 	// Iterate through all items in the player's inventory
 	for (auto [key, item] : getAllSlotItems()) {
@@ -588,6 +616,7 @@ void Player::updateInventoryImbuement() {
 			bool isInBackpack = parent && parent->getContainer();
 			// If the imbuement is aggressive and the player is not in fight mode or is in a protection zone, or the item is in a container, ignore it.
 			if (categoryImbuement && (categoryImbuement->agressive || nonAggressiveFightOnly) && (isInProtectionZone || !isInFightMode || isInBackpack)) {
+				keepTicking = keepTicking || !isInProtectionZone;
 				continue;
 			}
 			// If the item is not in the backpack slot and it's not a agressive imbuement, ignore it.
@@ -613,8 +642,10 @@ void Player::updateInventoryImbuement() {
 				updateImbuementTrackerStats();
 				continue;
 			}
+			keepTicking = true;
 		}
 	}
+	return keepTicking;
 }
 
 phmap::flat_hash_map<uint8_t, std::shared_ptr<Item>> Player::getAllSlotItems() const {
@@ -632,7 +663,7 @@ phmap::flat_hash_map<uint8_t, std::shared_ptr<Item>> Player::getAllSlotItems() c
 }
 
 void Player::setTraining(bool value) {
-	for (const auto &[key, player] : g_game().getPlayers()) {
+	for (const auto &player : PlayerVIP::getOnlineWatchers(getGUID())) {
 		if (!this->isInGhostMode() || player->isAccessPlayer()) {
 			player->vip()->notifyStatusChange(static_self_cast<Player>(), value ? VipStatus_t::Training : VipStatus_t::Online, false);
 		}
@@ -699,6 +730,7 @@ void Player::addSkillAdvance(skills_t skill, uint64_t count) {
 		}
 
 		g_creatureEvents().playerAdvance(static_self_cast<Player>(), skill, (skills[skill].level - 1), skills[skill].level);
+		g_highscores().updatePlayer(static_self_cast<Player>());
 
 		sendUpdateSkills = true;
 		currReqTries = nextReqTries;
@@ -898,15 +930,25 @@ void Player::addStorageValue(const uint32_t key, const int32_t value, const bool
 
 	if (value != -1) {
 		int32_t oldValue = getStorageValue(key);
-		storageMap[key] = value;
+		setStorageRow(key, value);
 
 		if (!isLogin) {
 			auto currentFrameTime = g_dispatcher().getDispatcherCycle();
 			g_events().eventOnStorageUpdate(static_self_cast<Player>(), key, value, oldValue, currentFrameTime);
 			g_callbacks().executeCallback(EventCallback_t::playerOnStorageUpdate, &EventCallback::playerOnStorageUpdate, getPlayer(), key, value, oldValue, currentFrameTime);
 		}
-	} else {
-		storageMap.erase(key);
+	} else if (const auto it = storageMap.find(key); it != storageMap.end()) {
+		const int32_t oldValue = it->second;
+		storageMap.erase(it);
+		dirtyStorageKeys.emplace(key);
+		updateBestiaryProgress(key, oldValue, 0);
+	}
+
+	if (key == STORAGEVALUE_HAZARDCOUNT) {
+		hazardSystemPoints = static_cast<uint16_t>(std::clamp<int32_t>(getStorageValue(key), 0, 0xFFFF));
+		if (m_party) {
+			m_party->invalidateHazardSystemPoints();
+		}
 	}
 }
 
@@ -1210,10 +1252,10 @@ void Player::sendLootStats(std::shared_ptr<Item> item, uint8_t count) {
 	}
 }
 
-bool Player::isNearDepotBox() {
+bool Player::isNearDepotBox(int32_t range /* = 1*/) {
 	const Position &pos = getPosition();
-	for (int32_t cx = -1; cx <= 1; ++cx) {
-		for (int32_t cy = -1; cy <= 1; ++cy) {
+	for (int32_t cx = -range; cx <= range; ++cx) {
+		for (int32_t cy = -range; cy <= range; ++cy) {
 			std::shared_ptr<Tile> posTile = g_game().map.getTile(static_cast<uint16_t>(pos.x + cx), static_cast<uint16_t>(pos.y + cy), pos.z);
 			if (!posTile) {
 				continue;
@@ -1227,7 +1269,23 @@ bool Player::isNearDepotBox() {
 	return false;
 }
 
+void Player::loadDepotItems() const {
+	if (!depotItemsPending) {
+		return;
+	}
+
+	// Cleared first, the loaders reach the depot chests and the inbox through their accessors
+	depotItemsPending = false;
+	const auto self = std::const_pointer_cast<Player>(static_self_cast<Player>());
+	DBResultPrefetch noPrefetch;
+	DBResultPrefetch::Use use(depotPrefetch ? *depotPrefetch : noPrefetch);
+	IOLoginDataLoad::loadPlayerDepotItems(self, nullptr);
+	IOLoginDataLoad::loadPlayerInboxItems(self, nullptr);
+	depotPrefetch.reset();
+}
+
 std::shared_ptr<DepotChest> Player::getDepotChest(uint32_t depotId, bool autoCreate) {
+	loadDepotItems();
 	auto it = depotChests.find(depotId);
 	if (it != depotChests.end()) {
 		return it->second;
@@ -1239,13 +1297,13 @@ std::shared_ptr<DepotChest> Player::getDepotChest(uint32_t depotId, bool autoCre
 
 	std::shared_ptr<DepotChest> depotChest;
 	if (depotId > 0 && depotId < 18) {
-		depotChest = std::make_shared<DepotChest>(ITEM_DEPOT_NULL + depotId);
+		depotChest = makePooledItem<DepotChest>("depot_chest", ITEM_DEPOT_NULL + depotId);
 	} else if (depotId == 18) {
-		depotChest = std::make_shared<DepotChest>(ITEM_DEPOT_XVIII);
+		depotChest = makePooledItem<DepotChest>("depot_chest", ITEM_DEPOT_XVIII);
 	} else if (depotId == 19) {
-		depotChest = std::make_shared<DepotChest>(ITEM_DEPOT_XIX);
+		depotChest = makePooledItem<DepotChest>("depot_chest", ITEM_DEPOT_XIX);
 	} else {
-		depotChest = std::make_shared<DepotChest>(ITEM_DEPOT_XX);
+		depotChest = makePooledItem<DepotChest>("depot_chest", ITEM_DEPOT_XX);
 	}
 
 	depotChests[depotId] = depotChest;
@@ -1253,21 +1311,27 @@ std::shared_ptr<DepotChest> Player::getDepotChest(uint32_t depotId, bool autoCre
 }
 
 std::shared_ptr<DepotLocker> Player::getDepotLocker(uint32_t depotId) {
+	loadDepotItems();
 	auto it = depotLockerMap.find(depotId);
 	if (it != depotLockerMap.end()) {
+		const bool switchedLocker = inbox->getParent() != it->second;
 		inbox->setParent(it->second);
 		for (uint32_t i = g_configManager().getNumber(DEPOT_BOXES, __FUNCTION__); i > 0; i--) {
 			if (std::shared_ptr<DepotChest> depotBox = getDepotChest(i, false)) {
 				depotBox->setParent(it->second->getItemByIndex(0)->getContainer());
 			}
 		}
+		// The inbox and depot boxes are shared by every locker, only the one they pointed to saw their changes
+		if (switchedLocker) {
+			it->second->rebuildHoldingCount();
+		}
 		return it->second;
 	}
 
 	// We need to make room for supply stash on 12+ protocol versions and remove it for 10x.
 	bool createSupplyStash = !client->oldProtocol;
 
-	std::shared_ptr<DepotLocker> depotLocker = std::make_shared<DepotLocker>(ITEM_LOCKER, createSupplyStash ? 4 : 3);
+	std::shared_ptr<DepotLocker> depotLocker = makePooledItem<DepotLocker>("depot_locker", ITEM_LOCKER, createSupplyStash ? 4 : 3);
 	depotLocker->setDepotId(depotId);
 	depotLocker->internalAddThing(Item::CreateItem(ITEM_MARKET));
 	depotLocker->internalAddThing(inbox);
@@ -1290,7 +1354,7 @@ std::shared_ptr<RewardChest> Player::getRewardChest() {
 		return rewardChest;
 	}
 
-	rewardChest = std::make_shared<RewardChest>(ITEM_REWARD_CHEST);
+	rewardChest = makePooledItem<RewardChest>("reward_chest", ITEM_REWARD_CHEST);
 	return rewardChest;
 }
 
@@ -1303,7 +1367,7 @@ std::shared_ptr<Reward> Player::getReward(const uint64_t rewardId, const bool au
 		return nullptr;
 	}
 
-	auto reward = std::make_shared<Reward>();
+	auto reward = makePooledItem<Reward>("reward");
 	reward->setAttribute(ItemAttribute_t::DATE, rewardId);
 	rewardMap[rewardId] = reward;
 	g_game().internalAddItem(getRewardChest(), reward, INDEX_WHEREEVER, FLAG_NOLIMIT);
@@ -1343,10 +1407,68 @@ void Player::sendCancelMessage(ReturnValue message) const {
 }
 
 void Player::sendStats() {
-	if (client) {
+	if (!client) {
+		return;
+	}
+
+	if (!g_configManager().getBoolean(COALESCE_PLAYER_STATS, __FUNCTION__)) {
 		client->sendStats();
 		lastStatsTrainingTime = getOfflineTrainingTime() / 60 / 1000;
+		return;
+	}
+
+	// A combat round changes health, mana and capacity one by one, only the last values are sent
+	if (statsUpdatePending) {
+		return;
 	}
+
+	statsUpdatePending = true;
+	g_dispatcher().addEvent(
+		[weak = std::weak_ptr<Player>(getPlayer())] {
+			const auto player = weak.lock();
+			if (!player || !player->statsUpdatePending) {
+				return;
+			}
+
+			player->statsUpdatePending = false;
+			if (player->client) {
+				player->client->sendStats();
+				player->lastStatsTrainingTime = player->getOfflineTrainingTime() / 60 / 1000;
+			}
+		},
+		__FUNCTION__
+	);
+}
+
+void Player::sendSkills() const {
+	if (!client) {
+		return;
+	}
+
+	if (!g_configManager().getBoolean(COALESCE_PLAYER_STATS, __FUNCTION__)) {
+		client->sendSkills();
+		return;
+	}
+
+	if (skillsUpdatePending) {
+		return;
+	}
+
+	skillsUpdatePending = true;
+	g_dispatcher().addEvent(
+		[weak = std::weak_ptr<const Player>(getPlayer())] {
+			const auto player = weak.lock();
+			if (!player || !player->skillsUpdatePending) {
+				return;
+			}
+
+			player->skillsUpdatePending = false;
+			if (player->client) {
+				player->client->sendSkills();
+			}
+		},
+		__FUNCTION__
+	);
 }
 
 void Player::updateSupplyTracker(std::shared_ptr<Item> item) {
@@ -1593,7 +1715,7 @@ void Player::sendAddContainerItem(std::shared_ptr<Container> container, std::sha
 		return;
 	}
 
-	if (!container) {
+	if (!container || hasPendingContainerUpdate(container)) {
 		return;
 	}
 
@@ -1621,7 +1743,7 @@ void Player::sendAddContainerItem(std::shared_ptr<Container> container, std::sha
 }
 
 void Player::sendUpdateContainerItem(std::shared_ptr<Container> container, uint16_t slot, std::shared_ptr<Item> newItem) {
-	if (!client) {
+	if (!client || hasPendingContainerUpdate(container)) {
 		return;
 	}
 
@@ -1653,6 +1775,7 @@ void Player::sendRemoveContainerItem(std::shared_ptr<Container> container, uint1
 		return;
 	}
 
+	const bool pending = hasPendingContainerUpdate(container);
 	for (auto &it : openContainers) {
 		OpenContainer &openContainer = it.second;
 		if (openContainer.container != container) {
@@ -1662,7 +1785,12 @@ void Player::sendRemoveContainerItem(std::shared_ptr<Container> container, uint1
 		uint16_t &firstIndex = openContainer.index;
 		if (firstIndex > 0 && firstIndex >= container->size() - 1) {
 			firstIndex -= container->capacity();
+			if (pending) {
+				continue;
+			}
 			sendContainer(it.first, container, false, firstIndex);
+		} else if (pending) {
+			continue;
 		}
 
 		client->sendRemoveContainerItem(it.first, std::max<uint16_t>(slot, firstIndex), container->getItemByIndex(container->capacity() + firstIndex));
@@ -1670,8 +1798,6 @@ void Player::sendRemoveContainerItem(std::shared_ptr<Container> container, uint1
 }
 
 void Player::onUpdateTileItem(std::shared_ptr<Tile> updateTile, const Position &pos, std::shared_ptr<Item> oldItem, const ItemType &oldType, std::shared_ptr<Item> newItem, const ItemType &newType) {
-	Creature::onUpdateTileItem(updateTile, pos, oldItem, oldType, newItem, newType);
-
 	if (oldItem != newItem) {
 		onRemoveTileItem(updateTile, pos, oldType, oldItem);
 	}
@@ -1684,8 +1810,6 @@ void Player::onUpdateTileItem(std::shared_ptr<Tile> updateTile, const Position &
 }
 
 void Player::onRemoveTileItem(std::shared_ptr<Tile> fromTile, const Position &pos, const ItemType &iType, std::shared_ptr<Item> item) {
-	Creature::onRemoveTileItem(fromTile, pos, iType, item);
-
 	if (tradeState != TRADE_TRANSFER) {
 		checkTradeState(item);
 
@@ -1793,6 +1917,8 @@ void Player::onChangeZone(ZoneType_t zone) {
 			wasMounted = true;
 		}
 	} else {
+		// The imbuements paused in the protection zone decay again
+		g_game().addImbuedPlayer(getPlayer());
 		int32_t ticks = g_configManager().getNumber(STAIRHOP_DELAY, __FUNCTION__);
 		if (ticks > 0) {
 			if (const auto &condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_PACIFIED, ticks, 0)) {
@@ -1981,6 +2107,16 @@ void Player::onCreatureMove(const std::shared_ptr<Creature> &creature, const std
 		inMarket = false;
 	}
 
+	// Reads the depot rows ahead, so opening the depot only has to build the items
+	if (depotItemsPending && !depotPrefetching && isNearDepotBox(2)) {
+		depotPrefetching = true;
+		g_databaseTasks().prefetch(IOLoginDataLoad::getDepotQueries(getGUID()), [weakPlayer = std::weak_ptr<Player>(getPlayer())](const std::shared_ptr<DBResultPrefetch> &prefetch) {
+			if (const auto &player = weakPlayer.lock(); player && player->depotItemsPending) {
+				player->depotPrefetch = prefetch;
+			}
+		});
+	}
+
 	if (m_party) {
 		m_party->updateSharedExperience();
 		m_party->updatePlayerStatus(getPlayer(), oldPos, newPos);
@@ -2002,6 +2138,9 @@ void Player::onEquipInventory() {
 		if (item) {
 			item->startDecaying();
 			g_moveEvents().onPlayerEquip(getPlayer(), item, static_cast<Slots_t>(slot), false);
+			if (item->hasImbuements()) {
+				g_game().addImbuedPlayer(getPlayer());
+			}
 		}
 	}
 }
@@ -2017,10 +2156,12 @@ void Player::onDeEquipInventory() {
 
 // container
 void Player::onAddContainerItem(std::shared_ptr<Item> item) {
+	invalidateCyclopediaCache();
 	checkTradeState(item);
 }
 
 void Player::onUpdateContainerItem(std::shared_ptr<Container> container, std::shared_ptr<Item> oldItem, std::shared_ptr<Item> newItem) {
+	invalidateCyclopediaCache();
 	if (oldItem != newItem) {
 		onRemoveContainerItem(container, oldItem);
 	}
@@ -2031,6 +2172,7 @@ void Player::onUpdateContainerItem(std::shared_ptr<Container> container, std::sh
 }
 
 void Player::onRemoveContainerItem(std::shared_ptr<Container> container, std::shared_ptr<Item> item) {
+	invalidateCyclopediaCache();
 	if (tradeState != TRADE_TRANSFER) {
 		checkTradeState(item);
 
@@ -2070,8 +2212,39 @@ void Player::onSendContainer(std::shared_ptr<Container> container) {
 	}
 }
 
+void Player::scheduleContainerUpdate(const std::shared_ptr<Container> &container) {
+	if (!client || !container) {
+		return;
+	}
+
+	if (std::ranges::find(pendingContainerUpdates, container) == pendingContainerUpdates.end()) {
+		pendingContainerUpdates.push_back(container);
+	}
+	if (!scheduledContainerUpdate) {
+		scheduledContainerUpdate = true;
+		g_dispatcher().addEvent(
+			[playerId = getID()] {
+				if (const auto &player = g_game().getPlayerByID(playerId)) {
+					player->sendPendingContainers();
+				}
+			},
+			"Player::sendPendingContainers"
+		);
+	}
+}
+
+void Player::sendPendingContainers() {
+	scheduledContainerUpdate = false;
+	const auto containers = std::move(pendingContainerUpdates);
+	pendingContainerUpdates.clear();
+	for (const auto &container : containers) {
+		onSendContainer(container);
+	}
+}
+
 // inventory
 void Player::onUpdateInventoryItem(std::shared_ptr<Item> oldItem, std::shared_ptr<Item> newItem) {
+	invalidateCyclopediaCache();
 	if (oldItem != newItem) {
 		onRemoveInventoryItem(oldItem);
 	}
@@ -2331,6 +2504,7 @@ void Player::addManaSpent(uint64_t amount) {
 		sendTakeScreenshot(SCREENSHOT_TYPE_SKILLUP);
 
 		g_creatureEvents().playerAdvance(static_self_cast<Player>(), SKILL_MAGLEVEL, magLevel - 1, magLevel);
+		g_highscores().updatePlayer(static_self_cast<Player>());
 		sendTakeScreenshot(SCREENSHOT_TYPE_SKILLUP);
 
 		sendUpdateStats = true;
@@ -2465,6 +2639,7 @@ void Player::addExperience(std::shared_ptr<Creature> target, uint64_t exp, bool
 		}
 
 		g_creatureEvents().playerAdvance(static_self_cast<Player>(), SKILL_LEVEL, prevLevel, level);
+		g_highscores().updatePlayer(static_self_cast<Player>());
 
 		std::ostringstream ss;
 		ss << "You advanced from Level " << prevLevel << " to Level " << level << '.';
@@ -3001,9 +3176,10 @@ void Player::despawn() {
 	g_game().removePlayer(static_self_cast<Player>());
 
 	// show player as pending
-	for (const auto &[key, player] : g_game().getPlayers()) {
+	for (const auto &player : PlayerVIP::getOnlineWatchers(getGUID())) {
 		player->vip()->notifyStatusChange(static_self_cast<Player>(), VipStatus_t::Pending, false);
 	}
+	vip()->unsubscribe();
 
 	setDead(true);
 }
@@ -3054,18 +3230,20 @@ void Player::addInFightTicks(bool pzlock /*= false*/) {
 
 void Player::removeList() {
 	g_game().removePlayer(static_self_cast<Player>());
+	vip()->unsubscribe();
 
-	for (const auto &[key, player] : g_game().getPlayers()) {
+	for (const auto &player : PlayerVIP::getOnlineWatchers(getGUID())) {
 		player->vip()->notifyStatusChange(static_self_cast<Player>(), VipStatus_t::Offline);
 	}
 }
 
 void Player::addList() {
-	for (const auto &[key, player] : g_game().getPlayers()) {
+	for (const auto &player : PlayerVIP::getOnlineWatchers(getGUID())) {
 		player->vip()->notifyStatusChange(static_self_cast<Player>(), vip()->getStatus());
 	}
 
 	g_game().addPlayer(static_self_cast<Player>());
+	vip()->subscribe();
 }
 
 void Player::removePlayer(bool displayEffect, bool forced /*= true*/) {
@@ -3701,10 +3879,8 @@ uint32_t Player::getItemTypeCount(uint16_t itemId, int32_t subType /*= -1*/) con
 		}
 
 		if (std::shared_ptr<Container> container = item->getContainer()) {
-			for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
-				if ((*it)->getID() == itemId) {
-					count += Item::countByType(*it, subType);
-				}
+			for (const auto &containerItem : container->getHoldingItemsWithId(itemId)) {
+				count += Item::countByType(containerItem, subType);
 			}
 		}
 	}
@@ -4002,6 +4178,7 @@ ItemsTierCountList Player::getStoreInboxItemsId() const {
 }
 
 ItemsTierCountList Player::getDepotChestItemsId() const {
+	loadDepotItems();
 	ItemsTierCountList itemMap;
 
 	for (const auto &[index, depot] : depotChests) {
@@ -4119,10 +4296,49 @@ std::map<uint32_t, uint32_t> &Player::getAllItemTypeCount(std::map<uint32_t, uin
 }
 
 std::map<uint16_t, uint16_t> &Player::getAllSaleItemIdAndCount(std::map<uint16_t, uint16_t> &countMap) const {
-	for (const auto &item : getAllInventoryItems(false, true)) {
-		countMap[item->getID()] += item->getItemCount();
+	if (!shopOwner) {
+		for (const auto &item : getAllInventoryItems(false, true)) {
+			countMap[item->getID()] += item->getItemCount();
+		}
+		return countMap;
+	}
+
+	// Only the items bought by the shop and its currency are read, through the item ids indexed by the containers
+	phmap::flat_hash_set<uint16_t> itemIds;
+	if (const auto currency = shopOwner->getCurrency(); currency == ITEM_GOLD_COIN) {
+		itemIds.insert({ ITEM_CRYSTAL_COIN, ITEM_PLATINUM_COIN, ITEM_GOLD_COIN });
+	} else {
+		itemIds.emplace(currency);
 	}
+	for (const ShopBlock &shopBlock : shopOwner->getShopItemVector(getGUID())) {
+		if (shopBlock.itemSellPrice > 0) {
+			itemIds.emplace(shopBlock.itemId);
+		}
+	}
+
+	for (const auto itemId : itemIds) {
+		uint32_t count = 0;
+		for (int32_t slot = CONST_SLOT_FIRST; slot <= CONST_SLOT_LAST; ++slot) {
+			const auto &item = inventory[slot];
+			if (!item) {
+				continue;
+			}
 
+			if (item->getID() == itemId) {
+				count += item->getItemCount();
+			}
+			if (const auto &container = item->getContainer()) {
+				for (const auto &containerItem : container->getHoldingItemsWithId(itemId)) {
+					if (containerItem->getTier() == 0) {
+						count += containerItem->getItemCount();
+					}
+				}
+			}
+		}
+		if (count > 0) {
+			countMap[itemId] += static_cast<uint16_t>(count);
+		}
+	}
 	return countMap;
 }
 
@@ -4138,13 +4354,19 @@ void Player::getAllItemTypeCountAndSubtype(std::map<uint32_t, uint32_t> &countMa
 }
 
 std::shared_ptr<Item> Player::getForgeItemFromId(uint16_t itemId, uint8_t tier) {
-	for (auto item : getAllInventoryItems(true)) {
-		if (item->hasImbuements()) {
+	// Same items as getAllInventoryItems(true), walked in place so the search stops at the first match
+	for (int i = CONST_SLOT_FIRST; i <= CONST_SLOT_LAST; ++i) {
+		const auto &inventoryItem = inventory[i];
+		const auto container = inventoryItem ? inventoryItem->getContainer() : nullptr;
+		if (!container) {
 			continue;
 		}
 
-		if (item->getID() == itemId && item->getTier() == tier) {
-			return item;
+		for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
+			const auto item = *it;
+			if (item->getID() == itemId && item->getTier() == tier && !item->hasImbuements()) {
+				return item;
+			}
 		}
 	}
 
@@ -4158,10 +4380,34 @@ std::shared_ptr<Thing> Player::getThing(size_t index) const {
 	return nullptr;
 }
 
+void Player::updateInventoryClient() {
+	if (itemTransfers != 0) {
+		itemTransferChanged = true;
+		return;
+	}
+
+	updateItemsLight();
+	sendInventoryIds();
+	sendStats();
+}
+
+void Player::endItemTransfer() {
+	if (itemTransfers == 0 || --itemTransfers != 0 || !itemTransferChanged) {
+		return;
+	}
+
+	itemTransferChanged = false;
+	updateInventoryClient();
+}
+
 void Player::postAddNotification(std::shared_ptr<Thing> thing, std::shared_ptr<Cylinder> oldParent, int32_t index, CylinderLink_t link /*= LINK_OWNER*/) {
+	invalidateCyclopediaCache();
 	if (link == LINK_OWNER) {
 		// calling movement scripts
 		g_moveEvents().onPlayerEquip(getPlayer(), thing->getItem(), static_cast<Slots_t>(index), false);
+		if (const auto &item = thing->getItem(); item && item->hasImbuements()) {
+			g_game().addImbuedPlayer(getPlayer());
+		}
 	}
 
 	bool requireListUpdate = true;
@@ -4175,14 +4421,12 @@ void Player::postAddNotification(std::shared_ptr<Thing> thing, std::shared_ptr<C
 		}
 
 		updateInventoryWeight();
-		updateItemsLight();
-		sendInventoryIds();
-		sendStats();
+		updateInventoryClient();
 	}
 
 	if (std::shared_ptr<Item> item = thing->getItem()) {
 		if (std::shared_ptr<Container> container = item->getContainer()) {
-			onSendContainer(container);
+			scheduleContainerUpdate(container);
 		}
 
 		if (shopOwner && !scheduledSaleUpdate && requireListUpdate) {
@@ -4212,6 +4456,7 @@ void Player::postAddNotification(std::shared_ptr<Thing> thing, std::shared_ptr<C
 }
 
 void Player::postRemoveNotification(std::shared_ptr<Thing> thing, std::shared_ptr<Cylinder> newParent, int32_t index, CylinderLink_t link /*= LINK_OWNER*/) {
+	invalidateCyclopediaCache();
 	if (link == LINK_OWNER) {
 		// calling movement scripts
 		g_moveEvents().onPlayerDeEquip(getPlayer(), thing->getItem(), static_cast<Slots_t>(index));
@@ -4229,9 +4474,7 @@ void Player::postRemoveNotification(std::shared_ptr<Thing> thing, std::shared_pt
 		}
 
 		updateInventoryWeight();
-		updateItemsLight();
-		sendInventoryIds();
-		sendStats();
+		updateInventoryClient();
 	}
 
 	if (std::shared_ptr<Item> item = thing->getItem()) {
@@ -4241,7 +4484,7 @@ void Player::postRemoveNotification(std::shared_ptr<Thing> thing, std::shared_pt
 			if (container->isRemoved() || !Position::areInRange<1, 1, 0>(getPosition(), container->getPosition())) {
 				autoCloseContainers(container);
 			} else if (container->getTopParent() == getPlayer()) {
-				onSendContainer(container);
+				scheduleContainerUpdate(container);
 			} else if (std::shared_ptr<Container> topContainer = std::dynamic_pointer_cast<Container>(container->getTopParent())) {
 				if (std::shared_ptr<DepotChest> depotChest = std::dynamic_pointer_cast<DepotChest>(topContainer)) {
 					bool isOwner = false;
@@ -4250,7 +4493,7 @@ void Player::postRemoveNotification(std::shared_ptr<Thing> thing, std::shared_pt
 						if (it.second == depotChest) {
 							isOwner = true;
 							it.second->stopDecaying();
-							onSendContainer(container);
+							scheduleContainerUpdate(container);
 						}
 					}
 
@@ -4258,7 +4501,7 @@ void Player::postRemoveNotification(std::shared_ptr<Thing> thing, std::shared_pt
 						autoCloseContainers(container);
 					}
 				} else {
-					onSendContainer(container);
+					scheduleContainerUpdate(container);
 				}
 			} else {
 				autoCloseContainers(container);
@@ -4971,15 +5214,32 @@ void Player::genReservedStorageRange() {
 	// generate outfits range
 	uint32_t outfits_key = PSTRG_OUTFITS_RANGE_START;
 	for (const OutfitEntry &entry : outfits) {
-		storageMap[++outfits_key] = (entry.lookType << 16) | entry.addons;
+		setStorageRow(++outfits_key, (entry.lookType << 16) | entry.addons);
 	}
 	// generate familiars range
 	uint32_t familiar_key = PSTRG_FAMILIARS_RANGE_START;
 	for (const FamiliarEntry &entry : familiars) {
-		storageMap[++familiar_key] = (entry.lookType << 16);
+		setStorageRow(++familiar_key, entry.lookType << 16);
 	}
 }
 
+void Player::setStorageRow(uint32_t key, int32_t value) {
+	const auto [it, inserted] = storageMap.try_emplace(key, value);
+	if (inserted || it->second != value) {
+		const int32_t oldValue = inserted ? 0 : it->second;
+		it->second = value;
+		dirtyStorageKeys.emplace(key);
+		updateBestiaryProgress(key, oldValue, value);
+	}
+}
+
+void Player::updateBestiaryProgress(uint32_t key, int32_t oldValue, int32_t newValue) {
+	if (!bestiaryProgress || key < STORAGEVALUE_BESTIARYKILLCOUNT || key - STORAGEVALUE_BESTIARYKILLCOUNT > std::numeric_limits<uint16_t>::max()) {
+		return;
+	}
+	g_iobestiary().updateBestiaryProgress(*bestiaryProgress, static_cast<uint16_t>(key - STORAGEVALUE_BESTIARYKILLCOUNT), oldValue, newValue);
+}
+
 void Player::addOutfit(uint16_t lookType, uint8_t addons) {
 	for (OutfitEntry &outfitEntry : outfits) {
 		if (outfitEntry.lookType == lookType) {
@@ -6004,6 +6264,7 @@ bool Player::addOfflineTrainingTries(skills_t skill, uint64_t tries) {
 			manaSpent = 0;
 
 			g_creatureEvents().playerAdvance(static_self_cast<Player>(), SKILL_MAGLEVEL, magLevel - 1, magLevel);
+			g_highscores().updatePlayer(static_self_cast<Player>());
 
 			sendUpdate = true;
 			currReqMana = nextReqMana;
@@ -6061,6 +6322,7 @@ bool Player::addOfflineTrainingTries(skills_t skill, uint64_t tries) {
 			skills[skill].percent = 0;
 
 			g_creatureEvents().playerAdvance(static_self_cast<Player>(), skill, (skills[skill].level - 1), skills[skill].level);
+			g_highscores().updatePlayer(static_self_cast<Player>());
 
 			sendUpdate = true;
 			currReqTries = nextReqTries;
@@ -6226,6 +6488,10 @@ void Player::removeBakragoreIcon(const IconBakragore icon) {
 	}
 }
 
+bool Player::sendCachedCyclopediaCharacterInfo(CyclopediaCharacterInfoType_t characterInfoType) {
+	return client && client->sendCachedCyclopediaCharacterInfo(characterInfoType);
+}
+
 void Player::sendCyclopediaCharacterAchievements(uint16_t secretsUnlocked, std::vector<std::pair<Achievement, uint32_t>> achievementsUnlocked) {
 	if (client) {
 		client->sendCyclopediaCharacterAchievements(secretsUnlocked, achievementsUnlocked);
@@ -6878,9 +7144,8 @@ void Player::requestDepotSearchItem(uint16_t itemId, uint8_t tier) {
 			continue;
 		}
 
-		for (ContainerIterator it = c->iterator(); it.hasNext(); it.advance()) {
-			std::shared_ptr<Item> item = *it;
-			if (!item || item->getID() != itemId || item->getTier() != tier) {
+		for (const auto &item : c->getHoldingItemsWithId(itemId)) {
+			if (item->getTier() != tier) {
 				continue;
 			}
 
@@ -6919,13 +7184,8 @@ void Player::retrieveAllItemsFromDepotSearch(uint16_t itemId, uint8_t tier, bool
 			continue;
 		}
 
-		for (ContainerIterator it = c->iterator(); it.hasNext(); it.advance()) {
-			std::shared_ptr<Item> item = *it;
-			if (!item) {
-				continue;
-			}
-
-			if (item->getID() == itemId && item->getTier() == depotSearchOnItem.second) {
+		for (const auto &item : c->getHoldingItemsWithId(itemId)) {
+			if (item->getTier() == depotSearchOnItem.second) {
 				itemsVector.push_back(item);
 			}
 		}
@@ -6985,9 +7245,8 @@ std::shared_ptr<Item> Player::getItemFromDepotSearch(uint16_t itemId, const Posi
 			continue;
 		}
 
-		for (ContainerIterator it = c->iterator(); it.hasNext(); it.advance()) {
-			std::shared_ptr<Item> item = *it;
-			if (!item || item->getID() != itemId || item->getTier() != depotSearchOnItem.second) {
+		for (const auto &item : c->getHoldingItemsWithId(itemId)) {
+			if (item->getTier() != depotSearchOnItem.second) {
 				continue;
 			}
 
@@ -7909,6 +8168,10 @@ void Player::setHazardSystemPoints(int32_t count) {
 	}
 }
 
+uint16_t Player::getPartyHazardSystemPoints() const {
+	return m_party ? m_party->getLowestHazardSystemPoints() : getHazardSystemPoints();
+}
+
 void Player::parseAttackRecvHazardSystem(CombatDamage &damage, std::shared_ptr<Monster> monster) {
 	if (!monster || !monster->getHazard()) {
 		return;
@@ -7922,18 +8185,7 @@ void Player::parseAttackRecvHazardSystem(CombatDamage &damage, std::shared_ptr<M
 		return;
 	}
 
-	auto points = getHazardSystemPoints();
-	if (m_party) {
-		for (const auto &partyMember : m_party->getMembers()) {
-			if (partyMember && partyMember->getHazardSystemPoints() < points) {
-				points = partyMember->getHazardSystemPoints();
-			}
-		}
-
-		if (m_party->getLeader() && m_party->getLeader()->getHazardSystemPoints() < points) {
-			points = m_party->getLeader()->getHazardSystemPoints();
-		}
-	}
+	const auto points = getPartyHazardSystemPoints();
 
 	if (points == 0) {
 		return;
@@ -7981,18 +8233,7 @@ void Player::parseAttackDealtHazardSystem(CombatDamage &damage, std::shared_ptr<
 		return;
 	}
 
-	auto points = getHazardSystemPoints();
-	if (m_party) {
-		for (const auto &partyMember : m_party->getMembers()) {
-			if (partyMember && partyMember->getHazardSystemPoints() < points) {
-				points = partyMember->getHazardSystemPoints();
-			}
-		}
-
-		if (m_party->getLeader() && m_party->getLeader()->getHazardSystemPoints() < points) {
-			points = m_party->getLeader()->getHazardSystemPoints();
-		}
-	}
+	const auto points = getPartyHazardSystemPoints();
 
 	if (points == 0) {
 		return;
@@ -8214,3 +8455,17 @@ uint16_t Player::getPlayerVocationEnum() const {
 
 	return Vocation_t::VOCATION_NONE;
 }
+
+void Player::updatePreyLookup() {
+	preyByRaceId.clear();
+	for (size_t i = 0; i < preys.size(); ++i) {
+		preyByRaceId.try_emplace(preys[i]->selectedRaceId, static_cast<uint8_t>(i));
+	}
+}
+
+void Player::updateTaskHuntingLookup() {
+	taskHuntingByRaceId.clear();
+	for (size_t i = 0; i < taskHunting.size(); ++i) {
+		taskHuntingByRaceId.try_emplace(taskHunting[i]->selectedRaceId, static_cast<uint8_t>(i));
+	}
+}
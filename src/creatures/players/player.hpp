@@ -42,6 +42,7 @@
 #include "creatures/players/vip/player_vip.hpp"
 
 class House;
+class DBResultPrefetch;
 class NetworkMessage;
 class Weapon;
 class ProtocolGame;
@@ -207,7 +208,8 @@ public:
 	void addBestiaryKillCount(uint16_t raceid, uint32_t amount) {
 		uint32_t oldCount = getBestiaryKillCount(raceid);
 		uint32_t key = STORAGEVALUE_BESTIARYKILLCOUNT + raceid;
-		addStorageValue(key, static_cast<int32_t>(oldCount + amount), true);
+		// Outside the reserved range and without storage events, written straight to the row saved with the player
+		setStorageRow(key, static_cast<int32_t>(oldCount + amount));
 	}
 	uint32_t getBestiaryKillCount(uint16_t raceid) const {
 		uint32_t key = STORAGEVALUE_BESTIARYKILLCOUNT + raceid;
@@ -215,6 +217,18 @@ public:
 		return value > 0 ? static_cast<uint32_t>(value) : 0;
 	}
 
+	/**
+	 * The bestiary entries with kills and the finished ones, by race. Built
+	 * by IOBestiary::getBestiaryProgress when the bestiary is first browsed,
+	 * then kept current by every write of a kill count.
+	 */
+	struct BestiaryProgress {
+		uint32_t indexRevision = 0;
+		std::array<uint16_t, BESTY_RACE_LAST + 1> unlocked {};
+		// Race ids, sorted
+		std::vector<uint16_t> finished;
+	};
+
 	void setGUID(uint32_t newGuid) {
 		this->guid = newGuid;
 	}
@@ -311,6 +325,7 @@ public:
 	}
 
 	std::shared_ptr<Inbox> getInbox() const {
+		loadDepotItems();
 		return inbox;
 	}
 
@@ -343,6 +358,11 @@ public:
 			client->refreshCyclopediaMonsterTracker(trackerList, isBoss);
 		}
 	}
+	/**
+	 * @brief Refreshes the tracker after a kill of the monster, only when it is tracked.
+	 * The kills of the same dispatcher cycle share one refresh, sent once they were all counted.
+	 */
+	void refreshCyclopediaMonsterTrackerOnKill(const std::shared_ptr<MonsterType> &mtype, bool isBoss);
 
 	bool isBossOnBosstiaryTracker(const std::shared_ptr<MonsterType> &monsterType) const;
 
@@ -531,6 +551,18 @@ public:
 	}
 
 	void genReservedStorageRange();
+	void setStorageRow(uint32_t key, int32_t value);
+	void updateBestiaryProgress(uint32_t key, int32_t oldValue, int32_t newValue);
+
+	/**
+	 * @brief Forgets which rows are stored, so the next save rewrites them all.
+	 * Used when a save did not reach the database.
+	 */
+	void resetPersistedRows() {
+		storageRowsKnown = false;
+		persistedDepotRows.reset();
+		persistedInboxRows.reset();
+	}
 
 	void setGroup(std::shared_ptr<Group> newGroup) {
 		group = newGroup;
@@ -713,6 +745,7 @@ public:
 	bool removeItemCountById(uint16_t itemId, uint32_t itemAmount, bool removeFromStash = true);
 
 	void addItemOnStash(uint16_t itemId, uint32_t amount) {
+		invalidateCyclopediaCache();
 		auto it = stashItems.find(itemId);
 		if (it != stashItems.end()) {
 			stashItems[itemId] += amount;
@@ -729,6 +762,7 @@ public:
 		return 0;
 	}
 	bool withdrawItem(uint16_t itemId, uint32_t amount) {
+		invalidateCyclopediaCache();
 		auto it = stashItems.find(itemId);
 		if (it != stashItems.end()) {
 			if (it->second > amount) {
@@ -806,7 +840,16 @@ public:
 	std::shared_ptr<DepotChest> getDepotChest(uint32_t depotId, bool autoCreate);
 	std::shared_ptr<DepotLocker> getDepotLocker(uint32_t depotId);
 	void onReceiveMail();
-	bool isNearDepotBox();
+	bool isNearDepotBox(int32_t range = 1);
+
+	/**
+	 * @brief Reads the depot and inbox items a login left in the database, on their first use.
+	 * Every accessor of the depot chests and the inbox goes through it.
+	 */
+	void loadDepotItems() const;
+	bool hasDepotItemsLoaded() const {
+		return !depotItemsPending;
+	}
 
 	std::shared_ptr<Container> refreshManagedContainer(ObjectCategory_t category, std::shared_ptr<Container> container, bool isLootContainer, bool loading = false);
 	std::shared_ptr<Container> getManagedContainer(ObjectCategory_t category, bool isLootContainer) const;
@@ -1094,9 +1137,9 @@ public:
 		}
 	}
 
-	void sendChannelMessage(const std::string &author, const std::string &text, SpeakClasses type, uint16_t channel) {
+	void sendChannelMessage(const std::string &author, const std::string &text, SpeakClasses type, uint16_t channel, BroadcastMessage* broadcast = nullptr) {
 		if (client) {
-			client->sendChannelMessage(author, text, type, channel);
+			client->sendChannelMessage(author, text, type, channel, broadcast);
 		}
 	}
 	void sendChannelEvent(uint16_t channelId, const std::string &playerName, ChannelEvent_t channelEvent) {
@@ -1140,9 +1183,9 @@ public:
 			}
 		}
 	}
-	void sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, const Position* pos = nullptr) {
+	void sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, const Position* pos = nullptr, BroadcastMessage* broadcast = nullptr) {
 		if (client) {
-			client->sendCreatureSay(creature, type, text, pos);
+			client->sendCreatureSay(creature, type, text, pos, broadcast);
 		}
 	}
 	void sendCreatureReload(std::shared_ptr<Creature> creature) {
@@ -1291,6 +1334,34 @@ public:
 		}
 	}
 
+	/**
+	 * @brief Starts a bulk move of items done by the server for the player, such as a reward
+	 * collect or a stow. Until the last transfer ends, the inventory weight is kept current but
+	 * the light and the inventory and stats of the client are only updated once, at the end.
+	 */
+	void beginItemTransfer() {
+		++itemTransfers;
+	}
+	void endItemTransfer();
+
+	// Keeps an item transfer open while it lives
+	class ItemTransfer {
+	public:
+		explicit ItemTransfer(const std::shared_ptr<Player> &player) :
+			player(player) {
+			player->beginItemTransfer();
+		}
+		~ItemTransfer() {
+			player->endItemTransfer();
+		}
+
+		ItemTransfer(const ItemTransfer &) = delete;
+		ItemTransfer &operator=(const ItemTransfer &) = delete;
+
+	private:
+		std::shared_ptr<Player> player;
+	};
+
 	void openPlayerContainers();
 
 	// Quickloot
@@ -1336,6 +1407,13 @@ public:
 
 	void onCloseContainer(std::shared_ptr<Container> container);
 	void onSendContainer(std::shared_ptr<Container> container);
+	// Resends the container once the current dispatcher task ends, the changes of a whole loot or move go out as one window
+	void scheduleContainerUpdate(const std::shared_ptr<Container> &container);
+	void sendPendingContainers();
+	// The item updates of a container waiting for its resend are left out, it carries them
+	bool hasPendingContainerUpdate(const std::shared_ptr<Container> &container) const {
+		return std::ranges::find(pendingContainerUpdates, container) != pendingContainerUpdates.end();
+	}
 	void autoCloseContainers(std::shared_ptr<Container> container);
 
 	// inventory
@@ -1363,9 +1441,9 @@ public:
 			client->sendChangeSpeed(creature, newSpeed);
 		}
 	}
-	void sendCreatureHealth(std::shared_ptr<Creature> creature) const {
+	void sendCreatureHealth(std::shared_ptr<Creature> creature, BroadcastMessage* broadcast = nullptr) const {
 		if (client) {
-			client->sendCreatureHealth(creature);
+			client->sendCreatureHealth(creature, broadcast);
 		}
 	}
 	void sendPartyCreatureUpdate(std::shared_ptr<Creature> creature) const {
@@ -1408,9 +1486,9 @@ public:
 			client->sendPlayerVocation(player);
 		}
 	}
-	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type) const {
+	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type, BroadcastMessage* broadcast = nullptr) const {
 		if (client) {
-			client->sendDistanceShoot(from, to, type);
+			client->sendDistanceShoot(from, to, type, broadcast);
 		}
 	}
 	void sendHouseWindow(std::shared_ptr<House> house, uint32_t listId) const;
@@ -1434,9 +1512,9 @@ public:
 			client->sendGameNews();
 		}
 	}
-	void sendMagicEffect(const Position &pos, uint16_t type) const {
+	void sendMagicEffect(const Position &pos, uint16_t type, BroadcastMessage* broadcast = nullptr) const {
 		if (client) {
-			client->sendMagicEffect(pos, type);
+			client->sendMagicEffect(pos, type, broadcast);
 		}
 	}
 	void removeMagicEffect(const Position &pos, uint16_t type) const {
@@ -1461,11 +1539,7 @@ public:
 			client->sendBlessStatus();
 		}
 	}
-	void sendSkills() const {
-		if (client) {
-			client->sendSkills();
-		}
-	}
+	void sendSkills() const;
 	void sendTextMessage(MessageClasses mclass, const std::string &message) const {
 		if (client) {
 			client->sendTextMessage(TextMessage(mclass, message));
@@ -1486,9 +1560,9 @@ public:
 			client->sendTextWindow(windowTextId, item, maxlen, canWrite);
 		}
 	}
-	void sendToChannel(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, uint16_t channelId) const {
+	void sendToChannel(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, uint16_t channelId, BroadcastMessage* broadcast = nullptr) const {
 		if (client) {
-			client->sendToChannel(creature, type, text, channelId);
+			client->sendToChannel(creature, type, text, channelId, broadcast);
 		}
 	}
 	void sendShop(std::shared_ptr<Npc> npc) const {
@@ -1549,14 +1623,14 @@ public:
 			client->sendCloseTrade();
 		}
 	}
-	void sendWorldLight(LightInfo lightInfo) {
+	void sendWorldLight(LightInfo lightInfo, BroadcastMessage* broadcast = nullptr) {
 		if (client) {
-			client->sendWorldLight(lightInfo);
+			client->sendWorldLight(lightInfo, broadcast);
 		}
 	}
-	void sendTibiaTime(int32_t time) {
+	void sendTibiaTime(int32_t time, BroadcastMessage* broadcast = nullptr) {
 		if (client) {
-			client->sendTibiaTime(time);
+			client->sendTibiaTime(time, broadcast);
 		}
 	}
 	void sendChannelsDialog() {
@@ -1655,6 +1729,18 @@ public:
 		}
 	}
 	void sendCyclopediaCharacterAchievements(uint16_t secretsUnlocked, std::vector<std::pair<Achievement, uint32_t>> achievementsUnlocked);
+	/**
+	 * @brief Resends a cyclopedia section encoded on a previous open, when nothing it shows has changed since.
+	 * @return False when the section has to be built again.
+	 */
+	bool sendCachedCyclopediaCharacterInfo(CyclopediaCharacterInfoType_t characterInfoType);
+	// Bumped by the changes of the items, stash and achievements shown in the cyclopedia
+	uint32_t getCyclopediaRevision() const {
+		return cyclopediaRevision;
+	}
+	void invalidateCyclopediaCache() {
+		++cyclopediaRevision;
+	}
 	void sendCyclopediaCharacterItemSummary(const ItemsTierCountList &inventoryItems, const ItemsTierCountList &storeInboxItems, const StashItemList &supplyStashItems, const ItemsTierCountList &depotBoxItems, const ItemsTierCountList &inboxItems) {
 		if (client) {
 			client->sendCyclopediaCharacterItemSummary(inventoryItems, storeInboxItems, supplyStashItems, depotBoxItems, inboxItems);
@@ -2152,7 +2238,9 @@ public:
 		}
 	}
 
+	// Every change of a selected monster is followed by the reload of its slot, which indexes the slots again
 	void reloadPreySlot(PreySlot_t slotid) {
+		updatePreyLookup();
 		if (g_configManager().getBoolean(PREY_ENABLED, __FUNCTION__) && client) {
 			client->sendPreyData(getPreySlotById(slotid));
 			client->sendResourcesBalance(getMoney(), getBankBalance(), getPreyCards(), getTaskHuntingPoints());
@@ -2176,6 +2264,7 @@ public:
 		}
 
 		preys.emplace_back(std::move(slot));
+		updatePreyLookup();
 		return true;
 	}
 
@@ -2227,11 +2316,8 @@ public:
 			return PreySlotNull;
 		}
 
-		if (auto it = std::find_if(preys.begin(), preys.end(), [raceId](const std::unique_ptr<PreySlot> &it) {
-				return it->selectedRaceId == raceId;
-			});
-		    it != preys.end()) {
-			return *it;
+		if (auto it = preyByRaceId.find(raceId); it != preyByRaceId.end()) {
+			return preys[it->second];
 		}
 
 		return PreySlotNull;
@@ -2247,10 +2333,13 @@ public:
 		}
 
 		taskHunting.emplace_back(std::move(slot));
+		updateTaskHuntingLookup();
 		return true;
 	}
 
+	// Every change of a selected monster is followed by the reload of its slot, which indexes the slots again
 	void reloadTaskSlot(PreySlot_t slotid) {
+		updateTaskHuntingLookup();
 		if (g_configManager().getBoolean(TASK_HUNTING_ENABLED, __FUNCTION__) && client) {
 			client->sendTaskHuntingData(getTaskHuntingSlotById(slotid));
 			client->sendResourcesBalance(getMoney(), getBankBalance(), getPreyCards(), getTaskHuntingPoints());
@@ -2327,11 +2416,8 @@ public:
 			return TaskHuntingSlotNull;
 		}
 
-		if (auto it = std::find_if(taskHunting.begin(), taskHunting.end(), [raceId](const std::unique_ptr<TaskHuntingSlot> &itTask) {
-				return itTask->selectedRaceId == raceId;
-			});
-		    it != taskHunting.end()) {
-			return *it;
+		if (auto it = taskHuntingByRaceId.find(raceId); it != taskHuntingByRaceId.end()) {
+			return taskHunting[it->second];
 		}
 
 		return TaskHuntingSlotNull;
@@ -2540,13 +2626,10 @@ public:
 	void setHazardSystemPoints(int32_t amount);
 	// Points get:
 	uint16_t getHazardSystemPoints() const {
-		int32_t points = 0;
-		points = getStorageValue(STORAGEVALUE_HAZARDCOUNT);
-		if (points <= 0) {
-			return 0;
-		}
-		return static_cast<uint16_t>(std::max<int32_t>(0, std::min<int32_t>(0xFFFF, points)));
+		return hazardSystemPoints;
 	}
+	// Points that apply to the attacks of the player, the lowest of its party
+	uint16_t getPartyHazardSystemPoints() const;
 
 	/*******************************************************************************/
 
@@ -2676,11 +2759,13 @@ private:
 	void removeExperience(uint64_t exp, bool sendText = false);
 
 	void updateInventoryWeight();
+	// The light and the client inventory and stats, deferred while an item transfer is open
+	void updateInventoryClient();
 	/**
-	 * @brief Starts checking the imbuements in the item so that the time decay is performed
-	 * Registers the player in an unordered_map in game.h so that the function can be initialized by the task
+	 * @brief Decays the imbuements of the equipped items, called by Game::checkImbuements for the players registered with Game::addImbuedPlayer
+	 * @return False when no imbuement can decay until the player equips an item or leaves the protection zone, so that the player is unregistered
 	 */
-	void updateInventoryImbuement();
+	bool updateInventoryImbuement();
 
 	void setNextWalkActionTask(std::shared_ptr<Task> task);
 	void setNextWalkTask(std::shared_ptr<Task> task);
@@ -2733,12 +2818,30 @@ private:
 	phmap::flat_hash_set<uint32_t> attackedSet;
 
 	std::map<uint8_t, OpenContainer> openContainers;
+	std::vector<std::shared_ptr<Container>> pendingContainerUpdates;
 	std::map<uint32_t, std::shared_ptr<DepotLocker>> depotLockerMap;
 	std::map<uint32_t, std::shared_ptr<DepotChest>> depotChests;
 	std::map<uint8_t, int64_t> moduleDelayMap;
-	std::map<uint32_t, int32_t> storageMap;
+	phmap::flat_hash_map<uint32_t, int32_t> storageMap;
 	std::map<uint16_t, uint64_t> itemPriceMap;
 
+	// Rows as they are stored in the database (sid -> row hash for items), so a save only writes what changed.
+	// An empty optional means the stored rows are unknown and the next save rewrites the whole table.
+	using PersistedItemRows = phmap::flat_hash_map<int32_t, uint64_t>;
+	// Storage keys set or erased since the last save, which writes only those while the stored rows are known
+	phmap::flat_hash_set<uint32_t> dirtyStorageKeys;
+	bool storageRowsKnown = false;
+	std::optional<PersistedItemRows> persistedDepotRows;
+	std::optional<PersistedItemRows> persistedInboxRows;
+	// Set by a login that left the depot and inbox items unloaded, see loadDepotItems
+	mutable bool depotItemsPending = false;
+	// Depot rows read ahead while the player walks near a depot
+	mutable std::shared_ptr<DBResultPrefetch> depotPrefetch;
+	bool depotPrefetching = false;
+	// Stats and skills changed by the current task, sent once by a queued event, see sendStats
+	mutable bool statsUpdatePending = false;
+	mutable bool skillsUpdatePending = false;
+
 	std::map<uint8_t, uint16_t> maxValuePerSkill = {
 		{ SKILL_LIFE_LEECH_CHANCE, 100 },
 		{ SKILL_MANA_LEECH_CHANCE, 100 },
@@ -2757,6 +2860,12 @@ private:
 
 	std::vector<std::unique_ptr<PreySlot>> preys;
 	std::vector<std::unique_ptr<TaskHuntingSlot>> taskHunting;
+	// Index of the first slot selecting each race id, read on every hit and kill
+	phmap::flat_hash_map<uint16_t, uint8_t> preyByRaceId;
+	phmap::flat_hash_map<uint16_t, uint8_t> taskHuntingByRaceId;
+
+	void updatePreyLookup();
+	void updateTaskHuntingLookup();
 
 	GuildWarVector guildWarVector;
 
@@ -2768,6 +2877,8 @@ private:
 
 	std::unordered_set<std::shared_ptr<MonsterType>> m_bestiaryMonsterTracker;
 	std::unordered_set<std::shared_ptr<MonsterType>> m_bosstiaryMonsterTracker;
+	bool m_bestiaryTrackerRefreshPending = false;
+	bool m_bosstiaryTrackerRefreshPending = false;
 
 	std::string name;
 	std::string guildNick;
@@ -2939,6 +3050,11 @@ private:
 	bool quickLootFallbackToMainContainer = false;
 	bool logged = false;
 	bool scheduledSaleUpdate = false;
+	uint32_t cyclopediaRevision = 0;
+	bool scheduledContainerUpdate = false;
+	mutable std::optional<BestiaryProgress> bestiaryProgress;
+	uint16_t itemTransfers = 0;
+	bool itemTransferChanged = false;
 	bool inEventMovePush = false;
 	bool supplyStash = false; // Menu option 'stow, stow container ...'
 	bool marketMenu = false; // Menu option 'show in market'
@@ -2950,6 +3066,8 @@ private:
 	// Hazard system
 	int64_t lastHazardSystemCriticalHit = 0;
 	bool reloadHazardSystemPointsCounter = true;
+	// Copy of the hazard count storage, read on every attack on a hazard monster
+	uint16_t hazardSystemPoints = 0;
 	// Hazard end
 
 	// Concoctions
@@ -3032,6 +3150,7 @@ private:
 	friend class Map;
 	friend class Actions;
 	friend class IOLoginData;
+	friend class IOBestiary;
 	friend class ProtocolGame;
 	friend class MoveEvent;
 	friend class BedItem;
@@ -19,6 +19,8 @@
 const uint8_t PlayerVIP::firstID = 1;
 const uint8_t PlayerVIP::lastID = 8;
 
+phmap::flat_hash_map<uint32_t, phmap::flat_hash_set<uint32_t>> PlayerVIP::watchers;
+
 PlayerVIP::PlayerVIP(Player &player) :
 	m_player(player) { }
 
@@ -58,12 +60,65 @@ void PlayerVIP::notifyStatusChange(std::shared_ptr<Player> loginPlayer, VipStatu
 	}
 }
 
+void PlayerVIP::subscribe() {
+	if (subscribed) {
+		return;
+	}
+
+	subscribed = true;
+	for (const auto vipGuid : vipGuids) {
+		watchers[vipGuid].insert(m_player.getGUID());
+	}
+}
+
+void PlayerVIP::unsubscribe() {
+	if (!subscribed) {
+		return;
+	}
+
+	subscribed = false;
+	for (const auto vipGuid : vipGuids) {
+		unwatch(vipGuid);
+	}
+}
+
+void PlayerVIP::unwatch(uint32_t vipGuid) const {
+	auto it = watchers.find(vipGuid);
+	if (it == watchers.end()) {
+		return;
+	}
+
+	it->second.erase(m_player.getGUID());
+	if (it->second.empty()) {
+		watchers.erase(it);
+	}
+}
+
+std::vector<std::shared_ptr<Player>> PlayerVIP::getOnlineWatchers(uint32_t guid) {
+	std::vector<std::shared_ptr<Player>> onlineWatchers;
+	auto it = watchers.find(guid);
+	if (it == watchers.end()) {
+		return onlineWatchers;
+	}
+
+	onlineWatchers.reserve(it->second.size());
+	for (const auto watcherGuid : it->second) {
+		if (const auto &watcher = g_game().getPlayerByGUID(watcherGuid)) {
+			onlineWatchers.emplace_back(watcher);
+		}
+	}
+	return onlineWatchers;
+}
+
 bool PlayerVIP::remove(uint32_t vipGuid) {
 	if (!vipGuids.erase(vipGuid)) {
 		return false;
 	}
 
-	vipGuids.erase(vipGuid);
+	if (subscribed) {
+		unwatch(vipGuid);
+	}
+
 	if (m_player.account) {
 		IOLoginData::removeVIPEntry(m_player.account->getID(), vipGuid);
 	}
@@ -82,6 +137,10 @@ bool PlayerVIP::add(uint32_t vipGuid, const std::string &vipName, VipStatus_t st
 		return false;
 	}
 
+	if (subscribed) {
+		watchers[vipGuid].insert(m_player.getGUID());
+	}
+
 	if (m_player.account) {
 		IOLoginData::addVIPEntry(m_player.account->getID(), vipGuid, "", 0, false);
 	}
@@ -98,7 +157,14 @@ bool PlayerVIP::addInternal(uint32_t vipGuid) {
 		return false;
 	}
 
-	return vipGuids.insert(vipGuid).second;
+	if (!vipGuids.insert(vipGuid).second) {
+		return false;
+	}
+
+	if (subscribed) {
+		watchers[vipGuid].insert(m_player.getGUID());
+	}
+	return true;
 }
 
 bool PlayerVIP::edit(uint32_t vipGuid, const std::string &description, uint32_t icon, bool notify, std::vector<uint8_t> groupsId) const {
@@ -42,6 +42,16 @@ public:
 	}
 
 	void notifyStatusChange(std::shared_ptr<Player> loginPlayer, VipStatus_t status, bool message = true) const;
+
+	/**
+	 * @brief Lists the player in the watchers of its entries, done on login.
+	 * A login or logout then reaches only the online players that have it in their list.
+	 */
+	void subscribe();
+	void unsubscribe();
+	// Online players that have the guid in their list
+	static std::vector<std::shared_ptr<Player>> getOnlineWatchers(uint32_t guid);
+
 	bool remove(uint32_t vipGuid);
 	bool add(uint32_t vipGuid, const std::string &vipName, VipStatus_t status);
 	bool addInternal(uint32_t vipGuid);
@@ -66,9 +76,15 @@ public:
 	}
 
 private:
+	void unwatch(uint32_t vipGuid) const;
+
 	Player &m_player;
 
+	// Watched guid -> guids of the online players that have it in their list
+	static phmap::flat_hash_map<uint32_t, phmap::flat_hash_set<uint32_t>> watchers;
+
 	VipStatus_t status = VipStatus_t::Online;
+	bool subscribed = false;
 	std::vector<std::shared_ptr<VIPGroup>> vipGroups;
 	phmap::flat_hash_set<uint32_t> vipGuids;
 };
@@ -190,6 +190,8 @@ bool Vocations::loadFromXml() {
 				voc->wheelGems[static_cast<WheelGemQuality_t>(quality)] = name;
 			}
 		}
+
+		voc->buildFormulaTables();
 	}
 	return true;
 }
@@ -226,66 +228,77 @@ uint16_t Vocations::getPromotedVocation(uint16_t vocationId) const {
 uint32_t Vocation::skillBase[SKILL_LAST + 1] = { 50, 50, 50, 50, 30, 100, 20 };
 const uint16_t minSkillLevel = 10;
 
-absl::uint128 Vocation::getTotalSkillTries(uint8_t skill, uint16_t level) {
+uint64_t Vocation::computeReqSkillTries(uint8_t skill, uint16_t level) const {
+	return static_cast<uint64_t>(skillBase[skill] * std::pow(static_cast<double>(skillMultipliers[skill]), level - (minSkillLevel + 1)));
+}
+
+uint64_t Vocation::computeReqMana(uint32_t magLevel) const {
+	return std::floor<uint64_t>(1600 * std::pow<double>(manaMultiplier, static_cast<int32_t>(magLevel) - 1));
+}
+
+void Vocation::buildFormulaTables() {
+	for (uint8_t skill = SKILL_FIRST; skill <= SKILL_LAST; ++skill) {
+		auto &table = skillTables[skill];
+		absl::uint128 totalTries = 0;
+		for (uint16_t level = 0; level < FORMULA_TABLE_SIZE; ++level) {
+			const uint64_t tries = level > minSkillLevel ? computeReqSkillTries(skill, level) : 0;
+			totalTries += tries;
+			table[level] = { tries, totalTries };
+		}
+	}
+
+	absl::uint128 totalMana = 0;
+	for (uint32_t magLevel = 0; magLevel < FORMULA_TABLE_SIZE; ++magLevel) {
+		const uint64_t reqMana = magLevel != 0 ? computeReqMana(magLevel) : 0;
+		totalMana += reqMana;
+		manaTable[magLevel] = { reqMana, totalMana };
+	}
+}
+
+absl::uint128 Vocation::getTotalSkillTries(uint8_t skill, uint16_t level) const {
 	if (skill > SKILL_LAST) {
 		return 0;
 	}
 
-	auto it = cacheSkillTotal[skill].find(level);
-	if (it != cacheSkillTotal[skill].end()) {
-		return it->second;
+	if (level < FORMULA_TABLE_SIZE) {
+		return skillTables[skill][level].total;
 	}
 
-	absl::uint128 totalTries = 0;
-	for (uint16_t i = minSkillLevel; i <= level; ++i) {
-		totalTries += getReqSkillTries(skill, i);
+	absl::uint128 totalTries = skillTables[skill][FORMULA_TABLE_SIZE - 1].total;
+	for (uint32_t i = FORMULA_TABLE_SIZE; i <= level; ++i) {
+		totalTries += computeReqSkillTries(skill, static_cast<uint16_t>(i));
 	}
-	cacheSkillTotal[skill][level] = totalTries;
 	return totalTries;
 }
 
-uint64_t Vocation::getReqSkillTries(uint8_t skill, uint16_t level) {
+uint64_t Vocation::getReqSkillTries(uint8_t skill, uint16_t level) const {
 	if (skill > SKILL_LAST || level <= minSkillLevel) {
 		return 0;
 	}
 
-	auto it = cacheSkill[skill].find(level);
-	if (it != cacheSkill[skill].end()) {
-		return it->second;
+	if (level < FORMULA_TABLE_SIZE) {
+		return skillTables[skill][level].required;
 	}
-
-	uint64_t tries = static_cast<uint64_t>(skillBase[skill] * std::pow(static_cast<double>(skillMultipliers[skill]), level - (minSkillLevel + 1)));
-	cacheSkill[skill][level] = tries;
-	return tries;
+	return computeReqSkillTries(skill, level);
 }
 
-absl::uint128 Vocation::getTotalMana(uint32_t magLevel) {
-	if (magLevel == 0) {
-		return 0;
-	}
-	auto it = cacheManaTotal.find(magLevel);
-	if (it != cacheManaTotal.end()) {
-		return it->second;
+absl::uint128 Vocation::getTotalMana(uint32_t magLevel) const {
+	if (magLevel < FORMULA_TABLE_SIZE) {
+		return manaTable[magLevel].total;
 	}
-	absl::uint128 totalMana = 0;
-	for (uint32_t i = 1; i <= magLevel; ++i) {
-		totalMana += getReqMana(i);
+
+	absl::uint128 totalMana = manaTable[FORMULA_TABLE_SIZE - 1].total;
+	for (uint32_t i = FORMULA_TABLE_SIZE; i <= magLevel; ++i) {
+		totalMana += computeReqMana(i);
 	}
 	return totalMana;
 }
 
-uint64_t Vocation::getReqMana(uint32_t magLevel) {
-	if (magLevel == 0) {
-		return 0;
+uint64_t Vocation::getReqMana(uint32_t magLevel) const {
+	if (magLevel < FORMULA_TABLE_SIZE) {
+		return manaTable[magLevel].required;
 	}
-	auto it = cacheMana.find(magLevel);
-	if (it != cacheMana.end()) {
-		return it->second;
-	}
-
-	uint64_t reqMana = std::floor<uint64_t>(1600 * std::pow<double>(manaMultiplier, static_cast<int32_t>(magLevel) - 1));
-	cacheMana[magLevel] = reqMana;
-	return reqMana;
+	return computeReqMana(magLevel);
 }
 
 std::vector<WheelGemSupremeModifier_t> Vocation::getSupremeGemModifiers() {
@@ -25,10 +25,10 @@ public:
 	const std::string &getVocDescription() const {
 		return description;
 	}
-	absl::uint128 getTotalSkillTries(uint8_t skill, uint16_t level);
-	uint64_t getReqSkillTries(uint8_t skill, uint16_t level);
-	absl::uint128 getTotalMana(uint32_t magLevel);
-	uint64_t getReqMana(uint32_t magLevel);
+	absl::uint128 getTotalSkillTries(uint8_t skill, uint16_t level) const;
+	uint64_t getReqSkillTries(uint8_t skill, uint16_t level) const;
+	absl::uint128 getTotalMana(uint32_t magLevel) const;
+	uint64_t getReqMana(uint32_t magLevel) const;
 
 	uint16_t getId() const {
 		return id;
@@ -128,10 +128,22 @@ public:
 private:
 	friend class Vocations;
 
-	std::map<uint32_t, uint64_t> cacheMana;
-	std::map<uint32_t, absl::uint128> cacheManaTotal;
-	std::map<uint32_t, uint32_t> cacheSkill[SKILL_LAST + 1];
-	std::map<uint32_t, absl::uint128> cacheSkillTotal[SKILL_LAST + 1];
+	// Levels past the table are computed on each call, no character gets there
+	static constexpr uint16_t FORMULA_TABLE_SIZE = 256;
+
+	struct FormulaEntry {
+		uint64_t required = 0;
+		// Sum of the required amounts up to this level
+		absl::uint128 total = 0;
+	};
+
+	void buildFormulaTables();
+	uint64_t computeReqSkillTries(uint8_t skill, uint16_t level) const;
+	uint64_t computeReqMana(uint32_t magLevel) const;
+
+	// Built once the vocation is loaded, read-only afterwards
+	std::array<std::array<FormulaEntry, FORMULA_TABLE_SIZE>, SKILL_LAST + 1> skillTables {};
+	std::array<FormulaEntry, FORMULA_TABLE_SIZE> manaTable {};
 	std::map<WheelGemQuality_t, std::string> wheelGems;
 
 	std::string name = "none";
@@ -78,6 +78,34 @@ const static std::vector<WheelGemBasicModifier_t> wheelGemBasicSlot2Allowed = {
 // To avoid conflict in other files that might use a function with the same name
 // Here are built-in helper functions
 namespace {
+	// Perks queried by name, either toggled instants or stages
+	struct NamedPerk {
+		bool isStage = false;
+		uint8_t index = 0;
+	};
+
+	const phmap::flat_hash_map<std::string_view, NamedPerk> perksByName = {
+		{ "Battle Instinct", { false, static_cast<uint8_t>(WheelInstant_t::BATTLE_INSTINCT) } },
+		{ "Battle Healing", { false, static_cast<uint8_t>(WheelInstant_t::BATTLE_HEALING) } },
+		{ "Positional Tatics", { false, static_cast<uint8_t>(WheelInstant_t::POSITIONAL_TATICS) } },
+		{ "Ballistic Mastery", { false, static_cast<uint8_t>(WheelInstant_t::BALLISTIC_MASTERY) } },
+		{ "Healing Link", { false, static_cast<uint8_t>(WheelInstant_t::HEALING_LINK) } },
+		{ "Runic Mastery", { false, static_cast<uint8_t>(WheelInstant_t::RUNIC_MASTERY) } },
+		{ "Focus Mastery", { false, static_cast<uint8_t>(WheelInstant_t::FOCUS_MASTERY) } },
+		{ "Beam Mastery", { true, static_cast<uint8_t>(WheelStage_t::BEAM_MASTERY) } },
+		{ "Combat Mastery", { true, static_cast<uint8_t>(WheelStage_t::COMBAT_MASTERY) } },
+		{ "Gift of Life", { true, static_cast<uint8_t>(WheelStage_t::GIFT_OF_LIFE) } },
+		{ "Blessing of the Grove", { true, static_cast<uint8_t>(WheelStage_t::BLESSING_OF_THE_GROVE) } },
+		{ "Drain Body", { true, static_cast<uint8_t>(WheelStage_t::DRAIN_BODY) } },
+		{ "Divine Empowerment", { true, static_cast<uint8_t>(WheelStage_t::DIVINE_EMPOWERMENT) } },
+		{ "Divine Grenade", { true, static_cast<uint8_t>(WheelStage_t::DIVINE_GRENADE) } },
+		{ "Twin Burst", { true, static_cast<uint8_t>(WheelStage_t::TWIN_BURST) } },
+		{ "Executioner's Throw", { true, static_cast<uint8_t>(WheelStage_t::EXECUTIONERS_THROW) } },
+		{ "Avatar of Light", { true, static_cast<uint8_t>(WheelStage_t::AVATAR_OF_LIGHT) } },
+		{ "Avatar of Nature", { true, static_cast<uint8_t>(WheelStage_t::AVATAR_OF_NATURE) } },
+		{ "Avatar of Steel", { true, static_cast<uint8_t>(WheelStage_t::AVATAR_OF_STEEL) } },
+		{ "Avatar of Storm", { true, static_cast<uint8_t>(WheelStage_t::AVATAR_OF_STORM) } },
+	};
 	template <typename SpellType>
 	bool checkSpellArea(const std::array<SpellType, 5> &spellsTable, const std::string &spellName, uint8_t stage) {
 		for (const auto &spellTable : spellsTable) {
@@ -1397,6 +1425,7 @@ void PlayerWheel::registerPlayerBonusData() {
 	}
 	m_modifierContext->resetStrategies();
 	m_spellsBonuses.clear();
+	m_spellProfiles.clear();
 
 	addStat(WheelStat_t::HEALTH, m_playerBonusData.stats.health);
 	addStat(WheelStat_t::MANA, m_playerBonusData.stats.mana);
@@ -2537,6 +2566,8 @@ void PlayerWheel::resetUpgradedSpells() {
 	}
 	m_creaturesNearby = 0;
 	m_spellsSelected.clear();
+	m_spellProfiles.clear();
+	++m_spellsVersion;
 	m_learnedSpellsSelected.clear();
 	for (int i = 0; i < static_cast<int>(WheelMajor_t::TOTAL_COUNT); i++) {
 		setMajorStat(static_cast<WheelMajor_t>(i), 0);
@@ -2548,6 +2579,8 @@ void PlayerWheel::resetUpgradedSpells() {
 }
 
 void PlayerWheel::upgradeSpell(const std::string &name) {
+	++m_spellsVersion;
+	m_spellProfiles.clear();
 	if (!m_player.hasLearnedInstantSpell(name)) {
 		m_learnedSpellsSelected.emplace_back(name);
 		m_player.learnInstantSpell(name);
@@ -2562,6 +2595,8 @@ void PlayerWheel::upgradeSpell(const std::string &name) {
 }
 
 void PlayerWheel::downgradeSpell(const std::string &name) {
+	++m_spellsVersion;
+	m_spellProfiles.clear();
 	if (m_spellsSelected[name] == WheelSpellGrade_t::NONE || m_spellsSelected[name] == WheelSpellGrade_t::REGULAR) {
 		m_spellsSelected.erase(name);
 	} else if (m_spellsSelected[name] == WheelSpellGrade_t::UPGRADED) {
@@ -2573,38 +2608,67 @@ void PlayerWheel::downgradeSpell(const std::string &name) {
 
 std::shared_ptr<Spell> PlayerWheel::getCombatDataSpell(CombatDamage &damage) {
 	std::shared_ptr<Spell> spell = nullptr;
-	WheelSpellGrade_t spellGrade = WheelSpellGrade_t::NONE;
+	bool isInstant = false;
 	if (!(damage.instantSpellName).empty()) {
-		spellGrade = getSpellUpgrade(damage.instantSpellName);
 		spell = g_spells().getInstantSpellByName(damage.instantSpellName);
+		isInstant = true;
 	} else if (!(damage.runeSpellName).empty()) {
 		spell = g_spells().getRuneSpellByName(damage.runeSpellName);
 	}
 	if (spell) {
 		damage.damageMultiplier += checkFocusMasteryDamage();
-		if (getHealingLinkUpgrade(spell->getName())) {
-			damage.healingLink += 10;
-		}
-		if (spell->getSecondaryGroup() == SPELLGROUP_FOCUS && getInstant("Focus Mastery")) {
+		if (spell->getSecondaryGroup() == SPELLGROUP_FOCUS && getInstant(WheelInstant_t::FOCUS_MASTERY)) {
 			setOnThinkTimer(WheelOnThink_t::FOCUS_MASTERY, (OTSYS_TIME() + 12000));
 		}
 
-		if (spell->getWheelOfDestinyUpgraded()) {
-			damage.criticalDamage += spell->getWheelOfDestinyBoost(WheelSpellBoost_t::CRITICAL_DAMAGE, spellGrade) + getSpellBonus(spell->getName(), WheelSpellBoost_t::CRITICAL_DAMAGE);
-			damage.criticalChance += spell->getWheelOfDestinyBoost(WheelSpellBoost_t::CRITICAL_CHANCE, spellGrade) + getSpellBonus(spell->getName(), WheelSpellBoost_t::CRITICAL_CHANCE);
-			damage.damageMultiplier += spell->getWheelOfDestinyBoost(WheelSpellBoost_t::DAMAGE, spellGrade) + getSpellBonus(spell->getName(), WheelSpellBoost_t::DAMAGE);
-			damage.damageReductionMultiplier += spell->getWheelOfDestinyBoost(WheelSpellBoost_t::DAMAGE_REDUCTION, spellGrade) + getSpellBonus(spell->getName(), WheelSpellBoost_t::DAMAGE_REDUCTION);
-			damage.healingMultiplier += spell->getWheelOfDestinyBoost(WheelSpellBoost_t::HEAL, spellGrade) + getSpellBonus(spell->getName(), WheelSpellBoost_t::HEAL);
-			damage.manaLeech += spell->getWheelOfDestinyBoost(WheelSpellBoost_t::MANA_LEECH, spellGrade) + getSpellBonus(spell->getName(), WheelSpellBoost_t::MANA_LEECH);
-			damage.manaLeechChance += spell->getWheelOfDestinyBoost(WheelSpellBoost_t::LIFE_LEECH_CHANCE, spellGrade) + getSpellBonus(spell->getName(), WheelSpellBoost_t::LIFE_LEECH_CHANCE);
-			damage.lifeLeech += spell->getWheelOfDestinyBoost(WheelSpellBoost_t::LIFE_LEECH, spellGrade) + getSpellBonus(spell->getName(), WheelSpellBoost_t::LIFE_LEECH);
-			damage.lifeLeechChance += spell->getWheelOfDestinyBoost(WheelSpellBoost_t::LIFE_LEECH_CHANCE, spellGrade) + getSpellBonus(spell->getName(), WheelSpellBoost_t::LIFE_LEECH_CHANCE);
-		}
+		const auto &profile = getSpellProfile(spell, isInstant ? damage.instantSpellName : damage.runeSpellName, isInstant);
+		damage.healingLink += profile.healingLink;
+		damage.criticalDamage += profile.criticalDamage;
+		damage.criticalChance += profile.criticalChance;
+		damage.damageMultiplier += profile.damage;
+		damage.damageReductionMultiplier += profile.damageReduction;
+		damage.healingMultiplier += profile.healing;
+		damage.manaLeech += profile.manaLeech;
+		damage.manaLeechChance += profile.manaLeechChance;
+		damage.lifeLeech += profile.lifeLeech;
+		damage.lifeLeechChance += profile.lifeLeechChance;
 	}
 
 	return spell;
 }
 
+const PlayerWheel::SpellProfile &PlayerWheel::getSpellProfile(const std::shared_ptr<Spell> &spell, const std::string &castName, bool isInstant) {
+	auto &profile = m_spellProfiles[std::make_pair(castName, isInstant)];
+	if (profile.spell == spell.get()) {
+		return profile;
+	}
+
+	profile = SpellProfile();
+	profile.spell = spell.get();
+	const auto &spellName = spell->getName();
+	if (getHealingLinkUpgrade(spellName)) {
+		profile.healingLink = 10;
+	}
+	if (!spell->getWheelOfDestinyUpgraded()) {
+		return profile;
+	}
+
+	const auto spellGrade = isInstant ? getSpellUpgrade(castName) : WheelSpellGrade_t::NONE;
+	const auto boost = [&](WheelSpellBoost_t type) {
+		return spell->getWheelOfDestinyBoost(type, spellGrade) + getSpellBonus(spellName, type);
+	};
+	profile.criticalDamage = boost(WheelSpellBoost_t::CRITICAL_DAMAGE);
+	profile.criticalChance = boost(WheelSpellBoost_t::CRITICAL_CHANCE);
+	profile.damage = boost(WheelSpellBoost_t::DAMAGE);
+	profile.damageReduction = boost(WheelSpellBoost_t::DAMAGE_REDUCTION);
+	profile.healing = boost(WheelSpellBoost_t::HEAL);
+	profile.manaLeech = boost(WheelSpellBoost_t::MANA_LEECH);
+	profile.manaLeechChance = boost(WheelSpellBoost_t::LIFE_LEECH_CHANCE);
+	profile.lifeLeech = boost(WheelSpellBoost_t::LIFE_LEECH);
+	profile.lifeLeechChance = boost(WheelSpellBoost_t::LIFE_LEECH_CHANCE);
+	return profile;
+}
+
 // Wheel of destiny - setSpellInstant helpers
 void PlayerWheel::setStage(WheelStage_t type, uint8_t value) {
 	auto enumValue = static_cast<uint8_t>(type);
@@ -2637,6 +2701,7 @@ void PlayerWheel::setInstant(WheelInstant_t type, bool toggle) {
 	auto enumValue = static_cast<uint8_t>(type);
 	try {
 		m_instant.at(enumValue) = toggle;
+		m_spellProfiles.clear();
 	} catch (const std::out_of_range &e) {
 		g_logger().error("[{}]. Type {} is out of range. Error message: {}", __FUNCTION__, enumValue, e.what());
 	}
@@ -2796,49 +2861,12 @@ bool PlayerWheel::getInstant(WheelInstant_t type) const {
 }
 
 uint8_t PlayerWheel::getStage(const std::string name) const {
-	if (name == "Battle Instinct") {
-		return PlayerWheel::getInstant(WheelInstant_t::BATTLE_INSTINCT);
-	} else if (name == "Battle Healing") {
-		return PlayerWheel::getInstant(WheelInstant_t::BATTLE_HEALING);
-	} else if (name == "Positional Tatics") {
-		return PlayerWheel::getInstant(WheelInstant_t::POSITIONAL_TATICS);
-	} else if (name == "Ballistic Mastery") {
-		return PlayerWheel::getInstant(WheelInstant_t::BALLISTIC_MASTERY);
-	} else if (name == "Healing Link") {
-		return PlayerWheel::getInstant(WheelInstant_t::HEALING_LINK);
-	} else if (name == "Runic Mastery") {
-		return PlayerWheel::getInstant(WheelInstant_t::RUNIC_MASTERY);
-	} else if (name == "Focus Mastery") {
-		return PlayerWheel::getInstant(WheelInstant_t::FOCUS_MASTERY);
-	} else if (name == "Beam Mastery") {
-		return PlayerWheel::getStage(WheelStage_t::BEAM_MASTERY);
-	} else if (name == "Combat Mastery") {
-		return PlayerWheel::getStage(WheelStage_t::COMBAT_MASTERY);
-	} else if (name == "Gift of Life") {
-		return PlayerWheel::getStage(WheelStage_t::GIFT_OF_LIFE);
-	} else if (name == "Blessing of the Grove") {
-		return PlayerWheel::getStage(WheelStage_t::BLESSING_OF_THE_GROVE);
-	} else if (name == "Drain Body") {
-		return PlayerWheel::getStage(WheelStage_t::DRAIN_BODY);
-	} else if (name == "Divine Empowerment") {
-		return PlayerWheel::getStage(WheelStage_t::DIVINE_EMPOWERMENT);
-	} else if (name == "Divine Grenade") {
-		return PlayerWheel::getStage(WheelStage_t::DIVINE_GRENADE);
-	} else if (name == "Twin Burst") {
-		return PlayerWheel::getStage(WheelStage_t::TWIN_BURST);
-	} else if (name == "Executioner's Throw") {
-		return PlayerWheel::getStage(WheelStage_t::EXECUTIONERS_THROW);
-	} else if (name == "Avatar of Light") {
-		return PlayerWheel::getStage(WheelStage_t::AVATAR_OF_LIGHT);
-	} else if (name == "Avatar of Nature") {
-		return PlayerWheel::getStage(WheelStage_t::AVATAR_OF_NATURE);
-	} else if (name == "Avatar of Steel") {
-		return PlayerWheel::getStage(WheelStage_t::AVATAR_OF_STEEL);
-	} else if (name == "Avatar of Storm") {
-		return PlayerWheel::getStage(WheelStage_t::AVATAR_OF_STORM);
+	const auto it = perksByName.find(name);
+	if (it == perksByName.end()) {
+		return 0;
 	}
-
-	return false;
+	const auto &[isStage, index] = it->second;
+	return isStage ? getStage(static_cast<WheelStage_t>(index)) : getInstant(static_cast<WheelInstant_t>(index));
 }
 
 uint8_t PlayerWheel::getStage(WheelStage_t type) const {
@@ -2882,12 +2910,8 @@ int32_t PlayerWheel::getResistance(CombatType_t type) const {
 }
 
 WheelSpellGrade_t PlayerWheel::getSpellUpgrade(const std::string &name) const {
-	for (const auto &[name_it, grade_it] : m_spellsSelected) {
-		if (name_it == name) {
-			return grade_it;
-		}
-	}
-	return WheelSpellGrade_t::NONE;
+	const auto it = m_spellsSelected.find(name);
+	return it != m_spellsSelected.end() ? it->second : WheelSpellGrade_t::NONE;
 }
 
 double PlayerWheel::getMitigationMultiplier() const {
@@ -2920,49 +2944,7 @@ int64_t PlayerWheel::getOnThinkTimer(WheelOnThink_t type) const {
 }
 
 bool PlayerWheel::getInstant(const std::string name) const {
-	if (name == "Battle Instinct") {
-		return PlayerWheel::getInstant(WheelInstant_t::BATTLE_INSTINCT);
-	} else if (name == "Battle Healing") {
-		return PlayerWheel::getInstant(WheelInstant_t::BATTLE_HEALING);
-	} else if (name == "Positional Tatics") {
-		return PlayerWheel::getInstant(WheelInstant_t::POSITIONAL_TATICS);
-	} else if (name == "Ballistic Mastery") {
-		return PlayerWheel::getInstant(WheelInstant_t::BALLISTIC_MASTERY);
-	} else if (name == "Healing Link") {
-		return PlayerWheel::getInstant(WheelInstant_t::HEALING_LINK);
-	} else if (name == "Runic Mastery") {
-		return PlayerWheel::getInstant(WheelInstant_t::RUNIC_MASTERY);
-	} else if (name == "Focus Mastery") {
-		return PlayerWheel::getInstant(WheelInstant_t::FOCUS_MASTERY);
-	} else if (name == "Beam Mastery") {
-		return PlayerWheel::getStage(WheelStage_t::BEAM_MASTERY);
-	} else if (name == "Combat Mastery") {
-		return PlayerWheel::getStage(WheelStage_t::COMBAT_MASTERY);
-	} else if (name == "Gift of Life") {
-		return PlayerWheel::getStage(WheelStage_t::GIFT_OF_LIFE);
-	} else if (name == "Blessing of the Grove") {
-		return PlayerWheel::getStage(WheelStage_t::BLESSING_OF_THE_GROVE);
-	} else if (name == "Drain Body") {
-		return PlayerWheel::getStage(WheelStage_t::DRAIN_BODY);
-	} else if (name == "Divine Empowerment") {
-		return PlayerWheel::getStage(WheelStage_t::DIVINE_EMPOWERMENT);
-	} else if (name == "Divine Grenade") {
-		return PlayerWheel::getStage(WheelStage_t::DIVINE_GRENADE);
-	} else if (name == "Twin Burst") {
-		return PlayerWheel::getStage(WheelStage_t::TWIN_BURST);
-	} else if (name == "Executioner's Throw") {
-		return PlayerWheel::getStage(WheelStage_t::EXECUTIONERS_THROW);
-	} else if (name == "Avatar of Light") {
-		return PlayerWheel::getStage(WheelStage_t::AVATAR_OF_LIGHT);
-	} else if (name == "Avatar of Nature") {
-		return PlayerWheel::getStage(WheelStage_t::AVATAR_OF_NATURE);
-	} else if (name == "Avatar of Steel") {
-		return PlayerWheel::getStage(WheelStage_t::AVATAR_OF_STEEL);
-	} else if (name == "Avatar of Storm") {
-		return PlayerWheel::getStage(WheelStage_t::AVATAR_OF_STORM);
-	}
-
-	return false;
+	return getStage(name) != 0;
 }
 
 // Wheel of destiny - Specific functions
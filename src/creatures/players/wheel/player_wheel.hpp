@@ -325,6 +325,10 @@ public:
 	uint8_t getStage(const std::string name) const;
 	uint8_t getStage(WheelStage_t type) const;
 	WheelSpellGrade_t getSpellUpgrade(const std::string &name) const;
+	// Changes with any spell grade, the cached spell formulas of the player depend on it
+	uint32_t getSpellsVersion() const {
+		return m_spellsVersion;
+	}
 	int32_t getMajorStat(WheelMajor_t type) const;
 	int32_t getStat(WheelStat_t type) const;
 	int32_t getResistance(CombatType_t type) const;
@@ -350,6 +354,26 @@ public:
 
 	std::shared_ptr<Spell> getCombatDataSpell(CombatDamage &damage);
 
+	/**
+	 * Wheel modifiers applied to the damage of a spell, summed from its grade and the
+	 * bonuses of the wheel. Built on the first cast after the wheel changes.
+	 */
+	struct SpellProfile {
+		// Reloading the spells replaces them, the profile is rebuilt then
+		const Spell* spell = nullptr;
+		int32_t criticalDamage = 0;
+		int32_t criticalChance = 0;
+		int32_t damage = 0;
+		int32_t damageReduction = 0;
+		int32_t healing = 0;
+		int32_t manaLeech = 0;
+		int32_t manaLeechChance = 0;
+		int32_t lifeLeech = 0;
+		int32_t lifeLeechChance = 0;
+		int32_t healingLink = 0;
+	};
+	const SpellProfile &getSpellProfile(const std::shared_ptr<Spell> &spell, const std::string &castName, bool isInstant);
+
 	const PlayerWheelMethodsBonusData &getBonusData() const;
 
 	PlayerWheelMethodsBonusData &getBonusData();
@@ -417,16 +441,19 @@ public:
 			m_spellsBonuses[spellName].increase.heal += bonus.increase.heal;
 			m_spellsBonuses[spellName].leech.life += bonus.leech.life;
 			m_spellsBonuses[spellName].leech.mana += bonus.leech.mana;
+			m_spellProfiles.clear();
 			return;
 		}
 		m_spellsBonuses[spellName] = bonus;
+		m_spellProfiles.clear();
 	}
 
 	int32_t getSpellBonus(const std::string &spellName, WheelSpellBoost_t boost) const {
-		if (!m_spellsBonuses.contains(spellName)) {
+		const auto it = m_spellsBonuses.find(spellName);
+		if (it == m_spellsBonuses.end()) {
 			return 0;
 		}
-		auto bonus = m_spellsBonuses.at(spellName);
+		const auto &bonus = it->second;
 		switch (boost) {
 			case WheelSpellBoost_t::COOLDOWN:
 				return bonus.decrease.cooldown;
@@ -476,6 +503,9 @@ private:
 
 	int32_t m_creaturesNearby = 0;
 	std::map<std::string, WheelSpellGrade_t> m_spellsSelected;
+	uint32_t m_spellsVersion = 0;
 	std::vector<std::string> m_learnedSpellsSelected;
 	std::unordered_map<std::string, WheelSpells::Bonus> m_spellsBonuses;
+	// By cast name and whether it is an instant spell, cleared with any change to the grades, bonuses or instants
+	phmap::flat_hash_map<std::pair<std::string, bool>, SpellProfile> m_spellProfiles;
 };
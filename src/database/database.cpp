@@ -15,6 +15,9 @@
 #include "lib/metrics/metrics.hpp"
 
 Database::~Database() {
+	for (const auto &[query, statement] : statements) {
+		mysql_stmt_close(statement);
+	}
 	if (handle != nullptr) {
 		mysql_close(handle);
 	}
@@ -61,9 +64,7 @@ bool Database::beginTransaction() {
 	if (!executeQuery("BEGIN")) {
 		return false;
 	}
-	metrics::lock_latency measureLock("database");
 	databaseLock.lock();
-	measureLock.stop();
 
 	return true;
 }
@@ -122,6 +123,11 @@ bool Database::retryQuery(const std::string_view &query, int retries) {
 }
 
 bool Database::executeQuery(const std::string_view &query) {
+	if (DBQueryBatch::capturing) {
+		DBQueryBatch::capturing->queries.push_back({ std::string(query), std::nullopt });
+		return true;
+	}
+
 	if (!handle) {
 		g_logger().error("Database not initialized!");
 		return false;
@@ -129,9 +135,7 @@ bool Database::executeQuery(const std::string_view &query) {
 
 	g_logger().trace("Executing Query: {}", query);
 
-	metrics::lock_latency measureLock("database");
 	std::scoped_lock lock { databaseLock };
-	measureLock.stop();
 
 	metrics::query_latency measure(query.substr(0, 50));
 	bool success = retryQuery(query, 10);
@@ -141,15 +145,23 @@ bool Database::executeQuery(const std::string_view &query) {
 }
 
 DBResult_ptr Database::storeQuery(const std::string_view &query) {
+	if (DBResultPrefetch::using_) {
+		auto &prefetched = DBResultPrefetch::using_->results;
+		if (const auto it = prefetched.find(query); it != prefetched.end()) {
+			// A result can only be read once
+			DBResult_ptr result = std::move(it->second);
+			prefetched.erase(it);
+			return result;
+		}
+	}
+
 	if (!handle) {
 		g_logger().error("Database not initialized!");
 		return nullptr;
 	}
 	g_logger().trace("Storing Query: {}", query);
 
-	metrics::lock_latency measureLock("database");
 	std::scoped_lock lock { databaseLock };
-	measureLock.stop();
 
 	metrics::query_latency measure(query.substr(0, 50));
 retry:
@@ -175,6 +187,201 @@ retry:
 	return nullptr;
 }
 
+namespace {
+	// ER_UNKNOWN_STMT_HANDLER and ER_NEED_REPREPARE, the statement has to be prepared again
+	bool isStaleStatementError(unsigned int error) {
+		return error == 1243 || error == 1615;
+	}
+}
+
+MYSQL_STMT* Database::getStatement(std::string_view query) {
+	if (const auto it = statements.find(query); it != statements.end()) {
+		return it->second;
+	}
+
+	MYSQL_STMT* statement = mysql_stmt_init(handle);
+	if (!statement) {
+		g_logger().error("Failed to initialize MySQL statement.");
+		return nullptr;
+	}
+	if (mysql_stmt_prepare(statement, query.data(), static_cast<unsigned long>(query.size())) != 0) {
+		g_logger().error("Query: {}", query.substr(0, 256));
+		g_logger().error("MySQL error [{}]: {}", mysql_stmt_errno(statement), mysql_stmt_error(statement));
+		mysql_stmt_close(statement);
+		return nullptr;
+	}
+
+	statements.emplace(std::string(query), statement);
+	return statement;
+}
+
+void Database::dropStatement(std::string_view query) {
+	if (const auto it = statements.find(query); it != statements.end()) {
+		mysql_stmt_close(it->second);
+		statements.erase(it);
+	}
+}
+
+bool Database::runStatement(std::string_view query, std::span<const DBParam> params, DBResult_ptr* result) {
+	if (!handle) {
+		g_logger().error("Database not initialized!");
+		return false;
+	}
+
+	g_logger().trace("Executing Statement: {}", query);
+
+	std::scoped_lock lock { databaseLock };
+
+	metrics::query_latency measure(query.substr(0, 50));
+	for (int retries = 10; retries > 0; --retries) {
+		MYSQL_STMT* statement = getStatement(query);
+		if (!statement) {
+			if (!isRecoverableError(mysql_errno(handle))) {
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+			continue;
+		}
+
+		if (mysql_stmt_param_count(statement) != params.size()) {
+			g_logger().error("Statement expects {} values, {} given: {}", mysql_stmt_param_count(statement), params.size(), query.substr(0, 256));
+			return false;
+		}
+
+		std::vector<MYSQL_BIND> binds(params.size());
+		std::vector<unsigned long> lengths(params.size());
+		for (size_t i = 0; i < params.size(); ++i) {
+			auto &bind = binds[i];
+			std::memset(&bind, 0, sizeof(bind));
+			std::visit(
+				[&bind, &length = lengths[i]](const auto &value) {
+					using T = std::decay_t<decltype(value)>;
+					if constexpr (std::is_same_v<T, std::nullptr_t>) {
+						bind.buffer_type = MYSQL_TYPE_NULL;
+					} else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) {
+						bind.buffer_type = MYSQL_TYPE_LONGLONG;
+						bind.buffer = const_cast<T*>(&value);
+						bind.is_unsigned = std::is_same_v<T, uint64_t>;
+					} else if constexpr (std::is_same_v<T, double>) {
+						bind.buffer_type = MYSQL_TYPE_DOUBLE;
+						bind.buffer = const_cast<double*>(&value);
+					} else if constexpr (std::is_same_v<T, std::string_view>) {
+						bind.buffer_type = MYSQL_TYPE_STRING;
+						bind.buffer = const_cast<char*>(value.data());
+						length = static_cast<unsigned long>(value.size());
+						bind.buffer_length = length;
+						bind.length = &length;
+					} else {
+						bind.buffer_type = MYSQL_TYPE_BLOB;
+						bind.buffer = const_cast<char*>(value.data);
+						length = static_cast<unsigned long>(value.size);
+						bind.buffer_length = length;
+						bind.length = &length;
+					}
+				},
+				params[i].get()
+			);
+		}
+
+		if (mysql_stmt_bind_param(statement, binds.data()) != 0 || mysql_stmt_execute(statement) != 0) {
+			const auto error = mysql_stmt_errno(statement);
+			g_logger().error("Query: {}", query.substr(0, 256));
+			g_logger().error("MySQL error [{}]: {}", error, mysql_stmt_error(statement));
+			// The statements of a lost connection are gone with it
+			dropStatement(query);
+			if (!isStaleStatementError(error) && !isRecoverableError(error)) {
+				return false;
+			}
+			if (!isStaleStatementError(error)) {
+				std::this_thread::sleep_for(std::chrono::seconds(1));
+			}
+			continue;
+		}
+
+		MYSQL_RES* metadata = mysql_stmt_result_metadata(statement);
+		if (!metadata) {
+			return true;
+		}
+
+		const auto columnCount = mysql_num_fields(metadata);
+		const MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+		std::vector<std::string> columnNames;
+		columnNames.reserve(columnCount);
+		for (unsigned int column = 0; column < columnCount; ++column) {
+			columnNames.emplace_back(fields[column].name);
+		}
+		mysql_free_result(metadata);
+
+		if (!result || mysql_stmt_store_result(statement) != 0) {
+			mysql_stmt_free_result(statement);
+			return result == nullptr;
+		}
+
+		// Every value is fetched as text, like the rows of mysql_store_result, sized by a first fetch without buffers
+		std::vector<MYSQL_BIND> columns(columnCount);
+		std::vector<unsigned long> columnLengths(columnCount);
+		std::vector<char> nulls(columnCount);
+		for (unsigned int column = 0; column < columnCount; ++column) {
+			auto &bind = columns[column];
+			std::memset(&bind, 0, sizeof(bind));
+			bind.buffer_type = MYSQL_TYPE_STRING;
+			bind.length = &columnLengths[column];
+			bind.is_null = reinterpret_cast<decltype(bind.is_null)>(&nulls[column]);
+		}
+		mysql_stmt_bind_result(statement, columns.data());
+
+		std::vector<std::optional<std::string>> values;
+		values.reserve(static_cast<size_t>(mysql_stmt_num_rows(statement)) * columnCount);
+		int fetched;
+		while ((fetched = mysql_stmt_fetch(statement)) == 0 || fetched == MYSQL_DATA_TRUNCATED) {
+			for (unsigned int column = 0; column < columnCount; ++column) {
+				if (nulls[column]) {
+					values.emplace_back(std::nullopt);
+					continue;
+				}
+
+				auto &value = values.emplace_back(std::string(columnLengths[column], '\0'));
+				if (columnLengths[column] == 0) {
+					continue;
+				}
+
+				MYSQL_BIND cell {};
+				std::memset(&cell, 0, sizeof(cell));
+				cell.buffer_type = MYSQL_TYPE_STRING;
+				cell.buffer = value->data();
+				cell.buffer_length = columnLengths[column];
+				mysql_stmt_fetch_column(statement, &cell, column, 0);
+			}
+		}
+		mysql_stmt_free_result(statement);
+
+		if (!values.empty()) {
+			*result = std::make_shared<DBResult>(std::move(columnNames), std::move(values));
+		}
+		return true;
+	}
+
+	g_logger().error("Statement {} failed after {} retries.", query.substr(0, 256), 10);
+	return false;
+}
+
+bool Database::executeStatement(std::string_view query, std::initializer_list<DBParam> params) {
+	if (DBQueryBatch::capturing) {
+		DBQueryBatch::capturing->addStatement(query, params);
+		return true;
+	}
+
+	return runStatement(query, params, nullptr);
+}
+
+DBResult_ptr Database::storeStatement(std::string_view query, std::initializer_list<DBParam> params) {
+	DBResult_ptr result;
+	if (!runStatement(query, params, &result)) {
+		return nullptr;
+	}
+	return result;
+}
+
 std::string Database::escapeString(const std::string &s) const {
 	std::string::size_type len = s.length();
 	auto length = static_cast<uint32_t>(len);
@@ -186,20 +393,15 @@ std::string Database::escapeString(const std::string &s) const {
 }
 
 std::string Database::escapeBlob(const char* s, uint32_t length) const {
-	size_t maxLength = (length * 2) + 1;
-
-	std::string escaped;
-	escaped.reserve(maxLength + 2);
-	escaped.push_back('\'');
-
+	// Escaped straight into the quoted result, the worst case doubles every byte and adds the terminator
+	std::string escaped((static_cast<size_t>(length) * 2) + 3, '\0');
+	escaped[0] = '\'';
+	size_t escapedLength = 0;
 	if (length != 0) {
-		std::string output(maxLength, '\0');
-		size_t escapedLength = mysql_real_escape_string(handle, &output[0], s, length);
-		output.resize(escapedLength);
-		escaped.append(output);
+		escapedLength = mysql_real_escape_string(handle, &escaped[1], s, length);
 	}
-
-	escaped.push_back('\'');
+	escaped[escapedLength + 1] = '\'';
+	escaped.resize(escapedLength + 2);
 	return escaped;
 }
 
@@ -215,8 +417,39 @@ DBResult::DBResult(MYSQL_RES* res) {
 	row = mysql_fetch_row(handle);
 }
 
+DBResult::DBResult(std::vector<std::string> columnNames, std::vector<std::optional<std::string>> values) :
+	columns(std::move(columnNames)) {
+	for (size_t i = 0; i < columns.size(); i++) {
+		listNames[columns[i]] = i;
+	}
+
+	// The pointers are taken once every cell is in place
+	cells.reserve(values.size());
+	cellLengths.reserve(values.size());
+	for (auto &value : values) {
+		cellLengths.emplace_back(value ? static_cast<unsigned long>(value->size()) : 0);
+		cells.emplace_back(value ? std::move(*value) : std::string());
+	}
+	cellPointers.reserve(values.size());
+	for (size_t i = 0; i < values.size(); i++) {
+		cellPointers.emplace_back(values[i] ? cells[i].data() : nullptr);
+	}
+
+	rowCount = columns.empty() ? 0 : cells.size() / columns.size();
+	row = rowCount > 0 ? cellPointers.data() : nullptr;
+}
+
 DBResult::~DBResult() {
-	mysql_free_result(handle);
+	if (handle) {
+		mysql_free_result(handle);
+	}
+}
+
+unsigned long DBResult::getLength(size_t column) const {
+	if (handle) {
+		return mysql_fetch_lengths(handle)[column];
+	}
+	return cellLengths[(currentRow * columns.size()) + column];
 }
 
 std::string DBResult::getString(const std::string &s) const {
@@ -244,7 +477,7 @@ const char* DBResult::getStream(const std::string &s, unsigned long &size) const
 		return nullptr;
 	}
 
-	size = mysql_fetch_lengths(handle)[it->second];
+	size = getLength(it->second);
 	return row[it->second];
 }
 
@@ -269,6 +502,9 @@ int8_t DBResult::getInt8FromString(const std::string &string, const std::string
 }
 
 size_t DBResult::countResults() const {
+	if (!handle) {
+		return rowCount;
+	}
 	return static_cast<size_t>(mysql_num_rows(handle));
 }
 
@@ -278,8 +514,13 @@ bool DBResult::hasNext() const {
 
 bool DBResult::next() {
 	if (!handle) {
-		g_logger().error("Database not initialized!");
-		return false;
+		if (currentRow + 1 >= rowCount) {
+			currentRow = rowCount;
+			row = nullptr;
+			return false;
+		}
+		row = cellPointers.data() + (++currentRow * columns.size());
+		return true;
 	}
 	row = mysql_fetch_row(handle);
 	return row != nullptr;
@@ -372,3 +613,205 @@ bool DBInsert::execute() {
 
 	return true;
 }
+
+thread_local DBQueryBatch* DBQueryBatch::capturing = nullptr;
+thread_local DBResultPrefetch* DBResultPrefetch::using_ = nullptr;
+
+bool DBQueryBatch::execute() const {
+	if (queries.empty()) {
+		return true;
+	}
+
+	return DBTransaction::executeWithinTransaction([this]() {
+		Database &db = Database::getInstance();
+		std::vector<DBParam> params;
+		for (const auto &query : queries) {
+			bool executed;
+			if (query.params) {
+				params.clear();
+				for (const auto &param : *query.params) {
+					std::visit(
+						[&params](const auto &value) {
+							using T = std::decay_t<decltype(value)>;
+							if constexpr (std::is_same_v<T, std::vector<char>>) {
+								params.emplace_back(DBBlob { value.data(), value.size() });
+							} else {
+								params.emplace_back(value);
+							}
+						},
+						param
+					);
+				}
+				executed = db.runStatement(query.text, params, nullptr);
+			} else {
+				executed = db.executeQuery(query.text);
+			}
+
+			// Throwing rolls the whole batch back
+			if (!executed) {
+				throw DatabaseException("Failed to execute query of the batch: " + query.text.substr(0, 256));
+			}
+		}
+		return true;
+	});
+}
+
+namespace {
+	template <typename T>
+	void writeValue(std::string &out, T value) {
+		out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	void writeBytes(std::string &out, const char* data, size_t size) {
+		writeValue(out, static_cast<uint32_t>(size));
+		out.append(data, size);
+	}
+
+	template <typename T>
+	bool readValue(std::string_view &data, T &value) {
+		if (data.size() < sizeof(T)) {
+			return false;
+		}
+		std::memcpy(&value, data.data(), sizeof(T));
+		data.remove_prefix(sizeof(T));
+		return true;
+	}
+
+	bool readBytes(std::string_view &data, std::string_view &bytes) {
+		uint32_t size;
+		if (!readValue(data, size) || data.size() < size) {
+			return false;
+		}
+		bytes = data.substr(0, size);
+		data.remove_prefix(size);
+		return true;
+	}
+}
+
+void DBQueryBatch::serialize(std::string &out) const {
+	writeValue(out, static_cast<uint32_t>(queries.size()));
+	for (const auto &query : queries) {
+		writeBytes(out, query.text.data(), query.text.size());
+		writeValue(out, static_cast<uint8_t>(query.params.has_value()));
+		if (!query.params) {
+			continue;
+		}
+
+		writeValue(out, static_cast<uint32_t>(query.params->size()));
+		for (const auto &param : *query.params) {
+			writeValue(out, static_cast<uint8_t>(param.index()));
+			std::visit(
+				[&out](const auto &value) {
+					using T = std::decay_t<decltype(value)>;
+					if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::vector<char>>) {
+						writeBytes(out, value.data(), value.size());
+					} else if constexpr (!std::is_same_v<T, std::nullptr_t>) {
+						writeValue(out, value);
+					}
+				},
+				param
+			);
+		}
+	}
+}
+
+bool DBQueryBatch::deserialize(std::string_view data) {
+	queries.clear();
+	uint32_t count;
+	if (!readValue(data, count)) {
+		return false;
+	}
+
+	queries.reserve(count);
+	for (uint32_t i = 0; i < count; ++i) {
+		std::string_view text;
+		uint8_t hasParams;
+		if (!readBytes(data, text) || !readValue(data, hasParams)) {
+			return false;
+		}
+
+		auto &query = queries.emplace_back(Query { std::string(text) });
+		if (!hasParams) {
+			continue;
+		}
+
+		uint32_t paramCount;
+		if (!readValue(data, paramCount)) {
+			return false;
+		}
+
+		auto &params = query.params.emplace();
+		params.reserve(paramCount);
+		for (uint32_t j = 0; j < paramCount; ++j) {
+			uint8_t index;
+			if (!readValue(data, index)) {
+				return false;
+			}
+
+			// Same order as the alternatives of OwnedParam
+			int64_t signedValue;
+			uint64_t unsignedValue;
+			double doubleValue;
+			std::string_view bytes;
+			switch (index) {
+				case 0:
+					params.emplace_back(nullptr);
+					break;
+				case 1:
+					if (!readValue(data, signedValue)) {
+						return false;
+					}
+					params.emplace_back(signedValue);
+					break;
+				case 2:
+					if (!readValue(data, unsignedValue)) {
+						return false;
+					}
+					params.emplace_back(unsignedValue);
+					break;
+				case 3:
+					if (!readValue(data, doubleValue)) {
+						return false;
+					}
+					params.emplace_back(doubleValue);
+					break;
+				case 4:
+					if (!readBytes(data, bytes)) {
+						return false;
+					}
+					params.emplace_back(std::string(bytes));
+					break;
+				case 5:
+					if (!readBytes(data, bytes)) {
+						return false;
+					}
+					params.emplace_back(std::vector<char>(bytes.begin(), bytes.end()));
+					break;
+				default:
+					return false;
+			}
+		}
+	}
+	return data.empty();
+}
+
+void DBQueryBatch::addStatement(std::string_view query, std::initializer_list<DBParam> params) {
+	std::vector<OwnedParam> owned;
+	owned.reserve(params.size());
+	for (const auto &param : params) {
+		std::visit(
+			[&owned](const auto &value) {
+				using T = std::decay_t<decltype(value)>;
+				if constexpr (std::is_same_v<T, std::string_view>) {
+					owned.emplace_back(std::string(value));
+				} else if constexpr (std::is_same_v<T, DBBlob>) {
+					owned.emplace_back(std::vector<char>(value.data, value.data + value.size));
+				} else {
+					owned.emplace_back(value);
+				}
+			},
+			param.get()
+		);
+	}
+	queries.push_back({ std::string(query), std::move(owned) });
+}
@@ -20,6 +20,50 @@
 class DBResult;
 using DBResult_ptr = std::shared_ptr<DBResult>;
 
+// Binary value of a prepared statement, sent as is
+struct DBBlob {
+	const char* data;
+	size_t size;
+};
+
+/**
+ * Typed value bound to a '?' of a prepared statement.
+ * Strings and blobs are only viewed, they must outlive the call.
+ */
+class DBParam {
+public:
+	using Value = std::variant<std::nullptr_t, int64_t, uint64_t, double, std::string_view, DBBlob>;
+
+	DBParam(std::nullptr_t) :
+		value(nullptr) { }
+	template <typename T>
+		requires std::is_integral_v<T>
+	DBParam(T number) {
+		if constexpr (std::is_signed_v<T>) {
+			value = static_cast<int64_t>(number);
+		} else {
+			value = static_cast<uint64_t>(number);
+		}
+	}
+	DBParam(double number) :
+		value(number) { }
+	DBParam(std::string_view text) :
+		value(text) { }
+	DBParam(const std::string &text) :
+		value(std::string_view(text)) { }
+	DBParam(const char* text) :
+		value(std::string_view(text)) { }
+	DBParam(DBBlob blob) :
+		value(blob) { }
+
+	const Value &get() const {
+		return value;
+	}
+
+private:
+	Value value;
+};
+
 class Database {
 public:
 	static const size_t MAX_QUERY_SIZE = 8 * 1024 * 1024; // 8 Mb -- half the default MySQL max_allowed_packet size
@@ -42,6 +86,15 @@ public:
 
 	DBResult_ptr storeQuery(const std::string_view &query);
 
+	/**
+	 * @brief Runs a query with '?' placeholders as a prepared statement, binding the values in order.
+	 * The statement is prepared once per connection and kept, string values need no escaping.
+	 * While a DBQueryBatch::Capture is alive, it is added to the batch like executeQuery.
+	 */
+	bool executeStatement(std::string_view query, std::initializer_list<DBParam> params);
+	// Reads the rows of a prepared statement, nullptr without rows like storeQuery
+	DBResult_ptr storeStatement(std::string_view query, std::initializer_list<DBParam> params);
+
 	std::string escapeString(const std::string &s) const;
 
 	std::string escapeBlob(const char* s, uint32_t length) const;
@@ -65,11 +118,18 @@ private:
 
 	bool isRecoverableError(unsigned int error) const;
 
+	MYSQL_STMT* getStatement(std::string_view query);
+	void dropStatement(std::string_view query);
+	bool runStatement(std::string_view query, std::span<const DBParam> params, DBResult_ptr* result);
+
 	MYSQL* handle = nullptr;
-	std::recursive_mutex databaseLock;
+	// Statements prepared on the connection, by query
+	phmap::flat_hash_map<std::string, MYSQL_STMT*> statements;
+	ProfiledMutex<std::recursive_mutex> databaseLock { "database" };
 	uint64_t maxPacketSize = 1048576;
 
 	friend class DBTransaction;
+	friend class DBQueryBatch;
 };
 
 constexpr auto g_database = Database::getInstance;
@@ -77,6 +137,8 @@ constexpr auto g_database = Database::getInstance;
 class DBResult {
 public:
 	explicit DBResult(MYSQL_RES* res);
+	// Rows of a prepared statement, each value as text or nullopt for NULL, row by row
+	DBResult(std::vector<std::string> columnNames, std::vector<std::optional<std::string>> values);
 	~DBResult();
 
 	// Non copyable
@@ -157,11 +219,21 @@ public:
 	bool next();
 
 private:
-	MYSQL_RES* handle;
-	MYSQL_ROW row;
+	unsigned long getLength(size_t column) const;
+
+	MYSQL_RES* handle = nullptr;
+	MYSQL_ROW row = nullptr;
 
 	std::map<std::string_view, size_t> listNames;
 
+	// Owned rows of a prepared statement, handle is nullptr then
+	std::vector<std::string> columns;
+	std::vector<std::string> cells;
+	std::vector<char*> cellPointers;
+	std::vector<unsigned long> cellLengths;
+	size_t rowCount = 0;
+	size_t currentRow = 0;
+
 	friend class Database;
 };
 
@@ -183,6 +255,112 @@ private:
 	size_t length;
 };
 
+/**
+ * Write queries built on one thread and executed later, in a single transaction.
+ * While a DBQueryBatch::Capture is alive, Database::executeQuery on that thread
+ * appends to the batch instead of running the query; reads are still executed.
+ */
+class DBQueryBatch {
+public:
+	class Capture {
+	public:
+		explicit Capture(DBQueryBatch &batch) :
+			previous(capturing) {
+			capturing = &batch;
+		}
+
+		~Capture() {
+			capturing = previous;
+		}
+
+		Capture(const Capture &) = delete;
+		Capture &operator=(const Capture &) = delete;
+
+	private:
+		DBQueryBatch* previous;
+	};
+
+	bool execute() const;
+
+	bool empty() const noexcept {
+		return queries.empty();
+	}
+
+	size_t size() const noexcept {
+		return queries.size();
+	}
+
+	/**
+	 * @brief Appends the queries and the values of their statements to a binary record.
+	 */
+	void serialize(std::string &out) const;
+	/**
+	 * @brief Reads a record written by serialize.
+	 * @return False if the record is truncated or malformed.
+	 */
+	bool deserialize(std::string_view data);
+
+private:
+	// The values of a captured statement, kept until the batch runs
+	using OwnedParam = std::variant<std::nullptr_t, int64_t, uint64_t, double, std::string, std::vector<char>>;
+	struct Query {
+		std::string text;
+		// Only for statements
+		std::optional<std::vector<OwnedParam>> params;
+	};
+
+	void addStatement(std::string_view query, std::initializer_list<DBParam> params);
+
+	std::vector<Query> queries;
+
+	static thread_local DBQueryBatch* capturing;
+
+	friend class Database;
+};
+
+/**
+ * Read queries run ahead of the code that needs their results.
+ * While a DBResultPrefetch::Use is alive, Database::storeQuery on that thread
+ * returns the prefetched result of an identical query, once, instead of running
+ * it; any other query still goes to the database.
+ */
+class DBResultPrefetch {
+public:
+	class Use {
+	public:
+		explicit Use(DBResultPrefetch &prefetch) :
+			previous(using_) {
+			using_ = &prefetch;
+		}
+
+		~Use() {
+			using_ = previous;
+		}
+
+		Use(const Use &) = delete;
+		Use &operator=(const Use &) = delete;
+
+	private:
+		DBResultPrefetch* previous;
+	};
+
+	void add(std::string query, DBResult_ptr result) {
+		results.insert_or_assign(std::move(query), std::move(result));
+	}
+
+	size_t size() const noexcept {
+		return results.size();
+	}
+
+private:
+	// A query without rows is kept as nullptr, it was still prefetched
+	phmap::flat_hash_map<std::string, DBResult_ptr> results;
+
+	static thread_local DBResultPrefetch* using_;
+
+	friend class Database;
+};
+
 class DBTransaction {
 public:
 	explicit DBTransaction() = default;
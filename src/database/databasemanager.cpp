@@ -13,6 +13,7 @@
 #include "database/databasemanager.hpp"
 #include "lua/functions/core/libs/core_libs_functions.hpp"
 #include "lua/scripts/luascript.hpp"
+#include "lib/metrics/metrics.hpp"
 
 bool DatabaseManager::optimizeTables() {
 	Database &db = Database::getInstance();
@@ -51,15 +52,30 @@ bool DatabaseManager::tableExists(const std::string &tableName) {
 	return db.storeQuery(query.str()).get() != nullptr;
 }
 
+DatabaseManager::SchemaState DatabaseManager::getSchemaState() {
+	// Both checks in one round trip, they run on every boot
+	SchemaState state;
+	DBResult_ptr result = Database::getInstance().storeStatement(
+		"SELECT COUNT(*) AS `tables`, COALESCE(MAX(`TABLE_NAME` = 'server_config'), 0) AS `server_config` FROM `information_schema`.`tables` WHERE `TABLE_SCHEMA` = ?",
+		{ g_configManager().getString(MYSQL_DB, __FUNCTION__) }
+	);
+	if (result) {
+		state.tables = result->getNumber<uint32_t>("tables");
+		state.hasServerConfig = result->getNumber<uint32_t>("server_config") != 0;
+	}
+	return state;
+}
+
 bool DatabaseManager::isDatabaseSetup() {
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `TABLE_NAME` FROM `information_schema`.`tables` WHERE `TABLE_SCHEMA` = " << db.escapeString(g_configManager().getString(MYSQL_DB, __FUNCTION__));
-	return db.storeQuery(query.str()).get() != nullptr;
+	return getSchemaState().tables != 0;
 }
 
 int32_t DatabaseManager::getDatabaseVersion() {
-	if (!tableExists("server_config")) {
+	return getDatabaseVersion(getSchemaState());
+}
+
+int32_t DatabaseManager::getDatabaseVersion(const SchemaState &schema) {
+	if (!schema.hasServerConfig) {
 		Database &db = Database::getInstance();
 		db.executeQuery("CREATE TABLE `server_config` (`config` VARCHAR(50) NOT NULL, `value` VARCHAR(256) NOT NULL DEFAULT '', UNIQUE(`config`)) ENGINE = InnoDB");
 		db.executeQuery("INSERT INTO `server_config` VALUES ('db_version', 0)");
@@ -74,6 +90,10 @@ int32_t DatabaseManager::getDatabaseVersion() {
 }
 
 void DatabaseManager::updateDatabase() {
+	updateDatabase(getSchemaState());
+}
+
+void DatabaseManager::updateDatabase(const SchemaState &schema) {
 	lua_State* L = luaL_newstate();
 	if (!L) {
 		return;
@@ -83,8 +103,11 @@ void DatabaseManager::updateDatabase() {
 
 	CoreLibsFunctions::init(L);
 
-	int32_t version = getDatabaseVersion();
+	int32_t version = getDatabaseVersion(schema);
+	const auto updateStart = std::chrono::steady_clock::now();
+	const int32_t firstVersion = version;
 	do {
+		const auto migrationStart = std::chrono::steady_clock::now();
 		std::ostringstream ss;
 		ss << g_configManager().getString(DATA_DIRECTORY, __FUNCTION__) + "/migrations/" << version << ".lua";
 		if (luaL_dofile(L, ss.str().c_str()) != 0) {
@@ -110,13 +133,21 @@ void DatabaseManager::updateDatabase() {
 			break;
 		}
 
+		const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - migrationStart).count();
+		g_metrics().addCounter("database_migration_ms", static_cast<double>(elapsed), { { "version", std::to_string(version) } });
+
 		version++;
-		g_logger().info("Database has been updated to version {}", version);
+		g_logger().info("Database has been updated to version {} in {} ms", version, elapsed);
 		registerDatabaseConfig("db_version", version);
 
 		LuaScriptInterface::resetScriptEnv();
 	} while (true);
 	lua_close(L);
+
+	if (version != firstVersion) {
+		const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - updateStart).count();
+		g_logger().info("Database updated from version {} to {} in {} ms", firstVersion, version, elapsed);
+	}
 }
 
 bool DatabaseManager::getDatabaseConfig(const std::string &config, int32_t &value) {
@@ -134,16 +165,9 @@ bool DatabaseManager::getDatabaseConfig(const std::string &config, int32_t &valu
 }
 
 void DatabaseManager::registerDatabaseConfig(const std::string &config, int32_t value) {
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-
-	int32_t tmp;
-
-	if (!getDatabaseConfig(config, tmp)) {
-		query << "INSERT INTO `server_config` VALUES (" << db.escapeString(config) << ", '" << value << "')";
-	} else {
-		query << "UPDATE `server_config` SET `value` = '" << value << "' WHERE `config` = " << db.escapeString(config);
-	}
-
-	db.executeQuery(query.str());
+	// The config is the key of the table, one upsert instead of a read and a write
+	Database::getInstance().executeStatement(
+		"INSERT INTO `server_config` (`config`, `value`) VALUES (?, ?) ON DUPLICATE KEY UPDATE `value` = VALUES(`value`)",
+		{ config, value }
+	);
 }
@@ -15,11 +15,24 @@ class DatabaseManager {
 public:
 	static bool tableExists(const std::string &table);
 
+	struct SchemaState {
+		// Tables of the configured database, 0 until the schema is imported
+		uint32_t tables = 0;
+		bool hasServerConfig = false;
+	};
+
+	/**
+	 * @brief Reads how far the schema is set up with a single query.
+	 */
+	static SchemaState getSchemaState();
+
 	static int32_t getDatabaseVersion();
+	static int32_t getDatabaseVersion(const SchemaState &schema);
 	static bool isDatabaseSetup();
 
 	static bool optimizeTables();
 	static void updateDatabase();
+	static void updateDatabase(const SchemaState &schema);
 
 	static bool getDatabaseConfig(const std::string &config, int32_t &value);
 	static void registerDatabaseConfig(const std::string &config, int32_t value);
@@ -13,6 +13,8 @@
 #include "game/scheduling/dispatcher.hpp"
 #include "lib/thread/thread_pool.hpp"
 #include "lib/di/container.hpp"
+#include "config/configmanager.hpp"
+#include "utils/tools.hpp"
 
 DatabaseTasks::DatabaseTasks(ThreadPool &threadPool, Database &db) :
 	db(db), threadPool(threadPool) {
@@ -22,7 +24,59 @@ DatabaseTasks &DatabaseTasks::getInstance() {
 	return inject<DatabaseTasks>();
 }
 
+void DatabaseTasks::init() {
+	const auto workerCount = g_configManager().getNumber(DATABASE_WORKERS, __FUNCTION__);
+	if (workerCount <= 0) {
+		return;
+	}
+
+	coalesceWindow = std::chrono::milliseconds(std::max<int32_t>(0, g_configManager().getNumber(DATABASE_COALESCE_WINDOW, __FUNCTION__)));
+	for (int32_t i = 0; i < workerCount; ++i) {
+		auto worker = std::make_unique<Worker>();
+		worker->id = static_cast<uint32_t>(i);
+		worker->queueName = fmt::format("database_worker_{}_queue", i);
+		worker->connection = std::make_unique<Database>();
+		if (!worker->connection->connect()) {
+			g_logger().error("[{}] - Failed to connect database worker {}, async queries will use the main connection", __FUNCTION__, i);
+			workers.clear();
+			return;
+		}
+		workers.emplace_back(std::move(worker));
+	}
+
+	for (const auto &worker : workers) {
+		worker->thread = std::thread([this, &worker = *worker]() {
+			runWorker(worker);
+		});
+	}
+
+	g_logger().info("Started {} database workers", workers.size());
+}
+
+void DatabaseTasks::shutdown() {
+	for (const auto &worker : workers) {
+		{
+			std::scoped_lock lock(worker->queueMutex);
+			worker->stopping = true;
+		}
+		worker->queueSignal.notify_one();
+	}
+
+	// Workers drain their queues before leaving
+	for (const auto &worker : workers) {
+		if (worker->thread.joinable()) {
+			worker->thread.join();
+		}
+	}
+	workers.clear();
+}
+
 void DatabaseTasks::execute(const std::string &query, std::function<void(DBResult_ptr, bool)> callback /* nullptr */) {
+	if (!workers.empty()) {
+		enqueue(query, std::move(callback), false);
+		return;
+	}
+
 	threadPool.detach_task([this, query, callback]() {
 		bool success = db.executeQuery(query);
 		if (callback != nullptr) {
@@ -32,6 +86,11 @@ void DatabaseTasks::execute(const std::string &query, std::function<void(DBResul
 }
 
 void DatabaseTasks::store(const std::string &query, std::function<void(DBResult_ptr, bool)> callback /* nullptr */) {
+	if (!workers.empty()) {
+		enqueue(query, std::move(callback), true);
+		return;
+	}
+
 	threadPool.detach_task([this, query, callback]() {
 		DBResult_ptr result = db.storeQuery(query);
 		if (callback != nullptr) {
@@ -39,3 +98,179 @@ void DatabaseTasks::store(const std::string &query, std::function<void(DBResult_
 		}
 	});
 }
+
+void DatabaseTasks::prefetch(std::vector<std::string> queries, std::function<void(const std::shared_ptr<DBResultPrefetch> &)> callback) {
+	auto prefetch = std::make_shared<DBResultPrefetch>();
+	if (queries.empty()) {
+		g_dispatcher().addEvent([prefetch, callback = std::move(callback)]() { callback(prefetch); }, __FUNCTION__);
+		return;
+	}
+
+	// The store callbacks all run on the dispatcher, the last one completes the prefetch
+	auto remaining = std::make_shared<size_t>(queries.size());
+	auto done = std::make_shared<std::function<void(const std::shared_ptr<DBResultPrefetch> &)>>(std::move(callback));
+	for (auto &query : queries) {
+		store(query, [prefetch, remaining, done, query](DBResult_ptr result, bool) {
+			prefetch->add(query, std::move(result));
+			if (--*remaining == 0) {
+				(*done)(prefetch);
+			}
+		});
+	}
+}
+
+void DatabaseTasks::enqueue(std::string query, std::function<void(DBResult_ptr, bool)> callback, bool store) {
+	// Queries of the same table always go to the same worker, so they keep the order they were issued in
+	const auto table = getQueryTable(query);
+	auto &worker = *workers[std::hash<std::string_view>()(table) % workers.size()];
+
+	{
+		std::scoped_lock lock(worker.queueMutex);
+		worker.queue.emplace_back(PendingQuery { std::move(query), std::move(callback), store, std::make_unique<metrics::query_latency>(worker.queueName) });
+	}
+	g_metrics().addUpDownCounter("database_queue_depth", 1, { { "queue", worker.queueName } });
+	worker.queueSignal.notify_one();
+}
+
+void DatabaseTasks::runWorker(Worker &worker) {
+	mysql_thread_init();
+
+	std::vector<PendingQuery> batch;
+	while (true) {
+		{
+			std::unique_lock lock(worker.queueMutex);
+			worker.queueSignal.wait(lock, [&worker] { return worker.stopping || !worker.queue.empty(); });
+			if (worker.queue.empty()) {
+				break;
+			}
+
+			// Give single row inserts a moment to pile up, so they can share one statement
+			if (coalesceWindow.count() > 0 && !worker.stopping && getCoalescePrefixLength(worker.queue.front().query) > 0) {
+				worker.queueSignal.wait_for(lock, coalesceWindow, [&worker] {
+					return worker.stopping || worker.queue.size() >= MAX_COALESCED_QUERIES;
+				});
+			}
+
+			batch.assign(std::make_move_iterator(worker.queue.begin()), std::make_move_iterator(worker.queue.end()));
+			worker.queue.clear();
+		}
+
+		g_metrics().addUpDownCounter("database_queue_depth", -static_cast<int>(batch.size()), { { "queue", worker.queueName } });
+		processBatch(worker, batch);
+		batch.clear();
+	}
+
+	mysql_thread_end();
+}
+
+void DatabaseTasks::processBatch(Worker &worker, std::vector<PendingQuery> &batch) {
+	for (auto &pending : batch) {
+		pending.queueLatency->stop();
+	}
+
+	auto it = batch.begin();
+	while (it != batch.end()) {
+		if (it->store) {
+			DBResult_ptr result = worker.connection->storeQuery(it->query);
+			if (it->callback != nullptr) {
+				g_dispatcher().addEvent([callback = std::move(it->callback), result]() { callback(result, true); }, "DatabaseTasks::store");
+			}
+			++it;
+			continue;
+		}
+
+		// Neighbouring inserts into the same columns are merged, anything in between keeps them apart
+		const size_t prefixLength = getCoalescePrefixLength(it->query);
+		auto last = std::next(it);
+		if (prefixLength > 0) {
+			const std::string_view prefix(it->query.data(), prefixLength);
+			while (last != batch.end() && !last->store && std::distance(it, last) < static_cast<std::ptrdiff_t>(MAX_COALESCED_QUERIES)
+			       && getCoalescePrefixLength(last->query) == prefixLength && std::string_view(last->query).starts_with(prefix)) {
+				++last;
+			}
+		}
+
+		executeCoalesced(worker, it, last, prefixLength);
+		it = last;
+	}
+}
+
+void DatabaseTasks::executeCoalesced(Worker &worker, std::vector<PendingQuery>::iterator first, std::vector<PendingQuery>::iterator last, size_t prefixLength) {
+	const auto notify = [](PendingQuery &pending, bool success) {
+		if (pending.callback != nullptr) {
+			g_dispatcher().addEvent([callback = std::move(pending.callback), success]() { callback(nullptr, success); }, "DatabaseTasks::execute");
+		}
+	};
+
+	if (std::distance(first, last) == 1) {
+		notify(*first, worker.connection->executeQuery(first->query));
+		return;
+	}
+
+	std::string statement(first->query, 0, prefixLength);
+	for (auto it = first; it != last; ++it) {
+		if (it != first) {
+			statement.push_back(',');
+		}
+		statement.append(it->query, prefixLength);
+	}
+
+	if (statement.size() <= worker.connection->getMaxPacketSize() && worker.connection->executeQuery(statement)) {
+		for (auto it = first; it != last; ++it) {
+			notify(*it, true);
+		}
+		return;
+	}
+
+	// One bad row must not fail the others, run them one by one
+	for (auto it = first; it != last; ++it) {
+		notify(*it, worker.connection->executeQuery(it->query));
+	}
+}
+
+std::string_view DatabaseTasks::getQueryTable(std::string_view query) {
+	static constexpr std::array<std::string_view, 3> keywords { "into ", "from ", "update " };
+
+	std::string lowerQuery = asLowerCaseString(std::string(query.substr(0, 128)));
+	size_t keywordEnd = std::string::npos;
+	for (const auto &keyword : keywords) {
+		if (const size_t position = lowerQuery.find(keyword); position != std::string::npos && (keywordEnd == std::string::npos || position + keyword.size() < keywordEnd)) {
+			keywordEnd = position + keyword.size();
+		}
+	}
+
+	if (keywordEnd == std::string::npos) {
+		return {};
+	}
+
+	size_t begin = query.find_first_not_of(" `", keywordEnd);
+	if (begin == std::string_view::npos) {
+		return {};
+	}
+
+	const size_t end = query.find_first_of(" `(,;", begin);
+	return query.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+}
+
+size_t DatabaseTasks::getCoalescePrefixLength(std::string_view query) {
+	// Only plain "INSERT INTO t (...) VALUES (...)" can be merged with the rows of another query
+	if (query.size() < 12 || asLowerCaseString(std::string(query.substr(0, 12))) != "insert into ") {
+		return 0;
+	}
+
+	const std::string lowerQuery = asLowerCaseString(std::string(query));
+	if (lowerQuery.find("select") != std::string::npos || lowerQuery.find("on duplicate") != std::string::npos) {
+		return 0;
+	}
+
+	const size_t values = lowerQuery.find(" values");
+	if (values == std::string::npos) {
+		return 0;
+	}
+
+	const size_t rowsBegin = query.find_first_not_of(' ', values + 7);
+	if (rowsBegin == std::string_view::npos || query[rowsBegin] != '(' || query.back() != ')') {
+		return 0;
+	}
+	return rowsBegin;
+}
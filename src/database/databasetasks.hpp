@@ -11,6 +11,7 @@
 
 #include "database/database.hpp"
 #include "lib/thread/thread_pool.hpp"
+#include "lib/metrics/metrics.hpp"
 
 class DatabaseTasks {
 public:
@@ -22,12 +23,62 @@ public:
 
 	static DatabaseTasks &getInstance();
 
+	/**
+	 * @brief Starts the database workers set by databaseWorkers, each one with its own connection.
+	 * Without workers the queries run on the thread pool over the main connection.
+	 */
+	void init();
+	void shutdown();
+
+	// Only the workers keep the order of the queries of a table, the thread pool runs them in any order
+	bool hasWorkers() const {
+		return !workers.empty();
+	}
+
 	void execute(const std::string &query, std::function<void(DBResult_ptr, bool)> callback = nullptr);
 	void store(const std::string &query, std::function<void(DBResult_ptr, bool)> callback = nullptr);
+	/**
+	 * @brief Runs the read queries side by side and calls back on the dispatcher once all of them are stored.
+	 * With workers the queries of different tables run on different connections.
+	 */
+	void prefetch(std::vector<std::string> queries, std::function<void(const std::shared_ptr<DBResultPrefetch> &)> callback);
 
 private:
+	struct PendingQuery {
+		std::string query;
+		std::function<void(DBResult_ptr, bool)> callback;
+		bool store = false;
+		// Time spent waiting in the worker queue
+		std::unique_ptr<metrics::query_latency> queueLatency;
+	};
+
+	struct Worker {
+		uint32_t id = 0;
+		std::string queueName;
+		std::unique_ptr<Database> connection;
+		std::thread thread;
+
+		std::mutex queueMutex;
+		std::condition_variable queueSignal;
+		std::deque<PendingQuery> queue;
+		bool stopping = false;
+	};
+
+	static constexpr size_t MAX_COALESCED_QUERIES = 256;
+
+	void enqueue(std::string query, std::function<void(DBResult_ptr, bool)> callback, bool store);
+	void runWorker(Worker &worker);
+	void processBatch(Worker &worker, std::vector<PendingQuery> &batch);
+	void executeCoalesced(Worker &worker, std::vector<PendingQuery>::iterator first, std::vector<PendingQuery>::iterator last, size_t prefixLength);
+
+	static std::string_view getQueryTable(std::string_view query);
+	static size_t getCoalescePrefixLength(std::string_view query);
+
 	Database &db;
 	ThreadPool &threadPool;
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::chrono::milliseconds coalesceWindow { 0 };
 };
 
 constexpr auto g_databaseTasks = DatabaseTasks::getInstance;
@@ -0,0 +1,146 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Creatures of one kind by id, looked up with one indexed load.
+ *
+ * The low bits of an id, relative to the first id of the range, are its slot
+ * in a power of two table and the high bits act as its generation, so the
+ * slot entry only has to hold the id to tell a live creature from a stale
+ * id. Ids keep increasing as before; the ones whose slot is taken by a
+ * creature still alive are skipped, and the table doubles before it is half
+ * full, which never makes two live ids share a slot. The creatures
+ * themselves are kept contiguous, in no particular order, for iteration.
+ * Only used on the dispatcher.
+ */
+template <typename T>
+class CreatureRegistry {
+public:
+	using Entry = std::pair<uint32_t, std::shared_ptr<T>>;
+
+	CreatureRegistry(uint32_t firstId, uint32_t lastId) :
+		firstId(firstId), lastId(lastId), autoId(firstId) {
+		slots.resize(INITIAL_SLOTS);
+	}
+
+	bool inRange(uint32_t id) const {
+		return id >= firstId && id <= lastId;
+	}
+
+	/**
+	 * @brief Returns the id for a new creature, after the last one given, that doesn't share a slot with a live creature.
+	 */
+	uint32_t nextId() {
+		while (true) {
+			const uint32_t id = autoId;
+			autoId = autoId == lastId ? firstId : autoId + 1;
+			if (slots[slotOf(id)].id == 0) {
+				return id;
+			}
+		}
+	}
+
+	void add(const std::shared_ptr<T> &creature) {
+		const uint32_t id = creature->getID();
+		if (auto &slot = slots[slotOf(id)]; slot.id == id) {
+			entries[slot.index].second = creature;
+			return;
+		}
+
+		if ((entries.size() + 1) * 2 > slots.size()) {
+			grow();
+		}
+
+		auto &slot = slots[slotOf(id)];
+		if (slot.id != 0) {
+			// Only when the id was not given by nextId
+			g_logger().error("[CreatureRegistry::add] - Id {} shares its slot with id {}", id, slot.id);
+			return;
+		}
+
+		slot.id = id;
+		slot.index = static_cast<uint32_t>(entries.size());
+		entries.emplace_back(id, creature);
+	}
+
+	void remove(uint32_t id) {
+		if (!inRange(id)) {
+			return;
+		}
+
+		auto &slot = slots[slotOf(id)];
+		if (slot.id != id) {
+			return;
+		}
+
+		// The last entry takes the place of the removed one
+		const uint32_t index = slot.index;
+		if (index != entries.size() - 1) {
+			entries[index] = std::move(entries.back());
+			slots[slotOf(entries[index].first)].index = index;
+		}
+		entries.pop_back();
+		slot = {};
+	}
+
+	std::shared_ptr<T> find(uint32_t id) const {
+		if (!inRange(id)) {
+			return nullptr;
+		}
+
+		const auto &slot = slots[slotOf(id)];
+		return slot.id == id ? entries[slot.index].second : nullptr;
+	}
+
+	size_t size() const {
+		return entries.size();
+	}
+	bool empty() const {
+		return entries.empty();
+	}
+
+	auto begin() const {
+		return entries.cbegin();
+	}
+	auto end() const {
+		return entries.cend();
+	}
+
+private:
+	static constexpr size_t INITIAL_SLOTS = 1024;
+
+	struct Slot {
+		// 0 while free, no range starts at 0
+		uint32_t id = 0;
+		uint32_t index = 0;
+	};
+
+	size_t slotOf(uint32_t id) const {
+		return (id - firstId) & (slots.size() - 1);
+	}
+
+	void grow() {
+		// Two live ids in different slots differ in the bits of the old mask, so they still differ with the new one
+		std::vector<Slot> previous(slots.size() * 2);
+		std::swap(slots, previous);
+		for (uint32_t index = 0; index < entries.size(); ++index) {
+			auto &slot = slots[slotOf(entries[index].first)];
+			slot.id = entries[index].first;
+			slot.index = index;
+		}
+	}
+
+	uint32_t firstId;
+	uint32_t lastId;
+	uint32_t autoId;
+	std::vector<Slot> slots;
+	std::vector<Entry> entries;
+};
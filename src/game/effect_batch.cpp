@@ -0,0 +1,205 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/effect_batch.hpp"
+#include "creatures/players/player.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/metrics/metrics.hpp"
+#include "map/spectators.hpp"
+#include "server/network/protocol/protocolgame.hpp"
+
+namespace {
+	enum class EffectKind : uint8_t {
+		Magic,
+		Distance,
+		Sound
+	};
+
+	uint64_t packPosition(const Position &pos) {
+		return (static_cast<uint64_t>(pos.x) << 24) | (static_cast<uint64_t>(pos.y) << 8) | pos.z;
+	}
+
+	using FloorBounds = phmap::flat_hash_map<uint8_t, std::pair<Position, Position>>;
+
+	void extendBounds(FloorBounds &floors, uint8_t z, const Position &pos) {
+		auto [it, inserted] = floors.try_emplace(z, pos, pos);
+		if (!inserted) {
+			auto &[minPos, maxPos] = it->second;
+			minPos.x = std::min(minPos.x, pos.x);
+			minPos.y = std::min(minPos.y, pos.y);
+			maxPos.x = std::max(maxPos.x, pos.x);
+			maxPos.y = std::max(maxPos.y, pos.y);
+		}
+	}
+}
+
+bool EffectBatch::isBatching() {
+	return g_dispatcher().context().isGroup(TaskGroup::Serial);
+}
+
+void EffectBatch::addMagicEffect(const Position &pos, uint16_t effect) {
+	if (keys.emplace(packPosition(pos) << 16 | effect, static_cast<uint64_t>(EffectKind::Magic)).second) {
+		magicEffects.emplace_back(MagicEffect { pos, effect });
+	} else {
+		++deduplicated;
+	}
+}
+
+void EffectBatch::removeMagicEffect(const Position &pos, uint16_t effect) {
+	if (keys.erase(Key(packPosition(pos) << 16 | effect, static_cast<uint64_t>(EffectKind::Magic))) != 0) {
+		std::erase_if(magicEffects, [&pos, effect](const MagicEffect &magicEffect) {
+			return magicEffect.effect == effect && magicEffect.pos == pos;
+		});
+	}
+}
+
+void EffectBatch::addDistanceEffect(const Position &fromPos, const Position &toPos, uint16_t effect) {
+	if (keys.emplace(packPosition(fromPos) << 16 | effect, packPosition(toPos) << 8 | static_cast<uint64_t>(EffectKind::Distance)).second) {
+		distanceEffects.emplace_back(DistanceEffect { fromPos, toPos, effect });
+	} else {
+		++deduplicated;
+	}
+}
+
+void EffectBatch::addSoundEffect(const Position &pos, SoundEffect_t mainSoundEffect, SoundEffect_t secondarySoundEffect, const std::shared_ptr<Creature> &actor) {
+	// The source each viewer hears depends on the actor, the same sound from another actor is not the same
+	const uint64_t actorId = actor ? actor->getID() : 0;
+	if (keys.emplace(packPosition(pos) << 16 | mainSoundEffect, actorId << 24 | static_cast<uint64_t>(secondarySoundEffect) << 8 | static_cast<uint64_t>(EffectKind::Sound)).second) {
+		soundEffects.emplace_back(SoundEffect { pos, mainSoundEffect, secondarySoundEffect, actor });
+	} else {
+		++deduplicated;
+	}
+}
+
+SourceEffect_t EffectBatch::getSoundSource(const std::shared_ptr<Creature> &actor, const std::shared_ptr<Player> &spectator) {
+	using enum SourceEffect_t;
+	if (!actor || actor->getNpc()) {
+		return GLOBAL;
+	} else if (actor == spectator) {
+		return OWN;
+	} else if (actor->getPlayer()) {
+		return OTHERS;
+	}
+	return CREATURES;
+}
+
+void EffectBatch::flush() {
+	if (empty()) {
+		return;
+	}
+
+	// Moved out first, anything sent while flushing waits for the next flush
+	const auto magic = std::move(magicEffects);
+	const auto distance = std::move(distanceEffects);
+	const auto sound = std::move(soundEffects);
+	magicEffects.clear();
+	distanceEffects.clear();
+	soundEffects.clear();
+	keys.clear();
+	if (deduplicated != 0) {
+		g_metrics().addCounter("effects_deduplicated", deduplicated);
+		deduplicated = 0;
+	}
+
+	// The message of each effect is serialized once for all its viewers
+	std::vector<BroadcastMessage> magicBroadcasts(magic.size());
+	std::vector<BroadcastMessage> distanceBroadcasts(distance.size());
+
+	const auto sendMagic = [&](const std::shared_ptr<Player> &player, size_t i) {
+		if (player->canSee(magic[i].pos)) {
+			player->sendMagicEffect(magic[i].pos, magic[i].effect, &magicBroadcasts[i]);
+		}
+	};
+	const auto sendDistance = [&](const std::shared_ptr<Player> &player, size_t i) {
+		if (player->canSee(distance[i].fromPos) || player->canSee(distance[i].toPos)) {
+			player->sendDistanceShoot(distance[i].fromPos, distance[i].toPos, distance[i].effect, &distanceBroadcasts[i]);
+		}
+	};
+	const auto sendSound = [&](const std::shared_ptr<Player> &player, size_t i) {
+		const auto &[pos, mainSoundEffect, secondarySoundEffect, actor] = sound[i];
+		if (player->getPosition().z != pos.z || !player->canSee(pos)) {
+			return;
+		}
+
+		const auto source = getSoundSource(actor, player);
+		if (secondarySoundEffect == SoundEffect_t::SILENCE) {
+			player->sendSingleSoundEffect(pos, mainSoundEffect, source);
+		} else {
+			player->sendDoubleSoundEffect(pos, mainSoundEffect, source, secondarySoundEffect, source);
+		}
+	};
+
+	// Bounds of the positions of each floor, a distance effect belongs to the floor it leaves from
+	FloorBounds floors;
+	for (const auto &[pos, effect] : magic) {
+		extendBounds(floors, pos.z, pos);
+	}
+	for (const auto &[fromPos, toPos, effect] : distance) {
+		extendBounds(floors, fromPos.z, fromPos);
+		extendBounds(floors, fromPos.z, toPos);
+	}
+	for (const auto &effect : sound) {
+		extendBounds(floors, effect.pos.z, effect.pos);
+	}
+
+	for (const auto &[z, bounds] : floors) {
+		const auto &[minPos, maxPos] = bounds;
+		// Too far apart, a lookup covering them all would find more than it saves
+		if (maxPos.x - minPos.x > MAP_MAX_VIEW_PORT_X * 2 || maxPos.y - minPos.y > MAP_MAX_VIEW_PORT_Y * 2) {
+			for (size_t i = 0; i < magic.size(); ++i) {
+				if (magic[i].pos.z == z) {
+					for (const auto &spectator : Spectators().find<Player>(magic[i].pos, true)) {
+						sendMagic(spectator->getPlayer(), i);
+					}
+				}
+			}
+			for (size_t i = 0; i < distance.size(); ++i) {
+				if (distance[i].fromPos.z == z) {
+					for (const auto &spectator : Spectators().find<Player>(distance[i].fromPos).find<Player>(distance[i].toPos)) {
+						sendDistance(spectator->getPlayer(), i);
+					}
+				}
+			}
+			for (size_t i = 0; i < sound.size(); ++i) {
+				if (sound[i].pos.z == z) {
+					for (const auto &spectator : Spectators().find<Player>(sound[i].pos)) {
+						sendSound(spectator->getPlayer(), i);
+					}
+				}
+			}
+			continue;
+		}
+
+		const Position center((minPos.x + maxPos.x) / 2, (minPos.y + maxPos.y) / 2, z);
+		for (const auto &spectator : Spectators().find<Player>(center, true, MAP_MAX_VIEW_PORT_X + center.x - minPos.x, MAP_MAX_VIEW_PORT_X + maxPos.x - center.x, MAP_MAX_VIEW_PORT_Y + center.y - minPos.y, MAP_MAX_VIEW_PORT_Y + maxPos.y - center.y)) {
+			const auto &player = spectator->getPlayer();
+			if (!player) {
+				continue;
+			}
+
+			for (size_t i = 0; i < magic.size(); ++i) {
+				if (magic[i].pos.z == z) {
+					sendMagic(player, i);
+				}
+			}
+			for (size_t i = 0; i < distance.size(); ++i) {
+				if (distance[i].fromPos.z == z) {
+					sendDistance(player, i);
+				}
+			}
+			for (size_t i = 0; i < sound.size(); ++i) {
+				if (sound[i].pos.z == z) {
+					sendSound(player, i);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,78 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "creatures/creatures_definitions.hpp"
+#include "game/movement/position.hpp"
+
+class Creature;
+class Player;
+
+/**
+ * Magic, distance and sound effects sent during a dispatcher cycle, kept
+ * until its end instead of sent one by one.
+ *
+ * An area spell puts the same effect on many positions for the same
+ * viewers, and several spells often hit the same positions in one cycle.
+ * The batch drops the repeated effects and, at the end of the cycle, looks
+ * up the viewers of each floor once for all of them; every effect is then
+ * serialized once for all its viewers.
+ */
+class EffectBatch {
+public:
+	/**
+	 * @brief Whether the effects sent now should wait for the end of the cycle.
+	 * Only from serial tasks, the async ones and the code out of the dispatcher send right away.
+	 */
+	static bool isBatching();
+
+	void addMagicEffect(const Position &pos, uint16_t effect);
+	// Before sending the removal, so an effect added and removed in the same cycle is never shown
+	void removeMagicEffect(const Position &pos, uint16_t effect);
+	void addDistanceEffect(const Position &fromPos, const Position &toPos, uint16_t effect);
+	void addSoundEffect(const Position &pos, SoundEffect_t mainSoundEffect, SoundEffect_t secondarySoundEffect, const std::shared_ptr<Creature> &actor);
+
+	bool empty() const {
+		return magicEffects.empty() && distanceEffects.empty() && soundEffects.empty();
+	}
+
+	// Sends and clears everything added so far
+	void flush();
+
+	static SourceEffect_t getSoundSource(const std::shared_ptr<Creature> &actor, const std::shared_ptr<Player> &spectator);
+
+private:
+	struct MagicEffect {
+		Position pos;
+		uint16_t effect;
+	};
+
+	struct DistanceEffect {
+		Position fromPos;
+		Position toPos;
+		uint16_t effect;
+	};
+
+	struct SoundEffect {
+		Position pos;
+		SoundEffect_t mainSoundEffect;
+		SoundEffect_t secondarySoundEffect;
+		std::shared_ptr<Creature> actor;
+	};
+
+	// An effect is the same as another one when its type, positions, ids and actor are
+	using Key = std::pair<uint64_t, uint64_t>;
+
+	std::vector<MagicEffect> magicEffects;
+	std::vector<DistanceEffect> distanceEffects;
+	std::vector<SoundEffect> soundEffects;
+	phmap::flat_hash_set<Key> keys;
+	uint64_t deduplicated = 0;
+};
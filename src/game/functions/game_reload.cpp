@@ -147,7 +147,8 @@ bool GameReload::reloadImbuements() {
 
 bool GameReload::reloadVocations() {
 	const bool result = g_vocations().reload();
-	reloadScripts();
+	// The spells and weapons keep the vocation ids they were registered with
+	reloadAllScripts();
 	logReloadStatus("Vocations", result);
 	return result;
 }
@@ -174,6 +175,18 @@ bool GameReload::reloadGroups() {
 }
 
 bool GameReload::reloadScripts() {
+	const auto &datapackFolder = g_configManager().getString(DATA_DIRECTORY, __FUNCTION__);
+	const auto &coreFolder = g_configManager().getString(CORE_DIRECTORY, __FUNCTION__);
+
+	// Only the changed files run again, everything does when a library changed
+	if (g_scripts().reloadChangedScripts(coreFolder + "/scripts/lib", { datapackFolder + "/scripts", coreFolder + "/scripts" })) {
+		logReloadStatus("Scripts", true);
+		return true;
+	}
+	return reloadAllScripts();
+}
+
+bool GameReload::reloadAllScripts() {
 	g_scripts().clearAllScripts();
 	Zone::clearZones();
 
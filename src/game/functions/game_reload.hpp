@@ -67,6 +67,7 @@ private:
 	static bool reloadCore();
 	static bool reloadGroups();
 	static bool reloadScripts();
+	static bool reloadAllScripts();
 	static bool reloadItems();
 	static bool reloadMonsters();
 	static bool reloadNpcs();
@@ -10,6 +10,7 @@
 #include "pch.hpp"
 
 #include "game/game.hpp"
+#include "game/game_snapshot.hpp"
 
 #include "lua/creature/actions.hpp"
 #include "items/bed.hpp"
@@ -19,17 +20,20 @@
 #include "lua/callbacks/event_callback.hpp"
 #include "lua/callbacks/events_callbacks.hpp"
 #include "creatures/players/highscore_category.hpp"
+#include "creatures/players/offline_player.hpp"
 #include "game/zones/zone.hpp"
 #include "lua/global/globalevent.hpp"
 #include "io/iologindata.hpp"
 #include "io/io_wheel.hpp"
 #include "io/iomarket.hpp"
 #include "items/items.hpp"
+#include "items/itempool.hpp"
 #include "lua/scripts/lua_environment.hpp"
 #include "creatures/monsters/monster.hpp"
 #include "lua/creature/movement.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/save_manager.hpp"
+#include "game/highscores/highscores.hpp"
 #include "server/server.hpp"
 #include "creatures/combat/spells.hpp"
 #include "lua/creature/talkaction.hpp"
@@ -183,7 +187,9 @@ namespace InternalGame {
 	}
 } // Namespace InternalGame
 
-Game::Game() {
+Game::Game() :
+	npcs(Npc::FIRST_ID, Npc::LAST_ID),
+	monsters(Monster::FIRST_ID, Monster::LAST_ID) {
 	offlineTrainingWindow.choices.emplace_back("Sword Fighting and Shielding", SKILL_SWORD);
 	offlineTrainingWindow.choices.emplace_back("Axe Fighting and Shielding", SKILL_AXE);
 	offlineTrainingWindow.choices.emplace_back("Club Fighting and Shielding", SKILL_CLUB);
@@ -198,8 +204,6 @@ Game::Game() {
 	// Create instance of IOWheel to Game class
 	m_IOWheel = std::make_unique<IOWheel>();
 
-	wildcardTree = std::make_shared<WildcardTreeNode>(false);
-
 	m_badges = {
 		Badge(1, CyclopediaBadge_t::ACCOUNT_AGE, "Fledegeling Hero", 1),
 		Badge(2, CyclopediaBadge_t::ACCOUNT_AGE, "Veteran Hero", 5),
@@ -491,6 +495,9 @@ void Game::start(ServiceManager* manager) {
 	manager->add<ProtocolLogin>(static_cast<uint16_t>(g_configManager().getNumber(LOGIN_PORT, __FUNCTION__)));
 	// OT protocols
 	manager->add<ProtocolStatus>(static_cast<uint16_t>(g_configManager().getNumber(STATUS_PORT, __FUNCTION__)));
+	if (const auto adminPort = static_cast<uint16_t>(g_configManager().getNumber(ADMIN_HTTP_PORT, __FUNCTION__)); adminPort != 0) {
+		manager->openAdminHttp(g_configManager().getString(ADMIN_HTTP_ADDRESS, __FUNCTION__), adminPort);
+	}
 
 	serviceManager = manager;
 
@@ -518,8 +525,54 @@ void Game::start(ServiceManager* manager) {
 		EVENT_IMBUEMENT_INTERVAL, [this] { checkImbuements(); }, "Game::checkImbuements"
 	);
 	g_dispatcher().cycleEvent(
-		EVENT_LUA_GARBAGE_COLLECTION, [this] { g_luaEnvironment().collectGarbage(); }, "Calling GC"
+		EVENT_LUA_GARBAGE_COLLECTION, [] {
+			// The incremental steps keep up with the garbage on their own
+			if (g_configManager().getNumber(LUA_GC_STEP_BUDGET, __FUNCTION__) == 0) {
+				g_luaEnvironment().collectGarbage();
+			}
+		},
+		"Calling GC"
+	);
+	g_dispatcher().setCycleEndHandler([this] { effectBatch.flush(); });
+	g_dispatcher().setIdleHandler([](std::chrono::milliseconds slack) {
+		const auto budget = std::chrono::milliseconds(g_configManager().getNumber(LUA_GC_STEP_BUDGET, __FUNCTION__));
+		// Only when the step can not delay the next scheduled task
+		if (budget.count() > 0 && slack > budget * 2) {
+			g_luaEnvironment().stepGarbage(budget, g_configManager().getNumber(LUA_GC_STEP_SIZE, __FUNCTION__));
+		}
+	});
+	g_dispatcher().cycleEvent(
+		EVENT_MAP_TILES_INTERVAL, [this] { map.checkTiles(); }, "MapCache::checkTiles"
+	);
+	g_dispatcher().cycleEvent(
+		EVENT_ITEM_POOL_METRICS_INTERVAL, [] { ItemSlabPool::exportMetrics(); }, "ItemSlabPool::exportMetrics"
+	);
+	g_dispatcher().cycleEvent(
+		EVENT_MEMORY_METRICS_INTERVAL, [this] { exportMemoryMetrics(); }, "Game::exportMemoryMetrics"
 	);
+	if (g_configManager().getNumber(PLAYER_TRAFFIC_METRICS_TOP, __FUNCTION__) > 0) {
+		g_dispatcher().cycleEvent(
+			EVENT_TRAFFIC_METRICS_INTERVAL, [this] { exportTrafficMetrics(); }, "Game::exportTrafficMetrics"
+		);
+	}
+	const auto snapshotInterval = g_configManager().getNumber(GAME_SNAPSHOT_INTERVAL, __FUNCTION__);
+	if (snapshotInterval > 0) {
+		publishSnapshot();
+		g_dispatcher().cycleEvent(
+			std::max<int32_t>(snapshotInterval, SCHEDULER_MINTICKS), [this] { publishSnapshot(); }, "Game::publishSnapshot"
+		);
+	}
+	const auto kvWriteBehindInterval = g_configManager().getNumber(KV_WRITE_BEHIND_INTERVAL, __FUNCTION__);
+	if (kvWriteBehindInterval > 0) {
+		g_dispatcher().cycleEvent(
+			kvWriteBehindInterval, [] { g_saveManager().scheduleKV(); }, "SaveManager::scheduleKV"
+		);
+	}
+	if (g_ioJournal().isOpen() && g_configManager().getNumber(SAVE_JOURNAL_PLAYERS_INTERVAL, __FUNCTION__) > 0) {
+		g_dispatcher().cycleEvent(
+			1000, [] { g_saveManager().journalPlayers(); }, "SaveManager::journalPlayers"
+		);
+	}
 	auto marketItemsPriceIntervalMinutes = g_configManager().getNumber(MARKET_REFRESH_PRICES, __FUNCTION__);
 	if (marketItemsPriceIntervalMinutes > 0) {
 		auto marketItemsPriceIntervalMS = marketItemsPriceIntervalMinutes * 60000;
@@ -646,9 +699,18 @@ void Game::loadItemsPrice() {
 }
 
 void Game::loadMainMap(const std::string &filename) {
+	loadMainMapFile(filename);
+	loadMainMapData();
+}
+
+void Game::loadMainMapFile(const std::string &filename) {
+	map.loadMapFile(g_configManager().getString(DATA_DIRECTORY, __FUNCTION__) + "/world/" + filename + ".otbm", true);
+}
+
+void Game::loadMainMapData() {
 	Monster::despawnRange = g_configManager().getNumber(DEFAULT_DESPAWNRANGE, __FUNCTION__);
 	Monster::despawnRadius = g_configManager().getNumber(DEFAULT_DESPAWNRADIUS, __FUNCTION__);
-	map.loadMap(g_configManager().getString(DATA_DIRECTORY, __FUNCTION__) + "/world/" + filename + ".otbm", true, true, true, true, true);
+	map.loadMapData(true, true, true, true, true);
 }
 
 void Game::loadCustomMaps(const std::filesystem::path &customMapPath) {
@@ -886,9 +948,9 @@ void Game::internalGetPosition(std::shared_ptr<Item> item, Position &pos, uint8_
 std::shared_ptr<Creature> Game::getCreatureByID(uint32_t id) {
 	if (id >= Player::getFirstID() && id <= Player::getLastID()) {
 		return getPlayerByID(id);
-	} else if (id <= Monster::monsterAutoID) {
+	} else if (monsters.inRange(id)) {
 		return getMonsterByID(id);
-	} else if (id <= Npc::npcAutoID) {
+	} else if (npcs.inRange(id)) {
 		return getNpcByID(id);
 	} else {
 		g_logger().warn("Creature with id {} not exists");
@@ -897,27 +959,11 @@ std::shared_ptr<Creature> Game::getCreatureByID(uint32_t id) {
 }
 
 std::shared_ptr<Monster> Game::getMonsterByID(uint32_t id) {
-	if (id == 0) {
-		return nullptr;
-	}
-
-	auto it = monsters.find(id);
-	if (it == monsters.end()) {
-		return nullptr;
-	}
-	return it->second;
+	return monsters.find(id);
 }
 
 std::shared_ptr<Npc> Game::getNpcByID(uint32_t id) {
-	if (id == 0) {
-		return nullptr;
-	}
-
-	auto it = npcs.find(id);
-	if (it == npcs.end()) {
-		return nullptr;
-	}
-	return it->second;
+	return npcs.find(id);
 }
 
 std::shared_ptr<Player> Game::getPlayerByID(uint32_t id, bool allowOffline /* = false */) {
@@ -1006,9 +1052,9 @@ std::shared_ptr<Player> Game::getPlayerByGUID(const uint32_t &guid, bool allowOf
 	if (guid == 0) {
 		return nullptr;
 	}
-	for (const auto &it : players) {
-		if (guid == it.second->getGUID()) {
-			return it.second;
+	if (auto it = mappedPlayerGuids.find(guid); it != mappedPlayerGuids.end()) {
+		if (auto player = it->second.lock()) {
+			return player;
 		}
 	}
 	if (!allowOffline) {
@@ -1046,7 +1092,7 @@ ReturnValue Game::getPlayerByNameWildcard(const std::string &s, std::shared_ptr<
 	if (s.back() == '~') {
 		const std::string &query = asLowerCaseString(s.substr(0, strlen - 1));
 		std::string result;
-		ReturnValue ret = wildcardTree->findOne(query, result);
+		ReturnValue ret = wildcardTree.findOne(query, result);
 		if (ret != RETURNVALUE_NOERROR) {
 			return ret;
 		}
@@ -1086,8 +1132,8 @@ bool Game::internalPlaceCreature(std::shared_ptr<Creature> creature, const Posit
 	if (!tile) {
 		return false;
 	}
-	auto toZones = tile->getZones();
-	if (auto ret = beforeCreatureZoneChange(creature, {}, toZones); ret != RETURNVALUE_NOERROR) {
+	const auto toZones = tile->getZones();
+	if (auto ret = beforeCreatureZoneChange(creature, ZoneSet::empty(), toZones); ret != RETURNVALUE_NOERROR) {
 		return false;
 	}
 
@@ -1103,7 +1149,7 @@ bool Game::internalPlaceCreature(std::shared_ptr<Creature> creature, const Posit
 		addCreatureCheck(creature);
 		creature->onPlacedCreature();
 	}
-	afterCreatureZoneChange(creature, {}, toZones);
+	afterCreatureZoneChange(creature, ZoneSet::empty(), toZones);
 	return true;
 }
 
@@ -1144,7 +1190,7 @@ bool Game::removeCreature(std::shared_ptr<Creature> creature, bool isLogout /* =
 	if (!tile) {
 		g_logger().error("[{}] tile on position '{}' for creature '{}' not exist", __FUNCTION__, creature->getPosition().toString(), creature->getName());
 	}
-	auto fromZones = creature->getZones();
+	const auto fromZones = creature->getZones();
 
 	if (tile) {
 		std::vector<int32_t> oldStackPosVector;
@@ -1181,12 +1227,13 @@ bool Game::removeCreature(std::shared_ptr<Creature> creature, bool isLogout /* =
 	}
 
 	creature->getParent()->postRemoveNotification(creature, nullptr, 0);
-	afterCreatureZoneChange(creature, fromZones, {});
+	afterCreatureZoneChange(creature, fromZones, ZoneSet::empty());
 
 	creature->removeList();
 	creature->setRemoved();
 
 	removeCreatureCheck(creature);
+	g_luaEnvironment().getTimerEvents().stopOwner(creature->getID());
 
 	for (const auto &summon : creature->getSummons()) {
 		summon->setSkillLoss(false);
@@ -1207,7 +1254,7 @@ void Game::executeDeath(uint32_t creatureId) {
 	metrics::method_latency measure(__METHOD_NAME__);
 	std::shared_ptr<Creature> creature = getCreatureByID(creatureId);
 	if (creature && !creature->isRemoved()) {
-		afterCreatureZoneChange(creature, creature->getZones(), {});
+		afterCreatureZoneChange(creature, creature->getZones(), ZoneSet::empty());
 		creature->onDeath();
 	}
 }
@@ -1250,10 +1297,12 @@ void Game::playerInspectItem(std::shared_ptr<Player> player, uint16_t itemId, ui
 FILELOADER_ERRORS Game::loadAppearanceProtobuf(const std::string &file) {
 	using namespace Canary::protobuf::appearances;
 
-	std::fstream fileStream(file, std::ios::in | std::ios::binary);
-	if (!fileStream.is_open()) {
+	// Mapped and parsed in place, without copying the file through a stream
+	std::error_code error;
+	mio::mmap_source source;
+	source.map(file, error);
+	if (error) {
 		g_logger().error("[Game::loadAppearanceProtobuf] - Failed to load {}, file cannot be oppened", file);
-		fileStream.close();
 		return ERROR_NOT_OPEN;
 	}
 
@@ -1261,9 +1310,8 @@ FILELOADER_ERRORS Game::loadAppearanceProtobuf(const std::string &file) {
 	// compatible with the version of the headers we compiled against.
 	GOOGLE_PROTOBUF_VERIFY_VERSION;
 	m_appearancesPtr = std::make_unique<Appearances>();
-	if (!m_appearancesPtr->ParseFromIstream(&fileStream)) {
+	if (source.size() > static_cast<size_t>(std::numeric_limits<int>::max()) || !m_appearancesPtr->ParseFromArray(source.data(), static_cast<int>(source.size()))) {
 		g_logger().error("[Game::loadAppearanceProtobuf] - Failed to parse binary file {}, file is invalid", file);
-		fileStream.close();
 		return ERROR_NOT_OPEN;
 	}
 
@@ -1288,8 +1336,6 @@ FILELOADER_ERRORS Game::loadAppearanceProtobuf(const std::string &file) {
 		}
 	}
 
-	fileStream.close();
-
 	// Disposing allocated objects.
 	google::protobuf::ShutdownProtobufLibrary();
 
@@ -2167,8 +2213,8 @@ ReturnValue Game::internalMoveItem(std::shared_ptr<Cylinder> fromCylinder, std::
 	auto player = actor ? actor->getPlayer() : nullptr;
 	if (player) {
 		// Update containers
-		player->onSendContainer(toContainer);
-		player->onSendContainer(fromContainer);
+		player->scheduleContainerUpdate(toContainer);
+		player->scheduleContainerUpdate(fromContainer);
 	}
 
 	// Actor related actions
@@ -2541,7 +2587,7 @@ std::shared_ptr<Item> Game::findItemOfType(std::shared_ptr<Cylinder> cylinder, u
 
 		if (depthSearch) {
 			std::shared_ptr<Container> container = item->getContainer();
-			if (container) {
+			if (container && container->isHoldingItemWithId(itemId)) {
 				containers.push_back(container);
 			}
 		}
@@ -2555,8 +2601,9 @@ std::shared_ptr<Item> Game::findItemOfType(std::shared_ptr<Cylinder> cylinder, u
 				return item;
 			}
 
+			// Containers holding none of them are skipped
 			std::shared_ptr<Container> subContainer = item->getContainer();
-			if (subContainer) {
+			if (subContainer && subContainer->isHoldingItemWithId(itemId)) {
 				containers.push_back(subContainer);
 			}
 		}
@@ -2867,20 +2914,23 @@ void Game::playerQuickLootCorpse(std::shared_ptr<Player> player, std::shared_ptr
 		return;
 	}
 
+	QuickLootBatch batch;
+	lootCorpseItems(player, corpse, batch);
+	sendQuickLootSummary(player, batch);
+}
+
+void Game::lootCorpseItems(const std::shared_ptr<Player> &player, const std::shared_ptr<Container> &corpse, QuickLootBatch &batch) {
 	std::vector<std::shared_ptr<Item>> itemList;
 	bool ignoreListItems = (player->quickLootFilter == QUICKLOOTFILTER_SKIPPEDLOOT);
 
-	bool missedAnyGold = false;
-	bool missedAnyItem = false;
-
 	for (ContainerIterator it = corpse->iterator(); it.hasNext(); it.advance()) {
 		std::shared_ptr<Item> item = *it;
 		bool listed = player->isQuickLootListedItem(item);
 		if ((listed && ignoreListItems) || (!listed && !ignoreListItems)) {
 			if (item->getWorth() != 0) {
-				missedAnyGold = true;
+				batch.missedAnyGold = true;
 			} else {
-				missedAnyItem = true;
+				batch.missedAnyItem = true;
 			}
 			continue;
 		}
@@ -2888,41 +2938,56 @@ void Game::playerQuickLootCorpse(std::shared_ptr<Player> player, std::shared_ptr
 		itemList.push_back(item);
 	}
 
-	bool shouldNotifyCapacity = false;
-	ObjectCategory_t shouldNotifyNotEnoughRoom = OBJECTCATEGORY_NONE;
-
-	uint32_t totalLootedGold = 0;
-	uint32_t totalLootedItems = 0;
+	const bool infiniteCapacity = player->hasFlag(PlayerFlags_t::HasInfiniteCapacity);
 	for (const std::shared_ptr<Item> &item : itemList) {
 		uint32_t worth = item->getWorth();
 		uint16_t baseCount = item->getItemCount();
 		ObjectCategory_t category = getObjectCategory(item);
 
-		ReturnValue ret = internalCollectManagedItems(player, item, category);
+		// A stack can still be merged or partially moved, the rest would fail the same way as before
+		ReturnValue ret;
+		if (!item->isStackable() && batch.fullCategories.test(category)) {
+			ret = RETURNVALUE_CONTAINERNOTENOUGHROOM;
+		} else if (!item->isStackable() && !infiniteCapacity && item->getWeight() > player->getFreeCapacity()) {
+			ret = RETURNVALUE_NOTENOUGHCAPACITY;
+		} else {
+			ret = internalCollectManagedItems(player, item, category);
+		}
+
 		if (ret == RETURNVALUE_NOTENOUGHCAPACITY) {
-			shouldNotifyCapacity = true;
+			batch.notifyCapacity = true;
 		} else if (ret == RETURNVALUE_CONTAINERNOTENOUGHROOM) {
-			shouldNotifyNotEnoughRoom = category;
+			batch.notifyNotEnoughRoom = category;
+			if (!item->isStackable()) {
+				batch.fullCategories.set(category);
+			}
 		}
 
 		bool success = ret == RETURNVALUE_NOERROR;
 		if (worth != 0) {
-			missedAnyGold = missedAnyGold || !success;
+			batch.missedAnyGold = batch.missedAnyGold || !success;
 			if (success) {
 				player->sendLootStats(item, baseCount);
-				totalLootedGold += worth;
+				batch.lootedGold += worth;
 			} else {
 				// item is not completely moved
-				totalLootedGold += worth - item->getWorth();
+				batch.lootedGold += worth - item->getWorth();
 			}
 		} else {
-			missedAnyItem = missedAnyItem || !success;
+			batch.missedAnyItem = batch.missedAnyItem || !success;
 			if (success || item->getItemCount() != baseCount) {
-				totalLootedItems++;
+				batch.lootedItems++;
 				player->sendLootStats(item, item->getItemCount());
 			}
 		}
 	}
+}
+
+void Game::sendQuickLootSummary(const std::shared_ptr<Player> &player, const QuickLootBatch &batch) {
+	const uint32_t totalLootedGold = batch.lootedGold;
+	const uint32_t totalLootedItems = batch.lootedItems;
+	const bool missedAnyGold = batch.missedAnyGold;
+	const bool missedAnyItem = batch.missedAnyItem;
 
 	std::stringstream ss;
 	if (totalLootedGold != 0 || missedAnyGold || totalLootedItems != 0 || missedAnyItem) {
@@ -2982,12 +3047,12 @@ void Game::playerQuickLootCorpse(std::shared_ptr<Player> player, std::shared_ptr
 	ss << ".";
 	player->sendTextMessage(MESSAGE_STATUS, ss.str());
 
-	if (shouldNotifyCapacity) {
+	if (batch.notifyCapacity) {
 		ss.str(std::string());
 		ss << "Attention! The loot you are trying to pick up is too heavy for you to carry.";
-	} else if (shouldNotifyNotEnoughRoom != OBJECTCATEGORY_NONE) {
+	} else if (batch.notifyNotEnoughRoom != OBJECTCATEGORY_NONE) {
 		ss.str(std::string());
-		ss << "Attention! The container assigned to category " << getObjectCategoryName(shouldNotifyNotEnoughRoom) << " is full.";
+		ss << "Attention! The container assigned to category " << getObjectCategoryName(batch.notifyNotEnoughRoom) << " is full.";
 	} else {
 		return;
 	}
@@ -3142,15 +3207,35 @@ ReturnValue Game::collectRewardChestItems(std::shared_ptr<Player> player, uint32
 
 	auto rewardItemsVector = player->getRewardsFromContainer(rewardChest->getContainer());
 	auto rewardCount = rewardItemsVector.size();
+
+	// Only the rewards that fit in the free capacity are tried, the coins sent to the bank weigh nothing
+	size_t fittingItems = 0;
+	if (player->hasFlag(PlayerFlags_t::HasInfiniteCapacity)) {
+		fittingItems = rewardCount;
+	} else {
+		const bool autoBank = g_configManager().getBoolean(AUTOBANK, __FUNCTION__);
+		uint64_t freeCapacity = player->getFreeCapacity();
+		for (; fittingItems < rewardCount; ++fittingItems) {
+			const auto &item = rewardItemsVector[fittingItems];
+			if (!item || (autoBank && item->getWorth() != 0)) {
+				continue;
+			}
+			if (item->getWeight() > freeCapacity) {
+				break;
+			}
+			freeCapacity -= item->getWeight();
+		}
+	}
+	if (fittingItems < rewardCount) {
+		player->sendCancelMessage(RETURNVALUE_NOTENOUGHCAPACITY);
+		rewardItemsVector.resize(fittingItems);
+	}
+
+	// Server side moves, the inventory of the client is updated once for all of them
+	Player::ItemTransfer transfer(player);
 	uint32_t movedRewardItems = 0;
 	std::string lootedItemsMessage;
 	for (const auto &item : rewardItemsVector) {
-		// Stop if player not have free capacity
-		if (item && player->getCapacity() < item->getWeight()) {
-			player->sendCancelMessage(RETURNVALUE_NOTENOUGHCAPACITY);
-			break;
-		}
-
 		// Limit the collect count if the "maxMoveItems" is not "0"
 		auto limitMove = maxMoveItems != 0 && movedRewardItems == maxMoveItems;
 		if (limitMove) {
@@ -4567,6 +4652,13 @@ void Game::playerWriteItem(uint32_t playerId, uint32_t windowTextId, const std::
 		writeItem->removeAttribute(ItemAttribute_t::DATE);
 	}
 
+	// The text is not a cylinder change, the house is told about it here
+	if (const auto &tile = writeItem->getTile()) {
+		if (const auto &house = tile->getHouse()) {
+			house->markItemsChanged();
+		}
+	}
+
 	uint16_t newId = Item::items[writeItem->getID()].writeOnceItemId;
 	if (newId != 0) {
 		transformItem(writeItem, newId);
@@ -4671,7 +4763,10 @@ void Game::playerStowItem(uint32_t playerId, const Position &pos, uint16_t itemI
 		return;
 	}
 
-	player->stowItem(item, count, allItems);
+	{
+		Player::ItemTransfer transfer(player);
+		player->stowItem(item, count, allItems);
+	}
 
 	// Refresh depot search window if necessary
 	if (player->isDepotSearchOpenOnItem(itemId)) {
@@ -5569,6 +5664,7 @@ void Game::playerLootAllCorpses(std::shared_ptr<Player> player, const Position &
 
 		const TileItemVector* itemVector = tile->getItemList();
 		uint16_t corpses = 0;
+		QuickLootBatch batch;
 		for (auto &tileItem : *itemVector) {
 			if (!tileItem) {
 				continue;
@@ -5588,13 +5684,14 @@ void Game::playerLootAllCorpses(std::shared_ptr<Player> player, const Position &
 			}
 
 			corpses++;
-			playerQuickLootCorpse(player, tileCorpse, tileCorpse->getPosition());
+			lootCorpseItems(player, tileCorpse, batch);
 			if (corpses >= 30) {
 				break;
 			}
 		}
 
 		if (corpses > 0) {
+			sendQuickLootSummary(player, batch);
 			if (corpses > 1) {
 				std::stringstream string;
 				string << "You looted " << corpses << " corpses.";
@@ -6321,10 +6418,11 @@ bool Game::internalCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses
 	}
 
 	// Send to client
+	BroadcastMessage broadcast;
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
 			if (!ghostMode || tmpPlayer->canSeeCreature(creature)) {
-				tmpPlayer->sendCreatureSay(creature, type, text, pos);
+				tmpPlayer->sendCreatureSay(creature, type, text, pos, &broadcast);
 			}
 		}
 	}
@@ -6347,6 +6445,52 @@ void Game::checkCreatureWalk(uint32_t creatureId) {
 	}
 }
 
+uint32_t Game::scheduleCreatureWalk(const std::shared_ptr<Creature> &creature, uint32_t delay) {
+	// Rounded up like the scheduler does, which fires a task on the first tick that is not earlier than its time
+	const int64_t now = OTSYS_TIME();
+	const int64_t slot = (now + delay + SCHEDULER_MINTICKS - 1) / SCHEDULER_MINTICKS;
+	auto &walks = walkSlots[slot];
+	if (walks.empty()) {
+		g_dispatcher().scheduleEvent(
+			static_cast<uint32_t>(std::max<int64_t>(0, slot * SCHEDULER_MINTICKS - now)),
+			[this, slot] { checkCreatureWalks(slot); },
+			"Game::checkCreatureWalk"
+		);
+	}
+
+	if (++lastWalkToken == 0) {
+		++lastWalkToken;
+	}
+	walks.emplace_back(creature, lastWalkToken);
+	return lastWalkToken;
+}
+
+void Game::checkCreatureWalks(int64_t slot) {
+	metrics::method_latency measure(__METHOD_NAME__);
+	auto it = walkSlots.find(slot);
+	if (it == walkSlots.end()) {
+		return;
+	}
+
+	auto walks = std::move(it->second);
+	walkSlots.erase(it);
+
+	// Neighbours step one after another, so the sectors and spectators they touch stay in cache
+	std::ranges::sort(walks, [](const auto &lhs, const auto &rhs) {
+		const auto &lhsPos = lhs.first->getPosition();
+		const auto &rhsPos = rhs.first->getPosition();
+		return std::make_tuple(lhsPos.z, lhsPos.x / SECTOR_SIZE, lhsPos.y / SECTOR_SIZE) < std::make_tuple(rhsPos.z, rhsPos.x / SECTOR_SIZE, rhsPos.y / SECTOR_SIZE);
+	});
+
+	for (const auto &[creature, token] : walks) {
+		// Stopped, or queued again, since it was added
+		if (creature->eventWalk != token || creature->isRemoved() || creature->getHealth() <= 0) {
+			continue;
+		}
+		creature->onCreatureWalk();
+	}
+}
+
 void Game::updateCreatureWalk(uint32_t creatureId) {
 	const auto &creature = getCreatureByID(creatureId);
 	if (creature && creature->getHealth() > 0) {
@@ -6380,21 +6524,73 @@ void Game::removeCreatureCheck(const std::shared_ptr<Creature> &creature) {
 	}
 }
 
+void Game::prepareCreaturesThink(const std::vector<std::shared_ptr<Creature>> &creatures) {
+	metrics::method_latency measure(__METHOD_NAME__);
+	// Each stripe is wider than the largest path search, so partitions of the same wave never touch the same tiles
+	constexpr int32_t THINK_STRIPE_WIDTH = SECTOR_SIZE * 4;
+
+	// Stripes are split into two waves (even and odd), leaving a whole stripe as safety margin between partitions running together
+	std::array<phmap::flat_hash_map<int32_t, std::vector<std::shared_ptr<Creature>>>, 2> waves;
+	for (const auto &creature : creatures) {
+		if (!creature || !creature->creatureCheck || creature->getHealth() <= 0 || !creature->getFollowCreature()) {
+			continue;
+		}
+
+		const int32_t stripe = creature->getPosition().x / THINK_STRIPE_WIDTH;
+		waves[stripe % 2][stripe].emplace_back(creature);
+	}
+
+	for (const auto &wave : waves) {
+		if (wave.empty()) {
+			continue;
+		}
+
+		std::vector<const std::vector<std::shared_ptr<Creature>>*> partitions;
+		partitions.reserve(wave.size());
+		for (const auto &[stripe, partition] : wave) {
+			partitions.emplace_back(&partition);
+		}
+
+		g_dispatcher().asyncWaitGroup(partitions.size(), [&partitions](size_t i) {
+			for (const auto &creature : *partitions[i]) {
+				creature->prepareFollowPath(EVENT_CREATURE_THINK_INTERVAL);
+			}
+		});
+	}
+}
+
 void Game::checkCreatures() {
 	metrics::method_latency measure(__METHOD_NAME__);
 	static size_t index = 0;
 
 	auto &checkCreatureList = checkCreatureLists[index];
+	if (g_configManager().getBoolean(PARALLEL_CREATURE_THINK, __FUNCTION__)) {
+		prepareCreaturesThink(checkCreatureList);
+	}
+
+	// Slowed down further while the dispatcher is over its latency target, nobody is near them
+	const uint32_t idleFactor = g_dispatcher().getTickGovernor().isActive(TickGovernor::Degradation::IdleThink) ? 2 : 1;
+	const std::array<uint32_t, 3> thinkIntervals = {
+		static_cast<uint32_t>(EVENT_CREATURE_THINK_INTERVAL),
+		idleFactor * static_cast<uint32_t>(std::max<int32_t>(EVENT_CREATURE_THINK_INTERVAL, g_configManager().getNumber(MONSTER_IDLE_THINK_INTERVAL, __FUNCTION__))),
+		idleFactor * static_cast<uint32_t>(std::max<int32_t>(EVENT_CREATURE_THINK_INTERVAL, g_configManager().getNumber(MONSTER_UNSEEN_THINK_INTERVAL, __FUNCTION__))),
+	};
+
 	size_t it = 0, end = checkCreatureList.size();
 	while (it < end) {
 		auto creature = checkCreatureList[it];
 		if (creature && creature->creatureCheck) {
 			if (creature->getHealth() > 0) {
-				creature->onThink(EVENT_CREATURE_THINK_INTERVAL);
-				creature->onAttacking(EVENT_CREATURE_THINK_INTERVAL);
+				// Lower tiers gather the checks they skip into the interval of their next think
+				creature->pendingThinkInterval += EVENT_CREATURE_THINK_INTERVAL;
+				if (creature->pendingThinkInterval >= thinkIntervals[static_cast<uint8_t>(creature->getThinkTier())]) {
+					const uint32_t interval = std::exchange(creature->pendingThinkInterval, 0);
+					creature->onThink(interval);
+					creature->onAttacking(interval);
+				}
 				creature->executeConditions(EVENT_CREATURE_THINK_INTERVAL);
 			} else {
-				afterCreatureZoneChange(creature, creature->getZones(), {});
+				afterCreatureZoneChange(creature, creature->getZones(), ZoneSet::empty());
 				creature->onDeath();
 			}
 			++it;
@@ -6497,47 +6693,41 @@ void Game::reloadCreature(std::shared_ptr<Creature> creature) {
 }
 
 void Game::sendSingleSoundEffect(const Position &pos, SoundEffect_t soundId, std::shared_ptr<Creature> actor /* = nullptr*/) {
-	if (soundId == SoundEffect_t::SILENCE) {
+	// Only cosmetic, the first thing dropped while the dispatcher is over its latency target
+	if (soundId == SoundEffect_t::SILENCE || g_dispatcher().getTickGovernor().isActive(TickGovernor::Degradation::CosmeticEffects)) {
 		return;
 	}
 
-	using enum SourceEffect_t;
-	for (const auto &spectator : Spectators().find<Player>(pos)) {
-		SourceEffect_t source = CREATURES;
-		if (!actor || actor->getNpc()) {
-			source = GLOBAL;
-		} else if (actor == spectator) {
-			source = OWN;
-		} else if (actor->getPlayer()) {
-			source = OTHERS;
-		}
+	if (EffectBatch::isBatching()) {
+		effectBatch.addSoundEffect(pos, soundId, SoundEffect_t::SILENCE, actor);
+		return;
+	}
 
-		spectator->getPlayer()->sendSingleSoundEffect(pos, soundId, source);
+	for (const auto &spectator : Spectators().find<Player>(pos)) {
+		const auto &player = spectator->getPlayer();
+		player->sendSingleSoundEffect(pos, soundId, EffectBatch::getSoundSource(actor, player));
 	}
 }
 
 void Game::sendDoubleSoundEffect(const Position &pos, SoundEffect_t mainSoundEffect, SoundEffect_t secondarySoundEffect, std::shared_ptr<Creature> actor /* = nullptr*/) {
-	if (secondarySoundEffect == SoundEffect_t::SILENCE) {
+	if (secondarySoundEffect == SoundEffect_t::SILENCE || g_dispatcher().getTickGovernor().isActive(TickGovernor::Degradation::CosmeticEffects)) {
 		sendSingleSoundEffect(pos, mainSoundEffect, actor);
 		return;
 	}
 
-	using enum SourceEffect_t;
-	for (const auto &spectator : Spectators().find<Player>(pos)) {
-		SourceEffect_t source = CREATURES;
-		if (!actor || actor->getNpc()) {
-			source = GLOBAL;
-		} else if (actor == spectator) {
-			source = OWN;
-		} else if (actor->getPlayer()) {
-			source = OTHERS;
-		}
+	if (EffectBatch::isBatching()) {
+		effectBatch.addSoundEffect(pos, mainSoundEffect, secondarySoundEffect, actor);
+		return;
+	}
 
-		spectator->getPlayer()->sendDoubleSoundEffect(pos, mainSoundEffect, source, secondarySoundEffect, source);
+	for (const auto &spectator : Spectators().find<Player>(pos)) {
+		const auto &player = spectator->getPlayer();
+		const auto source = EffectBatch::getSoundSource(actor, player);
+		player->sendDoubleSoundEffect(pos, mainSoundEffect, source, secondarySoundEffect, source);
 	}
 }
 
-bool Game::combatBlockHit(CombatDamage &damage, std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, bool checkDefense, bool checkArmor, bool field) {
+bool Game::combatBlockHit(CombatDamage &damage, const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, bool checkDefense, bool checkArmor, bool field) {
 	if (damage.primary.type == COMBAT_NONE && damage.secondary.type == COMBAT_NONE) {
 		return true;
 	}
@@ -6725,7 +6915,7 @@ bool Game::combatBlockHit(CombatDamage &damage, std::shared_ptr<Creature> attack
 	return (primaryBlockType != BLOCK_NONE) && (secondaryBlockType != BLOCK_NONE);
 }
 
-void Game::combatGetTypeInfo(CombatType_t combatType, std::shared_ptr<Creature> target, TextColor_t &color, uint16_t &effect) {
+void Game::combatGetTypeInfo(CombatType_t combatType, const std::shared_ptr<Creature> &target, TextColor_t &color, uint16_t &effect) {
 	switch (combatType) {
 		case COMBAT_PHYSICALDAMAGE: {
 			std::shared_ptr<Item> splash = nullptr;
@@ -6924,7 +7114,7 @@ void Game::applyWheelOfDestinyHealing(CombatDamage &damage, std::shared_ptr<Play
 			combatChangeHealth(attackerPlayer, attackerPlayer, tmpDamage);
 		}
 
-		if (attackerPlayer->wheel()->getInstant("Blessing of the Grove")) {
+		if (attackerPlayer->wheel()->getStage(WheelStage_t::BLESSING_OF_THE_GROVE)) {
 			damage.primary.value += (damage.primary.value * attackerPlayer->wheel()->checkBlessingGroveHealingByTarget(target)) / 100.;
 		}
 	}
@@ -6975,7 +7165,7 @@ int32_t Game::applyHealthChange(CombatDamage &damage, std::shared_ptr<Creature>
 
 	// Wheel of destiny (Gift of Life)
 	if (std::shared_ptr<Player> targetPlayer = target->getPlayer()) {
-		if (targetPlayer->wheel()->getInstant("Gift of Life") && targetPlayer->wheel()->getGiftOfCooldown() == 0 && (damage.primary.value + damage.secondary.value) >= targetHealth) {
+		if (targetPlayer->wheel()->getStage(WheelStage_t::GIFT_OF_LIFE) && targetPlayer->wheel()->getGiftOfCooldown() == 0 && (damage.primary.value + damage.secondary.value) >= targetHealth) {
 			int32_t overkillMultiplier = (damage.primary.value + damage.secondary.value) - targetHealth;
 			overkillMultiplier = (overkillMultiplier * 100) / targetPlayer->getMaxHealth();
 			if (overkillMultiplier <= targetPlayer->wheel()->getGiftOfLifeValue()) {
@@ -6987,7 +7177,7 @@ int32_t Game::applyHealthChange(CombatDamage &damage, std::shared_ptr<Creature>
 	return targetHealth;
 }
 
-bool Game::combatChangeHealth(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, CombatDamage &damage, bool isEvent /*= false*/) {
+bool Game::combatChangeHealth(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, CombatDamage &damage, bool isEvent /*= false*/) {
 	using namespace std;
 	const Position &targetPos = target->getPosition();
 	if (damage.primary.value > 0) {
@@ -7047,7 +7237,7 @@ bool Game::combatChangeHealth(std::shared_ptr<Creature> attacker, std::shared_pt
 			message.primary.value = realHealthChange;
 			message.primary.color = TEXTCOLOR_PASTELRED;
 
-			for (const auto &spectator : Spectators().find<Player>(targetPos)) {
+			for (const auto &spectator : getCombatSpectators(targetPos, false)) {
 				const auto &tmpPlayer = spectator->getPlayer();
 				if (!tmpPlayer) {
 					continue;
@@ -7179,7 +7369,7 @@ bool Game::combatChangeHealth(std::shared_ptr<Creature> attacker, std::shared_pt
 			return true;
 		}
 
-		auto spectators = Spectators().find<Player>(targetPos, true);
+		auto spectators = getCombatSpectators(targetPos, true);
 
 		if (targetPlayer && attackerMonster) {
 			handleHazardSystemAttack(damage, targetPlayer, attackerMonster, false);
@@ -7374,11 +7564,10 @@ bool Game::combatChangeHealth(std::shared_ptr<Creature> attacker, std::shared_pt
 
 			if (targetMonster->israndomStepping()) {
 				targetMonster->setIgnoreFieldDamage(true);
-				targetMonster->updateMapCache();
 			}
 		}
 
-		if (spectators.empty()) {
+		if (spectators.empty() && !areaCombatScope) {
 			spectators.find<Player>(targetPos, true);
 		}
 
@@ -7409,6 +7598,46 @@ bool Game::combatChangeHealth(std::shared_ptr<Creature> attacker, std::shared_pt
 	return true;
 }
 
+Game::AreaCombatScope::AreaCombatScope(const CreatureVector &spectators, const Position &centerPos, int32_t rangeX, int32_t rangeY) :
+	spectators(spectators), centerPos(centerPos), rangeX(rangeX), rangeY(rangeY), previous(g_game().areaCombatScope) {
+	g_game().areaCombatScope = this;
+}
+
+Game::AreaCombatScope::~AreaCombatScope() {
+	g_game().areaCombatScope = previous;
+
+	std::ranges::stable_sort(effects, {}, &std::pair<uint16_t, Position>::first);
+	std::vector<Position> positions;
+	for (auto it = effects.begin(); it != effects.end();) {
+		const uint16_t effect = it->first;
+		positions.clear();
+		for (; it != effects.end() && it->first == effect; ++it) {
+			positions.emplace_back(it->second);
+		}
+		g_game().addMagicEffects(positions, effect);
+	}
+}
+
+Spectators Game::getCombatSpectators(const Position &targetPos, bool multifloor) {
+	// Callbacks of the area may hit creatures elsewhere, the area players only cover its own floor and bounds
+	const auto scope = areaCombatScope;
+	if (!scope || targetPos.z != scope->centerPos.z || Position::getDistanceX(targetPos, scope->centerPos) + MAP_MAX_VIEW_PORT_X > scope->rangeX || Position::getDistanceY(targetPos, scope->centerPos) + MAP_MAX_VIEW_PORT_Y > scope->rangeY) {
+		return Spectators().find<Player>(targetPos, multifloor);
+	}
+
+	CreatureVector players;
+	for (const auto &spectator : scope->spectators) {
+		const auto &spectatorPos = spectator->getPosition();
+		if ((multifloor || spectatorPos.z == targetPos.z) && Creature::canSee(spectatorPos, targetPos, MAP_MAX_VIEW_PORT_X, MAP_MAX_VIEW_PORT_Y)) {
+			players.emplace_back(spectator);
+		}
+	}
+
+	Spectators spectators;
+	spectators.insertAll(players);
+	return spectators;
+}
+
 void Game::updatePlayerPartyHuntAnalyzer(const CombatDamage &damage, std::shared_ptr<Player> player) const {
 	if (!player) {
 		return;
@@ -7567,19 +7796,27 @@ void Game::sendEffects(
 	std::shared_ptr<Creature> target, const CombatDamage &damage, const Position &targetPos, TextMessage &message,
 	const CreatureVector &spectators
 ) {
+	const auto sendEffect = [&](uint16_t hitEffect) {
+		if (hitEffect == CONST_ME_NONE) {
+			return;
+		}
+
+		if (areaCombatScope) {
+			areaCombatScope->effects.emplace_back(hitEffect, targetPos);
+		} else {
+			addMagicEffect(spectators, targetPos, hitEffect);
+		}
+	};
+
 	uint16_t hitEffect;
 	if (message.primary.value) {
 		combatGetTypeInfo(damage.primary.type, target, message.primary.color, hitEffect);
-		if (hitEffect != CONST_ME_NONE) {
-			addMagicEffect(spectators, targetPos, hitEffect);
-		}
+		sendEffect(hitEffect);
 	}
 
 	if (message.secondary.value) {
 		combatGetTypeInfo(damage.secondary.type, target, message.secondary.color, hitEffect);
-		if (hitEffect != CONST_ME_NONE) {
-			addMagicEffect(spectators, targetPos, hitEffect);
-		}
+		sendEffect(hitEffect);
 	}
 }
 
@@ -7669,7 +7906,7 @@ int32_t Game::calculateLeechAmount(const int32_t &realDamage, const uint16_t &sk
 	return std::clamp<int32_t>(static_cast<int32_t>(std::lround(intermediateResult)), 0, realDamage);
 }
 
-bool Game::combatChangeMana(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, CombatDamage &damage) {
+bool Game::combatChangeMana(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, CombatDamage &damage) {
 	const Position &targetPos = target->getPosition();
 	auto manaChange = damage.primary.value + damage.secondary.value;
 	if (manaChange > 0) {
@@ -7886,9 +8123,10 @@ void Game::addCreatureHealth(const CreatureVector &spectators, std::shared_ptr<C
 			}
 		}
 	}
+	BroadcastMessage broadcast;
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendCreatureHealth(target);
+			tmpPlayer->sendCreatureHealth(target, &broadcast);
 		}
 	}
 }
@@ -7911,19 +8149,36 @@ void Game::addPlayerVocation(std::shared_ptr<Player> target) {
 }
 
 void Game::addMagicEffect(const Position &pos, uint16_t effect) {
+	if (EffectBatch::isBatching()) {
+		effectBatch.addMagicEffect(pos, effect);
+		return;
+	}
+
 	auto spectators = Spectators().find<Player>(pos, true);
 	addMagicEffect(spectators.data(), pos, effect);
 }
 
 void Game::addMagicEffect(const CreatureVector &spectators, const Position &pos, uint16_t effect) {
+	BroadcastMessage broadcast;
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendMagicEffect(pos, effect);
+			tmpPlayer->sendMagicEffect(pos, effect, &broadcast);
 		}
 	}
 }
 
+void Game::addMagicEffects(const std::vector<Position> &positions, uint16_t effect) {
+	// Out of a serial task the positions are still sent together, from a batch of their own
+	EffectBatch localBatch;
+	auto &batch = EffectBatch::isBatching() ? effectBatch : localBatch;
+	for (const auto &pos : positions) {
+		batch.addMagicEffect(pos, effect);
+	}
+	localBatch.flush();
+}
+
 void Game::removeMagicEffect(const Position &pos, uint16_t effect) {
+	effectBatch.removeMagicEffect(pos, effect);
 	auto spectators = Spectators().find<Player>(pos, true);
 	removeMagicEffect(spectators.data(), pos, effect);
 }
@@ -7937,25 +8192,185 @@ void Game::removeMagicEffect(const CreatureVector &spectators, const Position &p
 }
 
 void Game::addDistanceEffect(const Position &fromPos, const Position &toPos, uint16_t effect) {
+	if (EffectBatch::isBatching()) {
+		effectBatch.addDistanceEffect(fromPos, toPos, effect);
+		return;
+	}
+
 	auto spectators = Spectators().find<Player>(fromPos).find<Player>(toPos);
 	addDistanceEffect(spectators.data(), fromPos, toPos, effect);
 }
 
 void Game::addDistanceEffect(const CreatureVector &spectators, const Position &fromPos, const Position &toPos, uint16_t effect) {
+	BroadcastMessage broadcast;
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect);
+			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect, &broadcast);
 		}
 	}
 }
 
-void Game::checkImbuements() {
-	for (const auto &[mapPlayerId, mapPlayer] : getPlayers()) {
-		if (!mapPlayer) {
+std::vector<MemoryAccounting::Usage> Game::getMemoryUsage() const {
+	std::vector<MemoryAccounting::Usage> usage;
+	for (uint8_t category = 0; category < static_cast<uint8_t>(MemoryCategory::Last); ++category) {
+		usage.emplace_back(MemoryAccounting::getUsage(static_cast<MemoryCategory>(category)));
+	}
+	usage.emplace_back(g_kv().getCacheUsage());
+
+	lua_State* L = g_luaEnvironment().getLuaState();
+	if (L) {
+		const int64_t luaBytes = static_cast<int64_t>(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+		usage.push_back({ "lua heap", 0, luaBytes });
+	}
+	return usage;
+}
+
+std::string Game::getMemoryReport() const {
+	const auto toMegabytes = [](int64_t bytes) {
+		return static_cast<double>(bytes) / (1024.0 * 1024.0);
+	};
+
+	const auto usage = getMemoryUsage();
+	// Containers are items too, they are left out of the total
+	int64_t totalBytes = -usage[static_cast<uint8_t>(MemoryCategory::Containers)].bytes;
+	std::string categories;
+	for (const auto &[name, objects, bytes] : usage) {
+		totalBytes += bytes;
+		categories += fmt::format("\n{} - {}, {:.2f} MB", name, objects, toMegabytes(bytes));
+	}
+
+	return fmt::format(
+		"Resident memory: {:.2f} MB\nAccounted: {:.2f} MB, not counting what the objects own on the heap\n\nCategory - objects, MB:{}",
+		toMegabytes(MemoryAccounting::getResidentBytes()), toMegabytes(totalBytes), categories
+	);
+}
+
+void Game::exportMemoryMetrics() {
+	for (const auto &[name, objects, bytes] : getMemoryUsage()) {
+		auto &[exportedObjects, exportedKilobytes] = exportedMemoryUsage[name];
+		const std::map<std::string, std::string> attrs = { { "category", std::string(name) } };
+		if (objects != exportedObjects) {
+			g_metrics().addUpDownCounter("memory_objects", static_cast<int>(objects - exportedObjects), attrs);
+			exportedObjects = objects;
+		}
+		const auto kilobytes = bytes / 1024;
+		if (kilobytes != exportedKilobytes) {
+			g_metrics().addUpDownCounter("memory_kilobytes", static_cast<int>(kilobytes - exportedKilobytes), attrs);
+			exportedKilobytes = kilobytes;
+		}
+	}
+}
+
+std::string Game::getTrafficReport(const std::string &playerName, size_t limit) {
+	if (!playerName.empty()) {
+		const auto &player = getPlayerByName(playerName);
+		if (!player || !player->client) {
+			return fmt::format("Player {} is not online.", playerName);
+		}
+		return fmt::format("{}\n{}", player->getName(), player->client->getTrafficReport());
+	}
+
+	std::vector<std::pair<std::shared_ptr<Player>, int64_t>> sorted;
+	for (const auto &[playerId, player] : players) {
+		if (player->client) {
+			sorted.emplace_back(player, player->client->getDispatcherTimeNs());
+		}
+	}
+	std::ranges::sort(sorted, [](const auto &a, const auto &b) {
+		return a.second > b.second;
+	});
+
+	std::string report = "Players by dispatcher time (ms, packets in, KB in, KB out, KB saved by compression):";
+	for (size_t i = 0; i < sorted.size() && (limit == 0 || i < limit); ++i) {
+		const auto &[player, dispatcherTimeNs] = sorted[i];
+		const auto stats = player->client->getTrafficStats();
+		report += fmt::format(
+			"\n{} - {:.2f}, {}, {:.1f}, {:.1f}, {:.1f}",
+			player->getName(), static_cast<double>(dispatcherTimeNs) / 1000000.0, stats.packetsReceived,
+			static_cast<double>(stats.bytesReceived) / 1024.0, static_cast<double>(stats.bytesSent) / 1024.0, static_cast<double>(stats.compressionSaved) / 1024.0
+		);
+	}
+	return sorted.empty() ? "No player online." : report;
+}
+
+void Game::exportTrafficMetrics() {
+	// Only the players who took the most dispatcher time since the last export, the others would flood the series
+	struct Delta {
+		std::shared_ptr<Player> player;
+		PlayerTraffic traffic;
+	};
+
+	std::vector<Delta> deltas;
+	phmap::flat_hash_map<uint32_t, PlayerTraffic> current;
+	for (const auto &[playerId, player] : players) {
+		if (!player->client) {
 			continue;
 		}
 
-		mapPlayer->updateInventoryImbuement();
+		PlayerTraffic traffic { player->client, player->client->getTrafficStats(), player->client->getDispatcherTimeNs() };
+		const auto it = exportedTraffic.find(playerId);
+		const auto previous = it != exportedTraffic.end() && it->second.client.lock() == player->client ? it->second : PlayerTraffic {};
+		deltas.push_back({ player, {
+			{},
+			{
+				traffic.stats.bytesReceived - previous.stats.bytesReceived,
+				traffic.stats.bytesSent - previous.stats.bytesSent,
+				traffic.stats.packetsReceived - previous.stats.packetsReceived,
+				traffic.stats.packetsSent - previous.stats.packetsSent,
+				traffic.stats.compressionSaved - previous.stats.compressionSaved,
+			},
+			traffic.dispatcherTimeNs - previous.dispatcherTimeNs,
+		} });
+		current.emplace(playerId, traffic);
+	}
+	// The players who logged out are dropped
+	exportedTraffic = std::move(current);
+
+	const auto top = std::min(deltas.size(), static_cast<size_t>(g_configManager().getNumber(PLAYER_TRAFFIC_METRICS_TOP, __FUNCTION__)));
+	std::ranges::partial_sort(deltas, deltas.begin() + top, [](const auto &a, const auto &b) {
+		return a.traffic.dispatcherTimeNs > b.traffic.dispatcherTimeNs;
+	});
+	for (size_t i = 0; i < top; ++i) {
+		const auto &[player, traffic] = deltas[i];
+		const std::map<std::string, std::string> attrs = { { "player", player->getName() } };
+		g_metrics().addCounter("player_dispatcher_time_us", static_cast<double>(traffic.dispatcherTimeNs) / 1000.0, attrs);
+		g_metrics().addCounter("player_packets_received", static_cast<double>(traffic.stats.packetsReceived), attrs);
+		g_metrics().addCounter("player_bytes_received", static_cast<double>(traffic.stats.bytesReceived), attrs);
+		g_metrics().addCounter("player_bytes_sent", static_cast<double>(traffic.stats.bytesSent), attrs);
+		g_metrics().addCounter("player_compression_saved_bytes", static_cast<double>(traffic.stats.compressionSaved), attrs);
+	}
+}
+
+void Game::publishSnapshot() {
+	std::shared_ptr<GameSnapshot> next;
+	if (spareSnapshot && spareSnapshot.use_count() == 1) {
+		// Pairs with the release of the last reader dropping it
+		std::atomic_thread_fence(std::memory_order_acquire);
+		next = std::move(spareSnapshot);
+	} else {
+		next = std::make_shared<GameSnapshot>();
+	}
+	next->capture();
+
+	auto previous = snapshot.exchange(next, std::memory_order_acq_rel);
+	// Readers only ever see it const, it is refilled once they have all dropped it
+	spareSnapshot = std::const_pointer_cast<GameSnapshot>(previous);
+}
+
+void Game::addImbuedPlayer(const std::shared_ptr<Player> &player) {
+	if (player && !player->isRemoved()) {
+		imbuedPlayers.emplace(player->getID());
+	}
+}
+
+void Game::checkImbuements() {
+	for (auto it = imbuedPlayers.begin(); it != imbuedPlayers.end();) {
+		const auto &player = getPlayerByID(*it);
+		if (!player || !player->updateInventoryImbuement()) {
+			imbuedPlayers.erase(it++);
+			continue;
+		}
+		++it;
 	}
 }
 
@@ -8002,15 +8417,14 @@ void Game::checkLight() {
 
 	LightInfo lightInfo = getWorldLightInfo();
 
-	if (lightChange) {
-		for ([[maybe_unused]] const auto &[mapPlayerId, mapPlayer] : getPlayers()) {
-			mapPlayer->sendWorldLight(lightInfo);
-			mapPlayer->sendTibiaTime(lightHour);
-		}
-	} else {
-		for ([[maybe_unused]] const auto &[mapPlayerId, mapPlayer] : getPlayers()) {
-			mapPlayer->sendTibiaTime(lightHour);
+	// Built once per client protocol and copied to every player
+	BroadcastMessage lightBroadcast;
+	BroadcastMessage timeBroadcast;
+	for ([[maybe_unused]] const auto &[mapPlayerId, mapPlayer] : getPlayers()) {
+		if (lightChange) {
+			mapPlayer->sendWorldLight(lightInfo, &lightBroadcast);
 		}
+		mapPlayer->sendTibiaTime(lightHour, &timeBroadcast);
 	}
 	if (currentLightState != lightState) {
 		currentLightState = lightState;
@@ -8059,6 +8473,8 @@ void Game::shutdown() {
 }
 
 void Game::addBestiaryList(uint16_t raceid, std::string name) {
+	// Also on a reload of a known type, its class or unlock counts may have changed
+	g_iobestiary().invalidateBestiaryIndex();
 	auto it = BestiaryList.find(raceid);
 	if (it != BestiaryList.end()) {
 		return;
@@ -8372,6 +8788,10 @@ void Game::playerCyclopediaCharacterInfo(std::shared_ptr<Player> player, uint32_
 		return;
 	}
 
+	if (player->sendCachedCyclopediaCharacterInfo(characterInfoType)) {
+		return;
+	}
+
 	switch (characterInfoType) {
 		case CYCLOPEDIA_CHARACTERINFO_BASEINFORMATION:
 			player->sendCyclopediaCharacterBaseInformation();
@@ -8573,6 +8993,19 @@ void Game::playerHighscores(std::shared_ptr<Player> player, HighscoreType_t type
 
 	std::string categoryName = getSkillNameById(category);
 
+	if (g_configManager().getBoolean(HIGHSCORES_IN_MEMORY, __FUNCTION__) && g_highscores().hasCategory(category)) {
+		std::vector<HighscoreCharacter> characters;
+		uint16_t pages = 0;
+		const uint32_t ourRankGuid = type == HIGHSCORE_OURRANK ? player->getGUID() : 0;
+		if (!g_highscores().getPage(category, vocation, page, entriesPerPage, pages, ourRankGuid, characters)) {
+			player->sendHighscoresNoData();
+			return;
+		}
+
+		player->sendHighscores(characters, category, vocation, page, pages, getTimeNow());
+		return;
+	}
+
 	std::string query;
 	if (type == HIGHSCORE_GETENTRIES) {
 		query = generateHighscoreOrGetCachedQueryForEntries(categoryName, page, entriesPerPage, vocation);
@@ -8977,7 +9410,7 @@ void Game::playerCreateMarketOffer(uint32_t playerId, uint8_t type, uint16_t ite
 		return;
 	}
 
-	IOMarket::createOffer(player->getGUID(), static_cast<MarketAction_t>(type), it.id, amount, price, tier, anonymous);
+	IOMarket::createOffer(player->getGUID(), player->getName(), static_cast<MarketAction_t>(type), it.id, amount, price, tier, anonymous);
 
 	const MarketOfferList &buyOffers = IOMarket::getActiveOffers(MARKETACTION_BUY, it.id, tier);
 	const MarketOfferList &sellOffers = IOMarket::getActiveOffers(MARKETACTION_SELL, it.id, tier);
@@ -9116,18 +9549,21 @@ void Game::playerAcceptMarketOffer(uint32_t playerId, uint32_t timestamp, uint16
 			return;
 		}
 
-		std::shared_ptr<Player> buyerPlayer = getPlayerByGUID(offer.playerId, true);
-		if (!buyerPlayer) {
+		// An offline buyer is only read for its account, the items go straight to its stored inbox
+		std::shared_ptr<Player> buyerPlayer = getPlayerByGUID(offer.playerId);
+		auto offlineBuyer = buyerPlayer ? std::nullopt : OfflinePlayer::load(offer.playerId);
+		if (!buyerPlayer && !offlineBuyer) {
 			offerStatus << "Failed to load buyer player " << player->getName();
 			return;
 		}
 
-		if (!buyerPlayer->getAccount()) {
+		const auto &buyerAccount = buyerPlayer ? buyerPlayer->getAccount() : offlineBuyer->getAccount();
+		if (!buyerAccount) {
 			player->sendTextMessage(MESSAGE_MARKET, "Cannot accept offer.");
 			return;
 		}
 
-		if (player == buyerPlayer || player->getAccount() == buyerPlayer->getAccount()) {
+		if (player == buyerPlayer || player->getAccountId() == buyerAccount->getID()) {
 			player->sendTextMessage(MESSAGE_MARKET, "You cannot accept your own offer.");
 			return;
 		}
@@ -9174,57 +9610,59 @@ void Game::playerAcceptMarketOffer(uint32_t playerId, uint32_t timestamp, uint16
 		g_metrics().addCounter("balance_increase", totalPrice, { { "player", player->getName() }, { "context", "market_sale" } });
 
 		if (it.id == ITEM_STORE_COIN) {
-			buyerPlayer->getAccount()->addCoins(enumToValue(CoinType::Transferable), amount, "Purchased on Market");
-		} else if (it.stackable) {
-			uint16_t tmpAmount = amount;
-			while (tmpAmount > 0) {
-				uint16_t stackCount = std::min<uint16_t>(it.stackSize, tmpAmount);
-				std::shared_ptr<Item> item = Item::CreateItem(it.id, stackCount);
-				if (internalAddItem(buyerPlayer->getInbox(), item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
-					offerStatus << "Failed to add player inbox stackable item for buy offer for player " << player->getName();
+			buyerAccount->addCoins(enumToValue(CoinType::Transferable), amount, "Purchased on Market");
+		} else {
+			std::vector<std::shared_ptr<Item>> boughtItems;
+			if (it.stackable) {
+				uint16_t tmpAmount = amount;
+				while (tmpAmount > 0) {
+					uint16_t stackCount = std::min<uint16_t>(it.stackSize, tmpAmount);
+					boughtItems.emplace_back(Item::CreateItem(it.id, stackCount));
+					tmpAmount -= stackCount;
+				}
+			} else {
+				int32_t subType;
+				if (it.charges != 0) {
+					subType = it.charges;
+				} else {
+					subType = -1;
+				}
 
-					break;
+				for (uint16_t i = 0; i < amount; ++i) {
+					boughtItems.emplace_back(Item::CreateItem(it.id, subType));
 				}
+			}
 
+			for (const auto &item : boughtItems) {
 				if (offer.tier > 0) {
 					item->setAttribute(ItemAttribute_t::TIER, offer.tier);
 				}
-
-				tmpAmount -= stackCount;
-			}
-		} else {
-			int32_t subType;
-			if (it.charges != 0) {
-				subType = it.charges;
-			} else {
-				subType = -1;
 			}
 
-			for (uint16_t i = 0; i < amount; ++i) {
-				std::shared_ptr<Item> item = Item::CreateItem(it.id, subType);
-				if (internalAddItem(buyerPlayer->getInbox(), item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
-					offerStatus << "Failed to add player inbox item for buy offer for player " << player->getName();
-
-					break;
+			if (!buyerPlayer) {
+				if (!offlineBuyer->appendInboxItems(boughtItems)) {
+					offerStatus << "Failed to add offline player inbox items for buy offer for player " << player->getName();
 				}
-
-				if (offer.tier > 0) {
-					item->setAttribute(ItemAttribute_t::TIER, offer.tier);
+			} else {
+				for (const auto &item : boughtItems) {
+					if (internalAddItem(buyerPlayer->getInbox(), item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
+						offerStatus << "Failed to add player inbox item for buy offer for player " << player->getName();
+						break;
+					}
 				}
 			}
 		}
-
-		if (buyerPlayer->isOffline()) {
-			g_saveManager().savePlayer(buyerPlayer);
-		}
 	} else if (offer.type == MARKETACTION_SELL) {
-		std::shared_ptr<Player> sellerPlayer = getPlayerByGUID(offer.playerId, true);
-		if (!sellerPlayer) {
+		// An offline seller is only credited, straight in the database
+		std::shared_ptr<Player> sellerPlayer = getPlayerByGUID(offer.playerId);
+		auto offlineSeller = sellerPlayer ? std::nullopt : OfflinePlayer::load(offer.playerId);
+		if (!sellerPlayer && !offlineSeller) {
 			offerStatus << "Failed to load seller player";
 			return;
 		}
 
-		if (player == sellerPlayer || player->getAccount() == sellerPlayer->getAccount()) {
+		const uint32_t sellerAccountId = sellerPlayer ? sellerPlayer->getAccountId() : offlineSeller->getAccountId();
+		if (player == sellerPlayer || player->getAccountId() == sellerAccountId) {
 			player->sendTextMessage(MESSAGE_MARKET, "You cannot accept your own offer.");
 			return;
 		}
@@ -9296,21 +9734,23 @@ void Game::playerAcceptMarketOffer(uint32_t playerId, uint32_t timestamp, uint16
 			}
 		}
 
-		sellerPlayer->setBankBalance(sellerPlayer->getBankBalance() + totalPrice);
-		g_metrics().addCounter("balance_increase", totalPrice, { { "player", sellerPlayer->getName() }, { "context", "market_sale" } });
+		if (sellerPlayer) {
+			sellerPlayer->setBankBalance(sellerPlayer->getBankBalance() + totalPrice);
+		} else {
+			offlineSeller->increaseBankBalance(totalPrice);
+		}
+		g_metrics().addCounter("balance_increase", totalPrice, { { "player", sellerPlayer ? sellerPlayer->getName() : offlineSeller->getName() }, { "context", "market_sale" } });
 		if (it.id == ITEM_STORE_COIN) {
 			const auto &tranferable = enumToValue(CoinType::Transferable);
 			const auto &removeCoin = enumToValue(CoinTransactionType::Remove);
-			sellerPlayer->getAccount()->registerCoinTransaction(removeCoin, tranferable, amount, "Sold on Market");
+			if (const auto &sellerAccount = sellerPlayer ? sellerPlayer->getAccount() : offlineSeller->getAccount()) {
+				sellerAccount->registerCoinTransaction(removeCoin, tranferable, amount, "Sold on Market");
+			}
 		}
 
 		if (it.id != ITEM_STORE_COIN) {
 			player->onReceiveMail();
 		}
-
-		if (sellerPlayer->isOffline()) {
-			g_saveManager().savePlayer(sellerPlayer);
-		}
 	}
 
 	// Send market window again for update item stats and avoid item clone
@@ -9825,31 +10265,38 @@ void Game::updatePlayerSaleItems(uint32_t playerId) {
 void Game::addPlayer(std::shared_ptr<Player> player) {
 	const std::string &lowercase_name = asLowerCaseString(player->getName());
 	mappedPlayerNames[lowercase_name] = player;
-	wildcardTree->insert(lowercase_name);
+	mappedPlayerGuids[player->getGUID()] = player;
+	wildcardTree.insert(lowercase_name);
 	players[player->getID()] = player;
 }
 
 void Game::removePlayer(std::shared_ptr<Player> player) {
 	const std::string &lowercase_name = asLowerCaseString(player->getName());
 	mappedPlayerNames.erase(lowercase_name);
-	wildcardTree->remove(lowercase_name);
+	mappedPlayerGuids.erase(player->getGUID());
+	wildcardTree.remove(lowercase_name);
 	players.erase(player->getID());
 }
 
 void Game::addNpc(std::shared_ptr<Npc> npc) {
-	npcs[npc->getID()] = npc;
+	npcs.add(npc);
 }
 
 void Game::removeNpc(std::shared_ptr<Npc> npc) {
-	npcs.erase(npc->getID());
+	npcs.remove(npc->getID());
 }
 
 void Game::addMonster(std::shared_ptr<Monster> monster) {
-	monsters[monster->getID()] = monster;
+	monsters.add(monster);
+	// Whether it can be forged right now is checked when it is picked, the rest never changes
+	if (monster->isForgeCreature() && monster->getRaceId() > 0 && !monster->isRewardBoss()) {
+		forgeableMonsters.insert(monster->getID());
+	}
 }
 
 void Game::removeMonster(std::shared_ptr<Monster> monster) {
-	monsters.erase(monster->getID());
+	monsters.remove(monster->getID());
+	forgeableMonsters.erase(monster->getID());
 }
 
 std::shared_ptr<Guild> Game::getGuild(uint32_t id, bool allowOffline /* = flase */) const {
@@ -10014,40 +10461,7 @@ uint32_t Game::makeInfluencedMonster() {
 		return 0;
 	}
 
-	if (forgeableMonsters.empty()) {
-		return 0;
-	}
-
-	auto maxTries = forgeableMonsters.size();
-	uint16_t tries = 0;
-	std::shared_ptr<Monster> monster = nullptr;
-	while (true) {
-		if (tries == maxTries) {
-			return 0;
-		}
-
-		tries++;
-
-		auto random = static_cast<uint32_t>(normal_random(0, static_cast<int32_t>(forgeableMonsters.size() - 1)));
-		auto monsterId = forgeableMonsters.at(random);
-		monster = getMonsterByID(monsterId);
-		if (monster == nullptr) {
-			continue;
-		}
-
-		// Avoiding replace forgeable monster with another
-		if (monster->getForgeStack() == 0) {
-			auto it = std::ranges::find(forgeableMonsters.begin(), forgeableMonsters.end(), monsterId);
-			if (it == forgeableMonsters.end()) {
-				monster = nullptr;
-				continue;
-			}
-			forgeableMonsters.erase(it);
-			break;
-		}
-	}
-
-	if (monster && monster->canBeForgeMonster()) {
+	if (const auto &monster = pickForgeableMonster()) {
 		monster->setMonsterForgeClassification(ForgeClassifications_t::FORGE_INFLUENCED_MONSTER);
 		monster->configureForgeSystem();
 		influencedMonsters.insert(monster->getID());
@@ -10059,19 +10473,6 @@ uint32_t Game::makeInfluencedMonster() {
 
 uint32_t Game::makeFiendishMonster(uint32_t forgeableMonsterId /* = 0*/, bool createForgeableMonsters /* = false*/) {
 	if (createForgeableMonsters) {
-		forgeableMonsters.clear();
-		// If the forgeable monsters haven't been created
-		// Then we'll create them so they don't return in the next if (forgeableMonsters.empty())
-		for (auto [monsterId, monster] : monsters) {
-			auto monsterTile = monster->getTile();
-			if (!monster || !monsterTile) {
-				continue;
-			}
-
-			if (monster->canBeForgeMonster() && !monsterTile->hasFlag(TILESTATE_NOLOGOUT)) {
-				forgeableMonsters.push_back(monster->getID());
-			}
-		}
 		for (const auto monsterId : getFiendishMonsters()) {
 			// If the fiendish is no longer on the map, we remove it from the vector
 			auto monster = getMonsterByID(monsterId);
@@ -10095,36 +10496,9 @@ uint32_t Game::makeFiendishMonster(uint32_t forgeableMonsterId /* = 0*/, bool cr
 		return 0;
 	}
 
-	auto maxTries = forgeableMonsters.size();
-	uint16_t tries = 0;
-	std::shared_ptr<Monster> monster = nullptr;
-	while (true) {
-		if (tries == maxTries) {
-			return 0;
-		}
-
-		tries++;
-
-		auto random = static_cast<uint32_t>(uniform_random(0, static_cast<int32_t>(forgeableMonsters.size() - 1)));
-		uint32_t fiendishMonsterId = forgeableMonsterId;
-		if (fiendishMonsterId == 0) {
-			fiendishMonsterId = forgeableMonsters.at(random);
-		}
-		monster = getMonsterByID(fiendishMonsterId);
-		if (monster == nullptr) {
-			continue;
-		}
-
-		// Avoiding replace forgeable monster with another
-		if (monster->getForgeStack() == 0) {
-			auto it = std::find(forgeableMonsters.begin(), forgeableMonsters.end(), fiendishMonsterId);
-			if (it == forgeableMonsters.end()) {
-				monster = nullptr;
-				continue;
-			}
-			forgeableMonsters.erase(it);
-			break;
-		}
+	const auto monster = pickForgeableMonster(forgeableMonsterId);
+	if (!monster) {
+		return 0;
 	}
 
 	// Get interval time to fiendish
@@ -10153,22 +10527,18 @@ uint32_t Game::makeFiendishMonster(uint32_t forgeableMonsterId /* = 0*/, bool cr
 		finalTime = static_cast<uint32_t>(saveIntervalConfigTime * intervalTime);
 	}
 
-	if (monster && monster->canBeForgeMonster()) {
-		monster->setMonsterForgeClassification(ForgeClassifications_t::FORGE_FIENDISH_MONSTER);
-		monster->configureForgeSystem();
-		monster->setTimeToChangeFiendish(timeToChangeFiendish + getTimeNow());
-		fiendishMonsters.insert(monster->getID());
-
-		auto schedulerTask = createPlayerTask(
-			finalTime,
-			[this, monster] { updateFiendishMonsterStatus(monster->getID(), monster->getName()); },
-			__FUNCTION__
-		);
-		forgeMonsterEventIds[monster->getID()] = g_dispatcher().scheduleEvent(schedulerTask);
-		return monster->getID();
-	}
+	monster->setMonsterForgeClassification(ForgeClassifications_t::FORGE_FIENDISH_MONSTER);
+	monster->configureForgeSystem();
+	monster->setTimeToChangeFiendish(timeToChangeFiendish + getTimeNow());
+	fiendishMonsters.insert(monster->getID());
 
-	return 0;
+	auto schedulerTask = createPlayerTask(
+		finalTime,
+		[this, monster] { updateFiendishMonsterStatus(monster->getID(), monster->getName()); },
+		__FUNCTION__
+	);
+	forgeMonsterEventIds[monster->getID()] = g_dispatcher().scheduleEvent(schedulerTask);
+	return monster->getID();
 }
 
 void Game::updateFiendishMonsterStatus(uint32_t monsterId, const std::string &monsterName) {
@@ -10229,19 +10599,28 @@ bool Game::removeFiendishMonster(uint32_t id, bool create /* = true*/) {
 	return false;
 }
 
-void Game::updateForgeableMonsters() {
-	forgeableMonsters.clear();
-	for (auto [monsterId, monster] : monsters) {
-		auto monsterTile = monster->getTile();
-		if (!monsterTile) {
-			continue;
-		}
+std::shared_ptr<Monster> Game::pickForgeableMonster(uint32_t monsterId /* = 0*/) {
+	const auto isForgeable = [](const std::shared_ptr<Monster> &monster) {
+		const auto &tile = monster ? monster->getTile() : nullptr;
+		return tile && monster->canBeForgeMonster() && !tile->hasFlag(TILESTATE_NOLOGOUT);
+	};
 
-		if (monster->canBeForgeMonster() && !monsterTile->hasFlag(TILESTATE_NOLOGOUT)) {
-			forgeableMonsters.push_back(monster->getID());
+	if (monsterId != 0) {
+		const auto &monster = forgeableMonsters.contains(monsterId) ? getMonsterByID(monsterId) : nullptr;
+		return isForgeable(monster) ? monster : nullptr;
+	}
+
+	// The index holds every candidate, the ones forged already or standing where they can't be are skipped
+	for (size_t tries = forgeableMonsters.size(); tries > 0; --tries) {
+		const auto random = static_cast<size_t>(uniform_random(0, static_cast<int32_t>(forgeableMonsters.size() - 1)));
+		if (const auto &monster = getMonsterByID(forgeableMonsters.at(random)); isForgeable(monster)) {
+			return monster;
 		}
 	}
+	return nullptr;
+}
 
+void Game::updateForgeableMonsters() {
 	for (const auto monsterId : getFiendishMonsters()) {
 		if (!getMonsterByID(monsterId)) {
 			removeFiendishMonster(monsterId);
@@ -10522,34 +10901,21 @@ void Game::setTransferPlayerHouseItems(uint32_t houseId, uint32_t playerId) {
 	transferHouseItemsToPlayer[houseId] = playerId;
 }
 
-template <typename T>
-std::vector<T> setDifference(const std::unordered_set<T> &setA, const std::unordered_set<T> &setB) {
-	std::vector<T> setResult;
-	setResult.reserve(setA.size());
-
-	for (const auto &elem : setA) {
-		if (!setB.contains(elem)) {
-			setResult.emplace_back(elem);
-		}
-	}
-
-	return setResult;
-}
-
-ReturnValue Game::beforeCreatureZoneChange(std::shared_ptr<Creature> creature, const std::unordered_set<std::shared_ptr<Zone>> &fromZones, const std::unordered_set<std::shared_ptr<Zone>> &toZones, bool force /* = false*/) const {
+ReturnValue Game::beforeCreatureZoneChange(std::shared_ptr<Creature> creature, const ZoneSet::Ptr &fromZones, const ZoneSet::Ptr &toZones, bool force /* = false*/) const {
 	if (!creature) {
 		return RETURNVALUE_NOTPOSSIBLE;
 	}
 
-	// fromZones - toZones = zones that creature left
-	const auto &zonesLeaving = setDifference(fromZones, toZones);
-	// toZones - fromZones = zones that creature entered
-	const auto &zonesEntering = setDifference(toZones, fromZones);
-
-	if (zonesLeaving.empty() && zonesEntering.empty()) {
+	// The sets are interned, most steps stay in the same zones
+	if (fromZones == toZones) {
 		return RETURNVALUE_NOERROR;
 	}
 
+	// fromZones - toZones = zones that creature left
+	const auto &zonesLeaving = ZoneSet::difference(*fromZones, *toZones);
+	// toZones - fromZones = zones that creature entered
+	const auto &zonesEntering = ZoneSet::difference(*toZones, *fromZones);
+
 	for (const auto &zone : zonesLeaving) {
 		bool allowed = g_callbacks().checkCallback(EventCallback_t::zoneBeforeCreatureLeave, &EventCallback::zoneBeforeCreatureLeave, zone, creature);
 		if (!force && !allowed) {
@@ -10566,15 +10932,15 @@ ReturnValue Game::beforeCreatureZoneChange(std::shared_ptr<Creature> creature, c
 	return RETURNVALUE_NOERROR;
 }
 
-void Game::afterCreatureZoneChange(std::shared_ptr<Creature> creature, const std::unordered_set<std::shared_ptr<Zone>> &fromZones, const std::unordered_set<std::shared_ptr<Zone>> &toZones) const {
-	if (!creature) {
+void Game::afterCreatureZoneChange(std::shared_ptr<Creature> creature, const ZoneSet::Ptr &fromZones, const ZoneSet::Ptr &toZones) const {
+	if (!creature || fromZones == toZones) {
 		return;
 	}
 
 	// fromZones - toZones = zones that creature left
-	const auto &zonesLeaving = setDifference(fromZones, toZones);
+	const auto &zonesLeaving = ZoneSet::difference(*fromZones, *toZones);
 	// toZones - fromZones = zones that creature entered
-	const auto &zonesEntering = setDifference(toZones, fromZones);
+	const auto &zonesEntering = ZoneSet::difference(*toZones, *fromZones);
 
 	for (const auto &zone : zonesLeaving) {
 		zone->creatureRemoved(creature);
@@ -10654,64 +11020,58 @@ void Game::logCyclopediaStats() {
 	g_logger().info("Loaded {} titles from Title System", m_titles.size());
 }
 
-std::unordered_set<Badge> Game::getBadges() {
+const std::unordered_set<Badge> &Game::getBadges() const {
 	return m_badges;
 }
 
-Badge Game::getBadgeById(uint8_t id) {
+const Badge &Game::getBadgeById(uint8_t id) const {
+	static const Badge none;
 	if (id == 0) {
-		return {};
+		return none;
 	}
-	auto it = std::find_if(m_badges.begin(), m_badges.end(), [id](const Badge &b) {
-		return b.m_id == id;
-	});
-	if (it != m_badges.end()) {
-		return *it;
-	}
-	return {};
+	// Badges hash and compare by id only
+	Badge key;
+	key.m_id = id;
+	auto it = m_badges.find(key);
+	return it != m_badges.end() ? *it : none;
 }
 
-Badge Game::getBadgeByName(const std::string &name) {
+const Badge &Game::getBadgeByName(const std::string &name) const {
+	static const Badge none;
 	if (name.empty()) {
-		return {};
+		return none;
 	}
-	auto it = std::find_if(m_badges.begin(), m_badges.end(), [name](const Badge &b) {
+	auto it = std::find_if(m_badges.begin(), m_badges.end(), [&name](const Badge &b) {
 		return b.m_name == name;
 	});
-	if (it != m_badges.end()) {
-		return *it;
-	}
-	return {};
+	return it != m_badges.end() ? *it : none;
 }
 
-std::unordered_set<Title> Game::getTitles() {
+const std::unordered_set<Title> &Game::getTitles() const {
 	return m_titles;
 }
 
-Title Game::getTitleById(uint8_t id) {
+const Title &Game::getTitleById(uint8_t id) const {
+	static const Title none;
 	if (id == 0) {
-		return {};
-	}
-	auto it = std::find_if(m_titles.begin(), m_titles.end(), [id](const Title &t) {
-		return t.m_id == id;
-	});
-	if (it != m_titles.end()) {
-		return *it;
+		return none;
 	}
-	return {};
+	// Titles hash and compare by id only
+	Title key;
+	key.m_id = id;
+	auto it = m_titles.find(key);
+	return it != m_titles.end() ? *it : none;
 }
 
-Title Game::getTitleByName(const std::string &name) {
+const Title &Game::getTitleByName(const std::string &name) const {
+	static const Title none;
 	if (name.empty()) {
-		return {};
+		return none;
 	}
-	auto it = std::find_if(m_titles.begin(), m_titles.end(), [name](const Title &t) {
+	auto it = std::find_if(m_titles.begin(), m_titles.end(), [&name](const Title &t) {
 		return t.m_maleName == name;
 	});
-	if (it != m_titles.end()) {
-		return *it;
-	}
-	return {};
+	return it != m_titles.end() ? *it : none;
 }
 
 const std::string &Game::getSummaryKeyByType(uint8_t type) {
@@ -25,6 +25,9 @@
 #include "items/items_classification.hpp"
 #include "modal_window/modal_window.hpp"
 #include "enums/object_category.hpp"
+#include "game/creature_registry.hpp"
+#include "game/effect_batch.hpp"
+#include "utils/indexed_set.hpp"
 
 // Forward declaration for protobuf class
 namespace Canary {
@@ -47,6 +50,7 @@ class ItemClassification;
 class Guild;
 class Mounts;
 class Spectators;
+class GameSnapshot;
 
 struct Achievement;
 struct HighscoreCategory;
@@ -56,8 +60,6 @@ struct Title;
 static constexpr uint16_t SERVER_BEAT = 0x32;
 static constexpr int32_t EVENT_MS = 10000;
 static constexpr int32_t EVENT_LIGHTINTERVAL_MS = 10000;
-static constexpr int32_t EVENT_DECAYINTERVAL = 250;
-static constexpr int32_t EVENT_DECAY_BUCKETS = 4;
 static constexpr int32_t EVENT_FORGEABLEMONSTERCHECKINTERVAL = 300000;
 static constexpr int32_t EVENT_LUA_GARBAGE_COLLECTION = 60000 * 10; // 10min
 
@@ -107,6 +109,9 @@ public:
 	 * \returns true if the custom map was loaded successfully
 	 */
 	void loadMainMap(const std::string &filename);
+	// The two halves of loadMainMap, the file only needs the items and can load next to the scripts
+	void loadMainMapFile(const std::string &filename);
+	void loadMainMapData();
 	/**
 	 * Load the custom map
 	 * \param filename Is the map custom name (Example: "map".otbm, not is necessary add extension .otbm)
@@ -463,14 +468,21 @@ public:
 
 	// Events
 	void checkCreatureWalk(uint32_t creatureId);
+	/**
+	 * @brief Queues the next step of the creature in the walk batch of its scheduler tick.
+	 * @return The token to keep in the creature eventWalk, the step is skipped once it no longer matches.
+	 */
+	uint32_t scheduleCreatureWalk(const std::shared_ptr<Creature> &creature, uint32_t delay);
+	void checkCreatureWalks(int64_t slot);
 	void updateCreatureWalk(uint32_t creatureId);
 	void checkCreatureAttack(uint32_t creatureId);
 	void checkCreatures();
+	void prepareCreaturesThink(const std::vector<std::shared_ptr<Creature>> &creatures);
 	void checkLight();
 
-	bool combatBlockHit(CombatDamage &damage, std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, bool checkDefense, bool checkArmor, bool field);
+	bool combatBlockHit(CombatDamage &damage, const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, bool checkDefense, bool checkArmor, bool field);
 
-	void combatGetTypeInfo(CombatType_t combatType, std::shared_ptr<Creature> target, TextColor_t &color, uint16_t &effect);
+	void combatGetTypeInfo(CombatType_t combatType, const std::shared_ptr<Creature> &target, TextColor_t &color, uint16_t &effect);
 
 	// Hazard combat helpers
 	void handleHazardSystemAttack(CombatDamage &damage, std::shared_ptr<Player> player, const std::shared_ptr<Monster> monster, bool isPlayerAttacker);
@@ -485,7 +497,32 @@ public:
 	void applyWheelOfDestinyEffectsToDamage(CombatDamage &damage, std::shared_ptr<Player> attackerPlayer, std::shared_ptr<Creature> target) const;
 	int32_t applyHealthChange(CombatDamage &damage, std::shared_ptr<Creature> target) const;
 
-	bool combatChangeHealth(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, CombatDamage &damage, bool isEvent = false);
+	bool combatChangeHealth(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, CombatDamage &damage, bool isEvent = false);
+
+	/**
+	 * While alive, the health changes of an area combat take their spectators from the
+	 * players already found around the whole area, and their hit effects are sent
+	 * together once the area is done.
+	 */
+	class AreaCombatScope {
+	public:
+		AreaCombatScope(const CreatureVector &spectators, const Position &centerPos, int32_t rangeX, int32_t rangeY);
+		~AreaCombatScope();
+
+		AreaCombatScope(const AreaCombatScope &) = delete;
+		AreaCombatScope &operator=(const AreaCombatScope &) = delete;
+
+	private:
+		friend class Game;
+
+		const CreatureVector &spectators;
+		const Position centerPos;
+		const int32_t rangeX;
+		const int32_t rangeY;
+		std::vector<std::pair<uint16_t, Position>> effects;
+		AreaCombatScope* previous;
+	};
+
 	void applyCharmRune(std::shared_ptr<Monster> targetMonster, std::shared_ptr<Player> attackerPlayer, std::shared_ptr<Creature> target, const int32_t &realDamage) const;
 	void applyManaLeech(
 		std::shared_ptr<Player> attackerPlayer, std::shared_ptr<Monster> targetMonster,
@@ -496,16 +533,19 @@ public:
 		std::shared_ptr<Creature> target, const CombatDamage &damage, const int32_t &realDamage
 	) const;
 	int32_t calculateLeechAmount(const int32_t &realDamage, const uint16_t &skillAmount, int targetsAffected) const;
-	bool combatChangeMana(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, CombatDamage &damage);
+	bool combatChangeMana(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, CombatDamage &damage);
 
 	// Animation help functions
 	void addCreatureHealth(const std::shared_ptr<Creature> target);
 	static void addCreatureHealth(const CreatureVector &spectators, const std::shared_ptr<Creature> target);
 	void addPlayerMana(const std::shared_ptr<Player> target);
 	void addPlayerVocation(const std::shared_ptr<Player> target);
+	// The effects sent from a serial task wait for the end of the dispatcher cycle, see EffectBatch
 	void addMagicEffect(const Position &pos, uint16_t effect);
 	static void addMagicEffect(const std::vector<std::shared_ptr<Player>> &players, const Position &pos, uint16_t effect);
 	static void addMagicEffect(const CreatureVector &spectators, const Position &pos, uint16_t effect);
+	// Same effect on many positions, with one spectators lookup per floor instead of one per position
+	void addMagicEffects(const std::vector<Position> &positions, uint16_t effect);
 	void removeMagicEffect(const Position &pos, uint16_t effect);
 	static void removeMagicEffect(const CreatureVector &spectators, const Position &pos, uint16_t effect);
 	void addDistanceEffect(const Position &fromPos, const Position &toPos, uint16_t effect);
@@ -517,6 +557,28 @@ public:
 
 	void loadItemsPrice();
 
+	/**
+	 * @brief Live objects and bytes of the tracked classes, the KV cache and the Lua heap.
+	 * Reads the Lua state, so only on the dispatcher thread.
+	 */
+	std::vector<MemoryAccounting::Usage> getMemoryUsage() const;
+	std::string getMemoryReport() const;
+	void exportMemoryMetrics();
+
+	/**
+	 * @brief Network traffic and dispatcher time of one player, or of the players who took the most dispatcher time.
+	 */
+	std::string getTrafficReport(const std::string &playerName, size_t limit);
+	void exportTrafficMetrics();
+
+	/**
+	 * @brief Last world state copy published for other threads, null when gameSnapshotInterval is 0.
+	 */
+	std::shared_ptr<const GameSnapshot> getSnapshot() const {
+		return snapshot.load(std::memory_order_acquire);
+	}
+	void publishSnapshot();
+
 	void loadMotdNum();
 	void saveMotdNum() const;
 	const std::string &getMotdHash() const {
@@ -540,10 +602,10 @@ public:
 	const phmap::parallel_flat_hash_map<uint32_t, std::shared_ptr<Player>> &getPlayers() const {
 		return players;
 	}
-	const std::map<uint32_t, std::shared_ptr<Monster>> &getMonsters() const {
+	const CreatureRegistry<Monster> &getMonsters() const {
 		return monsters;
 	}
-	const std::map<uint32_t, std::shared_ptr<Npc>> &getNpcs() const {
+	const CreatureRegistry<Npc> &getNpcs() const {
 		return npcs;
 	}
 
@@ -553,12 +615,20 @@ public:
 
 	void addPlayer(std::shared_ptr<Player> player);
 	void removePlayer(std::shared_ptr<Player> player);
+	// Decays the imbuements of the player every EVENT_IMBUEMENT_INTERVAL, until none of them can decay
+	void addImbuedPlayer(const std::shared_ptr<Player> &player);
 
 	void addNpc(std::shared_ptr<Npc> npc);
 	void removeNpc(std::shared_ptr<Npc> npc);
+	uint32_t getNextNpcId() {
+		return npcs.nextId();
+	}
 
 	void addMonster(std::shared_ptr<Monster> npc);
 	void removeMonster(std::shared_ptr<Monster> npc);
+	uint32_t getNextMonsterId() {
+		return monsters.nextId();
+	}
 
 	std::shared_ptr<Guild> getGuild(uint32_t id, bool allowOffline = false) const;
 	std::shared_ptr<Guild> getGuildByName(const std::string &name, bool allowOffline = false) const;
@@ -588,7 +658,7 @@ public:
 	Raids raids;
 	std::unique_ptr<Canary::protobuf::appearances::Appearances> m_appearancesPtr;
 
-	auto getTilesToClean() const {
+	const auto &getTilesToClean() const {
 		return tilesToClean;
 	}
 	void addTileToClean(std::shared_ptr<Tile> tile) {
@@ -646,6 +716,10 @@ public:
 	void createInfluencedMonsters();
 	void updateForgeableMonsters();
 	void checkForgeEventId(uint32_t monsterId);
+	/**
+	 * @brief Picks a random monster that can be forged now, or checks the given one.
+	 */
+	std::shared_ptr<Monster> pickForgeableMonster(uint32_t monsterId = 0);
 	uint32_t makeFiendishMonster(uint32_t forgeableMonsterId = 0, bool createForgeableMonsters = false);
 	uint32_t makeInfluencedMonster();
 
@@ -704,8 +778,8 @@ public:
 	 */
 	bool tryRetrieveStashItems(std::shared_ptr<Player> player, std::shared_ptr<Item> item);
 
-	ReturnValue beforeCreatureZoneChange(std::shared_ptr<Creature> creature, const std::unordered_set<std::shared_ptr<Zone>> &fromZones, const std::unordered_set<std::shared_ptr<Zone>> &toZones, bool force = false) const;
-	void afterCreatureZoneChange(std::shared_ptr<Creature> creature, const std::unordered_set<std::shared_ptr<Zone>> &fromZones, const std::unordered_set<std::shared_ptr<Zone>> &toZones) const;
+	ReturnValue beforeCreatureZoneChange(std::shared_ptr<Creature> creature, const ZoneSet::Ptr &fromZones, const ZoneSet::Ptr &toZones, bool force = false) const;
+	void afterCreatureZoneChange(std::shared_ptr<Creature> creature, const ZoneSet::Ptr &fromZones, const ZoneSet::Ptr &toZones) const;
 
 	std::unique_ptr<IOWheel> &getIOWheel();
 	const std::unique_ptr<IOWheel> &getIOWheel() const;
@@ -724,13 +798,13 @@ public:
 	std::vector<Achievement> getPublicAchievements();
 	std::map<uint16_t, Achievement> getAchievements();
 
-	std::unordered_set<Badge> getBadges();
-	Badge getBadgeById(uint8_t id);
-	Badge getBadgeByName(const std::string &name);
+	const std::unordered_set<Badge> &getBadges() const;
+	const Badge &getBadgeById(uint8_t id) const;
+	const Badge &getBadgeByName(const std::string &name) const;
 
-	std::unordered_set<Title> getTitles();
-	Title getTitleById(uint8_t id);
-	Title getTitleByName(const std::string &name);
+	const std::unordered_set<Title> &getTitles() const;
+	const Title &getTitleById(uint8_t id) const;
+	const Title &getTitleByName(const std::string &name) const;
 
 	const std::string &getSummaryKeyByType(uint8_t type);
 
@@ -787,6 +861,26 @@ private:
 	 */
 	std::shared_ptr<Container> findNextAvailableContainer(ContainerIterator &containerIterator, std::shared_ptr<Container> &lastSubContainer, std::shared_ptr<Container> &lootContainer);
 
+	/**
+	 * @brief State of one quick loot request, shared by all the corpses it loots.
+	 *
+	 * Remembers the categories whose containers ran out of room, so the next
+	 * items of those categories don't walk the whole container chain again,
+	 * and sums what was looted into a single message.
+	 */
+	struct QuickLootBatch {
+		std::bitset<OBJECTCATEGORY_LAST + 1> fullCategories;
+		uint32_t lootedGold = 0;
+		uint32_t lootedItems = 0;
+		bool missedAnyGold = false;
+		bool missedAnyItem = false;
+		bool notifyCapacity = false;
+		ObjectCategory_t notifyNotEnoughRoom = OBJECTCATEGORY_NONE;
+	};
+
+	void lootCorpseItems(const std::shared_ptr<Player> &player, const std::shared_ptr<Container> &corpse, QuickLootBatch &batch);
+	void sendQuickLootSummary(const std::shared_ptr<Player> &player, const QuickLootBatch &batch);
+
 	/**
 	 * @brief Handles the fallback logic for loot containers.
 	 *
@@ -842,9 +936,14 @@ private:
 	phmap::flat_hash_map<std::string, QueryHighscoreCacheEntry> queryCache;
 	phmap::flat_hash_map<std::string, HighscoreCacheEntry> highscoreCache;
 
+	std::atomic<std::shared_ptr<const GameSnapshot>> snapshot;
+	// The copy published before the current one, refilled once no reader holds it
+	std::shared_ptr<GameSnapshot> spareSnapshot;
+
 	phmap::flat_hash_map<std::string, std::weak_ptr<Player>> m_uniqueLoginPlayerNames;
 	phmap::parallel_flat_hash_map<uint32_t, std::shared_ptr<Player>> players;
 	phmap::flat_hash_map<std::string, std::weak_ptr<Player>> mappedPlayerNames;
+	phmap::flat_hash_map<uint32_t, std::weak_ptr<Player>> mappedPlayerGuids;
 	phmap::parallel_flat_hash_map<uint32_t, std::shared_ptr<Guild>> guilds;
 	phmap::flat_hash_map<uint16_t, std::shared_ptr<Item>> uniqueItems;
 	phmap::parallel_flat_hash_map<uint32_t, std::string> m_playerNameCache;
@@ -853,13 +952,16 @@ private:
 	 * For example: ActionFunctions::luaActionPosition
 	 * This basically works so that the item is created after the map is loaded, because the scripts are loaded before the map is loaded, we will use this table to create items that don't exist in the map natively through each script
 	 */
-	std::map<Position, uint16_t> mapLuaItemsStored;
+	PositionMap<uint16_t> mapLuaItemsStored;
 
 	std::map<uint16_t, std::string> BestiaryList;
 	std::string boostedCreature = "";
 
 	std::vector<std::shared_ptr<Charm>> CharmList;
 	std::vector<std::shared_ptr<Creature>> checkCreatureLists[EVENT_CREATURECOUNT];
+	// Creatures due to step in each scheduler tick, with the token of their walk, stepped by one task per tick
+	phmap::flat_hash_map<int64_t, std::vector<std::pair<std::shared_ptr<Creature>, uint32_t>>> walkSlots;
+	uint32_t lastWalkToken = 0;
 
 	std::vector<uint16_t> registeredMagicEffects;
 	std::vector<uint16_t> registeredDistanceEffects;
@@ -868,11 +970,15 @@ private:
 	size_t lastBucket = 0;
 	size_t lastImbuedBucket = 0;
 
-	std::shared_ptr<WildcardTreeNode> wildcardTree;
+	WildcardTree wildcardTree;
+
+	CreatureRegistry<Npc> npcs;
+	CreatureRegistry<Monster> monsters;
+	// Monsters of the types that can be forged, kept as they spawn and despawn
+	IndexedSet<uint32_t> forgeableMonsters;
 
-	std::map<uint32_t, std::shared_ptr<Npc>> npcs;
-	std::map<uint32_t, std::shared_ptr<Monster>> monsters;
-	std::vector<uint32_t> forgeableMonsters;
+	// Flushed at the end of each dispatcher cycle
+	EffectBatch effectBatch;
 
 	std::map<uint32_t, std::unique_ptr<TeamFinder>> teamFinderMap; // [leaderGUID] = TeamFinder*
 
@@ -917,6 +1023,21 @@ private:
 
 	std::map<uint16_t, std::map<uint8_t, uint64_t>> itemsPriceMap;
 
+	// Objects and kilobytes last exported per memory category, the metrics are sent as deltas
+	std::map<std::string_view, std::pair<int64_t, int64_t>> exportedMemoryUsage;
+
+	struct PlayerTraffic {
+		// The counters restart with the protocol when the player reconnects
+		std::weak_ptr<ProtocolGame> client;
+		Protocol::TrafficStats stats;
+		int64_t dispatcherTimeNs = 0;
+	};
+	// Traffic of each online player when the metrics were last exported, by player id
+	phmap::flat_hash_map<uint32_t, PlayerTraffic> exportedTraffic;
+
+	// Players with imbuements that can decay, by id
+	phmap::flat_hash_set<uint32_t> imbuedPlayers;
+
 	std::vector<ItemClassification*> itemsClassifications;
 
 	bool isTryingToStow(const Position &toPos, std::shared_ptr<Cylinder> toCylinder) const;
@@ -942,6 +1063,10 @@ private:
 
 	bool shouldSendMessage(const TextMessage &message) const;
 
+	// Players that can see a combat target, from the current area combat when it covers the position
+	Spectators getCombatSpectators(const Position &targetPos, bool multifloor);
+	AreaCombatScope* areaCombatScope = nullptr;
+
 	void buildMessageAsAttacker(
 		std::shared_ptr<Creature> target, const CombatDamage &damage, TextMessage &message,
 		std::stringstream &ss, const std::string &damageString
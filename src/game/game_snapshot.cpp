@@ -0,0 +1,77 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/game_snapshot.hpp"
+#include "game/game.hpp"
+#include "creatures/monsters/monster.hpp"
+
+namespace {
+	template <typename T>
+	GameSnapshot::Creature describe(const std::shared_ptr<T> &creature) {
+		GameSnapshot::Creature described;
+		described.id = creature->getID();
+		described.position = creature->getPosition();
+		described.health = creature->getHealth();
+		described.maxHealth = creature->getMaxHealth();
+		described.lookType = creature->getCurrentOutfit().lookType;
+		described.type = creature->getType();
+		return described;
+	}
+}
+
+void GameSnapshot::capture() {
+	auto &game = g_game();
+	time = OTSYS_TIME();
+
+	creatures.clear();
+	players.clear();
+	const auto &onlinePlayers = game.getPlayers();
+	const auto &monsters = game.getMonsters();
+	const auto &npcs = game.getNpcs();
+	creatures.reserve(onlinePlayers.size() + monsters.size() + npcs.size());
+	players.reserve(onlinePlayers.size());
+
+	for (const auto &[_, player] : onlinePlayers) {
+		creatures.emplace_back(describe(player));
+		auto &described = players.emplace_back();
+		described.id = player->getID();
+		described.name = player->getName();
+		described.lowerName = asLowerCaseString(described.name);
+		described.level = player->getLevel();
+		described.ip = player->getIP();
+	}
+	for (const auto &[_, monster] : monsters) {
+		creatures.emplace_back(describe(monster));
+	}
+	for (const auto &[_, npc] : npcs) {
+		creatures.emplace_back(describe(npc));
+	}
+
+	std::ranges::sort(creatures, {}, &Creature::id);
+	std::ranges::sort(players, {}, &Player::lowerName);
+
+	monstersOnline = monsters.size();
+	npcsOnline = npcs.size();
+	playersRecord = game.getPlayersRecord();
+	game.getMapDimensions(mapWidth, mapHeight);
+	walkVersion = game.map.getWalkVersion();
+}
+
+const GameSnapshot::Creature* GameSnapshot::getCreature(uint32_t id) const {
+	const auto it = std::ranges::lower_bound(creatures, id, {}, &Creature::id);
+	return it != creatures.end() && it->id == id ? &*it : nullptr;
+}
+
+const GameSnapshot::Player* GameSnapshot::getPlayerByName(const std::string &name) const {
+	const auto lowerName = asLowerCaseString(name);
+	const auto it = std::ranges::lower_bound(players, lowerName, {}, &Player::lowerName);
+	return it != players.end() && it->lowerName == lowerName ? &*it : nullptr;
+}
@@ -0,0 +1,93 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "creatures/creatures_definitions.hpp"
+#include "game/movement/position.hpp"
+
+/**
+ * Read-only copy of the world state, captured on the dispatcher and safe to
+ * read from any thread.
+ *
+ * Game publishes one every gameSnapshotInterval and readers hold it through
+ * a shared pointer, so it stays alive for as long as they read it; the copy
+ * a reader drops last is reused for the next capture instead of allocated.
+ * The values are as old as the interval, only use it where that is fine.
+ */
+class GameSnapshot {
+public:
+	struct Creature {
+		uint32_t id = 0;
+		Position position;
+		int32_t health = 0;
+		int32_t maxHealth = 0;
+		uint16_t lookType = 0;
+		CreatureType_t type = CREATURETYPE_PLAYER;
+	};
+
+	struct Player {
+		uint32_t id = 0;
+		std::string name;
+		std::string lowerName;
+		uint32_t level = 0;
+		uint32_t ip = 0;
+	};
+
+	// Only on the dispatcher
+	void capture();
+
+	int64_t getTime() const {
+		return time;
+	}
+
+	// Sorted by id
+	const std::vector<Creature> &getCreatures() const {
+		return creatures;
+	}
+	const Creature* getCreature(uint32_t id) const;
+
+	// Sorted by lowercase name
+	const std::vector<Player> &getPlayers() const {
+		return players;
+	}
+	const Player* getPlayerByName(const std::string &name) const;
+
+	size_t getMonstersOnline() const {
+		return monstersOnline;
+	}
+	size_t getNpcsOnline() const {
+		return npcsOnline;
+	}
+	uint32_t getPlayersRecord() const {
+		return playersRecord;
+	}
+	uint32_t getMapWidth() const {
+		return mapWidth;
+	}
+	uint32_t getMapHeight() const {
+		return mapHeight;
+	}
+
+	// Changes whenever a tile starts or stops blocking walks or projectiles, not when creatures move
+	uint32_t getWalkVersion() const {
+		return walkVersion;
+	}
+
+private:
+	int64_t time = 0;
+	std::vector<Creature> creatures;
+	std::vector<Player> players;
+	size_t monstersOnline = 0;
+	size_t npcsOnline = 0;
+	uint32_t playersRecord = 0;
+	uint32_t mapWidth = 0;
+	uint32_t mapHeight = 0;
+	uint32_t walkVersion = 0;
+};
@@ -0,0 +1,234 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/highscores/highscores.hpp"
+#include "creatures/players/player.hpp"
+#include "creatures/players/vocations/vocation.hpp"
+#include "database/database.hpp"
+#include "enums/account_group_type.hpp"
+
+namespace {
+	// Order of Character::points, with the players column of each category
+	constexpr std::array<std::pair<HighscoreCategories_t, std::string_view>, 9> CATEGORY_COLUMNS = { {
+		{ HighscoreCategories_t::EXPERIENCE, "experience" },
+		{ HighscoreCategories_t::FIST_FIGHTING, "skill_fist" },
+		{ HighscoreCategories_t::CLUB_FIGHTING, "skill_club" },
+		{ HighscoreCategories_t::SWORD_FIGHTING, "skill_sword" },
+		{ HighscoreCategories_t::AXE_FIGHTING, "skill_axe" },
+		{ HighscoreCategories_t::DISTANCE_FIGHTING, "skill_dist" },
+		{ HighscoreCategories_t::SHIELDING, "skill_shielding" },
+		{ HighscoreCategories_t::FISHING, "skill_fishing" },
+		{ HighscoreCategories_t::MAGIC_LEVEL, "maglevel" },
+	} };
+
+	constexpr uint32_t ALL_VOCATIONS = 0xFFFFFFFF;
+}
+
+void HighscoreRanking::set(uint32_t guid, uint64_t newPoints) {
+	const auto [it, inserted] = points.try_emplace(guid, newPoints);
+	if (inserted) {
+		const Entry entry { newPoints, guid };
+		entries.insert(std::lower_bound(entries.begin(), entries.end(), entry, isBefore), entry);
+		return;
+	}
+
+	const uint64_t oldPoints = it->second;
+	if (oldPoints == newPoints) {
+		return;
+	}
+
+	it->second = newPoints;
+	const auto current = std::lower_bound(entries.begin(), entries.end(), Entry { oldPoints, guid }, isBefore);
+	current->points = newPoints;
+	// Only the entries passed by the new score are moved
+	if (newPoints > oldPoints) {
+		const auto target = std::lower_bound(entries.begin(), current, *current, isBefore);
+		std::rotate(target, current, current + 1);
+	} else {
+		const auto target = std::lower_bound(current + 1, entries.end(), *current, isBefore);
+		std::rotate(current, current + 1, target);
+	}
+}
+
+void HighscoreRanking::erase(uint32_t guid) {
+	const auto it = points.find(guid);
+	if (it == points.end()) {
+		return;
+	}
+
+	entries.erase(std::lower_bound(entries.begin(), entries.end(), Entry { it->second, guid }, isBefore));
+	points.erase(it);
+}
+
+std::optional<size_t> HighscoreRanking::getPosition(uint32_t guid) const {
+	const auto it = points.find(guid);
+	if (it == points.end()) {
+		return std::nullopt;
+	}
+
+	return static_cast<size_t>(std::lower_bound(entries.begin(), entries.end(), Entry { it->second, guid }, isBefore) - entries.begin());
+}
+
+size_t HighscoreRanking::countAbove(uint64_t minPoints) const {
+	// The first guid sorts before any other entry with the same points
+	return static_cast<size_t>(std::lower_bound(entries.begin(), entries.end(), Entry { minPoints, 0 }, isBefore) - entries.begin());
+}
+
+Highscores &Highscores::getInstance() {
+	return inject<Highscores>();
+}
+
+std::optional<size_t> Highscores::getCategoryIndex(uint8_t category) {
+	for (size_t i = 0; i < CATEGORY_COLUMNS.size(); ++i) {
+		if (static_cast<uint8_t>(CATEGORY_COLUMNS[i].first) == category) {
+			return i;
+		}
+	}
+	return std::nullopt;
+}
+
+uint32_t Highscores::getBaseVocation(uint16_t vocation) {
+	const auto &voc = g_vocations().getVocation(vocation);
+	return voc ? voc->getFromVocation() : vocation;
+}
+
+void Highscores::load() {
+	std::string columns;
+	for (const auto &[category, column] : CATEGORY_COLUMNS) {
+		columns += fmt::format(", `{}`", column);
+	}
+
+	const auto query = fmt::format("SELECT `id`, `name`, `level`, `vocation`{} FROM `players` WHERE `group_id` < {}", columns, static_cast<int>(GROUP_TYPE_GAMEMASTER));
+	DBResult_ptr result = g_database().storeQuery(query);
+
+	std::scoped_lock lock(mutex);
+	loaded = true;
+	if (!result) {
+		return;
+	}
+
+	do {
+		Character character;
+		character.name = result->getString("name");
+		character.level = result->getNumber<uint32_t>("level");
+		character.vocation = result->getNumber<uint16_t>("vocation");
+		for (size_t i = 0; i < CATEGORY_COLUMNS.size(); ++i) {
+			character.points[i] = result->getNumber<uint64_t>(std::string(CATEGORY_COLUMNS[i].second));
+		}
+		setCharacter(result->getNumber<uint32_t>("id"), std::move(character));
+	} while (result->next());
+
+	g_logger().debug("Loaded {} characters into the highscores", characters.size());
+}
+
+bool Highscores::hasCategory(uint8_t category) const {
+	std::scoped_lock lock(mutex);
+	return loaded && getCategoryIndex(category).has_value();
+}
+
+void Highscores::updatePlayer(const std::shared_ptr<Player> &player) {
+	std::scoped_lock lock(mutex);
+	if (!loaded || !player) {
+		return;
+	}
+
+	const auto &group = player->getGroup();
+	if (group && group->id >= GROUP_TYPE_GAMEMASTER) {
+		eraseCharacter(player->getGUID());
+		return;
+	}
+
+	Character character;
+	character.name = player->getName();
+	character.level = player->getLevel();
+	character.vocation = player->getVocationId();
+	character.points[0] = player->getExperience();
+	for (uint8_t skill = SKILL_FIST; skill <= SKILL_FISHING; ++skill) {
+		character.points[skill + 1] = player->getBaseSkill(skill);
+	}
+	character.points[CATEGORY_COUNT - 1] = player->getBaseMagicLevel();
+	setCharacter(player->getGUID(), std::move(character));
+}
+
+void Highscores::setCharacter(uint32_t guid, Character character) {
+	const auto it = characters.find(guid);
+	const auto baseVocation = getBaseVocation(character.vocation);
+	if (it != characters.end() && getBaseVocation(it->second.vocation) != baseVocation) {
+		const auto oldVocation = getBaseVocation(it->second.vocation);
+		for (auto &byVocation : vocationRankings) {
+			byVocation[oldVocation].erase(guid);
+		}
+	}
+
+	for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+		rankings[i].set(guid, character.points[i]);
+		vocationRankings[i][baseVocation].set(guid, character.points[i]);
+	}
+	characters.insert_or_assign(guid, std::move(character));
+}
+
+void Highscores::eraseCharacter(uint32_t guid) {
+	const auto it = characters.find(guid);
+	if (it == characters.end()) {
+		return;
+	}
+
+	const auto baseVocation = getBaseVocation(it->second.vocation);
+	for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+		rankings[i].erase(guid);
+		vocationRankings[i][baseVocation].erase(guid);
+	}
+	characters.erase(it);
+}
+
+bool Highscores::getPage(uint8_t category, uint32_t vocation, uint16_t &page, uint8_t entriesPerPage, uint16_t &pages, uint32_t ourRankGuid, std::vector<HighscoreCharacter> &characterList) const {
+	std::scoped_lock lock(mutex);
+	const auto index = getCategoryIndex(category);
+	if (!index || entriesPerPage == 0) {
+		return false;
+	}
+
+	const auto &ranking = rankings[*index];
+	const HighscoreRanking* listed = &ranking;
+	if (vocation != ALL_VOCATIONS) {
+		const auto &byVocation = vocationRankings[*index];
+		const auto it = byVocation.find(vocation);
+		if (it == byVocation.end()) {
+			return false;
+		}
+		listed = &it->second;
+	}
+
+	if (ourRankGuid != 0) {
+		// A character out of the list sees the first page
+		const auto position = listed->getPosition(ourRankGuid);
+		page = static_cast<uint16_t>(position.value_or(0) / entriesPerPage + 1);
+	}
+
+	const auto &entries = listed->getEntries();
+	const size_t start = static_cast<size_t>(std::max<uint16_t>(page, 1) - 1) * entriesPerPage;
+	if (start >= entries.size()) {
+		return false;
+	}
+
+	pages = static_cast<uint16_t>(std::min<size_t>((entries.size() + entriesPerPage - 1) / entriesPerPage, std::numeric_limits<uint16_t>::max()));
+	const size_t end = std::min(entries.size(), start + entriesPerPage);
+	characterList.reserve(end - start);
+	for (size_t i = start; i < end; ++i) {
+		const auto &entry = entries[i];
+		const auto &character = characters.at(entry.guid);
+		const auto &voc = g_vocations().getVocation(character.vocation);
+		// Ranked among all vocations, as the database listing did
+		const auto rank = static_cast<uint32_t>(ranking.countAbove(entry.points) + 1);
+		characterList.emplace_back(character.name, entry.points, entry.guid, rank, static_cast<uint16_t>(character.level), voc ? voc->getClientId() : 0, "");
+	}
+	return true;
+}
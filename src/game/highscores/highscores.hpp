@@ -0,0 +1,113 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Player;
+
+/**
+ * Characters of one highscore list, best first.
+ *
+ * Entries are kept sorted by points, ties broken by guid, so positions and
+ * ranks are binary searches; a changed score only shifts the entries between
+ * its old and new place.
+ */
+class HighscoreRanking {
+public:
+	struct Entry {
+		uint64_t points;
+		uint32_t guid;
+	};
+
+	void set(uint32_t guid, uint64_t points);
+	void erase(uint32_t guid);
+
+	size_t size() const {
+		return entries.size();
+	}
+
+	const std::vector<Entry> &getEntries() const {
+		return entries;
+	}
+
+	/**
+	 * @return Zero based position of the character, std::nullopt when it is not listed.
+	 */
+	std::optional<size_t> getPosition(uint32_t guid) const;
+	/**
+	 * @return Number of characters with more points, the rank of the points minus one.
+	 */
+	size_t countAbove(uint64_t points) const;
+
+private:
+	static bool isBefore(const Entry &lhs, const Entry &rhs) {
+		return lhs.points != rhs.points ? lhs.points > rhs.points : lhs.guid < rhs.guid;
+	}
+
+	std::vector<Entry> entries;
+	phmap::flat_hash_map<uint32_t, uint64_t> points;
+};
+
+/**
+ * Highscores of the player columns served from memory.
+ *
+ * Loaded once from the players table and refreshed when a character saves or
+ * advances, so the highscore window never runs an ORDER BY over all players.
+ * Categories without a ranking here are still answered by the database.
+ */
+class Highscores {
+public:
+	Highscores() = default;
+
+	// Ensures that we don't accidentally copy it
+	Highscores(const Highscores &) = delete;
+	Highscores &operator=(const Highscores &) = delete;
+
+	static Highscores &getInstance();
+
+	void load();
+
+	bool hasCategory(uint8_t category) const;
+
+	void updatePlayer(const std::shared_ptr<Player> &player);
+
+	/**
+	 * @brief Fills the characters of a page of a category.
+	 * @param vocation Base vocation listed, 0xFFFFFFFF for all.
+	 * @param page One based page, replaced by the page of the player when ourRank is set.
+	 * @return False when the page is empty.
+	 */
+	bool getPage(uint8_t category, uint32_t vocation, uint16_t &page, uint8_t entriesPerPage, uint16_t &pages, uint32_t ourRankGuid, std::vector<HighscoreCharacter> &characters) const;
+
+private:
+	static constexpr size_t CATEGORY_COUNT = 9;
+
+	struct Character {
+		std::string name;
+		uint32_t level = 0;
+		uint16_t vocation = 0;
+		std::array<uint64_t, CATEGORY_COUNT> points {};
+	};
+
+	static std::optional<size_t> getCategoryIndex(uint8_t category);
+	static uint32_t getBaseVocation(uint16_t vocation);
+
+	void setCharacter(uint32_t guid, Character character);
+	void eraseCharacter(uint32_t guid);
+
+	bool loaded = false;
+	phmap::flat_hash_map<uint32_t, Character> characters;
+	std::array<HighscoreRanking, CATEGORY_COUNT> rankings;
+	// Keyed by base vocation, the lists of the vocation filter
+	std::array<phmap::flat_hash_map<uint32_t, HighscoreRanking>, CATEGORY_COUNT> vocationRankings;
+	// Saves may run outside the dispatcher
+	mutable std::mutex mutex;
+};
+
+constexpr auto g_highscores = Highscores::getInstance;
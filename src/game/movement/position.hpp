@@ -114,13 +114,37 @@ struct Position {
 	int_fast16_t getZ() const {
 		return z;
 	}
+
+	// The coordinates in one word, only equal positions have the same key
+	constexpr uint64_t pack() const {
+		return static_cast<uint64_t>(x) | (static_cast<uint64_t>(y) << 16) | (static_cast<uint64_t>(z) << 32);
+	}
+};
+
+/**
+ * Hash of the packed coordinates. Near positions only differ in the low
+ * bits of the key, the mixer spreads them over the whole word so the open
+ * addressing tables do not cluster.
+ */
+struct PositionHasher {
+	std::size_t operator()(const Position &p) const {
+		uint64_t key = p.pack();
+		key ^= key >> 33;
+		key *= 0xFF51AFD7ED558CCDULL;
+		key ^= key >> 33;
+		return static_cast<std::size_t>(key);
+	}
 };
 
+template <typename T>
+using PositionMap = phmap::flat_hash_map<Position, T, PositionHasher>;
+using PositionSet = phmap::flat_hash_set<Position, PositionHasher>;
+
 namespace std {
 	template <>
 	struct hash<Position> {
 		std::size_t operator()(const Position &p) const {
-			return static_cast<std::size_t>(p.x) | (static_cast<std::size_t>(p.y) << 16) | (static_cast<std::size_t>(p.z) << 32);
+			return PositionHasher()(p);
 		}
 	};
 }
@@ -0,0 +1,288 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include <coroutine>
+
+#include "game/scheduling/dispatcher.hpp"
+#include "database/databasetasks.hpp"
+#include "lib/di/container.hpp"
+
+/**
+ * Coroutine run by the dispatcher, for flows that wait on the database or
+ * the thread pool between serial steps.
+ *
+ * It starts when awaited by another coroutine, or when detached from plain
+ * code; the awaitables below always resume it on the dispatcher, so the code
+ * between two co_await can touch game state like any other serial task.
+ * Anything read before a co_await may be gone after it: take ids, not
+ * pointers, as parameters and look the objects up again. Parameters must be
+ * taken by value, a coroutine outlives the call that created it.
+ */
+template <typename T = void>
+class AsyncTask;
+
+namespace coroutine_detail {
+	template <typename T>
+	struct PromiseBase {
+		std::coroutine_handle<> continuation;
+		std::exception_ptr exception;
+		bool detached = false;
+
+		std::suspend_always initial_suspend() noexcept {
+			return {};
+		}
+
+		struct FinalAwaiter {
+			bool await_ready() noexcept {
+				return false;
+			}
+
+			template <typename Promise>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+				auto &promise = handle.promise();
+				if (promise.continuation) {
+					return promise.continuation;
+				}
+				if (promise.detached) {
+					handle.destroy();
+				}
+				return std::noop_coroutine();
+			}
+
+			void await_resume() noexcept { }
+		};
+
+		FinalAwaiter final_suspend() noexcept {
+			return {};
+		}
+
+		void unhandled_exception() {
+			exception = std::current_exception();
+			if (detached) {
+				try {
+					std::rethrow_exception(exception);
+				} catch (const std::exception &e) {
+					g_logger().error("[AsyncTask] - Detached coroutine failed: {}", e.what());
+				} catch (...) {
+					g_logger().error("[AsyncTask] - Detached coroutine failed");
+				}
+			}
+		}
+	};
+
+	template <typename T>
+	struct Promise : PromiseBase<T> {
+		std::optional<T> value;
+
+		AsyncTask<T> get_return_object();
+
+		template <typename U>
+		void return_value(U &&result) {
+			value.emplace(std::forward<U>(result));
+		}
+
+		T take() {
+			if (this->exception) {
+				std::rethrow_exception(this->exception);
+			}
+			return std::move(*value);
+		}
+	};
+
+	template <>
+	struct Promise<void> : PromiseBase<void> {
+		AsyncTask<void> get_return_object();
+
+		void return_void() { }
+
+		void take() {
+			if (exception) {
+				std::rethrow_exception(exception);
+			}
+		}
+	};
+}
+
+template <typename T>
+class [[nodiscard]] AsyncTask {
+public:
+	using promise_type = coroutine_detail::Promise<T>;
+
+	explicit AsyncTask(std::coroutine_handle<promise_type> handle) :
+		handle(handle) { }
+
+	AsyncTask(AsyncTask &&other) noexcept :
+		handle(std::exchange(other.handle, nullptr)) { }
+
+	AsyncTask(const AsyncTask &) = delete;
+	AsyncTask &operator=(const AsyncTask &) = delete;
+	AsyncTask &operator=(AsyncTask &&) = delete;
+
+	~AsyncTask() {
+		if (handle) {
+			handle.destroy();
+		}
+	}
+
+	/**
+	 * @brief Starts the coroutine from plain code, it frees itself when it finishes.
+	 * Must be called on the dispatcher; an exception it throws is logged.
+	 */
+	void detach() && {
+		auto started = std::exchange(handle, nullptr);
+		started.promise().detached = true;
+		started.resume();
+	}
+
+	bool await_ready() const noexcept {
+		return false;
+	}
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+		handle.promise().continuation = caller;
+		return handle;
+	}
+
+	T await_resume() {
+		return handle.promise().take();
+	}
+
+private:
+	std::coroutine_handle<promise_type> handle;
+};
+
+namespace coroutine_detail {
+	template <typename T>
+	AsyncTask<T> Promise<T>::get_return_object() {
+		return AsyncTask<T> { std::coroutine_handle<Promise<T>>::from_promise(*this) };
+	}
+
+	inline AsyncTask<void> Promise<void>::get_return_object() {
+		return AsyncTask<void> { std::coroutine_handle<Promise<void>>::from_promise(*this) };
+	}
+}
+
+/**
+ * @brief Continues the coroutine in a new dispatcher task, letting the tasks queued meanwhile run.
+ */
+inline auto resumeOnDispatcher(std::string_view context) {
+	struct Awaiter {
+		std::string_view context;
+
+		bool await_ready() const noexcept {
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> handle) const {
+			g_dispatcher().addEvent([handle] { handle.resume(); }, context);
+		}
+
+		void await_resume() const noexcept { }
+	};
+	return Awaiter { context };
+}
+
+/**
+ * @brief Runs work on the thread pool and resumes on the dispatcher with its result.
+ * The work must not touch game state; an exception it throws is rethrown by the co_await.
+ */
+template <typename F>
+auto offload(F work, std::string_view context) {
+	using Result = std::invoke_result_t<F>;
+	struct Awaiter {
+		F work;
+		std::string_view context;
+		std::conditional_t<std::is_void_v<Result>, std::monostate, std::optional<Result>> result;
+		std::exception_ptr exception;
+
+		bool await_ready() const noexcept {
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> handle) {
+			// The awaiter lives in the suspended coroutine until it is resumed
+			inject<ThreadPool>().detach_task([this, handle] {
+				try {
+					if constexpr (std::is_void_v<Result>) {
+						work();
+					} else {
+						result.emplace(work());
+					}
+				} catch (...) {
+					exception = std::current_exception();
+				}
+				g_dispatcher().addEvent([handle] { handle.resume(); }, context);
+			});
+		}
+
+		Result await_resume() {
+			if (exception) {
+				std::rethrow_exception(exception);
+			}
+			if constexpr (!std::is_void_v<Result>) {
+				return std::move(*result);
+			}
+		}
+	};
+	return Awaiter { std::move(work), context };
+}
+
+/**
+ * @brief Stores a query through the database tasks and resumes on the dispatcher with its result.
+ */
+inline auto storeQueryAsync(std::string query) {
+	struct Awaiter {
+		std::string query;
+		DBResult_ptr result;
+
+		bool await_ready() const noexcept {
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> handle) {
+			g_databaseTasks().store(query, [this, handle](DBResult_ptr stored, bool) {
+				result = std::move(stored);
+				handle.resume();
+			});
+		}
+
+		DBResult_ptr await_resume() {
+			return std::move(result);
+		}
+	};
+	return Awaiter { std::move(query) };
+}
+
+/**
+ * @brief Executes a query through the database tasks and resumes on the dispatcher with its success.
+ */
+inline auto executeQueryAsync(std::string query) {
+	struct Awaiter {
+		std::string query;
+		bool success = false;
+
+		bool await_ready() const noexcept {
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> handle) {
+			g_databaseTasks().execute(query, [this, handle](DBResult_ptr, bool executed) {
+				success = executed;
+				handle.resume();
+			});
+		}
+
+		bool await_resume() const noexcept {
+			return success;
+		}
+	};
+	return Awaiter { std::move(query) };
+}
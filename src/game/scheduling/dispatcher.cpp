@@ -29,12 +29,28 @@ void Dispatcher::init() {
 		while (!threadPool.isStopped()) {
 			UPDATE_OTSYS_TIME();
 
+			flightRecorder.beginCycle();
 			executeEvents();
 			executeScheduledEvents();
+			if (cycleEndHandler) {
+				const auto handlerStart = FlightRecorder::now();
+				cycleEndHandler();
+				flightRecorder.addTask("Dispatcher::cycleEnd", handlerStart, false);
+			}
 			mergeEvents();
+			if (const auto durationNs = flightRecorder.endCycle(); durationNs != 0) {
+				tickGovernor.addCycle(durationNs);
+			}
 
 			if (!hasPendingTasks) {
-				signalSchedule.wait_for(asyncLock, timeUntilNextScheduledTask());
+				if (idleHandler) {
+					idleHandler(timeUntilNextScheduledTask());
+					UPDATE_OTSYS_TIME();
+				}
+
+				if (!hasPendingTasks) {
+					signalSchedule.wait_for(asyncLock, timeUntilNextScheduledTask());
+				}
 			}
 		}
 	});
@@ -44,18 +60,24 @@ void Dispatcher::executeSerialEvents(std::vector<Task> &tasks) {
 	dispacherContext.group = TaskGroup::Serial;
 	dispacherContext.type = DispatcherType::Event;
 
+	const auto phaseStart = FlightRecorder::now();
 	for (const auto &task : tasks) {
 		dispacherContext.taskName = task.getContext();
+		const auto taskStart = FlightRecorder::now();
 		if (task.execute()) {
 			++dispatcherCycle;
 		}
+		flightRecorder.addTask(task.getContext(), taskStart, false);
 	}
 	tasks.clear();
+	flightRecorder.addPhase(FlightRecorder::Phase::Serial, phaseStart);
 
 	dispacherContext.reset();
 }
 
 void Dispatcher::executeParallelEvents(std::vector<Task> &tasks, const uint8_t groupId) {
+	const auto phaseStart = FlightRecorder::now();
+	flightRecorder.addTasks(static_cast<TaskGroup>(groupId), tasks.size());
 	asyncWait(tasks.size(), [groupId, &tasks](size_t i) {
 		dispacherContext.type = DispatcherType::AsyncEvent;
 		dispacherContext.group = static_cast<TaskGroup>(groupId);
@@ -65,6 +87,7 @@ void Dispatcher::executeParallelEvents(std::vector<Task> &tasks, const uint8_t g
 	});
 
 	tasks.clear();
+	flightRecorder.addPhase(FlightRecorder::Phase::Parallel, phaseStart);
 }
 
 void Dispatcher::asyncWait(size_t requestSize, std::function<void(size_t i)> &&f) {
@@ -103,11 +126,25 @@ void Dispatcher::asyncWait(size_t requestSize, std::function<void(size_t i)> &&f
 	}
 }
 
+void Dispatcher::asyncWaitGroup(size_t requestSize, std::function<void(size_t i)> &&f, TaskGroup group) {
+	const auto callerContext = dispacherContext;
+
+	asyncWait(requestSize, [&f, group](size_t i) {
+		dispacherContext.type = DispatcherType::AsyncEvent;
+		dispacherContext.group = group;
+		f(i);
+
+		dispacherContext.reset();
+	});
+
+	dispacherContext = callerContext;
+}
+
 void Dispatcher::executeEvents(const TaskGroup startGroup) {
 	for (uint_fast8_t groupId = static_cast<uint8_t>(startGroup); groupId < static_cast<uint8_t>(TaskGroup::Last); ++groupId) {
 		auto &tasks = m_tasks[groupId];
 		if (tasks.empty()) {
-			return;
+			continue;
 		}
 
 		if (groupId == static_cast<uint8_t>(TaskGroup::Serial)) {
@@ -119,9 +156,33 @@ void Dispatcher::executeEvents(const TaskGroup startGroup) {
 	}
 }
 
+void Dispatcher::executeScheduledTask(const std::shared_ptr<Task> &task, std::vector<std::shared_ptr<Task>> &threadScheduledTasks) {
+	dispacherContext.type = task->isCycle() ? DispatcherType::CycleEvent : DispatcherType::ScheduledEvent;
+	dispacherContext.group = TaskGroup::Serial;
+	dispacherContext.taskName = task->getContext();
+
+	const auto taskStart = FlightRecorder::now();
+	const bool executed = task->execute();
+	flightRecorder.addTask(task->getContext(), taskStart, true);
+	if (executed && task->isCycle()) {
+		task->updateTime();
+		threadScheduledTasks.emplace_back(task);
+	} else {
+		scheduledTasksRef.erase(task->getId());
+	}
+}
+
 void Dispatcher::executeScheduledEvents() {
 	auto &threadScheduledTasks = getThreadTask()->scheduledTasks;
+	const auto phaseStart = FlightRecorder::now();
 
+#ifdef FEATURE_TIMING_WHEEL
+	scheduledTasks.advance(OTSYS_TIME(), expiredScheduledTasks);
+	for (const auto &task : expiredScheduledTasks) {
+		executeScheduledTask(task, threadScheduledTasks);
+	}
+	expiredScheduledTasks.clear();
+#else
 	auto it = scheduledTasks.begin();
 	while (it != scheduledTasks.end()) {
 		const auto &task = *it;
@@ -129,25 +190,17 @@ void Dispatcher::executeScheduledEvents() {
 			break;
 		}
 
-		dispacherContext.type = task->isCycle() ? DispatcherType::CycleEvent : DispatcherType::ScheduledEvent;
-		dispacherContext.group = TaskGroup::Serial;
-		dispacherContext.taskName = task->getContext();
-
-		if (task->execute() && task->isCycle()) {
-			task->updateTime();
-			threadScheduledTasks.emplace_back(task);
-		} else {
-			scheduledTasksRef.erase(task->getId());
-		}
-
+		executeScheduledTask(task, threadScheduledTasks);
 		++it;
 	}
 
 	if (it != scheduledTasks.begin()) {
 		scheduledTasks.erase(scheduledTasks.begin(), it);
 	}
+#endif
 
 	dispacherContext.reset();
+	flightRecorder.addPhase(FlightRecorder::Phase::Scheduled, phaseStart);
 
 	mergeAsyncEvents(); // merge async events requested by scheduled events
 	executeEvents(TaskGroup::GenericParallel); // execute async events requested by scheduled events
@@ -176,12 +229,28 @@ void Dispatcher::mergeEvents() {
 	for (const auto &thread : threads) {
 		std::scoped_lock lock(thread->mutex);
 		if (!thread->tasks[serial].empty()) {
-			m_tasks[serial].insert(m_tasks[serial].end(), make_move_iterator(thread->tasks[serial].begin()), make_move_iterator(thread->tasks[serial].end()));
+			// The tasks already expired are dropped here, they would only wait for their turn to be skipped
+			auto &serialTasks = m_tasks[serial];
+			serialTasks.reserve(serialTasks.size() + thread->tasks[serial].size());
+			for (auto &task : thread->tasks[serial]) {
+				if (task.hasExpired()) {
+					task.onExpired();
+					continue;
+				}
+				serialTasks.emplace_back(std::move(task));
+			}
 			thread->tasks[serial].clear();
 		}
 
 		if (!thread->scheduledTasks.empty()) {
+#ifdef FEATURE_TIMING_WHEEL
+			const auto now = OTSYS_TIME();
+			for (const auto &task : thread->scheduledTasks) {
+				scheduledTasks.insert(task, now);
+			}
+#else
 			scheduledTasks.insert(make_move_iterator(thread->scheduledTasks.begin()), make_move_iterator(thread->scheduledTasks.end()));
+#endif
 			thread->scheduledTasks.clear();
 		}
 	}
@@ -190,6 +259,9 @@ void Dispatcher::mergeEvents() {
 }
 
 std::chrono::milliseconds Dispatcher::timeUntilNextScheduledTask() const {
+#ifdef FEATURE_TIMING_WHEEL
+	return scheduledTasks.timeUntilNextTick(OTSYS_TIME());
+#else
 	constexpr auto CHRONO_0 = std::chrono::milliseconds(0);
 	constexpr auto CHRONO_MILI_MAX = std::chrono::milliseconds::max();
 
@@ -200,9 +272,10 @@ std::chrono::milliseconds Dispatcher::timeUntilNextScheduledTask() const {
 	const auto &task = *scheduledTasks.begin();
 	const auto timeRemaining = std::chrono::milliseconds(task->getTime() - OTSYS_TIME());
 	return std::max<std::chrono::milliseconds>(timeRemaining, CHRONO_0);
+#endif
 }
 
-void Dispatcher::addEvent(std::function<void(void)> &&f, std::string_view context, uint32_t expiresAfterMs) {
+void Dispatcher::addEvent(TaskCallback &&f, std::string_view context, uint32_t expiresAfterMs) {
 	const auto &thread = getThreadTask();
 	std::scoped_lock lock(thread->mutex);
 	thread->tasks[static_cast<uint8_t>(TaskGroup::Serial)].emplace_back(expiresAfterMs, std::move(f), context);
@@ -221,7 +294,7 @@ uint64_t Dispatcher::scheduleEvent(const std::shared_ptr<Task> &task) {
 	return eventId;
 }
 
-void Dispatcher::asyncEvent(std::function<void(void)> &&f, TaskGroup group) {
+void Dispatcher::asyncEvent(TaskCallback &&f, TaskGroup group) {
 	const auto &thread = getThreadTask();
 	std::scoped_lock lock(thread->mutex);
 	thread->tasks[static_cast<uint8_t>(group)].emplace_back(0, std::move(f), dispacherContext.taskName);
@@ -236,11 +309,11 @@ void Dispatcher::stopEvent(uint64_t eventId) {
 	}
 }
 
-void DispatcherContext::addEvent(std::function<void(void)> &&f, std::string_view context) const {
+void DispatcherContext::addEvent(TaskCallback &&f, std::string_view context) const {
 	g_dispatcher().addEvent(std::move(f), context);
 }
 
-void DispatcherContext::tryAddEvent(std::function<void(void)> &&f, std::string_view context) const {
+void DispatcherContext::tryAddEvent(TaskCallback &&f, std::string_view context) const {
 	if (!f) {
 		return;
 	}
@@ -10,8 +10,14 @@
 #pragma once
 
 #include "task.hpp"
+#include "game/scheduling/flight_recorder.hpp"
+#include "game/scheduling/tick_governor.hpp"
 #include "lib/thread/thread_pool.hpp"
 
+#ifdef FEATURE_TIMING_WHEEL
+	#include "game/scheduling/timing_wheel.hpp"
+#endif
+
 static constexpr uint16_t DISPATCHER_TASK_EXPIRATION = 2000;
 static constexpr uint16_t SCHEDULER_MINTICKS = 50;
 
@@ -19,6 +25,8 @@ enum class TaskGroup : int8_t {
 	ThreadPool = -1,
 	Serial,
 	GenericParallel,
+	// Pathfinding requests, kept apart so their batch does not delay the other async events
+	Walk,
 	Last
 };
 
@@ -56,10 +64,10 @@ struct DispatcherContext {
 	}
 
 	// postpone the event
-	void addEvent(std::function<void(void)> &&f, std::string_view context) const;
+	void addEvent(TaskCallback &&f, std::string_view context) const;
 
 	// if the context is async, the event will be postponed, if not, it will be executed immediately.
-	void tryAddEvent(std::function<void(void)> &&f, std::string_view context) const;
+	void tryAddEvent(TaskCallback &&f, std::string_view context) const;
 
 private:
 	void reset() {
@@ -73,6 +81,7 @@ private:
 	std::string_view taskName;
 
 	friend class Dispatcher;
+	friend class TaskGraph;
 };
 
 /**
@@ -96,20 +105,23 @@ public:
 
 	static Dispatcher &getInstance();
 
-	void addEvent(std::function<void(void)> &&f, std::string_view context, uint32_t expiresAfterMs = 0);
+	void addEvent(TaskCallback &&f, std::string_view context, uint32_t expiresAfterMs = 0);
 
-	uint64_t cycleEvent(uint32_t delay, std::function<void(void)> &&f, std::string_view context) {
+	uint64_t cycleEvent(uint32_t delay, TaskCallback &&f, std::string_view context) {
 		return scheduleEvent(delay, std::move(f), context, true);
 	}
 
 	uint64_t scheduleEvent(const std::shared_ptr<Task> &task);
-	uint64_t scheduleEvent(uint32_t delay, std::function<void(void)> &&f, std::string_view context) {
+	uint64_t scheduleEvent(uint32_t delay, TaskCallback &&f, std::string_view context) {
 		return scheduleEvent(delay, std::move(f), context, false);
 	}
 
-	void asyncEvent(std::function<void(void)> &&f, TaskGroup group = TaskGroup::GenericParallel);
+	void asyncEvent(TaskCallback &&f, TaskGroup group = TaskGroup::GenericParallel);
 	void asyncWait(size_t size, std::function<void(size_t i)> &&f);
 
+	// Same as asyncWait, but each call runs inside an async context, so serial-only work requested from it is postponed to the dispatcher.
+	void asyncWaitGroup(size_t size, std::function<void(size_t i)> &&f, TaskGroup group = TaskGroup::GenericParallel);
+
 	uint64_t asyncCycleEvent(uint32_t delay, std::function<void(void)> &&f, TaskGroup group = TaskGroup::GenericParallel) {
 		return scheduleEvent(
 			delay, [this, f = std::move(f), group] { asyncEvent([f] { f(); }, group); }, dispacherContext.taskName, true, false
@@ -128,10 +140,39 @@ public:
 
 	void stopEvent(uint64_t eventId);
 
+	/**
+	 * @brief Sets the work run on the dispatcher thread when it has nothing to run.
+	 * @param handler Receives the time left until the next scheduled task, it must return well before that.
+	 */
+	void setIdleHandler(std::function<void(std::chrono::milliseconds slack)> &&handler) {
+		idleHandler = std::move(handler);
+	}
+
+	/**
+	 * @brief Sets the work run on the dispatcher thread once the tasks of a cycle are done.
+	 * It runs out of any task, what it sends no longer counts as sent from a serial task.
+	 */
+	void setCycleEndHandler(std::function<void()> &&handler) {
+		cycleEndHandler = std::move(handler);
+	}
+
 	const auto &context() const {
 		return dispacherContext;
 	}
 
+	// Same as context(), without the instance, for a signal handler that can't reach the container
+	static const DispatcherContext &threadContext() {
+		return dispacherContext;
+	}
+
+	const FlightRecorder &getFlightRecorder() const {
+		return flightRecorder;
+	}
+
+	const TickGovernor &getTickGovernor() const {
+		return tickGovernor;
+	}
+
 private:
 	thread_local static DispatcherContext dispacherContext;
 
@@ -139,8 +180,8 @@ private:
 		return threads[ThreadPool::getThreadId()];
 	}
 
-	uint64_t scheduleEvent(uint32_t delay, std::function<void(void)> &&f, std::string_view context, bool cycle, bool log = true) {
-		return scheduleEvent(std::make_shared<Task>(std::move(f), context, delay, cycle, log));
+	uint64_t scheduleEvent(uint32_t delay, TaskCallback &&f, std::string_view context, bool cycle, bool log = true) {
+		return scheduleEvent(Task::makeShared(std::move(f), context, delay, cycle, log));
 	}
 
 	void init();
@@ -153,6 +194,7 @@ private:
 	inline void executeEvents(const TaskGroup startGroup = TaskGroup::Serial);
 	inline void executeScheduledEvents();
 
+	inline void executeScheduledTask(const std::shared_ptr<Task> &task, std::vector<std::shared_ptr<Task>> &threadScheduledTasks);
 	inline void executeSerialEvents(std::vector<Task> &tasks);
 	inline void executeParallelEvents(std::vector<Task> &tasks, const uint8_t groupId);
 	inline std::chrono::milliseconds timeUntilNextScheduledTask() const;
@@ -208,18 +250,29 @@ private:
 
 		std::array<std::vector<Task>, static_cast<uint8_t>(TaskGroup::Last)> tasks;
 		std::vector<std::shared_ptr<Task>> scheduledTasks;
-		std::mutex mutex;
+		ProfiledMutex<std::mutex> mutex { "dispatcher_thread_task" };
 	};
 	std::vector<std::unique_ptr<ThreadTask>> threads;
 
 	// Main Events
 	std::array<std::vector<Task>, static_cast<uint8_t>(TaskGroup::Last)> m_tasks;
+#ifdef FEATURE_TIMING_WHEEL
+	TimingWheel scheduledTasks { SCHEDULER_MINTICKS };
+	std::vector<std::shared_ptr<Task>> expiredScheduledTasks;
+#else
 	phmap::btree_multiset<std::shared_ptr<Task>, Task::Compare> scheduledTasks;
+#endif
 	phmap::parallel_flat_hash_map_m<uint64_t, std::shared_ptr<Task>> scheduledTasksRef;
 
+	std::function<void(std::chrono::milliseconds)> idleHandler;
+	std::function<void()> cycleEndHandler;
+	FlightRecorder flightRecorder;
+	TickGovernor tickGovernor;
+
 	bool asyncWaitDisabled = false;
 
 	friend class CanaryServer;
+	friend class TaskGraph;
 };
 
 constexpr auto g_dispatcher = Dispatcher::getInstance;
@@ -0,0 +1,175 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/scheduling/flight_recorder.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "config/configmanager.hpp"
+#include "lib/logging/log_with_spd_log.hpp"
+
+namespace {
+	double toMs(int64_t ns) {
+		return static_cast<double>(ns) / 1000000.0;
+	}
+}
+
+void FlightRecorder::beginCycle() {
+	current = Cycle();
+	current.startMs = OTSYS_TIME();
+	current.startNs = now();
+}
+
+int64_t FlightRecorder::endCycle() {
+	const auto ran = std::accumulate(current.tasks.begin(), current.tasks.end(), current.scheduledTasks);
+	if (ran == 0) {
+		return 0;
+	}
+
+	current.durationNs = now() - current.startNs;
+	current.id = ++lastId;
+	cycles[next] = current;
+	next = (next + 1) % CYCLES;
+	count = std::min(count + 1, CYCLES);
+
+	// The threshold is in milliseconds, most cycles are shorter and skip reading it
+	if (current.durationNs < 1000000) {
+		return current.durationNs;
+	}
+
+	const auto threshold = g_configManager().getNumber(DISPATCHER_SLOW_CYCLE_THRESHOLD, __FUNCTION__);
+	if (threshold > 0 && current.durationNs >= static_cast<int64_t>(threshold) * 1000000) {
+		static LogRateLimiter slowCycles;
+		g_logger().warn(slowCycles, "[FlightRecorder] - Slow dispatcher cycle: {}", describe(current));
+	}
+	return current.durationNs;
+}
+
+void FlightRecorder::addTasks(TaskGroup group, size_t taskCount) {
+	const auto index = static_cast<size_t>(group);
+	if (index < GROUPS) {
+		current.tasks[index] += static_cast<uint32_t>(taskCount);
+	}
+}
+
+void FlightRecorder::addTask(std::string_view context, int64_t startNs, bool scheduled) {
+	const auto ns = now() - startNs;
+	if (scheduled) {
+		++current.scheduledTasks;
+	} else {
+		++current.tasks[static_cast<size_t>(TaskGroup::Serial)];
+	}
+
+	// Sorted slowest first, most tasks are faster than the last one and stop here
+	auto &slowest = current.slowest;
+	if (ns <= slowest.back().ns) {
+		return;
+	}
+
+	size_t position = slowest.size() - 1;
+	while (position > 0 && slowest[position - 1].ns < ns) {
+		slowest[position] = slowest[position - 1];
+		--position;
+	}
+
+	auto &task = slowest[position];
+	const auto length = std::min(context.size(), task.context.size() - 1);
+	std::copy_n(context.data(), length, task.context.data());
+	task.context[length] = '\0';
+	task.ns = ns;
+}
+
+std::string FlightRecorder::describe(const Cycle &cycle) {
+	std::string slowestTasks;
+	for (const auto &task : cycle.slowest) {
+		if (task.ns == 0) {
+			break;
+		}
+		if (!slowestTasks.empty()) {
+			slowestTasks += ", ";
+		}
+		slowestTasks += fmt::format("{} {:.2f} ms", task.context.data(), toMs(task.ns));
+	}
+
+	return fmt::format(
+		"cycle {} took {:.2f} ms (serial {:.2f} ms, parallel {:.2f} ms, scheduled {:.2f} ms), tasks: {} serial, {} parallel, {} walk, {} scheduled; slowest: {}",
+		cycle.id, toMs(cycle.durationNs),
+		toMs(cycle.phaseNs[static_cast<uint8_t>(Phase::Serial)]), toMs(cycle.phaseNs[static_cast<uint8_t>(Phase::Parallel)]), toMs(cycle.phaseNs[static_cast<uint8_t>(Phase::Scheduled)]),
+		cycle.tasks[static_cast<size_t>(TaskGroup::Serial)], cycle.tasks[static_cast<size_t>(TaskGroup::GenericParallel)], cycle.tasks[static_cast<size_t>(TaskGroup::Walk)], cycle.scheduledTasks,
+		slowestTasks.empty() ? "none" : slowestTasks
+	);
+}
+
+std::string FlightRecorder::getReport(size_t limit) const {
+	const size_t cycleCount = limit == 0 ? count : std::min(limit, count);
+	if (cycleCount == 0) {
+		return "No dispatcher cycle recorded.";
+	}
+
+	struct TaskEntry {
+		uint32_t times = 0;
+		int64_t totalNs = 0;
+		int64_t maxNs = 0;
+	};
+
+	int64_t totalNs = 0;
+	int64_t maxNs = 0;
+	const Cycle* slowestCycle = nullptr;
+	std::array<int64_t, static_cast<uint8_t>(Phase::Last)> phaseNs {};
+	std::array<uint64_t, GROUPS> tasks {};
+	uint64_t scheduledTasks = 0;
+	std::map<std::string, TaskEntry> slowTasks;
+	for (size_t i = 1; i <= cycleCount; ++i) {
+		const auto &cycle = cycles[(next + CYCLES - i) % CYCLES];
+		totalNs += cycle.durationNs;
+		if (!slowestCycle || cycle.durationNs > maxNs) {
+			maxNs = cycle.durationNs;
+			slowestCycle = &cycle;
+		}
+		for (size_t phase = 0; phase < phaseNs.size(); ++phase) {
+			phaseNs[phase] += cycle.phaseNs[phase];
+		}
+		for (size_t group = 0; group < GROUPS; ++group) {
+			tasks[group] += cycle.tasks[group];
+		}
+		scheduledTasks += cycle.scheduledTasks;
+		for (const auto &task : cycle.slowest) {
+			if (task.ns == 0) {
+				break;
+			}
+			auto &entry = slowTasks[task.context.data()];
+			++entry.times;
+			entry.totalNs += task.ns;
+			entry.maxNs = std::max(entry.maxNs, task.ns);
+		}
+	}
+
+	const auto percent = [totalNs](int64_t ns) {
+		return totalNs > 0 ? 100.0 * static_cast<double>(ns) / static_cast<double>(totalNs) : 0.0;
+	};
+
+	std::string report = fmt::format(
+		"Last {} cycles: {:.2f} ms on average, {:.2f} ms at most\nSerial {:.1f}%, parallel {:.1f}%, scheduled {:.1f}%\nTasks per cycle: {:.1f} serial, {:.1f} parallel, {:.1f} walk, {:.1f} scheduled\nSlowest cycle: {}\n\nSlowest tasks (times among the slowest, max ms, total ms):",
+		cycleCount, toMs(totalNs) / static_cast<double>(cycleCount), toMs(maxNs),
+		percent(phaseNs[static_cast<uint8_t>(Phase::Serial)]), percent(phaseNs[static_cast<uint8_t>(Phase::Parallel)]), percent(phaseNs[static_cast<uint8_t>(Phase::Scheduled)]),
+		static_cast<double>(tasks[static_cast<size_t>(TaskGroup::Serial)]) / cycleCount, static_cast<double>(tasks[static_cast<size_t>(TaskGroup::GenericParallel)]) / cycleCount,
+		static_cast<double>(tasks[static_cast<size_t>(TaskGroup::Walk)]) / cycleCount, static_cast<double>(scheduledTasks) / cycleCount,
+		describe(*slowestCycle)
+	);
+
+	std::vector<std::pair<std::string, TaskEntry>> sorted(slowTasks.begin(), slowTasks.end());
+	std::ranges::sort(sorted, [](const auto &a, const auto &b) {
+		return a.second.maxNs > b.second.maxNs;
+	});
+	for (size_t i = 0; i < sorted.size() && i < 20; ++i) {
+		const auto &[context, entry] = sorted[i];
+		report += fmt::format("\n{} - {}, {:.2f}, {:.2f}", context, entry.times, toMs(entry.maxNs), toMs(entry.totalNs));
+	}
+	return report;
+}
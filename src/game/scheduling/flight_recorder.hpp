@@ -0,0 +1,88 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+enum class TaskGroup : int8_t;
+
+/**
+ * Ring of the last dispatcher cycles: how long each took, how it was split
+ * between the serial, parallel and scheduled events, how many tasks of each
+ * group ran and which tasks were the slowest. A cycle slower than the
+ * dispatcherSlowCycleThreshold config is logged as it ends.
+ *
+ * Written and read only from the dispatcher thread, so it needs no lock;
+ * the scripts asking for the report run there too.
+ */
+class FlightRecorder {
+public:
+	enum class Phase : uint8_t {
+		Serial,
+		Parallel,
+		Scheduled,
+		Last
+	};
+
+	FlightRecorder() = default;
+
+	// Ensures that we don't accidentally copy it
+	FlightRecorder(const FlightRecorder &) = delete;
+	FlightRecorder &operator=(const FlightRecorder &) = delete;
+
+	static int64_t now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void beginCycle();
+	// Keeps the cycle if it ran anything, and logs it when it took too long. Returns its duration, 0 when not kept
+	int64_t endCycle();
+
+	void addPhase(Phase phase, int64_t startNs) {
+		current.phaseNs[static_cast<uint8_t>(phase)] += now() - startNs;
+	}
+	void addTasks(TaskGroup group, size_t count);
+	void addTask(std::string_view context, int64_t startNs, bool scheduled);
+
+	/**
+	 * @brief Summarizes the last cycles: their duration, the split between the phases and the slowest tasks.
+	 * @param limit Maximum number of cycles, 0 for all the recorded ones.
+	 */
+	std::string getReport(size_t limit) const;
+
+private:
+	static constexpr size_t CYCLES = 512;
+	static constexpr size_t SLOWEST_TASKS = 3;
+	// TaskGroup::Serial, GenericParallel and Walk
+	static constexpr size_t GROUPS = 3;
+
+	struct SlowTask {
+		// Copied, the context of a finished task may not outlive it
+		std::array<char, 64> context {};
+		int64_t ns = 0;
+	};
+
+	struct Cycle {
+		uint64_t id = 0;
+		int64_t startMs = 0;
+		int64_t startNs = 0;
+		int64_t durationNs = 0;
+		std::array<int64_t, static_cast<uint8_t>(Phase::Last)> phaseNs {};
+		std::array<uint32_t, GROUPS> tasks {};
+		uint32_t scheduledTasks = 0;
+		std::array<SlowTask, SLOWEST_TASKS> slowest {};
+	};
+
+	static std::string describe(const Cycle &cycle);
+
+	std::array<Cycle, CYCLES> cycles;
+	size_t next = 0;
+	size_t count = 0;
+	uint64_t lastId = 0;
+	Cycle current;
+};
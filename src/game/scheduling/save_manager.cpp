@@ -3,15 +3,19 @@
 #include "game/game.hpp"
 #include "game/scheduling/save_manager.hpp"
 #include "io/iologindata.hpp"
+#include "io/iomapserialize.hpp"
 
-SaveManager::SaveManager(ThreadPool &threadPool, KVStore &kvStore, Logger &logger, Game &game) :
-	threadPool(threadPool), kv(kvStore), logger(logger), game(game) { }
+SaveManager::SaveManager(ThreadPool &threadPool, KVStore &kvStore, Logger &logger, Game &game, IOJournal &journal) :
+	threadPool(threadPool), kv(kvStore), logger(logger), game(game), journal(journal) { }
 
 SaveManager &SaveManager::getInstance() {
 	return inject<SaveManager>();
 }
 
 void SaveManager::saveAll() {
+	// Batches still queued by async saves must land before the live state is written over them
+	flushWrites();
+
 	Benchmark bm_saveAll;
 	logger.info("Saving server...");
 	const auto players = game.getPlayers();
@@ -32,22 +36,69 @@ void SaveManager::saveAll() {
 }
 
 void SaveManager::scheduleAll() {
-	auto scheduledAt = std::chrono::steady_clock::now();
-	m_scheduledAt = scheduledAt;
-
 	// Disable save async if the config is set to false
 	if (!g_configManager().getBoolean(TOGGLE_SAVE_ASYNC, __FUNCTION__)) {
 		saveAll();
 		return;
 	}
 
-	threadPool.detach_task([this, scheduledAt]() {
-		if (m_scheduledAt.load() != scheduledAt) {
-			logger.warn("Skipping save for server because another save has been scheduled.");
-			return;
+	Benchmark bm_snapshot;
+	logger.info("Saving server...");
+
+	struct PlayerBatch {
+		std::weak_ptr<Player> player;
+		std::string name;
+		DBQueryBatch batch;
+	};
+
+	auto playerBatches = std::make_shared<std::vector<PlayerBatch>>();
+	const auto players = game.getPlayers();
+	playerBatches->reserve(players.size());
+	for (const auto &[_, player] : players) {
+		player->loginPosition = player->getPosition();
+		auto &playerBatch = playerBatches->emplace_back(PlayerBatch { player, player->getName() });
+		snapshotPlayer(player, playerBatch.batch);
+	}
+
+	auto worldBatch = std::make_shared<DBQueryBatch>();
+	{
+		DBQueryBatch::Capture capture(*worldBatch);
+		for (const auto &[_, guild] : game.getGuilds()) {
+			saveGuild(guild);
 		}
-		saveAll();
-	});
+	}
+
+	auto housesSave = std::make_shared<IOMapSerialize::HouseItemsSave>();
+	if (!IOMapSerialize::saveHousesToBatch(*worldBatch, *housesSave)) {
+		logger.error("Failed to save map.");
+	}
+
+	logger.info("Server snapshot taken in {} milliseconds, writing it in the background.", bm_snapshot.duration());
+
+	std::vector<const DBQueryBatch*> journaled;
+	journaled.reserve(playerBatches->size() + 1);
+	for (const auto &playerBatch : *playerBatches) {
+		journaled.emplace_back(&playerBatch.batch);
+	}
+	journaled.emplace_back(worldBatch.get());
+
+	enqueueWrite([this, playerBatches, worldBatch, housesSave]() {
+		Benchmark bm_write;
+		for (const auto &playerBatch : *playerBatches) {
+			writePlayerBatch(playerBatch.player, playerBatch.name, playerBatch.batch);
+		}
+
+		if (!worldBatch->execute()) {
+			logger.error("Failed to save guilds and map.");
+		} else {
+			// The houses stay unsaved on failure, the next save writes them again
+			g_dispatcher().addEvent([housesSave]() { IOMapSerialize::onHouseItemsSaved(*housesSave); }, "SaveManager::scheduleAll");
+		}
+
+		saveKV();
+		logger.info("Server saved in {} milliseconds.", bm_write.duration());
+	},
+	             journaled);
 }
 
 void SaveManager::schedulePlayer(std::weak_ptr<Player> playerPtr) {
@@ -67,20 +118,17 @@ void SaveManager::schedulePlayer(std::weak_ptr<Player> playerPtr) {
 	}
 
 	logger.debug("Scheduling player {} for saving.", playerToSave->getName());
-	auto scheduledAt = std::chrono::steady_clock::now();
-	m_playerMap[playerToSave->getGUID()] = scheduledAt;
-	threadPool.detach_task([this, playerPtr, scheduledAt]() {
-		auto player = playerPtr.lock();
-		if (!player) {
-			logger.debug("Skipping save for player because player is no longer online.");
-			return;
-		}
-		if (m_playerMap[player->getGUID()] != scheduledAt) {
-			logger.warn("Skipping save for player because another save has been scheduled.");
-			return;
-		}
-		doSavePlayer(player);
-	});
+	auto batch = std::make_shared<DBQueryBatch>();
+	if (!snapshotPlayer(playerToSave, *batch)) {
+		return;
+	}
+
+	enqueueWrite(
+		[this, playerPtr, name = playerToSave->getName(), batch]() {
+			writePlayerBatch(playerPtr, name, *batch);
+		},
+		{ batch.get() }
+	);
 }
 
 bool SaveManager::doSavePlayer(std::shared_ptr<Player> player) {
@@ -91,7 +139,6 @@ bool SaveManager::doSavePlayer(std::shared_ptr<Player> player) {
 
 	Benchmark bm_savePlayer;
 	Player::PlayerLock lock(player);
-	m_playerMap.erase(player->getGUID());
 	if (g_game().getGameState() == GAME_STATE_NORMAL) {
 		logger.debug("Saving player {}.", player->getName());
 	}
@@ -106,6 +153,83 @@ bool SaveManager::doSavePlayer(std::shared_ptr<Player> player) {
 	return saveSuccess;
 }
 
+bool SaveManager::snapshotPlayer(const std::shared_ptr<Player> &player, DBQueryBatch &batch) {
+	Benchmark bm_snapshot;
+	Player::PlayerLock lock(player);
+	bool snapshotSuccess = IOLoginData::savePlayerToBatch(player, batch);
+	if (!snapshotSuccess) {
+		logger.error("Failed to save player {}.", player->getName());
+	}
+
+	logger.debug("Snapshot of player {} took {} milliseconds, {} queries.", player->getName(), bm_snapshot.duration(), batch.size());
+	return snapshotSuccess;
+}
+
+void SaveManager::writePlayerBatch(const std::weak_ptr<Player> &player, const std::string &name, const DBQueryBatch &batch) {
+	if (batch.empty() || batch.execute()) {
+		return;
+	}
+
+	logger.error("Failed to save player {}.", name);
+	// The player remembers the rows of this batch as stored, make its next save rewrite them
+	g_dispatcher().addEvent(
+		[player]() {
+			if (const auto &failedPlayer = player.lock()) {
+				failedPlayer->resetPersistedRows();
+			}
+		},
+		"SaveManager::writePlayerBatch"
+	);
+}
+
+void SaveManager::enqueueWrite(std::function<void()> &&write, const std::vector<const DBQueryBatch*> &journaled /* = {}*/) {
+	std::scoped_lock lock(m_pendingWritesMutex);
+	for (const auto* batch : journaled) {
+		journal.append(*batch);
+	}
+	m_pendingWrites.emplace_back(std::move(write));
+	if (!m_writerScheduled) {
+		m_writerScheduled = true;
+		threadPool.detach_task([this]() {
+			flushWrites();
+		});
+	}
+}
+
+void SaveManager::flushWrites() {
+	// A single writer at a time keeps the batches in capture order
+	std::scoped_lock writerLock(m_writerMutex);
+	while (true) {
+		std::function<void()> write;
+		{
+			std::scoped_lock lock(m_pendingWritesMutex);
+			if (m_pendingWrites.empty()) {
+				// Every journaled batch is in the database, and none can be appended while the queue is locked
+				journal.checkpoint();
+				m_writerScheduled = false;
+				return;
+			}
+			write = std::move(m_pendingWrites.front());
+			m_pendingWrites.pop_front();
+		}
+
+		// On disk before the database sees it, along with every batch queued since the last sync
+		journal.sync();
+		write();
+	}
+}
+
+void SaveManager::journalPlayers() {
+	const auto interval = static_cast<uint32_t>(std::max<int32_t>(1, g_configManager().getNumber(SAVE_JOURNAL_PLAYERS_INTERVAL, __FUNCTION__)));
+	const uint32_t turn = journalTick++ % interval;
+	for (const auto &[_, player] : game.getPlayers()) {
+		// Spread over the interval, a few players per second
+		if (player->getGUID() % interval == turn) {
+			schedulePlayer(player);
+		}
+	}
+}
+
 bool SaveManager::savePlayer(std::shared_ptr<Player> player) {
 	if (player->isOnline()) {
 		schedulePlayer(player);
@@ -140,6 +264,13 @@ void SaveManager::saveMap() {
 	logger.debug("Map saved in {} milliseconds.", duration);
 }
 
+void SaveManager::scheduleKV() {
+	// Behind any pending save, so it never overtakes an older write
+	enqueueWrite([this]() {
+		saveKV();
+	});
+}
+
 void SaveManager::saveKV() {
 	Benchmark bm_saveKV;
 	logger.debug("Saving key-value store...");
@@ -11,10 +11,13 @@
 
 #include "lib/thread/thread_pool.hpp"
 #include "kv/kv.hpp"
+#include "io/iojournal.hpp"
+
+class DBQueryBatch;
 
 class SaveManager {
 public:
-	explicit SaveManager(ThreadPool &threadPool, KVStore &kvStore, Logger &logger, Game &game);
+	explicit SaveManager(ThreadPool &threadPool, KVStore &kvStore, Logger &logger, Game &game, IOJournal &journal);
 
 	SaveManager(const SaveManager &) = delete;
 	void operator=(const SaveManager &) = delete;
@@ -23,10 +26,20 @@ public:
 
 	void saveAll();
 	void scheduleAll();
+	/**
+	 * @brief Flushes the changed key-value entries on the background writer.
+	 */
+	void scheduleKV();
 
 	bool savePlayer(std::shared_ptr<Player> player);
 	void saveGuild(std::shared_ptr<Guild> guild);
 
+	/**
+	 * @brief Queues the journaled save of the online players whose turn it is, each one every saveJournalPlayersInterval seconds.
+	 * Runs every second while the journal is open.
+	 */
+	void journalPlayers();
+
 private:
 	void saveMap();
 	void saveKV();
@@ -34,13 +47,27 @@ private:
 	void schedulePlayer(std::weak_ptr<Player> player);
 	bool doSavePlayer(std::shared_ptr<Player> player);
 
-	std::atomic<std::chrono::steady_clock::time_point> m_scheduledAt;
-	phmap::parallel_flat_hash_map<uint32_t, std::chrono::steady_clock::time_point> m_playerMap;
+	/**
+	 * Async saves are captured on the dispatcher into query batches, then
+	 * written by a single background writer in the order they were captured.
+	 */
+	bool snapshotPlayer(const std::shared_ptr<Player> &player, DBQueryBatch &batch);
+	void writePlayerBatch(const std::weak_ptr<Player> &player, const std::string &name, const DBQueryBatch &batch);
+	// The batches are journaled in the order their write is queued
+	void enqueueWrite(std::function<void()> &&write, const std::vector<const DBQueryBatch*> &journaled = {});
+	void flushWrites();
+
+	std::mutex m_pendingWritesMutex;
+	std::deque<std::function<void()>> m_pendingWrites;
+	bool m_writerScheduled = false;
+	std::mutex m_writerMutex;
 
 	ThreadPool &threadPool;
 	KVStore &kv;
 	Logger &logger;
 	Game &game;
+	IOJournal &journal;
+	uint32_t journalTick = 0;
 };
 
 constexpr auto g_saveManager = SaveManager::getInstance;
@@ -16,8 +16,9 @@
 
 std::atomic_uint_fast64_t Task::LAST_EVENT_ID = 0;
 
-Task::Task(uint32_t expiresAfterMs, std::function<void(void)> &&f, std::string_view context) :
+Task::Task(uint32_t expiresAfterMs, TaskCallback &&f, std::string_view context) :
 	func(std::move(f)), context(context), utime(OTSYS_TIME()), expiration(expiresAfterMs > 0 ? OTSYS_TIME() + expiresAfterMs : 0) {
+	countHeapFallback();
 	if (this->context.empty()) {
 		g_logger().error("[{}]: task context cannot be empty!", __FUNCTION__);
 		return;
@@ -26,8 +27,9 @@ Task::Task(uint32_t expiresAfterMs, std::function<void(void)> &&f, std::string_v
 	assert(!this->context.empty() && "Context cannot be empty!");
 }
 
-Task::Task(std::function<void(void)> &&f, std::string_view context, uint32_t delay, bool cycle /* = false*/, bool log /*= true*/) :
+Task::Task(TaskCallback &&f, std::string_view context, uint32_t delay, bool cycle /* = false*/, bool log /*= true*/) :
 	func(std::move(f)), context(context), utime(OTSYS_TIME() + delay), delay(delay), cycle(cycle), log(log) {
+	countHeapFallback();
 	if (this->context.empty()) {
 		g_logger().error("[{}]: task context cannot be empty!", __FUNCTION__);
 		return;
@@ -36,6 +38,19 @@ Task::Task(std::function<void(void)> &&f, std::string_view context, uint32_t del
 	assert(!this->context.empty() && "Context cannot be empty!");
 }
 
+void Task::countHeapFallback() const {
+	if (func.isHeapAllocated()) {
+		g_metrics().addCounter("task_callback_heap_fallback", 1, { { "task", context } });
+	}
+}
+
+void Task::onExpired() const {
+	// A client flooding or the dispatcher falling behind expires many at once
+	static LogRateLimiter expiredLogs;
+	g_metrics().addCounter("dispatcher_task_expired", 1, { { "task", context } });
+	g_logger().warn(expiredLogs, "The task '{}' has expired, it has not been executed in {}.", getContext(), expiration - utime);
+}
+
 bool Task::execute() const {
 	metrics::task_latency measure(context);
 	if (isCanceled()) {
@@ -43,7 +58,7 @@ bool Task::execute() const {
 	}
 
 	if (hasExpired()) {
-		g_logger().info("The task '{}' has expired, it has not been executed in {}.", getContext(), expiration - utime);
+		onExpired();
 		return false;
 	}
 
@@ -11,14 +11,205 @@
 #include "utils/tools.hpp"
 #include <unordered_set>
 
-class Task {
+/**
+ * Move-only void() callable with inline storage sized for the dispatcher captures.
+ * Callables that do not fit fall back to the heap and are counted (see Task constructor),
+ * so INLINE_SIZE can be tuned from the "task_callback_heap_fallback" metric.
+ */
+class TaskCallback {
 public:
-	Task(uint32_t expiresAfterMs, std::function<void(void)> &&f, std::string_view context);
+	static constexpr size_t INLINE_SIZE = 112;
+
+	TaskCallback() noexcept = default;
+	TaskCallback(std::nullptr_t) noexcept { }
+
+	template <typename F, typename Fn = std::decay_t<F>>
+		requires(!std::is_same_v<Fn, TaskCallback> && std::is_invocable_r_v<void, Fn &>)
+	TaskCallback(F &&f) {
+		if constexpr (std::is_same_v<Fn, std::function<void(void)>>) {
+			if (!f) {
+				return;
+			}
+		}
+
+		if constexpr (fitsInline<Fn>) {
+			new (storage) Fn(std::forward<F>(f));
+			ops = &inlineOps<Fn>;
+		} else {
+			*reinterpret_cast<Fn**>(storage) = new Fn(std::forward<F>(f));
+			ops = &heapOps<Fn>;
+		}
+	}
+
+	TaskCallback(TaskCallback &&other) noexcept {
+		moveFrom(other);
+	}
+
+	TaskCallback &operator=(TaskCallback &&other) noexcept {
+		if (this != &other) {
+			reset();
+			moveFrom(other);
+		}
+		return *this;
+	}
+
+	TaskCallback &operator=(std::nullptr_t) noexcept {
+		reset();
+		return *this;
+	}
+
+	TaskCallback(const TaskCallback &) = delete;
+	TaskCallback &operator=(const TaskCallback &) = delete;
 
-	Task(std::function<void(void)> &&f, std::string_view context, uint32_t delay, bool cycle = false, bool log = true);
+	~TaskCallback() {
+		reset();
+	}
+
+	void operator()() const {
+		ops->invoke(storage);
+	}
+
+	explicit operator bool() const noexcept {
+		return ops != nullptr;
+	}
+
+	friend bool operator==(const TaskCallback &callback, std::nullptr_t) noexcept {
+		return callback.ops == nullptr;
+	}
+
+	bool isHeapAllocated() const noexcept {
+		return ops != nullptr && ops->heap;
+	}
+
+private:
+	struct Ops {
+		void (*invoke)(void* storage);
+		void (*move)(void* to, void* from);
+		void (*destroy)(void* storage);
+		bool heap;
+	};
+
+	template <typename Fn>
+	static constexpr bool fitsInline = sizeof(Fn) <= INLINE_SIZE && alignof(Fn) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Fn>;
+
+	template <typename Fn>
+	static constexpr Ops inlineOps {
+		[](void* storage) { (*std::launder(static_cast<Fn*>(storage)))(); },
+		[](void* to, void* from) {
+			auto* fn = std::launder(static_cast<Fn*>(from));
+			new (to) Fn(std::move(*fn));
+			fn->~Fn();
+		},
+		[](void* storage) { std::launder(static_cast<Fn*>(storage))->~Fn(); },
+		false
+	};
+
+	template <typename Fn>
+	static constexpr Ops heapOps {
+		[](void* storage) { (**static_cast<Fn**>(storage))(); },
+		[](void* to, void* from) { *static_cast<Fn**>(to) = *static_cast<Fn**>(from); },
+		[](void* storage) { delete *static_cast<Fn**>(storage); },
+		true
+	};
+
+	void moveFrom(TaskCallback &other) noexcept {
+		if (other.ops) {
+			other.ops->move(storage, other.storage);
+			ops = std::exchange(other.ops, nullptr);
+		}
+	}
+
+	void reset() noexcept {
+		if (ops) {
+			ops->destroy(storage);
+			ops = nullptr;
+		}
+	}
+
+	alignas(std::max_align_t) mutable unsigned char storage[INLINE_SIZE];
+	const Ops* ops = nullptr;
+};
+
+/**
+ * Allocator used for the shared scheduled tasks, it keeps a bounded free list per thread
+ * so the dispatcher reuses the blocks of the tasks it has just executed.
+ */
+template <typename T>
+struct TaskPoolAllocator {
+	using value_type = T;
+
+	static constexpr size_t MAX_FREE_BLOCKS = 4096;
+
+	TaskPoolAllocator() noexcept = default;
+
+	template <typename U>
+	TaskPoolAllocator(const TaskPoolAllocator<U> &) noexcept { }
+
+	T* allocate(size_t n) {
+		if (n == 1) {
+			auto &freeList = getFreeList();
+			if (!freeList.blocks.empty()) {
+				auto* block = freeList.blocks.back();
+				freeList.blocks.pop_back();
+				return static_cast<T*>(block);
+			}
+		}
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T* block, size_t n) noexcept {
+		if (n == 1) {
+			auto &freeList = getFreeList();
+			if (freeList.blocks.size() < MAX_FREE_BLOCKS) {
+				freeList.blocks.emplace_back(block);
+				return;
+			}
+		}
+		::operator delete(block);
+	}
+
+	template <typename U>
+	bool operator==(const TaskPoolAllocator<U> &) const noexcept {
+		return true;
+	}
+
+private:
+	struct FreeList {
+		FreeList() {
+			blocks.reserve(MAX_FREE_BLOCKS);
+		}
+
+		~FreeList() {
+			for (auto* block : blocks) {
+				::operator delete(block);
+			}
+		}
+
+		std::vector<void*> blocks;
+	};
+
+	static FreeList &getFreeList() {
+		thread_local FreeList freeList;
+		return freeList;
+	}
+};
+
+class Task : private MemoryTracked<Task, MemoryCategory::DispatcherTasks> {
+public:
+	Task(uint32_t expiresAfterMs, TaskCallback &&f, std::string_view context);
+
+	Task(TaskCallback &&f, std::string_view context, uint32_t delay, bool cycle = false, bool log = true);
+
+	template <typename... Args>
+	static std::shared_ptr<Task> makeShared(Args &&... args) {
+		return std::allocate_shared<Task>(TaskPoolAllocator<Task>(), std::forward<Args>(args)...);
+	}
 
 	~Task() = default;
 
+	Task(Task &&) noexcept = default;
+	Task &operator=(Task &&) noexcept = default;
+
 	uint64_t getId() {
 		if (id == 0) {
 			if (++LAST_EVENT_ID == 0) {
@@ -61,7 +252,12 @@ public:
 
 	bool execute() const;
 
+	// Counts and reports an expired task, dropped before it ran
+	void onExpired() const;
+
 private:
+	void countHeapFallback() const;
+
 	static std::atomic_uint_fast64_t LAST_EVENT_ID;
 
 	void updateTime() {
@@ -86,7 +282,7 @@ private:
 		                                                                        "OutputMessagePool::sendAll",
 		                                                                        "ProtocolGame::addGameTask",
 		                                                                        "ProtocolGame::parsePacketFromDispatcher",
-		                                                                        "Raids::checkRaids",
+		                                                                        "Raids::startScheduledRaid",
 		                                                                        "SpawnMonster::checkSpawnMonster",
 		                                                                        "SpawnMonster::scheduleSpawn",
 		                                                                        "SpawnMonster::startup",
@@ -103,7 +299,7 @@ private:
 		}
 	};
 
-	std::function<void(void)> func = nullptr;
+	TaskCallback func;
 	std::string context;
 
 	int64_t utime = 0;
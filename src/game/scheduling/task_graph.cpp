@@ -0,0 +1,131 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/scheduling/task_graph.hpp"
+
+TaskGraph::Node TaskGraph::add(std::initializer_list<Node> after, std::function<void()> &&f, bool serial) {
+	const auto node = static_cast<Node>(nodes.size());
+	auto &entry = nodes.emplace_back();
+	entry.task = std::move(f);
+	entry.serial = serial;
+	for (const auto previous : after) {
+		if (previous < node) {
+			nodes[previous].next.emplace_back(node);
+			++entry.pending;
+		}
+	}
+	if (!serial) {
+		++parallelNodes;
+	}
+	return node;
+}
+
+void TaskGraph::join() {
+	if (nodes.empty()) {
+		return;
+	}
+
+	auto &dispatcher = g_dispatcher();
+	const bool nested = dispatcher.asyncWaitDisabled;
+
+	const auto run = std::make_shared<Run>(std::move(nodes), group);
+	run->unfinished = static_cast<uint32_t>(run->nodes.size());
+	run->unfinishedParallel = parallelNodes;
+	for (Node node = 0; node < run->nodes.size(); ++node) {
+		if (run->nodes[node].pending == 0) {
+			(run->nodes[node].serial ? run->serialReady : run->ready).emplace_back(node);
+		}
+	}
+
+	if (!nested) {
+		// Nested async waits run inline, the pool threads are busy with this graph
+		dispatcher.asyncWaitDisabled = true;
+		const auto threadCount = static_cast<uint32_t>(dispatcher.threadPool.get_thread_count());
+		const auto helpers = parallelNodes > 1 ? std::min(threadCount, parallelNodes - 1) : 0;
+		for (uint32_t i = 0; i < helpers; ++i) {
+			dispatcher.threadPool.detach_task([run] { run->work(false); });
+		}
+	}
+
+	run->work(true);
+
+	if (!nested) {
+		dispatcher.asyncWaitDisabled = false;
+	}
+
+	nodes.clear();
+	parallelNodes = 0;
+	if (run->failure) {
+		std::rethrow_exception(run->failure);
+	}
+}
+
+void TaskGraph::Run::work(bool joining) {
+	const auto callerContext = Dispatcher::dispacherContext;
+	std::unique_lock lock(mutex);
+	while (true) {
+		Node node;
+		if (joining && !serialReady.empty()) {
+			node = serialReady.front();
+			serialReady.pop_front();
+		} else if (!ready.empty()) {
+			node = ready.front();
+			ready.pop_front();
+		} else if (joining ? unfinished == 0 : unfinishedParallel == 0) {
+			break;
+		} else {
+			signal.wait(lock);
+			continue;
+		}
+
+		auto &entry = nodes[node];
+		if (!failure) {
+			lock.unlock();
+			if (entry.serial) {
+				Dispatcher::dispacherContext = callerContext;
+			} else {
+				Dispatcher::dispacherContext.type = DispatcherType::AsyncEvent;
+				Dispatcher::dispacherContext.group = group;
+			}
+			std::exception_ptr exception;
+			try {
+				entry.task();
+			} catch (...) {
+				exception = std::current_exception();
+			}
+			lock.lock();
+			if (exception && !failure) {
+				failure = exception;
+			}
+		}
+		finish(node);
+	}
+
+	if (joining) {
+		Dispatcher::dispacherContext = callerContext;
+	} else {
+		Dispatcher::dispacherContext.reset();
+	}
+}
+
+void TaskGraph::Run::finish(Node node) {
+	const auto &entry = nodes[node];
+	--unfinished;
+	if (!entry.serial) {
+		--unfinishedParallel;
+	}
+	for (const auto next : entry.next) {
+		if (--nodes[next].pending == 0) {
+			(nodes[next].serial ? serialReady : ready).emplace_back(next);
+		}
+	}
+	signal.notify_all();
+}
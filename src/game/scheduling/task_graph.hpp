@@ -0,0 +1,96 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/scheduling/dispatcher.hpp"
+
+/**
+ * Tasks with dependencies between them, run on the thread pool by join.
+ *
+ * A task starts once every task it continues has finished. The tasks added
+ * with continueSerial only run on the thread calling join, so they can touch
+ * game state, e.g. targets computed in parallel and then applied; the others
+ * run in an async dispatcher context of the given group.
+ *
+ * The ready tasks are kept in one queue shared by the joining thread and the
+ * pool workers helping it, so whichever of them is idle takes the next one.
+ * Inside another async wait or graph the tasks run inline, in order.
+ */
+class TaskGraph {
+public:
+	using Node = uint32_t;
+
+	explicit TaskGraph(TaskGroup group = TaskGroup::GenericParallel) :
+		group(group) { }
+
+	// Ensures that we don't accidentally copy it
+	TaskGraph(const TaskGraph &) = delete;
+	TaskGraph &operator=(const TaskGraph &) = delete;
+
+	Node spawn(std::function<void()> &&f) {
+		return add({}, std::move(f), false);
+	}
+
+	Node continueWith(std::initializer_list<Node> after, std::function<void()> &&f) {
+		return add(after, std::move(f), false);
+	}
+
+	Node continueSerial(std::initializer_list<Node> after, std::function<void()> &&f) {
+		return add(after, std::move(f), true);
+	}
+
+	size_t size() const {
+		return nodes.size();
+	}
+
+	/**
+	 * @brief Runs every task and waits for them, the graph is empty afterwards.
+	 *
+	 * After a task throws, the tasks not started yet are skipped and the first
+	 * exception is rethrown here.
+	 */
+	void join();
+
+private:
+	struct Entry {
+		std::function<void()> task;
+		std::vector<Node> next;
+		uint32_t pending = 0;
+		bool serial = false;
+	};
+
+	// State of a join, shared with the helpers since those queued after the last task may only start after join returned
+	struct Run {
+		explicit Run(std::vector<Entry> &&nodes, TaskGroup group) :
+			nodes(std::move(nodes)), group(group) { }
+
+		// Runs tasks until none is left for this thread
+		void work(bool joining);
+		void finish(Node node);
+
+		std::vector<Entry> nodes;
+		TaskGroup group;
+
+		// Guarded by the mutex
+		std::mutex mutex;
+		std::condition_variable signal;
+		std::deque<Node> ready;
+		std::deque<Node> serialReady;
+		uint32_t unfinished = 0;
+		uint32_t unfinishedParallel = 0;
+		std::exception_ptr failure;
+	};
+
+	Node add(std::initializer_list<Node> after, std::function<void()> &&f, bool serial);
+
+	TaskGroup group;
+	std::vector<Entry> nodes;
+	uint32_t parallelNodes = 0;
+};
@@ -0,0 +1,104 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/scheduling/tick_governor.hpp"
+#include "config/configmanager.hpp"
+#include "lib/logging/log_with_spd_log.hpp"
+#include "lib/metrics/metrics.hpp"
+
+std::string_view TickGovernor::getName(Degradation degradation) {
+	switch (degradation) {
+		case Degradation::IdleThink:
+			return "idle_think";
+		case Degradation::LowPriorityPackets:
+			return "low_priority_packets";
+		case Degradation::CosmeticEffects:
+			return "cosmetic_effects";
+		case Degradation::Batches:
+			return "batches";
+		default:
+			return "unknown";
+	}
+}
+
+void TickGovernor::addCycle(int64_t durationNs) {
+	const int64_t nowMs = OTSYS_TIME();
+	samples[next] = { nowMs, durationNs };
+	next = (next + 1) % SAMPLES;
+
+	if (nowMs >= nextEvaluationMs) {
+		nextEvaluationMs = nowMs + EVALUATION_INTERVAL_MS;
+		evaluate(nowMs);
+	}
+}
+
+void TickGovernor::evaluate(int64_t nowMs) {
+	const int64_t targetNs = static_cast<int64_t>(g_configManager().getNumber(DISPATCHER_LATENCY_TARGET, __FUNCTION__)) * 1000000;
+	if (targetNs <= 0) {
+		setLevel(0, 0, 0);
+		return;
+	}
+
+	window.clear();
+	for (const auto &[timeMs, durationNs] : samples) {
+		if (timeMs != 0 && nowMs - timeMs < WINDOW_MS) {
+			window.emplace_back(durationNs);
+		}
+	}
+
+	int64_t p99Ns = 0;
+	if (window.size() >= MIN_SAMPLES) {
+		const auto p99 = window.begin() + static_cast<std::ptrdiff_t>(window.size() * 99 / 100);
+		std::ranges::nth_element(window, p99);
+		p99Ns = *p99;
+	}
+
+	const auto p99Us = p99Ns / 1000;
+	if (p99Us != exportedP99Us) {
+		g_metrics().addUpDownCounter("tick_governor_p99_us", static_cast<int>(p99Us - exportedP99Us));
+		exportedP99Us = p99Us;
+	}
+
+	if (p99Ns > targetNs) {
+		healthyEvaluations = 0;
+		if (level < static_cast<uint8_t>(Degradation::Last)) {
+			setLevel(level + 1, p99Ns, targetNs);
+		}
+		return;
+	}
+
+	// Between the recovery threshold and the target the degradations hold, disabling one would bring the lag back
+	if (p99Ns * 100 > targetNs * RECOVERY_PERCENT) {
+		healthyEvaluations = 0;
+		return;
+	}
+
+	if (level > 0 && ++healthyEvaluations >= RECOVERY_EVALUATIONS) {
+		healthyEvaluations = 0;
+		setLevel(level - 1, p99Ns, targetNs);
+	}
+}
+
+void TickGovernor::setLevel(uint8_t newLevel, int64_t p99Ns, int64_t targetNs) {
+	while (level < newLevel) {
+		const auto name = getName(static_cast<Degradation>(level++));
+		const std::map<std::string, std::string> attrs = { { "degradation", std::string(name) } };
+		g_metrics().addUpDownCounter("tick_governor_degradations", 1, attrs);
+		g_metrics().addCounter("tick_governor_triggers", 1, attrs);
+		g_logger().warn("[TickGovernor] - Dispatcher cycles p99 of {:.2f} ms over the target of {} ms, enabling {}", p99Ns / 1000000.0, targetNs / 1000000, name);
+	}
+
+	while (level > newLevel) {
+		const auto name = getName(static_cast<Degradation>(--level));
+		g_metrics().addUpDownCounter("tick_governor_degradations", -1, { { "degradation", std::string(name) } });
+		g_logger().info("[TickGovernor] - Dispatcher cycles p99 of {:.2f} ms back under the target, disabling {}", p99Ns / 1000000.0, name);
+	}
+}
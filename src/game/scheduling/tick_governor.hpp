@@ -0,0 +1,75 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Keeps the p99 of the dispatcher cycles under the dispatcherLatencyTarget
+ * config. Once a second the cycles of the last seconds are checked: over the
+ * target the next degradation is enabled, one at a time, and they are
+ * disabled again in the reverse order once the cycles stay well under it.
+ *
+ * Fed and read only from the dispatcher thread, so it needs no lock.
+ */
+class TickGovernor {
+public:
+	// In the order they are enabled, the cheapest for the players first
+	enum class Degradation : uint8_t {
+		// The idle and unseen monsters think less often
+		IdleThink,
+		// The bulk packets wait in their buffers
+		LowPriorityPackets,
+		// The sound effects are not sent
+		CosmeticEffects,
+		// The decay and the map clean steps are postponed
+		Batches,
+		Last
+	};
+
+	TickGovernor() = default;
+
+	// Ensures that we don't accidentally copy it
+	TickGovernor(const TickGovernor &) = delete;
+	TickGovernor &operator=(const TickGovernor &) = delete;
+
+	bool isActive(Degradation degradation) const {
+		return level > static_cast<uint8_t>(degradation);
+	}
+
+	// Adds the duration of a cycle that ran something, and checks the last ones when it is time
+	void addCycle(int64_t durationNs);
+
+private:
+	static constexpr size_t SAMPLES = 1024;
+	static constexpr int64_t EVALUATION_INTERVAL_MS = 1000;
+	static constexpr int64_t WINDOW_MS = 5000;
+	// Fewer cycles than this in the window say little, and a quiet server is not lagging
+	static constexpr size_t MIN_SAMPLES = 32;
+	// Under this percent of the target the cycles are healthy, and after this many healthy checks a degradation is disabled
+	static constexpr int64_t RECOVERY_PERCENT = 75;
+	static constexpr uint32_t RECOVERY_EVALUATIONS = 5;
+
+	struct Sample {
+		int64_t timeMs = 0;
+		int64_t durationNs = 0;
+	};
+
+	static std::string_view getName(Degradation degradation);
+
+	void evaluate(int64_t nowMs);
+	void setLevel(uint8_t newLevel, int64_t p99Ns, int64_t targetNs);
+
+	std::array<Sample, SAMPLES> samples;
+	size_t next = 0;
+	std::vector<int64_t> window;
+	int64_t nextEvaluationMs = 0;
+	int64_t exportedP99Us = 0;
+	uint32_t healthyEvaluations = 0;
+	uint8_t level = 0;
+};
@@ -0,0 +1,154 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/scheduling/timing_wheel.hpp"
+#include "game/scheduling/task.hpp"
+
+void TimingWheel::insert(const std::shared_ptr<Task> &task, int64_t now) {
+	if (count == 0) {
+		// Nothing is pending, so the wheel can jump straight to the present
+		currentTick = std::max<uint64_t>(currentTick, static_cast<uint64_t>(std::max<int64_t>(now, 0)) / tickMs + 1);
+	}
+
+	place(allocNode(task));
+	++count;
+}
+
+void TimingWheel::advance(int64_t now, std::vector<std::shared_ptr<Task>> &expired) {
+	const uint64_t nowTick = static_cast<uint64_t>(std::max<int64_t>(now, 0)) / tickMs;
+	if (count == 0) {
+		currentTick = std::max<uint64_t>(currentTick, nowTick + 1);
+		return;
+	}
+
+	const size_t firstExpired = expired.size();
+	drain(ready, expired);
+
+	while (count > 0 && currentTick <= nowTick) {
+		// When a level wraps, the next bucket of the level above is spread over the lower levels
+		for (uint32_t level = 1; level < LEVELS; ++level) {
+			if (((currentTick >> (SLOT_BITS * (level - 1))) & SLOT_MASK) != 0) {
+				break;
+			}
+			cascade(level);
+		}
+
+		drain(levels[0][currentTick & SLOT_MASK], expired);
+		++currentTick;
+	}
+
+	if (count == 0) {
+		currentTick = std::max<uint64_t>(currentTick, nowTick + 1);
+	}
+
+	// Tasks sharing a tick can come from different levels, keep them in time order like the ordered set did
+	std::stable_sort(expired.begin() + firstExpired, expired.end(), [](const std::shared_ptr<Task> &a, const std::shared_ptr<Task> &b) {
+		return a->getTime() < b->getTime();
+	});
+}
+
+std::chrono::milliseconds TimingWheel::timeUntilNextTick(int64_t now) const {
+	if (count == 0) {
+		return std::chrono::milliseconds::max();
+	}
+
+	if (!ready.empty()) {
+		return std::chrono::milliseconds(0);
+	}
+
+	uint64_t tick = currentTick;
+	for (uint32_t i = 0; i < SLOTS; ++i, ++tick) {
+		// Stop at the next cascade or at the first pending bucket, the wheel must be revisited there anyway
+		if ((tick & SLOT_MASK) == 0 || !levels[0][tick & SLOT_MASK].empty()) {
+			break;
+		}
+	}
+
+	const auto remaining = static_cast<int64_t>(tick * tickMs) - now;
+	return std::chrono::milliseconds(std::max<int64_t>(remaining, 0));
+}
+
+uint32_t TimingWheel::allocNode(const std::shared_ptr<Task> &task) {
+	uint32_t index;
+	if (freeNodes.empty()) {
+		index = static_cast<uint32_t>(nodes.size());
+		nodes.emplace_back();
+	} else {
+		index = freeNodes.back();
+		freeNodes.pop_back();
+	}
+
+	auto &node = nodes[index];
+	node.task = task;
+	node.next = INVALID_NODE;
+	return index;
+}
+
+void TimingWheel::releaseNode(uint32_t index) {
+	nodes[index].task.reset();
+	freeNodes.emplace_back(index);
+}
+
+void TimingWheel::append(Bucket &bucket, uint32_t index) {
+	nodes[index].next = INVALID_NODE;
+	if (bucket.empty()) {
+		bucket.head = index;
+	} else {
+		nodes[bucket.tail].next = index;
+	}
+	bucket.tail = index;
+}
+
+void TimingWheel::place(uint32_t index) {
+	const uint64_t tick = toTick(nodes[index].task->getTime());
+	if (tick < currentTick) {
+		append(ready, index);
+		return;
+	}
+
+	const uint64_t delta = tick - currentTick;
+	for (uint32_t level = 0; level < LEVELS; ++level) {
+		if ((delta >> (SLOT_BITS * (level + 1))) == 0) {
+			append(levels[level][(tick >> (SLOT_BITS * level)) & SLOT_MASK], index);
+			return;
+		}
+	}
+
+	// Farther than the wheel can hold, park it in the last bucket of the top level, it is placed again when cascaded
+	constexpr uint32_t topShift = SLOT_BITS * (LEVELS - 1);
+	const uint64_t farthestTick = currentTick + (static_cast<uint64_t>(1) << (SLOT_BITS * LEVELS)) - 1;
+	append(levels[LEVELS - 1][(farthestTick >> topShift) & SLOT_MASK], index);
+}
+
+void TimingWheel::cascade(uint32_t level) {
+	auto &bucket = levels[level][(currentTick >> (SLOT_BITS * level)) & SLOT_MASK];
+	uint32_t index = bucket.head;
+	bucket = {};
+
+	while (index != INVALID_NODE) {
+		const uint32_t next = nodes[index].next;
+		place(index);
+		index = next;
+	}
+}
+
+void TimingWheel::drain(Bucket &bucket, std::vector<std::shared_ptr<Task>> &expired) {
+	uint32_t index = bucket.head;
+	bucket = {};
+
+	while (index != INVALID_NODE) {
+		const uint32_t next = nodes[index].next;
+		expired.emplace_back(std::move(nodes[index].task));
+		releaseNode(index);
+		--count;
+		index = next;
+	}
+}
@@ -0,0 +1,102 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Task;
+
+/**
+ * Hierarchical timing wheel for the dispatcher scheduled events.
+ *
+ * Time is split into ticks of a fixed resolution; every level has
+ * SLOTS buckets and each bucket of level N covers SLOTS^N ticks. Tasks
+ * beyond the current level are cascaded down when the lower level wraps.
+ * Buckets are intrusive singly linked lists of nodes kept in a slab, so
+ * inserting and firing a task does not allocate once the slab is warm.
+ *
+ * A task is fired on the first tick that is not earlier than its time,
+ * so it can run up to one tick late but never early.
+ */
+class TimingWheel {
+public:
+	explicit TimingWheel(uint32_t tickMs) :
+		tickMs(tickMs) { }
+
+	// Ensures that we don't accidentally copy it
+	TimingWheel(const TimingWheel &) = delete;
+	TimingWheel operator=(const TimingWheel &) = delete;
+
+	void insert(const std::shared_ptr<Task> &task, int64_t now);
+
+	/**
+	 * @brief Moves every task due at the given time into the output list, in firing order.
+	 * @param now The current time in milliseconds.
+	 * @param expired Receives the expired tasks.
+	 */
+	void advance(int64_t now, std::vector<std::shared_ptr<Task>> &expired);
+
+	/**
+	 * @brief Time until the wheel needs to be advanced again.
+	 * It is exact when the next task is in the first level, otherwise it is
+	 * the time of the next cascade, when the wheel must be revisited anyway.
+	 */
+	std::chrono::milliseconds timeUntilNextTick(int64_t now) const;
+
+	bool empty() const noexcept {
+		return count == 0;
+	}
+
+	size_t size() const noexcept {
+		return count;
+	}
+
+private:
+	static constexpr uint32_t SLOT_BITS = 6;
+	static constexpr uint32_t SLOTS = 1 << SLOT_BITS;
+	static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+	static constexpr uint32_t LEVELS = 4;
+	static constexpr uint32_t INVALID_NODE = std::numeric_limits<uint32_t>::max();
+
+	struct Node {
+		std::shared_ptr<Task> task;
+		uint32_t next = INVALID_NODE;
+	};
+
+	struct Bucket {
+		uint32_t head = INVALID_NODE;
+		uint32_t tail = INVALID_NODE;
+
+		bool empty() const noexcept {
+			return head == INVALID_NODE;
+		}
+	};
+
+	uint64_t toTick(int64_t time) const {
+		return time <= 0 ? 0 : (static_cast<uint64_t>(time) + tickMs - 1) / tickMs;
+	}
+
+	uint32_t allocNode(const std::shared_ptr<Task> &task);
+	void releaseNode(uint32_t index);
+
+	void append(Bucket &bucket, uint32_t index);
+	void place(uint32_t index);
+	void cascade(uint32_t level);
+	void drain(Bucket &bucket, std::vector<std::shared_ptr<Task>> &expired);
+
+	const uint32_t tickMs;
+	uint64_t currentTick = 0;
+	size_t count = 0;
+
+	std::vector<Node> nodes;
+	std::vector<uint32_t> freeNodes;
+
+	// Tasks that were already due when inserted, fired on the next advance
+	Bucket ready;
+	std::array<std::array<Bucket, SLOTS>, LEVELS> levels;
+};
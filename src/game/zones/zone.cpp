@@ -19,6 +19,8 @@
 
 phmap::parallel_flat_hash_map<std::string, std::shared_ptr<Zone>> Zone::zones = {};
 phmap::parallel_flat_hash_map<uint32_t, std::shared_ptr<Zone>> Zone::zonesByID = {};
+phmap::flat_hash_map<uint64_t, std::vector<std::shared_ptr<Zone>>> Zone::sectorIndex = {};
+bool Zone::sectorIndexDirty = false;
 const static std::shared_ptr<Zone> nullZone = nullptr;
 
 std::shared_ptr<Zone> Zone::addZone(const std::string &name, uint32_t zoneID /* = 0 */) {
@@ -31,6 +33,7 @@ std::shared_ptr<Zone> Zone::addZone(const std::string &name, uint32_t zoneID /*
 		auto zone = zonesByID[zoneID];
 		zone->name = name;
 		zones[name] = zone;
+		sectorIndexDirty = true;
 		return zone;
 	}
 
@@ -39,6 +42,7 @@ std::shared_ptr<Zone> Zone::addZone(const std::string &name, uint32_t zoneID /*
 		return nullZone;
 	}
 	zones[name] = std::make_shared<Zone>(name, zoneID);
+	sectorIndexDirty = true;
 	if (zoneID != 0) {
 		zonesByID[zoneID] = zones[name];
 	}
@@ -46,21 +50,75 @@ std::shared_ptr<Zone> Zone::addZone(const std::string &name, uint32_t zoneID /*
 }
 
 void Zone::addArea(Area area) {
-	for (const auto &pos : area) {
-		addPosition(pos);
-	}
+	setArea(area, true);
 	refresh();
 }
 
 void Zone::subtractArea(Area area) {
-	for (const auto &pos : area) {
-		removePosition(pos);
-	}
+	setArea(area, false);
 	refresh();
 }
 
+void Zone::setArea(Area area, bool value) {
+	for (uint8_t z = area.from.z; z <= area.to.z; ++z) {
+		for (uint32_t sectorY = area.from.y & ~SECTOR_MASK; sectorY <= area.to.y; sectorY += SECTOR_SIZE) {
+			for (uint32_t sectorX = area.from.x & ~SECTOR_MASK; sectorX <= area.to.x; sectorX += SECTOR_SIZE) {
+				const auto key = getSectorKey(static_cast<uint16_t>(sectorX), static_cast<uint16_t>(sectorY), z);
+				auto it = sectors.find(key);
+				if (it == sectors.end()) {
+					if (!value) {
+						continue;
+					}
+					it = sectors.emplace(key, SectorTiles {}).first;
+				}
+
+				// The part of the area inside this sector
+				const auto fromX = std::max<uint32_t>(area.from.x, sectorX);
+				const auto toX = std::min<uint32_t>(area.to.x, sectorX + SECTOR_MASK);
+				const auto fromY = std::max<uint32_t>(area.from.y, sectorY);
+				const auto toY = std::min<uint32_t>(area.to.y, sectorY + SECTOR_MASK);
+				for (auto y = fromY; y <= toY; ++y) {
+					for (auto x = fromX; x <= toX; ++x) {
+						it->second.set(getSectorBit(static_cast<uint16_t>(x), static_cast<uint16_t>(y)), value);
+					}
+				}
+
+				if (!value && it->second.none()) {
+					sectors.erase(it);
+				}
+			}
+		}
+		// z is a uint8_t, the last floor would wrap around
+		if (z == area.to.z) {
+			break;
+		}
+	}
+	sectorIndexDirty = true;
+}
+
+void Zone::addPosition(const Position &position) {
+	auto &tiles = sectors[getSectorKey(position.x, position.y, position.z)];
+	if (tiles.none()) {
+		sectorIndexDirty = true;
+	}
+	tiles.set(getSectorBit(position.x, position.y));
+}
+
+void Zone::removePosition(const Position &position) {
+	const auto it = sectors.find(getSectorKey(position.x, position.y, position.z));
+	if (it == sectors.end()) {
+		return;
+	}
+	it->second.reset(getSectorBit(position.x, position.y));
+	if (it->second.none()) {
+		sectors.erase(it);
+		sectorIndexDirty = true;
+	}
+}
+
 bool Zone::contains(const Position &pos) const {
-	return positions.contains(pos);
+	const auto it = sectors.find(getSectorKey(pos.x, pos.y, pos.z));
+	return it != sectors.end() && it->second.test(getSectorBit(pos.x, pos.y));
 }
 
 Position Zone::getRemoveDestination(const std::shared_ptr<Creature> &creature /* = nullptr */) const {
@@ -94,8 +152,15 @@ std::shared_ptr<Zone> Zone::getZone(uint32_t zoneID) {
 
 std::vector<Position> Zone::getPositions() const {
 	std::vector<Position> result;
-	for (const auto &pos : positions) {
-		result.push_back(pos);
+	for (const auto &[key, tiles] : sectors) {
+		const auto baseX = static_cast<uint16_t>((key >> 24) << SECTOR_BITS);
+		const auto baseY = static_cast<uint16_t>(((key >> 8) & 0xFFFF) << SECTOR_BITS);
+		const auto z = static_cast<uint8_t>(key & 0xFF);
+		for (size_t bit = 0; bit < tiles.size(); ++bit) {
+			if (tiles.test(bit)) {
+				result.emplace_back(static_cast<uint16_t>(baseX + (bit & SECTOR_MASK)), static_cast<uint16_t>(baseY + (bit >> SECTOR_BITS)), z);
+			}
+		}
 	}
 	return result;
 }
@@ -154,20 +219,37 @@ void Zone::clearZones() {
 	for (const auto &[_, zone] : zonesByID) {
 		zones[zone->name] = zone;
 	}
+	sectorIndexDirty = true;
+}
+
+void Zone::rebuildSectorIndex() {
+	sectorIndex.clear();
+	for (const auto &[_, zone] : zones) {
+		if (!zone) {
+			continue;
+		}
+		for (const auto &[key, tiles] : zone->sectors) {
+			sectorIndex[key].emplace_back(zone);
+		}
+	}
+	sectorIndexDirty = false;
 }
 
 std::vector<std::shared_ptr<Zone>> Zone::getZones(const Position position) {
-	Benchmark bm_getZones;
+	if (sectorIndexDirty) {
+		rebuildSectorIndex();
+	}
+
 	std::vector<std::shared_ptr<Zone>> result;
-	for (const auto &[_, zone] : zones) {
-		if (zone && zone->contains(position)) {
+	const auto it = sectorIndex.find(getSectorKey(position.x, position.y, position.z));
+	if (it == sectorIndex.end()) {
+		return result;
+	}
+	for (const auto &zone : it->second) {
+		if (zone->contains(position)) {
 			result.push_back(zone);
 		}
 	}
-	auto duration = bm_getZones.duration();
-	if (duration > 100) {
-		g_logger().warn("Listed {} zones for position {} in {} milliseconds", result.size(), position.toString(), duration);
-	}
 	return result;
 }
 
@@ -181,7 +263,8 @@ std::vector<std::shared_ptr<Zone>> Zone::getZones() {
 	}
 	auto duration = bm_getZones.duration();
 	if (duration > 100) {
-		g_logger().warn("Listed {} zones in {} milliseconds", result.size(), duration);
+		static LogRateLimiter slowListing;
+		g_logger().warn(slowListing, "Listed {} zones in {} milliseconds", result.size(), duration);
 	}
 	return result;
 }
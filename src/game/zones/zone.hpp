@@ -157,12 +157,8 @@ public:
 	}
 	void addArea(Area area);
 	void subtractArea(Area area);
-	void addPosition(const Position &position) {
-		positions.emplace(position);
-	}
-	void removePosition(const Position &position) {
-		positions.erase(position);
-	}
+	void addPosition(const Position &position);
+	void removePosition(const Position &position);
 	Position getRemoveDestination(const std::shared_ptr<Creature> &creature = nullptr) const;
 	void setRemoveDestination(const Position &position) {
 		removeDestination = position;
@@ -213,10 +209,31 @@ public:
 protected:
 	bool contains(const Position &position) const;
 
+	/**
+	 * The tiles are kept as a bitset per 32x32 sector of a floor, a large
+	 * arena costs 128 bytes per sector instead of an entry per tile, and
+	 * areas are set and cleared a sector row at a time.
+	 */
+	static constexpr uint16_t SECTOR_BITS = 5;
+	static constexpr uint16_t SECTOR_SIZE = 1 << SECTOR_BITS;
+	static constexpr uint16_t SECTOR_MASK = SECTOR_SIZE - 1;
+	using SectorTiles = std::bitset<SECTOR_SIZE * SECTOR_SIZE>;
+
+	static uint64_t getSectorKey(uint16_t x, uint16_t y, uint8_t z) {
+		return (static_cast<uint64_t>(x >> SECTOR_BITS) << 24) | (static_cast<uint64_t>(y >> SECTOR_BITS) << 8) | z;
+	}
+	static size_t getSectorBit(uint16_t x, uint16_t y) {
+		return static_cast<size_t>(y & SECTOR_MASK) * SECTOR_SIZE + (x & SECTOR_MASK);
+	}
+
+	void setArea(Area area, bool value);
+
+	static void rebuildSectorIndex();
+
 	Position removeDestination = Position();
 	std::string name;
 	std::string monsterVariant;
-	std::unordered_set<Position> positions;
+	phmap::flat_hash_map<uint64_t, SectorTiles> sectors;
 	uint32_t id = 0; // ID 0 is used in zones created dynamically from lua. The map editor uses IDs starting from 1 (automatically generated).
 
 	weak::set<Item> itemsCache;
@@ -227,4 +244,8 @@ protected:
 
 	static phmap::parallel_flat_hash_map<std::string, std::shared_ptr<Zone>> zones;
 	static phmap::parallel_flat_hash_map<uint32_t, std::shared_ptr<Zone>> zonesByID;
+
+	// The listed zones with tiles in each sector, rebuilt by the first lookup after a zone or its tiles change
+	static phmap::flat_hash_map<uint64_t, std::vector<std::shared_ptr<Zone>>> sectorIndex;
+	static bool sectorIndexDirty;
 };
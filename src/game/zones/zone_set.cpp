@@ -0,0 +1,118 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/zones/zone_set.hpp"
+
+namespace {
+	using Key = std::vector<const Zone*>;
+
+	struct KeyHash {
+		size_t operator()(const Key &key) const {
+			size_t hash = key.size();
+			for (const auto* zone : key) {
+				hash ^= std::hash<const Zone*> {}(zone) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+			}
+			return hash;
+		}
+	};
+
+	// Tiles may be released outside the dispatcher, the table is only touched when a set is created or dropped
+	std::mutex internMutex;
+	phmap::flat_hash_map<Key, std::weak_ptr<const ZoneSet>, KeyHash> internTable;
+	uint32_t lastId = 0;
+
+	Key makeKey(const std::vector<std::shared_ptr<Zone>> &zones) {
+		Key key;
+		key.reserve(zones.size());
+		for (const auto &zone : zones) {
+			key.emplace_back(zone.get());
+		}
+		return key;
+	}
+
+	bool zoneLess(const std::shared_ptr<Zone> &a, const std::shared_ptr<Zone> &b) {
+		return std::less<const Zone*> {}(a.get(), b.get());
+	}
+}
+
+const ZoneSet::Ptr &ZoneSet::empty() {
+	// Never interned, so that it outlives every tile
+	static const Ptr emptySet(new ZoneSet({}, 0));
+	return emptySet;
+}
+
+ZoneSet::Ptr ZoneSet::with(const Ptr &set, const std::shared_ptr<Zone> &zone) {
+	if (!zone || set->contains(zone)) {
+		return set;
+	}
+
+	std::vector<std::shared_ptr<Zone>> zones;
+	zones.reserve(set->size() + 1);
+	const auto position = std::ranges::lower_bound(set->zones, zone, zoneLess);
+	zones.insert(zones.end(), set->zones.begin(), position);
+	zones.emplace_back(zone);
+	zones.insert(zones.end(), position, set->zones.end());
+	return intern(std::move(zones));
+}
+
+ZoneSet::Ptr ZoneSet::filter(const Ptr &set, const std::function<bool(const std::shared_ptr<Zone> &)> &predicate) {
+	std::vector<std::shared_ptr<Zone>> zones;
+	zones.reserve(set->size());
+	for (const auto &zone : set->zones) {
+		if (predicate(zone)) {
+			zones.emplace_back(zone);
+		}
+	}
+	if (zones.size() == set->size()) {
+		return set;
+	}
+	return intern(std::move(zones));
+}
+
+std::vector<std::shared_ptr<Zone>> ZoneSet::difference(const ZoneSet &setA, const ZoneSet &setB) {
+	std::vector<std::shared_ptr<Zone>> result;
+	if (&setA == &setB) {
+		return result;
+	}
+	std::ranges::set_difference(setA.zones, setB.zones, std::back_inserter(result), zoneLess);
+	return result;
+}
+
+bool ZoneSet::contains(const std::shared_ptr<Zone> &zone) const {
+	return std::ranges::binary_search(zones, zone, zoneLess);
+}
+
+ZoneSet::Ptr ZoneSet::intern(std::vector<std::shared_ptr<Zone>> zones) {
+	if (zones.empty()) {
+		return empty();
+	}
+
+	auto key = makeKey(zones);
+	std::scoped_lock lock(internMutex);
+	auto &entry = internTable[key];
+	if (auto set = entry.lock()) {
+		return set;
+	}
+
+	// The deleter drops the entry, unless the key was interned again meanwhile
+	Ptr set(new ZoneSet(std::move(zones), ++lastId), [key](const ZoneSet* zoneSet) {
+		{
+			std::scoped_lock lock(internMutex);
+			const auto it = internTable.find(key);
+			if (it != internTable.end() && it->second.expired()) {
+				internTable.erase(it);
+			}
+		}
+		delete zoneSet;
+	});
+	entry = set;
+	return set;
+}
@@ -0,0 +1,64 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Zone;
+
+/**
+ * Immutable set of the zones of a tile.
+ *
+ * Sets are interned: tiles in the same zones share the same set, so two
+ * tiles are in the same zones exactly when they point to the same set, and
+ * moving between them needs no set difference. A set is dropped from the
+ * intern table when the last tile using it lets it go.
+ */
+class ZoneSet {
+public:
+	using Ptr = std::shared_ptr<const ZoneSet>;
+
+	ZoneSet(const ZoneSet &) = delete;
+	ZoneSet &operator=(const ZoneSet &) = delete;
+
+	static const Ptr &empty();
+	static Ptr with(const Ptr &set, const std::shared_ptr<Zone> &zone);
+	// Keeps only the zones for which the predicate is true
+	static Ptr filter(const Ptr &set, const std::function<bool(const std::shared_ptr<Zone> &)> &predicate);
+
+	// Zones of the first set which are not in the second one
+	static std::vector<std::shared_ptr<Zone>> difference(const ZoneSet &setA, const ZoneSet &setB);
+
+	uint32_t getId() const {
+		return id;
+	}
+	bool contains(const std::shared_ptr<Zone> &zone) const;
+
+	size_t size() const {
+		return zones.size();
+	}
+	bool isEmpty() const {
+		return zones.empty();
+	}
+	auto begin() const {
+		return zones.begin();
+	}
+	auto end() const {
+		return zones.end();
+	}
+
+private:
+	ZoneSet(std::vector<std::shared_ptr<Zone>> zones, uint32_t id) :
+		zones(std::move(zones)), id(id) { }
+
+	static Ptr intern(std::vector<std::shared_ptr<Zone>> zones);
+
+	// Sorted by address
+	const std::vector<std::shared_ptr<Zone>> zones;
+	const uint32_t id;
+};
@@ -28,12 +28,19 @@ namespace OTB {
 		}
 	}
 
-	using NodeStack = std::stack<Node*, std::vector<Node*>>;
-	static Node &getCurrentNode(const NodeStack &nodeStack) {
-		if (nodeStack.empty()) {
-			throw InvalidOTBFormat {};
+	namespace {
+		struct ParseEntry {
+			uint32_t node;
+			uint32_t lastChild = 0;
+		};
+		using NodeStack = std::vector<ParseEntry>;
+
+		ParseEntry &getCurrentNode(NodeStack &nodeStack) {
+			if (nodeStack.empty()) {
+				throw InvalidOTBFormat {};
+			}
+			return nodeStack.back();
 		}
-		return *nodeStack.top();
 	}
 
 	const Node &Loader::parseTree() {
@@ -41,34 +48,43 @@ namespace OTB {
 		if (static_cast<uint8_t>(*it) != Node::START) {
 			throw InvalidOTBFormat {};
 		}
+		nodes.clear();
+		// Every node starts with a START byte, escaped ones included, so this may reserve a few more
+		nodes.reserve(std::count(it, fileContents.end(), static_cast<char>(Node::START)));
+		auto &root = nodes.emplace_back();
 		root.type = *(++it);
 		root.propsBegin = ++it;
 		NodeStack parseStack;
-		parseStack.push(&root);
+		parseStack.push_back({ 0 });
 
 		for (; it != fileContents.end(); ++it) {
 			switch (static_cast<uint8_t>(*it)) {
 				case Node::START: {
-					auto &currentNode = getCurrentNode(parseStack);
-					if (currentNode.children.empty()) {
-						currentNode.propsEnd = it;
+					auto &current = getCurrentNode(parseStack);
+					const auto childIndex = static_cast<uint32_t>(nodes.size());
+					if (current.lastChild == 0) {
+						nodes[current.node].propsEnd = it;
+						nodes[current.node].firstChild = childIndex;
+					} else {
+						nodes[current.lastChild].nextSibling = childIndex;
 					}
-					currentNode.children.emplace_back();
-					auto &child = currentNode.children.back();
+					current.lastChild = childIndex;
+
+					auto &child = nodes.emplace_back();
 					if (++it == fileContents.end()) {
 						throw InvalidOTBFormat {};
 					}
 					child.type = *it;
 					child.propsBegin = it + sizeof(Node::type);
-					parseStack.push(&child);
+					parseStack.push_back({ childIndex });
 					break;
 				}
 				case Node::END: {
-					auto &currentNode = getCurrentNode(parseStack);
-					if (currentNode.children.empty()) {
-						currentNode.propsEnd = it;
+					const auto &current = getCurrentNode(parseStack);
+					if (current.lastChild == 0) {
+						nodes[current.node].propsEnd = it;
 					}
-					parseStack.pop();
+					parseStack.pop_back();
 					break;
 				}
 				case Node::ESCAPE: {
@@ -86,7 +102,7 @@ namespace OTB {
 			throw InvalidOTBFormat {};
 		}
 
-		return root;
+		return nodes.front();
 	}
 
 	bool Loader::getProps(const Node &node, PropStream &props) {
@@ -14,16 +14,15 @@ class PropStream;
 namespace OTB {
 	using Identifier = std::array<char, 4>;
 
+	/**
+	 * A node of the tree parsed by Loader. The nodes are kept in one vector of the loader, in file order,
+	 * and link to their first child and next sibling by index; the root is never a child, so 0 means none.
+	 */
 	struct Node {
-		Node() = default;
-		Node(Node &&) = default;
-		Node &operator=(Node &&) = default;
-		Node(const Node &) = delete;
-		Node &operator=(const Node &) = delete;
-
-		std::list<Node> children;
 		mio::mmap_source::const_iterator propsBegin;
 		mio::mmap_source::const_iterator propsEnd;
+		uint32_t firstChild = 0;
+		uint32_t nextSibling = 0;
 		uint8_t type;
 		enum NodeChar : uint8_t {
 			ESCAPE = 0xFD,
@@ -42,15 +41,73 @@ namespace OTB {
 		}
 	};
 
+	// The children of a node, walked through the sibling links
+	class NodeChildren {
+	public:
+		class iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Node;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const Node*;
+			using reference = const Node &;
+
+			iterator(const std::vector<Node>* nodes, uint32_t index) :
+				nodes(nodes), index(index) { }
+
+			reference operator*() const {
+				return (*nodes)[index];
+			}
+			pointer operator->() const {
+				return &(*nodes)[index];
+			}
+			iterator &operator++() {
+				index = (*nodes)[index].nextSibling;
+				return *this;
+			}
+			bool operator==(const iterator &other) const {
+				return index == other.index;
+			}
+			bool operator!=(const iterator &other) const {
+				return index != other.index;
+			}
+
+		private:
+			const std::vector<Node>* nodes;
+			uint32_t index;
+		};
+
+		NodeChildren(const std::vector<Node> &nodes, const Node &node) :
+			nodes(&nodes), first(node.firstChild) { }
+
+		iterator begin() const {
+			return { nodes, first };
+		}
+		iterator end() const {
+			return { nodes, 0 };
+		}
+		bool empty() const {
+			return first == 0;
+		}
+
+	private:
+		const std::vector<Node>* nodes;
+		uint32_t first;
+	};
+
 	class Loader {
 		mio::mmap_source fileContents;
-		Node root;
+		std::vector<Node> nodes;
 		std::vector<char> propBuffer;
 
 	public:
 		Loader(const std::string &fileName, const Identifier &acceptedIdentifier);
 		bool getProps(const Node &node, PropStream &props);
 		const Node &parseTree();
+		// Only valid for the nodes of the last parseTree
+		NodeChildren getChildren(const Node &node) const {
+			return { nodes, node };
+		}
 	};
 } // namespace OTB
 
@@ -109,9 +166,18 @@ private:
 	const char* end = nullptr;
 };
 
+/**
+ * Growing write buffer of the serialized attributes.
+ * The buffers of the streams destroyed on a thread are reused, with their capacity, by the next streams
+ * created on it, so serializing the items of every save doesn't grow a new vector each time.
+ */
 class PropWriteStream {
 public:
-	PropWriteStream() = default;
+	PropWriteStream() :
+		buffer(acquireBuffer()) { }
+	~PropWriteStream() {
+		releaseBuffer(std::move(buffer));
+	}
 
 	// non-copyable
 	PropWriteStream(const PropWriteStream &) = delete;
@@ -128,8 +194,8 @@ public:
 
 	template <typename T>
 	void write(T add) {
-		char* addr = reinterpret_cast<char*>(&add);
-		std::copy(addr, addr + sizeof(T), std::back_inserter(buffer));
+		const char* addr = reinterpret_cast<const char*>(&add);
+		buffer.insert(buffer.end(), addr, addr + sizeof(T));
 	}
 
 	void writeString(const std::string &str) {
@@ -140,9 +206,39 @@ public:
 		}
 
 		write(static_cast<uint16_t>(strLength));
-		std::copy(str.begin(), str.end(), std::back_inserter(buffer));
+		buffer.insert(buffer.end(), str.begin(), str.end());
 	}
 
 private:
+	static constexpr size_t MAX_POOLED_BUFFERS = 8;
+	// Larger buffers, like the ones of a whole map save, are freed instead of kept by the thread
+	static constexpr size_t MAX_POOLED_CAPACITY = 1024 * 1024;
+
+	static std::vector<std::vector<char>> &bufferPool() {
+		thread_local std::vector<std::vector<char>> pool;
+		return pool;
+	}
+
+	static std::vector<char> acquireBuffer() {
+		auto &pool = bufferPool();
+		if (pool.empty()) {
+			return {};
+		}
+
+		auto pooled = std::move(pool.back());
+		pool.pop_back();
+		return pooled;
+	}
+
+	static void releaseBuffer(std::vector<char> &&released) {
+		auto &pool = bufferPool();
+		if (released.capacity() == 0 || released.capacity() > MAX_POOLED_CAPACITY || pool.size() >= MAX_POOLED_BUFFERS) {
+			return;
+		}
+
+		released.clear();
+		pool.emplace_back(std::move(released));
+	}
+
 	std::vector<char> buffer;
 };
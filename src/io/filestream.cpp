@@ -144,6 +144,22 @@ bool FileStream::startNode(uint8_t type) {
 	return false;
 }
 
+bool FileStream::skipNode() {
+	uint32_t depth = 1;
+	while (m_pos < m_data.size()) {
+		const uint8_t byte = m_data[m_pos++];
+		if (byte == OTB::Node::ESCAPE) {
+			++m_pos;
+		} else if (byte == OTB::Node::START) {
+			++depth;
+		} else if (byte == OTB::Node::END && --depth == 0) {
+			--m_nodes;
+			return true;
+		}
+	}
+	return false;
+}
+
 bool FileStream::endNode() {
 	if (getU8() == OTB::Node::END) {
 		--m_nodes;
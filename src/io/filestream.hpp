@@ -9,15 +9,11 @@
 
 #pragma once
 
+// Reads over memory it does not own, the caller keeps the mapped file alive
 class FileStream {
 public:
-	FileStream(const char* begin, const char* end) {
-		m_data.insert(m_data.end(), begin, end);
-	}
-
-	explicit FileStream(mio::mmap_source source) {
-		m_data.insert(m_data.end(), source.begin(), source.end());
-	}
+	FileStream(const char* begin, const char* end) :
+		m_data(reinterpret_cast<const uint8_t*>(begin), reinterpret_cast<const uint8_t*>(end)) { }
 
 	void back(uint32_t pos = 1);
 	void seek(uint32_t pos);
@@ -27,6 +23,8 @@ public:
 
 	bool startNode(uint8_t type = 0);
 	bool endNode();
+	// Skips the rest of the node just started, children included
+	bool skipNode();
 	bool isProp(uint8_t prop, bool toNext = true);
 
 	uint8_t getU8();
@@ -41,5 +39,5 @@ private:
 	uint32_t m_nodes { 0 };
 	uint32_t m_pos { 0 };
 
-	std::vector<uint8_t> m_data;
+	std::span<const uint8_t> m_data;
 };
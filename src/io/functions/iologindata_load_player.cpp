@@ -18,7 +18,92 @@
 #include "enums/account_errors.hpp"
 #include "utils/tools.hpp"
 
-void IOLoginDataLoad::loadItems(ItemsMap &itemsMap, DBResult_ptr result, const std::shared_ptr<Player> &player) {
+namespace {
+	// The reads of a login that only need the guid and account, shared with IOLoginDataLoad::getPlayerQueries
+	std::string getKillsQuery(uint32_t guid) {
+		return fmt::format("SELECT `player_id`, `time`, `target`, `unavenged` FROM `player_kills` WHERE `player_id` = {}", guid);
+	}
+
+	std::string getGuildMembershipQuery(uint32_t guid) {
+		return fmt::format("SELECT `guild_id`, `rank_id`, `nick` FROM `guild_membership` WHERE `player_id` = {}", guid);
+	}
+
+	std::string getStashQuery(uint32_t guid) {
+		return fmt::format("SELECT `item_count`, `item_id`  FROM `player_stash` WHERE `player_id` = {}", guid);
+	}
+
+	std::string getCharmsQuery(uint32_t guid) {
+		return fmt::format("SELECT * FROM `player_charms` WHERE `player_guid` = {}", guid);
+	}
+
+	std::string getSpellsQuery(uint32_t guid) {
+		return fmt::format("SELECT `player_id`, `name` FROM `player_spells` WHERE `player_id` = {}", guid);
+	}
+
+	std::string getItemsQuery(std::string_view table, uint32_t guid) {
+		return fmt::format("SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `{}` WHERE `player_id` = {} ORDER BY `sid` DESC", table, guid);
+	}
+
+	std::string getRewardsQuery(uint32_t guid) {
+		return fmt::format("SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_rewards` WHERE `player_id` = {} ORDER BY `pid`, `sid` ASC", guid);
+	}
+
+	std::string getStorageQuery(uint32_t guid) {
+		return fmt::format("SELECT `key`, `value` FROM `player_storage` WHERE `player_id` = {}", guid);
+	}
+
+	std::string getVipListQuery(uint32_t accountId) {
+		return fmt::format("SELECT `player_id` FROM `account_viplist` WHERE `account_id` = {}", accountId);
+	}
+
+	std::string getVipGroupsQuery(uint32_t accountId) {
+		return fmt::format("SELECT `id`, `name`, `customizable` FROM `account_vipgroups` WHERE `account_id` = {}", accountId);
+	}
+
+	std::string getVipGroupListQuery(uint32_t accountId) {
+		return fmt::format("SELECT `player_id`, `vipgroup_id` FROM `account_vipgrouplist` WHERE `account_id` = {}", accountId);
+	}
+
+	std::string getPlayerTableQuery(std::string_view table, uint32_t guid) {
+		return fmt::format("SELECT * FROM `{}` WHERE `player_id` = {}", table, guid);
+	}
+}
+
+std::vector<std::string> IOLoginDataLoad::getDepotQueries(uint32_t guid) {
+	return { getItemsQuery("player_depotitems", guid), getItemsQuery("player_inboxitems", guid) };
+}
+
+std::vector<std::string> IOLoginDataLoad::getPlayerQueries(uint32_t guid, uint32_t accountId) {
+	std::vector<std::string> queries = {
+		getKillsQuery(guid),
+		getGuildMembershipQuery(guid),
+		getStashQuery(guid),
+		getCharmsQuery(guid),
+		getItemsQuery("player_items", guid),
+		getRewardsQuery(guid),
+		getStorageQuery(guid),
+		getVipListQuery(accountId),
+		getVipGroupsQuery(accountId),
+		getVipGroupListQuery(accountId),
+		getSpellsQuery(guid),
+		getPlayerTableQuery("forge_history", guid),
+		getPlayerTableQuery("player_bosstiary", guid),
+	};
+
+	if (!g_configManager().getBoolean(LAZY_DEPOT_LOADING, __FUNCTION__)) {
+		auto depotQueries = getDepotQueries(guid);
+		queries.insert(queries.end(), std::make_move_iterator(depotQueries.begin()), std::make_move_iterator(depotQueries.end()));
+	}
+	if (g_configManager().getBoolean(PREY_ENABLED, __FUNCTION__)) {
+		queries.emplace_back(getPlayerTableQuery("player_prey", guid));
+	}
+	if (g_configManager().getBoolean(TASK_HUNTING_ENABLED, __FUNCTION__)) {
+		queries.emplace_back(getPlayerTableQuery("player_taskhunt", guid));
+	}
+	return queries;
+}
+
+void IOLoginDataLoad::loadItems(ItemsMap &itemsMap, DBResult_ptr result, const std::shared_ptr<Player> &player, Player::PersistedItemRows* persistedRows /* = nullptr*/) {
 	try {
 		do {
 			uint32_t sid = result->getNumber<uint32_t>("sid");
@@ -27,6 +112,10 @@ void IOLoginDataLoad::loadItems(ItemsMap &itemsMap, DBResult_ptr result, const s
 			uint16_t count = result->getNumber<uint16_t>("count");
 			unsigned long attrSize;
 			const char* attr = result->getStream("attributes", attrSize);
+			if (persistedRows) {
+				// Every stored row is recorded, even the ones that fail to load, so the next save deletes them
+				(*persistedRows)[static_cast<int32_t>(sid)] = hashItemRow(static_cast<int32_t>(pid), type, count, attr, attrSize);
+			}
 			PropStream propStream;
 			propStream.init(attr, attrSize);
 
@@ -323,9 +412,7 @@ void IOLoginDataLoad::loadPlayerKills(std::shared_ptr<Player> player, DBResult_p
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `player_id`, `time`, `target`, `unavenged` FROM `player_kills` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(getKillsQuery(player->getGUID())))) {
 		do {
 			time_t killTime = result->getNumber<time_t>("time");
 			if ((time(nullptr) - killTime) <= g_configManager().getNumber(FRAG_TIME, __FUNCTION__)) {
@@ -343,8 +430,7 @@ void IOLoginDataLoad::loadPlayerGuild(std::shared_ptr<Player> player, DBResult_p
 
 	Database &db = Database::getInstance();
 	std::ostringstream query;
-	query << "SELECT `guild_id`, `rank_id`, `nick` FROM `guild_membership` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(getGuildMembershipQuery(player->getGUID())))) {
 		uint32_t guildId = result->getNumber<uint32_t>("guild_id");
 		uint32_t playerRankId = result->getNumber<uint32_t>("rank_id");
 		player->guildNick = result->getString("nick");
@@ -392,9 +478,7 @@ void IOLoginDataLoad::loadPlayerStashItems(std::shared_ptr<Player> player, DBRes
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `item_count`, `item_id`  FROM `player_stash` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(getStashQuery(player->getGUID())))) {
 		do {
 			player->addItemOnStash(result->getNumber<uint16_t>("item_id"), result->getNumber<uint32_t>("item_count"));
 		} while (result->next());
@@ -409,8 +493,7 @@ void IOLoginDataLoad::loadPlayerBestiaryCharms(std::shared_ptr<Player> player, D
 
 	Database &db = Database::getInstance();
 	std::ostringstream query;
-	query << "SELECT * FROM `player_charms` WHERE `player_guid` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(getCharmsQuery(player->getGUID())))) {
 		player->charmPoints = result->getNumber<uint32_t>("charm_points");
 		player->charmExpansion = result->getNumber<bool>("charm_expansion");
 		player->charmRuneWound = result->getNumber<uint16_t>("rune_wound");
@@ -461,9 +544,7 @@ void IOLoginDataLoad::loadPlayerInstantSpellList(std::shared_ptr<Player> player,
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `player_id`, `name` FROM `player_spells` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(getSpellsQuery(player->getGUID())))) {
 		do {
 			player->learnedInstantSpellList.emplace_back(result->getString("name"));
 		} while (result->next());
@@ -478,14 +559,13 @@ void IOLoginDataLoad::loadPlayerInventoryItems(std::shared_ptr<Player> player, D
 
 	bool oldProtocol = g_configManager().getBoolean(OLD_PROTOCOL, __FUNCTION__) && player->getProtocolVersion() < 1200;
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_items` WHERE `player_id` = " << player->getGUID() << " ORDER BY `sid` DESC";
+	const auto query = getItemsQuery("player_items", player->getGUID());
 
 	ItemsMap inventoryItems;
 	std::vector<std::pair<uint8_t, std::shared_ptr<Container>>> openContainersList;
 
 	try {
-		if ((result = db.storeQuery(query.str()))) {
+		if ((result = db.storeQuery(query))) {
 			loadItems(inventoryItems, result, player);
 
 			for (ItemsMap::const_reverse_iterator it = inventoryItems.rbegin(), end = inventoryItems.rend(); it != end; ++it) {
@@ -570,11 +650,7 @@ void IOLoginDataLoad::loadRewardItems(std::shared_ptr<Player> player) {
 	}
 
 	ItemsMap rewardItems;
-	std::ostringstream query;
-	query.str(std::string());
-	query << "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_rewards` WHERE `player_id` = "
-		  << player->getGUID() << " ORDER BY `pid`, `sid` ASC";
-	if (auto result = Database::getInstance().storeQuery(query.str())) {
+	if (auto result = Database::getInstance().storeQuery(getRewardsQuery(player->getGUID()))) {
 		loadItems(rewardItems, result, player);
 		bindRewardBag(player, rewardItems);
 		insertItemsIntoRewardBag(rewardItems);
@@ -582,17 +658,17 @@ void IOLoginDataLoad::loadRewardItems(std::shared_ptr<Player> player) {
 }
 
 void IOLoginDataLoad::loadPlayerDepotItems(std::shared_ptr<Player> player, DBResult_ptr result) {
-	if (!result || !player) {
-		g_logger().warn("[IOLoginData::loadPlayer] - Player or Result nullptr: {}", __FUNCTION__);
+	// Also run on the first use of the depot, without the players row
+	if (!player) {
+		g_logger().warn("[IOLoginData::loadPlayer] - Player nullptr: {}", __FUNCTION__);
 		return;
 	}
 
 	Database &db = Database::getInstance();
 	ItemsMap depotItems;
-	std::ostringstream query;
-	query << "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_depotitems` WHERE `player_id` = " << player->getGUID() << " ORDER BY `sid` DESC";
-	if ((result = db.storeQuery(query.str()))) {
-		loadItems(depotItems, result, player);
+	player->persistedDepotRows.emplace();
+	if ((result = db.storeQuery(getItemsQuery("player_depotitems", player->getGUID())))) {
+		loadItems(depotItems, result, player, &player->persistedDepotRows.value());
 		for (ItemsMap::const_reverse_iterator it = depotItems.rbegin(), end = depotItems.rend(); it != end; ++it) {
 			const std::pair<std::shared_ptr<Item>, int32_t> &pair = it->second;
 			std::shared_ptr<Item> item = pair.first;
@@ -621,17 +697,17 @@ void IOLoginDataLoad::loadPlayerDepotItems(std::shared_ptr<Player> player, DBRes
 }
 
 void IOLoginDataLoad::loadPlayerInboxItems(std::shared_ptr<Player> player, DBResult_ptr result) {
-	if (!result || !player) {
-		g_logger().warn("[IOLoginData::loadPlayer] - Player or Result nullptr: {}", __FUNCTION__);
+	// Also run on the first use of the depot, without the players row
+	if (!player) {
+		g_logger().warn("[IOLoginData::loadPlayer] - Player nullptr: {}", __FUNCTION__);
 		return;
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_inboxitems` WHERE `player_id` = " << player->getGUID() << " ORDER BY `sid` DESC";
-	if ((result = db.storeQuery(query.str()))) {
+	player->persistedInboxRows.emplace();
+	if ((result = db.storeQuery(getItemsQuery("player_inboxitems", player->getGUID())))) {
 		ItemsMap inboxItems;
-		loadItems(inboxItems, result, player);
+		loadItems(inboxItems, result, player, &player->persistedInboxRows.value());
 
 		for (ItemsMap::const_reverse_iterator it = inboxItems.rbegin(), end = inboxItems.rend(); it != end; ++it) {
 			const std::pair<std::shared_ptr<Item>, int32_t> &pair = it->second;
@@ -663,13 +739,16 @@ void IOLoginDataLoad::loadPlayerStorageMap(std::shared_ptr<Player> player, DBRes
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `key`, `value` FROM `player_storage` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(getStorageQuery(player->getGUID())))) {
 		do {
 			player->addStorageValue(result->getNumber<uint32_t>("key"), result->getNumber<int32_t>("value"), true);
 		} while (result->next());
 	}
+
+	// Everything loaded is what the database has
+	player->genReservedStorageRange();
+	player->dirtyStorageKeys.clear();
+	player->storageRowsKnown = true;
 }
 
 void IOLoginDataLoad::loadPlayerVip(std::shared_ptr<Player> player, DBResult_ptr result) {
@@ -681,15 +760,13 @@ void IOLoginDataLoad::loadPlayerVip(std::shared_ptr<Player> player, DBResult_ptr
 	uint32_t accountId = player->getAccountId();
 
 	Database &db = Database::getInstance();
-	std::string query = fmt::format("SELECT `player_id` FROM `account_viplist` WHERE `account_id` = {}", accountId);
-	if ((result = db.storeQuery(query))) {
+	if ((result = db.storeQuery(getVipListQuery(accountId)))) {
 		do {
 			player->vip()->addInternal(result->getNumber<uint32_t>("player_id"));
 		} while (result->next());
 	}
 
-	query = fmt::format("SELECT `id`, `name`, `customizable` FROM `account_vipgroups` WHERE `account_id` = {}", accountId);
-	if ((result = db.storeQuery(query))) {
+	if ((result = db.storeQuery(getVipGroupsQuery(accountId)))) {
 		do {
 			player->vip()->addGroupInternal(
 				result->getNumber<uint8_t>("id"),
@@ -699,8 +776,7 @@ void IOLoginDataLoad::loadPlayerVip(std::shared_ptr<Player> player, DBResult_ptr
 		} while (result->next());
 	}
 
-	query = fmt::format("SELECT `player_id`, `vipgroup_id` FROM `account_vipgrouplist` WHERE `account_id` = {}", accountId);
-	if ((result = db.storeQuery(query))) {
+	if ((result = db.storeQuery(getVipGroupListQuery(accountId)))) {
 		do {
 			player->vip()->addGuidToGroupInternal(
 				result->getNumber<uint8_t>("vipgroup_id"),
@@ -718,9 +794,7 @@ void IOLoginDataLoad::loadPlayerPreyClass(std::shared_ptr<Player> player, DBResu
 
 	if (g_configManager().getBoolean(PREY_ENABLED, __FUNCTION__)) {
 		Database &db = Database::getInstance();
-		std::ostringstream query;
-		query << "SELECT * FROM `player_prey` WHERE `player_id` = " << player->getGUID();
-		if (result = db.storeQuery(query.str())) {
+		if (result = db.storeQuery(getPlayerTableQuery("player_prey", player->getGUID()))) {
 			do {
 				auto slot = std::make_unique<PreySlot>(static_cast<PreySlot_t>(result->getNumber<uint16_t>("slot")));
 				auto state = static_cast<PreyDataState_t>(result->getNumber<uint16_t>("state"));
@@ -765,9 +839,7 @@ void IOLoginDataLoad::loadPlayerTaskHuntingClass(std::shared_ptr<Player> player,
 
 	if (g_configManager().getBoolean(TASK_HUNTING_ENABLED, __FUNCTION__)) {
 		Database &db = Database::getInstance();
-		std::ostringstream query;
-		query << "SELECT * FROM `player_taskhunt` WHERE `player_id` = " << player->getGUID();
-		if (result = db.storeQuery(query.str())) {
+		if (result = db.storeQuery(getPlayerTableQuery("player_taskhunt", player->getGUID()))) {
 			do {
 				auto slot = std::make_unique<TaskHuntingSlot>(static_cast<PreySlot_t>(result->getNumber<uint16_t>("slot")));
 				auto state = static_cast<PreyTaskDataState_t>(result->getNumber<uint16_t>("state"));
@@ -813,9 +885,7 @@ void IOLoginDataLoad::loadPlayerForgeHistory(std::shared_ptr<Player> player, DBR
 		return;
 	}
 
-	std::ostringstream query;
-	query << "SELECT * FROM `forge_history` WHERE `player_id` = " << player->getGUID();
-	if (result = Database::getInstance().storeQuery(query.str())) {
+	if (result = Database::getInstance().storeQuery(getPlayerTableQuery("forge_history", player->getGUID()))) {
 		do {
 			auto actionEnum = magic_enum::enum_value<ForgeAction_t>(result->getNumber<uint16_t>("action_type"));
 			ForgeHistory history;
@@ -839,9 +909,7 @@ void IOLoginDataLoad::loadPlayerBosstiary(std::shared_ptr<Player> player, DBResu
 		return;
 	}
 
-	std::ostringstream query;
-	query << "SELECT * FROM `player_bosstiary` WHERE `player_id` = " << player->getGUID();
-	if (result = Database::getInstance().storeQuery(query.str())) {
+	if (result = Database::getInstance().storeQuery(getPlayerTableQuery("player_bosstiary", player->getGUID()))) {
 		do {
 			player->setSlotBossId(1, result->getNumber<uint16_t>("bossIdSlotOne"));
 			player->setSlotBossId(2, result->getNumber<uint16_t>("bossIdSlotTwo"));
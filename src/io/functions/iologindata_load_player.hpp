@@ -15,6 +15,14 @@ class IOLoginDataLoad : public IOLoginData {
 public:
 	static bool loadPlayerFirst(std::shared_ptr<Player> player, DBResult_ptr result);
 	static bool preLoadPlayer(std::shared_ptr<Player> player, const std::string &name);
+	/**
+	 * @brief The reads of the load functions that only need the guid and account, in the same text they run with.
+	 */
+	static std::vector<std::string> getPlayerQueries(uint32_t guid, uint32_t accountId);
+	/**
+	 * @brief The reads of loadPlayerDepotItems and loadPlayerInboxItems.
+	 */
+	static std::vector<std::string> getDepotQueries(uint32_t guid);
 	static void loadPlayerExperience(std::shared_ptr<Player> player, DBResult_ptr result);
 	static void loadPlayerBlessings(std::shared_ptr<Player> player, DBResult_ptr result);
 	static void loadPlayerConditions(std::shared_ptr<Player> player, DBResult_ptr result);
@@ -46,5 +54,5 @@ private:
 	static void bindRewardBag(std::shared_ptr<Player> player, ItemsMap &rewardItemsMap);
 	static void insertItemsIntoRewardBag(const ItemsMap &rewardItemsMap);
 
-	static void loadItems(ItemsMap &itemsMap, DBResult_ptr result, const std::shared_ptr<Player> &player);
+	static void loadItems(ItemsMap &itemsMap, DBResult_ptr result, const std::shared_ptr<Player> &player, Player::PersistedItemRows* persistedRows = nullptr);
 };
@@ -12,22 +12,14 @@
 #include "io/functions/iologindata_save_player.hpp"
 #include "game/game.hpp"
 
-bool IOLoginDataSave::saveItems(std::shared_ptr<Player> player, const ItemBlockList &itemList, DBInsert &query_insert, PropWriteStream &propWriteStream) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
-	}
-
-	const Database &db = Database::getInstance();
-	std::ostringstream ss;
-
+bool IOLoginDataSave::serializeItems(std::shared_ptr<Player> player, const ItemBlockList &itemList, PropWriteStream &propWriteStream, const ItemRowCallback &addRow, int32_t lastSid /* = 100*/) {
 	// Initialize variables
 	using ContainerBlock = std::pair<std::shared_ptr<Container>, int32_t>;
 	std::list<ContainerBlock> queue;
-	int32_t runningId = 100;
+	int32_t runningId = lastSid;
 
 	// Loop through each item in itemList
-	const auto openContainers = player->getOpenContainers();
+	const auto openContainers = player ? player->getOpenContainers() : std::map<uint8_t, OpenContainer> {};
 	for (const auto &it : itemList) {
 		int32_t pid = it.first;
 		std::shared_ptr<Item> item = it.second;
@@ -71,9 +63,7 @@ bool IOLoginDataSave::saveItems(std::shared_ptr<Player> player, const ItemBlockL
 		size_t attributesSize;
 		const char* attributes = propWriteStream.getStream(attributesSize);
 
-		// Build query string and add row
-		ss << player->getGUID() << ',' << pid << ',' << runningId << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
-		if (!query_insert.addRow(ss)) {
+		if (!addRow(pid, runningId, item, attributes, attributesSize)) {
 			g_logger().error("Error adding row to query.");
 			return false;
 		}
@@ -131,15 +121,29 @@ bool IOLoginDataSave::saveItems(std::shared_ptr<Player> player, const ItemBlockL
 			size_t attributesSize;
 			const char* attributes = propWriteStream.getStream(attributesSize);
 
-			// Build query string and add row
-			ss << player->getGUID() << ',' << parentId << ',' << runningId << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
-			if (!query_insert.addRow(ss)) {
+			if (!addRow(parentId, runningId, item, attributes, attributesSize)) {
 				g_logger().error("Error adding row to query for container item.");
 				return false;
 			}
 		}
 	}
 
+	return true;
+}
+
+bool IOLoginDataSave::saveItems(std::shared_ptr<Player> player, const ItemBlockList &itemList, DBInsert &query_insert, PropWriteStream &propWriteStream) {
+	const Database &db = Database::getInstance();
+	std::ostringstream ss;
+
+	const bool serialized = serializeItems(player, itemList, propWriteStream, [&](int32_t pid, int32_t sid, const std::shared_ptr<Item> &item, const char* attributes, size_t attributesSize) {
+		// Build query string and add row
+		ss << player->getGUID() << ',' << pid << ',' << sid << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
+		return query_insert.addRow(ss);
+	});
+	if (!serialized) {
+		return false;
+	}
+
 	// Execute query
 	if (!query_insert.execute()) {
 		g_logger().error("Error executing query.");
@@ -148,6 +152,60 @@ bool IOLoginDataSave::saveItems(std::shared_ptr<Player> player, const ItemBlockL
 	return true;
 }
 
+bool IOLoginDataSave::saveItemsDelta(std::shared_ptr<Player> player, const ItemBlockList &itemList, const std::string &table, std::optional<Player::PersistedItemRows> &persistedRows, PropWriteStream &propWriteStream) {
+	if (!player) {
+		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
+		return false;
+	}
+
+	Database &db = Database::getInstance();
+	if (!persistedRows) {
+		// Nothing is known about the stored rows, start from an empty table
+		if (!db.executeQuery(fmt::format("DELETE FROM `{}` WHERE `player_id` = {}", table, player->getGUID()))) {
+			return false;
+		}
+		persistedRows.emplace();
+	}
+
+	DBInsert upsertQuery(fmt::format("INSERT INTO `{}` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ", table));
+	upsertQuery.upsert({ "pid", "itemtype", "count", "attributes" });
+
+	Player::PersistedItemRows currentRows;
+	currentRows.reserve(persistedRows->size());
+	std::ostringstream ss;
+	const bool serialized = serializeItems(player, itemList, propWriteStream, [&](int32_t pid, int32_t sid, const std::shared_ptr<Item> &item, const char* attributes, size_t attributesSize) {
+		const uint64_t rowHash = hashItemRow(pid, item->getID(), item->getSubType(), attributes, attributesSize);
+		currentRows[sid] = rowHash;
+
+		// Unchanged rows are skipped before the attributes are escaped
+		if (auto it = persistedRows->find(sid); it != persistedRows->end() && it->second == rowHash) {
+			return true;
+		}
+
+		ss << player->getGUID() << ',' << pid << ',' << sid << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
+		return upsertQuery.addRow(ss);
+	});
+	if (!serialized || !upsertQuery.execute()) {
+		g_logger().error("[{}] - Error writing changed rows of '{}' from player: {}", __FUNCTION__, table, player->getName());
+		return false;
+	}
+
+	std::string removedSids;
+	for (const auto &[sid, rowHash] : persistedRows.value()) {
+		if (!currentRows.contains(sid)) {
+			fmt::format_to(std::back_inserter(removedSids), "{}{}", removedSids.empty() ? "" : ",", sid);
+		}
+	}
+
+	if (!removedSids.empty() && !db.executeQuery(fmt::format("DELETE FROM `{}` WHERE `player_id` = {} AND `sid` IN ({})", table, player->getGUID(), removedSids))) {
+		g_logger().error("[{}] - Error deleting removed rows of '{}' from player: {}", __FUNCTION__, table, player->getName());
+		return false;
+	}
+
+	persistedRows = std::move(currentRows);
+	return true;
+}
+
 bool IOLoginDataSave::savePlayerFirst(std::shared_ptr<Player> player) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
@@ -160,20 +218,14 @@ bool IOLoginDataSave::savePlayerFirst(std::shared_ptr<Player> player) {
 
 	Database &db = Database::getInstance();
 
+	// The `save` flag is checked by the queries themselves, so the save does not need to read from the database
 	std::ostringstream query;
-	query << "SELECT `save` FROM `players` WHERE `id` = " << player->getGUID();
-	DBResult_ptr result = db.storeQuery(query.str());
-	if (!result) {
-		g_logger().warn("[IOLoginData::savePlayer] - Error for select result query from player: {}", player->getName());
+	query << "UPDATE `players` SET `lastlogin` = " << player->lastLoginSaved << ", `lastip` = " << player->lastIP << " WHERE `id` = " << player->getGUID() << " AND `save` = 0";
+	if (!db.executeQuery(query.str())) {
+		g_logger().warn("[IOLoginData::savePlayer] - Error for update login query from player: {}", player->getName());
 		return false;
 	}
 
-	if (result->getNumber<uint16_t>("save") == 0) {
-		query.str("");
-		query << "UPDATE `players` SET `lastlogin` = " << player->lastLoginSaved << ", `lastip` = " << player->lastIP << " WHERE `id` = " << player->getGUID();
-		return db.executeQuery(query.str());
-	}
-
 	// First, an UPDATE query to write the player itself
 	query.str("");
 	query << "UPDATE `players` SET ";
@@ -306,7 +358,7 @@ bool IOLoginDataSave::savePlayerFirst(std::shared_ptr<Player> player) {
 		query << "`blessings" << i << "`"
 			  << " = " << static_cast<uint32_t>(player->getBlessingCount(static_cast<uint8_t>(i))) << ((i == 8) ? " " : ",");
 	}
-	query << " WHERE `id` = " << player->getGUID();
+	query << " WHERE `id` = " << player->getGUID() << " AND `save` != 0";
 
 	if (!db.executeQuery(query.str())) {
 		return false;
@@ -489,28 +541,21 @@ bool IOLoginDataSave::savePlayerDepotItems(std::shared_ptr<Player> player) {
 		return false;
 	}
 
-	Database &db = Database::getInstance();
+	// Never loaded, the stored rows are still what the player has
+	if (!player->hasDepotItemsLoaded()) {
+		return true;
+	}
+
 	PropWriteStream propWriteStream;
 	ItemDepotList depotList;
 	if (player->lastDepotId != -1) {
-		std::ostringstream query;
-		query << "DELETE FROM `player_depotitems` WHERE `player_id` = " << player->getGUID();
-
-		if (!db.executeQuery(query.str())) {
-			return false;
-		}
-
-		query.str("");
-
-		DBInsert depotQuery("INSERT INTO `player_depotitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
 		for (const auto &[pid, depotChest] : player->depotChests) {
 			for (std::shared_ptr<Item> item : depotChest->getItemList()) {
 				depotList.emplace_back(pid, item);
 			}
 		}
 
-		if (!saveItems(player, depotList, depotQuery, propWriteStream)) {
+		if (!saveItemsDelta(player, depotList, "player_depotitems", player->persistedDepotRows, propWriteStream)) {
 			return false;
 		}
 		return true;
@@ -558,28 +603,54 @@ bool IOLoginDataSave::savePlayerInbox(std::shared_ptr<Player> player) {
 		return false;
 	}
 
-	Database &db = Database::getInstance();
-	PropWriteStream propWriteStream;
-	ItemInboxList inboxList;
-	std::ostringstream query;
-	query << "DELETE FROM `player_inboxitems` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
+	if (!player->hasDepotItemsLoaded()) {
+		return true;
 	}
 
-	query.str("");
-	DBInsert inboxQuery("INSERT INTO `player_inboxitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
+	PropWriteStream propWriteStream;
+	ItemInboxList inboxList;
 	for (const auto &item : player->getInbox()->getItemList()) {
 		inboxList.emplace_back(0, item);
 	}
 
-	if (!saveItems(player, inboxList, inboxQuery, propWriteStream)) {
+	if (!saveItemsDelta(player, inboxList, "player_inboxitems", player->persistedInboxRows, propWriteStream)) {
 		return false;
 	}
 	return true;
 }
 
+bool IOLoginDataSave::appendInboxItems(uint32_t guid, const std::vector<std::shared_ptr<Item>> &items) {
+	if (items.empty()) {
+		return true;
+	}
+
+	ItemInboxList inboxList;
+	for (const auto &item : items) {
+		inboxList.emplace_back(0, item);
+	}
+
+	return DBTransaction::executeWithinTransaction([guid, &inboxList]() {
+		Database &db = Database::getInstance();
+		// Top level inbox rows are the ones whose pid is below 100, the sids must stay above it
+		int32_t lastSid = 100;
+		if (const auto result = db.storeStatement("SELECT COALESCE(MAX(`sid`), 0) AS `sid` FROM `player_inboxitems` WHERE `player_id` = ?", { guid })) {
+			lastSid = std::max(lastSid, result->getNumber<int32_t>("sid"));
+		}
+
+		DBInsert inboxQuery("INSERT INTO `player_inboxitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
+		PropWriteStream propWriteStream;
+		std::ostringstream ss;
+		const bool serialized = serializeItems(nullptr, inboxList, propWriteStream, [&](int32_t pid, int32_t sid, const std::shared_ptr<Item> &item, const char* attributes, size_t attributesSize) {
+			ss << guid << ',' << pid << ',' << sid << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
+			return inboxQuery.addRow(ss);
+		}, lastSid);
+		if (!serialized || !inboxQuery.execute()) {
+			throw DatabaseException(fmt::format("[IOLoginDataSave::appendInboxItems] - Failed to append inbox items of player id: {}", guid));
+		}
+		return true;
+	});
+}
+
 bool IOLoginDataSave::savePlayerPreyClass(std::shared_ptr<Player> player) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
@@ -772,25 +843,55 @@ bool IOLoginDataSave::savePlayerStorage(std::shared_ptr<Player> player) {
 
 	Database &db = Database::getInstance();
 	std::ostringstream query;
-	query << "DELETE FROM `player_storage` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
+	player->genReservedStorageRange();
 
-	query.str("");
+	const bool rowsKnown = player->storageRowsKnown;
+	if (!rowsKnown) {
+		// Nothing is known about the stored rows, start from an empty table
+		query << "DELETE FROM `player_storage` WHERE `player_id` = " << player->getGUID();
+		if (!db.executeQuery(query.str())) {
+			return false;
+		}
+
+		query.str("");
+	}
 
 	DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ");
-	player->genReservedStorageRange();
+	storageQuery.upsert({ "value" });
 
-	for (const auto &[key, value] : player->storageMap) {
+	std::string removedKeys;
+	const auto addRow = [&](uint32_t key, int32_t value) {
 		query << player->getGUID() << ',' << key << ',' << value;
-		if (!storageQuery.addRow(query)) {
-			return false;
+		return storageQuery.addRow(query);
+	};
+
+	if (rowsKnown) {
+		for (const auto key : player->dirtyStorageKeys) {
+			if (const auto it = player->storageMap.find(key); it != player->storageMap.end()) {
+				if (!addRow(key, it->second)) {
+					return false;
+				}
+			} else {
+				fmt::format_to(std::back_inserter(removedKeys), "{}{}", removedKeys.empty() ? "" : ",", key);
+			}
+		}
+	} else {
+		for (const auto &[key, value] : player->storageMap) {
+			if (!addRow(key, value)) {
+				return false;
+			}
 		}
 	}
 
 	if (!storageQuery.execute()) {
 		return false;
 	}
+
+	if (!removedKeys.empty() && !db.executeQuery(fmt::format("DELETE FROM `player_storage` WHERE `player_id` = {} AND `key` IN ({})", player->getGUID(), removedKeys))) {
+		return false;
+	}
+
+	player->dirtyStorageKeys.clear();
+	player->storageRowsKnown = true;
 	return true;
 }
@@ -28,11 +28,29 @@ public:
 	static bool savePlayerBosstiary(std::shared_ptr<Player> player);
 	static bool savePlayerStorage(std::shared_ptr<Player> player);
 
+	/**
+	 * @brief Adds items to the stored inbox of a player that is not loaded, after the rows already there.
+	 */
+	static bool appendInboxItems(uint32_t guid, const std::vector<std::shared_ptr<Item>> &items);
+
 protected:
 	using ItemBlockList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 	using ItemDepotList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 	using ItemRewardList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 	using ItemInboxList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 
+	using ItemRowCallback = std::function<bool(int32_t pid, int32_t sid, const std::shared_ptr<Item> &item, const char* attributes, size_t attributesSize)>;
+
+	/**
+	 * @brief Numbers the items and their contents after lastSid and passes each one, serialized, to addRow.
+	 * @param player Its open containers are stored in the items, nullptr for a player that is not loaded.
+	 */
+	static bool serializeItems(std::shared_ptr<Player> player, const ItemBlockList &itemList, PropWriteStream &stream, const ItemRowCallback &addRow, int32_t lastSid = 100);
 	static bool saveItems(std::shared_ptr<Player> player, const ItemBlockList &itemList, DBInsert &query_insert, PropWriteStream &stream);
+	/**
+	 * @brief Writes only the item rows that changed since the last save, deleting the ones that are gone.
+	 * @param table The item table, keyed by player and sid.
+	 * @param persistedRows The rows known to be stored, the table is rewritten when unknown.
+	 */
+	static bool saveItemsDelta(std::shared_ptr<Player> player, const ItemBlockList &itemList, const std::string &table, std::optional<Player::PersistedItemRows> &persistedRows, PropWriteStream &stream);
 };
@@ -154,19 +154,7 @@ uint16_t IOBosstiary::getBoostedBossId() const {
 }
 
 std::shared_ptr<MonsterType> IOBosstiary::getMonsterTypeByBossRaceId(uint16_t raceId) const {
-	for ([[maybe_unused]] const auto &[bossRaceId, bossName] : getBosstiaryMap()) {
-		if (bossRaceId == raceId) {
-			const auto monsterType = g_monsters().getMonsterType(bossName);
-			if (!monsterType) {
-				g_logger().error("[{}] Boss with id {} not found in boss map", __FUNCTION__, raceId);
-				continue;
-			}
-
-			return monsterType;
-		}
-	}
-
-	return nullptr;
+	return g_monsters().getBossTypeByRaceId(raceId);
 }
 
 void IOBosstiary::addBosstiaryKill(std::shared_ptr<Player> player, const std::shared_ptr<MonsterType> mtype, uint32_t amount /*= 1*/) const {
@@ -181,7 +169,7 @@ void IOBosstiary::addBosstiaryKill(std::shared_ptr<Player> player, const std::sh
 
 	auto oldBossLevel = getBossCurrentLevel(player, bossId);
 	player->addBestiaryKillCount(bossId, amount);
-	player->refreshCyclopediaMonsterTracker(true);
+	player->refreshCyclopediaMonsterTrackerOnKill(mtype, true);
 	auto newBossLevel = getBossCurrentLevel(player, bossId);
 	if (oldBossLevel == newBossLevel) {
 		return;
@@ -115,25 +115,93 @@ std::shared_ptr<Charm> IOBestiary::getBestiaryCharm(charmRune_t activeCharm, boo
 }
 
 std::map<uint16_t, std::string> IOBestiary::findRaceByName(const std::string &race, bool Onlystring /*= true*/, BestiaryType_t raceNumber /*= BESTY_RACE_NONE*/) const {
-	std::map<uint16_t, std::string> best_list = g_game().getBestiaryList();
-	std::map<uint16_t, std::string> race_list;
-
+	const auto &bestiaryIndex = getBestiaryIndex();
 	if (Onlystring) {
-		for (const auto &it : best_list) {
-			const auto tmpType = g_monsters().getMonsterType(it.second);
-			if (tmpType && tmpType->info.bestiaryClass == race) {
-				race_list.insert({ it.first, it.second });
-			}
+		const auto it = bestiaryIndex.byClass.find(race);
+		return it != bestiaryIndex.byClass.end() ? it->second : std::map<uint16_t, std::string> {};
+	}
+	return raceNumber <= BESTY_RACE_LAST ? bestiaryIndex.byRace[raceNumber] : std::map<uint16_t, std::string> {};
+}
+
+const IOBestiary::BestiaryIndex &IOBestiary::getBestiaryIndex() const {
+	if (!indexStale) {
+		return index;
+	}
+
+	const uint32_t revision = index.revision + 1;
+	index = BestiaryIndex();
+	index.revision = revision;
+	for (const auto &[raceId, name] : g_game().getBestiaryList()) {
+		const auto mtype = g_monsters().getMonsterType(name);
+		if (!mtype) {
+			continue;
 		}
-	} else {
-		for (const auto &itn : best_list) {
-			const auto tmpType = g_monsters().getMonsterType(itn.second);
-			if (tmpType && tmpType->info.bestiaryRace == raceNumber) {
-				race_list.insert({ itn.first, itn.second });
-			}
+
+		index.byClass[mtype->info.bestiaryClass].emplace(raceId, name);
+		const auto race = mtype->info.bestiaryRace;
+		if (race <= BESTY_RACE_LAST) {
+			index.byRace[race].emplace(raceId, name);
+			index.classNames[race] = mtype->info.bestiaryClass;
+		}
+	}
+	indexStale = false;
+	return index;
+}
+
+const Player::BestiaryProgress &IOBestiary::getBestiaryProgress(const std::shared_ptr<Player> &player) const {
+	const auto &bestiaryIndex = getBestiaryIndex();
+	auto &progress = player->bestiaryProgress;
+	if (progress && progress->indexRevision == bestiaryIndex.revision) {
+		return *progress;
+	}
+
+	// Once per player and index, the kills update it from then on
+	progress.emplace();
+	progress->indexRevision = bestiaryIndex.revision;
+	for (const auto &[raceId, name] : g_game().getBestiaryList()) {
+		const auto mtype = g_monsters().getMonsterType(name);
+		if (!mtype) {
+			continue;
+		}
+
+		const uint32_t killCount = player->getBestiaryKillCount(raceId);
+		if (killCount > 0 && mtype->info.bestiaryRace <= BESTY_RACE_LAST) {
+			++progress->unlocked[mtype->info.bestiaryRace];
+		}
+		if (killCount >= mtype->info.bestiaryToUnlock) {
+			progress->finished.emplace_back(raceId);
+		}
+	}
+	return *progress;
+}
+
+void IOBestiary::updateBestiaryProgress(Player::BestiaryProgress &progress, uint16_t raceId, int32_t oldCount, int32_t newCount) const {
+	if (!g_game().getBestiaryList().contains(raceId)) {
+		return;
+	}
+
+	const auto mtype = g_monsters().getMonsterTypeByRaceId(raceId);
+	if (!mtype) {
+		return;
+	}
+
+	const auto oldKills = static_cast<uint32_t>(std::max(0, oldCount));
+	const auto newKills = static_cast<uint32_t>(std::max(0, newCount));
+	if ((oldKills > 0) != (newKills > 0) && mtype->info.bestiaryRace <= BESTY_RACE_LAST) {
+		auto &unlocked = progress.unlocked[mtype->info.bestiaryRace];
+		unlocked = newKills > 0 ? unlocked + 1 : unlocked - 1;
+	}
+
+	const bool wasFinished = oldKills >= mtype->info.bestiaryToUnlock;
+	const bool isFinished = newKills >= mtype->info.bestiaryToUnlock;
+	if (wasFinished != isFinished) {
+		const auto it = std::ranges::lower_bound(progress.finished, raceId);
+		if (isFinished) {
+			progress.finished.insert(it, raceId);
+		} else if (it != progress.finished.end() && *it == raceId) {
+			progress.finished.erase(it);
 		}
 	}
-	return race_list;
 }
 
 uint8_t IOBestiary::getKillStatus(const std::shared_ptr<MonsterType> mtype, uint32_t killAmount) const {
@@ -188,16 +256,7 @@ uint16_t IOBestiary::getBestiaryRaceUnlocked(std::shared_ptr<Player> player, Bes
 		return 0;
 	}
 
-	uint16_t count = 0;
-	std::map<uint16_t, std::string> besty_l = g_game().getBestiaryList();
-
-	for (const auto &it : besty_l) {
-		const auto mtype = g_monsters().getMonsterType(it.second);
-		if (mtype && mtype->info.bestiaryRace == race && player->getBestiaryKillCount(mtype->info.raceid) > 0) {
-			count++;
-		}
-	}
-	return count;
+	return race <= BESTY_RACE_LAST ? getBestiaryProgress(player).unlocked[race] : 0;
 }
 
 void IOBestiary::addCharmPoints(std::shared_ptr<Player> player, uint16_t amount, bool negative /*= false*/) {
@@ -220,16 +279,13 @@ void IOBestiary::addBestiaryKill(std::shared_ptr<Player> player, const std::shar
 		return;
 	}
 	uint32_t curCount = player->getBestiaryKillCount(raceid);
-	std::ostringstream ss;
-
 	player->addBestiaryKillCount(raceid, amount);
 
 	if ((curCount == 0) || // Initial kill stage
 	    (curCount < mtype->info.bestiaryFirstUnlock && (curCount + amount) >= mtype->info.bestiaryFirstUnlock) || // First kill stage reached
 	    (curCount < mtype->info.bestiarySecondUnlock && (curCount + amount) >= mtype->info.bestiarySecondUnlock) || // Second kill stage reached
 	    (curCount < mtype->info.bestiaryToUnlock && (curCount + amount) >= mtype->info.bestiaryToUnlock)) { // Final kill stage reached
-		ss << "You unlocked details for the creature '" << mtype->name << "'";
-		player->sendTextMessage(MESSAGE_STATUS, ss.str());
+		player->sendTextMessage(MESSAGE_STATUS, fmt::format("You unlocked details for the creature '{}'", mtype->name));
 		player->sendBestiaryEntryChanged(raceid);
 
 		if ((curCount + amount) >= mtype->info.bestiaryToUnlock) {
@@ -238,7 +294,7 @@ void IOBestiary::addBestiaryKill(std::shared_ptr<Player> player, const std::shar
 	}
 
 	// Reload bestiary tracker
-	player->refreshCyclopediaMonsterTracker();
+	player->refreshCyclopediaMonsterTrackerOnKill(mtype, false);
 }
 
 charmRune_t IOBestiary::getCharmFromTarget(std::shared_ptr<Player> player, const std::shared_ptr<MonsterType> mtype) {
@@ -383,33 +439,8 @@ std::map<uint8_t, int16_t> IOBestiary::getMonsterElements(const std::shared_ptr<
 	return defaultMap;
 }
 
-std::map<uint16_t, uint32_t> IOBestiary::getBestiaryKillCountByMonsterIDs(std::shared_ptr<Player> player, std::map<uint16_t, std::string> mtype_list) const {
-	std::map<uint16_t, uint32_t> raceMonsters = {};
-	for (const auto &it : mtype_list) {
-		uint16_t raceid = it.first;
-		uint32_t thisKilled = player->getBestiaryKillCount(raceid);
-		if (thisKilled > 0) {
-			raceMonsters[raceid] = thisKilled;
-		}
-	}
-	return raceMonsters;
-}
-
 std::vector<uint16_t> IOBestiary::getBestiaryFinished(const std::shared_ptr<Player> &player) const {
-	const auto &bestiaryMap = g_game().getBestiaryList();
-
-	stdext::vector_set<uint16_t> finishedMonsters;
-	finishedMonsters.reserve(bestiaryMap.size());
-
-	for (const auto &[monsterTypeRaceId, monsterTypeName] : bestiaryMap) {
-		const auto &mtype = g_monsters().getMonsterType(monsterTypeName);
-		const uint32_t thisKilled = player->getBestiaryKillCount(monsterTypeRaceId);
-
-		if (mtype && thisKilled >= mtype->info.bestiaryToUnlock) {
-			finishedMonsters.insert(monsterTypeRaceId);
-		}
-	}
-	return finishedMonsters.data();
+	return getBestiaryProgress(player).finished;
 }
 
 int8_t IOBestiary::calculateDifficult(uint32_t chance) const {
@@ -76,11 +76,33 @@ public:
 
 	charmRune_t getCharmFromTarget(std::shared_ptr<Player> player, const std::shared_ptr<MonsterType> mtype);
 
-	std::map<uint16_t, uint32_t> getBestiaryKillCountByMonsterIDs(std::shared_ptr<Player> player, std::map<uint16_t, std::string> mtype_list) const;
 	std::map<uint8_t, int16_t> getMonsterElements(const std::shared_ptr<MonsterType> mtype) const;
 	std::map<uint16_t, std::string> findRaceByName(const std::string &race, bool Onlystring = true, BestiaryType_t raceNumber = BESTY_RACE_NONE) const;
 
+	/**
+	 * The monsters of Game::getBestiaryList grouped by race and by class,
+	 * built on first use and again once the list or its types change.
+	 */
+	struct BestiaryIndex {
+		uint32_t revision = 0;
+		std::array<std::map<uint16_t, std::string>, BESTY_RACE_LAST + 1> byRace;
+		// The class shown for each race, the one of its last monster
+		std::array<std::string, BESTY_RACE_LAST + 1> classNames;
+		phmap::flat_hash_map<std::string, std::map<uint16_t, std::string>> byClass;
+	};
+	const BestiaryIndex &getBestiaryIndex() const;
+	void invalidateBestiaryIndex() {
+		indexStale = true;
+	}
+
+	const Player::BestiaryProgress &getBestiaryProgress(const std::shared_ptr<Player> &player) const;
+	// A kill count of the player changed from oldCount to newCount
+	void updateBestiaryProgress(Player::BestiaryProgress &progress, uint16_t raceId, int32_t oldCount, int32_t newCount) const;
+
 private:
+	mutable BestiaryIndex index;
+	mutable bool indexStale = true;
+
 	static SoftSingleton instanceTracker;
 	SoftSingletonGuard guard { instanceTracker };
 };
@@ -0,0 +1,194 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "io/iojournal.hpp"
+#include "database/database.hpp"
+#include "lib/di/container.hpp"
+
+#ifdef _WIN32
+	#include <io.h>
+#else
+	#include <unistd.h>
+#endif
+
+namespace {
+	// A record is its payload size, the checksum of the payload and the payload, a serialized DBQueryBatch
+	constexpr size_t RECORD_HEADER_SIZE = sizeof(uint32_t) * 2;
+
+	uint32_t checksum(std::string_view data) {
+		// FNV-1a, only meant to find a record torn by the crash
+		uint32_t hash = 2166136261u;
+		for (const char byte : data) {
+			hash = (hash ^ static_cast<uint8_t>(byte)) * 16777619u;
+		}
+		return hash;
+	}
+
+	bool syncFile(std::FILE* file) {
+		if (std::fflush(file) != 0) {
+			return false;
+		}
+#ifdef _WIN32
+		return _commit(_fileno(file)) == 0;
+#else
+		return fsync(fileno(file)) == 0;
+#endif
+	}
+}
+
+IOJournal::IOJournal(Logger &logger) :
+	logger(logger) { }
+
+IOJournal::~IOJournal() {
+	if (file) {
+		std::fclose(file);
+	}
+}
+
+IOJournal &IOJournal::getInstance() {
+	return inject<IOJournal>();
+}
+
+bool IOJournal::open(const std::string &journalPath) {
+	if (isOpen()) {
+		return true;
+	}
+
+	path = journalPath;
+	replay(path);
+
+	file = std::fopen(path.c_str(), "wb");
+	if (!file) {
+		logger.error("[IOJournal::open] - Failed to open the save journal {}", path);
+		return false;
+	}
+	empty = true;
+	opened = true;
+	return true;
+}
+
+void IOJournal::replay(const std::string &replayPath) {
+	std::ifstream input(replayPath, std::ios::binary);
+	if (!input) {
+		return;
+	}
+
+	const std::string data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+	input.close();
+	if (data.empty()) {
+		return;
+	}
+
+	Benchmark bm_replay;
+	logger.warn("Replaying the save journal {} left by the last run...", replayPath);
+	size_t offset = 0;
+	size_t replayed = 0;
+	size_t failed = 0;
+	while (data.size() - offset >= RECORD_HEADER_SIZE) {
+		uint32_t size;
+		uint32_t expected;
+		std::memcpy(&size, data.data() + offset, sizeof(size));
+		std::memcpy(&expected, data.data() + offset + sizeof(size), sizeof(expected));
+		if (data.size() - offset - RECORD_HEADER_SIZE < size) {
+			break;
+		}
+
+		const std::string_view payload(data.data() + offset + RECORD_HEADER_SIZE, size);
+		if (checksum(payload) != expected) {
+			break;
+		}
+		offset += RECORD_HEADER_SIZE + size;
+
+		DBQueryBatch batch;
+		if (!batch.deserialize(payload) || !batch.execute()) {
+			++failed;
+			continue;
+		}
+		++replayed;
+	}
+
+	if (offset != data.size()) {
+		logger.warn("[IOJournal::replay] - Ignored the last {} bytes of the save journal, written partially by the crash", data.size() - offset);
+	}
+	if (failed > 0) {
+		logger.error("[IOJournal::replay] - {} batches of the save journal could not be written", failed);
+	}
+
+	// Kept for inspection until the next replay
+	std::error_code error;
+	std::filesystem::rename(replayPath, replayPath + ".old", error);
+	logger.info("Replayed {} batches of the save journal in {} milliseconds.", replayed, bm_replay.duration());
+}
+
+void IOJournal::append(const DBQueryBatch &batch) {
+	if (batch.empty()) {
+		return;
+	}
+
+	if (!isOpen()) {
+		return;
+	}
+
+	std::scoped_lock lock(mutex);
+	const size_t start = pending.size();
+	pending.resize(start + RECORD_HEADER_SIZE);
+	batch.serialize(pending);
+
+	const std::string_view payload(pending.data() + start + RECORD_HEADER_SIZE, pending.size() - start - RECORD_HEADER_SIZE);
+	const auto size = static_cast<uint32_t>(payload.size());
+	const uint32_t payloadChecksum = checksum(payload);
+	std::memcpy(pending.data() + start, &size, sizeof(size));
+	std::memcpy(pending.data() + start + sizeof(size), &payloadChecksum, sizeof(payloadChecksum));
+}
+
+bool IOJournal::sync() {
+	if (!isOpen()) {
+		return true;
+	}
+
+	// Everything appended up to here goes out with this sync, the dispatcher keeps appending meanwhile
+	std::string records;
+	{
+		std::scoped_lock lock(mutex);
+		records.swap(pending);
+	}
+	if (records.empty()) {
+		return true;
+	}
+
+	empty = false;
+	if (std::fwrite(records.data(), 1, records.size(), file) != records.size() || !syncFile(file)) {
+		logger.error("[IOJournal::sync] - Failed to write the save journal {}", path);
+		return false;
+	}
+	return true;
+}
+
+void IOJournal::checkpoint() {
+	if (!isOpen() || empty) {
+		return;
+	}
+
+	{
+		std::scoped_lock lock(mutex);
+		if (!pending.empty()) {
+			return;
+		}
+	}
+
+	file = std::freopen(path.c_str(), "wb", file);
+	if (!file) {
+		opened = false;
+		logger.error("[IOJournal::checkpoint] - Failed to reopen the save journal {}, journaling stopped", path);
+		return;
+	}
+	empty = true;
+}
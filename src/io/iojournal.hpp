@@ -0,0 +1,77 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+
+#pragma once
+
+class DBQueryBatch;
+class Logger;
+
+/**
+ * Write-ahead journal of the batches of the async saves.
+ *
+ * A batch is appended when it is queued for the background writer, and the
+ * writer syncs the journal before sending the batch to the database; every
+ * batch appended meanwhile reaches the disk with the same sync. Once the
+ * writer has nothing left, every journaled batch is in the database and the
+ * journal is emptied. After a crash the batches left in the journal are
+ * replayed in order on startup: they write whole rows, so one that had
+ * already reached the database is written again to the same result.
+ */
+class IOJournal {
+public:
+	explicit IOJournal(Logger &logger);
+	~IOJournal();
+
+	IOJournal(const IOJournal &) = delete;
+	void operator=(const IOJournal &) = delete;
+
+	static IOJournal &getInstance();
+
+	/**
+	 * @brief Replays what a crash left in the file, then opens it empty for the next batches.
+	 * Must be called once the database is ready and before any player is loaded.
+	 */
+	bool open(const std::string &path);
+	bool isOpen() const {
+		return opened.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * @brief Queues the batch for the next sync.
+	 * Called in the order the batches are handed to the writer.
+	 */
+	void append(const DBQueryBatch &batch);
+	/**
+	 * @brief Writes and syncs every batch appended so far.
+	 * Only called by the save writer, like checkpoint.
+	 */
+	bool sync();
+	/**
+	 * @brief Empties the journal, only called once every batch in it reached the database.
+	 */
+	void checkpoint();
+
+private:
+	void replay(const std::string &path);
+
+	Logger &logger;
+
+	// Guards the records appended since the last sync, the file is only touched by the save writer
+	std::mutex mutex;
+	std::string pending;
+
+	std::atomic<bool> opened = false;
+	std::string path;
+	std::FILE* file = nullptr;
+	// Nothing written since the last checkpoint
+	bool empty = true;
+};
+
+constexpr auto g_ioJournal = IOJournal::getInstance;
@@ -13,6 +13,7 @@
 #include "io/functions/iologindata_load_player.hpp"
 #include "io/functions/iologindata_save_player.hpp"
 #include "game/game.hpp"
+#include "game/highscores/highscores.hpp"
 #include "creatures/monsters/monster.hpp"
 #include "creatures/players/wheel/player_wheel.hpp"
 #include "lib/metrics/metrics.hpp"
@@ -43,11 +44,6 @@ bool IOLoginData::gameWorldAuthentication(const std::string &accountDescriptor,
 		return false;
 	}
 
-	if (AccountErrors_t::Ok != enumFromValue<AccountErrors_t>(account.load())) {
-		g_logger().error("Failed to load account [{}]", accountDescriptor);
-		return false;
-	}
-
 	auto [players, result] = account.getAccountPlayers();
 	if (AccountErrors_t::Ok != enumFromValue<AccountErrors_t>(result)) {
 		g_logger().error("Failed to load account [{}] players", accountDescriptor);
@@ -97,16 +93,22 @@ void IOLoginData::updateOnlineStatus(uint32_t guid, bool login) {
 // The boolean "disableIrrelevantInfo" will deactivate the loading of information that is not relevant to the preload, for example, forge, bosstiary, etc. None of this we need to access if the player is offline
 bool IOLoginData::loadPlayerById(std::shared_ptr<Player> player, uint32_t id, bool disableIrrelevantInfo /* = true*/) {
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT * FROM `players` WHERE `id` = " << id;
-	return loadPlayer(player, db.storeQuery(query.str()), disableIrrelevantInfo);
+	return loadPlayer(player, db.storeQuery(getPlayerByIdQuery(id)), disableIrrelevantInfo);
+}
+
+std::vector<std::string> IOLoginData::getLoadQueries(uint32_t guid, uint32_t accountId) {
+	auto queries = IOLoginDataLoad::getPlayerQueries(guid, accountId);
+	queries.emplace_back(getPlayerByIdQuery(guid));
+	return queries;
+}
+
+std::string IOLoginData::getPlayerByIdQuery(uint32_t id) {
+	return fmt::format("SELECT * FROM `players` WHERE `id` = {}", id);
 }
 
 bool IOLoginData::loadPlayerByName(std::shared_ptr<Player> player, const std::string &name, bool disableIrrelevantInfo /* = true*/) {
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT * FROM `players` WHERE `name` = " << db.escapeString(name);
-	return loadPlayer(player, db.storeQuery(query.str()), disableIrrelevantInfo);
+	return loadPlayer(player, db.storeStatement("SELECT * FROM `players` WHERE `name` = ?", { name }), disableIrrelevantInfo);
 }
 
 bool IOLoginData::loadPlayer(std::shared_ptr<Player> player, DBResult_ptr result, bool disableIrrelevantInfo /* = false*/) {
@@ -160,14 +162,20 @@ bool IOLoginData::loadPlayer(std::shared_ptr<Player> player, DBResult_ptr result
 		// store Inbox
 		IOLoginDataLoad::loadPlayerStoreInbox(player);
 
-		// load depot items
-		IOLoginDataLoad::loadPlayerDepotItems(player, result);
+		// load depot items, or leave them with the inbox items for their first use
+		if (g_configManager().getBoolean(LAZY_DEPOT_LOADING, __FUNCTION__)) {
+			player->depotItemsPending = true;
+		} else {
+			IOLoginDataLoad::loadPlayerDepotItems(player, result);
+		}
 
 		// load reward items
 		IOLoginDataLoad::loadRewardItems(player);
 
 		// load inbox items
-		IOLoginDataLoad::loadPlayerInboxItems(player, result);
+		if (!player->depotItemsPending) {
+			IOLoginDataLoad::loadPlayerInboxItems(player, result);
+		}
 
 		// load storage map
 		IOLoginDataLoad::loadPlayerStorageMap(player, result);
@@ -210,11 +218,35 @@ bool IOLoginData::savePlayer(std::shared_ptr<Player> player) {
 
 	if (!success) {
 		g_logger().error("[{}] Error occurred saving player", __FUNCTION__);
+		if (player) {
+			// The rollback leaves the rows as they were, so what we know about them is no longer reliable
+			player->resetPersistedRows();
+		}
 	}
 
 	return success;
 }
 
+bool IOLoginData::savePlayerToBatch(std::shared_ptr<Player> player, DBQueryBatch &batch) {
+	try {
+		DBQueryBatch::Capture capture(batch);
+		return savePlayerGuard(player);
+	} catch (const std::exception &exception) {
+		g_logger().error("[{}] Error occurred capturing player save, error: {}", __FUNCTION__, exception.what());
+		if (player) {
+			player->resetPersistedRows();
+		}
+		return false;
+	}
+}
+
+uint64_t IOLoginData::hashItemRow(int32_t pid, uint16_t itemType, uint16_t count, const char* attributes, size_t attributesSize) {
+	uint64_t hash = std::hash<std::string_view>()(std::string_view(attributes, attributesSize));
+	const uint64_t columns = (static_cast<uint64_t>(static_cast<uint32_t>(pid)) << 32) | (static_cast<uint64_t>(itemType) << 16) | count;
+	hash ^= columns * 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+	return hash;
+}
+
 bool IOLoginData::savePlayerGuard(std::shared_ptr<Player> player) {
 	if (!player) {
 		throw DatabaseException("Player nullptr in function: " + std::string(__FUNCTION__));
@@ -280,13 +312,12 @@ bool IOLoginData::savePlayerGuard(std::shared_ptr<Player> player) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerStorage] - Failed to save player storage: " + player->getName());
 	}
 
+	g_highscores().updatePlayer(player);
 	return true;
 }
 
 std::string IOLoginData::getNameByGuid(uint32_t guid) {
-	std::ostringstream query;
-	query << "SELECT `name` FROM `players` WHERE `id` = " << guid;
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeStatement("SELECT `name` FROM `players` WHERE `id` = ?", { guid });
 	if (!result) {
 		return std::string();
 	}
@@ -294,11 +325,7 @@ std::string IOLoginData::getNameByGuid(uint32_t guid) {
 }
 
 uint32_t IOLoginData::getGuidByName(const std::string &name) {
-	Database &db = Database::getInstance();
-
-	std::ostringstream query;
-	query << "SELECT `id` FROM `players` WHERE `name` = " << db.escapeString(name);
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeStatement("SELECT `id` FROM `players` WHERE `name` = ?", { name });
 	if (!result) {
 		return 0;
 	}
@@ -306,11 +333,7 @@ uint32_t IOLoginData::getGuidByName(const std::string &name) {
 }
 
 bool IOLoginData::getGuidByNameEx(uint32_t &guid, bool &specialVip, std::string &name) {
-	Database &db = Database::getInstance();
-
-	std::ostringstream query;
-	query << "SELECT `name`, `id`, `group_id`, `account_id` FROM `players` WHERE `name` = " << db.escapeString(name);
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeStatement("SELECT `name`, `id`, `group_id`, `account_id` FROM `players` WHERE `name` = ?", { name });
 	if (!result) {
 		return false;
 	}
@@ -326,12 +349,7 @@ bool IOLoginData::getGuidByNameEx(uint32_t &guid, bool &specialVip, std::string
 }
 
 bool IOLoginData::formatPlayerName(std::string &name) {
-	Database &db = Database::getInstance();
-
-	std::ostringstream query;
-	query << "SELECT `name` FROM `players` WHERE `name` = " << db.escapeString(name);
-
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeStatement("SELECT `name` FROM `players` WHERE `name` = ?", { name });
 	if (!result) {
 		return false;
 	}
@@ -341,9 +359,21 @@ bool IOLoginData::formatPlayerName(std::string &name) {
 }
 
 void IOLoginData::increaseBankBalance(uint32_t guid, uint64_t bankBalance) {
-	std::ostringstream query;
-	query << "UPDATE `players` SET `balance` = `balance` + " << bankBalance << " WHERE `id` = " << guid;
-	Database::getInstance().executeQuery(query.str());
+	Database::getInstance().executeStatement("UPDATE `players` SET `balance` = `balance` + ? WHERE `id` = ?", { bankBalance, guid });
+}
+
+bool IOLoginData::decreaseBankBalances(const phmap::flat_hash_map<uint32_t, uint64_t> &amounts) {
+	if (amounts.empty()) {
+		return true;
+	}
+
+	std::string cases;
+	std::string guids;
+	for (const auto &[guid, amount] : amounts) {
+		fmt::format_to(std::back_inserter(cases), " WHEN {} THEN {}", guid, amount);
+		fmt::format_to(std::back_inserter(guids), "{}{}", guids.empty() ? "" : ",", guid);
+	}
+	return Database::getInstance().executeQuery(fmt::format("UPDATE `players` SET `balance` = `balance` - CASE `id`{} END WHERE `id` IN ({})", cases, guids));
 }
 
 bool IOLoginData::hasBiddedOnHouse(uint32_t guid) {
@@ -23,12 +23,23 @@ public:
 	static bool loadPlayerById(std::shared_ptr<Player> player, uint32_t id, bool disableIrrelevantInfo = true);
 	static bool loadPlayerByName(std::shared_ptr<Player> player, const std::string &name, bool disableIrrelevantInfo = true);
 	static bool loadPlayer(std::shared_ptr<Player> player, DBResult_ptr result, bool disableIrrelevantInfo = false);
+	/**
+	 * @brief The reads of a full loadPlayerById that are known before it runs, to prefetch them.
+	 */
+	static std::vector<std::string> getLoadQueries(uint32_t guid, uint32_t accountId);
 	static bool savePlayer(std::shared_ptr<Player> player);
+	/**
+	 * @brief Builds the queries of a player save from its current state without running them.
+	 * @param batch Receives the queries, to be executed later with DBQueryBatch::execute.
+	 */
+	static bool savePlayerToBatch(std::shared_ptr<Player> player, DBQueryBatch &batch);
 	static uint32_t getGuidByName(const std::string &name);
 	static bool getGuidByNameEx(uint32_t &guid, bool &specialVip, std::string &name);
 	static std::string getNameByGuid(uint32_t guid);
 	static bool formatPlayerName(std::string &name);
 	static void increaseBankBalance(uint32_t guid, uint64_t bankBalance);
+	// Takes each amount from the bank balance of its player, with a single query
+	static bool decreaseBankBalances(const phmap::flat_hash_map<uint32_t, uint64_t> &amounts);
 	static bool hasBiddedOnHouse(uint32_t guid);
 
 	static std::vector<VIPEntry> getVIPEntries(uint32_t accountId);
@@ -43,6 +54,13 @@ public:
 	static void addGuidVIPGroupEntry(uint8_t groupId, uint32_t accountId, uint32_t guid);
 	static void removeGuidVIPGroupEntry(uint32_t accountId, uint32_t guid);
 
+protected:
+	/**
+	 * @brief Hash of a stored item row, used to tell which rows changed since the last save.
+	 */
+	static uint64_t hashItemRow(int32_t pid, uint16_t itemType, uint16_t count, const char* attributes, size_t attributesSize);
+
 private:
 	static bool savePlayerGuard(std::shared_ptr<Player> player);
+	static std::string getPlayerByIdQuery(uint32_t id);
 };
@@ -12,6 +12,9 @@
 #include "game/movement/teleport.hpp"
 #include "game/game.hpp"
 #include "io/filestream.hpp"
+#include "io/iomapsnapshot.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "game/scheduling/task_graph.hpp"
 
 /*
     OTBM_ROOTV1
@@ -66,15 +69,34 @@ void IOMap::loadMap(Map* map, const Position &pos) {
 		throw IOMapException("This map need to be upgraded by using the latest map editor version to be able to load correctly.");
 	}
 
+	const bool useSnapshot = g_configManager().getBoolean(MAP_SNAPSHOT, __FUNCTION__);
+	const uint64_t snapshotKey = useSnapshot ? IOMapSnapshot::getKey(fileByte, pos) : 0;
+	std::unique_ptr<IOMapSnapshot> snapshot;
+
 	if (stream.startNode(OTBM_MAP_DATA)) {
 		parseMapDataAttributes(stream, map);
-		parseTileArea(stream, *map, pos);
+		if (useSnapshot && IOMapSnapshot::load(*map, IOMapSnapshot::getPath(map->path), snapshotKey)) {
+			while (stream.startNode(OTBM_TILE_AREA)) {
+				if (!stream.skipNode()) {
+					throw IOMapException("Could not end node.");
+				}
+			}
+		} else {
+			if (useSnapshot) {
+				snapshot = std::make_unique<IOMapSnapshot>();
+			}
+			parseTileAreas(stream, *map, pos, snapshot.get());
+		}
 		stream.endNode();
 	}
 
 	parseTowns(stream, *map);
 	parseWaypoints(stream, *map);
 
+	if (snapshot) {
+		snapshot->save(IOMapSnapshot::getPath(map->path), snapshotKey);
+	}
+
 	map->flush();
 
 	g_logger().debug("Map Loaded {} ({}x{}) in {} milliseconds", map->path.filename().string(), map->width, map->height, bm_mapLoad.duration());
@@ -116,132 +138,209 @@ void IOMap::parseMapDataAttributes(FileStream &stream, Map* map) {
 	}
 }
 
-void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos) {
-	while (stream.startNode(OTBM_TILE_AREA)) {
-		const uint16_t base_x = stream.getU16();
-		const uint16_t base_y = stream.getU16();
-		const uint8_t base_z = stream.getU8();
+void IOMap::parseTileAreas(FileStream &stream, Map &map, const Position &pos, IOMapSnapshot* snapshot) {
+	// First pass, only the offsets of the tile areas
+	std::vector<uint32_t> areaOffsets;
+	for (uint32_t offset = stream.tell(); stream.startNode(OTBM_TILE_AREA); offset = stream.tell()) {
+		areaOffsets.emplace_back(offset);
+		if (!stream.skipNode()) {
+			throw IOMapException("Could not end node.");
+		}
+	}
 
-		while (stream.startNode()) {
-			const uint8_t tileType = stream.getU8();
-			if (tileType != OTBM_HOUSETILE && tileType != OTBM_TILE) {
-				throw IOMapException("Could not read tile type node.");
-			}
+	// Second pass, the areas are parsed in parallel and merged in file order, so the item cache deduplicates as a serial load would.
+	// Each area is merged as soon as it and the ones before it are parsed, while the later ones are still being parsed.
+	std::vector<TileAreaBatch> batches;
+	for (size_t first = 0; first < areaOffsets.size(); first += TILE_AREA_CHUNK) {
+		batches.clear();
+		batches.resize(std::min(TILE_AREA_CHUNK, areaOffsets.size() - first));
+
+		TaskGraph graph;
+		std::optional<TaskGraph::Node> lastMerge;
+		for (size_t i = 0; i < batches.size(); ++i) {
+			const auto parse = graph.spawn([&, i] {
+				FileStream areaStream = stream;
+				areaStream.seek(areaOffsets[first + i]);
+				try {
+					parseTileArea(areaStream, pos, batches[i]);
+				} catch (const std::exception &e) {
+					batches[i].error = e.what();
+				}
+			});
 
-			const auto tile = std::make_shared<BasicTile>();
+			auto merge = [&, i] {
+				if (!batches[i].error.empty()) {
+					throw IOMapException(batches[i].error);
+				}
+				mergeTileArea(map, batches[i], snapshot);
+			};
+			lastMerge = lastMerge ? graph.continueSerial({ parse, *lastMerge }, std::move(merge)) : graph.continueSerial({ parse }, std::move(merge));
+		}
+		graph.join();
+	}
+}
 
-			const uint8_t tileCoordsX = stream.getU8();
-			const uint8_t tileCoordsY = stream.getU8();
+void IOMap::parseTileArea(FileStream &stream, const Position &pos, TileAreaBatch &batch) {
+	if (!stream.startNode(OTBM_TILE_AREA)) {
+		throw IOMapException("Could not read tile area node.");
+	}
 
-			const uint16_t x = base_x + tileCoordsX + pos.x;
-			const uint16_t y = base_y + tileCoordsY + pos.y;
-			const uint8_t z = static_cast<uint8_t>(base_z + pos.z);
+	const uint16_t base_x = stream.getU16();
+	const uint16_t base_y = stream.getU16();
+	const uint8_t base_z = stream.getU8();
 
-			if (tileType == OTBM_HOUSETILE) {
-				tile->houseId = stream.getU32();
-				if (!map.houses.addHouse(tile->houseId)) {
-					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not create house id: {}", x, y, z, tile->houseId));
-				}
+	while (stream.startNode()) {
+		const uint8_t tileType = stream.getU8();
+		if (tileType != OTBM_HOUSETILE && tileType != OTBM_TILE) {
+			throw IOMapException("Could not read tile type node.");
+		}
+
+		const auto tile = std::make_shared<BasicTile>();
+
+		const uint8_t tileCoordsX = stream.getU8();
+		const uint8_t tileCoordsY = stream.getU8();
+
+		const uint16_t x = base_x + tileCoordsX + pos.x;
+		const uint16_t y = base_y + tileCoordsY + pos.y;
+		const uint8_t z = static_cast<uint8_t>(base_z + pos.z);
+
+		if (tileType == OTBM_HOUSETILE) {
+			tile->houseId = stream.getU32();
+		}
+
+		if (stream.isProp(OTBM_ATTR_TILE_FLAGS)) {
+			const uint32_t flags = stream.getU32();
+			if ((flags & OTBM_TILEFLAG_PROTECTIONZONE) != 0) {
+				tile->flags |= TILESTATE_PROTECTIONZONE;
+			} else if ((flags & OTBM_TILEFLAG_NOPVPZONE) != 0) {
+				tile->flags |= TILESTATE_NOPVPZONE;
+			} else if ((flags & OTBM_TILEFLAG_PVPZONE) != 0) {
+				tile->flags |= TILESTATE_PVPZONE;
 			}
 
-			if (stream.isProp(OTBM_ATTR_TILE_FLAGS)) {
-				const uint32_t flags = stream.getU32();
-				if ((flags & OTBM_TILEFLAG_PROTECTIONZONE) != 0) {
-					tile->flags |= TILESTATE_PROTECTIONZONE;
-				} else if ((flags & OTBM_TILEFLAG_NOPVPZONE) != 0) {
-					tile->flags |= TILESTATE_NOPVPZONE;
-				} else if ((flags & OTBM_TILEFLAG_PVPZONE) != 0) {
-					tile->flags |= TILESTATE_PVPZONE;
-				}
+			if ((flags & OTBM_TILEFLAG_NOLOGOUT) != 0) {
+				tile->flags |= TILESTATE_NOLOGOUT;
+			}
+		}
+
+		if (stream.isProp(OTBM_ATTR_ITEM)) {
+			const uint16_t id = stream.getU16();
+			const auto &iType = Item::items[id];
+
+			if (!tile->isHouse() || (!iType.isBed() && !iType.isTrashHolder())) {
 
-				if ((flags & OTBM_TILEFLAG_NOLOGOUT) != 0) {
-					tile->flags |= TILESTATE_NOLOGOUT;
+				const auto item = std::make_shared<BasicItem>();
+				item->id = id;
+
+				if (tile->isHouse() && iType.movable) {
+					g_logger().warn("[IOMap::loadMap] - "
+					                "Movable item with ID: {}, in house: {}, "
+					                "at position: x {}, y {}, z {}",
+					                id, tile->houseId, x, y, z);
+				} else if (iType.isGroundTile()) {
+					tile->ground = item;
+				} else {
+					tile->items.emplace_back(item);
 				}
 			}
+		}
 
-			if (stream.isProp(OTBM_ATTR_ITEM)) {
-				const uint16_t id = stream.getU16();
-				const auto &iType = Item::items[id];
+		while (stream.startNode()) {
+			auto type = stream.getU8();
+			switch (type) {
+				case OTBM_ITEM: {
+					const uint16_t id = stream.getU16();
 
-				if (!tile->isHouse() || (!iType.isBed() && !iType.isTrashHolder())) {
+					const auto &iType = Item::items[id];
 
 					const auto item = std::make_shared<BasicItem>();
 					item->id = id;
 
-					if (tile->isHouse() && iType.movable) {
+					if (!item->unserializeItemNode(stream, x, y, z)) {
+						throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Failed to load item {}, Node Type.", x, y, z, id));
+					}
+
+					if (tile->isHouse() && (iType.isBed() || iType.isTrashHolder())) {
+						// nothing
+					} else if (tile->isHouse() && iType.movable) {
 						g_logger().warn("[IOMap::loadMap] - "
 						                "Movable item with ID: {}, in house: {}, "
 						                "at position: x {}, y {}, z {}",
 						                id, tile->houseId, x, y, z);
 					} else if (iType.isGroundTile()) {
-						tile->ground = map.tryReplaceItemFromCache(item);
+						tile->ground = item;
 					} else {
-						tile->items.emplace_back(map.tryReplaceItemFromCache(item));
+						tile->items.emplace_back(item);
 					}
-				}
+				} break;
+				case OTBM_TILE_ZONE: {
+					const auto zoneCount = stream.getU16();
+					for (uint16_t i = 0; i < zoneCount; ++i) {
+						const auto zoneId = stream.getU16();
+						if (!zoneId) {
+							throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Invalid zone id.", x, y, z));
+						}
+						batch.zonePositions.emplace_back(zoneId, Position(x, y, z));
+					}
+				} break;
+				default:
+					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not read item/zone node.", x, y, z));
 			}
 
-			while (stream.startNode()) {
-				auto type = stream.getU8();
-				switch (type) {
-					case OTBM_ITEM: {
-						const uint16_t id = stream.getU16();
-
-						const auto &iType = Item::items[id];
+			if (!stream.endNode()) {
+				throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
+			}
+		}
 
-						const auto item = std::make_shared<BasicItem>();
-						item->id = id;
+		if (!stream.endNode()) {
+			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
+		}
 
-						if (!item->unserializeItemNode(stream, x, y, z)) {
-							throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Failed to load item {}, Node Type.", x, y, z, id));
-						}
+		batch.tiles.emplace_back(Position(x, y, z), tile);
+	}
 
-						if (tile->isHouse() && (iType.isBed() || iType.isTrashHolder())) {
-							// nothing
-						} else if (tile->isHouse() && iType.movable) {
-							g_logger().warn("[IOMap::loadMap] - "
-							                "Movable item with ID: {}, in house: {}, "
-							                "at position: x {}, y {}, z {}",
-							                id, tile->houseId, x, y, z);
-						} else if (iType.isGroundTile()) {
-							tile->ground = map.tryReplaceItemFromCache(item);
-						} else {
-							tile->items.emplace_back(map.tryReplaceItemFromCache(item));
-						}
-					} break;
-					case OTBM_TILE_ZONE: {
-						const auto zoneCount = stream.getU16();
-						for (uint16_t i = 0; i < zoneCount; ++i) {
-							const auto zoneId = stream.getU16();
-							if (!zoneId) {
-								throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Invalid zone id.", x, y, z));
-							}
-							auto zone = Zone::getZone(zoneId);
-							zone->addPosition(Position(x, y, z));
-						}
-					} break;
-					default:
-						throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not read item/zone node.", x, y, z));
-				}
+	if (!stream.endNode()) {
+		throw IOMapException("Could not end node.");
+	}
+}
 
-				if (!stream.endNode()) {
-					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
-				}
-			}
+void IOMap::mergeTileArea(Map &map, TileAreaBatch &batch, IOMapSnapshot* snapshot) {
+	// Children before their container, as the serial load cached them
+	const std::function<std::shared_ptr<BasicItem>(const std::shared_ptr<BasicItem> &)> replaceFromCache = [&](const std::shared_ptr<BasicItem> &item) {
+		for (auto &itemInside : item->items) {
+			itemInside = replaceFromCache(itemInside);
+		}
+		return map.tryReplaceItemFromCache(item);
+	};
 
-			if (!stream.endNode()) {
-				throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
-			}
+	for (const auto &[position, tile] : batch.tiles) {
+		if (tile->isHouse() && !map.houses.addHouse(tile->houseId)) {
+			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not create house id: {}", position.x, position.y, position.z, tile->houseId));
+		}
+		if (tile->isHouse() && snapshot) {
+			snapshot->addHouse(tile->houseId);
+		}
 
-			if (tile->isEmpty(true)) {
-				continue;
-			}
+		if (tile->isEmpty(true)) {
+			continue;
+		}
 
-			map.setBasicTile(x, y, z, tile);
+		if (tile->ground) {
+			tile->ground = replaceFromCache(tile->ground);
+		}
+		for (auto &item : tile->items) {
+			item = replaceFromCache(item);
 		}
+		const auto storedTile = map.setBasicTile(position.x, position.y, position.z, tile);
+		if (snapshot && storedTile) {
+			snapshot->addTile(position, storedTile);
+		}
+	}
 
-		if (!stream.endNode()) {
-			throw IOMapException("Could not end node.");
+	for (const auto &[zoneId, position] : batch.zonePositions) {
+		Zone::getZone(zoneId)->addPosition(position);
+		if (snapshot) {
+			snapshot->addZonePosition(zoneId, position);
 		}
 	}
 }
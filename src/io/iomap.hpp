@@ -19,6 +19,8 @@
 #include "creatures/npcs/spawns/spawn_npc.hpp"
 #include "game/zones/zone.hpp"
 
+class IOMapSnapshot;
+
 class IOMap {
 public:
 	static void loadMap(Map* map, const Position &pos = Position());
@@ -152,7 +154,19 @@ private:
 	static void parseMapDataAttributes(FileStream &stream, Map* map);
 	static void parseWaypoints(FileStream &stream, Map &map);
 	static void parseTowns(FileStream &stream, Map &map);
-	static void parseTileArea(FileStream &stream, Map &map, const Position &pos);
+
+	// Tile areas parsed and merged per round, bounds the tiles held before deduplication
+	static constexpr size_t TILE_AREA_CHUNK = 4096;
+
+	struct TileAreaBatch {
+		std::vector<std::pair<Position, std::shared_ptr<BasicTile>>> tiles;
+		std::vector<std::pair<uint16_t, Position>> zonePositions;
+		std::string error;
+	};
+
+	static void parseTileAreas(FileStream &stream, Map &map, const Position &pos, IOMapSnapshot* snapshot);
+	static void parseTileArea(FileStream &stream, const Position &pos, TileAreaBatch &batch);
+	static void mergeTileArea(Map &map, TileAreaBatch &batch, IOMapSnapshot* snapshot);
 };
 
 class IOMapException : public std::exception {
@@ -12,43 +12,100 @@
 #include "io/iomapserialize.hpp"
 #include "io/iologindata.hpp"
 #include "game/game.hpp"
+#include "game/scheduling/dispatcher.hpp"
 #include "items/bed.hpp"
 
+namespace {
+	// Houses read per query, the rows of a chunk are decoded together
+	constexpr size_t HOUSE_ITEMS_LOAD_CHUNK = 256;
+
+	struct HouseTileRow {
+		std::string data;
+		std::shared_ptr<Tile> tile;
+		std::vector<std::shared_ptr<Item>> items;
+		// Decoded on the thread pool, otherwise the row is read again by loadHouseTile
+		bool detached = false;
+	};
+}
+
 void IOMapSerialize::loadHouseItems(Map* map) {
 	Benchmark bm_context;
+	Database &db = Database::getInstance();
 
-	DBResult_ptr result = Database::getInstance().storeQuery("SELECT `data` FROM `tile_store`");
+	DBResult_ptr result = db.storeQuery("SELECT DISTINCT `house_id` FROM `tile_store` ORDER BY `house_id`");
 	if (!result) {
 		return;
 	}
 
+	std::vector<uint32_t> houseIds;
 	do {
-		unsigned long attrSize;
-		const char* attr = result->getStream("data", attrSize);
-
-		PropStream propStream;
-		propStream.init(attr, attrSize);
+		houseIds.emplace_back(result->getNumber<uint32_t>("house_id"));
+	} while (result->next());
 
-		uint16_t x, y;
-		uint8_t z;
-		if (!propStream.read<uint16_t>(x) || !propStream.read<uint16_t>(y) || !propStream.read<uint8_t>(z)) {
+	const auto isTransferOnRestart = g_configManager().getBoolean(TOGGLE_HOUSE_TRANSFER_ON_SERVER_RESTART, __FUNCTION__);
+	size_t tileCount = 0;
+	size_t serialTileCount = 0;
+	std::vector<HouseTileRow> rows;
+	for (size_t first = 0; first < houseIds.size(); first += HOUSE_ITEMS_LOAD_CHUNK) {
+		const auto last = std::min(first + HOUSE_ITEMS_LOAD_CHUNK, houseIds.size());
+		result = db.storeQuery(fmt::format("SELECT `data` FROM `tile_store` WHERE `house_id` IN ({})", fmt::join(houseIds.begin() + first, houseIds.begin() + last, ",")));
+		if (!result) {
 			continue;
 		}
 
-		std::shared_ptr<Tile> tile = map->getTile(x, y, z);
-		if (!tile) {
-			continue;
-		}
+		rows.clear();
+		do {
+			unsigned long attrSize;
+			const char* attr = result->getStream("data", attrSize);
+			rows.emplace_back().data.assign(attr, attrSize);
+		} while (result->next());
 
-		uint32_t item_count;
-		if (!propStream.read<uint32_t>(item_count)) {
-			continue;
-		}
+		g_dispatcher().asyncWait(rows.size(), [map, &rows](size_t i) {
+			auto &row = rows[i];
+			PropStream propStream;
+			propStream.init(row.data.data(), row.data.size());
+
+			uint16_t x, y;
+			uint8_t z;
+			uint32_t itemCount;
+			if (!propStream.read<uint16_t>(x) || !propStream.read<uint16_t>(y) || !propStream.read<uint8_t>(z) || !propStream.read<uint32_t>(itemCount)) {
+				return;
+			}
+
+			row.tile = map->getTile(x, y, z);
+			if (!row.tile) {
+				return;
+			}
+
+			row.items.reserve(itemCount);
+			while (itemCount--) {
+				auto item = loadDetachedItem(propStream, true);
+				if (!item) {
+					row.items.clear();
+					return;
+				}
+				row.items.emplace_back(std::move(item));
+			}
+			row.detached = true;
+		});
+
+		// Attached in the order of the rows, as the serial load did
+		for (auto &row : rows) {
+			++tileCount;
+			if (!row.detached) {
+				++serialTileCount;
+				PropStream propStream;
+				propStream.init(row.data.data(), row.data.size());
+				loadHouseTile(map, propStream);
+				continue;
+			}
+
+			if (row.items.empty()) {
+				continue;
+			}
 
-		while (item_count--) {
-			if (auto houseTile = std::dynamic_pointer_cast<HouseTile>(tile)) {
+			if (auto houseTile = std::dynamic_pointer_cast<HouseTile>(row.tile)) {
 				const auto &house = houseTile->getHouse();
-				auto isTransferOnRestart = g_configManager().getBoolean(TOGGLE_HOUSE_TRANSFER_ON_SERVER_RESTART, __FUNCTION__);
 				if (!isTransferOnRestart && house->getOwner() == 0) {
 					g_logger().trace("Skipping load item from house id: {}, position: {}, house does not have owner", house->getId(), house->getEntryPosition().toString());
 					house->clearHouseInfo(false);
@@ -56,37 +113,137 @@ void IOMapSerialize::loadHouseItems(Map* map) {
 				}
 			}
 
-			loadItem(propStream, tile, true);
+			for (const auto &item : row.items) {
+				row.tile->internalAddThing(item);
+				item->startDecaying();
+			}
 		}
-	} while (result->next());
-	g_logger().info("Loaded house items in {} milliseconds", bm_context.duration());
+	}
+	g_logger().info("Loaded house items in {} milliseconds ({} tiles, {} read serially)", bm_context.duration(), tileCount, serialTileCount);
+}
+
+void IOMapSerialize::loadHouseTile(Map* map, PropStream &propStream) {
+	uint16_t x, y;
+	uint8_t z;
+	if (!propStream.read<uint16_t>(x) || !propStream.read<uint16_t>(y) || !propStream.read<uint8_t>(z)) {
+		return;
+	}
+
+	std::shared_ptr<Tile> tile = map->getTile(x, y, z);
+	if (!tile) {
+		return;
+	}
+
+	uint32_t item_count;
+	if (!propStream.read<uint32_t>(item_count)) {
+		return;
+	}
+
+	while (item_count--) {
+		if (auto houseTile = std::dynamic_pointer_cast<HouseTile>(tile)) {
+			const auto &house = houseTile->getHouse();
+			auto isTransferOnRestart = g_configManager().getBoolean(TOGGLE_HOUSE_TRANSFER_ON_SERVER_RESTART, __FUNCTION__);
+			if (!isTransferOnRestart && house->getOwner() == 0) {
+				g_logger().trace("Skipping load item from house id: {}, position: {}, house does not have owner", house->getId(), house->getEntryPosition().toString());
+				house->clearHouseInfo(false);
+				continue;
+			}
+		}
+
+		loadItem(propStream, tile, true);
+	}
 }
 
+std::shared_ptr<Item> IOMapSerialize::loadDetachedItem(PropStream &propStream, bool onTile) {
+	uint16_t id;
+	if (!propStream.read<uint16_t>(id)) {
+		return nullptr;
+	}
+
+	// Beds register their sleeper in the game while reading their attributes, stationary items are merged into the map ones
+	const ItemType &iType = Item::items[id];
+	if (iType.isBed() || (onTile && !iType.movable && !iType.isCarpet() && !iType.isTrashHolder())) {
+		return nullptr;
+	}
+
+	auto item = Item::CreateItem(id);
+	if (!item || !item->unserializeAttr(propStream)) {
+		return nullptr;
+	}
+
+	if (std::shared_ptr<Container> container = item->getContainer()) {
+		while (container->serializationCount > 0) {
+			auto child = loadDetachedItem(propStream, false);
+			if (!child) {
+				return nullptr;
+			}
+			container->internalAddThing(child);
+			container->serializationCount--;
+		}
+
+		uint8_t endAttr;
+		if (!propStream.read<uint8_t>(endAttr) || endAttr != 0) {
+			return nullptr;
+		}
+	}
+	return item;
+}
+
+bool IOMapSerialize::houseItemsSaved = false;
+
 bool IOMapSerialize::saveHouseItems() {
-	bool success = DBTransaction::executeWithinTransaction([]() {
-		return SaveHouseItemsGuard();
+	HouseItemsSave save;
+	bool success = DBTransaction::executeWithinTransaction([&save]() {
+		save = HouseItemsSave();
+		return SaveHouseItemsGuard(save);
 	});
 
 	if (!success) {
 		g_logger().error("[{}] Error occurred saving houses", __FUNCTION__);
+		return false;
 	}
 
-	return success;
+	onHouseItemsSaved(save);
+	return true;
+}
+
+void IOMapSerialize::onHouseItemsSaved(const HouseItemsSave &save) {
+	for (const auto &[house, version] : save.houses) {
+		house->setSavedItemsVersion(version);
+	}
+	if (save.full) {
+		houseItemsSaved = true;
+	}
 }
 
-bool IOMapSerialize::SaveHouseItemsGuard() {
+bool IOMapSerialize::SaveHouseItemsGuard(HouseItemsSave &save) {
 	Database &db = Database::getInstance();
 	std::ostringstream query;
 
+	save.full = !houseItemsSaved;
+	std::string changedHouses;
+	for (const auto &[key, house] : g_game().map.houses.getHouses()) {
+		if (save.full || house->hasUnsavedItems()) {
+			save.houses.emplace_back(house, house->getItemsVersion());
+			changedHouses += fmt::format("{}{}", changedHouses.empty() ? "" : ",", house->getId());
+		}
+	}
+
 	// clear old tile data
-	if (!db.executeQuery("DELETE FROM `tile_store`")) {
+	if (save.full) {
+		if (!db.executeQuery("DELETE FROM `tile_store`")) {
+			return false;
+		}
+	} else if (changedHouses.empty()) {
+		return true;
+	} else if (!db.executeQuery(fmt::format("DELETE FROM `tile_store` WHERE `house_id` IN ({})", changedHouses))) {
 		return false;
 	}
 
 	DBInsert stmt("INSERT INTO `tile_store` (`house_id`, `data`) VALUES ");
 
 	PropWriteStream stream;
-	for (const auto &[key, house] : g_game().map.houses.getHouses()) {
+	for (const auto &[house, version] : save.houses) {
 		// save house items
 		for (const auto &tile : house->getTiles()) {
 			saveTile(stream, tile);
@@ -329,6 +486,20 @@ bool IOMapSerialize::saveHouseInfo() {
 	return success;
 }
 
+bool IOMapSerialize::saveHousesToBatch(DBQueryBatch &batch, HouseItemsSave &save) {
+	DBQueryBatch::Capture capture(batch);
+	if (!SaveHouseInfoGuard()) {
+		g_logger().error("[{}] Error occurred capturing houses info", __FUNCTION__);
+		return false;
+	}
+
+	if (!SaveHouseItemsGuard(save)) {
+		g_logger().error("[{}] Error occurred capturing houses", __FUNCTION__);
+		return false;
+	}
+	return true;
+}
+
 bool IOMapSerialize::SaveHouseInfoGuard() {
 	Database &db = Database::getInstance();
 
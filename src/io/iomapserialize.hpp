@@ -11,19 +11,49 @@
 
 #include "map/map.hpp"
 
+class DBQueryBatch;
+
 class IOMapSerialize {
 public:
+	// Houses written by a save of the house items, with the version of their items at that time
+	struct HouseItemsSave {
+		std::vector<std::pair<std::shared_ptr<House>, uint32_t>> houses;
+		bool full = false;
+	};
+
+
 	static void loadHouseItems(Map* map);
 	static bool saveHouseItems();
 	static bool loadHouseInfo();
 	static bool saveHouseInfo();
+	/**
+	 * @brief Builds the queries of the house info and items save without running them.
+	 */
+	static bool saveHousesToBatch(DBQueryBatch &batch, HouseItemsSave &save);
+	/**
+	 * @brief Marks the houses of a save as saved, once its queries succeeded. Dispatcher only.
+	 */
+	static void onHouseItemsSaved(const HouseItemsSave &save);
 
 private:
 	static bool SaveHouseInfoGuard();
-	static bool SaveHouseItemsGuard();
+	static bool SaveHouseItemsGuard(HouseItemsSave &save);
+
+	// Until a save succeeded, the rows of tile_store may belong to houses which are not in the map anymore
+	static bool houseItemsSaved;
 	static void saveItem(PropWriteStream &stream, std::shared_ptr<Item> item);
 	static void saveTile(PropWriteStream &stream, std::shared_ptr<Tile> tile);
 
+	/**
+	 * @brief Reads the items of one tile_store row straight into the map.
+	 */
+	static void loadHouseTile(Map* map, PropStream &propStream);
+	/**
+	 * @brief Reads an item and its contents without a parent, safe to run off the dispatcher.
+	 * @return nullptr when the item must be read by loadItem instead: beds, stationary tile items or read errors.
+	 */
+	static std::shared_ptr<Item> loadDetachedItem(PropStream &propStream, bool onTile);
+
 	static bool loadContainer(PropStream &propStream, std::shared_ptr<Container> container);
 	static bool loadItem(PropStream &propStream, std::shared_ptr<Cylinder> parent, bool isHouseItem = false);
 };
@@ -0,0 +1,325 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "io/iomapsnapshot.hpp"
+#include "io/fileloader.hpp"
+#include "config/configmanager.hpp"
+#include "game/zones/zone.hpp"
+#include "map/map.hpp"
+#include "utils/hash.hpp"
+
+namespace {
+	constexpr OTB::Identifier SNAPSHOT_IDENTIFIER = { { 'O', 'T', 'B', 'S' } };
+
+	size_t hashBytes(const mio::mmap_source &source) {
+		return std::hash<std::string_view>()(std::string_view(source.data(), source.size()));
+	}
+
+	size_t hashFile(const std::string &path) {
+		std::error_code error;
+		mio::mmap_source source;
+		source.map(path, error);
+		return error ? 0 : hashBytes(source);
+	}
+
+	template <typename T>
+	T readValue(PropStream &stream, bool &valid) {
+		T value {};
+		valid = valid && stream.read<T>(value);
+		return value;
+	}
+
+	bool readPosition(PropStream &stream, Position &pos) {
+		return stream.read<uint16_t>(pos.x) && stream.read<uint16_t>(pos.y) && stream.read<uint8_t>(pos.z);
+	}
+
+	void writePosition(PropWriteStream &stream, const Position &pos) {
+		stream.write<uint16_t>(pos.x);
+		stream.write<uint16_t>(pos.y);
+		stream.write<uint8_t>(pos.z);
+	}
+}
+
+uint64_t IOMapSnapshot::getKey(const mio::mmap_source &otbm, const Position &pos) {
+	const auto &coreFolder = g_configManager().getString(CORE_DIRECTORY, __FUNCTION__);
+
+	size_t key = VERSION;
+	stdext::hash_combine(key, hashBytes(otbm));
+	stdext::hash_combine(key, hashFile(coreFolder + "/items/items.xml"));
+	stdext::hash_combine(key, hashFile(coreFolder + "/items/appearances.dat"));
+	stdext::hash_combine(key, static_cast<uint64_t>(pos.x) | static_cast<uint64_t>(pos.y) << 16 | static_cast<uint64_t>(pos.z) << 32);
+	return key;
+}
+
+std::filesystem::path IOMapSnapshot::getPath(const std::filesystem::path &mapPath) {
+	auto path = mapPath;
+	path += ".snapshot";
+	return path;
+}
+
+bool IOMapSnapshot::load(Map &map, const std::filesystem::path &path, uint64_t key) {
+	Benchmark bm_snapshotLoad;
+
+	std::error_code error;
+	mio::mmap_source source;
+	source.map(path.string(), error);
+	if (error) {
+		return false;
+	}
+
+	PropStream stream;
+	stream.init(source.data(), source.size());
+
+	OTB::Identifier identifier;
+	uint32_t version;
+	uint64_t snapshotKey;
+	if (!stream.read(identifier) || identifier != SNAPSHOT_IDENTIFIER || !stream.read<uint32_t>(version) || version != VERSION || !stream.read<uint64_t>(snapshotKey)) {
+		g_logger().warn("[IOMapSnapshot::load] - Ignoring invalid map snapshot {}", path.string());
+		return false;
+	}
+
+	if (snapshotKey != key) {
+		g_logger().info("Map snapshot {} is outdated, it will be rebuilt", path.filename().string());
+		return false;
+	}
+
+	// Everything is read before the map is touched, a broken file leaves it as it was
+	bool valid = true;
+	// Every entry takes at least a byte, a larger count is a broken file and not an allocation
+	const auto readCount = [&]() {
+		const auto count = readValue<uint32_t>(stream, valid);
+		valid = valid && count <= stream.size();
+		return valid ? count : 0;
+	};
+
+	const auto readItems = [&](const std::vector<std::shared_ptr<BasicItem>> &table, size_t tableSize) {
+		std::vector<std::shared_ptr<BasicItem>> list(readCount());
+		for (auto &item : list) {
+			const auto index = readValue<uint32_t>(stream, valid);
+			if (!valid || index >= tableSize) {
+				valid = false;
+				return list;
+			}
+			item = table[index];
+		}
+		return list;
+	};
+
+	std::vector<std::shared_ptr<BasicItem>> itemTable(readCount());
+	for (size_t i = 0; valid && i < itemTable.size(); ++i) {
+		// BasicItem is packed, its fields are read by value
+		const auto item = std::make_shared<BasicItem>();
+		item->id = readValue<uint16_t>(stream, valid);
+		item->charges = readValue<uint16_t>(stream, valid);
+		item->actionId = readValue<uint16_t>(stream, valid);
+		item->uniqueId = readValue<uint16_t>(stream, valid);
+		item->destX = readValue<uint16_t>(stream, valid);
+		item->destY = readValue<uint16_t>(stream, valid);
+		item->destZ = readValue<uint8_t>(stream, valid);
+		item->doorOrDepotId = readValue<uint16_t>(stream, valid);
+		std::string text;
+		valid = valid && stream.readString(text);
+		if (!text.empty()) {
+			item->text = g_stringPool().intern(text);
+		}
+		// Only the items before this one, so a container never holds itself
+		item->items = readItems(itemTable, i);
+		itemTable[i] = item;
+	}
+
+	std::vector<std::shared_ptr<BasicTile>> tileTable(readCount());
+	for (auto &tile : tileTable) {
+		tile = std::make_shared<BasicTile>();
+		const auto ground = readValue<uint32_t>(stream, valid);
+		if (ground != NO_ITEM) {
+			valid = valid && ground < itemTable.size();
+			tile->ground = valid ? itemTable[ground] : nullptr;
+		}
+		tile->flags = readValue<uint32_t>(stream, valid);
+		tile->houseId = readValue<uint32_t>(stream, valid);
+		tile->type = readValue<uint8_t>(stream, valid);
+		tile->isStatic = readValue<uint8_t>(stream, valid) != 0;
+		tile->items = readItems(itemTable, itemTable.size());
+		if (!valid) {
+			break;
+		}
+	}
+
+	std::vector<std::pair<Position, uint32_t>> positions(readCount());
+	for (auto &[pos, tile] : positions) {
+		if (!valid) {
+			break;
+		}
+		valid = readPosition(stream, pos) && stream.read<uint32_t>(tile) && tile < tileTable.size();
+	}
+
+	std::vector<uint32_t> houseList(readCount());
+	for (auto &houseId : houseList) {
+		houseId = readValue<uint32_t>(stream, valid);
+	}
+
+	std::vector<std::pair<uint16_t, Position>> zones(readCount());
+	for (auto &[zoneId, pos] : zones) {
+		if (!valid) {
+			break;
+		}
+		valid = stream.read<uint16_t>(zoneId) && readPosition(stream, pos);
+	}
+
+	if (!valid || stream.size() != 0) {
+		g_logger().warn("[IOMapSnapshot::load] - Ignoring broken map snapshot {}", path.string());
+		return false;
+	}
+
+	for (const auto houseId : houseList) {
+		map.houses.addHouse(houseId);
+	}
+
+	for (const auto &[pos, tile] : positions) {
+		map.setBasicTile(pos.x, pos.y, pos.z, tileTable[tile], false);
+	}
+
+	for (const auto &[zoneId, pos] : zones) {
+		Zone::getZone(zoneId)->addPosition(pos);
+	}
+
+	g_logger().debug("Map snapshot {} loaded in {} milliseconds", path.filename().string(), bm_snapshotLoad.duration());
+	return true;
+}
+
+void IOMapSnapshot::addTile(const Position &pos, const std::shared_ptr<BasicTile> &tile) {
+	tilePositions.emplace_back(pos, getTileIndex(tile));
+}
+
+void IOMapSnapshot::addHouse(uint32_t houseId) {
+	if (houseIds.emplace(houseId).second) {
+		houses.emplace_back(houseId);
+	}
+}
+
+void IOMapSnapshot::addZonePosition(uint16_t zoneId, const Position &pos) {
+	zonePositions.emplace_back(zoneId, pos);
+}
+
+uint32_t IOMapSnapshot::getItemIndex(const std::shared_ptr<BasicItem> &item) {
+	if (!item) {
+		return NO_ITEM;
+	}
+
+	if (const auto it = itemIndexes.find(item.get()); it != itemIndexes.end()) {
+		return it->second;
+	}
+
+	for (const auto &itemInside : item->items) {
+		getItemIndex(itemInside);
+	}
+
+	const auto index = static_cast<uint32_t>(items.size());
+	items.emplace_back(item);
+	itemIndexes.emplace(item.get(), index);
+	return index;
+}
+
+uint32_t IOMapSnapshot::getTileIndex(const std::shared_ptr<BasicTile> &tile) {
+	if (const auto it = tileIndexes.find(tile.get()); it != tileIndexes.end()) {
+		return it->second;
+	}
+
+	getItemIndex(tile->ground);
+	for (const auto &item : tile->items) {
+		getItemIndex(item);
+	}
+
+	const auto index = static_cast<uint32_t>(tiles.size());
+	tiles.emplace_back(tile);
+	tileIndexes.emplace(tile.get(), index);
+	return index;
+}
+
+bool IOMapSnapshot::save(const std::filesystem::path &path, uint64_t key) {
+	Benchmark bm_snapshotSave;
+
+	PropWriteStream stream;
+	stream.write(SNAPSHOT_IDENTIFIER);
+	stream.write<uint32_t>(VERSION);
+	stream.write<uint64_t>(key);
+
+	stream.write<uint32_t>(static_cast<uint32_t>(items.size()));
+	for (const auto &item : items) {
+		stream.write<uint16_t>(item->id);
+		stream.write<uint16_t>(item->charges);
+		stream.write<uint16_t>(item->actionId);
+		stream.write<uint16_t>(item->uniqueId);
+		stream.write<uint16_t>(item->destX);
+		stream.write<uint16_t>(item->destY);
+		stream.write<uint8_t>(item->destZ);
+		stream.write<uint16_t>(item->doorOrDepotId);
+		stream.writeString(item->text ? *item->text : std::string());
+		stream.write<uint32_t>(static_cast<uint32_t>(item->items.size()));
+		for (const auto &itemInside : item->items) {
+			stream.write<uint32_t>(itemIndexes.at(itemInside.get()));
+		}
+	}
+
+	stream.write<uint32_t>(static_cast<uint32_t>(tiles.size()));
+	for (const auto &tile : tiles) {
+		stream.write<uint32_t>(tile->ground ? itemIndexes.at(tile->ground.get()) : NO_ITEM);
+		stream.write<uint32_t>(tile->flags);
+		stream.write<uint32_t>(tile->houseId);
+		stream.write<uint8_t>(tile->type);
+		stream.write<uint8_t>(tile->isStatic);
+		stream.write<uint32_t>(static_cast<uint32_t>(tile->items.size()));
+		for (const auto &item : tile->items) {
+			stream.write<uint32_t>(itemIndexes.at(item.get()));
+		}
+	}
+
+	stream.write<uint32_t>(static_cast<uint32_t>(tilePositions.size()));
+	for (const auto &[pos, tile] : tilePositions) {
+		writePosition(stream, pos);
+		stream.write<uint32_t>(tile);
+	}
+
+	stream.write<uint32_t>(static_cast<uint32_t>(houses.size()));
+	for (const auto houseId : houses) {
+		stream.write<uint32_t>(houseId);
+	}
+
+	stream.write<uint32_t>(static_cast<uint32_t>(zonePositions.size()));
+	for (const auto &[zoneId, pos] : zonePositions) {
+		stream.write<uint16_t>(zoneId);
+		writePosition(stream, pos);
+	}
+
+	// Written aside and renamed, a boot never reads a half written snapshot
+	auto tempPath = path;
+	tempPath += ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		size_t size;
+		const char* data = stream.getStream(size);
+		if (!file.write(data, static_cast<std::streamsize>(size))) {
+			g_logger().warn("[IOMapSnapshot::save] - Could not write map snapshot {}", tempPath.string());
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, path, error);
+	if (error) {
+		g_logger().warn("[IOMapSnapshot::save] - Could not write map snapshot {}: {}", path.string(), error.message());
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+
+	g_logger().debug("Map snapshot {} saved in {} milliseconds", path.filename().string(), bm_snapshotSave.duration());
+	return true;
+}
@@ -0,0 +1,63 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/movement/position.hpp"
+
+class Map;
+struct BasicItem;
+struct BasicTile;
+
+/**
+ * Binary copy of the tiles parsed from an OTBM file.
+ *
+ * It holds the deduplicated BasicItem and BasicTile tables, the position of
+ * every tile, the houses and the zone positions of the map, so a later boot
+ * reads them back without parsing the tile areas nor hashing the items again.
+ * The key covers the OTBM file, items.xml, appearances.dat and the position
+ * the map is loaded at; a snapshot with another key is ignored and rebuilt.
+ */
+class IOMapSnapshot {
+public:
+	static uint64_t getKey(const mio::mmap_source &otbm, const Position &pos);
+
+	// Kept next to the map file it was built from
+	static std::filesystem::path getPath(const std::filesystem::path &mapPath);
+
+	/**
+	 * @brief Sets the tiles, houses and zone positions of the snapshot into the map.
+	 * Nothing is set when the file is missing, built for another key or broken.
+	 */
+	static bool load(Map &map, const std::filesystem::path &path, uint64_t key);
+
+	void addTile(const Position &pos, const std::shared_ptr<BasicTile> &tile);
+	void addHouse(uint32_t houseId);
+	void addZonePosition(uint16_t zoneId, const Position &pos);
+
+	bool save(const std::filesystem::path &path, uint64_t key);
+
+private:
+	static constexpr uint32_t VERSION = 1;
+	static constexpr uint32_t NO_ITEM = std::numeric_limits<uint32_t>::max();
+
+	uint32_t getItemIndex(const std::shared_ptr<BasicItem> &item);
+	uint32_t getTileIndex(const std::shared_ptr<BasicTile> &tile);
+
+	// Tables written in index order, the items inside a container before it
+	std::vector<std::shared_ptr<BasicItem>> items;
+	std::vector<std::shared_ptr<BasicTile>> tiles;
+	std::unordered_map<const BasicItem*, uint32_t> itemIndexes;
+	std::unordered_map<const BasicTile*, uint32_t> tileIndexes;
+
+	std::vector<std::pair<Position, uint32_t>> tilePositions;
+	std::vector<uint32_t> houses;
+	std::unordered_set<uint32_t> houseIds;
+	std::vector<std::pair<uint16_t, Position>> zonePositions;
+};
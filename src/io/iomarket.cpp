@@ -26,105 +26,139 @@ uint8_t IOMarket::getTierFromDatabaseTable(const std::string &string) {
 	return tier;
 }
 
-MarketOfferList IOMarket::getActiveOffers(MarketAction_t action) {
-	MarketOfferList offerList;
-
-	std::string query = fmt::format(
-		"SELECT `id`, `itemtype`, `amount`, `price`, `tier`, `created`, `anonymous`, "
-		"(SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` "
-		"FROM `market_offers` WHERE `sale` = {}",
-		action
+void IOMarket::loadOffers() {
+	offers.clear();
+	books.clear();
+	playerOffers.clear();
+	nextOfferId = 1;
+
+	DBResult_ptr result = g_database().storeQuery(
+		"SELECT `id`, `player_id`, `sale`, `itemtype`, `amount`, `created`, `anonymous`, `price`, `tier`, "
+		"(SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers`"
 	);
-
-	DBResult_ptr result = g_database().storeQuery(query);
 	if (!result) {
-		return offerList;
+		return;
 	}
 
-	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION, __FUNCTION__);
-
 	do {
-		MarketOffer offer;
-		offer.itemId = result->getNumber<uint16_t>("itemtype");
-		offer.amount = result->getNumber<uint16_t>("amount");
+		Offer offer;
+		offer.id = result->getNumber<uint32_t>("id");
+		offer.playerId = result->getNumber<uint32_t>("player_id");
+		offer.created = result->getNumber<uint32_t>("created");
 		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = result->getNumber<uint32_t>("id") & 0xFFFF;
-		if (result->getNumber<uint16_t>("anonymous") == 0) {
-			offer.playerName = result->getString("player_name");
-		} else {
-			offer.playerName = "Anonymous";
-		}
+		offer.amount = result->getNumber<uint16_t>("amount");
+		offer.itemId = result->getNumber<uint16_t>("itemtype");
+		offer.type = static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale"));
 		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-		offerList.push_back(offer);
+		offer.anonymous = result->getNumber<uint16_t>("anonymous") != 0;
+		offer.playerName = result->getString("player_name");
+		nextOfferId = std::max(nextOfferId, offer.id + 1);
+		addOffer(std::move(offer));
 	} while (result->next());
-	return offerList;
+
+	g_logger().debug("Loaded {} market offers", offers.size());
 }
 
-MarketOfferList IOMarket::getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier) {
-	MarketOfferList offerList;
+void IOMarket::addOffer(Offer offer) {
+	const uint32_t offerId = offer.id;
+	books[getBookKey(offer.type, offer.itemId, offer.tier)].emplace(offerId);
+	playerOffers[offer.playerId].emplace(offerId);
+	offers.insert_or_assign(offerId, std::move(offer));
+}
 
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `tier`, `created`, `anonymous`, (SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers` WHERE `sale` = " << action << " AND `itemtype` = " << itemId << " AND `tier` = " << std::to_string(tier);
+void IOMarket::removeOffer(uint32_t offerId) {
+	const auto it = offers.find(offerId);
+	if (it == offers.end()) {
+		return;
+	}
 
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
-		return offerList;
+	const auto &offer = it->second;
+	if (const auto book = books.find(getBookKey(offer.type, offer.itemId, offer.tier)); book != books.end()) {
+		book->second.erase(offerId);
+		if (book->second.empty()) {
+			books.erase(book);
+		}
+	}
+
+	if (const auto own = playerOffers.find(offer.playerId); own != playerOffers.end()) {
+		own->second.erase(offerId);
+		if (own->second.empty()) {
+			playerOffers.erase(own);
+		}
 	}
+	offers.erase(it);
+}
 
-	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION, __FUNCTION__);
+MarketOffer IOMarket::toMarketOffer(const Offer &offer, bool withName) {
+	MarketOffer marketOffer;
+	marketOffer.price = offer.price;
+	marketOffer.timestamp = offer.created + g_configManager().getNumber(MARKET_OFFER_DURATION, __FUNCTION__);
+	marketOffer.amount = offer.amount;
+	marketOffer.counter = offer.id & 0xFFFF;
+	marketOffer.itemId = offer.itemId;
+	marketOffer.tier = offer.tier;
+	if (withName) {
+		marketOffer.playerName = offer.anonymous ? "Anonymous" : offer.playerName;
+	}
+	return marketOffer;
+}
 
-	do {
-		MarketOffer offer;
-		offer.itemId = itemId;
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = result->getNumber<uint32_t>("id") & 0xFFFF;
-		if (result->getNumber<uint16_t>("anonymous") == 0) {
-			offer.playerName = result->getString("player_name");
-		} else {
-			offer.playerName = "Anonymous";
+void IOMarket::executeWrite(const std::string &query) {
+	// The database workers keep the order of the queries of a table, the thread pool does not
+	if (g_databaseTasks().hasWorkers()) {
+		g_databaseTasks().execute(query);
+	} else {
+		g_database().executeQuery(query);
+	}
+}
+
+MarketOfferList IOMarket::getActiveOffers(MarketAction_t action) {
+	MarketOfferList offerList;
+	for (const auto &[offerId, offer] : getInstance().offers) {
+		if (offer.type == action) {
+			offerList.push_back(toMarketOffer(offer, true));
 		}
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-		offerList.push_back(offer);
-	} while (result->next());
+	}
 	return offerList;
 }
 
-MarketOfferList IOMarket::getOwnOffers(MarketAction_t action, uint32_t playerId) {
+MarketOfferList IOMarket::getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier) {
 	MarketOfferList offerList;
+	const auto &market = getInstance();
+	const auto book = market.books.find(getBookKey(action, itemId, tier));
+	if (book == market.books.end()) {
+		return offerList;
+	}
 
-	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION, __FUNCTION__);
-
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `created`, `itemtype`, `tier` FROM `market_offers` WHERE `player_id` = " << playerId << " AND `sale` = " << action;
+	for (const auto offerId : book->second) {
+		offerList.push_back(toMarketOffer(market.offers.at(offerId), true));
+	}
+	return offerList;
+}
 
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
+MarketOfferList IOMarket::getOwnOffers(MarketAction_t action, uint32_t playerId) {
+	MarketOfferList offerList;
+	const auto &market = getInstance();
+	const auto own = market.playerOffers.find(playerId);
+	if (own == market.playerOffers.end()) {
 		return offerList;
 	}
 
-	do {
-		MarketOffer offer;
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = result->getNumber<uint32_t>("id") & 0xFFFF;
-		offer.itemId = result->getNumber<uint16_t>("itemtype");
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-		offerList.push_back(offer);
-	} while (result->next());
+	for (const auto offerId : own->second) {
+		if (const auto &offer = market.offers.at(offerId); offer.type == action) {
+			offerList.push_back(toMarketOffer(offer, false));
+		}
+	}
 	return offerList;
 }
 
 HistoryMarketOfferList IOMarket::getOwnHistory(MarketAction_t action, uint32_t playerId) {
 	HistoryMarketOfferList offerList;
 
-	std::ostringstream query;
-	query << "SELECT `itemtype`, `amount`, `price`, `expires_at`, `state`, `tier` FROM `market_history` WHERE `player_id` = " << playerId << " AND `sale` = " << action;
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeStatement(
+		"SELECT `itemtype`, `amount`, `price`, `expires_at`, `state`, `tier` FROM `market_history` WHERE `player_id` = ? AND `sale` = ?",
+		{ playerId, static_cast<uint8_t>(action) }
+	);
 	if (!result) {
 		return offerList;
 	}
@@ -149,89 +183,88 @@ HistoryMarketOfferList IOMarket::getOwnHistory(MarketAction_t action, uint32_t p
 	return offerList;
 }
 
-void IOMarket::processExpiredOffers(DBResult_ptr result, bool) {
-	if (!result) {
-		return;
-	}
-
-	do {
-		if (!IOMarket::moveOfferToHistory(result->getNumber<uint32_t>("id"), OFFERSTATE_EXPIRED)) {
-			continue;
+void IOMarket::processExpiredOffer(const Offer &offer) {
+	const uint32_t playerId = offer.playerId;
+	const uint16_t amount = offer.amount;
+	const auto tier = offer.tier;
+	if (offer.type == MARKETACTION_SELL) {
+		const ItemType &itemType = Item::items[offer.itemId];
+		if (itemType.id == 0) {
+			return;
 		}
 
-		const uint32_t playerId = result->getNumber<uint32_t>("player_id");
-		const uint16_t amount = result->getNumber<uint16_t>("amount");
-		auto tier = getTierFromDatabaseTable(result->getString("tier"));
-		if (result->getNumber<uint16_t>("sale") == 1) {
-			const ItemType &itemType = Item::items[result->getNumber<uint16_t>("itemtype")];
-			if (itemType.id == 0) {
-				continue;
-			}
-
-			std::shared_ptr<Player> player = g_game().getPlayerByGUID(playerId, true);
-			if (!player) {
-				continue;
-			}
-
-			if (itemType.stackable) {
-				uint16_t tmpAmount = amount;
-				while (tmpAmount > 0) {
-					uint16_t stackCount = std::min<uint16_t>(100, tmpAmount);
-					std::shared_ptr<Item> item = Item::CreateItem(itemType.id, stackCount);
-					if (g_game().internalAddItem(player->getInbox(), item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
-						g_logger().error("[{}] Ocurred an error to add item with id {} to player {}", __FUNCTION__, itemType.id, player->getName());
+		std::shared_ptr<Player> player = g_game().getPlayerByGUID(playerId, true);
+		if (!player) {
+			return;
+		}
 
-						break;
-					}
+		if (itemType.stackable) {
+			uint16_t tmpAmount = amount;
+			while (tmpAmount > 0) {
+				uint16_t stackCount = std::min<uint16_t>(100, tmpAmount);
+				std::shared_ptr<Item> item = Item::CreateItem(itemType.id, stackCount);
+				if (g_game().internalAddItem(player->getInbox(), item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
+					g_logger().error("[{}] Ocurred an error to add item with id {} to player {}", __FUNCTION__, itemType.id, player->getName());
 
-					if (tier != 0) {
-						item->setAttribute(ItemAttribute_t::TIER, tier);
-					}
+					break;
+				}
 
-					tmpAmount -= stackCount;
+				if (tier != 0) {
+					item->setAttribute(ItemAttribute_t::TIER, tier);
 				}
+
+				tmpAmount -= stackCount;
+			}
+		} else {
+			int32_t subType;
+			if (itemType.charges != 0) {
+				subType = itemType.charges;
 			} else {
-				int32_t subType;
-				if (itemType.charges != 0) {
-					subType = itemType.charges;
-				} else {
-					subType = -1;
-				}
+				subType = -1;
+			}
 
-				for (uint16_t i = 0; i < amount; ++i) {
-					std::shared_ptr<Item> item = Item::CreateItem(itemType.id, subType);
-					if (g_game().internalAddItem(player->getInbox(), item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
-						break;
-					}
+			for (uint16_t i = 0; i < amount; ++i) {
+				std::shared_ptr<Item> item = Item::CreateItem(itemType.id, subType);
+				if (g_game().internalAddItem(player->getInbox(), item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
+					break;
+				}
 
-					if (tier != 0) {
-						item->setAttribute(ItemAttribute_t::TIER, tier);
-					}
+				if (tier != 0) {
+					item->setAttribute(ItemAttribute_t::TIER, tier);
 				}
 			}
+		}
 
-			if (player->isOffline()) {
-				g_saveManager().savePlayer(player);
-			}
-		} else {
-			uint64_t totalPrice = result->getNumber<uint64_t>("price") * amount;
+		if (player->isOffline()) {
+			g_saveManager().savePlayer(player);
+		}
+	} else {
+		uint64_t totalPrice = offer.price * amount;
 
-			std::shared_ptr<Player> player = g_game().getPlayerByGUID(playerId);
-			if (player) {
-				player->setBankBalance(player->getBankBalance() + totalPrice);
-			} else {
-				IOLoginData::increaseBankBalance(playerId, totalPrice);
-			}
+		std::shared_ptr<Player> player = g_game().getPlayerByGUID(playerId);
+		if (player) {
+			player->setBankBalance(player->getBankBalance() + totalPrice);
+		} else {
+			IOLoginData::increaseBankBalance(playerId, totalPrice);
 		}
-	} while (result->next());
+	}
 }
 
 void IOMarket::checkExpiredOffers() {
 	const time_t lastExpireDate = getTimeNow() - g_configManager().getNumber(MARKET_OFFER_DURATION, __FUNCTION__);
 
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `itemtype`, `player_id`, `sale`, `tier` FROM `market_offers` WHERE `created` <= " << lastExpireDate;
-	g_databaseTasks().store(query.str(), IOMarket::processExpiredOffers);
+	std::vector<Offer> expiredOffers;
+	for (const auto &[offerId, offer] : getInstance().offers) {
+		if (offer.created <= lastExpireDate) {
+			expiredOffers.emplace_back(offer);
+		}
+	}
+
+	for (const auto &offer : expiredOffers) {
+		if (IOMarket::moveOfferToHistory(offer.id, OFFERSTATE_EXPIRED)) {
+			processExpiredOffer(offer);
+		}
+	}
 
 	int32_t checkExpiredMarketOffersEachMinutes = g_configManager().getNumber(CHECK_EXPIRED_MARKET_OFFERS_EACH_MINUTES, __FUNCTION__);
 	if (checkExpiredMarketOffersEachMinutes <= 0) {
@@ -242,63 +275,79 @@ void IOMarket::checkExpiredOffers() {
 }
 
 uint32_t IOMarket::getPlayerOfferCount(uint32_t playerId) {
-	std::ostringstream query;
-	query << "SELECT COUNT(*) AS `count` FROM `market_offers` WHERE `player_id` = " << playerId;
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
-		return 0;
-	}
-	return result->getNumber<int32_t>("count");
+	const auto &market = getInstance();
+	const auto own = market.playerOffers.find(playerId);
+	return own != market.playerOffers.end() ? static_cast<uint32_t>(own->second.size()) : 0;
 }
 
 MarketOfferEx IOMarket::getOfferByCounter(uint32_t timestamp, uint16_t counter) {
 	MarketOfferEx offer;
+	offer.id = 0;
 
-	const int32_t created = timestamp - g_configManager().getNumber(MARKET_OFFER_DURATION, __FUNCTION__);
+	const auto created = static_cast<uint32_t>(timestamp - g_configManager().getNumber(MARKET_OFFER_DURATION, __FUNCTION__));
 
-	std::ostringstream query;
-	query << "SELECT `id`, `sale`, `itemtype`, `amount`, `created`, `price`, `player_id`, `anonymous`, `tier`, (SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers` WHERE `created` = " << created << " AND (`id` & 65535) = " << counter << " LIMIT 1";
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
-		offer.id = 0;
-		return offer;
-	}
+	// The counter is the low half of the id, only one id in each 65536 can match
+	const auto &market = getInstance();
+	for (uint64_t offerId = counter; offerId < market.nextOfferId; offerId += 0x10000) {
+		const auto it = market.offers.find(static_cast<uint32_t>(offerId));
+		if (it == market.offers.end() || it->second.created != created) {
+			continue;
+		}
 
-	offer.id = result->getNumber<uint32_t>("id");
-	offer.type = static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale"));
-	offer.amount = result->getNumber<uint16_t>("amount");
-	offer.counter = result->getNumber<uint32_t>("id") & 0xFFFF;
-	offer.timestamp = result->getNumber<uint32_t>("created");
-	offer.price = result->getNumber<uint64_t>("price");
-	offer.itemId = result->getNumber<uint16_t>("itemtype");
-	offer.playerId = result->getNumber<uint32_t>("player_id");
-	offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-	if (result->getNumber<uint16_t>("anonymous") == 0) {
-		offer.playerName = result->getString("player_name");
-	} else {
-		offer.playerName = "Anonymous";
+		const auto &found = it->second;
+		offer.id = found.id;
+		offer.type = found.type;
+		offer.amount = found.amount;
+		offer.counter = found.id & 0xFFFF;
+		offer.timestamp = found.created;
+		offer.price = found.price;
+		offer.itemId = found.itemId;
+		offer.playerId = found.playerId;
+		offer.tier = found.tier;
+		offer.playerName = found.anonymous ? "Anonymous" : found.playerName;
+		break;
 	}
 	return offer;
 }
 
-void IOMarket::createOffer(uint32_t playerId, MarketAction_t action, uint32_t itemId, uint16_t amount, uint64_t price, uint8_t tier, bool anonymous) {
+void IOMarket::createOffer(uint32_t playerId, const std::string &playerName, MarketAction_t action, uint32_t itemId, uint16_t amount, uint64_t price, uint8_t tier, bool anonymous) {
+	auto &market = getInstance();
+
+	Offer offer;
+	offer.id = market.nextOfferId++;
+	offer.playerId = playerId;
+	offer.created = static_cast<uint32_t>(getTimeNow());
+	offer.price = price;
+	offer.amount = amount;
+	offer.itemId = static_cast<uint16_t>(itemId);
+	offer.type = action;
+	offer.tier = tier;
+	offer.anonymous = anonymous;
+	offer.playerName = playerName;
+
 	std::ostringstream query;
-	query << "INSERT INTO `market_offers` (`player_id`, `sale`, `itemtype`, `amount`, `created`, `anonymous`, `price`, `tier`) VALUES (" << playerId << ',' << action << ',' << itemId << ',' << amount << ',' << getTimeNow() << ',' << anonymous << ',' << price << ',' << std::to_string(tier) << ')';
-	Database::getInstance().executeQuery(query.str());
+	query << "INSERT INTO `market_offers` (`id`, `player_id`, `sale`, `itemtype`, `amount`, `created`, `anonymous`, `price`, `tier`) VALUES (" << offer.id << ',' << playerId << ',' << action << ',' << itemId << ',' << amount << ',' << offer.created << ',' << anonymous << ',' << price << ',' << std::to_string(tier) << ')';
+	market.addOffer(std::move(offer));
+	executeWrite(query.str());
 }
 
 void IOMarket::acceptOffer(uint32_t offerId, uint16_t amount) {
+	auto &market = getInstance();
+	if (const auto it = market.offers.find(offerId); it != market.offers.end()) {
+		it->second.amount -= std::min(amount, it->second.amount);
+	}
+
 	std::ostringstream query;
 	query << "UPDATE `market_offers` SET `amount` = `amount` - " << amount << " WHERE `id` = " << offerId;
-	Database::getInstance().executeQuery(query.str());
+	executeWrite(query.str());
 }
 
 void IOMarket::deleteOffer(uint32_t offerId) {
+	getInstance().removeOffer(offerId);
+
 	std::ostringstream query;
 	query << "DELETE FROM `market_offers` WHERE `id` = " << offerId;
-	Database::getInstance().executeQuery(query.str());
+	executeWrite(query.str());
 }
 
 void IOMarket::appendHistory(uint32_t playerId, MarketAction_t type, uint16_t itemId, uint16_t amount, uint64_t price, time_t timestamp, uint8_t tier, MarketOfferState_t state) {
@@ -307,39 +356,62 @@ void IOMarket::appendHistory(uint32_t playerId, MarketAction_t type, uint16_t it
 		  << playerId << ',' << type << ',' << itemId << ',' << amount << ',' << price << ','
 		  << timestamp << ',' << getTimeNow() << ',' << state << ',' << std::to_string(tier) << ')';
 	g_databaseTasks().execute(query.str());
+
+	if (state == OFFERSTATE_ACCEPTED) {
+		getInstance().addTransaction(type, itemId, tier, price);
+	}
 }
 
 bool IOMarket::moveOfferToHistory(uint32_t offerId, MarketOfferState_t state) {
-	Database &db = Database::getInstance();
-
-	std::ostringstream query;
-	query << "SELECT `player_id`, `sale`, `itemtype`, `amount`, `price`, `created`, `tier` FROM `market_offers` WHERE `id` = " << offerId;
-
-	DBResult_ptr result = db.storeQuery(query.str());
-	if (!result) {
+	auto &market = getInstance();
+	const auto it = market.offers.find(offerId);
+	if (it == market.offers.end()) {
 		return false;
 	}
 
-	query.str(std::string());
-	query << "DELETE FROM `market_offers` WHERE `id` = " << offerId;
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
+	const Offer offer = it->second;
+	deleteOffer(offerId);
 
-	appendHistory(
-		result->getNumber<uint32_t>("player_id"),
-		static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale")),
-		result->getNumber<uint16_t>("itemtype"),
-		result->getNumber<uint16_t>("amount"),
-		result->getNumber<uint64_t>("price"),
-		getTimeNow(),
-		getTierFromDatabaseTable(result->getString("tier")), state
-	);
+	appendHistory(offer.playerId, offer.type, offer.itemId, offer.amount, offer.price, getTimeNow(), offer.tier, state);
 	return true;
 }
 
 void IOMarket::updateStatistics() {
-	auto query = fmt::format(
+	// Kept up to date by appendHistory once loaded, a reload would lose the writes still queued
+	if (statisticsLoaded) {
+		return;
+	}
+
+	DBResult_ptr result = g_database().storeQuery("SELECT `sale`, `itemtype`, `tier`, `num`, `min`, `max`, `sum` FROM `market_statistics`");
+	if (!result) {
+		rebuildStatistics();
+		return;
+	}
+
+	statisticsLoaded = true;
+	do {
+		MarketStatistics* statistics = nullptr;
+		const auto tier = getTierFromDatabaseTable(result->getString("tier"));
+		auto itemId = result->getNumber<uint16_t>("itemtype");
+		if (result->getNumber<uint16_t>("sale") == MARKETACTION_BUY) {
+			statistics = &purchaseStatistics[itemId][tier];
+		} else {
+			statistics = &saleStatistics[itemId][tier];
+		}
+
+		statistics->numTransactions = result->getNumber<uint32_t>("num");
+		statistics->lowestPrice = result->getNumber<uint64_t>("min");
+		statistics->totalPrice = result->getNumber<uint64_t>("sum");
+		statistics->highestPrice = result->getNumber<uint64_t>("max");
+	} while (result->next());
+}
+
+void IOMarket::rebuildStatistics() {
+	statisticsLoaded = true;
+	purchaseStatistics.clear();
+	saleStatistics.clear();
+
+	const auto query = fmt::format(
 		"SELECT sale, itemtype, COUNT(price) AS num, MIN(price) AS min, MAX(price) AS max, SUM(price) AS sum, tier "
 		"FROM market_history "
 		"WHERE state = '{}' "
@@ -352,11 +424,14 @@ void IOMarket::updateStatistics() {
 		return;
 	}
 
+	DBInsert rollup("INSERT INTO `market_statistics` (`sale`, `itemtype`, `tier`, `num`, `min`, `max`, `sum`) VALUES ");
+	rollup.upsert({ "num", "min", "max", "sum" });
 	do {
 		MarketStatistics* statistics = nullptr;
 		const auto tier = getTierFromDatabaseTable(result->getString("tier"));
 		auto itemId = result->getNumber<uint16_t>("itemtype");
-		if (result->getNumber<uint16_t>("sale") == MARKETACTION_BUY) {
+		const auto sale = result->getNumber<uint16_t>("sale");
+		if (sale == MARKETACTION_BUY) {
 			statistics = &purchaseStatistics[itemId][tier];
 		} else {
 			statistics = &saleStatistics[itemId][tier];
@@ -366,5 +441,21 @@ void IOMarket::updateStatistics() {
 		statistics->lowestPrice = result->getNumber<uint64_t>("min");
 		statistics->totalPrice = result->getNumber<uint64_t>("sum");
 		statistics->highestPrice = result->getNumber<uint64_t>("max");
+		rollup.addRow(fmt::format("{}, {}, {}, {}, {}, {}, {}", sale, itemId, tier, statistics->numTransactions, statistics->lowestPrice, statistics->highestPrice, statistics->totalPrice));
 	} while (result->next());
+	rollup.execute();
+}
+
+void IOMarket::addTransaction(MarketAction_t type, uint16_t itemId, uint8_t tier, uint64_t price) {
+	auto &statistics = (type == MARKETACTION_BUY ? purchaseStatistics : saleStatistics)[itemId][tier];
+	statistics.lowestPrice = statistics.numTransactions == 0 ? price : std::min(statistics.lowestPrice, price);
+	statistics.highestPrice = std::max(statistics.highestPrice, price);
+	statistics.totalPrice += price;
+	++statistics.numTransactions;
+
+	g_databaseTasks().execute(fmt::format(
+		"INSERT INTO `market_statistics` (`sale`, `itemtype`, `tier`, `num`, `min`, `max`, `sum`) VALUES ({0}, {1}, {2}, 1, {3}, {3}, {3}) "
+		"ON DUPLICATE KEY UPDATE `num` = `num` + 1, `min` = LEAST(`min`, {3}), `max` = GREATEST(`max`, {3}), `sum` = `sum` + {3}",
+		static_cast<uint16_t>(type), itemId, tier, price
+	));
 }
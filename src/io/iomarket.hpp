@@ -13,6 +13,15 @@
 #include "declarations.hpp"
 #include "lib/di/container.hpp"
 
+/**
+ * Market offers, kept in memory as an order book per item and tier.
+ *
+ * The offers are loaded once at startup and every later change is applied in
+ * memory first and then written through to `market_offers`, so browsing the
+ * market never queries the database. The server owns the table: offer ids
+ * are given out here, and an offer added to the table by anything else is
+ * only seen after a restart. The history stays in `market_history` alone.
+ */
 class IOMarket {
 public:
 	IOMarket() = default;
@@ -21,25 +30,33 @@ public:
 		return inject<IOMarket>();
 	}
 
+	void loadOffers();
+
 	static MarketOfferList getActiveOffers(MarketAction_t action);
 	static MarketOfferList getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier);
 	static MarketOfferList getOwnOffers(MarketAction_t action, uint32_t playerId);
 	static HistoryMarketOfferList getOwnHistory(MarketAction_t action, uint32_t playerId);
 
-	static void processExpiredOffers(DBResult_ptr result, bool);
 	static void checkExpiredOffers();
 
 	static uint32_t getPlayerOfferCount(uint32_t playerId);
 	static MarketOfferEx getOfferByCounter(uint32_t timestamp, uint16_t counter);
 
-	static void createOffer(uint32_t playerId, MarketAction_t action, uint32_t itemId, uint16_t amount, uint64_t price, uint8_t tier, bool anonymous);
+	static void createOffer(uint32_t playerId, const std::string &playerName, MarketAction_t action, uint32_t itemId, uint16_t amount, uint64_t price, uint8_t tier, bool anonymous);
 	static void acceptOffer(uint32_t offerId, uint16_t amount);
 	static void deleteOffer(uint32_t offerId);
 
 	static void appendHistory(uint32_t playerId, MarketAction_t type, uint16_t itemId, uint16_t amount, uint64_t price, time_t timestamp, uint8_t tier, MarketOfferState_t state);
 	static bool moveOfferToHistory(uint32_t offerId, MarketOfferState_t state);
 
+	/**
+	 * @brief Loads the statistics rolled up in market_statistics, once; appendHistory keeps them current.
+	 */
 	void updateStatistics();
+	/**
+	 * @brief Recomputes the statistics from the whole market_history and stores them in market_statistics.
+	 */
+	void rebuildStatistics();
 
 	using StatisticsMap = std::map<uint16_t, std::map<uint8_t, MarketStatistics>>;
 	const StatisticsMap &getPurchaseStatistics() const {
@@ -52,7 +69,42 @@ public:
 	static uint8_t getTierFromDatabaseTable(const std::string &string);
 
 private:
+	struct Offer {
+		uint32_t id;
+		uint32_t playerId;
+		uint32_t created;
+		uint64_t price;
+		uint16_t amount;
+		uint16_t itemId;
+		MarketAction_t type;
+		uint8_t tier;
+		bool anonymous;
+		std::string playerName;
+	};
+
+	static uint32_t getBookKey(MarketAction_t action, uint16_t itemId, uint8_t tier) {
+		return static_cast<uint32_t>(itemId) | static_cast<uint32_t>(tier) << 16 | static_cast<uint32_t>(action) << 24;
+	}
+
+	static MarketOffer toMarketOffer(const Offer &offer, bool withName);
+	static void processExpiredOffer(const Offer &offer);
+	// Market writes must reach the table in the order they were made
+	static void executeWrite(const std::string &query);
+
+	void addTransaction(MarketAction_t type, uint16_t itemId, uint8_t tier, uint64_t price);
+	void addOffer(Offer offer);
+	void removeOffer(uint32_t offerId);
+
+	// Keyed by offer id, in the order the offers were created
+	std::map<uint32_t, Offer> offers;
+	// Offer ids of each book, see getBookKey
+	phmap::flat_hash_map<uint32_t, std::set<uint32_t>> books;
+	// Offer ids of each player guid
+	phmap::flat_hash_map<uint32_t, std::set<uint32_t>> playerOffers;
+	uint32_t nextOfferId = 1;
+
 	// [uint16_t = item id, [uint8_t = item tier, MarketStatistics = structure of the statistics]]
 	StatisticsMap purchaseStatistics;
 	StatisticsMap saleStatistics;
+	bool statisticsLoaded = false;
 };
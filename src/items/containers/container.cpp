@@ -11,6 +11,7 @@
 
 #include "items/containers/container.hpp"
 #include "items/decay/decay.hpp"
+#include "items/itempool.hpp"
 #include "io/iomap.hpp"
 #include "game/game.hpp"
 #include "map/spectators.hpp"
@@ -38,15 +39,15 @@ Container::Container(uint16_t initType, uint16_t initSize, bool initUnlocked /*=
 	pagination(initPagination) { }
 
 std::shared_ptr<Container> Container::create(uint16_t type) {
-	return std::make_shared<Container>(type);
+	return makePooledItem<Container>("container", type);
 }
 
 std::shared_ptr<Container> Container::create(uint16_t type, uint16_t size, bool unlocked /*= true*/, bool pagination /*= false*/) {
-	return std::make_shared<Container>(type, size, unlocked, pagination);
+	return makePooledItem<Container>("container", type, size, unlocked, pagination);
 }
 
 std::shared_ptr<Container> Container::create(std::shared_ptr<Tile> tile) {
-	auto container = std::make_shared<Container>(ITEM_BROWSEFIELD, 30, false, true);
+	auto container = makePooledItem<Container>("container", ITEM_BROWSEFIELD, 30, false, true);
 	TileItemVector* itemVector = tile->getItemList();
 	if (itemVector) {
 		for (auto &item : *itemVector) {
@@ -126,6 +127,7 @@ bool Container::hasParent() {
 void Container::addItem(std::shared_ptr<Item> item) {
 	itemlist.push_back(item);
 	item->setParent(getContainer());
+	updateHoldingCount(item, 1);
 }
 
 StashContainerList Container::getStowableItems() const {
@@ -161,7 +163,7 @@ bool Container::unserializeItemNode(OTB::Loader &loader, const OTB::Node &node,
 		return false;
 	}
 
-	for (auto &itemNode : node.children) {
+	for (const auto &itemNode : loader.getChildren(node)) {
 		// load container items
 		if (itemNode.type != OTBM_ITEM) {
 			// unknown type
@@ -213,6 +215,51 @@ void Container::updateItemWeight(int32_t diff) {
 	}
 }
 
+namespace {
+	void addHoldingItemId(phmap::flat_hash_map<uint16_t, uint32_t> &holdingItemIds, uint16_t id, int32_t diff) {
+		auto &count = holdingItemIds[id];
+		count += diff;
+		if (count == 0) {
+			holdingItemIds.erase(id);
+		}
+	}
+}
+
+void Container::updateHoldingCount(const std::shared_ptr<Item> &item, int32_t sign) {
+	int32_t itemDiff = sign;
+	int32_t containerDiff = 0;
+	const auto container = item->getContainer();
+	if (container) {
+		itemDiff += sign * static_cast<int32_t>(container->holdingItemCount);
+		containerDiff = sign * static_cast<int32_t>(container->holdingContainerCount + 1);
+	}
+
+	std::shared_ptr<Container> parentContainer = getContainer();
+	do {
+		parentContainer->holdingItemCount += itemDiff;
+		parentContainer->holdingContainerCount += containerDiff;
+		addHoldingItemId(parentContainer->holdingItemIds, item->getID(), sign);
+		if (container) {
+			for (const auto &[id, count] : container->holdingItemIds) {
+				addHoldingItemId(parentContainer->holdingItemIds, id, sign * static_cast<int32_t>(count));
+			}
+		}
+	} while ((parentContainer = parentContainer->getParentContainer()) != nullptr);
+}
+
+void Container::updateHoldingItemId(uint16_t oldId, uint16_t newId) {
+	// The browse field counts are never read
+	if (oldId == newId || getID() == ITEM_BROWSEFIELD) {
+		return;
+	}
+
+	std::shared_ptr<Container> parentContainer = getContainer();
+	do {
+		addHoldingItemId(parentContainer->holdingItemIds, oldId, -1);
+		addHoldingItemId(parentContainer->holdingItemIds, newId, 1);
+	} while ((parentContainer = parentContainer->getParentContainer()) != nullptr);
+}
+
 uint32_t Container::getWeight() const {
 	return Item::getWeight() + totalWeight;
 }
@@ -339,6 +386,11 @@ std::shared_ptr<Item> Container::getItemByIndex(size_t index) const {
 }
 
 uint32_t Container::getItemHoldingCount() {
+	// The browse field items keep the tile as parent, so changes below them never reach its counts
+	if (getID() != ITEM_BROWSEFIELD) {
+		return holdingItemCount;
+	}
+
 	uint32_t counter = 0;
 	for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
 		++counter;
@@ -347,6 +399,10 @@ uint32_t Container::getItemHoldingCount() {
 }
 
 uint32_t Container::getContainerHoldingCount() {
+	if (getID() != ITEM_BROWSEFIELD) {
+		return holdingContainerCount;
+	}
+
 	uint32_t counter = 0;
 	for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
 		if ((*it)->getContainer()) {
@@ -365,7 +421,61 @@ bool Container::isHoldingItem(std::shared_ptr<Item> item) {
 	return false;
 }
 
+void Container::rebuildHoldingCount() {
+	holdingItemCount = 0;
+	holdingContainerCount = 0;
+	holdingItemIds.clear();
+	for (const auto &item : itemlist) {
+		++holdingItemCount;
+		++holdingItemIds[item->getID()];
+		if (const auto container = item->getContainer()) {
+			container->rebuildHoldingCount();
+			holdingItemCount += container->holdingItemCount;
+			holdingContainerCount += container->holdingContainerCount + 1;
+			for (const auto &[id, count] : container->holdingItemIds) {
+				holdingItemIds[id] += count;
+			}
+		}
+	}
+}
+
+ItemVector Container::getHoldingItemsWithId(uint16_t id) {
+	ItemVector items;
+	if (getID() == ITEM_BROWSEFIELD) {
+		for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
+			if ((*it)->getID() == id) {
+				items.push_back(*it);
+			}
+		}
+		return items;
+	}
+
+	if (!isHoldingItemWithId(id)) {
+		return items;
+	}
+
+	// Same breadth first order as ContainerIterator
+	std::vector<std::shared_ptr<Container>> containers { getContainer() };
+	for (size_t i = 0; i < containers.size(); ++i) {
+		for (const auto &item : containers[i]->itemlist) {
+			if (item->getID() == id) {
+				items.push_back(item);
+			}
+
+			const auto container = item->getContainer();
+			if (container && container->isHoldingItemWithId(id)) {
+				containers.push_back(container);
+			}
+		}
+	}
+	return items;
+}
+
 bool Container::isHoldingItemWithId(const uint16_t id) {
+	if (getID() != ITEM_BROWSEFIELD) {
+		return holdingItemIds.contains(id);
+	}
+
 	for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
 		std::shared_ptr<Item> item = *it;
 		if (item->getID() == id) {
@@ -700,6 +810,7 @@ void Container::addThing(int32_t index, std::shared_ptr<Thing> thing) {
 	item->setParent(getContainer());
 	itemlist.push_front(item);
 	updateItemWeight(item->getWeight());
+	updateHoldingCount(item, 1);
 
 	// send change to client
 	if (getParent() && (getParent() != VirtualCylinder::virtualCylinder)) {
@@ -753,6 +864,8 @@ void Container::replaceThing(uint32_t index, std::shared_ptr<Thing> thing) {
 	itemlist[index] = item;
 	item->setParent(getContainer());
 	updateItemWeight(-static_cast<int32_t>(replacedItem->getWeight()) + item->getWeight());
+	updateHoldingCount(replacedItem, -1);
+	updateHoldingCount(item, 1);
 
 	// send change to client
 	if (getParent()) {
@@ -785,6 +898,7 @@ void Container::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 		}
 	} else {
 		updateItemWeight(-static_cast<int32_t>(item->getWeight()));
+		updateHoldingCount(item, -1);
 
 		// send change to client
 		if (getParent()) {
@@ -839,6 +953,7 @@ std::shared_ptr<Thing> Container::getThing(size_t index) const {
 ItemVector Container::getItems(bool recursive /*= false*/) {
 	ItemVector containerItems;
 	if (recursive) {
+		containerItems.reserve(getItemHoldingCount());
 		for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
 			containerItems.push_back(*it);
 		}
@@ -895,15 +1010,29 @@ void Container::internalAddThing(uint32_t, std::shared_ptr<Thing> thing) {
 	item->setParent(getContainer());
 	itemlist.push_front(item);
 	updateItemWeight(item->getWeight());
+	updateHoldingCount(item, 1);
 }
 
 void Container::startDecaying() {
+	if (isDetachedConstruction()) {
+		pendingDecay = true;
+		return;
+	}
+
 	g_decay().startDecay(getContainer());
 	for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
 		g_decay().startDecay(*it);
 	}
 }
 
+void Container::attachDetached() {
+	// The iterator already walks the whole tree, each item only registers itself
+	for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
+		(*it)->Item::attachDetached();
+	}
+	Item::attachDetached();
+}
+
 void Container::stopDecaying() {
 	g_decay().stopDecay(getContainer());
 	for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
@@ -950,6 +1079,7 @@ void Container::removeItem(std::shared_ptr<Thing> thing, bool sendUpdateToClient
 		}
 
 		itemlist.erase(it);
+		updateHoldingCount(itemToRemove, -1);
 		itemToRemove->resetParent();
 	}
 }
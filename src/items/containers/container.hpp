@@ -35,7 +35,7 @@ private:
 	friend class Container;
 };
 
-class Container : public Item, public Cylinder {
+class Container : public Item, public Cylinder, private MemoryTracked<Container, MemoryCategory::Containers> {
 public:
 	explicit Container(uint16_t type);
 	Container(uint16_t type, uint16_t size, bool unlocked = true, bool pagination = false);
@@ -124,6 +124,18 @@ public:
 	std::shared_ptr<Item> getItemByIndex(size_t index) const;
 	bool isHoldingItem(std::shared_ptr<Item> item);
 	bool isHoldingItemWithId(const uint16_t id);
+	/**
+	 * @brief Returns the items with the id held anywhere below, in iterator order.
+	 * Only the containers holding some of them are walked.
+	 */
+	ItemVector getHoldingItemsWithId(uint16_t id);
+	// Called when an item of this container changes its id
+	void updateHoldingItemId(uint16_t oldId, uint16_t newId);
+	/**
+	 * @brief Counts again everything held below.
+	 * For the containers shared by several parents, like the inbox and the depot boxes, whose changes only reach the parent they point to.
+	 */
+	void rebuildHoldingCount();
 
 	uint32_t getItemHoldingCount();
 	uint32_t getContainerHoldingCount();
@@ -168,6 +180,7 @@ public:
 	void internalAddThing(uint32_t index, std::shared_ptr<Thing> thing) override final;
 	void startDecaying() override;
 	void stopDecaying() override;
+	void attachDetached() override;
 
 	virtual void removeItem(std::shared_ptr<Thing> thing, bool sendUpdateToClient = false);
 
@@ -184,12 +197,23 @@ protected:
 	uint32_t m_maxItems;
 	uint32_t maxSize;
 	uint32_t totalWeight = 0;
+	// Items and containers of the whole subtree, kept up to date by updateHoldingCount
+	uint32_t holdingItemCount = 0;
+	uint32_t holdingContainerCount = 0;
+	// Number of items held below by item id
+	phmap::flat_hash_map<uint16_t, uint32_t> holdingItemIds;
 	ItemDeque itemlist;
 	uint32_t serializationCount = 0;
 
 	bool unlocked;
 	bool pagination;
 
+	/**
+	 * @brief Adds or removes (sign -1) the item and its own subtree from the holding counts of this container and its parents.
+	 * Must follow every change of the item list, the counts are what queryAdd checks.
+	 */
+	void updateHoldingCount(const std::shared_ptr<Item> &item, int32_t sign);
+
 	friend class MapCache;
 
 private:
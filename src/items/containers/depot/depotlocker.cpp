@@ -48,4 +48,5 @@ void DepotLocker::removeInbox(std::shared_ptr<Inbox> inbox) {
 		return;
 	}
 	itemlist.erase(cit);
+	updateHoldingCount(inbox, -1);
 }
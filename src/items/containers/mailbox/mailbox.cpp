@@ -11,8 +11,7 @@
 
 #include "items/containers/mailbox/mailbox.hpp"
 #include "game/game.hpp"
-#include "io/iologindata.hpp"
-#include "game/scheduling/save_manager.hpp"
+#include "creatures/players/offline_player.hpp"
 #include "map/spectators.hpp"
 
 ReturnValue Mailbox::queryAdd(int32_t, const std::shared_ptr<Thing> &thing, uint32_t, uint32_t, std::shared_ptr<Creature>) {
@@ -88,34 +87,56 @@ bool Mailbox::sendItem(std::shared_ptr<Item> item) const {
 		}
 	}
 
-	std::shared_ptr<Player> player = g_game().getPlayerByName(receiver, true);
+	if (!item) {
+		return false;
+	}
+
+	std::shared_ptr<Player> player = g_game().getPlayerByName(receiver);
+	if (!player) {
+		return sendOfflineItem(item, receiver);
+	}
+
 	std::string writer;
 	time_t date = time(0);
 	std::string text;
-	if (item && item->getID() == ITEM_LETTER && !item->getAttribute<std::string>(ItemAttribute_t::WRITER).empty()) {
+	if (item->getID() == ITEM_LETTER && !item->getAttribute<std::string>(ItemAttribute_t::WRITER).empty()) {
 		writer = item->getAttribute<std::string>(ItemAttribute_t::WRITER);
 		date = item->getAttribute<time_t>(ItemAttribute_t::DATE);
 		text = item->getAttribute<std::string>(ItemAttribute_t::TEXT);
 	}
-	if (player && item) {
-		if (g_game().internalMoveItem(item->getParent(), player->getInbox(), INDEX_WHEREEVER, item, item->getItemCount(), nullptr, FLAG_NOLIMIT) == RETURNVALUE_NOERROR) {
-			auto newItem = g_game().transformItem(item, item->getID() + 1);
-			if (newItem && newItem->getID() == ITEM_LETTER_STAMPED && writer != "") {
-				newItem->setAttribute(ItemAttribute_t::WRITER, writer);
-				newItem->setAttribute(ItemAttribute_t::DATE, date);
-				newItem->setAttribute(ItemAttribute_t::TEXT, text);
-			}
-			if (player->isOnline()) {
-				player->onReceiveMail();
-			} else {
-				g_saveManager().savePlayer(player);
-			}
-			return true;
+	if (g_game().internalMoveItem(item->getParent(), player->getInbox(), INDEX_WHEREEVER, item, item->getItemCount(), nullptr, FLAG_NOLIMIT) == RETURNVALUE_NOERROR) {
+		auto newItem = g_game().transformItem(item, item->getID() + 1);
+		if (newItem && newItem->getID() == ITEM_LETTER_STAMPED && writer != "") {
+			newItem->setAttribute(ItemAttribute_t::WRITER, writer);
+			newItem->setAttribute(ItemAttribute_t::DATE, date);
+			newItem->setAttribute(ItemAttribute_t::TEXT, text);
 		}
+		player->onReceiveMail();
+		return true;
 	}
 	return false;
 }
 
+bool Mailbox::sendOfflineItem(const std::shared_ptr<Item> &item, const std::string &receiver) const {
+	auto offlinePlayer = OfflinePlayer::loadByName(receiver);
+	if (!offlinePlayer) {
+		return false;
+	}
+
+	// The stamped copy, with the letter text and the parcel contents, goes straight to the stored inbox
+	const auto &stamped = item->clone();
+	if (!stamped) {
+		return false;
+	}
+	stamped->setID(item->getID() + 1);
+	if (!offlinePlayer->appendInboxItems({ stamped })) {
+		return false;
+	}
+
+	g_game().internalRemoveItem(item, item->getItemCount());
+	return true;
+}
+
 bool Mailbox::getReceiver(std::shared_ptr<Item> item, std::string &name) const {
 	std::shared_ptr<Container> container = item->getContainer();
 	if (container) {
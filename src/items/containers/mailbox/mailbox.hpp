@@ -45,6 +45,7 @@ public:
 private:
 	bool getReceiver(std::shared_ptr<Item> item, std::string &name) const;
 	bool sendItem(std::shared_ptr<Item> item) const;
+	bool sendOfflineItem(const std::shared_ptr<Item> &item, const std::string &receiver) const;
 
 	static bool canSend(std::shared_ptr<Item> item);
 };
@@ -54,6 +54,7 @@ void RewardChest::removeItem(std::shared_ptr<Thing> thing, bool /* sendToClient
 	auto it = std::ranges::find(itemlist.begin(), itemlist.end(), itemToRemove);
 	if (it != itemlist.end()) {
 		itemlist.erase(it);
+		updateHoldingCount(itemToRemove, -1);
 		itemToRemove->resetParent();
 	}
 }
@@ -45,63 +45,33 @@ void Decay::startDecay(std::shared_ptr<Item> item) {
 			stopDecay(item);
 		}
 
-		int64_t timestamp = OTSYS_TIME() + duration;
-		if (decayMap.empty()) {
-			eventId = g_dispatcher().scheduleEvent(
-				std::max<int32_t>(SCHEDULER_MINTICKS, duration), [this] { checkDecay(); }, "Decay::checkDecay"
-			);
-		} else {
-			if (timestamp < decayMap.begin()->first) {
-				g_dispatcher().stopEvent(eventId);
-				eventId = g_dispatcher().scheduleEvent(
-					std::max<int32_t>(SCHEDULER_MINTICKS, duration), [this] { checkDecay(); }, "Decay::checkDecay"
-				);
-			}
+		const int64_t now = OTSYS_TIME();
+		const int64_t timestamp = now + duration;
+		if (scheduledItems == 0) {
+			// Nothing is pending, so the wheel can jump straight to the present
+			nextTick = static_cast<uint64_t>(now) / EVENT_DECAYINTERVAL + 1;
 		}
 
 		item->setDecaying(DECAYING_TRUE);
 		item->setAttribute(ItemAttribute_t::DURATION_TIMESTAMP, timestamp);
-		decayMap[timestamp].push_back(item);
+		placeItem(item, (static_cast<uint64_t>(timestamp) + EVENT_DECAYINTERVAL - 1) / EVENT_DECAYINTERVAL);
+
+		if (eventId == 0) {
+			scheduleCheck();
+		}
 	}
 }
 
 void Decay::stopDecay(std::shared_ptr<Item> item) {
 	if (item->hasAttribute(ItemAttribute_t::DECAYSTATE)) {
-		auto timestamp = item->getAttribute<int64_t>(ItemAttribute_t::DURATION_TIMESTAMP);
 		if (item->hasAttribute(ItemAttribute_t::DURATION_TIMESTAMP)) {
-			auto it = decayMap.find(timestamp);
-			if (it != decayMap.end()) {
-				auto &decayItems = it->second;
-
-				size_t i = 0, end = decayItems.size();
-				auto decayItem = decayItems[i];
-				if (end == 1) {
-					if (item == decayItem) {
-						if (item->hasAttribute(ItemAttribute_t::DURATION)) {
-							// Incase we removed duration attribute don't assign new duration
-							item->setDuration(item->getDuration());
-						}
-						item->removeAttribute(ItemAttribute_t::DECAYSTATE);
-
-						decayMap.erase(it);
-					}
-					return;
-				}
-				while (i < end) {
-					decayItem = decayItems[i];
-					if (item == decayItem) {
-						if (item->hasAttribute(ItemAttribute_t::DURATION)) {
-							// Incase we removed duration attribute don't assign new duration
-							item->setDuration(item->getDuration());
-						}
-						item->removeAttribute(ItemAttribute_t::DECAYSTATE);
-
-						decayItems[i] = decayItems.back();
-						decayItems.pop_back();
-						return;
-					}
-					++i;
+			if (unscheduleItem(item)) {
+				if (item->hasAttribute(ItemAttribute_t::DURATION)) {
+					// Incase we removed duration attribute don't assign new duration
+					item->setDuration(item->getDuration());
 				}
+				item->removeAttribute(ItemAttribute_t::DECAYSTATE);
+				return;
 			}
 			item->removeAttribute(ItemAttribute_t::DURATION_TIMESTAMP);
 		} else {
@@ -111,24 +81,39 @@ void Decay::stopDecay(std::shared_ptr<Item> item) {
 }
 
 void Decay::checkDecay() {
-	int64_t timestamp = OTSYS_TIME();
+	eventId = 0;
+	const uint64_t currentTick = static_cast<uint64_t>(OTSYS_TIME()) / EVENT_DECAYINTERVAL;
+
+	// The items decay late but in order, the ticks left behind are all done by the next check
+	if (g_dispatcher().getTickGovernor().isActive(TickGovernor::Degradation::Batches) && currentTick < nextTick + MAX_POSTPONED_TICKS) {
+		eventId = g_dispatcher().scheduleEvent(
+			EVENT_DECAYINTERVAL, [this] { checkDecay(); }, "Decay::checkDecay"
+		);
+		return;
+	}
 
 	std::vector<std::shared_ptr<Item>> tempItems;
 	tempItems.reserve(32); // Small preallocation
 
-	auto it = decayMap.begin(), end = decayMap.end();
-	while (it != end) {
-		if (it->first > timestamp) {
-			break;
+	while (scheduledItems > 0 && nextTick <= currentTick) {
+		// When a level wraps, the next slot of the level above is spread over the lower levels
+		for (uint32_t level = 1; level < EVENT_DECAY_BUCKETS; ++level) {
+			if (((nextTick >> (WHEEL_BITS * (level - 1))) & WHEEL_MASK) != 0) {
+				break;
+			}
+			cascade(level);
 		}
 
-		// Iterating here is unsafe so let's copy our items into temporary vector
-		auto &decayItems = it->second;
-		tempItems.reserve(tempItems.size() + decayItems.size());
-		for (auto &decayItem : decayItems) {
-			tempItems.push_back(decayItem);
+		// Taken out before decaying, the items started again while decaying go to the next ticks
+		auto decayItems = std::move(wheel[nextTick & WHEEL_MASK]);
+		wheel[nextTick & WHEEL_MASK].clear();
+		++nextTick;
+
+		scheduledItems -= decayItems.size();
+		for (auto &entry : decayItems) {
+			entry.item->decaySlot = NO_SLOT;
+			tempItems.emplace_back(std::move(entry.item));
 		}
-		it = decayMap.erase(it);
 	}
 
 	for (const auto &item : tempItems) {
@@ -141,10 +126,67 @@ void Decay::checkDecay() {
 		}
 	}
 
-	if (it != end) {
-		eventId = g_dispatcher().scheduleEvent(
-			std::max<int32_t>(SCHEDULER_MINTICKS, static_cast<int32_t>(it->first - timestamp)), [this] { checkDecay(); }, "Decay::checkDecay"
-		);
+	if (scheduledItems > 0 && eventId == 0) {
+		scheduleCheck();
+	}
+}
+
+void Decay::scheduleCheck() {
+	const int64_t delay = static_cast<int64_t>(nextTick) * EVENT_DECAYINTERVAL - OTSYS_TIME();
+	eventId = g_dispatcher().scheduleEvent(
+		static_cast<uint32_t>(std::max<int64_t>(SCHEDULER_MINTICKS, delay)), [this] { checkDecay(); }, "Decay::checkDecay"
+	);
+}
+
+void Decay::placeItem(const std::shared_ptr<Item> &item, uint64_t tick) {
+	tick = std::max(tick, nextTick);
+	const uint64_t delta = tick - nextTick;
+
+	uint32_t level = 0;
+	while (level + 1 < EVENT_DECAY_BUCKETS && (delta >> (WHEEL_BITS * (level + 1))) != 0) {
+		++level;
+	}
+
+	// Farther than the wheel can hold, it is placed again each time its top slot is cascaded
+	uint64_t slotTick = tick;
+	if ((delta >> (WHEEL_BITS * (level + 1))) != 0) {
+		slotTick = nextTick + (static_cast<uint64_t>(1) << (WHEEL_BITS * (level + 1))) - 1;
+	}
+
+	const uint32_t slot = level * WHEEL_SLOTS + static_cast<uint32_t>((slotTick >> (WHEEL_BITS * level)) & WHEEL_MASK);
+	auto &entries = wheel[slot];
+	item->decaySlot = slot;
+	item->decayIndex = static_cast<uint32_t>(entries.size());
+	entries.emplace_back(WheelEntry { item, tick });
+	++scheduledItems;
+}
+
+bool Decay::unscheduleItem(const std::shared_ptr<Item> &item) {
+	if (item->decaySlot == NO_SLOT) {
+		return false;
+	}
+
+	auto &entries = wheel[item->decaySlot];
+	const uint32_t index = item->decayIndex;
+	if (index + 1 != entries.size()) {
+		entries[index] = std::move(entries.back());
+		entries[index].item->decayIndex = index;
+	}
+	entries.pop_back();
+
+	item->decaySlot = NO_SLOT;
+	--scheduledItems;
+	return true;
+}
+
+void Decay::cascade(uint32_t level) {
+	auto &slot = wheel[level * WHEEL_SLOTS + ((nextTick >> (WHEEL_BITS * level)) & WHEEL_MASK)];
+	auto entries = std::move(slot);
+	slot.clear();
+
+	scheduledItems -= entries.size();
+	for (const auto &entry : entries) {
+		placeItem(entry.item, entry.tick);
 	}
 }
 
@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include "utils/const.hpp"
+
 class Item;
 
 class Decay {
@@ -24,12 +26,38 @@ public:
 	void stopDecay(std::shared_ptr<Item> item);
 
 private:
+	/**
+	 * Hierarchical timing wheel, one tick every EVENT_DECAYINTERVAL.
+	 * Each of the EVENT_DECAY_BUCKETS levels holds WHEEL_SLOTS slots, a slot of
+	 * a level spans a full turn of the level below it and is cascaded down when
+	 * that turn starts, so an item decays on the first tick at or after its
+	 * timestamp.
+	 */
+	static constexpr uint32_t WHEEL_BITS = 8;
+	static constexpr uint32_t WHEEL_SLOTS = 1 << WHEEL_BITS;
+	static constexpr uint32_t WHEEL_MASK = WHEEL_SLOTS - 1;
+	static constexpr uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+	// How far behind the wheel may fall while the dispatcher is over its latency target
+	static constexpr uint64_t MAX_POSTPONED_TICKS = 20;
+
 	void checkDecay();
 	void internalDecayItem(std::shared_ptr<Item> item);
 
+	struct WheelEntry {
+		std::shared_ptr<Item> item;
+		uint64_t tick;
+	};
+
+	void placeItem(const std::shared_ptr<Item> &item, uint64_t tick);
+	bool unscheduleItem(const std::shared_ptr<Item> &item);
+	void cascade(uint32_t level);
+	void scheduleCheck();
+
 	uint32_t eventId { 0 };
-	// order is important, so we use an std::map
-	std::map<int64_t, std::vector<std::shared_ptr<Item>>> decayMap;
+	// First tick not processed yet, the slots are relative to it
+	uint64_t nextTick { 0 };
+	size_t scheduledItems { 0 };
+	std::array<std::vector<WheelEntry>, WHEEL_SLOTS * EVENT_DECAY_BUCKETS> wheel;
 };
 
 constexpr auto g_decay = Decay::getInstance;
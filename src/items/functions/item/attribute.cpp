@@ -13,86 +13,130 @@
 
 /*
 =============================
-* ItemAttribute class (Attributes methods)
+* ItemAttribute class (Attribute methods)
 =============================
 */
+ItemAttribute::ItemAttribute(const ItemAttribute &other) :
+	integerMask(other.integerMask), stringMask(other.stringMask), inlineIntegers(other.inlineIntegers) {
+	if (other.heap) {
+		heap = std::make_unique<HeapAttributes>(*other.heap);
+	}
+}
+
+ItemAttribute::HeapAttributes &ItemAttribute::getHeap() {
+	if (!heap) {
+		heap = std::make_unique<HeapAttributes>();
+	}
+	return *heap;
+}
+
+void ItemAttribute::releaseHeap() {
+	if (heap && heap->empty()) {
+		heap.reset();
+	}
+}
+
 const std::string &ItemAttribute::getAttributeString(ItemAttribute_t type) const {
 	static std::string emptyString;
-	if (!isAttributeString(type)) {
+	if ((stringMask & typeBit(type)) == 0) {
 		return emptyString;
 	}
 
-	auto attribute = getAttribute(type);
-	if (!attribute) {
-		return emptyString;
+	for (const auto &[stringType, value] : heap->strings) {
+		if (stringType == type) {
+			return *value;
+		}
 	}
-
-	return *attribute->getString().get();
+	return emptyString;
 }
 
 const int64_t &ItemAttribute::getAttributeValue(ItemAttribute_t type) const {
 	static int64_t emptyInt;
-	if (!isAttributeInteger(type)) {
-		return emptyInt;
-	}
-
-	auto attribute = getAttribute(type);
-	if (!attribute) {
+	if ((integerMask & typeBit(type)) == 0) {
 		return emptyInt;
 	}
 
-	return attribute->getInteger();
+	return getInteger(integerRank(type));
 }
 
-const Attributes* ItemAttribute::getAttribute(ItemAttribute_t type) const {
-	if (hasAttribute(type)) {
-		for (const Attributes &attribute : attributeVector) {
-			if (attribute.getAttributeType() == type) {
-				return &attribute;
-			}
-		}
+void ItemAttribute::setAttribute(ItemAttribute_t type, int64_t value) {
+	if (!isAttributeInteger(type)) {
+		return;
 	}
-	return nullptr;
-}
 
-Attributes &ItemAttribute::getAttributesByType(ItemAttribute_t type) {
-	for (Attributes &attribute : attributeVector) {
-		if (attribute.getAttributeType() == type) {
-			return attribute;
+	const size_t rank = integerRank(type);
+	if ((integerMask & typeBit(type)) == 0) {
+		// Opens the slot of the type, the integers of the later types move one slot up
+		const auto count = static_cast<size_t>(std::popcount(integerMask));
+		if (count >= INLINE_INTEGERS) {
+			getHeap().integers.emplace_back(0);
+		}
+		for (size_t i = count; i > rank; --i) {
+			getInteger(i) = getInteger(i - 1);
 		}
+		integerMask |= typeBit(type);
 	}
 
-	attributeVector.emplace_back(type);
-	return attributeVector.back();
+	getInteger(rank) = value;
 }
 
-void ItemAttribute::setAttribute(ItemAttribute_t type, int64_t value) {
-	if (!isAttributeInteger(type)) {
+void ItemAttribute::setAttribute(ItemAttribute_t type, const std::string &value) {
+	if (!isAttributeString(type)) {
 		return;
 	}
 
-	getAttributesByType(type).setValue(value);
+	if (value.empty()) {
+		return;
+	}
+
+	setAttribute(type, g_stringPool().intern(value));
 }
 
-void ItemAttribute::setAttribute(ItemAttribute_t type, const std::string &value) {
+void ItemAttribute::setAttribute(ItemAttribute_t type, const StringPool::Handle &value) {
 	if (!isAttributeString(type)) {
 		return;
 	}
 
-	if (value.empty()) {
+	if (!value || value->empty()) {
 		return;
 	}
 
-	getAttributesByType(type).setValue(value);
+	auto &strings = getHeap().strings;
+	auto it = std::ranges::find_if(strings, [type](const auto &attribute) {
+		return attribute.first >= type;
+	});
+	if (it != strings.end() && it->first == type) {
+		it->second = value;
+	} else {
+		strings.emplace(it, type, value);
+		stringMask |= typeBit(type);
+	}
 }
 
 bool ItemAttribute::removeAttribute(ItemAttribute_t type) {
-	for (auto it = attributeVector.begin(); it != attributeVector.end(); ++it) {
-		if (it->getAttributeType() == type) {
-			*it = std::move(attributeVector.back());
-			attributeVector.pop_back();
-			return true;
+	if ((integerMask & typeBit(type)) != 0) {
+		const auto count = static_cast<size_t>(std::popcount(integerMask));
+		for (size_t i = integerRank(type); i + 1 < count; ++i) {
+			getInteger(i) = getInteger(i + 1);
 		}
+
+		if (count > INLINE_INTEGERS) {
+			heap->integers.pop_back();
+			releaseHeap();
+		} else {
+			inlineIntegers[count - 1] = 0;
+		}
+		integerMask &= ~typeBit(type);
+		return true;
+	}
+
+	if ((stringMask & typeBit(type)) != 0) {
+		std::erase_if(heap->strings, [type](const auto &attribute) {
+			return attribute.first == type;
+		});
+		stringMask &= ~typeBit(type);
+		releaseHeap();
+		return true;
 	}
 	return false;
 }
@@ -103,7 +147,8 @@ bool ItemAttribute::removeAttribute(ItemAttribute_t type) {
 =============================
 */
 const std::map<std::string, CustomAttribute, std::less<>> &ItemAttribute::getCustomAttributeMap() const {
-	return customAttributeMap;
+	static const std::map<std::string, CustomAttribute, std::less<>> emptyMap;
+	return heap ? heap->customAttributeMap : emptyMap;
 }
 
 /*
@@ -112,42 +157,49 @@ const std::map<std::string, CustomAttribute, std::less<>> &ItemAttribute::getCus
 =============================
 */
 const CustomAttribute* ItemAttribute::getCustomAttribute(const std::string &attributeName) const {
-	if (customAttributeMap.contains(asLowerCaseString(attributeName))) {
-		return &customAttributeMap.at(asLowerCaseString(attributeName));
+	if (!heap) {
+		return nullptr;
 	}
-	return nullptr;
+
+	const auto it = heap->customAttributeMap.find(asLowerCaseString(attributeName));
+	return it != heap->customAttributeMap.end() ? &it->second : nullptr;
 }
 
 void ItemAttribute::setCustomAttribute(const std::string &key, const int64_t value) {
 	CustomAttribute attribute(key, value);
-	customAttributeMap[asLowerCaseString(key)] = attribute;
+	getHeap().customAttributeMap[asLowerCaseString(key)] = attribute;
 }
 
 void ItemAttribute::setCustomAttribute(const std::string &key, const std::string &value) {
 	CustomAttribute attribute(key, value);
-	customAttributeMap[asLowerCaseString(key)] = attribute;
+	getHeap().customAttributeMap[asLowerCaseString(key)] = attribute;
 }
 
 void ItemAttribute::setCustomAttribute(const std::string &key, const double value) {
 	CustomAttribute attribute(key, value);
-	customAttributeMap[asLowerCaseString(key)] = attribute;
+	getHeap().customAttributeMap[asLowerCaseString(key)] = attribute;
 }
 
 void ItemAttribute::setCustomAttribute(const std::string &key, const bool value) {
 	CustomAttribute attribute(key, value);
-	customAttributeMap[asLowerCaseString(key)] = attribute;
+	getHeap().customAttributeMap[asLowerCaseString(key)] = attribute;
 }
 
 void ItemAttribute::addCustomAttribute(const std::string &key, const CustomAttribute &customAttribute) {
-	customAttributeMap[asLowerCaseString(key)] = customAttribute;
+	getHeap().customAttributeMap[asLowerCaseString(key)] = customAttribute;
 }
 
 bool ItemAttribute::removeCustomAttribute(const std::string &attributeName) {
-	auto it = customAttributeMap.find(asLowerCaseString(attributeName));
-	if (it == customAttributeMap.end()) {
+	if (!heap) {
+		return false;
+	}
+
+	auto it = heap->customAttributeMap.find(asLowerCaseString(attributeName));
+	if (it == heap->customAttributeMap.end()) {
 		return false;
 	}
 
-	customAttributeMap.erase(it);
+	heap->customAttributeMap.erase(it);
+	releaseHeap();
 	return true;
 }
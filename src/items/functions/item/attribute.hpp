@@ -11,6 +11,7 @@
 
 #include "enums/item_attribute.hpp"
 #include "items/functions/item/custom_attribute.hpp"
+#include "utils/stringpool.hpp"
 #include "utils/tools.hpp"
 
 class ItemAttributeHelper {
@@ -66,73 +67,21 @@ public:
 	}
 };
 
-class Attributes : public ItemAttributeHelper {
-public:
-	explicit Attributes(ItemAttribute_t type) :
-		type(type), value(getDefaultValueForType(type)) { }
-	~Attributes() = default;
-
-	Attributes(const Attributes &i) :
-		type(i.type), value(i.value) { }
-	Attributes(Attributes &&attribute) noexcept :
-		type(attribute.type), value(std::move(attribute.value)) { }
-
-	Attributes &operator=(Attributes &&other) noexcept {
-		type = other.type;
-		value = std::move(other.value);
-		return *this;
-	}
-
-	const ItemAttribute_t &getAttributeType() const {
-		return type;
-	}
-
-	std::variant<int64_t, std::shared_ptr<std::string>> getDefaultValueForType(ItemAttribute_t attributeType) const {
-		ItemAttributeHelper helper;
-		if (helper.isAttributeInteger(attributeType)) {
-			return 0;
-		} else if (helper.isAttributeString(attributeType)) {
-			return std::make_shared<std::string>();
-		} else {
-			return {};
-		}
-	}
-
-	void setValue(int64_t newValue) {
-		if (std::holds_alternative<int64_t>(value)) {
-			value = newValue;
-		}
-	}
-	void setValue(const std::string &newValue) {
-		if (std::holds_alternative<std::shared_ptr<std::string>>(value)) {
-			value = std::make_shared<std::string>(newValue);
-		}
-	}
-	const int64_t &getInteger() const {
-		if (std::holds_alternative<int64_t>(value)) {
-			return std::get<int64_t>(value);
-		}
-		static int64_t emptyValue;
-		return emptyValue;
-	}
-
-	const std::shared_ptr<std::string> getString() const {
-		if (std::holds_alternative<std::shared_ptr<std::string>>(value)) {
-			return std::get<std::shared_ptr<std::string>>(value);
-		}
-		static std::shared_ptr<std::string> emptyPtr;
-		return emptyPtr;
-	}
-
-private:
-	ItemAttribute_t type;
-	std::variant<int64_t, std::shared_ptr<std::string>> value;
-};
-
+/**
+ * Attributes of one item.
+ *
+ * Most items carry a few integer attributes (duration, decay state, charges),
+ * so the first INLINE_INTEGERS of them live inline, ordered by type and found
+ * through a bitmask of the types set. The rest of the integers, the strings
+ * and the custom attributes are rare and kept on the heap.
+ */
 class ItemAttribute : public ItemAttributeHelper {
 public:
 	ItemAttribute() = default;
 
+	ItemAttribute(const ItemAttribute &other);
+	ItemAttribute &operator=(const ItemAttribute &other) = delete;
+
 	// CustomAttribute map methods
 	const std::map<std::string, CustomAttribute, std::less<>> &getCustomAttributeMap() const;
 	// CustomAttribute object methods
@@ -148,29 +97,70 @@ public:
 
 	void setAttribute(ItemAttribute_t type, int64_t value);
 	void setAttribute(ItemAttribute_t type, const std::string &value);
+	void setAttribute(ItemAttribute_t type, const StringPool::Handle &value);
 	bool removeAttribute(ItemAttribute_t type);
 
 	const std::string &getAttributeString(ItemAttribute_t type) const;
 	const int64_t &getAttributeValue(ItemAttribute_t type) const;
 
-	const std::vector<Attributes> &getAttributeVector() const {
-		return attributeVector;
+	bool hasAttribute(ItemAttribute_t type) const {
+		return ((integerMask | stringMask) & typeBit(type)) != 0;
 	}
 
-	bool hasAttribute(ItemAttribute_t type) const {
-		for (const auto &attr : attributeVector) {
-			if (attr.getAttributeType() == type) {
-				return true;
+	/**
+	 * @brief Calls f(type, value) for every attribute set, value is an int64_t or a std::string.
+	 * The integers come first, then the strings, each in type order.
+	 */
+	template <typename F>
+	void forEachAttribute(F &&f) const {
+		size_t rank = 0;
+		for (uint64_t mask = integerMask; mask != 0; mask &= mask - 1) {
+			f(static_cast<ItemAttribute_t>(std::countr_zero(mask)), getInteger(rank++));
+		}
+
+		if (heap) {
+			for (const auto &[type, value] : heap->strings) {
+				f(type, *value);
 			}
 		}
-		return false;
 	}
 
-	const Attributes* getAttribute(ItemAttribute_t type) const;
+private:
+	static constexpr size_t INLINE_INTEGERS = 4;
+	static_assert(ItemAttribute_t::AUGMENTS < 64, "The attribute masks hold one bit per type");
+
+	struct HeapAttributes {
+		// Integers past INLINE_INTEGERS, in the same type order
+		std::vector<int64_t> integers;
+		// Interned, equal texts of every item share one copy
+		std::vector<std::pair<ItemAttribute_t, StringPool::Handle>> strings;
+		std::map<std::string, CustomAttribute, std::less<>> customAttributeMap;
+
+		bool empty() const {
+			return integers.empty() && strings.empty() && customAttributeMap.empty();
+		}
+	};
 
-	Attributes &getAttributesByType(ItemAttribute_t type);
+	static uint64_t typeBit(ItemAttribute_t type) {
+		return static_cast<uint64_t>(1) << static_cast<uint64_t>(type);
+	}
 
-private:
-	std::map<std::string, CustomAttribute, std::less<>> customAttributeMap;
-	std::vector<Attributes> attributeVector;
+	size_t integerRank(ItemAttribute_t type) const {
+		return static_cast<size_t>(std::popcount(integerMask & (typeBit(type) - 1)));
+	}
+
+	const int64_t &getInteger(size_t rank) const {
+		return rank < INLINE_INTEGERS ? inlineIntegers[rank] : heap->integers[rank - INLINE_INTEGERS];
+	}
+	int64_t &getInteger(size_t rank) {
+		return const_cast<int64_t &>(std::as_const(*this).getInteger(rank));
+	}
+
+	HeapAttributes &getHeap();
+	void releaseHeap();
+
+	uint64_t integerMask = 0;
+	uint64_t stringMask = 0;
+	std::array<int64_t, INLINE_INTEGERS> inlineIntegers {};
+	std::unique_ptr<HeapAttributes> heap;
 };
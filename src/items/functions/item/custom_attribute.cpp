@@ -13,28 +13,31 @@
 
 #include "lua/scripts/luascript.hpp"
 
-CustomAttribute::CustomAttribute() = default;
+CustomAttribute::CustomAttribute() :
+	stringKey(g_stringPool().intern({})) {
+}
+
 CustomAttribute::~CustomAttribute() = default;
 
 // Constructor for int64_t
 CustomAttribute::CustomAttribute(const std::string &initStringKey, const int64_t initInt64) :
-	stringKey(initStringKey), value(initInt64) {
+	stringKey(g_stringPool().intern(initStringKey)), value(initInt64) {
 }
 // Constructor for string
 CustomAttribute::CustomAttribute(const std::string &initStringKey, const std::string &initStringValue) :
-	stringKey(initStringKey), value(initStringValue) {
+	stringKey(g_stringPool().intern(initStringKey)), value(initStringValue) {
 }
 // Constructor for double
 CustomAttribute::CustomAttribute(const std::string &initStringKey, const double initDoubleValue) :
-	stringKey(initStringKey), value(initDoubleValue) {
+	stringKey(g_stringPool().intern(initStringKey)), value(initDoubleValue) {
 }
 // Constructor for boolean
 CustomAttribute::CustomAttribute(const std::string &initStringKey, const bool initBoolValue) :
-	stringKey(initStringKey), value(initBoolValue) {
+	stringKey(g_stringPool().intern(initStringKey)), value(initBoolValue) {
 }
 
 const std::string &CustomAttribute::getStringKey() const {
-	return stringKey;
+	return *stringKey;
 }
 
 const int64_t &CustomAttribute::getInteger() const {
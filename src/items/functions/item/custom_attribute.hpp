@@ -10,6 +10,7 @@
 #pragma once
 
 #include "io/fileloader.hpp"
+#include "utils/stringpool.hpp"
 
 class CustomAttribute {
 public:
@@ -78,7 +79,8 @@ public:
 	bool unserialize(PropStream &propStream, const std::string &function);
 
 private:
-	std::string stringKey;
+	// Interned, the same keys repeat on many items
+	StringPool::Handle stringKey;
 
 	std::variant<int64_t, std::string, double, bool> value;
 };
@@ -15,70 +15,106 @@
 #include "utils/pugicast.hpp"
 #include "creatures/combat/combat.hpp"
 
+template <auto parser>
+void ItemParse::parseAttribute(const std::string &tmpStrValue, pugi::xml_node attributeNode, pugi::xml_attribute valueAttribute, ItemType &itemType) {
+	if constexpr (std::is_invocable_v<decltype(parser), const std::string &, pugi::xml_node, pugi::xml_attribute, ItemType &>) {
+		parser(tmpStrValue, attributeNode, valueAttribute, itemType);
+	} else {
+		parser(tmpStrValue, valueAttribute, itemType);
+	}
+}
+
+const phmap::flat_hash_map<std::string, std::vector<ItemParse::AttributeParser>> &ItemParse::getAttributeParsers() {
+	static const auto parsers = [] {
+		phmap::flat_hash_map<std::string, std::vector<AttributeParser>> keyParsers;
+		const auto add = [&keyParsers](AttributeParser parser, std::initializer_list<std::string_view> keys) {
+			for (const auto &key : keys) {
+				keyParsers[std::string(key)].emplace_back(parser);
+			}
+		};
+
+		// A key read by more than one parser runs them in this order
+		add(parseAttribute<&ItemParse::parseType>, { "type" });
+		add(parseAttribute<&ItemParse::parseDescription>, { "description" });
+		add(parseAttribute<&ItemParse::parseRuneSpellName>, { "runespellname" });
+		add(parseAttribute<&ItemParse::parseWeight>, { "weight" });
+		add(parseAttribute<&ItemParse::parseShowCount>, { "showcount" });
+		add(parseAttribute<&ItemParse::parseArmor>, { "armor" });
+		add(parseAttribute<&ItemParse::parseDefense>, { "defense" });
+		add(parseAttribute<&ItemParse::parseExtraDefense>, { "extradef" });
+		add(parseAttribute<&ItemParse::parseAttack>, { "attack" });
+		add(parseAttribute<&ItemParse::parseRotateTo>, { "rotateto" });
+		add(parseAttribute<&ItemParse::parseWrapContainer>, { "wrapcontainer" });
+		add(parseAttribute<&ItemParse::parseWrapableTo>, { "wrapableto" });
+		add(parseAttribute<&ItemParse::parseMovable>, { "movable", "movable" });
+		add(parseAttribute<&ItemParse::parseBlockProjectTile>, { "blockprojectile" });
+		add(parseAttribute<&ItemParse::parsePickupable>, { "allowpickupable", "pickupable" });
+		add(parseAttribute<&ItemParse::parseFloorChange>, { "floorchange" });
+		add(parseAttribute<&ItemParse::parseContainerSize>, { "containersize" });
+		add(parseAttribute<&ItemParse::parseFluidSource>, { "fluidsource" });
+		add(parseAttribute<&ItemParse::parseWriteables>, { "readable", "writeable", "maxtextlen", "writeonceitemid" });
+		add(parseAttribute<&ItemParse::parseWeaponType>, { "weapontype" });
+		add(parseAttribute<&ItemParse::parseSlotType>, { "slottype" });
+		add(parseAttribute<&ItemParse::parseAmmoType>, { "ammotype" });
+		add(parseAttribute<&ItemParse::parseShootType>, { "shoottype" });
+		add(parseAttribute<&ItemParse::parseMagicEffect>, { "effect" });
+		add(parseAttribute<&ItemParse::parseLootType>, { "loottype" });
+		add(parseAttribute<&ItemParse::parseRange>, { "range" });
+		add(parseAttribute<&ItemParse::parseDecayTo>, { "decayto" });
+		add(parseAttribute<&ItemParse::parseDuration>, { "stopduration", "duration", "showduration" });
+		add(parseAttribute<&ItemParse::parseTransform>, { "transformequipto", "transformdeequipto", "destroyto" });
+		add(parseAttribute<&ItemParse::parseCharges>, { "charges", "showcharges" });
+		add(parseAttribute<&ItemParse::parseShowAttributes>, { "showattributes" });
+		add(parseAttribute<&ItemParse::parseHitChance>, { "hitchance", "maxhitchance" });
+		add(parseAttribute<&ItemParse::parseInvisible>, { "invisible" });
+		add(parseAttribute<&ItemParse::parseSpeed>, { "speed" });
+		add(parseAttribute<&ItemParse::parseHealthAndMana>, { "healthgain", "healthticks", "managain", "manaticks", "manashield" });
+		add(parseAttribute<&ItemParse::parseSkills>, { "skillsword", "skillaxe", "skillclub", "skilldist", "skillfish", "skillshield", "skillfist" });
+		add(parseAttribute<&ItemParse::parseCriticalHit>, { "criticalhitchance", "criticalhitdamage" });
+		add(parseAttribute<&ItemParse::parseLifeAndManaLeech>, { "lifeleechchance", "lifeleechamount", "manaleechchance", "manaleechamount" });
+		add(parseAttribute<&ItemParse::parseMaxHitAndManaPoints>, { "maxhitpoints", "maxhitpointspercent", "maxmanapoints", "maxmanapointspercent" });
+		add(parseAttribute<&ItemParse::parseMagicLevelPoint>, { "magiclevelpoints", "magicpoints" });
+		add(parseAttribute<&ItemParse::parseFieldAbsorbPercent>, { "fieldabsorbpercentenergy", "fieldabsorbpercentfire", "fieldabsorbpercentpoison" });
+		add(parseAttribute<&ItemParse::parseAbsorbPercent>, { "absorbpercentall", "absorbpercentelements", "absorbpercentmagic", "absorbpercentenergy", "absorbpercentfire", "absorbpercentpoison", "absorbpercentearth", "absorbpercentice", "absorbpercentholy", "absorbpercentdeath", "absorbpercentlifedrain", "absorbpercentmanadrain", "absorbpercentdrown", "absorbpercentphysical", "absorbpercenthealing" });
+		add(parseAttribute<&ItemParse::parseSupressDrunk>, { "suppressdrunk", "suppressenergy", "suppressfire", "suppresspoison", "suppressdrown", "suppressphysical", "suppressfreeze", "suppressdazzle", "suppresscurse" });
+		add(parseAttribute<&ItemParse::parseField>, { "field" });
+		add(parseAttribute<&ItemParse::parseReplaceable>, { "replaceable" });
+		add(parseAttribute<&ItemParse::parseLevelDoor>, { "leveldoor" });
+		add(parseAttribute<&ItemParse::parseBeds>, { "partnerdirection", "maletransformto", "femaletransformto", "bedpart", "bedpartof" });
+		add(parseAttribute<&ItemParse::parseElement>, { "elementice", "elementearth", "elementfire", "elementenergy", "elementdeath", "elementholy" });
+		add(parseAttribute<&ItemParse::parseWalk>, { "walkstack", "blocking" });
+		add(parseAttribute<&ItemParse::parseAllowDistanceRead>, { "allowdistread" });
+		add(parseAttribute<&ItemParse::parseImbuement>, { "imbuementslot" });
+		add(parseAttribute<&ItemParse::parseAugment>, { "augments" });
+		add(parseAttribute<&ItemParse::parseStackSize>, { "stacksize" });
+		add(parseAttribute<&ItemParse::parseSpecializedMagicLevelPoint>, { "deathmagiclevelpoints", "energymagiclevelpoints", "earthmagiclevelpoints", "firemagiclevelpoints", "icemagiclevelpoints", "holymagiclevelpoints", "healingmagiclevelpoints", "physicalmagiclevelpoints" });
+		add(parseAttribute<&ItemParse::parseMagicShieldCapacity>, { "magicshieldcapacitypercent", "magicshieldcapacityflat" });
+		add(parseAttribute<&ItemParse::parsePerfecShot>, { "perfectshotdamage", "perfectshotrange" });
+		add(parseAttribute<&ItemParse::parseCleavePercent>, { "cleavepercent" });
+		add(parseAttribute<&ItemParse::parseReflectDamage>, { "reflectdamage", "reflectpercentall" });
+		add(parseAttribute<&ItemParse::parseTransformOnUse>, { "transformonuse" });
+		add(parseAttribute<&ItemParse::parsePrimaryType>, { "primarytype" });
+		add(parseAttribute<&ItemParse::parseHouseRelated>, { "usedbyhouseguests" });
+		add(parseAttribute<&ItemParse::parseUnscriptedItems>, { "weapontype", "script" });
+		return keyParsers;
+	}();
+	return parsers;
+}
+
 void ItemParse::initParse(const std::string &tmpStrValue, pugi::xml_node attributeNode, pugi::xml_attribute valueAttribute, ItemType &itemType) {
-	// Parse all item attributes
-	ItemParse::parseType(tmpStrValue, attributeNode, valueAttribute, itemType);
-	ItemParse::parseDescription(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseRuneSpellName(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseWeight(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseShowCount(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseArmor(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseDefense(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseExtraDefense(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseAttack(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseRotateTo(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseWrapContainer(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseWrapableTo(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseMovable(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseBlockProjectTile(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parsePickupable(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseFloorChange(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseContainerSize(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseFluidSource(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseWriteables(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseWeaponType(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseSlotType(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseAmmoType(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseShootType(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseMagicEffect(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseLootType(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseRange(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseDecayTo(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseDuration(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseTransform(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseCharges(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseShowAttributes(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseHitChance(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseInvisible(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseSpeed(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseHealthAndMana(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseSkills(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseCriticalHit(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseLifeAndManaLeech(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseMaxHitAndManaPoints(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseMagicLevelPoint(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseFieldAbsorbPercent(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseAbsorbPercent(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseSupressDrunk(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseField(tmpStrValue, attributeNode, valueAttribute, itemType);
-	ItemParse::parseReplaceable(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseLevelDoor(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseBeds(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseElement(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseWalk(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseAllowDistanceRead(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseImbuement(tmpStrValue, attributeNode, valueAttribute, itemType);
-	ItemParse::parseAugment(tmpStrValue, attributeNode, valueAttribute, itemType);
-	ItemParse::parseStackSize(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseSpecializedMagicLevelPoint(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseMagicShieldCapacity(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parsePerfecShot(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseCleavePercent(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseReflectDamage(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseTransformOnUse(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parsePrimaryType(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseHouseRelated(tmpStrValue, valueAttribute, itemType);
-	ItemParse::parseUnscriptedItems(tmpStrValue, attributeNode, valueAttribute, itemType);
+	// Every parsed item has abilities, even when no key sets them, scripts read them as present
+	itemType.getAbilities();
+
+	// Only the parsers reading this key run
+	const auto &parsers = getAttributeParsers();
+	const auto it = parsers.find(tmpStrValue);
+	if (it == parsers.end()) {
+		return;
+	}
+
+	for (const auto parser : it->second) {
+		parser(tmpStrValue, attributeNode, valueAttribute, itemType);
+	}
 }
 
 void ItemParse::parseDummyRate(pugi::xml_node attributeNode, ItemType &itemType) {
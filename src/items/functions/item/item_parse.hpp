@@ -261,6 +261,13 @@ public:
 	static void initParse(const std::string &tmpStrValue, pugi::xml_node attributeNode, pugi::xml_attribute valueAttribute, ItemType &itemType);
 
 private:
+	using AttributeParser = void (*)(const std::string &tmpStrValue, pugi::xml_node attributeNode, pugi::xml_attribute valueAttribute, ItemType &itemType);
+
+	// The parsers of each attribute key, built once
+	static const phmap::flat_hash_map<std::string, std::vector<AttributeParser>> &getAttributeParsers();
+	template <auto parser>
+	static void parseAttribute(const std::string &tmpStrValue, pugi::xml_node attributeNode, pugi::xml_attribute valueAttribute, ItemType &itemType);
+
 	static void parseDummyRate(pugi::xml_node attributeNode, ItemType &itemType);
 	static void parseType(const std::string &tmpStrValue, pugi::xml_node attributeNode, pugi::xml_attribute valueAttribute, ItemType &itemType);
 	static void parseDescription(const std::string &tmpStrValue, pugi::xml_attribute valueAttribute, ItemType &itemType);
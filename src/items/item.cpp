@@ -22,10 +22,12 @@
 #include "creatures/players/imbuements/imbuements.hpp"
 #include "lua/creature/actions.hpp"
 #include "creatures/combat/spells.hpp"
+#include "items/itempool.hpp"
 
 #define ITEM_IMBUEMENT_SLOT 500
 
 Items Item::items;
+thread_local uint32_t Item::detachedDepth = 0;
 
 std::shared_ptr<Item> Item::CreateItem(const uint16_t type, uint16_t count /*= 0*/, Position* itemPosition /*= nullptr*/) {
 	// A map which contains items that, when on creating, should be transformed to the default type.
@@ -51,29 +53,29 @@ std::shared_ptr<Item> Item::CreateItem(const uint16_t type, uint16_t count /*= 0
 
 	if (it.id != 0) {
 		if (it.isDepot()) {
-			newItem = std::make_shared<DepotLocker>(type, 4);
+			newItem = makePooledItem<DepotLocker>("depot_locker", type, 4);
 		} else if (it.isRewardChest()) {
-			newItem = std::make_shared<RewardChest>(type);
+			newItem = makePooledItem<RewardChest>("reward_chest", type);
 		} else if (it.isContainer()) {
-			newItem = std::make_shared<Container>(type);
+			newItem = makePooledItem<Container>("container", type);
 		} else if (it.isTeleport()) {
-			newItem = std::make_shared<Teleport>(type);
+			newItem = makePooledItem<Teleport>("teleport", type);
 		} else if (it.isMagicField()) {
-			newItem = std::make_shared<MagicField>(type);
+			newItem = makePooledItem<MagicField>("magic_field", type);
 		} else if (it.isDoor()) {
-			newItem = std::make_shared<Door>(type);
+			newItem = makePooledItem<Door>("door", type);
 		} else if (it.isTrashHolder()) {
-			newItem = std::make_shared<TrashHolder>(type);
+			newItem = makePooledItem<TrashHolder>("trash_holder", type);
 		} else if (it.isMailbox()) {
-			newItem = std::make_shared<Mailbox>(type);
+			newItem = makePooledItem<Mailbox>("mailbox", type);
 		} else if (it.isBed()) {
-			newItem = std::make_shared<BedItem>(type);
+			newItem = makePooledItem<BedItem>("bed", type);
 		} else {
 			auto itemMap = ItemTransformationMap.find(static_cast<ItemID_t>(it.id));
 			if (itemMap != ItemTransformationMap.end()) {
-				newItem = std::make_shared<Item>(itemMap->second, count);
+				newItem = makePooledItem<Item>("item", itemMap->second, count);
 			} else {
-				newItem = std::make_shared<Item>(type, count);
+				newItem = makePooledItem<Item>("item", type, count);
 			}
 		}
 	} else if (type > 0 && itemPosition) {
@@ -125,6 +127,8 @@ void Item::addImbuement(uint8_t slot, uint16_t imbuementId, uint32_t duration) {
 	}
 
 	setImbuement(slot, imbuementId, duration);
+	// Checked from the next tick on, the player is dropped again if the item is not equipped
+	g_game().addImbuedPlayer(player);
 }
 
 bool Item::hasImbuementCategoryId(uint16_t categoryId) const {
@@ -153,7 +157,7 @@ std::shared_ptr<Container> Item::CreateItemAsContainer(const uint16_t type, uint
 		return nullptr;
 	}
 
-	std::shared_ptr<Container> newItem = std::make_shared<Container>(type, size);
+	std::shared_ptr<Container> newItem = makePooledItem<Container>("container", type, size);
 	return newItem;
 }
 
@@ -256,27 +260,20 @@ bool Item::equals(std::shared_ptr<Item> compareItem) const {
 		return false;
 	}
 
-	for (const auto &attribute : getAttributeVector()) {
-		if (attribute.getAttributeType() == ItemAttribute_t::STORE) {
-			continue;
+	bool equivalent = true;
+	forEachAttribute([&](ItemAttribute_t type, const auto &value) {
+		if (!equivalent || type == ItemAttribute_t::STORE || !compareItem->hasAttribute(type)) {
+			return;
 		}
 
-		for (const auto &compareAttribute : compareItem->getAttributeVector()) {
-			if (attribute.getAttributeType() != compareAttribute.getAttributeType()) {
-				continue;
-			}
-
-			if (isAttributeInteger(attribute.getAttributeType()) && attribute.getInteger() != compareAttribute.getInteger()) {
-				return false;
-			}
-
-			if (isAttributeString(attribute.getAttributeType()) && attribute.getString() != compareAttribute.getString()) {
-				return false;
-			}
+		if constexpr (std::is_same_v<std::decay_t<decltype(value)>, int64_t>) {
+			equivalent = value == compareItem->getInteger(type);
+		} else {
+			equivalent = value == compareItem->getString(type);
 		}
-	}
+	});
 
-	return true;
+	return equivalent;
 }
 
 void Item::setDefaultSubtype() {
@@ -304,8 +301,15 @@ void Item::onRemoved() {
 
 void Item::setID(uint16_t newid) {
 	const ItemType &prevIt = Item::items[id];
+	const uint16_t oldId = id;
 	id = newid;
 
+	if (const auto parent = getParent()) {
+		if (const auto container = parent->getContainer()) {
+			container->updateHoldingItemId(oldId, newid);
+		}
+	}
+
 	const ItemType &it = Item::items[newid];
 	uint32_t newDuration = it.decayTime * 1000;
 
@@ -1072,32 +1076,34 @@ std::string Item::getOwnerName() const {
 }
 
 bool Item::hasProperty(ItemProperty prop) const {
-	const ItemType &it = items[id];
+	const auto hasFlag = [this](ItemTypeFlag_t flag) {
+		return items.hasFlag(id, flag);
+	};
 	switch (prop) {
 		case CONST_PROP_BLOCKSOLID:
-			return it.blockSolid;
+			return hasFlag(ITEMTYPE_FLAG_BLOCKSOLID);
 		case CONST_PROP_MOVABLE:
 			return canBeMoved();
 		case CONST_PROP_HASHEIGHT:
-			return it.hasHeight;
+			return hasFlag(ITEMTYPE_FLAG_HASHEIGHT);
 		case CONST_PROP_BLOCKPROJECTILE:
-			return it.blockProjectile;
+			return hasFlag(ITEMTYPE_FLAG_BLOCKPROJECTILE);
 		case CONST_PROP_BLOCKPATH:
-			return it.blockPathFind;
+			return hasFlag(ITEMTYPE_FLAG_BLOCKPATHFIND);
 		case CONST_PROP_ISVERTICAL:
-			return it.isVertical;
+			return hasFlag(ITEMTYPE_FLAG_VERTICAL);
 		case CONST_PROP_ISHORIZONTAL:
-			return it.isHorizontal;
+			return hasFlag(ITEMTYPE_FLAG_HORIZONTAL);
 		case CONST_PROP_IMMOVABLEBLOCKSOLID:
-			return it.blockSolid && !canBeMoved();
+			return hasFlag(ITEMTYPE_FLAG_BLOCKSOLID) && !canBeMoved();
 		case CONST_PROP_IMMOVABLEBLOCKPATH:
-			return it.blockPathFind && !canBeMoved();
+			return hasFlag(ITEMTYPE_FLAG_BLOCKPATHFIND) && !canBeMoved();
 		case CONST_PROP_IMMOVABLENOFIELDBLOCKPATH:
-			return !it.isMagicField() && it.blockPathFind && !canBeMoved();
+			return !hasFlag(ITEMTYPE_FLAG_MAGICFIELD) && hasFlag(ITEMTYPE_FLAG_BLOCKPATHFIND) && !canBeMoved();
 		case CONST_PROP_NOFIELDBLOCKPATH:
-			return !it.isMagicField() && it.blockPathFind;
+			return !hasFlag(ITEMTYPE_FLAG_MAGICFIELD) && hasFlag(ITEMTYPE_FLAG_BLOCKPATHFIND);
 		case CONST_PROP_SUPPORTHANGABLE:
-			return it.isHorizontal || it.isVertical;
+			return hasFlag(ITEMTYPE_FLAG_HORIZONTAL) || hasFlag(ITEMTYPE_FLAG_VERTICAL);
 		default:
 			return false;
 	}
@@ -1944,6 +1950,15 @@ bool Item::isSavedToHouses() {
 	return it.movable || it.isWrappable() || it.isCarpet() || getDoor() || (getContainer() && !getContainer()->empty()) || it.canWriteText || getBed() || it.m_transformOnUse;
 }
 
+void Item::refreshTileMoveEventFlag() {
+	// Only the items lying on the tile run its move events
+	const auto &parent = getParent();
+	if (const auto &tile = parent ? parent->getTile() : nullptr;
+	    tile && tile == parent) {
+		tile->refreshMoveEventFlag();
+	}
+}
+
 SoundEffect_t Item::getMovementSound(std::shared_ptr<Cylinder> toCylinder) const {
 	if (!toCylinder) {
 		return SoundEffect_t::ITEM_MOVE_DEFAULT;
@@ -3075,7 +3090,31 @@ std::string Item::getDescription(const ItemType &it, int32_t lookDistance, std::
 
 std::string Item::getDescription(int32_t lookDistance) {
 	const ItemType &it = items[id];
-	return getDescription(it, lookDistance, getItem());
+	// The weight of a container follows its content and a decaying duration follows the clock
+	if (getContainer() || getDecaying() != DECAYING_FALSE) {
+		return getDescription(it, lookDistance, getItem());
+	}
+
+	// The text only changes at these distances
+	if (lookDistance <= 1) {
+		lookDistance = 1;
+	} else if (lookDistance <= 4) {
+		lookDistance = 4;
+	} else {
+		lookDistance = 5;
+	}
+
+	const uint32_t typesRevision = items.getTypesRevision();
+	const uint32_t revision = getAttributesRevision();
+	if (descriptionCache && descriptionCache->typesRevision == typesRevision && descriptionCache->attributesRevision == revision && descriptionCache->id == id && descriptionCache->count == count && descriptionCache->lookDistance == lookDistance) {
+		return descriptionCache->text;
+	}
+
+	if (!descriptionCache) {
+		descriptionCache = std::make_unique<DescriptionCache>();
+	}
+	*descriptionCache = { typesRevision, revision, id, count, lookDistance, getDescription(it, lookDistance, getItem()) };
+	return descriptionCache->text;
 }
 
 std::string Item::getNameDescription(const ItemType &it, std::shared_ptr<Item> item /*= nullptr*/, int32_t subType /*= -1*/, bool addArticle /*= true*/) {
@@ -3154,6 +3193,11 @@ void Item::addUniqueId(uint16_t uniqueId) {
 		return;
 	}
 
+	if (isDetachedConstruction()) {
+		pendingUniqueId = uniqueId;
+		return;
+	}
+
 	if (g_game().addUniqueItem(uniqueId, static_self_cast<Item>())) {
 		setAttribute(ItemAttribute_t::UNIQUEID, uniqueId);
 	}
@@ -3215,9 +3259,24 @@ LightInfo Item::getLightInfo() const {
 }
 
 void Item::startDecaying() {
+	if (isDetachedConstruction()) {
+		pendingDecay = true;
+		return;
+	}
+
 	g_decay().startDecay(static_self_cast<Item>());
 }
 
+void Item::attachDetached() {
+	if (pendingUniqueId != 0) {
+		addUniqueId(std::exchange(pendingUniqueId, 0));
+	}
+	// After the unique id, an item with one never decays
+	if (std::exchange(pendingDecay, false)) {
+		startDecaying();
+	}
+}
+
 void Item::stopDecaying() {
 	g_decay().stopDecay(static_self_cast<Item>());
 }
@@ -3265,18 +3324,16 @@ bool Item::hasMarketAttributes() const {
 		return true;
 	}
 
-	for (const auto &attribute : getAttributeVector()) {
-		if (attribute.getAttributeType() == ItemAttribute_t::CHARGES && static_cast<uint16_t>(attribute.getInteger()) != items[id].charges) {
-			return false;
-		}
+	if (hasAttribute(ItemAttribute_t::CHARGES) && static_cast<uint16_t>(getInteger(ItemAttribute_t::CHARGES)) != items[id].charges) {
+		return false;
+	}
 
-		if (attribute.getAttributeType() == ItemAttribute_t::DURATION && static_cast<uint32_t>(attribute.getInteger()) != getDefaultDuration()) {
-			return false;
-		}
+	if (hasAttribute(ItemAttribute_t::DURATION) && static_cast<uint32_t>(getInteger(ItemAttribute_t::DURATION)) != getDefaultDuration()) {
+		return false;
+	}
 
-		if (attribute.getAttributeType() == ItemAttribute_t::TIER && static_cast<uint8_t>(attribute.getInteger()) != getTier()) {
-			return false;
-		}
+	if (hasAttribute(ItemAttribute_t::TIER) && static_cast<uint8_t>(getInteger(ItemAttribute_t::TIER)) != getTier()) {
+		return false;
 	}
 
 	return !hasImbuements() && !isStoreItem() && !hasOwner();
@@ -56,15 +56,30 @@ public:
 
 		return attributePtr->hasAttribute(type);
 	}
+
+	// See ItemAttribute::forEachAttribute
+	template <typename F>
+	void forEachAttribute(F &&f) const {
+		if (attributePtr) {
+			attributePtr->forEachAttribute(std::forward<F>(f));
+		}
+	}
 	void removeAttribute(ItemAttribute_t type) {
 		if (attributePtr) {
 			attributePtr->removeAttribute(type);
+			++attributesRevision;
 		}
 	}
 
 	template <typename GenericAttribute>
 	void setAttribute(ItemAttribute_t type, GenericAttribute genericAttribute) {
 		initAttributePtr()->setAttribute(type, genericAttribute);
+		++attributesRevision;
+	}
+
+	// Changes with every attribute set or removed, custom ones included
+	uint32_t getAttributesRevision() const {
+		return attributesRevision;
 	}
 
 	bool isAttributeInteger(ItemAttribute_t type) const {
@@ -94,10 +109,12 @@ public:
 	template <typename GenericType>
 	void setCustomAttribute(const std::string &key, GenericType value) {
 		initAttributePtr()->setCustomAttribute(key, value);
+		++attributesRevision;
 	}
 
 	void addCustomAttribute(const std::string &key, const CustomAttribute &customAttribute) {
 		initAttributePtr()->addCustomAttribute(key, customAttribute);
+		++attributesRevision;
 	}
 
 	bool hasCustomAttribute() const {
@@ -109,6 +126,7 @@ public:
 			return false;
 		}
 
+		++attributesRevision;
 		return attributePtr->removeCustomAttribute(attributeName);
 	}
 
@@ -172,15 +190,6 @@ protected:
 		return attributePtr;
 	}
 
-	const std::vector<Attributes> &getAttributeVector() const {
-		static std::vector<Attributes> emptyVector = {};
-		if (!attributePtr) {
-			return emptyVector;
-		}
-
-		return attributePtr->getAttributeVector();
-	}
-
 	const int64_t &getInteger(ItemAttribute_t type) const {
 		static int64_t emptyInt;
 		if (!attributePtr) {
@@ -208,11 +217,12 @@ protected:
 
 private:
 	std::unique_ptr<ItemAttribute> attributePtr;
+	uint32_t attributesRevision = 0;
 
 	friend class Item;
 };
 
-class Item : virtual public Thing, public ItemProperties, public SharedObject {
+class Item : virtual public Thing, public ItemProperties, public SharedObject, private MemoryTracked<Item, MemoryCategory::Items> {
 public:
 	// Factory member to create item of right type based on type
 	static std::shared_ptr<Item> CreateItem(const uint16_t type, uint16_t count = 0, Position* itemPosition = nullptr);
@@ -259,6 +269,21 @@ public:
 
 	bool isSavedToHouses();
 
+	// Hide the ItemProperties ones, an action or unique id changes the move event flag of the tile holding the item
+	template <typename GenericAttribute>
+	void setAttribute(ItemAttribute_t type, GenericAttribute genericAttribute) {
+		ItemProperties::setAttribute(type, genericAttribute);
+		if (type == ItemAttribute_t::ACTIONID || type == ItemAttribute_t::UNIQUEID) {
+			refreshTileMoveEventFlag();
+		}
+	}
+	void removeAttribute(ItemAttribute_t type) {
+		ItemProperties::removeAttribute(type);
+		if (type == ItemAttribute_t::ACTIONID || type == ItemAttribute_t::UNIQUEID) {
+			refreshTileMoveEventFlag();
+		}
+	}
+
 	SoundEffect_t getMovementSound(std::shared_ptr<Cylinder> toCylinder) const;
 
 	void setIsLootTrackeable(bool value) {
@@ -471,28 +496,28 @@ public:
 
 	bool hasProperty(ItemProperty prop) const;
 	bool isBlocking() const {
-		return items[id].blockSolid;
+		return items.hasFlag(id, ITEMTYPE_FLAG_BLOCKSOLID);
 	}
 	bool isStackable() const {
-		return items[id].stackable;
+		return items.hasFlag(id, ITEMTYPE_FLAG_STACKABLE);
 	}
 	bool isStowable() const {
 		return items[id].stackable && items[id].wareId > 0;
 	}
 	bool isAlwaysOnTop() const {
-		return items[id].alwaysOnTopOrder != 0;
+		return items.hasFlag(id, ITEMTYPE_FLAG_ALWAYSONTOP);
 	}
 	bool isGroundTile() const {
-		return items[id].isGroundTile();
+		return items.hasFlag(id, ITEMTYPE_FLAG_GROUNDTILE);
 	}
 	bool isMagicField() const {
-		return items[id].isMagicField();
+		return items.hasFlag(id, ITEMTYPE_FLAG_MAGICFIELD);
 	}
 	bool isWrapContainer() const {
 		return items[id].wrapContainer;
 	}
 	bool isMovable() const {
-		return items[id].movable;
+		return items.hasFlag(id, ITEMTYPE_FLAG_MOVABLE);
 	}
 	bool isCorpse() const {
 		return items[id].isCorpse;
@@ -525,7 +550,7 @@ public:
 		return items[id].isAmmo();
 	}
 	bool hasWalkStack() const {
-		return items[id].walkStack;
+		return items.hasFlag(id, ITEMTYPE_FLAG_WALKSTACK);
 	}
 	bool isQuiver() const {
 		return items[id].isQuiver();
@@ -549,7 +574,7 @@ public:
 		return items[id].isCarpet();
 	}
 	bool canReceiveAutoCarpet() const {
-		return isBlocking() && isAlwaysOnTop() && !items[id].hasHeight;
+		return isBlocking() && isAlwaysOnTop() && !items.hasFlag(id, ITEMTYPE_FLAG_HASHEIGHT);
 	}
 	bool canBeUsedByGuests() const {
 		return isDummy() || items[id].m_canBeUsedByGuests;
@@ -611,6 +636,34 @@ public:
 	void setSubType(uint16_t n);
 	void addUniqueId(uint16_t uniqueId);
 
+	/**
+	 * @brief While alive, the items read on this thread are built detached from the game: their
+	 * unique id and decay are kept on the item instead of being registered, so that a worker can
+	 * build them. attachDetached() registers them once they are added to the world on the dispatcher.
+	 */
+	class DetachedConstruction {
+	public:
+		DetachedConstruction() {
+			++detachedDepth;
+		}
+		~DetachedConstruction() {
+			--detachedDepth;
+		}
+
+		// non-copyable
+		DetachedConstruction(const DetachedConstruction &) = delete;
+		DetachedConstruction &operator=(const DetachedConstruction &) = delete;
+	};
+
+	static bool isDetachedConstruction() {
+		return detachedDepth != 0;
+	}
+	bool isDetached() const {
+		return pendingUniqueId != 0 || pendingDecay;
+	}
+	// Registers what was kept back while the item was built detached, on the dispatcher
+	virtual void attachDetached();
+
 	void setDefaultDuration() {
 		uint32_t duration = getDefaultDuration();
 		if (duration != 0) {
@@ -800,11 +853,33 @@ protected:
 	bool isLootTrackeable = false;
 	bool decayDisabled = false;
 
+	// Position in the decay wheel, kept by Decay for constant time removal
+	uint32_t decaySlot = std::numeric_limits<uint32_t>::max();
+	uint32_t decayIndex = 0;
+
+	// Kept back while built detached, until attachDetached()
+	uint16_t pendingUniqueId = 0;
+	bool pendingDecay = false;
+
+	// Last look text and what it was built from
+	struct DescriptionCache {
+		uint32_t typesRevision = 0;
+		uint32_t attributesRevision = 0;
+		uint16_t id = 0;
+		uint8_t count = 0;
+		int32_t lookDistance = 0;
+		std::string text;
+	};
+	std::unique_ptr<DescriptionCache> descriptionCache;
+
 private:
 	void setImbuement(uint8_t slot, uint16_t imbuementId, uint32_t duration);
+	void refreshTileMoveEventFlag();
 	// Don't add variables here, use the ItemAttribute class.
 	std::string getWeightDescription(uint32_t weight) const;
 
+	thread_local static uint32_t detachedDepth;
+
 	friend class Decay;
 	friend class MapCache;
 };
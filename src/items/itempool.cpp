@@ -0,0 +1,95 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "items/itempool.hpp"
+#include "lib/metrics/metrics.hpp"
+
+ItemSlabPool::ItemSlabPool(std::string_view name, size_t blockSize, size_t blockAlignment) :
+	name(name),
+	blockAlignment(std::max(blockAlignment, alignof(FreeBlock))),
+	// Freed blocks hold the free list link, and every block of a slab stays aligned
+	blockSize((std::max(blockSize, sizeof(FreeBlock)) + this->blockAlignment - 1) / this->blockAlignment * this->blockAlignment) {
+	auto &registry = getRegistry();
+	std::scoped_lock lock(registry.mutex);
+	registry.pools.emplace_back(this);
+}
+
+ItemSlabPool::Registry &ItemSlabPool::getRegistry() {
+	// Never destroyed, like the pools it lists
+	static auto* registry = new Registry();
+	return *registry;
+}
+
+void* ItemSlabPool::allocate() {
+	std::scoped_lock lock(mutex);
+	if (!freeBlocks) {
+		addSlab();
+	}
+
+	auto* block = freeBlocks;
+	freeBlocks = block->next;
+	++blocksInUse;
+	return block;
+}
+
+void ItemSlabPool::deallocate(void* block) noexcept {
+	std::scoped_lock lock(mutex);
+	auto* freeBlock = static_cast<FreeBlock*>(block);
+	freeBlock->next = freeBlocks;
+	freeBlocks = freeBlock;
+	--blocksInUse;
+}
+
+void ItemSlabPool::addSlab() {
+	auto* slab = static_cast<unsigned char*>(::operator new(blockSize * SLAB_BLOCKS, std::align_val_t(blockAlignment)));
+	slabs.emplace_back(slab);
+
+	// Linked backwards so the first block of the slab is handed out first
+	for (size_t i = SLAB_BLOCKS; i-- > 0;) {
+		auto* block = reinterpret_cast<FreeBlock*>(slab + i * blockSize);
+		block->next = freeBlocks;
+		freeBlocks = block;
+	}
+}
+
+size_t ItemSlabPool::getSlabCount() const {
+	std::scoped_lock lock(mutex);
+	return slabs.size();
+}
+
+size_t ItemSlabPool::getBlocksInUse() const {
+	std::scoped_lock lock(mutex);
+	return blocksInUse;
+}
+
+void ItemSlabPool::exportMetrics() {
+	auto &registry = getRegistry();
+	std::scoped_lock registryLock(registry.mutex);
+	for (auto* pool : registry.pools) {
+		int64_t inUse;
+		int64_t reserved;
+		{
+			std::scoped_lock lock(pool->mutex);
+			inUse = static_cast<int64_t>(pool->blocksInUse);
+			reserved = static_cast<int64_t>(pool->slabs.size() * SLAB_BLOCKS);
+		}
+
+		const std::map<std::string, std::string> attrs = { { "pool", pool->name }, { "block_size", std::to_string(pool->blockSize) } };
+		if (inUse != pool->exportedBlocksInUse) {
+			g_metrics().addUpDownCounter("item_pool_blocks_in_use", static_cast<int>(inUse - pool->exportedBlocksInUse), attrs);
+			pool->exportedBlocksInUse = inUse;
+		}
+		if (reserved != pool->exportedBlocksReserved) {
+			g_metrics().addUpDownCounter("item_pool_blocks_reserved", static_cast<int>(reserved - pool->exportedBlocksReserved), attrs);
+			pool->exportedBlocksReserved = reserved;
+		}
+	}
+}
@@ -0,0 +1,123 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Slab pool holding the blocks of one item type.
+ *
+ * Blocks are carved from slabs of SLAB_BLOCKS and recycled through a free
+ * list, slabs are kept for the whole uptime. Safe to use from any thread,
+ * items are often released away from the dispatcher.
+ */
+class ItemSlabPool {
+public:
+	static constexpr size_t SLAB_BLOCKS = 256;
+
+	ItemSlabPool(std::string_view name, size_t blockSize, size_t blockAlignment);
+
+	// Ensures that we don't accidentally copy it
+	ItemSlabPool(const ItemSlabPool &) = delete;
+	ItemSlabPool &operator=(const ItemSlabPool &) = delete;
+
+	void* allocate();
+	void deallocate(void* block) noexcept;
+
+	std::string_view getName() const {
+		return name;
+	}
+	size_t getBlockSize() const {
+		return blockSize;
+	}
+	size_t getSlabCount() const;
+	size_t getBlocksInUse() const;
+
+	/**
+	 * @brief Reports the blocks in use and reserved by every pool.
+	 * Driven by a cycle event, the gap between both shows the fragmentation left by long uptimes.
+	 */
+	static void exportMetrics();
+
+private:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	struct Registry {
+		std::mutex mutex;
+		std::vector<ItemSlabPool*> pools;
+	};
+
+	static Registry &getRegistry();
+
+	void addSlab();
+
+	const std::string name;
+	const size_t blockAlignment;
+	const size_t blockSize;
+
+	FreeBlock* freeBlocks = nullptr;
+	std::vector<void*> slabs;
+	size_t blocksInUse = 0;
+	mutable std::mutex mutex;
+
+	// Last values sent to the metrics, which only take deltas
+	int64_t exportedBlocksInUse = 0;
+	int64_t exportedBlocksReserved = 0;
+};
+
+/**
+ * Allocator for the items created through std::allocate_shared, the object
+ * and its control block share one block of the pool named after the item type.
+ */
+template <typename T>
+struct ItemPoolAllocator {
+	using value_type = T;
+
+	explicit ItemPoolAllocator(std::string_view poolName) noexcept :
+		poolName(poolName) { }
+
+	template <typename U>
+	ItemPoolAllocator(const ItemPoolAllocator<U> &other) noexcept :
+		poolName(other.poolName) { }
+
+	T* allocate(size_t n) {
+		if (n == 1) {
+			return static_cast<T*>(getPool().allocate());
+		}
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T* block, size_t n) noexcept {
+		if (n == 1) {
+			getPool().deallocate(block);
+			return;
+		}
+		::operator delete(block);
+	}
+
+	template <typename U>
+	bool operator==(const ItemPoolAllocator<U> &) const noexcept {
+		return std::is_same_v<T, U>;
+	}
+
+	std::string_view poolName;
+
+private:
+	ItemSlabPool &getPool() const {
+		// One pool per control block type, never destroyed as items can outlive other statics
+		static auto* pool = new ItemSlabPool(poolName, sizeof(T), alignof(T));
+		return *pool;
+	}
+};
+
+template <typename T, typename... Args>
+std::shared_ptr<T> makePooledItem(std::string_view poolName, Args &&... args) {
+	return std::allocate_shared<T>(ItemPoolAllocator<T>(poolName), std::forward<Args>(args)...);
+}
@@ -14,6 +14,7 @@
 #include "items/weapons/weapons.hpp"
 #include "lua/creature/movement.hpp"
 #include "game/game.hpp"
+#include "game/scheduling/dispatcher.hpp"
 #include "utils/pugicast.hpp"
 
 #include <appearances.pb.h>
@@ -22,13 +23,24 @@ Items::Items() = default;
 
 void Items::clear() {
 	items.clear();
+	flags.clear();
 	ladders.clear();
 	dummys.clear();
 	nameToItems.clear();
+	typeDescriptions.clear();
+	++typesRevision;
 	g_moveEvents().clear(true);
 	g_weapons().clear(true);
 }
 
+const std::vector<std::pair<std::string, std::string>> &Items::getTypeDescriptions(const ItemType &it) {
+	auto iterator = typeDescriptions.find(it.id);
+	if (iterator == typeDescriptions.end()) {
+		iterator = typeDescriptions.emplace(it.id, Item::getDescriptions(it)).first;
+	}
+	return iterator->second;
+}
+
 using LootTypeNames = phmap::flat_hash_map<std::string, ItemTypes_t>;
 
 LootTypeNames lootTypeNames = {
@@ -119,28 +131,10 @@ bool Items::reload() {
 	return true;
 }
 
-void Items::loadFromProtobuf() {
-	using namespace Canary::protobuf::appearances;
-
-	bool supportAnimation = g_configManager().getBoolean(OLD_PROTOCOL, __FUNCTION__);
-	for (uint32_t it = 0; it < g_game().m_appearancesPtr->object_size(); ++it) {
-		Appearance object = g_game().m_appearancesPtr->object(it);
-
-		// This scenario should never happen but on custom assets this can break the loader.
-		if (!object.has_flags()) {
-			g_logger().warn("[Items::loadFromProtobuf] - Item with id '{}' is invalid and was ignored.", object.id());
-			continue;
-		}
-
-		if (object.id() >= items.size()) {
-			items.resize(object.id() + 1);
-		}
-
-		if (!object.has_id()) {
-			continue;
-		}
+namespace {
+	void loadAppearance(const Canary::protobuf::appearances::Appearance &object, ItemType &iType, bool supportAnimation) {
+		using namespace Canary::protobuf::appearances;
 
-		ItemType &iType = items[object.id()];
 		if (object.flags().container()) {
 			iType.type = ITEM_TYPE_CONTAINER;
 			iType.group = ITEM_GROUP_CONTAINER;
@@ -155,7 +149,7 @@ void Items::loadFromProtobuf() {
 		// This attribute is only used on 10x protocol, so we should not waste our time iterating it when it's disabled.
 		if (supportAnimation) {
 			for (uint32_t frame_it = 0; frame_it < object.frame_group_size(); ++frame_it) {
-				FrameGroup objectFrame = object.frame_group(frame_it);
+				const auto &objectFrame = object.frame_group(frame_it);
 				if (!objectFrame.has_sprite_info()) {
 					continue;
 				}
@@ -227,9 +221,63 @@ void Items::loadFromProtobuf() {
 		iType.expire = object.flags().expire();
 		iType.expireStop = object.flags().expirestop();
 		iType.isWrapKit = object.flags().wrapkit();
+	}
+}
+
+void Items::loadFromProtobuf() {
+	const auto &appearances = *g_game().m_appearancesPtr;
+	const auto objectCount = static_cast<size_t>(appearances.object_size());
+
+	// The table is sized once, so the objects can be decoded into it from any thread
+	size_t tableSize = items.size();
+	bool hasDuplicates = false;
+	std::vector<bool> seenIds;
+	for (size_t it = 0; it < objectCount; ++it) {
+		const auto &object = appearances.object(static_cast<int>(it));
+		// This scenario should never happen but on custom assets this can break the loader.
+		if (!object.has_flags()) {
+			g_logger().warn("[Items::loadFromProtobuf] - Item with id '{}' is invalid and was ignored.", object.id());
+			continue;
+		}
+
+		tableSize = std::max<size_t>(tableSize, object.id() + 1);
+		if (!object.has_id()) {
+			continue;
+		}
+
+		if (object.id() >= seenIds.size()) {
+			seenIds.resize(object.id() + 1);
+		}
+		hasDuplicates = hasDuplicates || seenIds[object.id()];
+		seenIds[object.id()] = true;
+	}
+
+	items.resize(tableSize);
+
+	const bool supportAnimation = g_configManager().getBoolean(OLD_PROTOCOL, __FUNCTION__);
+	const auto decode = [&](size_t it) {
+		const auto &object = appearances.object(static_cast<int>(it));
+		if (object.has_flags() && object.has_id()) {
+			loadAppearance(object, items[object.id()], supportAnimation);
+		}
+	};
+	const auto addName = [&](size_t it) {
+		const auto &object = appearances.object(static_cast<int>(it));
+		if (object.has_flags() && object.has_id() && !items[object.id()].name.empty()) {
+			nameToItems.insert({ asLowerCaseString(items[object.id()].name), static_cast<uint16_t>(object.id()) });
+		}
+	};
 
-		if (!iType.name.empty()) {
-			nameToItems.insert({ asLowerCaseString(iType.name), iType.id });
+	// A repeated id on custom assets merges into one type, in file order
+	if (hasDuplicates) {
+		for (size_t it = 0; it < objectCount; ++it) {
+			decode(it);
+			addName(it);
+		}
+	} else {
+		g_dispatcher().asyncWait(objectCount, decode);
+		for (size_t it = 0; it < objectCount; ++it) {
+			addName(it);
 		}
 	}
 
@@ -271,9 +319,46 @@ bool Items::loadFromXml() {
 			parseItemNode(itemNode, id++);
 		}
 	}
+
+	flags.clear();
+	flags.reserve(items.size());
+	for (const auto &type : items) {
+		flags.emplace_back(getFlags(type));
+	}
 	return true;
 }
 
+uint16_t Items::getFlags(const ItemType &type) {
+	uint16_t typeFlags = 0;
+	const auto setFlag = [&typeFlags](ItemTypeFlag_t flag, bool value) {
+		if (value) {
+			typeFlags |= flag;
+		}
+	};
+
+	setFlag(ITEMTYPE_FLAG_BLOCKSOLID, type.blockSolid);
+	setFlag(ITEMTYPE_FLAG_BLOCKPROJECTILE, type.blockProjectile);
+	setFlag(ITEMTYPE_FLAG_BLOCKPATHFIND, type.blockPathFind);
+	setFlag(ITEMTYPE_FLAG_MOVABLE, type.movable);
+	setFlag(ITEMTYPE_FLAG_STACKABLE, type.stackable);
+	setFlag(ITEMTYPE_FLAG_ALWAYSONTOP, type.alwaysOnTopOrder != 0);
+	setFlag(ITEMTYPE_FLAG_HASHEIGHT, type.hasHeight);
+	setFlag(ITEMTYPE_FLAG_VERTICAL, type.isVertical);
+	setFlag(ITEMTYPE_FLAG_HORIZONTAL, type.isHorizontal);
+	setFlag(ITEMTYPE_FLAG_GROUNDTILE, type.isGroundTile());
+	setFlag(ITEMTYPE_FLAG_MAGICFIELD, type.isMagicField());
+	setFlag(ITEMTYPE_FLAG_WALKSTACK, type.walkStack);
+	setFlag(ITEMTYPE_FLAG_FLOORCHANGE, type.floorChange != TILESTATE_NONE);
+	setFlag(ITEMTYPE_FLAG_TELEPORT, type.isTeleport());
+	return typeFlags;
+}
+
+void Items::updateFlags(uint16_t id) {
+	if (id < flags.size() && id < items.size()) {
+		flags[id] = getFlags(items[id]);
+	}
+}
+
 void Items::buildInventoryList() {
 	inventory.reserve(items.size());
 	for (const auto &type : items) {
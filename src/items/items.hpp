@@ -382,6 +382,26 @@ public:
 	bool m_canBeUsedByGuests = false;
 };
 
+/**
+ * Flags of an item type read on the tile and pathfinding hot paths.
+ */
+enum ItemTypeFlag_t : uint16_t {
+	ITEMTYPE_FLAG_BLOCKSOLID = 1 << 0,
+	ITEMTYPE_FLAG_BLOCKPROJECTILE = 1 << 1,
+	ITEMTYPE_FLAG_BLOCKPATHFIND = 1 << 2,
+	ITEMTYPE_FLAG_MOVABLE = 1 << 3,
+	ITEMTYPE_FLAG_STACKABLE = 1 << 4,
+	ITEMTYPE_FLAG_ALWAYSONTOP = 1 << 5,
+	ITEMTYPE_FLAG_HASHEIGHT = 1 << 6,
+	ITEMTYPE_FLAG_VERTICAL = 1 << 7,
+	ITEMTYPE_FLAG_HORIZONTAL = 1 << 8,
+	ITEMTYPE_FLAG_GROUNDTILE = 1 << 9,
+	ITEMTYPE_FLAG_MAGICFIELD = 1 << 10,
+	ITEMTYPE_FLAG_WALKSTACK = 1 << 11,
+	ITEMTYPE_FLAG_FLOORCHANGE = 1 << 12,
+	ITEMTYPE_FLAG_TELEPORT = 1 << 13,
+};
+
 class Items {
 public:
 	using NameMap = std::unordered_multimap<std::string, uint16_t>;
@@ -396,6 +416,16 @@ public:
 	bool reload();
 	void clear();
 
+	// Changes whenever the types are loaded again, descriptions built from the previous ones are stale then
+	uint32_t getTypesRevision() const {
+		return typesRevision;
+	}
+
+	/**
+	 * @brief Inspection lines of the type by itself, built once per load of the types.
+	 */
+	const std::vector<std::pair<std::string, std::string>> &getTypeDescriptions(const ItemType &it);
+
 	void loadFromProtobuf();
 
 	const ItemType &operator[](size_t id) const {
@@ -404,6 +434,20 @@ public:
 	const ItemType &getItemType(size_t id) const;
 	ItemType &getItemType(size_t id);
 
+	/**
+	 * @brief Checks a flag of the type without touching the ItemType.
+	 * The flags of every server id sit in one flat array, so the tile and pathfinding loops stay in a few cache lines.
+	 */
+	bool hasFlag(size_t id, ItemTypeFlag_t flag) const {
+		// Same fallback to the first type as getItemType
+		if (id >= flags.size()) {
+			return !flags.empty() && (flags.front() & flag) != 0;
+		}
+		return (flags[id] & flag) != 0;
+	}
+	// Must follow any change of the flagged ItemType fields after loading
+	void updateFlags(uint16_t id);
+
 	/**
 	 * @brief Check if the itemid "hasId" is stored on "items", if not, return false
 	 *
@@ -458,8 +502,13 @@ public:
 	}
 
 private:
+	static uint16_t getFlags(const ItemType &type);
+
 	std::vector<ItemType> items;
+	std::vector<uint16_t> flags;
 	std::vector<uint16_t> ladders;
 	std::unordered_map<uint16_t, uint16_t> dummys;
 	InventoryVector inventory;
+	phmap::flat_hash_map<uint16_t, std::vector<std::pair<std::string, std::string>>> typeDescriptions;
+	uint32_t typesRevision = 0;
 };
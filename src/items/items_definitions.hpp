@@ -454,6 +454,8 @@ enum TileFlags_t : uint32_t {
 	TILESTATE_ISVERTICAL = 1 << 26,
 	TILESTATE_BLOCKPROJECTILE = 1 << 27,
 	TILESTATE_HASHEIGHT = 1 << 28,
+	// An item of the tile has a step or add/remove item move event
+	TILESTATE_MOVEEVENT = 1 << 29,
 
 	TILESTATE_FLOORCHANGE = TILESTATE_FLOORCHANGE_DOWN | TILESTATE_FLOORCHANGE_NORTH | TILESTATE_FLOORCHANGE_SOUTH | TILESTATE_FLOORCHANGE_EAST | TILESTATE_FLOORCHANGE_WEST | TILESTATE_FLOORCHANGE_SOUTH_ALT | TILESTATE_FLOORCHANGE_EAST_ALT,
 };
@@ -22,6 +22,7 @@
 #include "io/iomap.hpp"
 #include "map/spectators.hpp"
 #include "enums/account_type.hpp"
+#include "utils/hash.hpp"
 
 auto real_nullptr_tile = std::make_shared<StaticTile>(0xFFFF, 0xFFFF, 0xFF);
 const std::shared_ptr<Tile> &Tile::nullptr_tile = real_nullptr_tile;
@@ -327,7 +328,7 @@ std::shared_ptr<Item> Tile::getItemByTopOrder(int32_t topOrder) {
 	// 3: doors etc
 	// 4: creatures
 	if (TileItemVector* items = getItemList()) {
-		for (auto it = ItemVector::const_reverse_iterator(items->getEndTopItem()), end = ItemVector::const_reverse_iterator(items->getBeginTopItem()); it != end; ++it) {
+		for (auto it = TileItemVector::const_reverse_iterator(items->getEndTopItem()), end = TileItemVector::const_reverse_iterator(items->getBeginTopItem()); it != end; ++it) {
 			if (Item::items[(*it)->getID()].alwaysOnTopOrder == topOrder) {
 				return (*it);
 			}
@@ -344,14 +345,14 @@ std::shared_ptr<Thing> Tile::getTopVisibleThing(std::shared_ptr<Creature> creatu
 
 	TileItemVector* items = getItemList();
 	if (items) {
-		for (ItemVector::const_iterator it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
+		for (TileItemVector::const_iterator it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
 			const ItemType &iit = Item::items[(*it)->getID()];
 			if (!iit.lookThrough) {
 				return (*it);
 			}
 		}
 
-		for (auto it = ItemVector::const_reverse_iterator(items->getEndTopItem()), end = ItemVector::const_reverse_iterator(items->getBeginTopItem()); it != end; ++it) {
+		for (auto it = TileItemVector::const_reverse_iterator(items->getEndTopItem()), end = TileItemVector::const_reverse_iterator(items->getBeginTopItem()); it != end; ++it) {
 			const ItemType &iit = Item::items[(*it)->getID()];
 			if (!iit.lookThrough) {
 				return (*it);
@@ -363,6 +364,14 @@ std::shared_ptr<Thing> Tile::getTopVisibleThing(std::shared_ptr<Creature> creatu
 }
 
 void Tile::onAddTileItem(std::shared_ptr<Item> item) {
+	basicTile.reset();
+	g_game().map.invalidateTileDescriptions();
+
+	if (SectorGraph::affectsWalkability(item->getID())) {
+		g_game().map.sectorGraph.invalidate(getPosition());
+		g_game().map.followPathCache.invalidate();
+	}
+
 	if ((item->hasProperty(CONST_PROP_MOVABLE) || item->getContainer()) || (item->isWrapable() && !item->hasProperty(CONST_PROP_MOVABLE) && !item->hasProperty(CONST_PROP_BLOCKPATH))) {
 		auto it = g_game().browseFields.find(static_self_cast<Tile>());
 		if (it != g_game().browseFields.end()) {
@@ -436,6 +445,14 @@ void Tile::onAddTileItem(std::shared_ptr<Item> item) {
 }
 
 void Tile::onUpdateTileItem(std::shared_ptr<Item> oldItem, const ItemType &oldType, std::shared_ptr<Item> newItem, const ItemType &newType) {
+	basicTile.reset();
+	g_game().map.invalidateTileDescriptions();
+
+	if (SectorGraph::affectsWalkability(oldType.id) || SectorGraph::affectsWalkability(newType.id)) {
+		g_game().map.sectorGraph.invalidate(getPosition());
+		g_game().map.followPathCache.invalidate();
+	}
+
 	if ((newItem->hasProperty(CONST_PROP_MOVABLE) || newItem->getContainer()) || (newItem->isWrapable() && newItem->hasProperty(CONST_PROP_MOVABLE) && !oldItem->hasProperty(CONST_PROP_BLOCKPATH))) {
 		auto it = g_game().browseFields.find(getTile());
 		if (it != g_game().browseFields.end()) {
@@ -478,6 +495,14 @@ void Tile::onUpdateTileItem(std::shared_ptr<Item> oldItem, const ItemType &oldTy
 }
 
 void Tile::onRemoveTileItem(const CreatureVector &spectators, const std::vector<int32_t> &oldStackPosVector, std::shared_ptr<Item> item) {
+	basicTile.reset();
+	g_game().map.invalidateTileDescriptions();
+
+	if (SectorGraph::affectsWalkability(item->getID())) {
+		g_game().map.sectorGraph.invalidate(getPosition());
+		g_game().map.followPathCache.invalidate();
+	}
+
 	if ((item->hasProperty(CONST_PROP_MOVABLE) || item->getContainer()) || (item->isWrapable() && !item->hasProperty(CONST_PROP_MOVABLE) && !item->hasProperty(CONST_PROP_BLOCKPATH))) {
 		auto it = g_game().browseFields.find(getTile());
 		if (it != g_game().browseFields.end()) {
@@ -487,7 +512,7 @@ void Tile::onRemoveTileItem(const CreatureVector &spectators, const std::vector<
 			}
 		}
 	}
-	for (auto &zone : getZones()) {
+	for (const auto &zone : *getZones()) {
 		zone->itemRemoved(item);
 	}
 
@@ -743,17 +768,13 @@ ReturnValue Tile::queryAdd(int32_t, const std::shared_ptr<Thing> &thing, uint32_
 			}
 		} else {
 			// FLAG_IGNOREBLOCKITEM is set
-			if (ground) {
-				const ItemType &iiType = Item::items[ground->getID()];
-				if (iiType.blockSolid && (!iiType.movable || ground->hasAttribute(ItemAttribute_t::UNIQUEID))) {
-					return RETURNVALUE_NOTPOSSIBLE;
-				}
+			if (ground && ground->isBlocking() && (!ground->isMovable() || ground->hasAttribute(ItemAttribute_t::UNIQUEID))) {
+				return RETURNVALUE_NOTPOSSIBLE;
 			}
 
 			if (const auto items = getItemList()) {
 				for (auto &item : *items) {
-					const ItemType &iiType = Item::items[item->getID()];
-					if (iiType.blockSolid && (!iiType.movable || item->hasAttribute(ItemAttribute_t::UNIQUEID))) {
+					if (item->isBlocking() && (!item->isMovable() || item->hasAttribute(ItemAttribute_t::UNIQUEID))) {
 						return RETURNVALUE_NOTPOSSIBLE;
 					}
 				}
@@ -836,6 +857,65 @@ ReturnValue Tile::checkNpcCanWalkIntoTile() const {
 	}
 }
 
+void Tile::setBasicTile(const std::shared_ptr<BasicTile> &newBasicTile) {
+	basicTile = newBasicTile;
+	basicStateHash = basicTile ? getItemStateHash() : 0;
+}
+
+bool Tile::canDemote() {
+	if (!basicTile || getCreatureCount() != 0 || getHouse()) {
+		return false;
+	}
+
+	// Anything else holding an item, like a decay list or a zone, keeps the tile loaded
+	const auto isMapOwned = [](const std::shared_ptr<Item> &item) {
+		return item.use_count() == 1 && item->getDecaying() == DECAYING_FALSE && !item->getContainer() && !item->hasAttribute(ItemAttribute_t::UNIQUEID) && !item->hasCustomAttribute();
+	};
+
+	if (ground && !isMapOwned(ground)) {
+		return false;
+	}
+
+	if (const auto items = getItemList()) {
+		if (!std::ranges::all_of(*items, isMapOwned)) {
+			return false;
+		}
+	}
+
+	// Attribute changes do not go through the tile, so compare against the state right after materialization
+	return getItemStateHash() == basicStateHash;
+}
+
+size_t Tile::getItemStateHash() const {
+	size_t hash = 0;
+	const auto addItem = [&hash](const std::shared_ptr<Item> &item) {
+		size_t itemHash = 0;
+		stdext::hash_combine(itemHash, item->getID());
+		stdext::hash_combine(itemHash, static_cast<uint32_t>(item->getItemCount()));
+		item->forEachAttribute([&itemHash](ItemAttribute_t type, const auto &value) {
+			stdext::hash_combine(itemHash, static_cast<uint32_t>(type));
+			if constexpr (std::is_same_v<std::decay_t<decltype(value)>, int64_t>) {
+				stdext::hash_combine(itemHash, static_cast<uint64_t>(value));
+			} else {
+				stdext::hash_combine(itemHash, value);
+			}
+		});
+		// Order independent, the tile sorts its items differently from the map file
+		hash += itemHash;
+	};
+
+	if (ground) {
+		addItem(ground);
+	}
+
+	if (const auto items = getItemList()) {
+		for (const auto &item : *items) {
+			addItem(item);
+		}
+	}
+	return hash;
+}
+
 bool Tile::hasHarmfulField() const {
 	return hasFlag(TILESTATE_MAGICFIELD) && getFieldItem() && !getFieldItem()->isBlocking() && getFieldItem()->getDamage() > 0;
 }
@@ -994,11 +1074,12 @@ void Tile::addThing(int32_t, std::shared_ptr<Thing> thing) {
 
 	std::shared_ptr<Creature> creature = thing->getCreature();
 	if (creature) {
-		Spectators::clearCache();
+		Spectators::clearCache(getPosition());
 		creature->setParent(static_self_cast<Tile>());
 
 		CreatureVector* creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
+		refreshPathFlags();
 	} else {
 		std::shared_ptr<Item> item = thing->getItem();
 		if (item == nullptr) {
@@ -1031,7 +1112,7 @@ void Tile::addThing(int32_t, std::shared_ptr<Thing> thing) {
 		} else if (item->isAlwaysOnTop()) {
 			if (itemType.isSplash() && items) {
 				// remove old splash if exists
-				for (ItemVector::const_iterator it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
+				for (TileItemVector::const_iterator it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
 					std::shared_ptr<Item> oldSplash = *it;
 					if (!Item::items[oldSplash->getID()].isSplash()) {
 						continue;
@@ -1068,7 +1149,7 @@ void Tile::addThing(int32_t, std::shared_ptr<Thing> thing) {
 			if (itemType.isMagicField()) {
 				// remove old field item if exists
 				if (items) {
-					for (ItemVector::const_iterator it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
+					for (TileItemVector::const_iterator it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
 						std::shared_ptr<MagicField> oldField = (*it)->getMagicField();
 						if (oldField) {
 							if (oldField->isReplaceable()) {
@@ -1193,8 +1274,9 @@ void Tile::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 		if (creatures) {
 			auto it = std::find(creatures->begin(), creatures->end(), thing);
 			if (it != creatures->end()) {
-				Spectators::clearCache();
+				Spectators::clearCache(getPosition());
 				creatures->erase(it);
+				refreshPathFlags();
 			}
 		}
 		return;
@@ -1213,6 +1295,7 @@ void Tile::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 	if (item == ground) {
 		ground->resetParent();
 		ground = nullptr;
+		refreshPathFlags();
 
 		auto spectators = Spectators().find<Creature>(getPosition(), true);
 		onRemoveTileItem(spectators.data(), std::vector<int32_t>(spectators.size(), 0), item);
@@ -1273,6 +1356,9 @@ void Tile::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 
 void Tile::removeCreature(std::shared_ptr<Creature> creature) {
 	g_game().map.getMapSector(tilePos.x, tilePos.y)->removeCreature(creature);
+	if (creature->getPlayer()) {
+		g_game().map.changeNearbyPlayers(tilePos.x, tilePos.y, -1);
+	}
 	removeThing(creature, 0);
 }
 
@@ -1487,8 +1573,16 @@ std::shared_ptr<Thing> Tile::getThing(size_t index) const {
 	return nullptr;
 }
 
+void Tile::postAddNotification(const std::shared_ptr<Thing> &thing, const std::shared_ptr<Cylinder> &oldParent, int32_t index, const Spectators &nearby) {
+	notifyAdded(thing, oldParent, index, LINK_OWNER, nearby.filterPlayersInView(getPosition()));
+}
+
 void Tile::postAddNotification(std::shared_ptr<Thing> thing, std::shared_ptr<Cylinder> oldParent, int32_t index, CylinderLink_t link /*= LINK_OWNER*/) {
-	for (const auto &spectator : Spectators().find<Player>(getPosition(), true)) {
+	notifyAdded(thing, oldParent, index, link, Spectators().find<Player>(getPosition(), true));
+}
+
+void Tile::notifyAdded(const std::shared_ptr<Thing> &thing, const std::shared_ptr<Cylinder> &oldParent, int32_t index, CylinderLink_t link, const Spectators &spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->getPlayer()->postAddNotification(thing, oldParent, index, LINK_NEAR);
 	}
 
@@ -1501,6 +1595,13 @@ void Tile::postAddNotification(std::shared_ptr<Thing> thing, std::shared_ptr<Cyl
 		item = thing->getItem();
 	}
 
+	// Items added to the tile or to the containers on it, the house items are only saved when changed
+	if (item) {
+		if (const auto &house = getHouse()) {
+			house->markItemsChanged();
+		}
+	}
+
 	if (link == LINK_OWNER) {
 		if (hasFlag(TILESTATE_TELEPORT)) {
 			std::shared_ptr<Teleport> teleport = getTeleportItem();
@@ -1519,18 +1620,26 @@ void Tile::postAddNotification(std::shared_ptr<Thing> thing, std::shared_ptr<Cyl
 			}
 		}
 
-		// calling movement scripts
+		// calling movement scripts, the item may have left already through a teleport or a trash holder
 		if (creature) {
-			g_moveEvents().onCreatureMove(creature, static_self_cast<Tile>(), MOVE_EVENT_STEP_IN);
-		} else if (item) {
+			if (hasMoveEvents()) {
+				g_moveEvents().onCreatureMove(creature, static_self_cast<Tile>(), MOVE_EVENT_STEP_IN);
+			}
+		} else if (item && (hasMoveEvents() || g_moveEvents().hasTileEvents(item))) {
 			g_moveEvents().onItemMove(item, static_self_cast<Tile>(), true);
 		}
 	}
 }
 
+void Tile::postRemoveNotification(const std::shared_ptr<Thing> &thing, const std::shared_ptr<Cylinder> &newParent, int32_t index, const Spectators &nearby) {
+	notifyRemoved(thing, newParent, index, nearby.filterPlayersInView(getPosition()));
+}
+
 void Tile::postRemoveNotification(std::shared_ptr<Thing> thing, std::shared_ptr<Cylinder> newParent, int32_t index, CylinderLink_t) {
-	auto spectators = Spectators().find<Player>(getPosition(), true);
+	notifyRemoved(thing, newParent, index, Spectators().find<Player>(getPosition(), true));
+}
 
+void Tile::notifyRemoved(const std::shared_ptr<Thing> &thing, const std::shared_ptr<Cylinder> &newParent, int32_t index, const Spectators &spectators) {
 	if (getThingCount() > 8) {
 		onUpdateTile(spectators.data());
 	}
@@ -1542,11 +1651,19 @@ void Tile::postRemoveNotification(std::shared_ptr<Thing> thing, std::shared_ptr<
 	// calling movement scripts
 	std::shared_ptr<Creature> creature = thing->getCreature();
 	if (creature) {
-		g_moveEvents().onCreatureMove(creature, static_self_cast<Tile>(), MOVE_EVENT_STEP_OUT);
+		if (hasMoveEvents()) {
+			g_moveEvents().onCreatureMove(creature, static_self_cast<Tile>(), MOVE_EVENT_STEP_OUT);
+		}
 	} else {
 		std::shared_ptr<Item> item = thing->getItem();
 		if (item) {
-			g_moveEvents().onItemMove(item, static_self_cast<Tile>(), false);
+			if (const auto &house = getHouse()) {
+				house->markItemsChanged();
+			}
+			// The removed item no longer counts in the tile flag
+			if (hasMoveEvents() || g_moveEvents().hasTileEvents(item)) {
+				g_moveEvents().onItemMove(item, static_self_cast<Tile>(), false);
+			}
 		}
 	}
 }
@@ -1575,7 +1692,8 @@ void Tile::internalAddThing(uint32_t, std::shared_ptr<Thing> thing) {
 	if (!thing) {
 		return;
 	}
-	for (const auto &zone : getZones()) {
+	g_game().map.invalidateTileDescriptions();
+	for (const auto &zone : *getZones()) {
 		zone->thingAdded(thing);
 	}
 
@@ -1583,10 +1701,11 @@ void Tile::internalAddThing(uint32_t, std::shared_ptr<Thing> thing) {
 
 	std::shared_ptr<Creature> creature = thing->getCreature();
 	if (creature) {
-		Spectators::clearCache();
+		Spectators::clearCache(getPosition());
 
 		CreatureVector* creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
+		refreshPathFlags();
 	} else {
 		std::shared_ptr<Item> item = thing->getItem();
 		if (item == nullptr) {
@@ -1629,177 +1748,181 @@ void Tile::internalAddThing(uint32_t, std::shared_ptr<Thing> thing) {
 	}
 }
 
-void Tile::updateTileFlags(const std::shared_ptr<Item> &item) {
-	resetTileFlags(item);
-	setTileFlags(item);
-}
-
-void Tile::setTileFlags(const std::shared_ptr<Item> &item) {
-	if (!hasFlag(TILESTATE_FLOORCHANGE)) {
-		const auto &it = Item::items[item->getID()];
-		if (it.floorChange != 0) {
-			setFlag(it.floorChange);
-		}
-	}
-
-	if (item->hasProperty(CONST_PROP_IMMOVABLEBLOCKSOLID)) {
-		setFlag(TILESTATE_IMMOVABLEBLOCKSOLID);
-	}
-
-	if (item->hasProperty(CONST_PROP_BLOCKPATH)) {
-		setFlag(TILESTATE_BLOCKPATH);
-	}
-
-	if (item->hasProperty(CONST_PROP_NOFIELDBLOCKPATH)) {
-		setFlag(TILESTATE_NOFIELDBLOCKPATH);
-	}
-
-	if (item->hasProperty(CONST_PROP_IMMOVABLENOFIELDBLOCKPATH)) {
-		setFlag(TILESTATE_IMMOVABLENOFIELDBLOCKPATH);
-	}
-
-	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
-		setFlag(TILESTATE_SUPPORTS_HANGABLE);
-	}
-
-	if (item->getTeleport()) {
-		setFlag(TILESTATE_TELEPORT);
-	}
-
-	if (item->getMagicField()) {
-		setFlag(TILESTATE_MAGICFIELD);
-	}
-
-	if (item->getMailbox()) {
-		setFlag(TILESTATE_MAILBOX);
-	}
-
-	if (item->getTrashHolder()) {
-		setFlag(TILESTATE_TRASHHOLDER);
-	}
-
-	if (item->hasProperty(CONST_PROP_BLOCKSOLID)) {
-		setFlag(TILESTATE_BLOCKSOLID);
-	}
-
-	if (item->getBed()) {
-		setFlag(TILESTATE_BED);
-	}
-
-	if (item->hasProperty(CONST_PROP_IMMOVABLEBLOCKPATH)) {
-		setFlag(TILESTATE_IMMOVABLEBLOCKPATH);
-	}
-
-	if (item->hasProperty(CONST_PROP_MOVABLE)) {
-		setFlag(TILESTATE_MOVABLE);
-	}
-
-	if (item->hasProperty(CONST_PROP_ISHORIZONTAL)) {
-		setFlag(TILESTATE_ISHORIZONTAL);
+uint8_t Tile::getPathFlags() const {
+	uint8_t flags = Floor::PATH_TILE;
+	// The flag is set before the field is in the item list and cleared by any field leaving, so check both
+	if (hasFlag(TILESTATE_MAGICFIELD) || getFieldItem()) {
+		flags |= Floor::PATH_FIELD;
 	}
 
-	if (item->hasProperty(CONST_PROP_ISVERTICAL)) {
-		setFlag(TILESTATE_ISVERTICAL);
+	if (const CreatureVector* creatures = getCreatures(); creatures && !creatures->empty()) {
+		flags |= Floor::PATH_CREATURE;
 	}
 
-	if (item->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
-		setFlag(TILESTATE_BLOCKPROJECTILE);
+	if (hasFlag(TILESTATE_BLOCKPROJECTILE)) {
+		flags |= Floor::PATH_BLOCKPROJECTILE;
 	}
 
-	if (item->hasProperty(CONST_PROP_HASHEIGHT)) {
-		setFlag(TILESTATE_HASHEIGHT);
+	if (!ground || hasFlag(TILESTATE_FLOORCHANGE | TILESTATE_TELEPORT | TILESTATE_IMMOVABLEBLOCKSOLID | TILESTATE_IMMOVABLENOFIELDBLOCKPATH)) {
+		flags |= Floor::PATH_BLOCKMONSTER;
+	} else if (hasFlag(TILESTATE_PROTECTIONZONE | TILESTATE_BLOCKSOLID | TILESTATE_NOFIELDBLOCKPATH) || (ground->getID() >= ITEM_WALKABLE_SEA_START && ground->getID() <= ITEM_WALKABLE_SEA_END)) {
+		flags |= Floor::PATH_CHECKMONSTER;
 	}
+	return flags;
+}
 
-	if (const auto &container = item->getContainer()) {
-		if (container->getDepotLocker()) {
-			setFlag(TILESTATE_DEPOT);
+void Tile::refreshPathFlags() {
+	const auto &pos = getPosition();
+	if (const auto sector = g_game().map.getMapSector(pos.x, pos.y)) {
+		if (const auto &floor = sector->getFloor(pos.z)) {
+			const uint8_t flags = getPathFlags();
+			const uint8_t changed = floor->getPathFlags(pos.x, pos.y) ^ flags;
+			if (changed & Floor::PATH_BLOCKPROJECTILE) {
+				g_game().map.invalidateSightLines();
+			}
+			if (changed & ~Floor::PATH_CREATURE) {
+				g_game().map.invalidateWalkability();
+			}
+			floor->setPathFlags(pos.x, pos.y, flags);
 		}
 	}
-
-	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
-		setFlag(TILESTATE_SUPPORTS_HANGABLE);
-	}
 }
 
-void Tile::resetTileFlags(const std::shared_ptr<Item> &item) {
-	const ItemType &it = Item::items[item->getID()];
-	if (it.floorChange != 0) {
-		resetFlag(TILESTATE_FLOORCHANGE);
-	}
-
-	if (item->hasProperty(CONST_PROP_BLOCKSOLID) && !hasProperty(item, CONST_PROP_BLOCKSOLID)) {
-		resetFlag(TILESTATE_BLOCKSOLID);
-	}
-
-	if (item->hasProperty(CONST_PROP_IMMOVABLEBLOCKSOLID) && !hasProperty(item, CONST_PROP_IMMOVABLEBLOCKSOLID)) {
-		resetFlag(TILESTATE_IMMOVABLEBLOCKSOLID);
-	}
-
-	if (item->hasProperty(CONST_PROP_BLOCKPATH) && !hasProperty(item, CONST_PROP_BLOCKPATH)) {
-		resetFlag(TILESTATE_BLOCKPATH);
+bool Tile::hasMoveEvents() {
+	const auto &moveEvents = g_moveEvents();
+	if (const auto version = moveEvents.getVersion();
+	    moveEventsVersion != version) {
+		refreshMoveEventFlag();
+		moveEventsVersion = version;
 	}
+	return hasFlag(TILESTATE_MOVEEVENT) || moveEvents.hasPositionEvents(getPosition());
+}
 
-	if (item->hasProperty(CONST_PROP_NOFIELDBLOCKPATH) && !hasProperty(item, CONST_PROP_NOFIELDBLOCKPATH)) {
-		resetFlag(TILESTATE_NOFIELDBLOCKPATH);
+void Tile::refreshMoveEventFlag() {
+	const auto &moveEvents = g_moveEvents();
+	bool hasEvents = ground && moveEvents.hasTileEvents(ground);
+	if (const TileItemVector* items = getItemList(); !hasEvents && items) {
+		hasEvents = std::ranges::any_of(*items, [&moveEvents](const auto &item) {
+			return moveEvents.hasTileEvents(item);
+		});
 	}
 
-	if (item->hasProperty(CONST_PROP_IMMOVABLEBLOCKPATH) && !hasProperty(item, CONST_PROP_IMMOVABLEBLOCKPATH)) {
-		resetFlag(TILESTATE_IMMOVABLEBLOCKPATH);
+	if (hasEvents) {
+		setFlag(TILESTATE_MOVEEVENT);
+	} else {
+		resetFlag(TILESTATE_MOVEEVENT);
 	}
+}
 
-	if (item->hasProperty(CONST_PROP_IMMOVABLENOFIELDBLOCKPATH) && !hasProperty(item, CONST_PROP_IMMOVABLENOFIELDBLOCKPATH)) {
-		resetFlag(TILESTATE_IMMOVABLENOFIELDBLOCKPATH);
-	}
+void Tile::updateTileFlags(const std::shared_ptr<Item> &item) {
+	resetTileFlags(item);
+	setTileFlags(item);
+}
 
-	if (item->hasProperty(CONST_PROP_MOVABLE) && !hasProperty(item, CONST_PROP_MOVABLE)) {
-		resetFlag(TILESTATE_MOVABLE);
-	}
+uint32_t Tile::getItemTileFlags(const std::shared_ptr<Item> &item) {
+	uint32_t itemFlags = 0;
+	const auto setIf = [&itemFlags](bool value, uint32_t flag) {
+		if (value) {
+			itemFlags |= flag;
+		}
+	};
 
-	if (item->hasProperty(CONST_PROP_ISHORIZONTAL) && !hasProperty(item, CONST_PROP_ISHORIZONTAL)) {
-		resetFlag(TILESTATE_ISHORIZONTAL);
+	if (Item::items.hasFlag(item->getID(), ITEMTYPE_FLAG_FLOORCHANGE)) {
+		itemFlags |= Item::items[item->getID()].floorChange;
+	}
+
+	setIf(item->hasProperty(CONST_PROP_BLOCKSOLID), TILESTATE_BLOCKSOLID);
+	setIf(item->hasProperty(CONST_PROP_BLOCKPATH), TILESTATE_BLOCKPATH);
+	setIf(item->hasProperty(CONST_PROP_NOFIELDBLOCKPATH), TILESTATE_NOFIELDBLOCKPATH);
+	setIf(item->hasProperty(CONST_PROP_SUPPORTHANGABLE), TILESTATE_SUPPORTS_HANGABLE);
+	setIf(item->hasProperty(CONST_PROP_ISHORIZONTAL), TILESTATE_ISHORIZONTAL);
+	setIf(item->hasProperty(CONST_PROP_ISVERTICAL), TILESTATE_ISVERTICAL);
+	setIf(item->hasProperty(CONST_PROP_BLOCKPROJECTILE), TILESTATE_BLOCKPROJECTILE);
+	setIf(item->hasProperty(CONST_PROP_HASHEIGHT), TILESTATE_HASHEIGHT);
+
+	// The movable checks read the item attributes, done once for the four flags
+	const bool movable = item->canBeMoved();
+	setIf(movable, TILESTATE_MOVABLE);
+	if (!movable) {
+		setIf(hasBitSet(TILESTATE_BLOCKSOLID, itemFlags), TILESTATE_IMMOVABLEBLOCKSOLID);
+		setIf(hasBitSet(TILESTATE_BLOCKPATH, itemFlags), TILESTATE_IMMOVABLEBLOCKPATH);
+		setIf(hasBitSet(TILESTATE_NOFIELDBLOCKPATH, itemFlags), TILESTATE_IMMOVABLENOFIELDBLOCKPATH);
+	}
+
+	setIf(g_moveEvents().hasTileEvents(item), TILESTATE_MOVEEVENT);
+	setIf(item->getTeleport() != nullptr, TILESTATE_TELEPORT);
+	setIf(item->getMagicField() != nullptr, TILESTATE_MAGICFIELD);
+	setIf(item->getMailbox() != nullptr, TILESTATE_MAILBOX);
+	setIf(item->getTrashHolder() != nullptr, TILESTATE_TRASHHOLDER);
+	setIf(item->getBed() != nullptr, TILESTATE_BED);
+	if (const auto &container = item->getContainer()) {
+		setIf(container->getDepotLocker() != nullptr, TILESTATE_DEPOT);
 	}
+	return itemFlags;
+}
 
-	if (item->hasProperty(CONST_PROP_ISVERTICAL) && !hasProperty(item, CONST_PROP_ISVERTICAL)) {
-		resetFlag(TILESTATE_ISVERTICAL);
-	}
+uint32_t Tile::getItemsTileFlags(const std::shared_ptr<Item> &exclude) const {
+	uint32_t itemsFlags = 0;
+	const auto addItem = [&](const std::shared_ptr<Item> &item) {
+		if (!item || item == exclude) {
+			return;
+		}
 
-	if (item->hasProperty(CONST_PROP_BLOCKPROJECTILE) && !hasProperty(item, CONST_PROP_BLOCKPROJECTILE)) {
-		resetFlag(TILESTATE_BLOCKPROJECTILE);
-	}
+		auto itemFlags = getItemTileFlags(item);
+		// The first floor change item decides the direction, as in setTileFlags
+		if (hasBitSet(TILESTATE_FLOORCHANGE, itemsFlags)) {
+			itemFlags &= ~TILESTATE_FLOORCHANGE;
+		}
+		itemsFlags |= itemFlags;
+	};
 
-	if (item->hasProperty(CONST_PROP_HASHEIGHT) && !hasProperty(item, CONST_PROP_HASHEIGHT)) {
-		resetFlag(TILESTATE_HASHEIGHT);
+	addItem(ground);
+	if (const TileItemVector* items = getItemList()) {
+		for (const auto &item : *items) {
+			addItem(item);
+		}
 	}
+	return itemsFlags;
+}
 
-	if (item->getTeleport()) {
-		resetFlag(TILESTATE_TELEPORT);
-	}
+void Tile::checkTileFlags() const {
+#ifdef DEBUG_TILE_FLAGS
+	// Every flag a tile takes from its items, the zone flags come from the map
+	constexpr uint32_t itemTileFlags = TILESTATE_FLOORCHANGE | TILESTATE_TELEPORT | TILESTATE_MAGICFIELD | TILESTATE_MAILBOX | TILESTATE_TRASHHOLDER | TILESTATE_BED | TILESTATE_DEPOT | TILESTATE_BLOCKSOLID | TILESTATE_BLOCKPATH | TILESTATE_IMMOVABLEBLOCKSOLID | TILESTATE_IMMOVABLEBLOCKPATH | TILESTATE_IMMOVABLENOFIELDBLOCKPATH | TILESTATE_NOFIELDBLOCKPATH | TILESTATE_SUPPORTS_HANGABLE | TILESTATE_MOVABLE | TILESTATE_ISHORIZONTAL | TILESTATE_ISVERTICAL | TILESTATE_BLOCKPROJECTILE | TILESTATE_HASHEIGHT;
+	// The floor change direction depends on the order the items came in, only its presence is compared
+	constexpr uint32_t compared = itemTileFlags & ~TILESTATE_FLOORCHANGE;
 
-	if (item->getMagicField()) {
-		resetFlag(TILESTATE_MAGICFIELD);
+	const uint32_t expected = getItemsTileFlags(nullptr);
+	if ((flags & compared) != (expected & compared) || hasFlag(TILESTATE_FLOORCHANGE) != hasBitSet(TILESTATE_FLOORCHANGE, expected)) {
+		g_logger().error("[Tile::checkTileFlags] - Tile {} has flags {:#x}, its items give {:#x}", tilePos.toString(), flags & itemTileFlags, expected);
 	}
+#endif
+}
 
-	if (item->getMailbox()) {
-		resetFlag(TILESTATE_MAILBOX);
+void Tile::setTileFlags(const std::shared_ptr<Item> &item) {
+	auto itemFlags = getItemTileFlags(item);
+	if (hasFlag(TILESTATE_FLOORCHANGE)) {
+		itemFlags &= ~TILESTATE_FLOORCHANGE;
 	}
+	setFlag(itemFlags);
 
-	if (item->getTrashHolder()) {
-		resetFlag(TILESTATE_TRASHHOLDER);
-	}
+	checkTileFlags();
+	refreshPathFlags();
+}
 
-	if (item->getBed()) {
-		resetFlag(TILESTATE_BED);
+void Tile::resetTileFlags(const std::shared_ptr<Item> &item) {
+	uint32_t itemFlags = getItemTileFlags(item);
+	if (hasBitSet(TILESTATE_FLOORCHANGE, itemFlags)) {
+		itemFlags |= TILESTATE_FLOORCHANGE;
 	}
 
-	if (const auto &container = item->getContainer()) {
-		if (container->getDepotLocker()) {
-			resetFlag(TILESTATE_DEPOT);
-		}
+	// Most items give the tile no flag, the others are checked in a single pass over the rest
+	if (itemFlags != 0) {
+		const uint32_t othersFlags = getItemsTileFlags(item);
+		flags = (flags & ~itemFlags) | (othersFlags & itemFlags);
 	}
 
-	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
-		resetFlag(TILESTATE_SUPPORTS_HANGABLE);
-	}
+	refreshPathFlags();
 }
 
 bool Tile::isMovableBlocking() const {
@@ -1838,7 +1961,7 @@ std::shared_ptr<Item> Tile::getDoorItem() const {
 }
 
 void Tile::addZone(std::shared_ptr<Zone> zone) {
-	zones.emplace(zone);
+	zones = ZoneSet::with(zones, zone);
 	const auto &items = getItemList();
 	if (items) {
 		for (const auto &item : *items) {
@@ -1854,26 +1977,22 @@ void Tile::addZone(std::shared_ptr<Zone> zone) {
 }
 
 void Tile::clearZones() {
-	std::vector<std::shared_ptr<Zone>> zonesToRemove;
-	for (const auto &zone : zones) {
+	const auto &items = getItemList();
+	const auto &creatures = getCreatures();
+	zones = ZoneSet::filter(zones, [&](const std::shared_ptr<Zone> &zone) {
 		if (zone->isStatic()) {
-			continue;
+			return true;
 		}
-		zonesToRemove.emplace_back(zone);
-		const auto &items = getItemList();
 		if (items) {
 			for (const auto &item : *items) {
 				zone->itemRemoved(item);
 			}
 		}
-		const auto &creatures = getCreatures();
 		if (creatures) {
 			for (const auto &creature : *creatures) {
 				zone->creatureRemoved(creature);
 			}
 		}
-	}
-	for (const auto &zone : zonesToRemove) {
-		zones.erase(zone);
-	}
+		return false;
+	});
 }
@@ -13,6 +13,7 @@
 #include "declarations.hpp"
 #include "items/item.hpp"
 #include "utils/tools.hpp"
+#include "game/zones/zone_set.hpp"
 
 class Creature;
 class Teleport;
@@ -22,28 +23,34 @@ class MagicField;
 class BedItem;
 class House;
 class Zone;
+class Spectators;
+struct BasicTile;
 
 using CreatureVector = std::vector<std::shared_ptr<Creature>>;
 using ItemVector = std::vector<std::shared_ptr<Item>>;
 
-class TileItemVector : private ItemVector {
+// Most tiles hold a couple of items besides the ground, those are kept inline and only crowded tiles allocate
+static constexpr size_t TILE_INLINE_ITEMS = 2;
+using TileItemStorage = absl::InlinedVector<std::shared_ptr<Item>, TILE_INLINE_ITEMS>;
+
+class TileItemVector : private TileItemStorage {
 public:
-	using ItemVector::at;
-	using ItemVector::begin;
-	using ItemVector::clear;
-	using ItemVector::const_iterator;
-	using ItemVector::const_reverse_iterator;
-	using ItemVector::empty;
-	using ItemVector::end;
-	using ItemVector::erase;
-	using ItemVector::insert;
-	using ItemVector::iterator;
-	using ItemVector::push_back;
-	using ItemVector::rbegin;
-	using ItemVector::rend;
-	using ItemVector::reverse_iterator;
-	using ItemVector::size;
-	using ItemVector::value_type;
+	using TileItemStorage::at;
+	using TileItemStorage::begin;
+	using TileItemStorage::clear;
+	using TileItemStorage::const_iterator;
+	using TileItemStorage::const_reverse_iterator;
+	using TileItemStorage::empty;
+	using TileItemStorage::end;
+	using TileItemStorage::erase;
+	using TileItemStorage::insert;
+	using TileItemStorage::iterator;
+	using TileItemStorage::push_back;
+	using TileItemStorage::rbegin;
+	using TileItemStorage::rend;
+	using TileItemStorage::reverse_iterator;
+	using TileItemStorage::size;
+	using TileItemStorage::value_type;
 
 	iterator getBeginDownItem() {
 		return begin();
@@ -71,7 +78,7 @@ public:
 	}
 
 	uint32_t getTopItemCount() const {
-		return size() - downItemCount;
+		return static_cast<uint32_t>(size()) - downItemCount;
 	}
 	uint32_t getDownItemCount() const {
 		return downItemCount;
@@ -96,10 +103,11 @@ public:
 	}
 
 private:
-	uint32_t downItemCount = 0;
+	// Adding an item is refused past 0xFFFF items, so the count fits
+	uint16_t downItemCount = 0;
 };
 
-class Tile : public Cylinder, public SharedObject {
+class Tile : public Cylinder, public SharedObject, private MemoryTracked<Tile, MemoryCategory::Tiles> {
 public:
 	static const std::shared_ptr<Tile> &nullptr_tile;
 	Tile(uint16_t x, uint16_t y, uint8_t z) :
@@ -178,10 +186,18 @@ public:
 	void resetFlag(uint32_t flag) {
 		this->flags &= ~flag;
 	}
+	/**
+	 * @brief Whether a creature or item moving in or out of the tile can run a move event.
+	 * The item flag is recomputed here when the move events changed since it was set.
+	 */
+	bool hasMoveEvents();
+	void refreshMoveEventFlag();
+
 	void addZone(std::shared_ptr<Zone> zone);
 	void clearZones();
 
-	auto getZones() const {
+	// Interned, tiles in the same zones return the same set
+	const ZoneSet::Ptr &getZones() const {
 		return zones;
 	}
 
@@ -218,6 +234,8 @@ public:
 	void addThing(int32_t index, std::shared_ptr<Thing> thing) override;
 
 	void updateTileFlags(const std::shared_ptr<Item> &item);
+	// Flags mirrored in the floor for the pathfinding, see Floor::PATH_TILE
+	uint8_t getPathFlags() const;
 	void updateThing(std::shared_ptr<Thing> thing, uint16_t itemId, uint32_t count) override final;
 	void replaceThing(uint32_t index, std::shared_ptr<Thing> thing) override final;
 
@@ -233,6 +251,9 @@ public:
 
 	void postAddNotification(std::shared_ptr<Thing> thing, std::shared_ptr<Cylinder> oldParent, int32_t index, CylinderLink_t link = LINK_OWNER) override final;
 	void postRemoveNotification(std::shared_ptr<Thing> thing, std::shared_ptr<Cylinder> newParent, int32_t index, CylinderLink_t link = LINK_OWNER) override final;
+	// Same, notifying the given players, out of the viewers of an area covering this tile
+	void postAddNotification(const std::shared_ptr<Thing> &thing, const std::shared_ptr<Cylinder> &oldParent, int32_t index, const Spectators &nearby);
+	void postRemoveNotification(const std::shared_ptr<Thing> &thing, const std::shared_ptr<Cylinder> &newParent, int32_t index, const Spectators &nearby);
 
 	void internalAddThing(std::shared_ptr<Thing> thing) override;
 	void virtual internalAddThing(uint32_t index, std::shared_ptr<Thing> thing) override;
@@ -251,6 +272,17 @@ public:
 	std::shared_ptr<Item> getGround() const {
 		return ground;
 	}
+
+	/**
+	 * @brief Remembers the map tile this tile was materialized from, forgotten on the first item change.
+	 */
+	void setBasicTile(const std::shared_ptr<BasicTile> &newBasicTile);
+	const std::shared_ptr<BasicTile> &getBasicTile() const {
+		return basicTile;
+	}
+
+	// True when nothing but the map holds the tile or its items and they still match the map tile
+	bool canDemote();
 	void setGround(const std::shared_ptr<Item> &item) {
 		if (ground) {
 			resetTileFlags(ground);
@@ -266,23 +298,36 @@ private:
 	void onUpdateTileItem(std::shared_ptr<Item> oldItem, const ItemType &oldType, std::shared_ptr<Item> newItem, const ItemType &newType);
 	void onRemoveTileItem(const CreatureVector &spectators, const std::vector<int32_t> &oldStackPosVector, std::shared_ptr<Item> item);
 	void onUpdateTile(const CreatureVector &spectators);
+	void notifyAdded(const std::shared_ptr<Thing> &thing, const std::shared_ptr<Cylinder> &oldParent, int32_t index, CylinderLink_t link, const Spectators &spectators);
+	void notifyRemoved(const std::shared_ptr<Thing> &thing, const std::shared_ptr<Cylinder> &newParent, int32_t index, const Spectators &spectators);
 
 	void setTileFlags(const std::shared_ptr<Item> &item);
 	void resetTileFlags(const std::shared_ptr<Item> &item);
+	static uint32_t getItemTileFlags(const std::shared_ptr<Item> &item);
+	// Flags given by the items of the tile but the excluded one
+	uint32_t getItemsTileFlags(const std::shared_ptr<Item> &exclude) const;
+	// Compares the flags against the items of the tile when built with DEBUG_TILE_FLAGS
+	void checkTileFlags() const;
+	void refreshPathFlags();
 	bool hasHarmfulField() const;
 	ReturnValue checkNpcCanWalkIntoTile() const;
+	size_t getItemStateHash() const;
 
 protected:
 	std::shared_ptr<Item> ground = nullptr;
 	Position tilePos;
 	uint32_t flags = 0;
-	std::unordered_set<std::shared_ptr<Zone>> zones;
+	// MoveEvents version the TILESTATE_MOVEEVENT flag was computed for, fits the padding after the flags
+	uint32_t moveEventsVersion = 0;
+	ZoneSet::Ptr zones = ZoneSet::empty();
+	std::shared_ptr<BasicTile> basicTile;
+	size_t basicStateHash = 0;
 };
 
 // Used for walkable tiles, where there is high likeliness of
 // items being added/removed
 class DynamicTile : public Tile {
-	// By allocating the vectors in-house, we avoid some memory fragmentation
+	// By allocating the vectors in-house, we avoid some memory fragmentation, and the first items need no allocation at all
 	TileItemVector items;
 	CreatureVector creatures;
 
@@ -54,6 +54,10 @@ void Weapons::clear(bool isFromXML /*= false*/) {
 	weapons.clear();
 }
 
+void Weapons::clearScriptFile(const std::string &file) {
+	std::erase_if(weapons, [&file](const auto &entry) { return entry.second->getScriptFile() == file; });
+}
+
 bool Weapons::registerLuaEvent(WeaponShared_ptr event, bool fromXML /*= false*/) {
 	weapons[event->getID()] = event;
 	if (fromXML) {
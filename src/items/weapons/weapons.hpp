@@ -46,6 +46,7 @@ public:
 
 	bool registerLuaEvent(WeaponShared_ptr event, bool fromXML = false);
 	void clear(bool isFromXML = false);
+	void clearScriptFile(const std::string &file);
 
 private:
 	std::map<uint32_t, WeaponShared_ptr> weapons;
@@ -31,58 +31,161 @@ void KVStore::set(const std::string &key, const std::initializer_list<std::pair<
 }
 
 void KVStore::set(const std::string &key, const ValueWrapper &value) {
-	std::scoped_lock lock(mutex_);
-	return setLocked(key, value);
+	auto &shard = getShard(key);
+	std::unique_lock lock(shard.mutex);
+	setLocked(shard, key, value);
 }
 
-void KVStore::setLocked(const std::string &key, const ValueWrapper &value) {
+KVStore::Shard &KVStore::getShard(const std::string &key) {
+	// The high bits pick the shard, the index hashes the key on its own
+	return shards_[std::hash<std::string>()(key) >> (std::numeric_limits<size_t>::digits - SHARD_BITS)];
+}
+
+void KVStore::setLocked(Shard &shard, const std::string &key, const ValueWrapper &value, bool dirty /* = true*/) {
 	logger.trace("KVStore::set({})", key);
-	auto it = store_.find(key);
-	if (it != store_.end()) {
-		it->second.first = value;
-		lruQueue_.splice(lruQueue_.begin(), lruQueue_, it->second.second);
+	if (auto it = shard.index.find(key); it != shard.index.end()) {
+		auto &entry = shard.entries[it->second];
+		entry.value = value;
+		entry.dirty = entry.dirty || dirty;
+		entry.referenced.store(true, std::memory_order_relaxed);
+		return;
+	}
+
+	uint32_t slot;
+	if (shard.entries.size() < SHARD_CAPACITY) {
+		slot = static_cast<uint32_t>(shard.entries.size());
+		shard.entries.emplace_back();
 	} else {
-		if (store_.size() >= MAX_SIZE) {
-			logger.debug("KVStore::set() - MAX_SIZE reached, removing last element");
-			auto last = lruQueue_.end();
-			last--;
-			save(*last, store_[*last].first);
-			store_.erase(*last);
-			lruQueue_.pop_back();
+		logger.debug("KVStore::set() - MAX_SIZE reached, removing least recently used element");
+		slot = evictLocked(shard);
+	}
+
+	auto &entry = shard.entries[slot];
+	entry.key = key;
+	entry.value = value;
+	entry.dirty = dirty;
+	entry.referenced.store(true, std::memory_order_relaxed);
+	shard.index.emplace(entry.key, slot);
+}
+
+uint32_t KVStore::evictLocked(Shard &shard) {
+	while (true) {
+		const auto slot = static_cast<uint32_t>(shard.hand);
+		shard.hand = (shard.hand + 1) % shard.entries.size();
+
+		auto &entry = shard.entries[slot];
+		// Recently used entries get a second chance
+		if (entry.referenced.exchange(false, std::memory_order_relaxed)) {
+			continue;
 		}
 
-		lruQueue_.push_front(key);
-		store_.try_emplace(key, std::make_pair(value, lruQueue_.begin()));
+		// Clean entries are already stored
+		if (entry.dirty) {
+			save(entry.key, entry.value);
+		}
+		shard.index.erase(entry.key);
+		return slot;
 	}
 }
 
 std::optional<ValueWrapper> KVStore::get(const std::string &key, bool forceLoad /*= false */) {
 	logger.trace("KVStore::get({})", key);
-	std::scoped_lock lock(mutex_);
-	if (forceLoad || !store_.contains(key)) {
-		auto value = load(key);
-		if (value) {
-			setLocked(key, *value);
+	auto &shard = getShard(key);
+	if (!forceLoad) {
+		std::shared_lock lock(shard.mutex);
+		if (auto it = shard.index.find(key); it != shard.index.end()) {
+			auto &entry = shard.entries[it->second];
+			if (entry.value.isDeleted()) {
+				// Deleted values are the first to go
+				entry.referenced.store(false, std::memory_order_relaxed);
+				return std::nullopt;
+			}
+			entry.referenced.store(true, std::memory_order_relaxed);
+			return entry.value;
 		}
-		return value;
 	}
 
-	auto &[value, lruIt] = store_[key];
-	if (value.isDeleted()) {
-		lruQueue_.splice(lruQueue_.end(), lruQueue_, lruIt);
-		return std::nullopt;
+	std::unique_lock lock(shard.mutex);
+	if (!forceLoad) {
+		// Another thread may have loaded it while the lock was released
+		if (auto it = shard.index.find(key); it != shard.index.end()) {
+			const auto &entry = shard.entries[it->second];
+			if (entry.value.isDeleted()) {
+				return std::nullopt;
+			}
+			return entry.value;
+		}
+	}
+
+	auto value = load(key);
+	if (value) {
+		setLocked(shard, key, *value, false);
 	}
-	lruQueue_.splice(lruQueue_.begin(), lruQueue_, lruIt);
 	return value;
 }
 
+void KVStore::flush() {
+	KV::flush();
+	for (auto &shard : shards_) {
+		std::unique_lock lock(shard.mutex);
+		// Changed after saveAll took its batch, hand them over like an eviction
+		for (const auto &entry : shard.entries) {
+			if (entry.dirty) {
+				save(entry.key, entry.value);
+			}
+		}
+		shard.index.clear();
+		shard.entries.clear();
+		shard.hand = 0;
+	}
+}
+
+KVStore::Snapshot KVStore::getStore() {
+	Snapshot snapshot;
+	for (auto &shard : shards_) {
+		std::shared_lock lock(shard.mutex);
+		snapshot.reserve(snapshot.size() + shard.index.size());
+		for (const auto &[key, slot] : shard.index) {
+			snapshot.emplace_back(shard.entries[slot].key, shard.entries[slot].value);
+		}
+	}
+	return snapshot;
+}
+
+MemoryAccounting::Usage KVStore::getCacheUsage() {
+	MemoryAccounting::Usage usage { "kv cache" };
+	for (auto &shard : shards_) {
+		std::shared_lock lock(shard.mutex);
+		usage.objects += static_cast<int64_t>(shard.index.size());
+		usage.bytes += static_cast<int64_t>(shard.entries.size() * sizeof(Entry) + shard.index.capacity() * (sizeof(decltype(shard.index)::value_type) + 1));
+	}
+	return usage;
+}
+
+void KVStore::takeDirty(const std::function<void(Snapshot &&)> &consumer) {
+	for (auto &shard : shards_) {
+		std::unique_lock lock(shard.mutex);
+		Snapshot snapshot;
+		for (auto &entry : shard.entries) {
+			if (entry.dirty) {
+				entry.dirty = false;
+				snapshot.emplace_back(entry.key, entry.value);
+			}
+		}
+		if (!snapshot.empty()) {
+			consumer(std::move(snapshot));
+		}
+	}
+}
+
 std::unordered_set<std::string> KVStore::keys(const std::string &prefix /*= ""*/) {
-	std::scoped_lock lock(mutex_);
 	std::unordered_set<std::string> keys;
-	for (const auto &[key, value] : store_) {
-		if (key.find(prefix) == 0) {
-			std::string suffix = key.substr(prefix.size());
-			keys.insert(suffix);
+	for (auto &shard : shards_) {
+		std::shared_lock lock(shard.mutex);
+		for (const auto &[key, slot] : shard.index) {
+			if (key.starts_with(prefix)) {
+				keys.emplace(key.substr(prefix.size()));
+			}
 		}
 	}
 	for (const auto &key : loadPrefix(prefix)) {
@@ -17,7 +17,9 @@
 	#include <optional>
 	#include <unordered_set>
 	#include <iomanip>
-	#include <list>
+	#include <deque>
+	#include <shared_mutex>
+	#include <atomic>
 #endif
 
 #include "lib/logging/logger.hpp"
@@ -85,24 +87,28 @@ public:
 
 	std::optional<ValueWrapper> get(const std::string &key, bool forceLoad = false) override;
 
-	void flush() override {
-		std::scoped_lock lock(mutex_);
-		KV::flush();
-		store_.clear();
-	}
+	void flush() override;
 
 	std::shared_ptr<KV> scoped(const std::string &scope) override final;
 	std::unordered_set<std::string> keys(const std::string &prefix = "");
 
+	/**
+	 * @brief Cached entries and the bytes of the entries and their index, without the keys and values they own.
+	 */
+	MemoryAccounting::Usage getCacheUsage();
+
 protected:
-	phmap::parallel_flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> getStore() {
-		std::scoped_lock lock(mutex_);
-		phmap::parallel_flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> copy;
-		for (const auto &[key, value] : store_) {
-			copy.try_emplace(key, value);
-		}
-		return copy;
-	}
+	using Snapshot = std::vector<std::pair<std::string, ValueWrapper>>;
+
+	/**
+	 * @brief Copies every cached entry, one shard at a time.
+	 */
+	Snapshot getStore();
+	/**
+	 * @brief Hands the entries changed since the last call to the consumer and marks them clean.
+	 * The consumer is called once per shard, while the shard is still locked.
+	 */
+	void takeDirty(const std::function<void(Snapshot &&)> &consumer);
 
 protected:
 	Logger &logger;
@@ -112,11 +118,35 @@ protected:
 	virtual std::vector<std::string> loadPrefix(const std::string &prefix = "") = 0;
 
 private:
-	void setLocked(const std::string &key, const ValueWrapper &value);
-
-	phmap::parallel_flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> store_;
-	std::list<std::string> lruQueue_;
-	std::mutex mutex_;
+	static constexpr size_t SHARD_BITS = 5;
+	static constexpr size_t SHARD_COUNT = 1 << SHARD_BITS;
+	static constexpr size_t SHARD_CAPACITY = MAX_SIZE / SHARD_COUNT;
+
+	/**
+	 * Entries live inline in a deque, so their address (and the key viewed
+	 * by the index) is stable. A CLOCK hand approximates the LRU order: reads
+	 * only set the referenced bit, so they share the shard lock.
+	 */
+	struct Entry {
+		std::string key;
+		ValueWrapper value;
+		std::atomic<bool> referenced { true };
+		// Changed since it was loaded or last taken by takeDirty, only touched under the exclusive lock
+		bool dirty = false;
+	};
+
+	struct Shard {
+		ProfiledMutex<std::shared_mutex> mutex { "kv_shard" };
+		phmap::flat_hash_map<std::string_view, uint32_t> index;
+		std::deque<Entry> entries;
+		size_t hand = 0;
+	};
+
+	Shard &getShard(const std::string &key);
+	void setLocked(Shard &shard, const std::string &key, const ValueWrapper &value, bool dirty = true);
+	uint32_t evictLocked(Shard &shard);
+
+	std::array<Shard, SHARD_COUNT> shards_;
 };
 
 class ScopedKV final : public KV {
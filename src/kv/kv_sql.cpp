@@ -10,14 +10,34 @@
 #include "pch.hpp"
 
 #include "kv/kv_sql.hpp"
+#include "kv/value_wrapper_flat.hpp"
 #include "kv/value_wrapper_proto.hpp"
+#include "config/configmanager.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "utils/tools.hpp"
 
 #include <kv.pb.h>
 
+std::optional<ValueWrapper> KVSQL::findPending(const std::string &key) {
+	std::scoped_lock lock(pendingMutex_);
+	if (auto it = pending_.find(key); it != pending_.end()) {
+		return it->second;
+	}
+	if (auto it = inflight_.find(key); it != inflight_.end()) {
+		return it->second;
+	}
+	return std::nullopt;
+}
+
 std::optional<ValueWrapper> KVSQL::load(const std::string &key) {
-	auto query = fmt::format("SELECT `key_name`, `timestamp`, `value` FROM `kv_store` WHERE `key_name` = {}", db.escapeString(key));
-	auto result = db.storeQuery(query);
+	if (auto pending = findPending(key)) {
+		if (pending->isDeleted()) {
+			return std::nullopt;
+		}
+		return pending;
+	}
+
+	auto result = db.storeStatement("SELECT `key_name`, `timestamp`, `value` FROM `kv_store` WHERE `key_name` = ?", { key });
 	if (result == nullptr) {
 		return std::nullopt;
 	}
@@ -28,12 +48,15 @@ std::optional<ValueWrapper> KVSQL::load(const std::string &key) {
 		return std::nullopt;
 	}
 
-	ValueWrapper valueWrapper;
 	auto timestamp = result->getNumber<uint64_t>("timestamp");
-	Canary::protobuf::kv::ValueWrapper protoValue;
-	if (protoValue.ParseFromArray(data, static_cast<int>(size))) {
-		valueWrapper = ProtoSerializable::fromProto(protoValue, timestamp);
-		return valueWrapper;
+	const std::string_view encoded(data, size);
+	if (FlatValue::isFlat(encoded)) {
+		if (auto value = FlatValue::decode(encoded, timestamp)) {
+			return value;
+		}
+	} else if (Canary::protobuf::kv::ValueWrapper protoValue; protoValue.ParseFromArray(data, static_cast<int>(size))) {
+		// Written before the flat encoding, rewritten in it by the next save
+		return ProtoSerializable::fromProto(protoValue, timestamp);
 	}
 	logger.error("Failed to deserialize value for key {}", key);
 	return std::nullopt;
@@ -41,9 +64,18 @@ std::optional<ValueWrapper> KVSQL::load(const std::string &key) {
 
 std::vector<std::string> KVSQL::loadPrefix(const std::string &prefix /* = ""*/) {
 	std::vector<std::string> keys;
-	std::string keySearch = db.escapeString(prefix + "%");
-	auto query = fmt::format("SELECT `key_name` FROM `kv_store` WHERE `key_name` LIKE {}", keySearch);
-	auto result = db.storeQuery(query);
+	{
+		std::scoped_lock lock(pendingMutex_);
+		for (const auto &batch : { std::cref(pending_), std::cref(inflight_) }) {
+			for (const auto &[key, value] : batch.get()) {
+				if (!value.isDeleted() && key.starts_with(prefix)) {
+					keys.emplace_back(key.substr(prefix.size()));
+				}
+			}
+		}
+	}
+
+	auto result = db.storeStatement("SELECT `key_name` FROM `kv_store` WHERE `key_name` LIKE ?", { prefix + "%" });
 	if (result == nullptr) {
 		return keys;
 	}
@@ -58,42 +90,89 @@ std::vector<std::string> KVSQL::loadPrefix(const std::string &prefix /* = ""*/)
 }
 
 bool KVSQL::save(const std::string &key, const ValueWrapper &value) {
-	auto update = dbUpdate();
-	prepareSave(key, value, update);
-	return update.execute();
+	if (g_configManager().getNumber(KV_WRITE_BEHIND_INTERVAL, __FUNCTION__) > 0) {
+		// Written by the next saveAll, loads read it from the buffer until then
+		std::scoped_lock lock(pendingMutex_);
+		pending_.insert_or_assign(key, value);
+		return true;
+	}
+
+	if (value.isDeleted()) {
+		return db.executeStatement("DELETE FROM `kv_store` WHERE `key_name` = ?", { key });
+	}
+
+	const auto data = FlatValue::encode(value);
+	return db.executeStatement(
+		"INSERT INTO `kv_store` (`key_name`, `timestamp`, `value`) VALUES (?, ?, ?) ON DUPLICATE KEY UPDATE `timestamp` = VALUES(`timestamp`), `value` = VALUES(`value`)",
+		{ key, value.getTimestamp(), DBBlob { data.data(), data.size() } }
+	);
 }
 
 bool KVSQL::prepareSave(const std::string &key, const ValueWrapper &value, DBInsert &update) {
-	auto protoValue = ProtoSerializable::toProto(value);
-	std::string data;
-	if (!protoValue.SerializeToString(&data)) {
-		return false;
-	}
 	if (value.isDeleted()) {
 		auto query = fmt::format("DELETE FROM `kv_store` WHERE `key_name` = {}", db.escapeString(key));
 		return db.executeQuery(query);
 	}
 
-	update.addRow(fmt::format("{}, {}, {}", db.escapeString(key), value.getTimestamp(), db.escapeString(data)));
+	update.addRow(fmt::format("{}, {}, {}", db.escapeString(key), value.getTimestamp(), db.escapeString(FlatValue::encode(value))));
 	return true;
 }
 
-bool KVSQL::saveAll() {
-	auto store = getStore();
-	bool success = DBTransaction::executeWithinTransaction([this, &store]() {
+bool KVSQL::writeBatch(const phmap::flat_hash_map<std::string, ValueWrapper> &batch) {
+	return DBTransaction::executeWithinTransaction([this, &batch]() {
 		auto update = dbUpdate();
-		if (!std::ranges::all_of(store, [this, &update](const auto &kv) {
-				const auto &[key, value] = kv;
-				return prepareSave(key, value.first, update);
-			})) {
-			return false;
+		std::string deletedKeys;
+		for (const auto &[key, value] : batch) {
+			if (value.isDeleted()) {
+				deletedKeys.append(deletedKeys.empty() ? "" : ", ").append(db.escapeString(key));
+			} else if (!prepareSave(key, value, update)) {
+				throw DatabaseException("Failed to serialize value for key " + key);
+			}
+		}
+
+		if (!deletedKeys.empty() && !db.executeQuery(fmt::format("DELETE FROM `kv_store` WHERE `key_name` IN ({})", deletedKeys))) {
+			throw DatabaseException("Failed to delete removed keys");
+		}
+		if (!update.execute()) {
+			throw DatabaseException("Failed to upsert changed keys");
 		}
-		return update.execute();
+		return true;
 	});
+}
 
-	if (!success) {
-		g_logger().error("[{}] Error occurred saving player", __FUNCTION__);
+bool KVSQL::saveAll() {
+	metrics::method_latency measure(__METHOD_NAME__);
+	// A single writer, so a newer batch can never be committed before an older one
+	std::scoped_lock flushLock(flushMutex_);
+	{
+		std::scoped_lock lock(pendingMutex_);
+		inflight_.swap(pending_);
 	}
 
+	// Runs under each shard lock, a value marked clean is already visible to load through the in-flight batch
+	takeDirty([this](Snapshot &&dirty) {
+		std::scoped_lock lock(pendingMutex_);
+		for (auto &[key, value] : dirty) {
+			inflight_.insert_or_assign(std::move(key), std::move(value));
+		}
+	});
+
+	// Only this thread changes the in-flight batch, other threads just read it
+	if (inflight_.empty()) {
+		return true;
+	}
+
+	g_metrics().addCounter("kv_flush_batch_size", inflight_.size());
+	bool success = writeBatch(inflight_);
+
+	std::scoped_lock lock(pendingMutex_);
+	if (!success) {
+		g_logger().error("[{}] Error occurred saving {} keys, retrying on the next flush", __FUNCTION__, inflight_.size());
+		// Values evicted meanwhile are newer, keep them
+		for (auto &[key, value] : inflight_) {
+			pending_.try_emplace(key, std::move(value));
+		}
+	}
+	inflight_.clear();
 	return success;
 }
@@ -29,6 +29,8 @@ private:
 	std::optional<ValueWrapper> load(const std::string &key) override;
 	bool save(const std::string &key, const ValueWrapper &value) override;
 	bool prepareSave(const std::string &key, const ValueWrapper &value, DBInsert &update);
+	bool writeBatch(const phmap::flat_hash_map<std::string, ValueWrapper> &batch);
+	std::optional<ValueWrapper> findPending(const std::string &key);
 
 	DBInsert dbUpdate() {
 		auto insert = DBInsert("INSERT INTO `kv_store` (`key_name`, `timestamp`, `value`) VALUES");
@@ -37,4 +39,10 @@ private:
 	}
 
 	Database &db;
+
+	// Evicted values waiting for the next flush, and the batch being written; both are newer than the database
+	std::mutex pendingMutex_;
+	phmap::flat_hash_map<std::string, ValueWrapper> pending_;
+	phmap::flat_hash_map<std::string, ValueWrapper> inflight_;
+	std::mutex flushMutex_;
 };
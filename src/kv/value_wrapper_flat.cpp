@@ -0,0 +1,334 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "kv/value_wrapper_flat.hpp"
+
+namespace {
+	constexpr size_t CONTAINER_SIZE_BYTES = 4;
+	// Deeper values are refused instead of recursing on a corrupted row
+	constexpr size_t MAX_DEPTH = 64;
+
+	void writeVarint(std::string &out, uint64_t value) {
+		while (value >= 0x80) {
+			out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<char>(value));
+	}
+
+	void writeFixed(std::string &out, uint64_t value, size_t bytes) {
+		for (size_t i = 0; i < bytes; ++i) {
+			out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+		}
+	}
+
+	void writeString(std::string &out, std::string_view value) {
+		writeVarint(out, value.size());
+		out.append(value);
+	}
+
+	void writeValue(std::string &out, const ValueVariant &variant) {
+		std::visit(
+			[&out](const auto &value) {
+				using T = std::decay_t<decltype(value)>;
+				if constexpr (std::is_same_v<T, StringType>) {
+					out.push_back(static_cast<char>(FlatValueView::Type::String));
+					writeString(out, value);
+				} else if constexpr (std::is_same_v<T, BooleanType>) {
+					out.push_back(static_cast<char>(FlatValueView::Type::Boolean));
+					out.push_back(value ? 1 : 0);
+				} else if constexpr (std::is_same_v<T, IntType>) {
+					out.push_back(static_cast<char>(FlatValueView::Type::Int));
+					const auto wide = static_cast<int64_t>(value);
+					writeVarint(out, (static_cast<uint64_t>(wide) << 1) ^ static_cast<uint64_t>(wide >> 63));
+				} else if constexpr (std::is_same_v<T, DoubleType>) {
+					out.push_back(static_cast<char>(FlatValueView::Type::Double));
+					writeFixed(out, std::bit_cast<uint64_t>(value), sizeof(uint64_t));
+				} else {
+					out.push_back(static_cast<char>(std::is_same_v<T, ArrayType> ? FlatValueView::Type::Array : FlatValueView::Type::Map));
+					// The size is patched once the elements are written
+					const size_t sizeOffset = out.size();
+					out.append(CONTAINER_SIZE_BYTES, '\0');
+					writeVarint(out, value.size());
+					if constexpr (std::is_same_v<T, ArrayType>) {
+						for (const auto &element : value) {
+							writeValue(out, element.getVariant());
+						}
+					} else {
+						for (const auto &[key, element] : value) {
+							writeString(out, key);
+							if (element) {
+								writeValue(out, element->getVariant());
+							} else {
+								writeValue(out, ValueVariant {});
+							}
+						}
+					}
+
+					const size_t bodySize = out.size() - sizeOffset - CONTAINER_SIZE_BYTES;
+					for (size_t i = 0; i < CONTAINER_SIZE_BYTES; ++i) {
+						out[sizeOffset + i] = static_cast<char>((bodySize >> (i * 8)) & 0xFF);
+					}
+				}
+			},
+			variant
+		);
+	}
+}
+
+/**
+ * Bounds checked cursor over an encoded buffer, any read past the end
+ * leaves it failed and returns empty values.
+ */
+class FlatValueReader {
+public:
+	explicit FlatValueReader(std::string_view data) :
+		data(data) { }
+
+	bool ok() const {
+		return !failed;
+	}
+
+	uint64_t readVarint() {
+		uint64_t value = 0;
+		for (uint32_t shift = 0; shift < 64; shift += 7) {
+			if (data.empty()) {
+				break;
+			}
+			const auto byte = static_cast<uint8_t>(data.front());
+			data.remove_prefix(1);
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				return value;
+			}
+		}
+		failed = true;
+		return 0;
+	}
+
+	uint64_t readFixed(size_t bytes) {
+		const auto raw = readBytes(bytes);
+		uint64_t value = 0;
+		for (size_t i = 0; i < raw.size(); ++i) {
+			value |= static_cast<uint64_t>(static_cast<uint8_t>(raw[i])) << (i * 8);
+		}
+		return value;
+	}
+
+	std::string_view readBytes(uint64_t count) {
+		if (failed || count > data.size()) {
+			failed = true;
+			return {};
+		}
+		const auto bytes = data.substr(0, count);
+		data.remove_prefix(count);
+		return bytes;
+	}
+
+	std::string_view readString() {
+		return readBytes(readVarint());
+	}
+
+	/**
+	 * @brief Views the next value and moves past it, without decoding its children.
+	 */
+	FlatValueView readValue() {
+		const auto typeByte = readBytes(1);
+		if (failed) {
+			return {};
+		}
+
+		const auto type = static_cast<FlatValueView::Type>(typeByte.front());
+		const auto start = data;
+		switch (type) {
+			case FlatValueView::Type::String:
+				readString();
+				break;
+			case FlatValueView::Type::Boolean:
+				readBytes(1);
+				break;
+			case FlatValueView::Type::Int:
+				readVarint();
+				break;
+			case FlatValueView::Type::Double:
+				readBytes(sizeof(uint64_t));
+				break;
+			case FlatValueView::Type::Array:
+			case FlatValueView::Type::Map: {
+				const auto body = readBytes(readFixed(CONTAINER_SIZE_BYTES));
+				return failed ? FlatValueView() : FlatValueView(type, body);
+			}
+			default:
+				failed = true;
+				break;
+		}
+
+		if (failed) {
+			return {};
+		}
+		return { type, start.substr(0, start.size() - data.size()) };
+	}
+
+private:
+	std::string_view data;
+	bool failed = false;
+};
+
+FlatValueView FlatValueView::fromEncoded(std::string_view data) {
+	if (!FlatValue::isFlat(data)) {
+		return {};
+	}
+	FlatValueReader reader(data.substr(1));
+	return reader.readValue();
+}
+
+std::string_view FlatValueView::getString() const {
+	if (type != Type::String) {
+		return {};
+	}
+	FlatValueReader reader(payload);
+	return reader.readString();
+}
+
+BooleanType FlatValueView::getBoolean() const {
+	return type == Type::Boolean && payload.front() != 0;
+}
+
+IntType FlatValueView::getInt() const {
+	if (type != Type::Int) {
+		return 0;
+	}
+	FlatValueReader reader(payload);
+	const uint64_t zigzag = reader.readVarint();
+	return static_cast<IntType>(static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1));
+}
+
+DoubleType FlatValueView::getDouble() const {
+	if (type != Type::Double) {
+		return 0.0;
+	}
+	FlatValueReader reader(payload);
+	return std::bit_cast<DoubleType>(reader.readFixed(sizeof(uint64_t)));
+}
+
+size_t FlatValueView::size() const {
+	if (type != Type::Array && type != Type::Map) {
+		return 0;
+	}
+	FlatValueReader reader(payload);
+	return reader.readVarint();
+}
+
+FlatValueView FlatValueView::at(size_t index) const {
+	if (type != Type::Array) {
+		return {};
+	}
+
+	FlatValueReader reader(payload);
+	if (index >= reader.readVarint()) {
+		return {};
+	}
+	for (size_t i = 0; i < index && reader.ok(); ++i) {
+		reader.readValue();
+	}
+	return reader.readValue();
+}
+
+FlatValueView FlatValueView::get(std::string_view key) const {
+	if (type != Type::Map) {
+		return {};
+	}
+
+	FlatValueReader reader(payload);
+	const auto count = reader.readVarint();
+	for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+		const auto entryKey = reader.readString();
+		const auto value = reader.readValue();
+		if (reader.ok() && entryKey == key) {
+			return value;
+		}
+	}
+	return {};
+}
+
+std::optional<ValueWrapper> FlatValueView::materialize(uint64_t timestamp /* = 0*/) const {
+	auto variant = materializeVariant(0);
+	if (!variant) {
+		return std::nullopt;
+	}
+	return ValueWrapper(*variant, timestamp);
+}
+
+std::optional<ValueVariant> FlatValueView::materializeVariant(size_t depth) const {
+	switch (type) {
+		case Type::String:
+			return StringType(getString());
+		case Type::Boolean:
+			return getBoolean();
+		case Type::Int:
+			return getInt();
+		case Type::Double:
+			return getDouble();
+		case Type::Array:
+		case Type::Map:
+			break;
+		default:
+			return std::nullopt;
+	}
+
+	if (depth >= MAX_DEPTH) {
+		return std::nullopt;
+	}
+
+	FlatValueReader reader(payload);
+	const auto count = reader.readVarint();
+	if (type == Type::Array) {
+		ArrayType array;
+		// Every element takes at least two bytes, a larger count is a corrupted row
+		array.reserve(std::min<uint64_t>(count, payload.size() / 2));
+		for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+			auto element = reader.readValue().materializeVariant(depth + 1);
+			if (!element) {
+				return std::nullopt;
+			}
+			array.emplace_back(*element);
+		}
+		return reader.ok() ? std::optional<ValueVariant>(std::move(array)) : std::nullopt;
+	}
+
+	MapType map;
+	for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+		const auto key = reader.readString();
+		auto element = reader.readValue().materializeVariant(depth + 1);
+		if (!element) {
+			return std::nullopt;
+		}
+		map.insert_or_assign(std::string(key), std::make_shared<ValueWrapper>(*element));
+	}
+	return reader.ok() ? std::optional<ValueVariant>(std::move(map)) : std::nullopt;
+}
+
+namespace FlatValue {
+	std::string encode(const ValueWrapper &value) {
+		std::string out;
+		out.push_back(MARKER);
+		writeValue(out, value.getVariant());
+		return out;
+	}
+
+	std::optional<ValueWrapper> decode(std::string_view data, uint64_t timestamp) {
+		const auto view = FlatValueView::fromEncoded(data);
+		if (!view.isValid()) {
+			return std::nullopt;
+		}
+		return view.materialize(timestamp);
+	}
+}
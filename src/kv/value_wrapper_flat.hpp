@@ -0,0 +1,91 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "kv/value_wrapper.hpp"
+
+/**
+ * Read-only view of a value in the flat encoding, nothing is copied or
+ * decoded until asked for.
+ *
+ * A value is a type byte and its payload: strings are a varint length and
+ * their bytes, integers a zigzag varint, doubles 8 little endian bytes.
+ * Arrays and maps start with the byte size of their elements as 4 little
+ * endian bytes, then the element count and the elements, map keys being
+ * stored like strings. The size lets a lookup skip a whole element, so
+ * reaching a key of a map never decodes its siblings.
+ */
+class FlatValueView {
+public:
+	enum class Type : uint8_t {
+		String,
+		Boolean,
+		Int,
+		Double,
+		Array,
+		Map,
+		Invalid
+	};
+
+	FlatValueView() = default;
+
+	/**
+	 * @brief Views an encoded row, as written by FlatValue::encode.
+	 */
+	static FlatValueView fromEncoded(std::string_view data);
+
+	Type getType() const {
+		return type;
+	}
+	bool isValid() const {
+		return type != Type::Invalid;
+	}
+
+	// Points into the viewed buffer
+	std::string_view getString() const;
+	BooleanType getBoolean() const;
+	IntType getInt() const;
+	DoubleType getDouble() const;
+
+	/**
+	 * @brief Elements of an array or entries of a map, 0 for the other types.
+	 */
+	size_t size() const;
+	FlatValueView at(size_t index) const;
+	FlatValueView get(std::string_view key) const;
+
+	/**
+	 * @brief Decodes the value and all its children, nullopt when the buffer is malformed.
+	 */
+	std::optional<ValueWrapper> materialize(uint64_t timestamp = 0) const;
+
+private:
+	friend class FlatValueReader;
+
+	FlatValueView(Type type, std::string_view payload) :
+		type(type), payload(payload) { }
+
+	std::optional<ValueVariant> materializeVariant(size_t depth) const;
+
+	Type type = Type::Invalid;
+	std::string_view payload;
+};
+
+namespace FlatValue {
+	// Protobuf never starts a message with a zero byte, the rows written before stay readable
+	constexpr char MARKER = 0x00;
+
+	inline bool isFlat(std::string_view data) {
+		return !data.empty() && data.front() == MARKER;
+	}
+
+	std::string encode(const ValueWrapper &value);
+	std::optional<ValueWrapper> decode(std::string_view data, uint64_t timestamp);
+}
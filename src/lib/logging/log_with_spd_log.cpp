@@ -7,11 +7,24 @@
  * Website: https://docs.opentibiabr.com/
  */
 #include <spdlog/spdlog.h>
+#include <spdlog/async.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
 
 #include "pch.hpp"
 #include "lib/di/container.hpp"
 
 LogWithSpdLog::LogWithSpdLog() {
+	// The messages are written by a background thread, the calling thread only formats and queues them.
+	// When the queue is full the oldest queued message is dropped, so a warning storm never blocks the dispatcher.
+	spdlog::init_thread_pool(ASYNC_QUEUE_SIZE, 1);
+	auto logger = std::make_shared<spdlog::async_logger>(
+		"canary", std::make_shared<spdlog::sinks::stdout_color_sink_mt>(), spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest
+	);
+	// Errors are flushed right away, they are usually followed by a shutdown or a crash
+	logger->flush_on(spdlog::level::err);
+	spdlog::set_default_logger(logger);
+	spdlog::flush_every(std::chrono::seconds(1));
+
 	setLevel("info");
 	spdlog::set_pattern("[%Y-%d-%m %H:%M:%S.%e] [%^%l%$] %v ");
 
@@ -20,6 +33,11 @@ LogWithSpdLog::LogWithSpdLog() {
 #endif
 }
 
+LogWithSpdLog::~LogWithSpdLog() {
+	// Writes the queued messages before the process exits
+	spdlog::shutdown();
+}
+
 Logger &LogWithSpdLog::getInstance() {
 	return inject<Logger>();
 }
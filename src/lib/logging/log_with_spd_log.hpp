@@ -13,7 +13,7 @@
 class LogWithSpdLog final : public Logger {
 public:
 	LogWithSpdLog();
-	~LogWithSpdLog() override = default;
+	~LogWithSpdLog() override;
 
 	static Logger &getInstance();
 
@@ -21,6 +21,9 @@ public:
 	std::string getLevel() const override;
 
 	void log(const std::string &lvl, fmt::basic_string_view<char> msg) const override;
+
+private:
+	static constexpr size_t ASYNC_QUEUE_SIZE = 8192;
 };
 
 constexpr auto g_logger = LogWithSpdLog::getInstance;
@@ -10,6 +10,19 @@
 
 #ifndef USE_PRECOMPILED_HEADERS
 	#include <fmt/format.h>
+	#include <atomic>
+	#include <chrono>
+	#include <limits>
+#endif
+
+// Calls under this level are compiled out: 0 trace, 1 debug, 2 info.
+// Release builds keep trace and debug only with DEBUG_LOG, or when it is defined by the build.
+#ifndef LOG_ACTIVE_LEVEL
+	#if defined(NDEBUG) && !defined(DEBUG_LOG)
+		#define LOG_ACTIVE_LEVEL 2
+	#else
+		#define LOG_ACTIVE_LEVEL 0
+	#endif
 #endif
 
 #define LOG_LEVEL_TRACE \
@@ -37,6 +50,49 @@
 		"critical"         \
 	}
 
+/**
+ * Limits the messages logged by one call site, kept as a static next to it.
+ *
+ * Lets through up to burst messages per interval; the ones dropped are not
+ * formatted and are counted into the next message let through, so a storm
+ * of warnings from a hot path costs a few atomic operations per call.
+ */
+class LogRateLimiter {
+public:
+	explicit LogRateLimiter(uint32_t burst = 5, std::chrono::milliseconds interval = std::chrono::seconds(10)) :
+		burst(burst), interval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval).count()) { }
+
+	LogRateLimiter(const LogRateLimiter &) = delete;
+	LogRateLimiter &operator=(const LogRateLimiter &) = delete;
+
+	/**
+	 * @brief Takes a message from the current interval.
+	 * @param suppressed Receives the messages dropped since the last one let through.
+	 * @return False when the message must be dropped.
+	 */
+	bool acquire(uint32_t &suppressed) {
+		const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+		auto start = windowStart.load(std::memory_order_relaxed);
+		if (now - start >= interval && windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+			taken.store(0, std::memory_order_relaxed);
+		}
+
+		if (taken.fetch_add(1, std::memory_order_relaxed) >= burst) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		suppressed = dropped.exchange(0, std::memory_order_relaxed);
+		return true;
+	}
+
+private:
+	const uint32_t burst;
+	const int64_t interval;
+	std::atomic<int64_t> windowStart = std::numeric_limits<int64_t>::min() / 2;
+	std::atomic<uint32_t> taken = 0;
+	std::atomic<uint32_t> dropped = 0;
+};
+
 class Logger {
 public:
 	Logger() = default;
@@ -52,12 +108,16 @@ public:
 
 	template <typename... Args>
 	void trace(const fmt::format_string<Args...> &fmt, Args &&... args) {
-		trace(fmt::format(fmt, std::forward<Args>(args)...));
+		if constexpr (LOG_ACTIVE_LEVEL <= 0) {
+			trace(fmt::format(fmt, std::forward<Args>(args)...));
+		}
 	}
 
 	template <typename... Args>
 	void debug(const fmt::format_string<Args...> &fmt, Args &&... args) {
-		debug(fmt::format(fmt, std::forward<Args>(args)...));
+		if constexpr (LOG_ACTIVE_LEVEL <= 1) {
+			debug(fmt::format(fmt, std::forward<Args>(args)...));
+		}
 	}
 
 	template <typename... Args>
@@ -82,12 +142,16 @@ public:
 
 	template <typename T>
 	void trace(const T &msg) {
-		log(LOG_LEVEL_TRACE, msg);
+		if constexpr (LOG_ACTIVE_LEVEL <= 0) {
+			log(LOG_LEVEL_TRACE, msg);
+		}
 	}
 
 	template <typename T>
 	void debug(const T &msg) {
-		log(LOG_LEVEL_DEBUG, msg);
+		if constexpr (LOG_ACTIVE_LEVEL <= 1) {
+			log(LOG_LEVEL_DEBUG, msg);
+		}
 	}
 
 	template <typename T>
@@ -109,4 +173,29 @@ public:
 	void critical(const T &msg) {
 		log(LOG_LEVEL_CRITICAL, msg);
 	}
+
+	// Rate limited versions for hot paths, the message is only formatted when it is let through
+	template <typename... Args>
+	void warn(LogRateLimiter &limiter, const fmt::format_string<Args...> &fmt, Args &&... args) {
+		uint32_t suppressed = 0;
+		if (limiter.acquire(suppressed)) {
+			warn(withSuppressed(fmt::format(fmt, std::forward<Args>(args)...), suppressed));
+		}
+	}
+
+	template <typename... Args>
+	void error(LogRateLimiter &limiter, const fmt::format_string<Args...> &fmt, Args &&... args) {
+		uint32_t suppressed = 0;
+		if (limiter.acquire(suppressed)) {
+			error(withSuppressed(fmt::format(fmt, std::forward<Args>(args)...), suppressed));
+		}
+	}
+
+private:
+	static std::string withSuppressed(std::string msg, uint32_t suppressed) {
+		if (suppressed > 0) {
+			msg += fmt::format(" ({} similar messages suppressed)", suppressed);
+		}
+		return msg;
+	}
 };
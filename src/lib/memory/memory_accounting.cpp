@@ -0,0 +1,35 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lib/memory/memory_accounting.hpp"
+
+MemoryAccounting::Usage MemoryAccounting::getUsage(MemoryCategory category) {
+	static constexpr std::array<std::string_view, static_cast<uint8_t>(MemoryCategory::Last)> names = {
+		"map tiles", "items", "containers", "creatures", "network buffers", "dispatcher tasks"
+	};
+
+	const auto index = static_cast<uint8_t>(category);
+	const auto &counter = counters[index];
+	return { names[index], counter.objects.load(std::memory_order_relaxed), counter.bytes.load(std::memory_order_relaxed) };
+}
+
+int64_t MemoryAccounting::getResidentBytes() {
+#ifdef __linux__
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line)) {
+		if (line.starts_with("VmRSS:")) {
+			return std::stoll(line.substr(6)) * 1024;
+		}
+	}
+#endif
+	return 0;
+}
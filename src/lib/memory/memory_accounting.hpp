@@ -0,0 +1,84 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+enum class MemoryCategory : uint8_t {
+	Tiles,
+	Items,
+	Containers,
+	Creatures,
+	NetworkBuffers,
+	DispatcherTasks,
+	Last
+};
+
+/**
+ * Live objects and bytes of the classes tracked through MemoryTracked.
+ *
+ * The bytes are the size of the objects themselves: what they own on the
+ * heap (item vectors, strings, attributes) is not counted, so they are a
+ * floor, but they grow with the subsystem that leaks. The counters are
+ * relaxed atomics, cheap enough for the constructors of the hot classes.
+ */
+class MemoryAccounting {
+public:
+	struct Usage {
+		std::string_view name;
+		int64_t objects = 0;
+		int64_t bytes = 0;
+	};
+
+	static void add(MemoryCategory category, int64_t bytes) noexcept {
+		auto &counter = counters[static_cast<uint8_t>(category)];
+		counter.objects.fetch_add(1, std::memory_order_relaxed);
+		counter.bytes.fetch_add(bytes, std::memory_order_relaxed);
+	}
+
+	static void remove(MemoryCategory category, int64_t bytes) noexcept {
+		auto &counter = counters[static_cast<uint8_t>(category)];
+		counter.objects.fetch_sub(1, std::memory_order_relaxed);
+		counter.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+	}
+
+	static Usage getUsage(MemoryCategory category);
+
+	// Resident memory of the process, 0 where it can't be read
+	static int64_t getResidentBytes();
+
+private:
+	struct alignas(64) Counter {
+		std::atomic<int64_t> objects = 0;
+		std::atomic<int64_t> bytes = 0;
+	};
+
+	static inline std::array<Counter, static_cast<uint8_t>(MemoryCategory::Last)> counters {};
+};
+
+/**
+ * Counts the instances of T in a category, as a base class of T. Containers
+ * are items too, so they are counted in both categories.
+ */
+template <typename T, MemoryCategory Category>
+class MemoryTracked {
+protected:
+	MemoryTracked() noexcept {
+		MemoryAccounting::add(Category, sizeof(T));
+	}
+	MemoryTracked(const MemoryTracked &) noexcept :
+		MemoryTracked() { }
+	MemoryTracked(MemoryTracked &&) noexcept :
+		MemoryTracked() { }
+	MemoryTracked &operator=(const MemoryTracked &) noexcept = default;
+	MemoryTracked &operator=(MemoryTracked &&) noexcept = default;
+
+	~MemoryTracked() {
+		MemoryAccounting::remove(Category, sizeof(T));
+	}
+};
@@ -40,10 +40,16 @@ void Metrics::init(Options opts) {
 
 	metrics_api::Provider::SetMeterProvider(std::move(provider));
 	initHistograms();
+	enabled = true;
+
+	g_dispatcher().cycleEvent(
+		FLUSH_INTERVAL, [] { g_metrics().flush(); }, "Metrics::flush"
+	);
 }
 
 void Metrics::initHistograms() {
-	for (auto name : latencyNames) {
+	for (size_t id = 0; id < latencyNames.size(); ++id) {
+		const std::string name(latencyNames[id]);
 		auto instrumentSelector = metrics_sdk::InstrumentSelectorFactory::Create(metrics_sdk::InstrumentType::kHistogram, name, "us");
 		auto meterSelector = metrics_sdk::MeterSelectorFactory::Create("performance", otelVersion, otelSchema);
 
@@ -78,21 +84,141 @@ void Metrics::initHistograms() {
 		auto* p = static_cast<metrics_sdk::MeterProvider*>(provider.get());
 		p->AddView(std::move(instrumentSelector), std::move(meterSelector), std::move(view));
 
-		latencyHistograms[name] = getMeter()->CreateDoubleHistogram(name, "Latency", "us");
+		latencyHistograms[id] = getMeter()->CreateDoubleHistogram(name, "Latency", "us");
 	}
 }
 
 void Metrics::shutdown() {
+	if (isEnabled()) {
+		flush();
+		enabled = false;
+	}
+
 	std::shared_ptr<metrics_api::MeterProvider> none;
 	metrics_api::Provider::SetMeterProvider(none);
 }
 
-ScopedLatency::ScopedLatency(const std::string_view &name, const std::string &histogramName, const std::string &scopeKey) :
-	ScopedLatency(name, g_metrics().latencyHistograms[histogramName], { { scopeKey, std::string(name) } }, g_metrics().defaultContext) {
-	if (histogram == nullptr) {
+ThreadBuffer &Metrics::getThreadBuffer() {
+	// Shared with the list, the values of a finished thread are still exported
+	thread_local const auto buffer = [this] {
+		auto threadBuffer = std::make_shared<ThreadBuffer>();
+		std::scoped_lock lock(buffersMutex);
+		buffers.emplace_back(threadBuffer);
+		return threadBuffer;
+	}();
+	return *buffer;
+}
+
+void Metrics::addCounter(std::string_view name, double value, Attributes attrs) {
+	if (isEnabled()) {
+		addPending(&ThreadBuffer::counters, name, value, std::move(attrs));
+	}
+}
+
+void Metrics::addUpDownCounter(std::string_view name, int value, Attributes attrs) {
+	if (isEnabled()) {
+		addPending(&ThreadBuffer::upDownCounters, name, value, std::move(attrs));
+	}
+}
+
+void Metrics::addPending(phmap::flat_hash_map<std::string, PendingCounter> ThreadBuffer::*pending, std::string_view name, double value, Attributes &&attrs) {
+	std::string key(name);
+	for (const auto &[attrKey, attrValue] : attrs) {
+		key.push_back('\0');
+		key.append(attrKey);
+		key.push_back('\0');
+		key.append(attrValue);
+	}
+
+	auto &buffer = getThreadBuffer();
+	std::scoped_lock lock(buffer.mutex);
+	auto &counter = (buffer.*pending)[key];
+	if (counter.name.empty()) {
+		counter.name = name;
+		counter.attrs = std::move(attrs);
+	}
+	counter.value += value;
+}
+
+void Metrics::flush() {
+	std::vector<std::shared_ptr<ThreadBuffer>> threadBuffers;
+	{
+		std::scoped_lock lock(buffersMutex);
+		threadBuffers = buffers;
+	}
+
+	std::scoped_lock lock(mutex_);
+	auto meter = getMeter();
+	if (!meter) {
+		return;
+	}
+
+	for (const auto &buffer : threadBuffers) {
+		phmap::flat_hash_map<std::string, PendingCounter> pendingCounters;
+		phmap::flat_hash_map<std::string, PendingCounter> pendingUpDownCounters;
+		std::vector<std::tuple<size_t, const Attributes*, std::vector<double>>> pendingSamples;
+		{
+			// Only the values are taken, the export happens without holding up the thread
+			std::scoped_lock bufferLock(buffer->mutex);
+			pendingCounters.swap(buffer->counters);
+			pendingUpDownCounters.swap(buffer->upDownCounters);
+			for (size_t id = 0; id < buffer->latencies.size(); ++id) {
+				for (auto &[scope, samples] : buffer->latencies[id]) {
+					if (!samples.values.empty()) {
+						pendingSamples.emplace_back(id, &samples.attrs, std::move(samples.values));
+						samples.values.clear();
+					}
+				}
+			}
+		}
+
+		for (const auto &[key, pending] : pendingCounters) {
+			auto &counter = counters[pending.name];
+			if (!counter) {
+				counter = meter->CreateDoubleCounter(pending.name);
+			}
+			counter->Add(pending.value, opentelemetry::common::KeyValueIterableView<Attributes> { pending.attrs });
+		}
+
+		for (const auto &[key, pending] : pendingUpDownCounters) {
+			auto &counter = upDownCounters[pending.name];
+			if (!counter) {
+				counter = meter->CreateInt64UpDownCounter(pending.name);
+			}
+			counter->Add(static_cast<int64_t>(pending.value), opentelemetry::common::KeyValueIterableView<Attributes> { pending.attrs });
+		}
+
+		// The nodes are never erased, the attributes can be read without the lock
+		for (const auto &[id, attrs, values] : pendingSamples) {
+			const auto &histogram = latencyHistograms[id];
+			if (!histogram) {
+				continue;
+			}
+			const auto attrskv = opentelemetry::common::KeyValueIterableView<Attributes> { *attrs };
+			for (const auto value : values) {
+				histogram->Record(value, attrskv, defaultContext);
+			}
+		}
+	}
+}
+
+ScopedLatency::ScopedLatency(std::string_view name, size_t histogramId, std::string_view scopeKey) {
+	if (!g_metrics().isEnabled() || histogramId >= latencyNames.size()) {
 		stopped = true;
 		return;
 	}
+
+	buffer = &g_metrics().getThreadBuffer();
+	{
+		std::scoped_lock lock(buffer->mutex);
+		auto &entries = buffer->latencies[histogramId];
+		auto it = entries.find(name);
+		if (it == entries.end()) {
+			it = entries.try_emplace(std::string(name), LatencySamples { { { std::string(scopeKey), std::string(name) } }, {} }).first;
+		}
+		samples = &it->second;
+	}
+	begin = std::chrono::steady_clock::now();
 }
 
 ScopedLatency::~ScopedLatency() {
@@ -106,8 +232,8 @@ void ScopedLatency::stop() {
 	stopped = true;
 	auto end = std::chrono::steady_clock::now();
 	double elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) / 1000;
-	auto attrskv = opentelemetry::common::KeyValueIterableView<decltype(attrs)> { attrs };
-	histogram->Record(elapsed, attrskv, context);
+	std::scoped_lock lock(buffer->mutex);
+	samples->values.push_back(elapsed);
 }
 
 #endif // FEATURE_METRICS
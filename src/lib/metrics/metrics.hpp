@@ -52,12 +52,55 @@ namespace metrics {
 		metrics_exporter::PrometheusExporterOptions prometheusOptions;
 	};
 
+	constexpr std::array<std::string_view, 6> latencyNames {
+		"method_latency",
+		"lua_latency",
+		"query_latency",
+		"task_latency",
+		"lock_latency",
+		"gc_latency",
+	};
+
+	// Resolved at compile time by the latency classes, so a measurement never looks its histogram up by name
+	constexpr size_t getLatencyId(std::string_view name) {
+		for (size_t id = 0; id < latencyNames.size(); ++id) {
+			if (latencyNames[id] == name) {
+				return id;
+			}
+		}
+		return latencyNames.size();
+	}
+
+	using Attributes = std::map<std::string, std::string>;
+
+	struct LatencySamples {
+		Attributes attrs;
+		std::vector<double> values;
+	};
+
+	struct PendingCounter {
+		std::string name;
+		Attributes attrs;
+		double value = 0;
+	};
+
+	/**
+	 * Values recorded by one thread since the last flush. Only the flush
+	 * reads it from another thread, so its lock is practically never
+	 * contended; it outlives the thread until the values are exported.
+	 */
+	struct ThreadBuffer {
+		std::mutex mutex;
+		// Keyed by the scope name, the nodes stay put so a running measurement keeps its entry
+		std::array<phmap::node_hash_map<std::string, LatencySamples>, latencyNames.size()> latencies;
+		// Keyed by the name followed by the attributes
+		phmap::flat_hash_map<std::string, PendingCounter> counters;
+		phmap::flat_hash_map<std::string, PendingCounter> upDownCounters;
+	};
+
 	class ScopedLatency {
 	public:
-		explicit ScopedLatency(const std::string_view &name, const std::string &histogramName, const std::string &scopeKey);
-		explicit ScopedLatency([[maybe_unused]] const std::string_view &name, Histogram<double> &histogram, std::map<std::string, std::string> attrs = {}, opentelemetry::context::Context context = opentelemetry::context::Context()) :
-			begin(std::chrono::steady_clock::now()), histogram(histogram), attrs(std::move(attrs)), context(std::move(context)) {
-		}
+		explicit ScopedLatency(std::string_view name, size_t histogramId, std::string_view scopeKey);
 
 		void stop();
 
@@ -65,17 +108,16 @@ namespace metrics {
 
 	private:
 		std::chrono::steady_clock::time_point begin;
-		Histogram<double> &histogram;
-		std::map<std::string, std::string> attrs;
-		opentelemetry::context::Context context;
+		ThreadBuffer* buffer = nullptr;
+		LatencySamples* samples = nullptr;
 		bool stopped { false };
 	};
 
-	#define DEFINE_LATENCY_CLASS(class_name, histogram_name, category)       \
-		class class_name##_latency final : public ScopedLatency {            \
-		public:                                                              \
-			class_name##_latency(std::string_view name) :                    \
-				ScopedLatency(name, histogram_name "_latency", category) { } \
+	#define DEFINE_LATENCY_CLASS(class_name, histogram_name, category)                     \
+		class class_name##_latency final : public ScopedLatency {                          \
+		public:                                                                            \
+			class_name##_latency(std::string_view name) :                                  \
+				ScopedLatency(name, getLatencyId(histogram_name "_latency"), category) { } \
 		}
 
 	DEFINE_LATENCY_CLASS(method, "method", "method");
@@ -83,14 +125,7 @@ namespace metrics {
 	DEFINE_LATENCY_CLASS(query, "query", "truncated_query");
 	DEFINE_LATENCY_CLASS(task, "task", "task");
 	DEFINE_LATENCY_CLASS(lock, "lock", "scope");
-
-	const std::vector<std::string> latencyNames {
-		"method_latency",
-		"lua_latency",
-		"query_latency",
-		"task_latency",
-		"lock_latency",
-	};
+	DEFINE_LATENCY_CLASS(gc, "gc", "phase");
 
 	class Metrics final {
 	public:
@@ -103,37 +138,26 @@ namespace metrics {
 
 		static Metrics &getInstance();
 
-		void addCounter(std::string_view name, double value, std::map<std::string, std::string> attrs = {}) {
-			std::scoped_lock lock(mutex_);
-			if (!getMeter()) {
-				return;
-			}
-			if (counters.find(name) == counters.end()) {
-				std::string nameStr(name);
-				counters[name] = getMeter()->CreateDoubleCounter(nameStr);
-			}
-			auto attrskv = opentelemetry::common::KeyValueIterableView<decltype(attrs)> { attrs };
-			counters[name]->Add(value, attrskv);
+		bool isEnabled() const {
+			return enabled.load(std::memory_order_relaxed);
 		}
 
-		void addUpDownCounter(std::string_view name, int value, std::map<std::string, std::string> attrs = {}) {
-			std::scoped_lock lock(mutex_);
-			if (!getMeter()) {
-				return;
-			}
-			if (upDownCounters.find(name) == upDownCounters.end()) {
-				std::string nameStr(name);
-				upDownCounters[name] = getMeter()->CreateInt64UpDownCounter(nameStr);
-			}
-			auto attrskv = opentelemetry::common::KeyValueIterableView<decltype(attrs)> { attrs };
-			upDownCounters[name]->Add(value, attrskv);
-		}
+		// Added to the buffer of the calling thread, the instrument gets the sum on the next flush
+		void addCounter(std::string_view name, double value, Attributes attrs = {});
+		void addUpDownCounter(std::string_view name, int value, Attributes attrs = {});
+
+		/**
+		 * @brief Exports the values buffered by every thread to the instruments.
+		 */
+		void flush();
+
+		ThreadBuffer &getThreadBuffer();
 
 		friend class ScopedLatency;
 
 	protected:
 		opentelemetry::context::Context defaultContext {};
-		phmap::parallel_flat_hash_map<std::string, Histogram<double>> latencyHistograms;
+		std::array<Histogram<double>, latencyNames.size()> latencyHistograms;
 		phmap::flat_hash_map<std::string, UpDownCounter<int64_t>> upDownCounters;
 		phmap::flat_hash_map<std::string, Counter<double>> counters;
 
@@ -146,7 +170,15 @@ namespace metrics {
 		}
 
 	private:
-		std::mutex mutex_;
+		static constexpr uint32_t FLUSH_INTERVAL = 1000;
+
+		void addPending(phmap::flat_hash_map<std::string, PendingCounter> ThreadBuffer::*pending, std::string_view name, double value, Attributes &&attrs);
+
+		std::atomic<bool> enabled = false;
+		// Guards the instruments, only taken by the flush
+		ProfiledMutex<std::mutex> mutex_ { "metrics" };
+		std::mutex buffersMutex;
+		std::vector<std::shared_ptr<ThreadBuffer>> buffers;
 
 		std::string meterName { "stats" };
 		std::string otelVersion { "1.2.0" };
@@ -189,6 +221,7 @@ namespace metrics {
 	DEFINE_LATENCY_CLASS(query, "query", "truncated_query");
 	DEFINE_LATENCY_CLASS(task, "task", "task");
 	DEFINE_LATENCY_CLASS(lock, "lock", "scope");
+	DEFINE_LATENCY_CLASS(gc, "gc", "phase");
 
 	const std::vector<std::string> latencyNames {
 		"method_latency",
@@ -196,6 +229,7 @@ namespace metrics {
 		"query_latency",
 		"task_latency",
 		"lock_latency",
+		"gc_latency",
 	};
 
 	class Metrics final {
@@ -0,0 +1,29 @@
+#ifdef FEATURE_METRICS
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+	#include "pch.hpp"
+
+	#include "lib/metrics/profiled_mutex.hpp"
+	#include "lib/metrics/metrics.hpp"
+	#include "game/scheduling/dispatcher.hpp"
+
+void metrics::measureLockWait(std::string_view name, void (*lock)(void*), void* mutex) {
+	lock_latency measure(name);
+	lock(mutex);
+}
+
+void metrics::recordContendedHold(std::string_view name, int64_t holdNs) {
+	const auto holder = Dispatcher::threadContext().getName();
+	Attributes attrs = { { "lock", std::string(name) }, { "holder", holder.empty() ? "none" : std::string(holder) } };
+	g_metrics().addCounter("lock_contended_hold_us", static_cast<double>(holdNs) / 1000.0, attrs);
+	g_metrics().addCounter("lock_contentions", 1, std::move(attrs));
+}
+
+#endif // FEATURE_METRICS
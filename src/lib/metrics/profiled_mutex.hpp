@@ -0,0 +1,114 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#ifdef FEATURE_METRICS
+
+namespace metrics {
+	// Out of line, so the lock headers don't pull the metrics and the dispatcher in
+	void measureLockWait(std::string_view name, void (*lock)(void*), void* mutex);
+	void recordContendedHold(std::string_view name, int64_t holdNs);
+}
+
+/**
+ * A mutex that profiles its contention.
+ *
+ * An uncontended lock costs a try_lock and, for the exclusive lock, a clock
+ * read. When the lock is taken, the wait is recorded in the lock_latency
+ * histogram under the name of the mutex. The exclusive holder the waiter
+ * was stuck behind then records, as it unlocks, how long it held the lock
+ * and the dispatcher task it was running, in the lock_contentions and
+ * lock_contended_hold_us counters. Shared holders are not timed.
+ */
+template <typename Mutex>
+class ProfiledMutex {
+public:
+	explicit ProfiledMutex(std::string_view name) :
+		name(name) { }
+
+	ProfiledMutex(const ProfiledMutex &) = delete;
+	ProfiledMutex &operator=(const ProfiledMutex &) = delete;
+
+	void lock() {
+		if (!mutex.try_lock()) {
+			contended.store(true, std::memory_order_relaxed);
+			metrics::measureLockWait(
+				name, [](void* target) { static_cast<Mutex*>(target)->lock(); }, &mutex
+			);
+		}
+		// Recursive mutexes are timed from their outermost lock
+		if (holdDepth++ == 0) {
+			acquiredAt = std::chrono::steady_clock::now();
+		}
+	}
+
+	bool try_lock() {
+		if (!mutex.try_lock()) {
+			return false;
+		}
+		if (holdDepth++ == 0) {
+			acquiredAt = std::chrono::steady_clock::now();
+		}
+		return true;
+	}
+
+	void unlock() {
+		int64_t holdNs = -1;
+		if (--holdDepth == 0 && contended.exchange(false, std::memory_order_relaxed)) {
+			holdNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - acquiredAt).count();
+		}
+		mutex.unlock();
+
+		if (holdNs >= 0) {
+			metrics::recordContendedHold(name, holdNs);
+		}
+	}
+
+	void lock_shared()
+		requires requires(Mutex &m) { m.lock_shared(); }
+	{
+		if (!mutex.try_lock_shared()) {
+			contended.store(true, std::memory_order_relaxed);
+			metrics::measureLockWait(
+				name, [](void* target) { static_cast<Mutex*>(target)->lock_shared(); }, &mutex
+			);
+		}
+	}
+
+	bool try_lock_shared()
+		requires requires(Mutex &m) { m.try_lock_shared(); }
+	{
+		return mutex.try_lock_shared();
+	}
+
+	void unlock_shared()
+		requires requires(Mutex &m) { m.unlock_shared(); }
+	{
+		mutex.unlock_shared();
+	}
+
+private:
+	Mutex mutex;
+	std::string_view name;
+	std::atomic<bool> contended = false;
+	// Only touched by the exclusive holder
+	uint32_t holdDepth = 0;
+	std::chrono::steady_clock::time_point acquiredAt;
+};
+
+#else
+
+template <typename Mutex>
+class ProfiledMutex : public Mutex {
+public:
+	explicit ProfiledMutex(std::string_view) { }
+};
+
+#endif // FEATURE_METRICS
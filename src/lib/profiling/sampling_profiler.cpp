@@ -0,0 +1,232 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lib/profiling/sampling_profiler.hpp"
+#include "lib/di/container.hpp"
+#include "game/scheduling/dispatcher.hpp"
+
+#ifdef __linux__
+	#include <csignal>
+	#include <cxxabi.h>
+	#include <dlfcn.h>
+	#include <execinfo.h>
+	#include <sys/time.h>
+#endif
+
+namespace {
+	// Read by the signal handler, which can't reach the container
+	std::atomic<SamplingProfiler*> activeProfiler = nullptr;
+	thread_local const std::string* sampledScript = nullptr;
+
+	template <size_t Size>
+	void copyName(std::array<char, Size> &target, const char* data, size_t size) {
+		size = std::min(size, Size - 1);
+		std::memcpy(target.data(), data, size);
+		target[size] = '\0';
+	}
+
+#ifdef __linux__
+	std::string symbolize(void* address) {
+		Dl_info info {};
+		if (dladdr(address, &info) == 0) {
+			return fmt::format("{}", address);
+		}
+
+		if (info.dli_sname) {
+			int status = 0;
+			std::unique_ptr<char, decltype(&std::free)> demangled(abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status), &std::free);
+			std::string name = status == 0 && demangled ? demangled.get() : info.dli_sname;
+			// Frames are split on ';' by the flame graph tools
+			std::replace(name.begin(), name.end(), ';', ',');
+			return name;
+		}
+
+		// Not exported, kept as module+offset for addr2line
+		const auto* module = info.dli_fname ? std::strrchr(info.dli_fname, '/') : nullptr;
+		return fmt::format("{}+{:#x}", module ? module + 1 : (info.dli_fname ? info.dli_fname : "?"), reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(info.dli_fbase));
+	}
+#endif
+}
+
+SamplingProfiler &SamplingProfiler::getInstance() {
+	return inject<SamplingProfiler>();
+}
+
+bool SamplingProfiler::start(uint32_t frequency) {
+#ifdef __linux__
+	if (isRunning()) {
+		return true;
+	}
+
+	if (!samples) {
+		samples = std::make_unique<Sample[]>(MAX_SAMPLES);
+	}
+
+	// The first call loads the unwinder, which must not happen inside the handler
+	std::array<void*, 1> warmup {};
+	backtrace(warmup.data(), static_cast<int>(warmup.size()));
+
+	activeProfiler = this;
+	struct sigaction action {};
+	action.sa_handler = &SamplingProfiler::onSignal;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	if (sigaction(SIGPROF, &action, nullptr) != 0) {
+		activeProfiler = nullptr;
+		return false;
+	}
+
+	const auto interval = 1000000 / std::clamp<uint32_t>(frequency, 1, 1000);
+	itimerval timer {};
+	timer.it_interval.tv_sec = static_cast<time_t>(interval / 1000000);
+	timer.it_interval.tv_usec = static_cast<suseconds_t>(interval % 1000000);
+	timer.it_value = timer.it_interval;
+	if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+		activeProfiler = nullptr;
+		return false;
+	}
+
+	running = true;
+	return true;
+#else
+	(void)frequency;
+	return false;
+#endif
+}
+
+void SamplingProfiler::stop() {
+#ifdef __linux__
+	if (!isRunning()) {
+		return;
+	}
+
+	itimerval timer {};
+	setitimer(ITIMER_PROF, &timer, nullptr);
+	// A signal already raised is still handled, it finds no profiler and returns
+	activeProfiler = nullptr;
+	running = false;
+#endif
+}
+
+void SamplingProfiler::reset() {
+	if (isRunning() || !samples) {
+		return;
+	}
+
+	for (size_t i = 0; i < MAX_SAMPLES; ++i) {
+		samples[i].ready = false;
+	}
+	nextSample = 0;
+	dropped = 0;
+}
+
+size_t SamplingProfiler::getSampleCount() const {
+	return std::min(nextSample.load(std::memory_order_relaxed), MAX_SAMPLES);
+}
+
+void SamplingProfiler::onSignal(int) {
+#ifdef __linux__
+	const int savedErrno = errno;
+	auto* profiler = activeProfiler.load(std::memory_order_acquire);
+	if (!profiler) {
+		return;
+	}
+
+	const auto index = profiler->nextSample.fetch_add(1, std::memory_order_relaxed);
+	if (index >= MAX_SAMPLES) {
+		profiler->dropped.fetch_add(1, std::memory_order_relaxed);
+		errno = savedErrno;
+		return;
+	}
+
+	auto &sample = profiler->samples[index];
+	sample.depth = static_cast<uint8_t>(backtrace(sample.frames.data(), static_cast<int>(sample.frames.size())));
+
+	const auto &taskName = Dispatcher::threadContext().getName();
+	copyName(sample.task, taskName.data(), taskName.size());
+	if (const auto* script = sampledScript) {
+		copyName(sample.script, script->data(), script->size());
+	} else {
+		sample.script[0] = '\0';
+	}
+
+	sample.ready.store(true, std::memory_order_release);
+	errno = savedErrno;
+#endif
+}
+
+bool SamplingProfiler::dump(const std::string &path) const {
+#ifdef __linux__
+	if (!samples) {
+		return false;
+	}
+
+	// The frames of the handler itself and the signal trampoline are skipped
+	constexpr size_t SKIPPED_FRAMES = 2;
+
+	phmap::flat_hash_map<void*, std::string> symbols;
+	std::map<std::string, uint64_t> stacks;
+	const auto count = getSampleCount();
+	for (size_t i = 0; i < count; ++i) {
+		const auto &sample = samples[i];
+		if (!sample.ready.load(std::memory_order_acquire)) {
+			continue;
+		}
+
+		std::string stack = sample.task[0] ? sample.task.data() : "idle";
+		std::replace(stack.begin(), stack.end(), ';', ',');
+		if (sample.script[0]) {
+			std::string script = sample.script.data();
+			std::replace(script.begin(), script.end(), ';', ',');
+			stack += ";lua ";
+			stack += script;
+		}
+
+		for (size_t frame = sample.depth; frame > SKIPPED_FRAMES; --frame) {
+			void* address = sample.frames[frame - 1];
+			auto it = symbols.find(address);
+			if (it == symbols.end()) {
+				it = symbols.emplace(address, symbolize(address)).first;
+			}
+			stack += ';';
+			stack += it->second;
+		}
+		++stacks[stack];
+	}
+
+	std::ofstream file(path, std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	for (const auto &[stack, samplesCount] : stacks) {
+		file << stack << ' ' << samplesCount << '\n';
+	}
+	return static_cast<bool>(file);
+#else
+	(void)path;
+	return false;
+#endif
+}
+
+SamplingProfiler::LuaScope::LuaScope(const std::string* script) {
+	if (!script) {
+		return;
+	}
+	previous = sampledScript;
+	sampledScript = script;
+	active = true;
+}
+
+SamplingProfiler::LuaScope::~LuaScope() {
+	if (active) {
+		sampledScript = previous;
+	}
+}
@@ -0,0 +1,93 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Sampling CPU profiler of the whole process.
+ *
+ * While running, a SIGPROF timer interrupts whichever thread is using the
+ * CPU, at the requested frequency, and the signal handler copies its call
+ * stack, the name of its dispatcher task and the Lua script it is running
+ * into a preallocated buffer. Nothing is allocated or locked in the
+ * handler; the stacks are only symbolized when they are dumped, in the
+ * collapsed stack format read by the flame graph tools. Linux only.
+ */
+class SamplingProfiler {
+public:
+	SamplingProfiler() = default;
+
+	// Ensures that we don't accidentally copy it
+	SamplingProfiler(const SamplingProfiler &) = delete;
+	SamplingProfiler &operator=(const SamplingProfiler &) = delete;
+
+	static SamplingProfiler &getInstance();
+
+	/**
+	 * @brief Starts sampling, keeping the samples taken before.
+	 * @param frequency Samples per second of CPU time.
+	 * @return False when the platform has no sampling timer.
+	 */
+	bool start(uint32_t frequency);
+	void stop();
+	// Drops the samples, only while stopped
+	void reset();
+
+	bool isRunning() const {
+		return running.load(std::memory_order_relaxed);
+	}
+
+	size_t getSampleCount() const;
+	size_t getDroppedCount() const {
+		return dropped.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Writes the samples as "task;script;frame;...;frame count" lines, outermost frame first.
+	 */
+	bool dump(const std::string &path) const;
+
+	/**
+	 * @brief Names the Lua script run by this thread for the samples taken during a call.
+	 */
+	class LuaScope {
+	public:
+		explicit LuaScope(const std::string* script);
+		~LuaScope();
+
+		LuaScope(const LuaScope &) = delete;
+		LuaScope &operator=(const LuaScope &) = delete;
+
+	private:
+		const std::string* previous = nullptr;
+		bool active = false;
+	};
+
+	static constexpr size_t MAX_FRAMES = 48;
+	static constexpr size_t MAX_SAMPLES = 16384;
+	static constexpr size_t NAME_SIZE = 64;
+
+	struct Sample {
+		std::atomic<bool> ready = false;
+		uint8_t depth = 0;
+		std::array<void*, MAX_FRAMES> frames {};
+		std::array<char, NAME_SIZE> task {};
+		std::array<char, NAME_SIZE> script {};
+	};
+
+private:
+	static void onSignal(int signal);
+
+	std::atomic<bool> running = false;
+	std::atomic<size_t> nextSample = 0;
+	std::atomic<size_t> dropped = 0;
+	std::unique_ptr<Sample[]> samples;
+};
+
+constexpr auto g_samplingProfiler = SamplingProfiler::getInstance;
@@ -12,8 +12,14 @@
 #include "lib/thread/thread_pool.hpp"
 
 #include "game/game.hpp"
+#include "config/configmanager.hpp"
 #include "utils/tools.hpp"
 
+#ifdef __linux__
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
 /**
  * Regardless of how many cores your computer have, we want at least
  * 4 threads because, even though they won't improve processing they
@@ -39,3 +45,88 @@ void ThreadPool::shutdown() {
 	stopped = true;
 	wait();
 }
+
+namespace {
+	std::vector<uint32_t> parseCpuList(std::string_view list) {
+		std::vector<uint32_t> cpus;
+		for (const auto &range : explodeString(std::string(list), ",")) {
+			const auto dash = range.find('-');
+			const auto first = static_cast<uint32_t>(std::atoi(range.substr(0, dash).c_str()));
+			const auto last = dash == std::string::npos ? first : static_cast<uint32_t>(std::atoi(range.substr(dash + 1).c_str()));
+			for (auto cpu = first; cpu <= last && cpu < 1024; ++cpu) {
+				cpus.emplace_back(cpu);
+			}
+		}
+		return cpus;
+	}
+}
+
+bool ThreadPool::pinCurrentThread(std::string_view list) {
+	const auto cpus = parseCpuList(list);
+	if (cpus.empty()) {
+		return false;
+	}
+
+#if defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (const auto cpu : cpus) {
+		if (cpu < CPU_SETSIZE) {
+			CPU_SET(cpu, &set);
+		}
+	}
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+	DWORD_PTR mask = 0;
+	for (const auto cpu : cpus) {
+		if (cpu < sizeof(DWORD_PTR) * 8) {
+			mask |= static_cast<DWORD_PTR>(1) << cpu;
+		}
+	}
+	return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+	return false;
+#endif
+}
+
+void ThreadPool::applyAffinity() {
+	const auto &dispatcherCpus = g_configManager().getString(DISPATCHER_CPUS, __FUNCTION__);
+	if (!dispatcherCpus.empty()) {
+		if (pinCurrentThread(dispatcherCpus)) {
+			logger.info("Dispatcher pinned to cpus {}", dispatcherCpus);
+		} else {
+			logger.warn("[{}] - Could not pin the dispatcher to cpus '{}'", __FUNCTION__, dispatcherCpus);
+		}
+	}
+
+	const auto &workerCpus = g_configManager().getString(THREAD_POOL_CPUS, __FUNCTION__);
+	if (workerCpus.empty()) {
+		return;
+	}
+
+	// The pool can't name its threads, so each worker gets one task that waits until the others
+	// started theirs; the dispatcher holds one worker. A worker busy for longer than the wait is missed.
+	struct Rendezvous {
+		std::mutex mutex;
+		std::condition_variable started;
+		size_t count = 0;
+		size_t pinned = 0;
+	};
+	const auto workers = get_thread_count() - 1;
+	const auto rendezvous = std::make_shared<Rendezvous>();
+	for (size_t i = 0; i < workers; ++i) {
+		detach_task([this, rendezvous, workers, cpus = workerCpus] {
+			const bool pinned = pinCurrentThread(cpus);
+			std::unique_lock lock(rendezvous->mutex);
+			++rendezvous->count;
+			rendezvous->pinned += pinned ? 1 : 0;
+			rendezvous->started.notify_all();
+			rendezvous->started.wait_for(lock, std::chrono::seconds(1), [&] { return rendezvous->count >= workers; });
+			if (rendezvous->count == workers) {
+				logger.info("{} of {} pool workers pinned to cpus {}", rendezvous->pinned, workers, cpus);
+				// Only the first to see it logs
+				++rendezvous->count;
+			}
+		});
+	}
+}
@@ -22,6 +22,17 @@ public:
 	void start();
 	void shutdown();
 
+	/**
+	 * @brief Pins the calling thread to a list of cpus such as "0-3,8".
+	 * @return False when the list is empty or invalid, or the thread could not be pinned.
+	 */
+	static bool pinCurrentThread(std::string_view cpus);
+
+	/**
+	 * @brief Pins the calling thread, which must be the dispatcher, and the other workers to their configured cpus.
+	 */
+	void applyAffinity();
+
 	static int16_t getThreadId() {
 		static std::atomic_int16_t lastId = -1;
 		thread_local static int16_t id = -1;
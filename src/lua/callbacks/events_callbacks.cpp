@@ -46,26 +46,35 @@ void EventsCallbacks::addCallback(const std::shared_ptr<EventCallback> &callback
 
 	g_logger().trace("Registering event callback: {}", callback->getName());
 
-	m_callbacks[callback->getName()] = callback;
+	auto &registered = m_callbacks[callback->getName()];
+	if (registered) {
+		// Replaced under the same name, the old one leaves its type
+		auto &replacedCallbacks = m_callbacksByType[static_cast<size_t>(registered->getType())];
+		std::erase(replacedCallbacks, registered);
+	}
+	registered = callback;
+	m_callbacksByType[static_cast<size_t>(callback->getType())].emplace_back(callback);
 }
 
-std::unordered_map<std::string, std::shared_ptr<EventCallback>> EventsCallbacks::getCallbacks() const {
+const std::unordered_map<std::string, std::shared_ptr<EventCallback>> &EventsCallbacks::getCallbacks() const {
 	return m_callbacks;
 }
 
-std::unordered_map<std::string, std::shared_ptr<EventCallback>> EventsCallbacks::getCallbacksByType(EventCallback_t type) const {
-	std::unordered_map<std::string, std::shared_ptr<EventCallback>> eventCallbacks;
-	for (auto [name, callback] : getCallbacks()) {
-		if (callback->getType() != type) {
-			continue;
-		}
-
-		eventCallbacks[name] = callback;
-	}
-
-	return eventCallbacks;
+const std::vector<std::shared_ptr<EventCallback>> &EventsCallbacks::getCallbacksByType(EventCallback_t type) const {
+	return m_callbacksByType[static_cast<size_t>(type)];
 }
 
 void EventsCallbacks::clear() {
 	m_callbacks.clear();
+	for (auto &callbacks : m_callbacksByType) {
+		callbacks.clear();
+	}
+}
+
+void EventsCallbacks::clearScriptFile(const std::string &file) {
+	const auto ownedBy = [&file](const std::shared_ptr<EventCallback> &callback) { return callback->getScriptFile() == file; };
+	std::erase_if(m_callbacks, [&ownedBy](const auto &entry) { return ownedBy(entry.second); });
+	for (auto &callbacks : m_callbacksByType) {
+		std::erase_if(callbacks, ownedBy);
+	}
 }
@@ -64,22 +64,29 @@ public:
 
 	/**
 	 * @brief Gets all registered event callbacks.
-	 * @return Vector of pointers to EventCallback objects.
+	 * @return Map of the EventCallback objects by name.
 	 */
-	std::unordered_map<std::string, std::shared_ptr<EventCallback>> getCallbacks() const;
+	const std::unordered_map<std::string, std::shared_ptr<EventCallback>> &getCallbacks() const;
 
 	/**
 	 * @brief Gets event callbacks by their type.
+	 * @details Indexed when the callbacks are registered, nothing is copied nor filtered here.
 	 * @param type The type of callbacks to retrieve.
-	 * @return Vector of pointers to EventCallback objects of the specified type.
+	 * @return Vector of pointers to EventCallback objects of the specified type, in registration order.
 	 */
-	std::unordered_map<std::string, std::shared_ptr<EventCallback>> getCallbacksByType(EventCallback_t type) const;
+	const std::vector<std::shared_ptr<EventCallback>> &getCallbacksByType(EventCallback_t type) const;
 
 	/**
 	 * @brief Clears all registered event callbacks.
 	 */
 	void clear();
 
+	/**
+	 * @brief Removes the event callbacks registered by a script file.
+	 * @param file The path of the script file.
+	 */
+	void clearScriptFile(const std::string &file);
+
 	/**
 	 * @brief Executes the specified event callback.
 	 * @param eventType The type of event to trigger.
@@ -88,7 +95,10 @@ public:
 	 */
 	template <typename CallbackFunc, typename... Args>
 	void executeCallback(EventCallback_t eventType, CallbackFunc callbackFunc, Args &&... args) {
-		for (const auto &[name, callback] : getCallbacksByType(eventType)) {
+		const auto &callbacks = getCallbacksByType(eventType);
+		// By index and holding each callback, a callback may register or clear others
+		for (size_t i = 0; i < callbacks.size(); ++i) {
+			const auto callback = callbacks[i];
 			auto argsCopy = std::make_tuple(args...);
 			if (callback && callback->isLoadedCallback()) {
 				std::apply(
@@ -97,7 +107,7 @@ public:
 					},
 					argsCopy
 				);
-				g_logger().trace("Executed callback: {}", name);
+				g_logger().trace("Executed callback: {}", callback->getName());
 			}
 		}
 	}
@@ -111,7 +121,9 @@ public:
 	template <typename CallbackFunc, typename... Args>
 	ReturnValue checkCallbackWithReturnValue(EventCallback_t eventType, CallbackFunc callbackFunc, Args &&... args) {
 		ReturnValue res = RETURNVALUE_NOERROR;
-		for (const auto &[name, callback] : getCallbacksByType(eventType)) {
+		const auto &callbacks = getCallbacksByType(eventType);
+		for (size_t i = 0; i < callbacks.size(); ++i) {
+			const auto callback = callbacks[i];
 			auto argsCopy = std::make_tuple(args...);
 			if (callback && callback->isLoadedCallback()) {
 				ReturnValue callbackResult = std::apply(
@@ -139,7 +151,9 @@ public:
 	bool checkCallback(EventCallback_t eventType, CallbackFunc callbackFunc, Args &&... args) {
 		bool allCallbacksSucceeded = true;
 
-		for (const auto &[name, callback] : getCallbacksByType(eventType)) {
+		const auto &callbacks = getCallbacksByType(eventType);
+		for (size_t i = 0; i < callbacks.size(); ++i) {
+			const auto callback = callbacks[i];
 			auto argsCopy = std::make_tuple(args...);
 			if (callback && callback->isLoadedCallback()) {
 				bool callbackResult = std::apply(
@@ -157,6 +171,8 @@ public:
 private:
 	// Container for storing registered event callbacks.
 	std::unordered_map<std::string, std::shared_ptr<EventCallback>> m_callbacks;
+	// The same callbacks by the type they were registered with.
+	std::array<std::vector<std::shared_ptr<EventCallback>>, magic_enum::enum_count<EventCallback_t>()> m_callbacksByType;
 };
 
 constexpr auto g_callbacks = EventsCallbacks::getInstance;
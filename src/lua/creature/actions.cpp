@@ -21,12 +21,24 @@ Actions::Actions() = default;
 Actions::~Actions() = default;
 
 void Actions::clear() {
-	useItemMap.clear();
+	useItemTable.clear();
 	uniqueItemMap.clear();
 	actionItemMap.clear();
 	actionPositionMap.clear();
 }
 
+void Actions::clearScriptFile(const std::string &file) {
+	const auto ownedBy = [&file](const auto &entry) { return entry.second->getScriptFile() == file; };
+	for (auto &action : useItemTable) {
+		if (action && action->getScriptFile() == file) {
+			action = nullptr;
+		}
+	}
+	phmap::erase_if(uniqueItemMap, ownedBy);
+	phmap::erase_if(actionItemMap, ownedBy);
+	phmap::erase_if(actionPositionMap, ownedBy);
+}
+
 bool Actions::registerLuaItemEvent(const std::shared_ptr<Action> action) {
 	auto itemIdVector = action->getItemIdsVector();
 	if (itemIdVector.empty()) {
@@ -225,9 +237,9 @@ std::shared_ptr<Action> Actions::getAction(std::shared_ptr<Item> item) {
 		}
 	}
 
-	auto it = useItemMap.find(item->getID());
-	if (it != useItemMap.end()) {
-		return it->second;
+	if (const auto itemId = item->getID();
+	    itemId < useItemTable.size() && useItemTable[itemId]) {
+		return useItemTable[itemId];
 	}
 
 	if (auto iteratePositions = actionPositionMap.find(item->getPosition());
@@ -157,6 +157,7 @@ public:
 	bool registerLuaEvent(const std::shared_ptr<Action> action);
 	// Clear maps for reloading
 	void clear();
+	void clearScriptFile(const std::string &file);
 
 private:
 	bool hasPosition(Position position) const {
@@ -167,24 +168,19 @@ private:
 		return false;
 	}
 
-	[[nodiscard]] std::map<Position, std::shared_ptr<Action>> getPositionsMap() const {
-		return actionPositionMap;
-	}
-
 	void setPosition(Position position, std::shared_ptr<Action> action) {
 		actionPositionMap.try_emplace(position, action);
 	}
 
 	bool hasItemId(uint16_t itemId) const {
-		if (auto it = useItemMap.find(itemId);
-		    it != useItemMap.end()) {
-			return true;
-		}
-		return false;
+		return itemId < useItemTable.size() && useItemTable[itemId];
 	}
 
 	void setItemId(uint16_t itemId, const std::shared_ptr<Action> action) {
-		useItemMap.try_emplace(itemId, action);
+		if (itemId >= useItemTable.size()) {
+			useItemTable.resize(itemId + 1);
+		}
+		useItemTable[itemId] = action;
 	}
 
 	bool hasUniqueId(uint16_t uniqueId) const {
@@ -214,11 +210,12 @@ private:
 	ReturnValue internalUseItem(std::shared_ptr<Player> player, const Position &pos, uint8_t index, std::shared_ptr<Item> item, bool isHotkey);
 	static void showUseHotkeyMessage(std::shared_ptr<Player> player, std::shared_ptr<Item> item, uint32_t count);
 
-	using ActionUseMap = std::map<uint16_t, std::shared_ptr<Action>>;
-	ActionUseMap useItemMap;
+	// Indexed by item id, up to the highest id with an action
+	std::vector<std::shared_ptr<Action>> useItemTable;
+	using ActionUseMap = phmap::flat_hash_map<uint16_t, std::shared_ptr<Action>>;
 	ActionUseMap uniqueItemMap;
 	ActionUseMap actionItemMap;
-	std::map<Position, std::shared_ptr<Action>> actionPositionMap;
+	PositionMap<std::shared_ptr<Action>> actionPositionMap;
 
 	std::shared_ptr<Action> getAction(std::shared_ptr<Item> item);
 };
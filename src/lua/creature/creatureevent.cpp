@@ -19,6 +19,15 @@ void CreatureEvents::clear() {
 	}
 }
 
+void CreatureEvents::clearScriptFile(const std::string &file) {
+	// Kept like on clear, the creatures that registered it by name find it again once the file runs
+	for (auto &[name, event] : creatureEvents) {
+		if (event->getScriptFile() == file) {
+			event->clearEvent();
+		}
+	}
+}
+
 bool CreatureEvents::registerLuaEvent(const std::shared_ptr<CreatureEvent> creatureEvent) {
 	if (creatureEvent->getEventType() == CREATURE_EVENT_NONE) {
 		g_logger().error(
@@ -159,6 +168,7 @@ void CreatureEvent::copyEvent(const std::shared_ptr<CreatureEvent> creatureEvent
 	setScriptId(creatureEvent->getScriptId());
 	setScriptInterface(creatureEvent->getScriptInterface());
 	setLoadedCallback(creatureEvent->isLoadedCallback());
+	setScriptFile(creatureEvent->getScriptFile());
 	loaded = creatureEvent->loaded;
 }
 
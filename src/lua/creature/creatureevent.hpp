@@ -87,6 +87,7 @@ public:
 	bool registerLuaEvent(const std::shared_ptr<CreatureEvent> event);
 	void removeInvalidEvents();
 	void clear();
+	void clearScriptFile(const std::string &file);
 
 private:
 	// creature events
@@ -18,25 +18,25 @@
 void MoveEvents::clear(bool isFromXML /*= false*/) {
 	if (isFromXML) {
 		int numRemoved = 0;
-		for (auto &pair : itemIdMap) {
-			MoveEventList &moveEventList = pair.second;
-
+		for (auto &[itemId, moveEventList] : itemIdMap) {
 			for (int moveEventType = 0; moveEventType < MOVE_EVENT_LAST; ++moveEventType) {
 				auto &eventList = moveEventList.moveEvent[moveEventType];
 
-				eventList.remove_if([&](const std::shared_ptr<MoveEvent> &moveEvent) {
+				std::erase_if(eventList, [&](const std::shared_ptr<MoveEvent> &moveEvent) {
 					bool removed = moveEvent && moveEvent->isFromXML();
 					if (removed) {
-						g_logger().debug("MoveEvent with id '{}' is from XML and will be removed.", pair.first);
+						g_logger().debug("MoveEvent with id '{}' is from XML and will be removed.", itemId);
 						++numRemoved;
 					}
 					return removed;
 				});
 			}
+			updateItemEventTypes(itemId, moveEventList);
 		}
 
 		if (numRemoved > 0) {
 			g_logger().debug("Removed '{}' MoveEvent from XML.", numRemoved);
+			++version;
 		}
 		return;
 	}
@@ -45,6 +45,67 @@ void MoveEvents::clear(bool isFromXML /*= false*/) {
 	actionIdMap.clear();
 	itemIdMap.clear();
 	positionsMap.clear();
+	itemEventTypes.clear();
+	uniqueIdEventTypes = 0;
+	actionIdEventTypes = 0;
+	positionEventTypes = 0;
+	++version;
+}
+
+void MoveEvents::clearScriptFile(const std::string &file) {
+	const auto removeFrom = [&file](MoveEventList &moveEventList) {
+		for (auto &eventList : moveEventList.moveEvent) {
+			std::erase_if(eventList, [&file](const std::shared_ptr<MoveEvent> &moveEvent) {
+				return moveEvent && moveEvent->getScriptFile() == file;
+			});
+		}
+	};
+
+	for (auto &[itemId, moveEventList] : itemIdMap) {
+		removeFrom(moveEventList);
+		updateItemEventTypes(itemId, moveEventList);
+	}
+
+	// The bits of the other tables are only set on registration, they are computed again from what is left
+	uniqueIdEventTypes = 0;
+	for (auto &[uniqueId, moveEventList] : uniqueIdMap) {
+		removeFrom(moveEventList);
+		uniqueIdEventTypes |= getEventTypes(moveEventList);
+	}
+	actionIdEventTypes = 0;
+	for (auto &[actionId, moveEventList] : actionIdMap) {
+		removeFrom(moveEventList);
+		actionIdEventTypes |= getEventTypes(moveEventList);
+	}
+	positionEventTypes = 0;
+	// A position left without events would still be flagged on its tile
+	phmap::erase_if(positionsMap, [&](auto &entry) {
+		removeFrom(entry.second);
+		const auto eventTypes = getEventTypes(entry.second);
+		positionEventTypes |= eventTypes;
+		return eventTypes == 0;
+	});
+	++version;
+}
+
+uint8_t MoveEvents::getEventTypes(const MoveEventList &moveEventList) {
+	uint8_t eventTypes = 0;
+	for (int moveEventType = 0; moveEventType < MOVE_EVENT_LAST; ++moveEventType) {
+		if (!moveEventList.moveEvent[moveEventType].empty()) {
+			eventTypes |= 1 << moveEventType;
+		}
+	}
+	return eventTypes;
+}
+
+void MoveEvents::updateItemEventTypes(int32_t itemId, const MoveEventList &moveEventList) {
+	if (itemId < 0 || itemId > std::numeric_limits<uint16_t>::max()) {
+		return;
+	}
+	if (static_cast<size_t>(itemId) >= itemEventTypes.size()) {
+		itemEventTypes.resize(itemId + 1);
+	}
+	itemEventTypes[itemId] = getEventTypes(moveEventList);
 }
 
 bool MoveEvents::registerLuaItemEvent(const std::shared_ptr<MoveEvent> moveEvent) {
@@ -64,11 +125,16 @@ bool MoveEvents::registerLuaItemEvent(const std::shared_ptr<MoveEvent> moveEvent
 			it.minReqMagicLevel = moveEvent->getReqMagLv();
 			it.vocationString = moveEvent->getVocationString();
 		}
-		if (registerEvent(moveEvent, itemId, itemIdMap)) {
+		uint8_t eventTypes = 0;
+		if (registerEvent(moveEvent, itemId, itemIdMap, eventTypes)) {
+			updateItemEventTypes(itemId, itemIdMap[itemId]);
 			tmpVector.emplace_back(itemId);
 		}
 	}
 
+	if (!tmpVector.empty()) {
+		++version;
+	}
 	itemIdVector = std::move(tmpVector);
 	return !itemIdVector.empty();
 }
@@ -83,11 +149,14 @@ bool MoveEvents::registerLuaActionEvent(const std::shared_ptr<MoveEvent> moveEve
 	tmpVector.reserve(actionIdVector.size());
 
 	for (const auto &actionId : actionIdVector) {
-		if (registerEvent(moveEvent, actionId, actionIdMap)) {
+		if (registerEvent(moveEvent, actionId, actionIdMap, actionIdEventTypes)) {
 			tmpVector.emplace_back(actionId);
 		}
 	}
 
+	if (!tmpVector.empty()) {
+		++version;
+	}
 	actionIdVector = std::move(tmpVector);
 	return !actionIdVector.empty();
 }
@@ -102,11 +171,14 @@ bool MoveEvents::registerLuaUniqueEvent(const std::shared_ptr<MoveEvent> moveEve
 	tmpVector.reserve(uniqueIdVector.size());
 
 	for (const auto &uniqueId : uniqueIdVector) {
-		if (registerEvent(moveEvent, uniqueId, uniqueIdMap)) {
+		if (registerEvent(moveEvent, uniqueId, uniqueIdMap, uniqueIdEventTypes)) {
 			tmpVector.emplace_back(uniqueId);
 		}
 	}
 
+	if (!tmpVector.empty()) {
+		++version;
+	}
 	uniqueIdVector = std::move(tmpVector);
 	return !uniqueIdVector.empty();
 }
@@ -121,11 +193,14 @@ bool MoveEvents::registerLuaPositionEvent(const std::shared_ptr<MoveEvent> moveE
 	tmpVector.reserve(positionVector.size());
 
 	for (const auto &position : positionVector) {
-		if (registerEvent(moveEvent, position, positionsMap)) {
+		if (registerEvent(moveEvent, position, positionsMap, positionEventTypes)) {
 			tmpVector.emplace_back(position);
 		}
 	}
 
+	if (!tmpVector.empty()) {
+		++version;
+	}
 	positionVector = std::move(tmpVector);
 	return !positionVector.empty();
 }
@@ -147,29 +222,22 @@ bool MoveEvents::registerLuaEvent(const std::shared_ptr<MoveEvent> moveEvent) {
 	}
 }
 
-bool MoveEvents::registerEvent(const std::shared_ptr<MoveEvent> moveEvent, int32_t id, std::map<int32_t, MoveEventList> &moveListMap) const {
-	auto it = moveListMap.find(id);
-	if (it == moveListMap.end()) {
-		MoveEventList moveEventList;
-		moveEventList.moveEvent[moveEvent->getEventType()].push_back(moveEvent);
-		moveListMap[id] = moveEventList;
-		return true;
-	} else {
-		std::list<std::shared_ptr<MoveEvent>> &moveEventList = it->second.moveEvent[moveEvent->getEventType()];
-		for (const auto &existingMoveEvent : moveEventList) {
-			if (existingMoveEvent->getSlot() == moveEvent->getSlot()) {
-				g_logger().warn(
-					"[{}] duplicate move event found: {}, for script: {}",
-					__FUNCTION__,
-					id,
-					moveEvent->getScriptInterface()->getLoadingScriptName()
-				);
-				return false;
-			}
+bool MoveEvents::registerEvent(const std::shared_ptr<MoveEvent> moveEvent, int32_t id, MoveEventMap &moveListMap, uint8_t &eventTypes) const {
+	auto &moveEventList = moveListMap[id].moveEvent[moveEvent->getEventType()];
+	for (const auto &existingMoveEvent : moveEventList) {
+		if (existingMoveEvent->getSlot() == moveEvent->getSlot()) {
+			g_logger().warn(
+				"[{}] duplicate move event found: {}, for script: {}",
+				__FUNCTION__,
+				id,
+				moveEvent->getScriptInterface()->getLoadingScriptName()
+			);
+			return false;
 		}
-		moveEventList.push_back(moveEvent);
-		return true;
 	}
+	moveEventList.push_back(moveEvent);
+	eventTypes |= 1 << moveEvent->getEventType();
+	return true;
 }
 
 std::shared_ptr<MoveEvent> MoveEvents::getEvent(const std::shared_ptr<Item> &item, MoveEvent_t eventType, Slots_t slot) {
@@ -210,11 +278,11 @@ std::shared_ptr<MoveEvent> MoveEvents::getEvent(const std::shared_ptr<Item> &ite
 			break;
 	}
 
-	if (item->hasAttribute(ItemAttribute_t::ACTIONID)) {
-		std::map<int32_t, MoveEventList>::iterator it = actionIdMap.find(item->getAttribute<uint16_t>(ItemAttribute_t::ACTIONID));
-		if (it != actionIdMap.end()) {
-			std::list<std::shared_ptr<MoveEvent>> moveEventList = it->second.moveEvent[eventType];
-			for (const auto &moveEvent : moveEventList) {
+	const uint8_t eventBit = 1 << eventType;
+	if ((actionIdEventTypes & eventBit) != 0 && item->hasAttribute(ItemAttribute_t::ACTIONID)) {
+		if (auto it = actionIdMap.find(item->getAttribute<uint16_t>(ItemAttribute_t::ACTIONID));
+		    it != actionIdMap.end()) {
+			for (const auto &moveEvent : it->second.moveEvent[eventType]) {
 				if ((moveEvent->getSlot() & slotp) != 0) {
 					return moveEvent;
 				}
@@ -222,10 +290,13 @@ std::shared_ptr<MoveEvent> MoveEvents::getEvent(const std::shared_ptr<Item> &ite
 		}
 	}
 
-	auto it = itemIdMap.find(item->getID());
-	if (it != itemIdMap.end()) {
-		std::list<std::shared_ptr<MoveEvent>> &moveEventList = it->second.moveEvent[eventType];
-		for (const auto &moveEvent : moveEventList) {
+	if ((getItemEventTypes(item->getID()) & eventBit) == 0) {
+		return nullptr;
+	}
+
+	if (auto it = itemIdMap.find(item->getID());
+	    it != itemIdMap.end()) {
+		for (const auto &moveEvent : it->second.moveEvent[eventType]) {
 			if ((moveEvent->getSlot() & slotp) != 0) {
 				return moveEvent;
 			}
@@ -234,68 +305,84 @@ std::shared_ptr<MoveEvent> MoveEvents::getEvent(const std::shared_ptr<Item> &ite
 	return nullptr;
 }
 
+bool MoveEvents::hasTileEvents(const std::shared_ptr<Item> &item) const {
+	if ((getItemEventTypes(item->getID()) & TILE_EVENT_TYPES) != 0) {
+		return true;
+	}
+
+	const auto hasEvents = [&item](const MoveEventMap &moveListMap, uint8_t eventTypes, ItemAttribute_t attribute) {
+		if ((eventTypes & TILE_EVENT_TYPES) == 0 || !item->hasAttribute(attribute)) {
+			return false;
+		}
+		const auto it = moveListMap.find(item->getAttribute<uint16_t>(attribute));
+		return it != moveListMap.end() && (getEventTypes(it->second) & TILE_EVENT_TYPES) != 0;
+	};
+	return hasEvents(uniqueIdMap, uniqueIdEventTypes, ItemAttribute_t::UNIQUEID) || hasEvents(actionIdMap, actionIdEventTypes, ItemAttribute_t::ACTIONID);
+}
+
 std::shared_ptr<MoveEvent> MoveEvents::getEvent(const std::shared_ptr<Item> &item, MoveEvent_t eventType) {
-	std::map<int32_t, MoveEventList>::iterator it;
-	if (item->hasAttribute(ItemAttribute_t::UNIQUEID)) {
-		it = uniqueIdMap.find(item->getAttribute<uint16_t>(ItemAttribute_t::UNIQUEID));
-		if (it != uniqueIdMap.end()) {
-			std::list<std::shared_ptr<MoveEvent>> &moveEventList = it->second.moveEvent[eventType];
+	const uint8_t eventBit = 1 << eventType;
+	if ((uniqueIdEventTypes & eventBit) != 0 && item->hasAttribute(ItemAttribute_t::UNIQUEID)) {
+		if (auto it = uniqueIdMap.find(item->getAttribute<uint16_t>(ItemAttribute_t::UNIQUEID));
+		    it != uniqueIdMap.end()) {
+			const auto &moveEventList = it->second.moveEvent[eventType];
 			if (!moveEventList.empty()) {
-				return *moveEventList.begin();
+				return moveEventList.front();
 			}
 		}
 	}
 
-	if (item->hasAttribute(ItemAttribute_t::ACTIONID)) {
-		it = actionIdMap.find(item->getAttribute<uint16_t>(ItemAttribute_t::ACTIONID));
-		if (it != actionIdMap.end()) {
-			std::list<std::shared_ptr<MoveEvent>> &moveEventList = it->second.moveEvent[eventType];
+	if ((actionIdEventTypes & eventBit) != 0 && item->hasAttribute(ItemAttribute_t::ACTIONID)) {
+		if (auto it = actionIdMap.find(item->getAttribute<uint16_t>(ItemAttribute_t::ACTIONID));
+		    it != actionIdMap.end()) {
+			const auto &moveEventList = it->second.moveEvent[eventType];
 			if (!moveEventList.empty()) {
-				return *moveEventList.begin();
+				return moveEventList.front();
 			}
 		}
 	}
 
-	it = itemIdMap.find(item->getID());
-	if (it != itemIdMap.end()) {
-		std::list<std::shared_ptr<MoveEvent>> &moveEventList = it->second.moveEvent[eventType];
+	if ((getItemEventTypes(item->getID()) & eventBit) == 0) {
+		return nullptr;
+	}
+
+	if (auto it = itemIdMap.find(item->getID());
+	    it != itemIdMap.end()) {
+		const auto &moveEventList = it->second.moveEvent[eventType];
 		if (!moveEventList.empty()) {
-			return *moveEventList.begin();
+			return moveEventList.front();
 		}
 	}
 	return nullptr;
 }
 
-bool MoveEvents::registerEvent(const std::shared_ptr<MoveEvent> moveEvent, const Position &position, std::map<Position, MoveEventList> &moveListMap) const {
-	auto it = moveListMap.find(position);
-	if (it == moveListMap.end()) {
-		MoveEventList moveEventList;
-		moveEventList.moveEvent[moveEvent->getEventType()].push_back(moveEvent);
-		moveListMap[position] = moveEventList;
-		return true;
-	} else {
-		std::list<std::shared_ptr<MoveEvent>> &moveEventList = it->second.moveEvent[moveEvent->getEventType()];
-		if (!moveEventList.empty()) {
-			g_logger().warn(
-				"[{}] duplicate move event found: {}, for script {}",
-				__FUNCTION__,
-				position.toString(),
-				moveEvent->getScriptInterface()->getLoadingScriptName()
-			);
-			return false;
-		}
-
-		moveEventList.push_back(moveEvent);
-		return true;
+bool MoveEvents::registerEvent(const std::shared_ptr<MoveEvent> moveEvent, const Position &position, PositionMap<MoveEventList> &moveListMap, uint8_t &eventTypes) const {
+	auto &moveEventList = moveListMap[position].moveEvent[moveEvent->getEventType()];
+	if (!moveEventList.empty()) {
+		g_logger().warn(
+			"[{}] duplicate move event found: {}, for script {}",
+			__FUNCTION__,
+			position.toString(),
+			moveEvent->getScriptInterface()->getLoadingScriptName()
+		);
+		return false;
 	}
+
+	moveEventList.push_back(moveEvent);
+	eventTypes |= 1 << moveEvent->getEventType();
+	return true;
 }
 
 std::shared_ptr<MoveEvent> MoveEvents::getEvent(const std::shared_ptr<Tile> &tile, MoveEvent_t eventType) {
+	if ((positionEventTypes & (1 << eventType)) == 0) {
+		return nullptr;
+	}
+
 	if (auto it = positionsMap.find(tile->getPosition());
 	    it != positionsMap.end()) {
-		std::list<std::shared_ptr<MoveEvent>> &moveEventList = it->second.moveEvent[eventType];
+		const auto &moveEventList = it->second.moveEvent[eventType];
 		if (!moveEventList.empty()) {
-			return *moveEventList.begin();
+			return moveEventList.front();
 		}
 	}
 	return nullptr;
@@ -18,9 +18,11 @@
 class MoveEvent;
 
 struct MoveEventList {
-	std::list<std::shared_ptr<MoveEvent>> moveEvent[MOVE_EVENT_LAST];
+	std::vector<std::shared_ptr<MoveEvent>> moveEvent[MOVE_EVENT_LAST];
 };
 
+using MoveEventMap = phmap::flat_hash_map<int32_t, MoveEventList>;
+
 using VocEquipMap = std::map<uint16_t, bool>;
 
 class MoveEvents final : public Scripts {
@@ -41,10 +43,6 @@ public:
 	uint32_t onPlayerDeEquip(const std::shared_ptr<Player> &player, const std::shared_ptr<Item> &item, Slots_t slot);
 	uint32_t onItemMove(const std::shared_ptr<Item> &item, const std::shared_ptr<Tile> &tile, bool isAdd);
 
-	std::map<Position, MoveEventList> getPositionsMap() const {
-		return positionsMap;
-	}
-
 	bool hasPosition(Position position) const {
 		if (auto it = positionsMap.find(position);
 		    it != positionsMap.end()) {
@@ -54,11 +52,10 @@ public:
 	}
 
 	void setPosition(Position position, MoveEventList moveEventList) {
-		positionsMap.try_emplace(position, moveEventList);
-	}
-
-	std::map<int32_t, MoveEventList> getItemIdMap() const {
-		return itemIdMap;
+		if (auto [it, inserted] = positionsMap.try_emplace(position, std::move(moveEventList)); inserted) {
+			positionEventTypes |= getEventTypes(it->second);
+			++version;
+		}
 	}
 
 	bool hasItemId(int32_t itemId) const {
@@ -70,11 +67,10 @@ public:
 	}
 
 	void setItemId(int32_t itemId, MoveEventList moveEventList) {
-		itemIdMap.try_emplace(itemId, moveEventList);
-	}
-
-	std::map<int32_t, MoveEventList> getUniqueIdMap() const {
-		return uniqueIdMap;
+		if (auto [it, inserted] = itemIdMap.try_emplace(itemId, std::move(moveEventList)); inserted) {
+			updateItemEventTypes(itemId, it->second);
+			++version;
+		}
 	}
 
 	bool hasUniqueId(int32_t uniqueId) const {
@@ -86,11 +82,10 @@ public:
 	}
 
 	void setUniqueId(int32_t uniqueId, MoveEventList moveEventList) {
-		uniqueIdMap.try_emplace(uniqueId, moveEventList);
-	}
-
-	std::map<int32_t, MoveEventList> getActionIdMap() const {
-		return actionIdMap;
+		if (auto [it, inserted] = uniqueIdMap.try_emplace(uniqueId, std::move(moveEventList)); inserted) {
+			uniqueIdEventTypes |= getEventTypes(it->second);
+			++version;
+		}
 	}
 
 	bool hasActionId(int32_t actionId) const {
@@ -102,32 +97,62 @@ public:
 	}
 
 	void setActionId(int32_t actionId, MoveEventList moveEventList) {
-		actionIdMap.try_emplace(actionId, moveEventList);
+		if (auto [it, inserted] = actionIdMap.try_emplace(actionId, std::move(moveEventList)); inserted) {
+			actionIdEventTypes |= getEventTypes(it->second);
+			++version;
+		}
 	}
 
 	std::shared_ptr<MoveEvent> getEvent(const std::shared_ptr<Item> &item, MoveEvent_t eventType);
 
+	/**
+	 * @brief Whether the item, by its id, action id or unique id, has a step or add/remove item event.
+	 */
+	bool hasTileEvents(const std::shared_ptr<Item> &item) const;
+	bool hasPositionEvents(const Position &position) const {
+		return (positionEventTypes & TILE_EVENT_TYPES) != 0 && positionsMap.contains(position);
+	}
+
+	// Changes whenever an event is registered or the events are cleared, the tiles recompute their move event flag then
+	uint32_t getVersion() const {
+		return version;
+	}
+
 	bool registerLuaItemEvent(const std::shared_ptr<MoveEvent> moveEvent);
 	bool registerLuaActionEvent(const std::shared_ptr<MoveEvent> moveEvent);
 	bool registerLuaUniqueEvent(const std::shared_ptr<MoveEvent> moveEvent);
 	bool registerLuaPositionEvent(const std::shared_ptr<MoveEvent> moveEvent);
 	bool registerLuaEvent(const std::shared_ptr<MoveEvent> event);
 	void clear(bool isFromXML = false);
+	void clearScriptFile(const std::string &file);
 
 private:
-	void clearMap(std::map<int32_t, MoveEventList> &map) const;
-	void clearPosMap(std::map<Position, MoveEventList> &map);
+	static constexpr uint8_t TILE_EVENT_TYPES = static_cast<uint8_t>(~((1 << MOVE_EVENT_EQUIP) | (1 << MOVE_EVENT_DEEQUIP)));
+
+	static uint8_t getEventTypes(const MoveEventList &moveEventList);
+	void updateItemEventTypes(int32_t itemId, const MoveEventList &moveEventList);
+	uint8_t getItemEventTypes(uint16_t itemId) const {
+		return itemId < itemEventTypes.size() ? itemEventTypes[itemId] : 0;
+	}
 
-	bool registerEvent(const std::shared_ptr<MoveEvent> moveEvent, int32_t id, std::map<int32_t, MoveEventList> &moveListMap) const;
-	bool registerEvent(const std::shared_ptr<MoveEvent> moveEvent, const Position &position, std::map<Position, MoveEventList> &moveListMap) const;
+	bool registerEvent(const std::shared_ptr<MoveEvent> moveEvent, int32_t id, MoveEventMap &moveListMap, uint8_t &eventTypes) const;
+	bool registerEvent(const std::shared_ptr<MoveEvent> moveEvent, const Position &position, PositionMap<MoveEventList> &moveListMap, uint8_t &eventTypes) const;
 	std::shared_ptr<MoveEvent> getEvent(const std::shared_ptr<Tile> &tile, MoveEvent_t eventType);
 
 	std::shared_ptr<MoveEvent> getEvent(const std::shared_ptr<Item> &item, MoveEvent_t eventType, Slots_t slot);
 
-	std::map<int32_t, MoveEventList> uniqueIdMap;
-	std::map<int32_t, MoveEventList> actionIdMap;
-	std::map<int32_t, MoveEventList> itemIdMap;
-	std::map<Position, MoveEventList> positionsMap;
+	MoveEventMap uniqueIdMap;
+	MoveEventMap actionIdMap;
+	MoveEventMap itemIdMap;
+	PositionMap<MoveEventList> positionsMap;
+
+	// One bit per MoveEvent_t registered in each table, a lookup is skipped when its bit is clear
+	// The item ids are indexed directly, up to the highest id with an event
+	std::vector<uint8_t> itemEventTypes;
+	uint8_t uniqueIdEventTypes = 0;
+	uint8_t actionIdEventTypes = 0;
+	uint8_t positionEventTypes = 0;
+	uint32_t version = 1;
 };
 
 constexpr auto g_moveEvents = MoveEvents::getInstance;
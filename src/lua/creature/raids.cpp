@@ -101,49 +101,109 @@ bool Raids::startup() {
 	}
 
 	setLastRaidEnd(OTSYS_TIME());
-
-	checkRaidsEvent = g_dispatcher().scheduleEvent(
-		CHECK_RAIDS_INTERVAL * 1000, [this] { checkRaids(); }, "Raids::checkRaids"
-	);
+	scheduleNextRaid();
 
 	started = true;
 	return started;
 }
 
-void Raids::checkRaids() {
-	if (g_configManager().getBoolean(DISABLE_LEGACY_RAIDS, __FUNCTION__)) {
+namespace {
+	// The longest delay of a dispatcher event, later raids are drawn again when it runs out
+	constexpr uint64_t MAX_RAID_SCHEDULE_DELAY = std::numeric_limits<int32_t>::max();
+
+	// Checks until the raid wins its roll, each check rolling as the per-interval check did
+	uint64_t drawFailedChecks(const std::shared_ptr<Raid> &raid) {
+		const auto required = static_cast<uint32_t>(MAX_RAND_RANGE * raid->getInterval()) / CHECK_RAIDS_INTERVAL;
+		const double chance = std::min(1.0, (static_cast<double>(required) + 1.0) / (static_cast<double>(MAX_RAND_RANGE) + 1.0));
+		if (chance >= 1.0) {
+			return 0;
+		}
+
+		// Geometric distribution, the number of failed rolls before the first success
+		const double roll = static_cast<double>(uniform_random(1, MAX_RAND_RANGE)) / static_cast<double>(MAX_RAND_RANGE);
+		const double checks = std::floor(std::log(roll) / std::log1p(-chance));
+		return static_cast<uint64_t>(std::min(checks, static_cast<double>(MAX_RAID_SCHEDULE_DELAY)));
+	}
+}
+
+void Raids::scheduleNextRaid() {
+	g_dispatcher().stopEvent(checkRaidsEvent);
+	checkRaidsEvent = 0;
+	scheduled = nullptr;
+	if (g_configManager().getBoolean(DISABLE_LEGACY_RAIDS, __FUNCTION__) || !isLoaded()) {
 		return;
 	}
-	if (!getRunning()) {
-		uint64_t now = OTSYS_TIME();
-
-		for (auto it = raidList.begin(), end = raidList.end(); it != end; ++it) {
-			const auto &raid = *it;
-			if (now >= (getLastRaidEnd() + raid->getMargin())) {
-				auto roll = static_cast<uint32_t>(uniform_random(0, MAX_RAND_RANGE));
-				auto required = static_cast<uint32_t>(MAX_RAND_RANGE * raid->getInterval()) / CHECK_RAIDS_INTERVAL;
-				auto shouldStart = required >= roll;
-				if (shouldStart) {
-					setRunning(raid);
-					raid->startRaid();
-
-					if (!raid->canBeRepeated()) {
-						raidList.erase(it);
-					}
-					break;
-				}
-			}
+
+	// The given raids roll on every check of the interval once their margin passed, the first winner, in list order, starts
+	const uint64_t now = OTSYS_TIME();
+	const uint64_t firstCheck = now + CHECK_RAIDS_INTERVAL * 1000;
+	for (const auto &raid : raidList) {
+		const auto eligible = std::max(firstCheck, getLastRaidEnd() + raid->getMargin());
+		const auto failedChecks = std::min(drawFailedChecks(raid), MAX_RAID_SCHEDULE_DELAY / (CHECK_RAIDS_INTERVAL * 1000));
+		raid->setPlannedStart(eligible + failedChecks * CHECK_RAIDS_INTERVAL * 1000);
+		if (!scheduled || raid->getPlannedStart() < scheduled->getPlannedStart()) {
+			scheduled = raid;
 		}
 	}
 
+	if (!scheduled) {
+		return;
+	}
+
+	const auto delay = std::min(scheduled->getPlannedStart() - now, MAX_RAID_SCHEDULE_DELAY);
 	checkRaidsEvent = g_dispatcher().scheduleEvent(
-		CHECK_RAIDS_INTERVAL * 1000, [this] { checkRaids(); }, "Raids::checkRaids"
+		static_cast<uint32_t>(delay), [this] { startScheduledRaid(); }, "Raids::startScheduledRaid"
 	);
 }
 
+void Raids::startScheduledRaid() {
+	checkRaidsEvent = 0;
+	// A raid started by hand is running, the next one is drawn when it ends
+	if (getRunning() || !scheduled) {
+		return;
+	}
+
+	// Too far ahead for a single event, the rolls are memoryless so drawing them again keeps the odds
+	if (OTSYS_TIME() < scheduled->getPlannedStart()) {
+		scheduleNextRaid();
+		return;
+	}
+
+	const auto raid = scheduled;
+	scheduled = nullptr;
+	if (!raid->canBeRepeated()) {
+		raidList.remove(raid);
+	}
+	setRunning(raid);
+	raid->startRaid();
+}
+
+std::string Raids::getScheduleReport() const {
+	if (running) {
+		return fmt::format("Raid {} is running, the next raid is drawn when it ends.", running->getName());
+	}
+	if (!scheduled) {
+		return "No raid scheduled.";
+	}
+
+	std::vector<std::shared_ptr<Raid>> raids(raidList.begin(), raidList.end());
+	std::ranges::sort(raids, [](const auto &a, const auto &b) {
+		return a->getPlannedStart() < b->getPlannedStart();
+	});
+
+	const uint64_t now = OTSYS_TIME();
+	std::string report = "Planned raid starts (minutes from now), only the earliest one happens:";
+	for (const auto &raid : raids) {
+		const auto minutes = raid->getPlannedStart() > now ? (raid->getPlannedStart() - now) / 60000 : 0;
+		report += fmt::format("\n{} - {}{}", raid->getName(), minutes, raid == scheduled ? " (next)" : "");
+	}
+	return report;
+}
+
 void Raids::clear() {
 	g_dispatcher().stopEvent(checkRaidsEvent);
 	checkRaidsEvent = 0;
+	scheduled = nullptr;
 
 	for (const auto &raid : raidList) {
 		raid->stopEvents();
@@ -252,6 +312,7 @@ void Raid::resetRaid() {
 	state = RAIDSTATE_IDLE;
 	g_game().raids.setRunning(nullptr);
 	g_game().raids.setLastRaidEnd(OTSYS_TIME());
+	g_game().raids.scheduleNextRaid();
 }
 
 void Raid::stopEvents() {
@@ -69,7 +69,13 @@ public:
 		lastRaidEnd = newLastRaidEnd;
 	}
 
-	void checkRaids();
+	/**
+	 * @brief Draws the start time of every raid and schedules the earliest one.
+	 * Called on startup and whenever a raid ends, instead of rolling every raid each CHECK_RAIDS_INTERVAL.
+	 */
+	void scheduleNextRaid();
+	// Upcoming raids, earliest first
+	std::string getScheduleReport() const;
 
 	LuaScriptInterface &getScriptInterface() {
 		return scriptInterface;
@@ -78,8 +84,11 @@ public:
 private:
 	LuaScriptInterface scriptInterface { "Raid Interface" };
 
+	void startScheduledRaid();
+
 	std::list<std::shared_ptr<Raid>> raidList;
 	std::shared_ptr<Raid> running = nullptr;
+	std::shared_ptr<Raid> scheduled = nullptr;
 	uint64_t lastRaidEnd = 0;
 	uint32_t checkRaidsEvent = 0;
 	bool loaded = false;
@@ -124,6 +133,14 @@ public:
 		return repeat;
 	}
 
+	// When the raid wins its roll, drawn by Raids::scheduleNextRaid
+	uint64_t getPlannedStart() const {
+		return plannedStart;
+	}
+	void setPlannedStart(uint64_t newPlannedStart) {
+		plannedStart = newPlannedStart;
+	}
+
 	void stopEvents();
 
 private:
@@ -132,6 +149,7 @@ private:
 	uint32_t interval;
 	uint32_t nextEvent = 0;
 	uint64_t margin;
+	uint64_t plannedStart = 0;
 	RaidState_t state = RAIDSTATE_IDLE;
 	uint32_t nextEventEvent = 0;
 	bool loaded = false;
@@ -18,22 +18,42 @@ TalkActions::~TalkActions() = default;
 
 void TalkActions::clear() {
 	talkActions.clear();
+	talkActionsByWord.clear();
 }
 
-bool TalkActions::registerLuaEvent(const TalkAction_ptr &talkAction) {
-	auto [iterator, inserted] = talkActions.try_emplace(talkAction->getWords(), talkAction);
-	return inserted;
+void TalkActions::clearScriptFile(const std::string &file) {
+	std::erase_if(talkActions, [&file](const auto &entry) { return entry.second->getScriptFile() == file; });
+	phmap::erase_if(talkActionsByWord, [&file](auto &entry) {
+		std::erase_if(entry.second, [&file](const auto &candidate) { return candidate.second->getScriptFile() == file; });
+		return entry.second.empty();
+	});
 }
 
-bool TalkActions::checkWord(std::shared_ptr<Player> player, SpeakClasses type, const std::string &words, const std::string_view &word, const TalkAction_ptr &talkActionPtr) const {
-	auto spacePos = std::ranges::find_if(words.begin(), words.end(), ::isspace);
-	std::string firstWord = words.substr(0, spacePos - words.begin());
-
-	// Check for exact equality from saying word and talkaction stored word
-	if (firstWord != word) {
+bool TalkActions::registerLuaEvent(const TalkAction_ptr &talkAction) {
+	const std::string &talkactionWords = talkAction->getWords();
+	auto [iterator, inserted] = talkActions.try_emplace(talkactionWords, talkAction);
+	if (!inserted) {
 		return false;
 	}
 
+	const auto addWord = [&](const std::string &word) {
+		auto &candidates = talkActionsByWord[word];
+		const auto position = std::ranges::lower_bound(candidates, talkactionWords, std::less {}, &std::pair<std::string, TalkAction_ptr>::first);
+		candidates.emplace(position, talkactionWords, talkAction);
+	};
+
+	if (talkactionWords.find(',') != std::string::npos) {
+		for (const auto &word : split(talkactionWords)) {
+			addWord(word);
+		}
+	} else {
+		addWord(talkactionWords);
+	}
+	return true;
+}
+
+bool TalkActions::checkWord(std::shared_ptr<Player> player, SpeakClasses type, const std::string &words, const std::string_view &word, const TalkAction_ptr &talkActionPtr) const {
+	// The first word of what was said is the talkaction word
 	auto groupId = player->getGroup()->id;
 	if (groupId < talkActionPtr->getGroupType()) {
 		return false;
@@ -62,18 +82,16 @@ bool TalkActions::checkWord(std::shared_ptr<Player> player, SpeakClasses type, c
 }
 
 TalkActionResult_t TalkActions::checkPlayerCanSayTalkAction(std::shared_ptr<Player> player, SpeakClasses type, const std::string &words) const {
-	for (const auto &[talkactionWords, talkActionPtr] : talkActions) {
-		if (talkactionWords.find(',') != std::string::npos) {
-			auto wordsList = split(talkactionWords);
-			for (const auto &word : wordsList) {
-				if (checkWord(player, type, words, word, talkActionPtr)) {
-					return TALKACTION_BREAK;
-				}
-			}
-		} else {
-			if (checkWord(player, type, words, talkactionWords, talkActionPtr)) {
-				return TALKACTION_BREAK;
-			}
+	const auto spacePos = std::ranges::find_if(words, ::isspace);
+	const std::string_view firstWord(words.data(), static_cast<size_t>(spacePos - words.begin()));
+	const auto it = talkActionsByWord.find(firstWord);
+	if (it == talkActionsByWord.end()) {
+		return TALKACTION_CONTINUE;
+	}
+
+	for (const auto &[talkactionWords, talkActionPtr] : it->second) {
+		if (checkWord(player, type, words, firstWord, talkActionPtr)) {
+			return TALKACTION_BREAK;
 		}
 	}
 	return TALKACTION_CONTINUE;
@@ -87,6 +87,7 @@ public:
 
 	bool registerLuaEvent(const TalkAction_ptr &talkAction);
 	void clear();
+	void clearScriptFile(const std::string &file);
 
 	const std::map<std::string, std::shared_ptr<TalkAction>> &getTalkActionsMap() const {
 		return talkActions;
@@ -94,6 +95,8 @@ public:
 
 private:
 	std::map<std::string, std::shared_ptr<TalkAction>> talkActions;
+	// Every word of the registered talkactions, with its talkactions in the order of the map above
+	phmap::flat_hash_map<std::string, std::vector<std::pair<std::string, std::shared_ptr<TalkAction>>>> talkActionsByWord;
 };
 
 constexpr auto g_talkActions = TalkActions::getInstance;
@@ -19,6 +19,7 @@ void ConfigFunctions::init(lua_State* L) {
 	registerMethod(L, "configManager", "getNumber", luaConfigManagerGetNumber);
 	registerMethod(L, "configManager", "getBoolean", luaConfigManagerGetBoolean);
 	registerMethod(L, "configManager", "getFloat", luaConfigManagerGetFloat);
+	registerMethod(L, "configManager", "getRevision", luaConfigManagerGetRevision);
 
 #define registerMagicEnumIn(L, tableName, enumValue)         \
 	do {                                                     \
@@ -88,3 +89,9 @@ int ConfigFunctions::luaConfigManagerGetFloat(lua_State* L) {
 	lua_pushnumber(L, finalValue);
 	return 1;
 }
+
+int ConfigFunctions::luaConfigManagerGetRevision(lua_State* L) {
+	// configManager.getRevision()
+	lua_pushnumber(L, g_configManager().getRevision());
+	return 1;
+}
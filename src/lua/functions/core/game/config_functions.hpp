@@ -48,4 +48,5 @@ private:
 	static int luaConfigManagerGetBoolean(lua_State* L);
 	static int luaConfigManagerGetNumber(lua_State* L);
 	static int luaConfigManagerGetString(lua_State* L);
+	static int luaConfigManagerGetRevision(lua_State* L);
 };
@@ -9,6 +9,7 @@
 
 #include "pch.hpp"
 
+#include "config/configmanager.hpp"
 #include "core.hpp"
 #include "creatures/monsters/monster.hpp"
 #include "game/functions/game_reload.hpp"
@@ -23,6 +24,8 @@
 #include "lua/creature/talkaction.hpp"
 #include "lua/functions/creatures/npc/npc_type_functions.hpp"
 #include "lua/scripts/lua_environment.hpp"
+#include "lua/scripts/lua_profiler.hpp"
+#include "lib/profiling/sampling_profiler.hpp"
 #include "lua/creature/events.hpp"
 #include "lua/callbacks/event_callback.hpp"
 #include "lua/callbacks/events_callbacks.hpp"
@@ -116,6 +119,125 @@ int GameFunctions::luaGameGetSpectators(lua_State* L) {
 	return 1;
 }
 
+int GameFunctions::luaGameSendMagicEffects(lua_State* L) {
+	// Game.sendMagicEffects(effect, positions)
+	const uint16_t effect = getNumber<uint16_t>(L, 1);
+	if (!lua_istable(L, 2)) {
+		reportErrorFunc("Positions must be a table");
+		pushBoolean(L, false);
+		return 1;
+	}
+
+	if (g_configManager().getBoolean(WARN_UNSAFE_SCRIPTS, __FUNCTION__) && !g_game().isMagicEffectRegistered(effect)) {
+		g_logger().warn("[{}] An unregistered magic effect type with id '{}' was blocked to prevent client crash.", __FUNCTION__, effect);
+		pushBoolean(L, false);
+		return 1;
+	}
+
+	std::vector<Position> positions;
+	positions.reserve(lua_objlen(L, 2));
+	lua_pushnil(L);
+	while (lua_next(L, 2) != 0) {
+		positions.emplace_back(getPosition(L, -1));
+		lua_pop(L, 1);
+	}
+
+	g_game().addMagicEffects(positions, effect);
+	pushBoolean(L, true);
+	return 1;
+}
+
+int GameFunctions::luaGameAddSpectatorsHealth(lua_State* L) {
+	// Game.addSpectatorsHealth(position, healthChange[, combatType = COMBAT_UNDEFINEDDAMAGE[, effect = CONST_ME_NONE[, onlyPlayers = false[, minRangeX = 0[, maxRangeX = 0[, minRangeY = 0[, maxRangeY = 0]]]]]]])
+	const Position &position = getPosition(L, 1);
+	const int32_t healthChange = getNumber<int32_t>(L, 2);
+	const auto combatType = getNumber<CombatType_t>(L, 3, COMBAT_UNDEFINEDDAMAGE);
+	const uint16_t effect = getNumber<uint16_t>(L, 4, CONST_ME_NONE);
+	const bool onlyPlayers = getBoolean(L, 5, false);
+	const int32_t minRangeX = getNumber<int32_t>(L, 6, 0);
+	const int32_t maxRangeX = getNumber<int32_t>(L, 7, 0);
+	const int32_t minRangeY = getNumber<int32_t>(L, 8, 0);
+	const int32_t maxRangeY = getNumber<int32_t>(L, 9, 0);
+
+	Spectators spectators;
+	if (onlyPlayers) {
+		spectators.find<Player>(position, false, minRangeX, maxRangeX, minRangeY, maxRangeY);
+	} else {
+		spectators.find<Creature>(position, false, minRangeX, maxRangeX, minRangeY, maxRangeY);
+	}
+
+	std::vector<Position> effectPositions;
+	effectPositions.reserve(spectators.size());
+	uint32_t count = 0;
+	for (const auto &creature : spectators) {
+		// A previous change may have killed or moved it out
+		if (creature->isRemoved() || creature->isDead()) {
+			continue;
+		}
+
+		CombatDamage damage;
+		damage.primary.value = healthChange;
+		damage.primary.type = healthChange >= 0 ? COMBAT_HEALING : combatType;
+		if (effect != CONST_ME_NONE) {
+			effectPositions.emplace_back(creature->getPosition());
+		}
+		if (g_game().combatChangeHealth(nullptr, creature, damage)) {
+			++count;
+		}
+	}
+
+	if (!effectPositions.empty()) {
+		g_game().addMagicEffects(effectPositions, effect);
+	}
+	lua_pushnumber(L, count);
+	return 1;
+}
+
+int GameFunctions::luaGameTeleportSpectators(lua_State* L) {
+	// Game.teleportSpectators(position, destination[, effect = CONST_ME_NONE[, onlyPlayers = true[, minRangeX = 0[, maxRangeX = 0[, minRangeY = 0[, maxRangeY = 0]]]]]])
+	const Position &position = getPosition(L, 1);
+	const Position &destination = getPosition(L, 2);
+	const uint16_t effect = getNumber<uint16_t>(L, 3, CONST_ME_NONE);
+	const bool onlyPlayers = getBoolean(L, 4, true);
+	const int32_t minRangeX = getNumber<int32_t>(L, 5, 0);
+	const int32_t maxRangeX = getNumber<int32_t>(L, 6, 0);
+	const int32_t minRangeY = getNumber<int32_t>(L, 7, 0);
+	const int32_t maxRangeY = getNumber<int32_t>(L, 8, 0);
+
+	Spectators spectators;
+	if (onlyPlayers) {
+		spectators.find<Player>(position, false, minRangeX, maxRangeX, minRangeY, maxRangeY);
+	} else {
+		spectators.find<Creature>(position, false, minRangeX, maxRangeX, minRangeY, maxRangeY);
+	}
+
+	std::vector<Position> effectPositions;
+	uint32_t count = 0;
+	for (const auto &creature : spectators) {
+		if (creature->isRemoved()) {
+			continue;
+		}
+
+		const Position oldPosition = creature->getPosition();
+		if (auto ret = g_game().internalTeleport(creature, destination); ret != RETURNVALUE_NOERROR) {
+			g_logger().debug("[{}] Failed to teleport creature {}, on position {}, error code: {}", __FUNCTION__, creature->getName(), oldPosition.toString(), getReturnMessage(ret));
+			continue;
+		}
+
+		if (effect != CONST_ME_NONE) {
+			effectPositions.emplace_back(oldPosition);
+		}
+		++count;
+	}
+
+	if (count != 0 && effect != CONST_ME_NONE) {
+		effectPositions.emplace_back(destination);
+		g_game().addMagicEffects(effectPositions, effect);
+	}
+	lua_pushnumber(L, count);
+	return 1;
+}
+
 int GameFunctions::luaGameGetBoostedCreature(lua_State* L) {
 	// Game.getBoostedCreature()
 	pushString(L, g_game().getBoostedMonsterName());
@@ -223,7 +345,7 @@ int GameFunctions::luaGameGetNpcCount(lua_State* L) {
 
 int GameFunctions::luaGameGetMonsterTypes(lua_State* L) {
 	// Game.getMonsterTypes()
-	const auto type = g_monsters().monsters;
+	const auto &type = g_monsters().monsters;
 	lua_createtable(L, type.size(), 0);
 
 	for (const auto &[typeName, mType] : type) {
@@ -582,6 +704,12 @@ int GameFunctions::luaGameStartRaid(lua_State* L) {
 	return 1;
 }
 
+int GameFunctions::luaGameGetRaidSchedule(lua_State* L) {
+	// Game.getRaidSchedule()
+	pushString(L, g_game().raids.getScheduleReport());
+	return 1;
+}
+
 int GameFunctions::luaGameGetClientVersion(lua_State* L) {
 	// Game.getClientVersion()
 	lua_createtable(L, 0, 3);
@@ -612,6 +740,90 @@ int GameFunctions::luaGameReload(lua_State* L) {
 	return 1;
 }
 
+int GameFunctions::luaGameStartLuaProfiler(lua_State* L) {
+	// Game.startLuaProfiler()
+	g_luaProfiler().start();
+	pushBoolean(L, true);
+	return 1;
+}
+
+int GameFunctions::luaGameStopLuaProfiler(lua_State* L) {
+	// Game.stopLuaProfiler()
+	g_luaProfiler().stop();
+	pushBoolean(L, true);
+	return 1;
+}
+
+int GameFunctions::luaGameResetLuaProfiler(lua_State* L) {
+	// Game.resetLuaProfiler()
+	g_luaProfiler().reset();
+	pushBoolean(L, true);
+	return 1;
+}
+
+int GameFunctions::luaGameGetLuaProfilerReport(lua_State* L) {
+	// Game.getLuaProfilerReport([limit = 20])
+	pushString(L, g_luaProfiler().getReport(getNumber<size_t>(L, 1, 20)));
+	return 1;
+}
+
+int GameFunctions::luaGameDumpLuaProfiler(lua_State* L) {
+	// Game.dumpLuaProfiler(path)
+	pushBoolean(L, g_luaProfiler().dump(getString(L, 1)));
+	return 1;
+}
+
+int GameFunctions::luaGameStartSamplingProfiler(lua_State* L) {
+	// Game.startSamplingProfiler([frequency = 100])
+	pushBoolean(L, g_samplingProfiler().start(getNumber<uint32_t>(L, 1, 100)));
+	return 1;
+}
+
+int GameFunctions::luaGameStopSamplingProfiler(lua_State* L) {
+	// Game.stopSamplingProfiler()
+	g_samplingProfiler().stop();
+	pushBoolean(L, true);
+	return 1;
+}
+
+int GameFunctions::luaGameResetSamplingProfiler(lua_State* L) {
+	// Game.resetSamplingProfiler()
+	g_samplingProfiler().reset();
+	pushBoolean(L, !g_samplingProfiler().isRunning());
+	return 1;
+}
+
+int GameFunctions::luaGameGetSamplingProfilerSamples(lua_State* L) {
+	// Game.getSamplingProfilerSamples()
+	lua_pushnumber(L, static_cast<lua_Number>(g_samplingProfiler().getSampleCount()));
+	lua_pushnumber(L, static_cast<lua_Number>(g_samplingProfiler().getDroppedCount()));
+	return 2;
+}
+
+int GameFunctions::luaGameDumpSamplingProfiler(lua_State* L) {
+	// Game.dumpSamplingProfiler(path)
+	pushBoolean(L, g_samplingProfiler().dump(getString(L, 1)));
+	return 1;
+}
+
+int GameFunctions::luaGameGetDispatcherReport(lua_State* L) {
+	// Game.getDispatcherReport([cycles = 0])
+	pushString(L, g_dispatcher().getFlightRecorder().getReport(getNumber<size_t>(L, 1, 0)));
+	return 1;
+}
+
+int GameFunctions::luaGameGetMemoryReport(lua_State* L) {
+	// Game.getMemoryReport()
+	pushString(L, g_game().getMemoryReport());
+	return 1;
+}
+
+int GameFunctions::luaGameGetTrafficReport(lua_State* L) {
+	// Game.getTrafficReport([playerName = ""[, limit = 20]])
+	pushString(L, g_game().getTrafficReport(getString(L, 1), getNumber<size_t>(L, 2, 20)));
+	return 1;
+}
+
 int GameFunctions::luaGameHasEffect(lua_State* L) {
 	// Game.hasEffect(effectId)
 	uint16_t effectId = getNumber<uint16_t>(L, 1);
@@ -20,6 +20,9 @@ public:
 		registerMethod(L, "Game", "createMonsterType", GameFunctions::luaGameCreateMonsterType);
 
 		registerMethod(L, "Game", "getSpectators", GameFunctions::luaGameGetSpectators);
+		registerMethod(L, "Game", "sendMagicEffects", GameFunctions::luaGameSendMagicEffects);
+		registerMethod(L, "Game", "addSpectatorsHealth", GameFunctions::luaGameAddSpectatorsHealth);
+		registerMethod(L, "Game", "teleportSpectators", GameFunctions::luaGameTeleportSpectators);
 
 		registerMethod(L, "Game", "getBoostedCreature", GameFunctions::luaGameGetBoostedCreature);
 		registerMethod(L, "Game", "getBestiaryList", GameFunctions::luaGameGetBestiaryList);
@@ -58,11 +61,26 @@ public:
 		registerMethod(L, "Game", "getBestiaryCharm", GameFunctions::luaGameGetBestiaryCharm);
 
 		registerMethod(L, "Game", "startRaid", GameFunctions::luaGameStartRaid);
+		registerMethod(L, "Game", "getRaidSchedule", GameFunctions::luaGameGetRaidSchedule);
 
 		registerMethod(L, "Game", "getClientVersion", GameFunctions::luaGameGetClientVersion);
 
 		registerMethod(L, "Game", "reload", GameFunctions::luaGameReload);
 
+		registerMethod(L, "Game", "startLuaProfiler", GameFunctions::luaGameStartLuaProfiler);
+		registerMethod(L, "Game", "stopLuaProfiler", GameFunctions::luaGameStopLuaProfiler);
+		registerMethod(L, "Game", "resetLuaProfiler", GameFunctions::luaGameResetLuaProfiler);
+		registerMethod(L, "Game", "getLuaProfilerReport", GameFunctions::luaGameGetLuaProfilerReport);
+		registerMethod(L, "Game", "dumpLuaProfiler", GameFunctions::luaGameDumpLuaProfiler);
+		registerMethod(L, "Game", "startSamplingProfiler", GameFunctions::luaGameStartSamplingProfiler);
+		registerMethod(L, "Game", "stopSamplingProfiler", GameFunctions::luaGameStopSamplingProfiler);
+		registerMethod(L, "Game", "resetSamplingProfiler", GameFunctions::luaGameResetSamplingProfiler);
+		registerMethod(L, "Game", "getSamplingProfilerSamples", GameFunctions::luaGameGetSamplingProfilerSamples);
+		registerMethod(L, "Game", "dumpSamplingProfiler", GameFunctions::luaGameDumpSamplingProfiler);
+		registerMethod(L, "Game", "getDispatcherReport", GameFunctions::luaGameGetDispatcherReport);
+		registerMethod(L, "Game", "getMemoryReport", GameFunctions::luaGameGetMemoryReport);
+		registerMethod(L, "Game", "getTrafficReport", GameFunctions::luaGameGetTrafficReport);
+
 		registerMethod(L, "Game", "hasDistanceEffect", GameFunctions::luaGameHasDistanceEffect);
 		registerMethod(L, "Game", "hasEffect", GameFunctions::luaGameHasEffect);
 		registerMethod(L, "Game", "getOfflinePlayer", GameFunctions::luaGameGetOfflinePlayer);
@@ -96,6 +114,9 @@ private:
 	static int luaGameCreateNpcType(lua_State* L);
 
 	static int luaGameGetSpectators(lua_State* L);
+	static int luaGameSendMagicEffects(lua_State* L);
+	static int luaGameAddSpectatorsHealth(lua_State* L);
+	static int luaGameTeleportSpectators(lua_State* L);
 
 	static int luaGameGetBoostedCreature(lua_State* L);
 	static int luaGameGetBestiaryList(lua_State* L);
@@ -134,11 +155,26 @@ private:
 	static int luaGameCreateItemClassification(lua_State* L);
 
 	static int luaGameStartRaid(lua_State* L);
+	static int luaGameGetRaidSchedule(lua_State* L);
 
 	static int luaGameGetClientVersion(lua_State* L);
 
 	static int luaGameReload(lua_State* L);
 
+	static int luaGameStartLuaProfiler(lua_State* L);
+	static int luaGameStopLuaProfiler(lua_State* L);
+	static int luaGameResetLuaProfiler(lua_State* L);
+	static int luaGameGetLuaProfilerReport(lua_State* L);
+	static int luaGameDumpLuaProfiler(lua_State* L);
+	static int luaGameStartSamplingProfiler(lua_State* L);
+	static int luaGameStopSamplingProfiler(lua_State* L);
+	static int luaGameResetSamplingProfiler(lua_State* L);
+	static int luaGameGetSamplingProfilerSamples(lua_State* L);
+	static int luaGameDumpSamplingProfiler(lua_State* L);
+	static int luaGameGetDispatcherReport(lua_State* L);
+	static int luaGameGetMemoryReport(lua_State* L);
+	static int luaGameGetTrafficReport(lua_State* L);
+
 	static int luaGameGetOfflinePlayer(lua_State* L);
 	static int luaGameGetNormalizedPlayerName(lua_State* L);
 	static int luaGameGetNormalizedGuildName(lua_State* L);
@@ -650,27 +650,25 @@ int GlobalFunctions::luaAddEvent(lua_State* L) {
 		}
 	}
 
+	uint32_t delay = std::max<uint32_t>(100, getNumber<uint32_t>(globalState, 2));
+
+	// The function and its parameters are kept in a single table, one registry reference per event
 	LuaTimerEventDesc eventDesc;
-	for (int i = 0; i < parameters - 2; ++i) { // -2 because addEvent needs at least two parameters
-		eventDesc.parameters.push_back(luaL_ref(globalState, LUA_REGISTRYINDEX));
+	eventDesc.parameterCount = parameters - 2; // -2 because addEvent needs at least two parameters
+	lua_createtable(globalState, parameters - 1, 0);
+	lua_pushvalue(globalState, 1);
+	lua_rawseti(globalState, -2, 1);
+	for (int i = 3; i <= parameters; ++i) {
+		lua_pushvalue(globalState, i);
+		lua_rawseti(globalState, -2, i - 1);
 	}
+	eventDesc.callback = luaL_ref(globalState, LUA_REGISTRYINDEX);
+	lua_pop(globalState, parameters);
 
-	uint32_t delay = std::max<uint32_t>(100, getNumber<uint32_t>(globalState, 2));
-	lua_pop(globalState, 1);
-
-	eventDesc.function = luaL_ref(globalState, LUA_REGISTRYINDEX);
 	eventDesc.scriptId = getScriptEnv()->getScriptId();
 	eventDesc.scriptName = getScriptEnv()->getScriptInterface()->getLoadingScriptName();
 
-	auto &lastTimerEventId = g_luaEnvironment().lastEventTimerId;
-	eventDesc.eventId = g_dispatcher().scheduleEvent(
-		delay,
-		[lastTimerEventId] { g_luaEnvironment().executeTimerEvent(lastTimerEventId); },
-		"LuaEnvironment::executeTimerEvent"
-	);
-
-	g_luaEnvironment().timerEvents.emplace(lastTimerEventId, std::move(eventDesc));
-	lua_pushnumber(L, lastTimerEventId++);
+	lua_pushnumber(L, g_luaEnvironment().getTimerEvents().add(std::move(eventDesc), delay));
 	return 1;
 }
 
@@ -684,25 +682,22 @@ int GlobalFunctions::luaStopEvent(lua_State* L) {
 	}
 
 	uint32_t eventId = getNumber<uint32_t>(L, 1);
+	pushBoolean(L, g_luaEnvironment().getTimerEvents().stop(eventId));
+	return 1;
+}
 
-	auto &timerEvents = g_luaEnvironment().timerEvents;
-	auto it = timerEvents.find(eventId);
-	if (it == timerEvents.end()) {
-		pushBoolean(L, false);
-		return 1;
-	}
-
-	LuaTimerEventDesc timerEventDesc = std::move(it->second);
-	timerEvents.erase(it);
-
-	g_dispatcher().stopEvent(timerEventDesc.eventId);
-	luaL_unref(globalState, LUA_REGISTRYINDEX, timerEventDesc.function);
-
-	for (auto parameter : timerEventDesc.parameters) {
-		luaL_unref(globalState, LUA_REGISTRYINDEX, parameter);
-	}
+int GlobalFunctions::luaSetEventOwner(lua_State* L) {
+	// setEventOwner(eventid, ownerId)
+	const uint32_t eventId = getNumber<uint32_t>(L, 1);
+	const uint32_t ownerId = getNumber<uint32_t>(L, 2);
+	pushBoolean(L, g_luaEnvironment().getTimerEvents().setOwner(eventId, ownerId));
+	return 1;
+}
 
-	pushBoolean(L, true);
+int GlobalFunctions::luaStopOwnerEvents(lua_State* L) {
+	// stopOwnerEvents(ownerId)
+	const uint32_t ownerId = getNumber<uint32_t>(L, 1);
+	lua_pushnumber(L, g_luaEnvironment().getTimerEvents().stopOwner(ownerId));
 	return 1;
 }
 
@@ -41,7 +41,9 @@ public:
 		lua_register(L, "saveServer", GlobalFunctions::luaSaveServer);
 		lua_register(L, "sendChannelMessage", GlobalFunctions::luaSendChannelMessage);
 		lua_register(L, "sendGuildChannelMessage", GlobalFunctions::luaSendGuildChannelMessage);
+		lua_register(L, "setEventOwner", GlobalFunctions::luaSetEventOwner);
 		lua_register(L, "stopEvent", GlobalFunctions::luaStopEvent);
+		lua_register(L, "stopOwnerEvents", GlobalFunctions::luaStopOwnerEvents);
 
 		registerGlobalVariable(L, "INDEX_WHEREEVER", INDEX_WHEREEVER);
 		registerGlobalBoolean(L, "VIRTUAL_PARENT", true);
@@ -81,7 +83,9 @@ private:
 	static int luaSaveServer(lua_State* L);
 	static int luaSendChannelMessage(lua_State* L);
 	static int luaSendGuildChannelMessage(lua_State* L);
+	static int luaSetEventOwner(lua_State* L);
 	static int luaStopEvent(lua_State* L);
+	static int luaStopOwnerEvents(lua_State* L);
 	static int luaIsType(lua_State* L);
 	static int luaRawGetMetatable(lua_State* L);
 	static int luaCreateTable(lua_State* L);
@@ -303,9 +303,9 @@ int ZoneFunctions::luaZoneGetByPosition(lua_State* L) {
 		return 1;
 	}
 	int index = 0;
-	auto zones = tile->getZones();
-	lua_createtable(L, static_cast<int>(zones.size()), 0);
-	for (auto zone : zones) {
+	const auto &zones = tile->getZones();
+	lua_createtable(L, static_cast<int>(zones->size()), 0);
+	for (const auto &zone : *zones) {
 		index++;
 		pushUserdata<Zone>(L, zone);
 		setMetatable(L, -1, "Zone");
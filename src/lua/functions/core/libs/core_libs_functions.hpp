@@ -12,6 +12,7 @@
 #include "lua/scripts/luascript.hpp"
 #include "lua/functions/core/libs/bit_functions.hpp"
 #include "lua/functions/core/libs/db_functions.hpp"
+#include "lua/functions/core/libs/ffi_functions.hpp"
 #include "lua/functions/core/libs/result_functions.hpp"
 #include "lua/functions/core/libs/logger_functions.hpp"
 #include "lua/functions/core/libs/metrics_functions.hpp"
@@ -22,6 +23,7 @@ public:
 	static void init(lua_State* L) {
 		BitFunctions::init(L);
 		DBFunctions::init(L);
+		FFIFunctions::init(L);
 		ResultFunctions::init(L);
 		LoggerFunctions::init(L);
 		MetricsFunctions::init(L);
@@ -0,0 +1,62 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lua/functions/core/libs/ffi_functions.hpp"
+
+#ifdef LUAJIT_VERSION
+	#include "game/game.hpp"
+	#include "lua/scripts/script_environment.hpp"
+
+	#ifdef _WIN32
+		#define CANARY_FFI_EXPORT extern "C" __declspec(dllexport)
+	#else
+		#define CANARY_FFI_EXPORT extern "C" __attribute__((visibility("default")))
+	#endif
+
+const char* const FFIFunctions::cdef = R"(
+	int canary_creature_get_position(uint32_t creatureId, uint16_t* position);
+	int canary_player_get_storage_value(uint32_t playerId, uint32_t key);
+	uint16_t canary_item_get_id(uint32_t uid);
+	int canary_tile_get_creature_count(uint16_t x, uint16_t y, uint8_t z);
+)";
+
+// Fills position with x, y and z, returns 0 when there is no such creature
+CANARY_FFI_EXPORT int canary_creature_get_position(uint32_t creatureId, uint16_t* position) {
+	const auto &creature = g_game().getCreatureByID(creatureId);
+	if (!creature) {
+		return 0;
+	}
+
+	const auto &pos = creature->getPosition();
+	position[0] = pos.x;
+	position[1] = pos.y;
+	position[2] = pos.z;
+	return 1;
+}
+
+// -1 when unset, like Player:getStorageValue, or when there is no such player
+CANARY_FFI_EXPORT int canary_player_get_storage_value(uint32_t playerId, uint32_t key) {
+	const auto &player = g_game().getPlayerByID(playerId);
+	return player ? player->getStorageValue(key) : -1;
+}
+
+// The uid is the one of Item:getUniqueId in the running script, 0 when not found
+CANARY_FFI_EXPORT uint16_t canary_item_get_id(uint32_t uid) {
+	const auto &item = LuaScriptInterface::getScriptEnv()->getItemByUID(uid);
+	return item ? item->getID() : 0;
+}
+
+// -1 when there is no tile
+CANARY_FFI_EXPORT int canary_tile_get_creature_count(uint16_t x, uint16_t y, uint8_t z) {
+	const auto &tile = g_game().map.getTile(x, y, z);
+	return tile ? static_cast<int>(tile->getCreatureCount()) : -1;
+}
+#endif
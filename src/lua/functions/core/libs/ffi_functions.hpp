@@ -0,0 +1,33 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "lua/scripts/luascript.hpp"
+
+/**
+ * Plain C entrypoints of hot getters, taking creature ids, item uids and
+ * positions instead of userdata. LuaJIT scripts call them through the FFI
+ * (data/libs/functions/fast_path.lua), which the JIT compiles into the trace
+ * where a Lua C API call would abort it.
+ */
+class FFIFunctions final : LuaScriptInterface {
+public:
+	static void init(lua_State* L) {
+#ifdef LUAJIT_VERSION
+		registerGlobalString(L, "FFI_FAST_PATH_CDEF", cdef);
+#endif
+	}
+
+private:
+#ifdef LUAJIT_VERSION
+	// Declarations of the entrypoints for ffi.cdef, kept next to their definitions
+	static const char* const cdef;
+#endif
+};
@@ -1000,9 +1000,9 @@ int CreatureFunctions::luaCreatureGetZones(lua_State* L) {
 	}
 
 	const auto zones = creature->getZones();
-	lua_createtable(L, static_cast<int>(zones.size()), 0);
+	lua_createtable(L, static_cast<int>(zones->size()), 0);
 	int index = 0;
-	for (auto zone : zones) {
+	for (const auto &zone : *zones) {
 		index++;
 		pushUserdata<Zone>(L, zone);
 		setMetatable(L, -1, "Zone");
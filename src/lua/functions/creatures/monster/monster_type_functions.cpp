@@ -22,7 +22,7 @@ void MonsterTypeFunctions::createMonsterTypeLootLuaTable(lua_State* L, const std
 
 	int index = 0;
 	for (const auto &lootBlock : lootList) {
-		lua_createtable(L, 0, 8);
+		lua_createtable(L, 0, 12);
 
 		setField(L, "itemId", lootBlock.id);
 		setField(L, "chance", lootBlock.chance);
@@ -34,6 +34,14 @@ void MonsterTypeFunctions::createMonsterTypeLootLuaTable(lua_State* L, const std
 		pushBoolean(L, lootBlock.unique);
 		lua_setfield(L, -2, "unique");
 
+		// Resolved here, so rolling the loot needs no ItemType per entry
+		const ItemType &itemType = Item::items[lootBlock.id];
+		setField(L, "charges", itemType.charges);
+		pushBoolean(L, itemType.stackable);
+		lua_setfield(L, -2, "stackable");
+		pushBoolean(L, itemType.type == ITEM_TYPE_CREATUREPRODUCT);
+		lua_setfield(L, -2, "creatureProduct");
+
 		createMonsterTypeLootLuaTable(L, lootBlock.childLoot);
 		lua_setfield(L, -2, "childLoot");
 
@@ -514,6 +522,7 @@ int MonsterTypeFunctions::luaMonsterTypeRaceid(lua_State* L) {
 		} else {
 			monsterType->info.raceid = getNumber<uint16_t>(L, 2);
 			g_game().addBestiaryList(getNumber<uint16_t>(L, 2), monsterType->name);
+			g_monsters().addRaceId(monsterType->info.raceid, monsterType);
 			pushBoolean(L, true);
 		}
 	} else {
@@ -819,7 +828,9 @@ int MonsterTypeFunctions::luaMonsterTypeAddAttack(lua_State* L) {
 		if (spell) {
 			spellBlock_t sb;
 			if (g_monsters().deserializeSpell(spell, sb, monsterType->name)) {
-				monsterType->info.attackSpells.push_back(std::move(sb));
+				auto &info = monsterType->info;
+				info.attackSpellsMinSpeed = info.attackSpells.empty() ? sb.speed : std::min(info.attackSpellsMinSpeed, sb.speed);
+				info.attackSpells.push_back(std::move(sb));
 			} else {
 				g_logger().warn("Monster: {}, cant load spell: {}", monsterType->name, spell->name);
 			}
@@ -1605,6 +1616,7 @@ int MonsterTypeFunctions::luaMonsterTypeBossRaceId(lua_State* L) {
 		auto raceId = getNumber<uint16_t>(L, 2, 0);
 		monsterType->info.raceid = raceId;
 		g_ioBosstiary().addBosstiaryMonster(raceId, monsterType->typeName);
+		g_monsters().addBossRaceId(raceId, monsterType);
 		pushBoolean(L, true);
 	}
 
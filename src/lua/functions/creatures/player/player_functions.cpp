@@ -338,11 +338,10 @@ int PlayerFunctions::luaPlayerIsMonsterBestiaryUnlocked(lua_State* L) {
 		return 0;
 	}
 
-	for (uint16_t finishedRaceId : g_iobestiary().getBestiaryFinished(player)) {
-		if (raceId == finishedRaceId) {
-			pushBoolean(L, true);
-			return 1;
-		}
+	const auto &finished = g_iobestiary().getBestiaryProgress(player).finished;
+	if (std::ranges::binary_search(finished, raceId)) {
+		pushBoolean(L, true);
+		return 1;
 	}
 
 	pushBoolean(L, false);
@@ -3037,16 +3036,16 @@ int PlayerFunctions::luaPlayerSetGhostMode(lua_State* L) {
 	}
 
 	if (player->isInGhostMode()) {
-		for (const auto &it : g_game().getPlayers()) {
-			if (!it.second->isAccessPlayer()) {
-				it.second->vip()->notifyStatusChange(player, VipStatus_t::Offline);
+		for (const auto &watcher : PlayerVIP::getOnlineWatchers(player->getGUID())) {
+			if (!watcher->isAccessPlayer()) {
+				watcher->vip()->notifyStatusChange(player, VipStatus_t::Offline);
 			}
 		}
 		IOLoginData::updateOnlineStatus(player->getGUID(), false);
 	} else {
-		for (const auto &it : g_game().getPlayers()) {
-			if (!it.second->isAccessPlayer()) {
-				it.second->vip()->notifyStatusChange(player, player->vip()->getStatus());
+		for (const auto &watcher : PlayerVIP::getOnlineWatchers(player->getGUID())) {
+			if (!watcher->isAccessPlayer()) {
+				watcher->vip()->notifyStatusChange(player, player->vip()->getStatus());
 			}
 		}
 		IOLoginData::updateOnlineStatus(player->getGUID(), true);
@@ -168,6 +168,7 @@ int ActionFunctions::luaActionPosition(lua_State* L) {
 		ItemType &itemType = Item::items.getItemType(itemId);
 		if (itemType.movable == true) {
 			itemType.movable = false;
+			Item::items.updateFlags(itemId);
 		}
 
 		g_game().setCreateLuaItems(position, itemId);
@@ -164,3 +164,16 @@ int GlobalEventFunctions::luaGlobalEventInterval(lua_State* L) {
 	}
 	return 1;
 }
+
+int GlobalEventFunctions::luaGlobalEventResumable(lua_State* L) {
+	// globalevent:resumable(resumable)
+	// The callback runs as a coroutine, coroutine.yield() pauses it until the next dispatcher cycle
+	const auto globalevent = getUserdataShared<GlobalEvent>(L, 1);
+	if (globalevent) {
+		globalevent->setResumable(getBoolean(L, 2, true));
+		pushBoolean(L, true);
+	} else {
+		lua_pushnil(L);
+	}
+	return 1;
+}
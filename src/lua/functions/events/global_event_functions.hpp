@@ -19,6 +19,7 @@ public:
 		registerMethod(L, "GlobalEvent", "register", GlobalEventFunctions::luaGlobalEventRegister);
 		registerMethod(L, "GlobalEvent", "time", GlobalEventFunctions::luaGlobalEventTime);
 		registerMethod(L, "GlobalEvent", "interval", GlobalEventFunctions::luaGlobalEventInterval);
+		registerMethod(L, "GlobalEvent", "resumable", GlobalEventFunctions::luaGlobalEventResumable);
 		registerMethod(L, "GlobalEvent", "onThink", GlobalEventFunctions::luaGlobalEventOnCallback);
 		registerMethod(L, "GlobalEvent", "onTime", GlobalEventFunctions::luaGlobalEventOnCallback);
 		registerMethod(L, "GlobalEvent", "onStartup", GlobalEventFunctions::luaGlobalEventOnCallback);
@@ -35,4 +36,5 @@ private:
 	static int luaGlobalEventOnCallback(lua_State* L);
 	static int luaGlobalEventTime(lua_State* L);
 	static int luaGlobalEventInterval(lua_State* L);
+	static int luaGlobalEventResumable(lua_State* L);
 };
@@ -31,11 +31,28 @@
 
 class LuaScriptInterface;
 
+namespace {
+	// Registry references of the class metatables of the current state, taken when
+	// the classes are registered, so a push does not look its metatable up by name
+	phmap::flat_hash_map<std::string, int32_t> metatableRefs;
+
+	void pushMetatable(lua_State* L, const std::string &name) {
+		if (const auto it = metatableRefs.find(name); it != metatableRefs.end()) {
+			lua_rawgeti(L, LUA_REGISTRYINDEX, it->second);
+		} else {
+			luaL_getmetatable(L, name.c_str());
+		}
+	}
+}
+
 void LuaFunctionsLoader::load(lua_State* L) {
 	if (!L) {
 		g_game().dieSafely("Invalid lua state, cannot load lua functions.");
 	}
 
+	// References of a closed state mean nothing in the new one
+	metatableRefs.clear();
+
 	luaL_openlibs(L);
 
 	CoreFunctions::init(L);
@@ -268,21 +285,21 @@ void LuaFunctionsLoader::setMetatable(lua_State* L, int32_t index, const std::st
 		return;
 	}
 
-	luaL_getmetatable(L, name.c_str());
+	pushMetatable(L, name);
 	lua_setmetatable(L, index - 1);
 }
 
 void LuaFunctionsLoader::setWeakMetatable(lua_State* L, int32_t index, const std::string &name) {
-	static phmap::flat_hash_set<std::string> weakObjectTypes;
 	if (validateDispatcherContext(__FUNCTION__)) {
 		return;
 	}
 
 	const std::string &weakName = name + "_weak";
 
-	auto result = weakObjectTypes.emplace(name);
-	if (result.second) {
-		luaL_getmetatable(L, name.c_str());
+	if (const auto it = metatableRefs.find(weakName); it != metatableRefs.end()) {
+		lua_rawgeti(L, LUA_REGISTRYINDEX, it->second);
+	} else {
+		pushMetatable(L, name);
 		int childMetatable = lua_gettop(L);
 
 		luaL_newmetatable(L, weakName.c_str());
@@ -304,8 +321,9 @@ void LuaFunctionsLoader::setWeakMetatable(lua_State* L, int32_t index, const std
 		lua_setfield(L, metatable, "__gc");
 
 		lua_remove(L, childMetatable);
-	} else {
-		luaL_getmetatable(L, weakName.c_str());
+
+		lua_pushvalue(L, -1);
+		metatableRefs[weakName] = luaL_ref(L, LUA_REGISTRYINDEX);
 	}
 	lua_setmetatable(L, index - 1);
 }
@@ -316,11 +334,11 @@ void LuaFunctionsLoader::setItemMetatable(lua_State* L, int32_t index, std::shar
 	}
 
 	if (item && item->getContainer()) {
-		luaL_getmetatable(L, "Container");
+		pushMetatable(L, "Container");
 	} else if (item && item->getTeleport()) {
-		luaL_getmetatable(L, "Teleport");
+		pushMetatable(L, "Teleport");
 	} else {
-		luaL_getmetatable(L, "Item");
+		pushMetatable(L, "Item");
 	}
 	lua_setmetatable(L, index - 1);
 }
@@ -331,11 +349,11 @@ void LuaFunctionsLoader::setCreatureMetatable(lua_State* L, int32_t index, std::
 	}
 
 	if (creature && creature->getPlayer()) {
-		luaL_getmetatable(L, "Player");
+		pushMetatable(L, "Player");
 	} else if (creature && creature->getMonster()) {
-		luaL_getmetatable(L, "Monster");
+		pushMetatable(L, "Monster");
 	} else {
-		luaL_getmetatable(L, "Npc");
+		pushMetatable(L, "Npc");
 	}
 	lua_setmetatable(L, index - 1);
 }
@@ -698,6 +716,10 @@ void LuaFunctionsLoader::registerClass(lua_State* L, const std::string &classNam
 	}
 	lua_rawseti(L, metatable, 't');
 
+	// Pushed by reference from now on
+	lua_pushvalue(L, metatable);
+	metatableRefs[className] = luaL_ref(L, LUA_REGISTRYINDEX);
+
 	// pop className, className.metatable
 	lua_pop(L, 2);
 }
@@ -720,7 +742,7 @@ void LuaFunctionsLoader::registerTable(lua_State* L, const std::string &tableNam
 
 void LuaFunctionsLoader::registerMetaMethod(lua_State* L, const std::string &className, const std::string &methodName, lua_CFunction func) {
 	// className.metatable.methodName = func
-	luaL_getmetatable(L, className.c_str());
+	pushMetatable(L, className);
 	lua_pushcfunction(L, func);
 	lua_setfield(L, -2, methodName.c_str());
 
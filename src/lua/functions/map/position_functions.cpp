@@ -137,7 +137,7 @@ int PositionFunctions::luaPositionGetZones(lua_State* L) {
 		return 1;
 	}
 	int index = 0;
-	for (auto zone : tile->getZones()) {
+	for (const auto &zone : *tile->getZones()) {
 		index++;
 		pushUserdata<Zone>(L, zone);
 		setMetatable(L, -1, "Zone");
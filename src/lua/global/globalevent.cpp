@@ -30,6 +30,23 @@ void GlobalEvents::clear() {
 	timerMap.clear();
 }
 
+void GlobalEvents::clearScriptFile(const std::string &file) {
+	const auto ownedBy = [&file](const auto &entry) { return entry.second->getScriptFile() == file; };
+	std::erase_if(thinkMap, ownedBy);
+	std::erase_if(serverMap, ownedBy);
+	std::erase_if(timerMap, ownedBy);
+
+	// Scheduled again soon, for the events left and the ones the file registers when it runs again
+	g_dispatcher().stopEvent(thinkEventId);
+	thinkEventId = g_dispatcher().scheduleEvent(
+		SCHEDULER_MINTICKS, [this] { think(); }, "GlobalEvents::think"
+	);
+	g_dispatcher().stopEvent(timerEventId);
+	timerEventId = g_dispatcher().scheduleEvent(
+		SCHEDULER_MINTICKS, [this] { timer(); }, "GlobalEvents::timer"
+	);
+}
+
 bool GlobalEvents::registerLuaEvent(const std::shared_ptr<GlobalEvent> globalEvent) {
 	if (globalEvent->getEventType() == GLOBALEVENT_TIMER) {
 		auto result = timerMap.emplace(globalEvent->getName(), globalEvent);
@@ -269,5 +286,9 @@ bool GlobalEvent::executeEvent() const {
 		params = 1;
 	}
 
+	// A long running event may yield and go on in the next dispatcher cycles
+	if (resumable) {
+		return getScriptInterface()->callResumableFunction(params);
+	}
 	return getScriptInterface()->callFunction(params);
 }
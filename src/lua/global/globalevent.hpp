@@ -40,6 +40,7 @@ public:
 
 	bool registerLuaEvent(const std::shared_ptr<GlobalEvent> globalEvent);
 	void clear();
+	void clearScriptFile(const std::string &file);
 
 private:
 	GlobalEventMap thinkMap, serverMap, timerMap;
@@ -83,6 +84,13 @@ public:
 		nextExecution = time;
 	}
 
+	bool isResumable() const {
+		return resumable;
+	}
+	void setResumable(bool value) {
+		resumable = value;
+	}
+
 private:
 	GlobalEvent_t eventType = GLOBALEVENT_NONE;
 
@@ -91,4 +99,5 @@ private:
 	std::string name;
 	int64_t nextExecution = 0;
 	uint32_t interval = 0;
+	bool resumable = false;
 };
@@ -11,17 +11,19 @@
 
 #ifndef USE_PRECOMPILED_HEADERS
 	#include <cstdint>
-	#include <list>
 	#include <string>
 #endif
 
 struct LuaTimerEventDesc {
 	int32_t scriptId = -1;
 	std::string scriptName;
-	int32_t function = -1;
-	std::list<int32_t> parameters;
-	uint32_t eventId = 0;
+	// Registry reference of a table with the function and then its parameters
+	int32_t callback = -1;
+	int32_t parameterCount = 0;
+	int64_t dueTime = 0;
+	uint32_t ownerId = 0;
 
 	LuaTimerEventDesc() = default;
 	LuaTimerEventDesc(LuaTimerEventDesc &&other) = default;
+	LuaTimerEventDesc &operator=(LuaTimerEventDesc &&other) = default;
 };
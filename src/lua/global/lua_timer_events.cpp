@@ -0,0 +1,161 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lua/global/lua_timer_events.hpp"
+#include "lua/scripts/lua_environment.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "utils/tools.hpp"
+
+namespace {
+	// Rounded up, an event never runs before its time
+	int64_t getTick(int64_t time) {
+		return (time + SCHEDULER_MINTICKS - 1) / SCHEDULER_MINTICKS;
+	}
+}
+
+uint32_t LuaTimerEvents::add(LuaTimerEventDesc &&event, uint32_t delay) {
+	const auto now = OTSYS_TIME();
+	event.dueTime = now + delay;
+
+	const auto tick = getTick(event.dueTime);
+	auto &tickEvents = ticks[tick];
+	if (tickEvents.pending == 0) {
+		tickEvents.taskId = g_dispatcher().scheduleEvent(
+			static_cast<uint32_t>(tick * SCHEDULER_MINTICKS - now),
+			[this, tick] { executeTick(tick); },
+			"LuaEnvironment::executeTimerEvent"
+		);
+	}
+
+	const auto eventId = lastEventId++;
+	tickEvents.events.emplace_back(eventId);
+	++tickEvents.pending;
+
+	if (event.ownerId != 0) {
+		owners[event.ownerId].emplace_back(eventId);
+	}
+	events.emplace(eventId, std::move(event));
+	return eventId;
+}
+
+bool LuaTimerEvents::stop(uint32_t eventId) {
+	const auto event = take(eventId);
+	if (!event) {
+		return false;
+	}
+
+	// The task of a tick is no longer needed once all its events are stopped
+	if (const auto it = ticks.find(getTick(event->dueTime)); it != ticks.end() && --it->second.pending == 0) {
+		g_dispatcher().stopEvent(it->second.taskId);
+		ticks.erase(it);
+	}
+
+	release(*event);
+	return true;
+}
+
+size_t LuaTimerEvents::stopOwner(uint32_t ownerId) {
+	const auto it = owners.find(ownerId);
+	if (it == owners.end()) {
+		return 0;
+	}
+
+	const auto eventIds = std::move(it->second);
+	owners.erase(it);
+
+	size_t stopped = 0;
+	for (const auto eventId : eventIds) {
+		if (stop(eventId)) {
+			++stopped;
+		}
+	}
+	return stopped;
+}
+
+bool LuaTimerEvents::setOwner(uint32_t eventId, uint32_t ownerId) {
+	const auto it = events.find(eventId);
+	if (it == events.end()) {
+		return false;
+	}
+
+	auto &event = it->second;
+	if (event.ownerId != 0) {
+		if (const auto ownerIt = owners.find(event.ownerId); ownerIt != owners.end()) {
+			std::erase(ownerIt->second, eventId);
+		}
+	}
+
+	event.ownerId = ownerId;
+	if (ownerId != 0) {
+		owners[ownerId].emplace_back(eventId);
+	}
+	return true;
+}
+
+void LuaTimerEvents::clear() {
+	for (const auto &[tick, tickEvents] : ticks) {
+		g_dispatcher().stopEvent(tickEvents.taskId);
+	}
+
+	events.clear();
+	ticks.clear();
+	owners.clear();
+}
+
+void LuaTimerEvents::executeTick(int64_t tick) {
+	const auto it = ticks.find(tick);
+	if (it == ticks.end()) {
+		return;
+	}
+
+	// Taken out first, the events may add others to new ticks
+	auto eventIds = std::move(it->second.events);
+	ticks.erase(it);
+
+	// Same order as one task per event would have
+	std::ranges::stable_sort(eventIds, {}, [this](uint32_t eventId) {
+		const auto eventIt = events.find(eventId);
+		return eventIt != events.end() ? eventIt->second.dueTime : 0;
+	});
+
+	for (const auto eventId : eventIds) {
+		// Taken one at a time, an event may stop the ones after it
+		if (auto event = take(eventId)) {
+			g_luaEnvironment().executeTimerEvent(*event);
+		}
+	}
+}
+
+std::optional<LuaTimerEventDesc> LuaTimerEvents::take(uint32_t eventId) {
+	const auto it = events.find(eventId);
+	if (it == events.end()) {
+		return std::nullopt;
+	}
+
+	LuaTimerEventDesc event = std::move(it->second);
+	events.erase(it);
+
+	if (event.ownerId != 0) {
+		if (const auto ownerIt = owners.find(event.ownerId); ownerIt != owners.end()) {
+			std::erase(ownerIt->second, eventId);
+			if (ownerIt->second.empty()) {
+				owners.erase(ownerIt);
+			}
+		}
+	}
+	return event;
+}
+
+void LuaTimerEvents::release(const LuaTimerEventDesc &event) {
+	if (lua_State* L = g_luaEnvironment().getLuaState()) {
+		luaL_unref(L, LUA_REGISTRYINDEX, event.callback);
+	}
+}
@@ -0,0 +1,61 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "lua/global/lua_timer_event_descr.hpp"
+
+/**
+ * Timer events scheduled by the scripts (addEvent).
+ *
+ * The events due in the same scheduler tick share one dispatcher task, which
+ * runs them by due time. An event may have an owner, usually a creature id,
+ * so all the events of that owner can be stopped at once.
+ */
+class LuaTimerEvents {
+public:
+	LuaTimerEvents() = default;
+
+	// non-copyable
+	LuaTimerEvents(const LuaTimerEvents &) = delete;
+	LuaTimerEvents &operator=(const LuaTimerEvents &) = delete;
+
+	/**
+	 * @brief Schedules an event, its callback reference is released by run or stop.
+	 * @return The id of the event for stop.
+	 */
+	uint32_t add(LuaTimerEventDesc &&event, uint32_t delay);
+
+	bool stop(uint32_t eventId);
+	size_t stopOwner(uint32_t ownerId);
+	bool setOwner(uint32_t eventId, uint32_t ownerId);
+
+	// Stops everything without touching the Lua state, which is about to be closed
+	void clear();
+
+	size_t size() const {
+		return events.size();
+	}
+
+private:
+	struct Tick {
+		uint64_t taskId = 0;
+		std::vector<uint32_t> events;
+		size_t pending = 0;
+	};
+
+	void executeTick(int64_t tick);
+	std::optional<LuaTimerEventDesc> take(uint32_t eventId);
+	static void release(const LuaTimerEventDesc &event);
+
+	phmap::flat_hash_map<uint32_t, LuaTimerEventDesc> events;
+	phmap::flat_hash_map<int64_t, Tick> ticks;
+	phmap::flat_hash_map<uint32_t, std::vector<uint32_t>> owners;
+	uint32_t lastEventId = 1;
+};
@@ -72,6 +72,8 @@ enum CreatureEventType_t {
 	CREATURE_EVENT_MANACHANGE,
 	// Otclient additional network opcodes.
 	CREATURE_EVENT_EXTENDED_OPCODE,
+
+	CREATURE_EVENT_LAST,
 };
 
 enum MoveEvent_t {
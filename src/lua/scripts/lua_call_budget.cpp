@@ -0,0 +1,97 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lua/scripts/lua_call_budget.hpp"
+#include "config/configmanager.hpp"
+#include "lua/scripts/luascript.hpp"
+
+bool LuaCallBudget::active = false;
+bool LuaCallBudget::reported = false;
+int64_t LuaCallBudget::startMs = 0;
+int64_t LuaCallBudget::budgetMs = 0;
+
+namespace {
+	int64_t getTimeMs() {
+		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	std::string getScriptName() {
+		int32_t scriptId;
+		int32_t callbackId;
+		bool timerEvent;
+		LuaScriptInterface* scriptInterface;
+		LuaScriptInterface::getScriptEnv()->getEventInfo(scriptId, scriptInterface, callbackId, timerEvent);
+		if (!scriptInterface || scriptId == EVENT_ID_USER) {
+			return "unknown";
+		}
+		return fmt::format("{} ({})", scriptInterface->getFileById(scriptId), timerEvent ? "timer" : scriptInterface->getInterfaceName());
+	}
+}
+
+LuaCallBudget::Scope::Scope(lua_State* L, Type type) {
+	// Nested calls count in the budget of the outermost one
+	if (active) {
+		return;
+	}
+
+	ConfigKey_t key = LUA_CALL_BUDGET;
+	if (type == Type::TimerEvent) {
+		key = LUA_TIMER_EVENT_CALL_BUDGET;
+	} else if (type == Type::GlobalEvent) {
+		key = LUA_GLOBALEVENT_CALL_BUDGET;
+	}
+	budgetMs = g_configManager().getNumber(key, __FUNCTION__);
+	if (budgetMs <= 0) {
+		return;
+	}
+
+	this->L = L;
+	active = true;
+	reported = false;
+	startMs = getTimeMs();
+	lua_sethook(L, hook, LUA_MASKCOUNT, HOOK_INSTRUCTIONS);
+}
+
+LuaCallBudget::Scope::~Scope() {
+	if (!L) {
+		return;
+	}
+
+	lua_sethook(L, nullptr, 0, 0);
+	active = false;
+
+	const auto elapsedMs = getTimeMs() - startMs;
+	if (!reported && elapsedMs > budgetMs) {
+		report(elapsedMs, "on return");
+	}
+}
+
+void LuaCallBudget::hook(lua_State* L, lua_Debug* ar) {
+	if (reported) {
+		return;
+	}
+
+	const auto elapsedMs = getTimeMs() - startMs;
+	if (elapsedMs <= budgetMs) {
+		return;
+	}
+
+	reported = true;
+	if (lua_getinfo(L, "Sl", ar) != 0) {
+		report(elapsedMs, fmt::format("near {}:{}", ar->short_src, ar->currentline));
+	} else {
+		report(elapsedMs, "at an unknown line");
+	}
+}
+
+void LuaCallBudget::report(int64_t elapsedMs, const std::string &where) {
+	g_logger().warn("[LuaCallBudget] - Script {} ran for {} ms, over its budget of {} ms, {}", getScriptName(), elapsedMs, budgetMs, where);
+}
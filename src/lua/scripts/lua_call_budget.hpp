@@ -0,0 +1,51 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Time budget of the Lua callbacks called by the engine.
+ *
+ * While the outermost callback runs, a count hook checks every few thousand
+ * instructions whether it went over the budget of its type and logs the
+ * script and the line it is at, once per call. Callbacks that spend their
+ * time in the engine, or in code compiled by LuaJIT where count hooks do not
+ * run, are reported when they return. Only used from the dispatcher thread.
+ */
+class LuaCallBudget {
+public:
+	enum class Type : uint8_t {
+		Callback,
+		TimerEvent,
+		GlobalEvent,
+	};
+
+	class Scope {
+	public:
+		Scope(lua_State* L, Type type);
+		~Scope();
+
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+	private:
+		lua_State* L = nullptr;
+	};
+
+private:
+	static void hook(lua_State* L, lua_Debug* ar);
+	static void report(int64_t elapsedMs, const std::string &where);
+
+	static constexpr int HOOK_INSTRUCTIONS = 10000;
+
+	static bool active;
+	static bool reported;
+	static int64_t startMs;
+	static int64_t budgetMs;
+};
@@ -14,6 +14,7 @@
 #include "lua/functions/lua_functions_loader.hpp"
 #include "lua/scripts/script_environment.hpp"
 #include "lua/global/lua_timer_event_descr.hpp"
+#include "lib/metrics/metrics.hpp"
 
 bool LuaEnvironment::shuttingDown = false;
 
@@ -69,14 +70,6 @@ bool LuaEnvironment::closeState() {
 		clearAreaObjects(areaEntry.first);
 	}
 
-	for (auto &timerEntry : timerEvents) {
-		LuaTimerEventDesc timerEventDesc = std::move(timerEntry.second);
-		for (int32_t parameter : timerEventDesc.parameters) {
-			luaL_unref(luaState, LUA_REGISTRYINDEX, parameter);
-		}
-		luaL_unref(luaState, LUA_REGISTRYINDEX, timerEventDesc.function);
-	}
-
 	combatIdMap.clear();
 	areaIdMap.clear();
 	timerEvents.clear();
@@ -149,29 +142,21 @@ void LuaEnvironment::clearAreaObjects(LuaScriptInterface* interface) {
 	it->second.clear();
 }
 
-void LuaEnvironment::executeTimerEvent(uint32_t eventIndex) {
-	auto it = timerEvents.find(eventIndex);
-	if (it == timerEvents.end()) {
-		return;
-	}
-
-	LuaTimerEventDesc timerEventDesc = std::move(it->second);
-	timerEvents.erase(it);
-
-	// push function
-	lua_rawgeti(luaState, LUA_REGISTRYINDEX, timerEventDesc.function);
-
-	// push parameters
-	for (auto parameter : std::views::reverse(timerEventDesc.parameters)) {
-		lua_rawgeti(luaState, LUA_REGISTRYINDEX, parameter);
+void LuaEnvironment::executeTimerEvent(const LuaTimerEventDesc &timerEventDesc) {
+	// push function and parameters
+	lua_rawgeti(luaState, LUA_REGISTRYINDEX, timerEventDesc.callback);
+	const int callbackIndex = lua_gettop(luaState);
+	for (int32_t i = 1; i <= timerEventDesc.parameterCount + 1; ++i) {
+		lua_rawgeti(luaState, callbackIndex, i);
 	}
+	lua_remove(luaState, callbackIndex);
 
 	// call the function
 	if (reserveScriptEnv()) {
 		ScriptEnvironment* env = getScriptEnv();
 		env->setTimerEvent();
 		env->setScriptId(timerEventDesc.scriptId, this);
-		callFunction(timerEventDesc.parameters.size());
+		callFunction(timerEventDesc.parameterCount);
 	} else {
 		g_logger().error("[LuaEnvironment::executeTimerEvent - Lua file {}] "
 		                 "Call stack overflow. Too many lua script calls being nested",
@@ -179,24 +164,59 @@ void LuaEnvironment::executeTimerEvent(uint32_t eventIndex) {
 	}
 
 	// free resources
-	luaL_unref(luaState, LUA_REGISTRYINDEX, timerEventDesc.function);
-	for (auto parameter : timerEventDesc.parameters) {
-		luaL_unref(luaState, LUA_REGISTRYINDEX, parameter);
-	}
+	luaL_unref(luaState, LUA_REGISTRYINDEX, timerEventDesc.callback);
 }
 
-void LuaEnvironment::collectGarbage() const {
+void LuaEnvironment::collectGarbage() {
 	// prevents recursive collects
 	static bool collecting = false;
 	if (!collecting) {
 		collecting = true;
 
-		// we must collect two times because __gc metamethod
-		// is called on uservalues only the second time
-		for (int i = -1; ++i < 2;) {
-			lua_gc(luaState, LUA_GCCOLLECT, 0);
+		{
+			metrics::gc_latency measure("collect");
+			// we must collect two times because __gc metamethod
+			// is called on uservalues only the second time
+			for (int i = -1; ++i < 2;) {
+				lua_gc(luaState, LUA_GCCOLLECT, 0);
+			}
 		}
 
+		heapKbAfterCycle = lua_gc(luaState, LUA_GCCOUNT, 0);
+		exportHeapSize();
 		collecting = false;
 	}
 }
+
+void LuaEnvironment::stepGarbage(std::chrono::milliseconds budget, int stepKb) {
+	if (!luaState || budget.count() <= 0) {
+		return;
+	}
+
+	// Nothing worth a new cycle yet, the automatic collector still runs if the heap outgrows it
+	const int64_t heapKb = lua_gc(luaState, LUA_GCCOUNT, 0);
+	if (heapKb < heapKbAfterCycle + heapKbAfterCycle / 2) {
+		return;
+	}
+
+	const auto deadline = std::chrono::steady_clock::now() + budget;
+	{
+		metrics::gc_latency measure("step");
+		do {
+			if (lua_gc(luaState, LUA_GCSTEP, stepKb) != 0) {
+				heapKbAfterCycle = lua_gc(luaState, LUA_GCCOUNT, 0);
+				break;
+			}
+		} while (std::chrono::steady_clock::now() < deadline);
+	}
+
+	exportHeapSize();
+}
+
+void LuaEnvironment::exportHeapSize() {
+	const int64_t heapKb = lua_gc(luaState, LUA_GCCOUNT, 0);
+	if (heapKb != exportedHeapKb) {
+		g_metrics().addUpDownCounter("lua_heap_kb", static_cast<int>(heapKb - exportedHeapKb));
+		exportedHeapKb = heapKb;
+	}
+}
@@ -14,7 +14,7 @@
 #include "lua/scripts/luascript.hpp"
 #include "items/weapons/weapons.hpp"
 
-#include "lua/global/lua_timer_event_descr.hpp"
+#include "lua/global/lua_timer_events.hpp"
 
 class AreaCombat;
 class Combat;
@@ -84,13 +84,23 @@ public:
 		return shuttingDown;
 	}
 
-	void collectGarbage() const;
+	LuaTimerEvents &getTimerEvents() {
+		return timerEvents;
+	}
+
+	void collectGarbage();
+
+	/**
+	 * @brief Advances the incremental collector in slices of stepKb, for up to budget.
+	 * Once a cycle is done it waits for the heap to grow by half before starting the next one.
+	 */
+	void stepGarbage(std::chrono::milliseconds budget, int stepKb);
 
 private:
-	void executeTimerEvent(uint32_t eventIndex);
+	void executeTimerEvent(const LuaTimerEventDesc &timerEventDesc);
+	void exportHeapSize();
 
-	phmap::flat_hash_map<uint32_t, LuaTimerEventDesc> timerEvents;
-	uint32_t lastEventTimerId = 1;
+	LuaTimerEvents timerEvents;
 
 	phmap::flat_hash_map<uint32_t, std::unique_ptr<AreaCombat>> areaMap;
 	phmap::flat_hash_map<LuaScriptInterface*, std::vector<uint32_t>> areaIdMap;
@@ -106,9 +116,13 @@ private:
 
 	LuaScriptInterface* testInterface = nullptr;
 
+	int64_t heapKbAfterCycle = 0;
+	int64_t exportedHeapKb = 0;
+
 	friend class LuaScriptInterface;
 	friend class GlobalFunctions;
 	friend class CombatSpell;
+	friend class LuaTimerEvents;
 };
 
 constexpr auto g_luaEnvironment = LuaEnvironment::getInstance;
@@ -0,0 +1,164 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lua/scripts/lua_profiler.hpp"
+#include "lib/di/container.hpp"
+#include "lua/scripts/luascript.hpp"
+
+namespace {
+	int64_t getTimeNs() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Sources are "@path/to/file.lua", both are kept from the datapack folder on
+	std::string_view trimSource(std::string_view source) {
+		if (!source.empty() && source.front() == '@') {
+			source.remove_prefix(1);
+		}
+		if (const auto pos = source.find("data"); pos != std::string_view::npos) {
+			source.remove_prefix(pos);
+		}
+		return source;
+	}
+}
+
+LuaProfiler &LuaProfiler::getInstance() {
+	return inject<LuaProfiler>();
+}
+
+void LuaProfiler::start() {
+	running = true;
+}
+
+void LuaProfiler::stop() {
+	running = false;
+	frames.clear();
+}
+
+void LuaProfiler::reset() {
+	entries.clear();
+}
+
+int64_t LuaProfiler::getHeapBytes(lua_State* L) {
+	return static_cast<int64_t>(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+}
+
+void LuaProfiler::enter(lua_State* L, int params) {
+	int32_t scriptId;
+	int32_t callbackId;
+	bool timerEvent;
+	LuaScriptInterface* scriptInterface;
+	LuaScriptInterface::getScriptEnv()->getEventInfo(scriptId, scriptInterface, callbackId, timerEvent);
+
+	std::string_view file = "unknown";
+	if (scriptId == EVENT_ID_LOADING) {
+		file = "loading";
+	} else if (scriptId == EVENT_ID_USER) {
+		file = "user";
+	} else if (scriptInterface) {
+		file = trimSource(scriptInterface->getFileById(scriptId));
+	}
+	const std::string_view event = timerEvent ? "timer" : (scriptInterface ? std::string_view(scriptInterface->getInterfaceName()) : "unknown");
+
+	lua_Debug debug {};
+	lua_pushvalue(L, -(params + 1));
+	lua_getinfo(L, ">S", &debug);
+
+	std::string stack;
+	if (!frames.empty()) {
+		stack = frames.back().stack;
+		stack += ';';
+	}
+	// Frames are split on ';' by the flame graph tools
+	auto name = fmt::format("{} {} {}:{}", file, event, trimSource(debug.source ? debug.source : "?"), debug.linedefined);
+	std::replace(name.begin(), name.end(), ';', ',');
+	stack += name;
+
+	frames.push_back({ std::move(stack), getTimeNs(), getHeapBytes(L) });
+}
+
+void LuaProfiler::leave(lua_State* L) {
+	if (frames.empty()) {
+		return;
+	}
+
+	const auto frame = std::move(frames.back());
+	frames.pop_back();
+
+	const auto elapsedNs = getTimeNs() - frame.startNs;
+	const auto grownBytes = getHeapBytes(L) - frame.startBytes;
+	if (!frames.empty()) {
+		frames.back().childNs += elapsedNs;
+		frames.back().childBytes += grownBytes;
+	}
+
+	auto &entry = entries[frame.stack];
+	++entry.calls;
+	entry.totalNs += elapsedNs;
+	entry.selfNs += elapsedNs - frame.childNs;
+	entry.maxNs = std::max(entry.maxNs, elapsedNs);
+	entry.selfBytes += grownBytes - frame.childBytes;
+}
+
+std::string LuaProfiler::getReport(size_t limit) const {
+	// Summed by function, whatever called it
+	phmap::flat_hash_map<std::string_view, Entry> functions;
+	for (const auto &[stack, entry] : entries) {
+		const auto pos = stack.rfind(';');
+		auto &function = functions[pos == std::string::npos ? std::string_view(stack) : std::string_view(stack).substr(pos + 1)];
+		function.calls += entry.calls;
+		function.totalNs += entry.totalNs;
+		function.selfNs += entry.selfNs;
+		function.maxNs = std::max(function.maxNs, entry.maxNs);
+		function.selfBytes += entry.selfBytes;
+	}
+
+	std::vector<std::pair<std::string_view, Entry>> sorted(functions.begin(), functions.end());
+	std::ranges::sort(sorted, [](const auto &a, const auto &b) {
+		return a.second.selfNs > b.second.selfNs;
+	});
+	if (limit != 0 && sorted.size() > limit) {
+		sorted.resize(limit);
+	}
+
+	std::string report = "self ms | total ms | calls | max ms | self kb | function\n";
+	for (const auto &[function, entry] : sorted) {
+		report += fmt::format("{:.2f} | {:.2f} | {} | {:.2f} | {:.1f} | {}\n", entry.selfNs / 1e6, entry.totalNs / 1e6, entry.calls, entry.maxNs / 1e6, entry.selfBytes / 1024., function);
+	}
+	return report;
+}
+
+bool LuaProfiler::dump(const std::string &path) const {
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.is_open()) {
+		g_logger().warn("[LuaProfiler::dump] - Could not open {}", path);
+		return false;
+	}
+
+	for (const auto &[stack, entry] : entries) {
+		file << stack << ' ' << std::max<int64_t>(0, entry.selfNs / 1000) << '\n';
+	}
+	return static_cast<bool>(file);
+}
+
+LuaProfiler::Scope::Scope(lua_State* L, int params) {
+	if (auto &profiler = g_luaProfiler(); profiler.isRunning()) {
+		profiler.enter(L, params);
+		this->L = L;
+	}
+}
+
+LuaProfiler::Scope::~Scope() {
+	// Closed even if the profiler was stopped by the call, stop() already dropped the frames
+	if (L) {
+		g_luaProfiler().leave(L);
+	}
+}
@@ -0,0 +1,99 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Instrumenting profiler of the Lua callbacks called by the engine.
+ *
+ * While running, every callFunction/callVoidFunction of a LuaScriptInterface
+ * is a frame named by its script file, its event (the interface, or timer)
+ * and the function called (source:line). Time and Lua heap growth are kept
+ * per stack of nested frames, both in total and without the nested ones, so
+ * the report ranks the scripts by their own cost and the dump can be read by
+ * any flame graph tool. Only used from the dispatcher thread, like Lua.
+ */
+class LuaProfiler {
+public:
+	LuaProfiler() = default;
+
+	// Ensures that we don't accidentally copy it
+	LuaProfiler(const LuaProfiler &) = delete;
+	LuaProfiler &operator=(const LuaProfiler &) = delete;
+
+	static LuaProfiler &getInstance();
+
+	void start();
+	void stop();
+	void reset();
+
+	bool isRunning() const {
+		return running;
+	}
+
+	/**
+	 * @brief Opens the frame of the function about to be called by the current script environment.
+	 * @param L Lua state, with the function below its params on the top of the stack.
+	 * @param params Number of params pushed after the function.
+	 */
+	void enter(lua_State* L, int params);
+	void leave(lua_State* L);
+
+	/**
+	 * @brief Lists the functions that took the most time of their own.
+	 * @param limit Maximum number of lines, 0 for all.
+	 */
+	std::string getReport(size_t limit) const;
+
+	/**
+	 * @brief Writes the samples in collapsed stack format, one "frame;frame microseconds" line per stack.
+	 */
+	bool dump(const std::string &path) const;
+
+	/**
+	 * @brief Runs a call inside a frame, when the profiler is running.
+	 */
+	class Scope {
+	public:
+		Scope(lua_State* L, int params);
+		~Scope();
+
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+	private:
+		lua_State* L = nullptr;
+	};
+
+private:
+	struct Frame {
+		std::string stack;
+		int64_t startNs;
+		int64_t startBytes;
+		int64_t childNs = 0;
+		int64_t childBytes = 0;
+	};
+
+	struct Entry {
+		uint64_t calls = 0;
+		int64_t totalNs = 0;
+		int64_t selfNs = 0;
+		int64_t maxNs = 0;
+		int64_t selfBytes = 0;
+	};
+
+	static int64_t getHeapBytes(lua_State* L);
+
+	bool running = false;
+	std::vector<Frame> frames;
+	// Keyed by the collapsed stack, outermost frame first
+	phmap::flat_hash_map<std::string, Entry> entries;
+};
+
+constexpr auto g_luaProfiler = LuaProfiler::getInstance;
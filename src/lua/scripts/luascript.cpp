@@ -11,6 +11,10 @@
 
 #include "lua/scripts/luascript.hpp"
 #include "lua/scripts/lua_environment.hpp"
+#include "lua/scripts/lua_profiler.hpp"
+#include "lib/profiling/sampling_profiler.hpp"
+#include "lua/scripts/lua_call_budget.hpp"
+#include "game/scheduling/dispatcher.hpp"
 #include "lib/metrics/metrics.hpp"
 
 ScriptEnvironment::DBResultMap ScriptEnvironment::tempResults;
@@ -45,6 +49,22 @@ int32_t LuaScriptInterface::loadFile(const std::string &file, const std::string
 		return -1;
 	}
 
+	return runLoadedChunk(file, scriptName);
+}
+
+int32_t LuaScriptInterface::loadBuffer(std::string_view chunk, const std::string &file, const std::string &scriptName) {
+	// named like luaL_loadfile does, so errors and tracebacks show the file
+	const std::string chunkName = "@" + file;
+	int ret = luaL_loadbuffer(luaState, chunk.data(), chunk.size(), chunkName.c_str());
+	if (ret != 0) {
+		lastLuaError = popString(luaState);
+		return -1;
+	}
+
+	return runLoadedChunk(file, scriptName);
+}
+
+int32_t LuaScriptInterface::runLoadedChunk(const std::string &file, const std::string &scriptName) {
 	// check that it is loaded as a function
 	if (!isFunction(luaState, -1)) {
 		return -1;
@@ -62,7 +82,9 @@ int32_t LuaScriptInterface::loadFile(const std::string &file, const std::string
 	// env->setNpc(npc);
 
 	// execute it
-	ret = protectedCall(luaState, 0, 0);
+	registeringFile = file;
+	const int ret = protectedCall(luaState, 0, 0);
+	registeringFile.clear();
 	if (ret != 0) {
 		reportError(nullptr, popString(luaState));
 		resetScriptEnv();
@@ -264,10 +286,26 @@ std::string LuaScriptInterface::getMetricsScope() {
 	return fmt::format("{}:{}", name, timerEvent ? "timer" : "<direct>");
 }
 
+const std::string* LuaScriptInterface::getSampledScript() {
+	if (!g_samplingProfiler().isRunning()) {
+		return nullptr;
+	}
+
+	int32_t scriptId;
+	int32_t callbackId;
+	bool timerEvent;
+	LuaScriptInterface* scriptInterface;
+	getScriptEnv()->getEventInfo(scriptId, scriptInterface, callbackId, timerEvent);
+	return scriptInterface ? &scriptInterface->getFileById(scriptId) : nullptr;
+}
+
 bool LuaScriptInterface::callFunction(int params) {
 	metrics::lua_latency measure(getMetricsScope());
 	bool result = false;
 	int size = lua_gettop(luaState);
+	LuaProfiler::Scope profile(luaState, params);
+	SamplingProfiler::LuaScope sampled(getSampledScript());
+	LuaCallBudget::Scope budget(luaState, getScriptEnv()->isTimerEvent() ? LuaCallBudget::Type::TimerEvent : LuaCallBudget::Type::Callback);
 	if (protectedCall(luaState, params, 1) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::getString(luaState, -1));
 	} else {
@@ -286,6 +324,9 @@ bool LuaScriptInterface::callFunction(int params) {
 void LuaScriptInterface::callVoidFunction(int params) {
 	metrics::lua_latency measure(getMetricsScope());
 	int size = lua_gettop(luaState);
+	LuaProfiler::Scope profile(luaState, params);
+	SamplingProfiler::LuaScope sampled(getSampledScript());
+	LuaCallBudget::Scope budget(luaState, getScriptEnv()->isTimerEvent() ? LuaCallBudget::Type::TimerEvent : LuaCallBudget::Type::Callback);
 	if (protectedCall(luaState, params, 0) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(luaState));
 	}
@@ -296,3 +337,69 @@ void LuaScriptInterface::callVoidFunction(int params) {
 
 	resetScriptEnv();
 }
+
+bool LuaScriptInterface::callResumableFunction(int params) {
+	const int32_t scriptId = getScriptEnv()->getScriptId();
+	// Still running since an earlier call, they would overlap
+	if (!resumingScripts.emplace(scriptId).second) {
+		lua_pop(luaState, params + 1);
+		resetScriptEnv();
+		return true;
+	}
+
+	// The function and its params are moved to a thread of their own, which stays referenced while it yields
+	lua_State* thread = lua_newthread(luaState);
+	const int32_t threadRef = luaL_ref(luaState, LUA_REGISTRYINDEX);
+	lua_xmove(luaState, thread, params + 1);
+	return resumeFunction(threadRef, scriptId, params);
+}
+
+bool LuaScriptInterface::resumeFunction(int32_t threadRef, int32_t scriptId, int params) {
+	metrics::lua_latency measure(getMetricsScope());
+	lua_rawgeti(luaState, LUA_REGISTRYINDEX, threadRef);
+	lua_State* thread = lua_tothread(luaState, -1);
+	lua_pop(luaState, 1);
+
+	int ret = validateDispatcherContext(__FUNCTION__);
+	if (ret == 0) {
+		LuaCallBudget::Scope budget(thread, LuaCallBudget::Type::GlobalEvent);
+		SamplingProfiler::LuaScope sampled(getSampledScript());
+#if LUA_VERSION_NUM >= 504
+		int results;
+		ret = lua_resume(thread, nullptr, params, &results);
+#elif LUA_VERSION_NUM >= 502
+		ret = lua_resume(thread, nullptr, params);
+#else
+		ret = lua_resume(thread, params);
+#endif
+	}
+
+	if (ret == LUA_YIELD) {
+		lua_settop(thread, 0);
+		resetScriptEnv();
+		g_dispatcher().addEvent(
+			[this, threadRef, scriptId] {
+				if (!luaState || !reserveScriptEnv()) {
+					g_logger().error("[LuaScriptInterface::resumeFunction] - Can not resume a function of {}", interfaceName);
+					return;
+				}
+				getScriptEnv()->setScriptId(scriptId, this);
+				resumeFunction(threadRef, scriptId, 0);
+			},
+			"LuaScriptInterface::resumeFunction"
+		);
+		return true;
+	}
+
+	bool result = false;
+	if (ret != 0) {
+		LuaScriptInterface::reportError(nullptr, lua_isstring(thread, -1) ? LuaScriptInterface::getString(thread, -1) : "unknown error");
+	} else if (lua_gettop(thread) > 0) {
+		result = LuaScriptInterface::getBoolean(thread, -1);
+	}
+
+	luaL_unref(luaState, LUA_REGISTRYINDEX, threadRef);
+	resumingScripts.erase(scriptId);
+	resetScriptEnv();
+	return result;
+}
@@ -26,6 +26,8 @@ public:
 	virtual bool reInitState();
 
 	int32_t loadFile(const std::string &file, const std::string &scriptName);
+	// Same as loadFile, with the file already read or compiled into chunk
+	int32_t loadBuffer(std::string_view chunk, const std::string &file, const std::string &scriptName);
 
 	const std::string &getFileById(int32_t scriptId);
 	int32_t getEvent(const std::string &eventName);
@@ -41,6 +43,10 @@ public:
 	const std::string &getLoadingFile() const {
 		return loadingFile;
 	}
+	// File whose chunk is running, what it registers belongs to it; empty outside of loading
+	const std::string &getRegisteringFile() const {
+		return registeringFile;
+	}
 
 	const std::string &getLoadingScriptName() const {
 		// If scripty name is empty, return warning informing
@@ -62,6 +68,12 @@ public:
 
 	bool callFunction(int params);
 	void callVoidFunction(int params);
+	/**
+	 * @brief Same as callFunction, but the function runs as a coroutine and may yield.
+	 * A yielded function is resumed on the next dispatcher cycles until it returns.
+	 * @return The result of the function, or true while it has not returned yet.
+	 */
+	bool callResumableFunction(int params);
 
 	std::string getStackTrace(const std::string &error_desc);
 
@@ -73,10 +85,19 @@ protected:
 	std::map<int32_t, std::string> cacheFiles;
 
 private:
+	int32_t runLoadedChunk(const std::string &file, const std::string &scriptName);
+	bool resumeFunction(int32_t threadRef, int32_t scriptId, int params);
+
 	std::string getMetricsScope();
+	// File of the script being called, for the samples of the sampling profiler while it runs
+	const std::string* getSampledScript();
+
+	// Scripts of the resumable functions that yielded and have not returned yet
+	phmap::flat_hash_set<int32_t> resumingScripts;
 
 	std::string lastLuaError;
 	std::string interfaceName;
 	std::string loadingFile;
+	std::string registeringFile;
 	std::string loadedScriptName;
 };
@@ -49,6 +49,9 @@ public:
 	void setTimerEvent() {
 		timerEvent = true;
 	}
+	bool isTimerEvent() const {
+		return timerEvent;
+	}
 
 	void getEventInfo(int32_t &scriptId, LuaScriptInterface*&scriptInterface, int32_t &callbackId, bool &timerEvent) const;
 
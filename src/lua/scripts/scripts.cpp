@@ -16,6 +16,61 @@
 #include "lua/scripts/scripts.hpp"
 #include "creatures/combat/spells.hpp"
 #include "lua/callbacks/events_callbacks.hpp"
+#include "game/scheduling/dispatcher.hpp"
+
+namespace {
+	int writeChunk(lua_State*, const void* data, size_t size, void* chunk) {
+		static_cast<std::string*>(chunk)->append(static_cast<const char*>(data), size);
+		return 0;
+	}
+
+	bool readScript(const std::filesystem::path &path, std::string &source) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			return false;
+		}
+		source.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+		// luaL_loadfile skips the BOM and a first "#" line, the line itself stays to keep the line numbers
+		if (source.starts_with("\xEF\xBB\xBF")) {
+			source.erase(0, 3);
+		}
+		if (source.starts_with('#')) {
+			source.insert(0, "--");
+		}
+		return true;
+	}
+
+	// Compiles on its own state, the bytecode loads on any other state of the same build
+	bool compileScript(const std::string &path, std::string &chunk, std::string &error) {
+		lua_State* L = luaL_newstate();
+		if (!L) {
+			error = "not enough memory";
+			return false;
+		}
+
+		const std::string chunkName = "@" + path;
+		if (luaL_loadbuffer(L, chunk.data(), chunk.size(), chunkName.c_str()) != 0) {
+			const char* message = lua_tostring(L, -1);
+			error = message ? message : "unknown error";
+			lua_close(L);
+			return false;
+		}
+
+		std::string bytecode;
+#if LUA_VERSION_NUM >= 503
+		const bool dumped = lua_dump(L, writeChunk, &bytecode, 0) == 0;
+#else
+		const bool dumped = lua_dump(L, writeChunk, &bytecode) == 0;
+#endif
+		lua_close(L);
+
+		if (dumped) {
+			chunk = std::move(bytecode);
+		}
+		return true;
+	}
+}
 
 Scripts::Scripts() :
 	scriptInterface("Scripts Interface") {
@@ -34,6 +89,17 @@ void Scripts::clearAllScripts() const {
 	g_monsters().clear();
 }
 
+void Scripts::clearScriptFile(const std::string &file) const {
+	g_actions().clearScriptFile(file);
+	g_creatureEvents().clearScriptFile(file);
+	g_talkActions().clearScriptFile(file);
+	g_globalEvents().clearScriptFile(file);
+	g_spells().clearScriptFile(file);
+	g_moveEvents().clearScriptFile(file);
+	g_weapons().clearScriptFile(file);
+	g_callbacks().clearScriptFile(file);
+}
+
 bool Scripts::loadEventSchedulerScripts(const std::string &fileName) {
 	auto coreFolder = g_configManager().getString(CORE_DIRECTORY, __FUNCTION__);
 	const auto dir = std::filesystem::current_path() / coreFolder / "events" / "scripts" / "scheduler";
@@ -59,26 +125,70 @@ bool Scripts::loadEventSchedulerScripts(const std::string &fileName) {
 	return false;
 }
 
-bool Scripts::loadScripts(std::string loadPath, bool isLib, bool reload) {
-	const auto dir = std::filesystem::current_path() / loadPath;
+std::vector<uint8_t> Scripts::compileScripts(const std::vector<std::filesystem::path> &paths, std::vector<std::string> &errors) {
+	std::vector<CompiledScript> compiled(paths.size());
+	// Not vector<bool>, the workers write next to each other
+	std::vector<uint8_t> changed(paths.size(), false);
+	std::vector<uint8_t> modified(paths.size(), false);
+	errors.assign(paths.size(), std::string());
+
+	// Only reads the cache, it is updated after the workers are done
+	g_dispatcher().asyncWait(paths.size(), [&](size_t i) {
+		const auto &path = paths[i];
+		const auto pathString = path.string();
+		auto &script = compiled[i];
+
+		std::error_code error;
+		script.writeTime = std::filesystem::last_write_time(path, error);
+		script.size = error ? 0 : std::filesystem::file_size(path, error);
+		const auto it = compiledScripts.find(pathString);
+		if (!error && it != compiledScripts.end() && it->second.writeTime == script.writeTime && it->second.size == script.size) {
+			return;
+		}
+
+		std::string source;
+		modified[i] = true;
+		if (!readScript(path, source)) {
+			errors[i] = fmt::format("cannot open {}", pathString);
+			return;
+		}
+
+		script.hash = std::hash<std::string_view>()(source);
+		changed[i] = true;
+		// Touched but not changed
+		if (it != compiledScripts.end() && it->second.hash == script.hash) {
+			script.chunk = it->second.chunk;
+			modified[i] = false;
+			return;
+		}
+
+		script.chunk = std::move(source);
+		if (!compileScript(pathString, script.chunk, errors[i])) {
+			changed[i] = false;
+		}
+	});
+
+	for (size_t i = 0; i < paths.size(); ++i) {
+		if (changed[i]) {
+			compiledScripts[paths[i].string()] = std::move(compiled[i]);
+		}
+	}
+	return modified;
+}
+
+bool Scripts::collectScripts(const std::string &folderName, bool isLib, std::vector<std::filesystem::path> &files, std::vector<bool> &executable) {
+	const auto dir = std::filesystem::current_path() / folderName;
 	// Checks if the folder exists and is really a folder
 	if (!std::filesystem::exists(dir) || !std::filesystem::is_directory(dir)) {
-		g_logger().error("Can not load folder {}", loadPath);
+		g_logger().error("Can not load folder {}", folderName);
 		return false;
 	}
 
-	// Declare a string variable to store the last directory
-	std::string lastDirectory;
 	// Recursive iterate through all entries in the directory
 	for (const auto &entry : std::filesystem::recursive_directory_iterator(dir)) {
 		// Get the filename of the entry as a string
 		const auto realPath = entry.path();
 		std::string fileFolder = realPath.parent_path().filename().string();
-		// Script folder, example: "actions"
-		std::string scriptFolder = realPath.parent_path().string();
-		// Create a string_view for the fileFolder and scriptFolder strings
-		std::string_view fileFolderView(fileFolder);
-		std::string_view scriptFolderView(scriptFolder);
 		// Filename, example: "demon.lua"
 		std::string file(realPath.filename().string());
 		if (!std::filesystem::is_regular_file(entry) || realPath.extension() != ".lua") {
@@ -97,8 +207,34 @@ bool Scripts::loadScripts(std::string loadPath, bool isLib, bool reload) {
 			continue;
 		}
 
+		files.emplace_back(realPath);
 		// If the file is a library file or if the file's parent directory is not "lib" or "events"
-		if (isLib || (fileFolderView != "lib" && fileFolderView != "events")) {
+		executable.emplace_back(isLib || (fileFolder != "lib" && fileFolder != "events"));
+	}
+	return true;
+}
+
+bool Scripts::loadScripts(std::string loadPath, bool isLib, bool reload) {
+	// Collects the files first, they are compiled together and then run in the same order
+	std::vector<std::filesystem::path> files;
+	std::vector<bool> executable;
+	if (!collectScripts(loadPath, isLib, files, executable)) {
+		return false;
+	}
+
+	// The files only read by the others are compiled too, a later reload tells from them whether a library changed
+	std::vector<std::string> compileErrors;
+	compileScripts(files, compileErrors);
+
+	// Declare a string variable to store the last directory
+	std::string lastDirectory;
+	for (size_t i = 0; i < files.size(); ++i) {
+		const auto &realPath = files[i];
+		// Script folder, example: "actions"
+		std::string scriptFolder = realPath.parent_path().string();
+		std::string_view scriptFolderView(scriptFolder);
+
+		if (executable[i]) {
 			// If console logs are enabled and the file is not a library file
 			if (g_configManager().getBoolean(SCRIPTS_CONSOLE_LOGS, __FUNCTION__)) {
 				// If the current directory is different from the last directory that was logged
@@ -109,11 +245,13 @@ bool Scripts::loadScripts(std::string loadPath, bool isLib, bool reload) {
 				lastDirectory = realPath.parent_path().string();
 			}
 
-			// If the function 'loadFile' returns -1, then there was an error loading the file
-			if (scriptInterface.loadFile(realPath.string(), realPath.filename().string()) == -1) {
+			const auto &compileError = compileErrors[i];
+			const auto it = compileError.empty() ? compiledScripts.find(realPath.string()) : compiledScripts.end();
+			// If the function 'loadBuffer' returns -1, then there was an error loading the file
+			if (it == compiledScripts.end() || scriptInterface.loadBuffer(it->second.chunk, realPath.string(), realPath.filename().string()) == -1) {
 				// Log the error and the file path, and skip to the next iteration of the loop.
 				g_logger().error(realPath.string());
-				g_logger().error(scriptInterface.getLastLuaError());
+				g_logger().error(compileError.empty() ? scriptInterface.getLastLuaError() : compileError);
 				continue;
 			}
 		}
@@ -129,3 +267,95 @@ bool Scripts::loadScripts(std::string loadPath, bool isLib, bool reload) {
 
 	return true;
 }
+
+bool Scripts::reloadChangedScripts(const std::string &libFolderName, const std::vector<std::string> &folderNames) {
+	std::vector<std::filesystem::path> libraries;
+	std::vector<bool> executable;
+	if (!collectScripts(libFolderName, true, libraries, executable)) {
+		return false;
+	}
+
+	// The library folder can be inside one of the folders, its files are libraries there too
+	const auto libDir = (std::filesystem::current_path() / libFolderName / "").string();
+	std::vector<std::filesystem::path> scripts;
+	for (const auto &folderName : folderNames) {
+		std::vector<std::filesystem::path> files;
+		executable.clear();
+		if (!collectScripts(folderName, false, files, executable)) {
+			return false;
+		}
+		for (size_t i = 0; i < files.size(); ++i) {
+			if (executable[i] && !files[i].string().starts_with(libDir)) {
+				scripts.emplace_back(files[i]);
+			} else {
+				libraries.emplace_back(files[i]);
+			}
+		}
+	}
+
+	// A library is read by scripts that didn't change, only running everything again picks it up
+	std::vector<std::string> errors;
+	const auto librariesModified = compileScripts(libraries, errors);
+	if (std::ranges::any_of(librariesModified, [](uint8_t modified) { return modified != 0; })) {
+		return false;
+	}
+
+	phmap::flat_hash_set<std::string> present;
+	for (const auto &path : libraries) {
+		present.emplace(path.string());
+	}
+	for (const auto &path : scripts) {
+		present.emplace(path.string());
+	}
+
+	// Compiled before but gone now, a renamed "#" file too
+	std::vector<std::string> removed;
+	for (const auto &[path, _] : compiledScripts) {
+		if (present.contains(path)) {
+			continue;
+		}
+		const bool inFolders = path.starts_with(libDir) || std::ranges::any_of(folderNames, [&path](const std::string &folderName) {
+			return path.starts_with((std::filesystem::current_path() / folderName / "").string());
+		});
+		if (!inFolders) {
+			continue;
+		}
+
+		const auto fileFolder = std::filesystem::path(path).parent_path().filename().string();
+		if (path.starts_with(libDir) || fileFolder == "lib" || fileFolder == "events") {
+			return false;
+		}
+		removed.emplace_back(path);
+	}
+
+	for (const auto &path : removed) {
+		clearScriptFile(path);
+		compiledScripts.erase(path);
+		g_logger().info("[script removed]: {}", std::filesystem::path(path).filename().string());
+	}
+
+	const auto scriptsModified = compileScripts(scripts, errors);
+	for (size_t i = 0; i < scripts.size(); ++i) {
+		if (!scriptsModified[i]) {
+			continue;
+		}
+
+		const auto &realPath = scripts[i];
+		// What it registered stays until it compiles again
+		if (!errors[i].empty()) {
+			g_logger().error(realPath.string());
+			g_logger().error(errors[i]);
+			continue;
+		}
+
+		clearScriptFile(realPath.string());
+		const auto it = compiledScripts.find(realPath.string());
+		if (it == compiledScripts.end() || scriptInterface.loadBuffer(it->second.chunk, realPath.string(), realPath.filename().string()) == -1) {
+			g_logger().error(realPath.string());
+			g_logger().error(scriptInterface.getLastLuaError());
+			continue;
+		}
+		g_logger().info("[script reloaded]: {}", realPath.filename().string());
+	}
+	return true;
+}
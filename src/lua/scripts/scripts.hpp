@@ -25,9 +25,17 @@ public:
 	}
 
 	void clearAllScripts() const;
+	// Drops what the file registered, before it runs again or after it was removed
+	void clearScriptFile(const std::string &file) const;
 
 	bool loadEventSchedulerScripts(const std::string &fileName);
 	bool loadScripts(std::string folderName, bool isLib, bool reload);
+	/**
+	 * @brief Runs again only the scripts of the folders changed since they were loaded, each after dropping what it registered.
+	 * The other registrations, and the timers and callbacks they hold, are left as they are.
+	 * @return false, with nothing run, when a library changed and every script has to be loaded again.
+	 */
+	bool reloadChangedScripts(const std::string &libFolderName, const std::vector<std::string> &folderNames);
 	LuaScriptInterface &getScriptInterface() {
 		return scriptInterface;
 	}
@@ -41,8 +49,23 @@ public:
 	}
 
 private:
+	struct CompiledScript {
+		std::filesystem::file_time_type writeTime;
+		uintmax_t size = 0;
+		size_t hash = 0;
+		// Bytecode, or the source itself when it could not be dumped
+		std::string chunk;
+	};
+
+	// Lists the .lua files of the folder in load order, and whether each runs or is only read by the others
+	static bool collectScripts(const std::string &folderName, bool isLib, std::vector<std::filesystem::path> &files, std::vector<bool> &executable);
+	// Reads and compiles the files on the thread pool, reusing the ones unchanged since the last load
+	// Returns, per file, whether its source is not the one last compiled
+	std::vector<uint8_t> compileScripts(const std::vector<std::filesystem::path> &paths, std::vector<std::string> &errors);
+
 	int32_t scriptId = 0;
 	LuaScriptInterface scriptInterface;
+	phmap::flat_hash_map<std::string, CompiledScript> compiledScripts;
 };
 
 constexpr auto g_scripts = Scripts::getInstance;
@@ -57,7 +80,7 @@ public:
 	 * @param interface Lua Script Interface
 	 */
 	explicit Script(LuaScriptInterface* interface) :
-		scriptInterface(interface) { }
+		scriptFile(interface ? interface->getRegisteringFile() : std::string()), scriptInterface(interface) { }
 	virtual ~Script() = default;
 
 	/**
@@ -117,10 +140,20 @@ public:
 		scriptId = newScriptId;
 	}
 
+	// File that registered it, empty when it was not registered by a script file
+	const std::string &getScriptFile() const {
+		return scriptFile;
+	}
+	void setScriptFile(const std::string &file) {
+		scriptFile = file;
+	}
+
 private:
 	// If script is loaded callback
 	bool loadedCallback = false;
 
+	std::string scriptFile;
+
 	int32_t scriptId = 0;
 	LuaScriptInterface* scriptInterface = nullptr;
 };
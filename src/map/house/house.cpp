@@ -11,6 +11,7 @@
 
 #include "utils/pugicast.hpp"
 #include "map/house/house.hpp"
+#include "creatures/players/offline_player.hpp"
 #include "io/iologindata.hpp"
 #include "game/game.hpp"
 #include "items/bed.hpp"
@@ -773,114 +774,197 @@ bool Houses::loadHousesXML(const std::string &filename) {
 	return true;
 }
 
+namespace {
+	enum class RentOutcome : uint8_t {
+		NotDue,
+		NoOwner,
+		Inactive,
+		Paid,
+		Unpaid,
+	};
+
+	struct HouseRent {
+		std::shared_ptr<House> house;
+		std::shared_ptr<Player> player;
+		const OfflinePlayer* offlinePlayer = nullptr;
+		RentOutcome outcome = RentOutcome::NotDue;
+
+		const std::string &getOwnerName() const {
+			return player ? player->getName() : offlinePlayer->getName();
+		}
+	};
+
+	void evictHouseOwner(const HouseRent &rent) {
+		// Moving the house items out needs the whole character
+		const auto &owner = rent.player ? rent.player : g_game().getPlayerByGUID(rent.house->getOwner(), true);
+		rent.house->setOwner(0, true, owner);
+		if (owner) {
+			g_saveManager().savePlayer(owner);
+		}
+	}
+
+	time_t getNextPaidUntil(RentPeriod_t rentPeriod, time_t currentTime) {
+		time_t paidUntil = currentTime;
+		switch (rentPeriod) {
+			case RENTPERIOD_DAILY:
+				paidUntil += 24 * 60 * 60;
+				break;
+			case RENTPERIOD_WEEKLY:
+				paidUntil += 24 * 60 * 60 * 7;
+				break;
+			case RENTPERIOD_MONTHLY:
+				paidUntil += 24 * 60 * 60 * 30;
+				break;
+			case RENTPERIOD_YEARLY:
+				paidUntil += 24 * 60 * 60 * 365;
+				break;
+			default:
+				break;
+		}
+		return paidUntil;
+	}
+
+	std::string getRentPeriodName(RentPeriod_t rentPeriod) {
+		switch (rentPeriod) {
+			case RENTPERIOD_DAILY:
+				return "daily";
+			case RENTPERIOD_WEEKLY:
+				return "weekly";
+			case RENTPERIOD_MONTHLY:
+				return "monthly";
+			case RENTPERIOD_YEARLY:
+				return "annual";
+			default:
+				return {};
+		}
+	}
+}
+
 void Houses::payHouses(RentPeriod_t rentPeriod) const {
 	if (rentPeriod == RENTPERIOD_NEVER) {
 		return;
 	}
 
-	time_t currentTime = time(nullptr);
-	for (const auto &it : houseMap) {
-		std::shared_ptr<House> house = it.second;
-		if (house->getOwner() == 0) {
+	// The offline owners are read with one query and charged with another, only the houses that aren't paid are handled one by one
+	std::vector<HouseRent> rents;
+	std::vector<uint32_t> offlineOwnerIds;
+	for (const auto &[houseId, house] : houseMap) {
+		if (house->getOwner() == 0 || !g_game().map.towns.getTown(house->getTownId())) {
 			continue;
 		}
 
-		const uint32_t ownerId = house->getOwner();
-		const auto &town = g_game().map.towns.getTown(house->getTownId());
-		if (!town) {
-			continue;
+		auto &rent = rents.emplace_back();
+		rent.house = house;
+		rent.player = g_game().getPlayerByGUID(house->getOwner());
+		if (!rent.player) {
+			offlineOwnerIds.emplace_back(house->getOwner());
 		}
+	}
 
-		auto player = g_game().getPlayerByGUID(ownerId, true);
-		if (!player) {
-			// Player doesn't exist, reset house owner
-			house->tryTransferOwnership(nullptr, true);
-			continue;
+	const auto offlineOwners = OfflinePlayer::loadAll(offlineOwnerIds);
+
+	const time_t currentTime = time(nullptr);
+	const auto daysToReset = g_configManager().getNumber(HOUSE_LOSE_AFTER_INACTIVITY, __FUNCTION__);
+	const bool vipKeepHouse = g_configManager().getBoolean(VIP_KEEP_HOUSE, __FUNCTION__);
+	phmap::flat_hash_map<uint32_t, uint64_t> offlineCharges;
+	for (auto &rent : rents) {
+		const uint32_t ownerId = rent.house->getOwner();
+		if (!rent.player) {
+			const auto it = offlineOwners.find(ownerId);
+			if (it == offlineOwners.end()) {
+				// Player doesn't exist, reset house owner
+				rent.outcome = RentOutcome::NoOwner;
+				continue;
+			}
+			rent.offlinePlayer = &it->second;
 		}
 
 		// Player hasn't logged in for a while, reset house owner
-		auto daysToReset = g_configManager().getNumber(HOUSE_LOSE_AFTER_INACTIVITY, __FUNCTION__);
 		if (daysToReset > 0) {
-			auto daysSinceLastLogin = (currentTime - player->getLastLoginSaved()) / (60 * 60 * 24);
-			bool vipKeep = g_configManager().getBoolean(VIP_KEEP_HOUSE, __FUNCTION__) && player->isVip();
+			const time_t lastLoginSaved = rent.player ? rent.player->getLastLoginSaved() : rent.offlinePlayer->getLastLoginSaved();
+			auto daysSinceLastLogin = (currentTime - lastLoginSaved) / (60 * 60 * 24);
+			bool vipKeep = vipKeepHouse && (rent.player ? rent.player->isVip() : rent.offlinePlayer->isVip());
 			bool activityKeep = daysSinceLastLogin < daysToReset;
 			if (vipKeep && !activityKeep) {
-				g_logger().info("Player {} has not logged in for {} days, but is a VIP, so the house will not be reset.", player->getName(), daysToReset);
+				g_logger().info("Player {} has not logged in for {} days, but is a VIP, so the house will not be reset.", rent.getOwnerName(), daysToReset);
 			} else if (!vipKeep && !activityKeep) {
-				g_logger().info("Player {} has not logged in for {} days, so the house will be reset.", player->getName(), daysToReset);
-				house->setOwner(0, true, player);
-				g_saveManager().savePlayer(player);
+				g_logger().info("Player {} has not logged in for {} days, so the house will be reset.", rent.getOwnerName(), daysToReset);
+				rent.outcome = RentOutcome::Inactive;
 				continue;
 			}
 		}
 
-		const uint32_t rent = house->getRent();
-		if (rent == 0 || house->getPaidUntil() > currentTime) {
+		const uint32_t houseRent = rent.house->getRent();
+		if (houseRent == 0 || rent.house->getPaidUntil() > currentTime) {
 			continue;
 		}
 
-		if (player->getBankBalance() >= rent) {
-			g_game().removeMoney(player, rent, 0, true);
-			g_metrics().addCounter("balance_decrease", rent, { { "player", player->getName() }, { "context", "house_rent" } });
-
-			time_t paidUntil = currentTime;
-			switch (rentPeriod) {
-				case RENTPERIOD_DAILY:
-					paidUntil += 24 * 60 * 60;
-					break;
-				case RENTPERIOD_WEEKLY:
-					paidUntil += 24 * 60 * 60 * 7;
-					break;
-				case RENTPERIOD_MONTHLY:
-					paidUntil += 24 * 60 * 60 * 30;
-					break;
-				case RENTPERIOD_YEARLY:
-					paidUntil += 24 * 60 * 60 * 365;
-					break;
-				default:
-					break;
-			}
+		if (rent.player) {
+			rent.outcome = rent.player->getBankBalance() >= houseRent ? RentOutcome::Paid : RentOutcome::Unpaid;
+			continue;
+		}
 
-			house->setPaidUntil(paidUntil);
+		// An owner of several houses pays them in order while the balance lasts
+		const auto it = offlineCharges.find(ownerId);
+		const uint64_t charged = it != offlineCharges.end() ? it->second : 0;
+		if (rent.offlinePlayer->getBankBalance() >= charged + houseRent) {
+			offlineCharges[ownerId] = charged + houseRent;
+			rent.outcome = RentOutcome::Paid;
 		} else {
-			if (house->getPayRentWarnings() < 7) {
-				int32_t daysLeft = 7 - house->getPayRentWarnings();
-
-				std::shared_ptr<Item> letter = Item::CreateItem(ITEM_LETTER_STAMPED);
-				std::string period;
-
-				switch (rentPeriod) {
-					case RENTPERIOD_DAILY:
-						period = "daily";
-						break;
-
-					case RENTPERIOD_WEEKLY:
-						period = "weekly";
-						break;
-
-					case RENTPERIOD_MONTHLY:
-						period = "monthly";
-						break;
+			rent.outcome = RentOutcome::Unpaid;
+		}
+	}
 
-					case RENTPERIOD_YEARLY:
-						period = "annual";
-						break;
+	// When it fails the houses stay unpaid, the next run charges them again
+	const bool offlineCharged = IOLoginData::decreaseBankBalances(offlineCharges);
+	if (!offlineCharged) {
+		g_logger().error("[{}] - Failed to charge the rent of {} offline house owners", __FUNCTION__, offlineCharges.size());
+	}
 
-					default:
-						break;
+	for (const auto &rent : rents) {
+		const auto &house = rent.house;
+		switch (rent.outcome) {
+			case RentOutcome::NotDue:
+				continue;
+			case RentOutcome::NoOwner:
+				house->tryTransferOwnership(nullptr, true);
+				continue;
+			case RentOutcome::Inactive:
+				evictHouseOwner(rent);
+				continue;
+			case RentOutcome::Paid: {
+				const uint32_t houseRent = house->getRent();
+				const bool paid = rent.player ? g_game().removeMoney(rent.player, houseRent, 0, true) : offlineCharged;
+				if (paid) {
+					g_metrics().addCounter("balance_decrease", houseRent, { { "player", rent.getOwnerName() }, { "context", "house_rent" } });
+					house->setPaidUntil(getNextPaidUntil(rentPeriod, currentTime));
+				}
+				break;
+			}
+			case RentOutcome::Unpaid: {
+				if (house->getPayRentWarnings() >= 7) {
+					evictHouseOwner(rent);
+					continue;
 				}
 
+				int32_t daysLeft = 7 - house->getPayRentWarnings();
+				std::shared_ptr<Item> letter = Item::CreateItem(ITEM_LETTER_STAMPED);
 				std::ostringstream ss;
-				ss << "Warning! \nThe " << period << " rent of " << house->getRent() << " gold for your house \"" << house->getName() << "\" is payable. Have it within " << daysLeft << " days or you will lose this house.";
+				ss << "Warning! \nThe " << getRentPeriodName(rentPeriod) << " rent of " << house->getRent() << " gold for your house \"" << house->getName() << "\" is payable. Have it within " << daysLeft << " days or you will lose this house.";
 				letter->setAttribute(ItemAttribute_t::TEXT, ss.str());
-				g_game().internalAddItem(player->getInbox(), letter, INDEX_WHEREEVER, FLAG_NOLIMIT);
+				if (rent.player) {
+					g_game().internalAddItem(rent.player->getInbox(), letter, INDEX_WHEREEVER, FLAG_NOLIMIT);
+				} else {
+					rent.offlinePlayer->appendInboxItems({ letter });
+				}
 				house->setPayRentWarnings(house->getPayRentWarnings() + 1);
-			} else {
-				house->setOwner(0, true, player);
+				break;
 			}
 		}
 
-		g_saveManager().savePlayer(player);
+		if (rent.player) {
+			g_saveManager().savePlayer(rent.player);
+		}
 	}
 }
 
@@ -233,6 +233,20 @@ public:
 	bool hasNewOwnership() const;
 	void setNewOwnership();
 
+	// Bumped by any change to the items of the house tiles, only houses with unsaved changes are written on save
+	void markItemsChanged() {
+		++itemsVersion;
+	}
+	uint32_t getItemsVersion() const {
+		return itemsVersion;
+	}
+	bool hasUnsavedItems() const {
+		return itemsVersion != savedItemsVersion;
+	}
+	void setSavedItemsVersion(uint32_t version) {
+		savedItemsVersion = version;
+	}
+
 private:
 	bool transferToDepot() const;
 
@@ -268,6 +282,10 @@ private:
 
 	bool isLoaded = false;
 
+	// Every house is written by the first save
+	uint32_t itemsVersion = 1;
+	uint32_t savedItemsVersion = 0;
+
 	void handleContainer(ItemList &moveItemList, std::shared_ptr<Item> item) const;
 	void handleWrapableItem(ItemList &moveItemList, std::shared_ptr<Item> item, std::shared_ptr<Player> player, std::shared_ptr<HouseTile> houseTile) const;
 };
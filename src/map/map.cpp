@@ -21,6 +21,7 @@
 #include "io/iomapserialize.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "map/spectators.hpp"
+#include "utils/hash.hpp"
 
 void Map::load(const std::string &identifier, const Position &pos) {
 	try {
@@ -32,6 +33,11 @@ void Map::load(const std::string &identifier, const Position &pos) {
 }
 
 void Map::loadMap(const std::string &identifier, bool mainMap /*= false*/, bool loadHouses /*= false*/, bool loadMonsters /*= false*/, bool loadNpcs /*= false*/, bool loadZones /*= false*/, const Position &pos /*= Position()*/) {
+	loadMapFile(identifier, mainMap, pos);
+	loadMapData(mainMap, loadHouses, loadMonsters, loadNpcs, loadZones);
+}
+
+void Map::loadMapFile(const std::string &identifier, bool mainMap /*= false*/, const Position &pos /*= Position()*/) {
 	// Only download map if is loading the main map and it is not already downloaded
 	if (mainMap && g_configManager().getBoolean(TOGGLE_DOWNLOAD_MAP, __FUNCTION__) && !std::filesystem::exists(identifier)) {
 		const auto mapDownloadUrl = g_configManager().getString(MAP_DOWNLOAD_URL, __FUNCTION__);
@@ -54,7 +60,9 @@ void Map::loadMap(const std::string &identifier, bool mainMap /*= false*/, bool
 
 	// Load the map
 	load(identifier, pos);
+}
 
+void Map::loadMapData(bool mainMap, bool loadHouses, bool loadMonsters, bool loadNpcs, bool loadZones) {
 	// Only create items from lua functions if is loading main map
 	// It needs to be after the load map to ensure the map already exists before creating the items
 	if (mainMap) {
@@ -160,6 +168,40 @@ std::shared_ptr<Tile> Map::getOrCreateTile(uint16_t x, uint16_t y, uint8_t z, bo
 	return tile;
 }
 
+void Map::getOrCreateTiles(const std::vector<Position> &positions, std::vector<std::shared_ptr<Tile>> &list) {
+	list.reserve(list.size() + positions.size());
+
+	const std::unique_ptr<Floor>* floor = nullptr;
+	int32_t sectorX = -1;
+	int32_t sectorY = -1;
+	int32_t sectorZ = -1;
+	for (const auto &pos : positions) {
+		if (pos.z >= MAP_MAX_LAYERS) {
+			continue;
+		}
+
+		if (pos.x / SECTOR_SIZE != sectorX || pos.y / SECTOR_SIZE != sectorY || pos.z != sectorZ) {
+			sectorX = pos.x / SECTOR_SIZE;
+			sectorY = pos.y / SECTOR_SIZE;
+			sectorZ = pos.z;
+			const auto sector = getMapSector(pos.x, pos.y);
+			floor = sector ? &sector->getFloor(pos.z) : nullptr;
+		}
+
+		std::shared_ptr<Tile> tile;
+		if (floor && *floor) {
+			tile = getOrCreateTileFromCache(*floor, pos.x, pos.y);
+		}
+
+		if (!tile) {
+			// Creating the tile may create its sector and floor too
+			tile = getOrCreateTile(pos);
+			sectorX = -1;
+		}
+		list.emplace_back(std::move(tile));
+	}
+}
+
 std::shared_ptr<Tile> Map::getLoadedTile(uint16_t x, uint16_t y, uint8_t z) {
 	if (z >= MAP_MAX_LAYERS) {
 		return nullptr;
@@ -216,11 +258,10 @@ void Map::setTile(uint16_t x, uint16_t y, uint8_t z, std::shared_ptr<Tile> newTi
 		return;
 	}
 
-	if (const auto sector = getMapSector(x, y)) {
-		sector->createFloor(z)->setTile(x, y, newTile);
-	} else {
-		getBestMapSector(x, y)->createFloor(z)->setTile(x, y, newTile);
-	}
+	const auto sector = getMapSector(x, y);
+	const auto &floor = (sector ? sector : getBestMapSector(x, y))->createFloor(z);
+	floor->setPathFlags(x, y, newTile ? newTile->getPathFlags() : 0);
+	floor->setTile(x, y, std::move(newTile));
 }
 
 bool Map::placeCreature(const Position &centerPos, std::shared_ptr<Creature> creature, bool extendedPos /* = false*/, bool forceLogin /* = false*/) {
@@ -317,6 +358,9 @@ bool Map::placeCreature(const Position &centerPos, std::shared_ptr<Creature> cre
 
 	const Position &dest = toCylinder->getPosition();
 	getMapSector(dest.x, dest.y)->addCreature(creature);
+	if (creature->getPlayer()) {
+		changeNearbyPlayers(dest.x, dest.y, 1);
+	}
 	return true;
 }
 
@@ -334,8 +378,9 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 	const auto &oldPos = oldTile->getPosition();
 	const auto &newPos = newTile->getPosition();
 
-	const auto &fromZones = oldTile->getZones();
-	const auto &toZones = newTile->getZones();
+	// Copied, the callbacks may refresh the zones of the tiles
+	const auto fromZones = oldTile->getZones();
+	const auto toZones = newTile->getZones();
 
 	if (auto ret = g_game().beforeCreatureZoneChange(creature, fromZones, toZones); ret != RETURNVALUE_NOERROR) {
 		return;
@@ -390,11 +435,18 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 	if (old_sector != new_sector) {
 		old_sector->removeCreature(creature);
 		new_sector->addCreature(creature);
+		if (creature->getPlayer()) {
+			changeNearbyPlayers(oldPos.x, oldPos.y, -1);
+			changeNearbyPlayers(newPos.x, newPos.y, 1);
+		}
 	}
 
 	// add the creature
 	newTile->addThing(creature);
 
+	// Refresh the sector position mirror now that the creature is on the new tile
+	new_sector->updateCreaturePosition(creature);
+
 	if (!teleport) {
 		if (oldPos.y > newPos.y) {
 			creature->setDirection(DIRECTION_NORTH);
@@ -421,12 +473,19 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 	}
 
 	// event method
+	const bool deferMonsterMoves = g_configManager().getBoolean(DEFER_MONSTER_MOVE_EVENTS, __FUNCTION__);
 	for (const auto &spectator : spectators) {
+		if (deferMonsterMoves) {
+			if (const auto &monster = spectator->getMonster(); monster && monster->deferCreatureMove(creature, oldPos)) {
+				continue;
+			}
+		}
 		spectator->onCreatureMove(creature, newTile, newPos, oldTile, oldPos, teleport);
 	}
 
-	oldTile->postRemoveNotification(creature, newTile, 0);
-	newTile->postAddNotification(creature, oldTile, 0);
+	// Both view ports are inside the one of the move, their viewers are picked out of it
+	oldTile->postRemoveNotification(creature, newTile, 0, playersSpectators);
+	newTile->postAddNotification(creature, oldTile, 0, playersSpectators);
 	g_game().afterCreatureZoneChange(creature, fromZones, toZones);
 }
 
@@ -473,8 +532,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 		while (--distanceX > 0) {
 			start.x += delta;
 
-			const auto &tile = getTile(start.x, start.y, start.z);
-			if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+			if (isProjectileBlocked(start.x, start.y, start.z)) {
 				return false;
 			}
 		}
@@ -484,8 +542,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 		while (--distanceY > 0) {
 			start.y += delta;
 
-			const auto &tile = getTile(start.x, start.y, start.z);
-			if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+			if (isProjectileBlocked(start.x, start.y, start.z)) {
 				return false;
 			}
 		}
@@ -517,8 +574,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 					xIncrease = deltaX;
 				}
 
-				const auto &tile = getTile(start.x + xIncrease, start.y + deltaY, start.z);
-				if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+				if (isProjectileBlocked(start.x + xIncrease, start.y + deltaY, start.z)) {
 					if (Position::areInRange<1, 1>(start, destination)) {
 						return true;
 					}
@@ -548,8 +604,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 					yIncrease = deltaY;
 				}
 
-				const auto &tile = getTile(start.x + deltaX, start.y + yIncrease, start.z);
-				if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+				if (isProjectileBlocked(start.x + deltaX, start.y + yIncrease, start.z)) {
 					if (Position::areInRange<1, 1>(start, destination)) {
 						return true;
 					}
@@ -564,7 +619,59 @@ bool Map::checkSightLine(Position start, Position destination) {
 	return true;
 }
 
+bool Map::isProjectileBlocked(uint16_t x, uint16_t y, uint8_t z) const {
+	const auto sector = getMapSector(x, y);
+	if (!sector) {
+		return false;
+	}
+
+	const auto &floor = sector->getFloor(z);
+	if (!floor) {
+		return false;
+	}
+
+	if (const uint8_t flags = floor->getPathFlags(x, y); flags & Floor::PATH_TILE) {
+		return flags & Floor::PATH_BLOCKPROJECTILE;
+	}
+
+	// Not loaded yet, read it from the map cache instead of creating the tile
+	if (const auto cachedTile = floor->getTileCache(x, y)) {
+		const auto blocks = [](const std::shared_ptr<BasicItem> &item) {
+			return Item::items.hasFlag(item->id, ITEMTYPE_FLAG_BLOCKPROJECTILE);
+		};
+		return (cachedTile->ground && blocks(cachedTile->ground)) || std::ranges::any_of(cachedTile->items, blocks);
+	}
+
+	const auto tile = floor->getTile(x, y);
+	return tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE);
+}
+
 bool Map::isSightClear(const Position &fromPos, const Position &toPos, bool floorCheck) {
+	// Only the serial tasks share the memo, nothing can change the map under them
+	if (g_dispatcher().context().isAsync()) {
+		return checkSightClear(fromPos, toPos, floorCheck);
+	}
+
+	const auto cycle = g_dispatcher().getDispatcherCycle();
+	const auto pack = [](const Position &pos) {
+		return static_cast<uint64_t>(pos.x) | static_cast<uint64_t>(pos.y) << 16 | static_cast<uint64_t>(pos.z) << 32;
+	};
+	size_t hash = floorCheck;
+	stdext::hash_combine(hash, pack(fromPos));
+	stdext::hash_combine(hash, pack(toPos));
+	auto &entry = sightEntries[hash % sightEntries.size()];
+	if (entry.cycle != cycle || entry.version != sightVersion || entry.fromPos != fromPos || entry.toPos != toPos || entry.floorCheck != floorCheck) {
+		entry.cycle = cycle;
+		entry.version = sightVersion;
+		entry.fromPos = fromPos;
+		entry.toPos = toPos;
+		entry.floorCheck = floorCheck;
+		entry.clear = checkSightClear(fromPos, toPos, floorCheck);
+	}
+	return entry.clear;
+}
+
+bool Map::checkSightClear(const Position &fromPos, const Position &toPos, bool floorCheck) {
 	// Check if this sight line should be even possible
 	if (floorCheck && fromPos.z != toPos.z) {
 		return false;
@@ -640,6 +747,28 @@ std::shared_ptr<Tile> Map::canWalkTo(const std::shared_ptr<Creature> &creature,
 	return tile;
 }
 
+std::optional<int_fast32_t> Map::getCachedTileWalkCost(const std::shared_ptr<Creature> &creature, const Position &pos) {
+	if (pos.z >= MAP_MAX_LAYERS) {
+		return std::nullopt;
+	}
+
+	const auto sector = getMapSector(pos.x, pos.y);
+	if (!sector) {
+		return std::nullopt;
+	}
+
+	const auto &floor = sector->getFloor(pos.z);
+	if (!floor || (floor->getPathFlags(pos.x, pos.y) & Floor::PATH_WALK_FLAGS) != Floor::PATH_TILE) {
+		return std::nullopt;
+	}
+
+	// Without creature or field on the tile the walk cost is always zero, only the walkability is left
+	if (creature && (creature->isRemoved() || creature->getWalkCache(pos) != 1)) {
+		return std::nullopt;
+	}
+	return 0;
+}
+
 bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Position &__targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
 	static int_fast32_t allNeighbors[8][2] = {
 		{ -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 }
@@ -661,7 +790,7 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 	Position pos = withoutCreature ? __targetPos : creature->getPosition();
 	Position endPos;
 
-	AStarNodes nodes(pos.x, pos.y, AStarNodes::getTileWalkCost(creature, getTile(pos.x, pos.y, pos.z)));
+	AStarNodes &nodes = AStarNodes::acquire(pos.x, pos.y, AStarNodes::getTileWalkCost(creature, getTile(pos.x, pos.y, pos.z)));
 
 	int32_t bestMatch = 0;
 
@@ -740,6 +869,8 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 			AStarNode* neighborNode = nodes.getNodeByPosition(pos.x, pos.y);
 			if (neighborNode) {
 				extraCost = neighborNode->c;
+			} else if (const auto cachedCost = getCachedTileWalkCost(creature, pos)) {
+				extraCost = *cachedCost;
 			} else {
 				const auto &tile = withoutCreature ? getTile(pos.x, pos.y, pos.z) : canWalkTo(creature, pos);
 				if (!tile) {
@@ -827,7 +958,7 @@ bool Map::getPathMatchingCond(const std::shared_ptr<Creature> &creature, const P
 	Position pos = creature->getPosition();
 	Position endPos;
 
-	AStarNodes nodes(pos.x, pos.y, AStarNodes::getTileWalkCost(creature, getTile(pos.x, pos.y, pos.z)));
+	AStarNodes &nodes = AStarNodes::acquire(pos.x, pos.y, AStarNodes::getTileWalkCost(creature, getTile(pos.x, pos.y, pos.z)));
 
 	int32_t bestMatch = 0;
 
@@ -927,6 +1058,8 @@ bool Map::getPathMatchingCond(const std::shared_ptr<Creature> &creature, const P
 			AStarNode* neighborNode = nodes.getNodeByPosition(pos.x, pos.y);
 			if (neighborNode) {
 				extraCost = neighborNode->c;
+			} else if (const auto cachedCost = getCachedTileWalkCost(creature, pos)) {
+				extraCost = *cachedCost;
 			} else {
 				const auto &tile = Map::canWalkTo(creature, pos);
 				if (!tile) {
@@ -1008,6 +1141,26 @@ bool Map::getPathMatchingCond(const std::shared_ptr<Creature> &creature, const P
 }
 
 uint32_t Map::clean() {
+	if (g_configManager().getNumber(MAP_CLEAN_STEP_BUDGET, __FUNCTION__) > 0) {
+		const bool running = !cleanQueue.empty();
+		size_t count = 0;
+		for (const auto &tile : g_game().getTilesToClean()) {
+			const auto items = tile ? tile->getItemList() : nullptr;
+			if (items) {
+				count += static_cast<size_t>(std::ranges::count_if(*items, [](const auto &item) { return item->isCleanable(); }));
+				cleanQueue.emplace_back(tile);
+			}
+		}
+		g_game().clearTilesToClean();
+
+		// A clean already running takes the new tiles in its queue
+		if (!running && !cleanQueue.empty()) {
+			cleanProgress = { OTSYS_TIME() };
+			g_dispatcher().addEvent([this] { cleanStep(); }, "Map::cleanStep");
+		}
+		return static_cast<uint32_t>(count);
+	}
+
 	uint64_t start = OTSYS_TIME();
 	size_t qntTiles = 0;
 
@@ -1048,3 +1201,52 @@ uint32_t Map::clean() {
 	g_logger().info("CLEAN: Removed {} item{} from {} tile{} in {} seconds", count, (count != 1 ? "s" : ""), qntTiles, (qntTiles != 1 ? "s" : ""), (end - start) / (1000.f));
 	return count;
 }
+
+void Map::cleanStep() {
+	// Waits for the dispatcher to be back under its latency target, the queued tiles stay queued
+	if (g_dispatcher().getTickGovernor().isActive(TickGovernor::Degradation::Batches)) {
+		g_dispatcher().scheduleEvent(CLEAN_POSTPONE_DELAY, [this] { cleanStep(); }, "Map::cleanStep");
+		return;
+	}
+
+	const auto budget = std::chrono::milliseconds(std::max<int64_t>(1, g_configManager().getNumber(MAP_CLEAN_STEP_BUDGET, __FUNCTION__)));
+	const auto deadline = std::chrono::steady_clock::now() + budget;
+
+	ItemVector toRemove;
+	while (!cleanQueue.empty() && std::chrono::steady_clock::now() < deadline) {
+		const auto tile = std::move(cleanQueue.back());
+		cleanQueue.pop_back();
+
+		// Left for the next clean, nobody sees the items vanish and no tile update is sent
+		if (!Spectators().find<Player>(tile->getPosition(), true).empty()) {
+			g_game().addTileToClean(tile);
+			++cleanProgress.skippedTiles;
+			continue;
+		}
+
+		const auto items = tile->getItemList();
+		if (!items) {
+			continue;
+		}
+
+		toRemove.clear();
+		for (const auto &item : *items) {
+			if (item->isCleanable()) {
+				toRemove.emplace_back(item);
+			}
+		}
+		for (const auto &item : toRemove) {
+			g_game().internalRemoveItem(item, -1);
+		}
+		cleanProgress.items += toRemove.size();
+		++cleanProgress.tiles;
+	}
+
+	if (!cleanQueue.empty()) {
+		g_dispatcher().scheduleEvent(SCHEDULER_MINTICKS, [this] { cleanStep(); }, "Map::cleanStep");
+		return;
+	}
+
+	const auto &[start, count, tiles, skippedTiles] = cleanProgress;
+	g_logger().info("CLEAN: Removed {} item{} from {} tile{} in {} seconds, {} tile{} in view left for the next clean", count, (count != 1 ? "s" : ""), tiles, (tiles != 1 ? "s" : ""), (OTSYS_TIME() - start) / (1000.f), skippedTiles, (skippedTiles != 1 ? "s" : ""));
+}
@@ -12,6 +12,8 @@
 #include "mapcache.hpp"
 #include "map/town.hpp"
 #include "map/house/house.hpp"
+#include "map/utils/sectorgraph.hpp"
+#include "map/utils/pathcache.hpp"
 #include "creatures/monsters/spawns/spawn_monster.hpp"
 #include "creatures/npcs/spawns/spawn_npc.hpp"
 
@@ -31,6 +33,12 @@ class FrozenPathingConditionCall;
  */
 class Map : public MapCache {
 public:
+	/**
+	 * @brief Removes the cleanable items of the tiles to clean, returns how many.
+	 * With mapCleanStepBudget set, the tiles are only queued and cleaned a few per
+	 * tick by cleanStep, leaving the ones a player can see for the next clean; the
+	 * count is then the items found on the queued tiles.
+	 */
 	uint32_t clean();
 
 	std::filesystem::path getPath() const {
@@ -51,6 +59,15 @@ public:
 	 * \returns true if the main map was loaded successfully
 	 */
 	void loadMap(const std::string &identifier, bool mainMap = false, bool loadHouses = false, bool loadMonsters = false, bool loadNpcs = false, bool loadZones = false, const Position &pos = Position());
+	/**
+	 * The first half of loadMap: downloads the main map when it is missing and loads the tiles.
+	 * It needs only the items, so the startup runs it next to the scripts
+	 */
+	void loadMapFile(const std::string &identifier, bool mainMap = false, const Position &pos = Position());
+	/**
+	 * The second half of loadMap: the items created by the scripts, the spawns, the houses and the zones
+	 */
+	void loadMapData(bool mainMap, bool loadHouses, bool loadMonsters, bool loadNpcs, bool loadZones);
 	/**
 	 * Load the custom map
 	 * \param identifier Is the map custom folder
@@ -88,6 +105,13 @@ public:
 		return getOrCreateTile(pos.x, pos.y, pos.z, isDynamic);
 	}
 
+	/**
+	 * Gets or creates the tiles of many positions, each map sector is looked up once for its run of positions.
+	 * \param positions The positions, best grouped by sector
+	 * \param list Receives the tiles in the order of the positions
+	 */
+	void getOrCreateTiles(const std::vector<Position> &positions, std::vector<std::shared_ptr<Tile>> &list);
+
 	/**
 	 * Place a creature on the map
 	 * \param centerPos The position to place the creature
@@ -119,8 +143,36 @@ public:
 	 */
 	bool isSightClear(const Position &fromPos, const Position &toPos, bool floorCheck);
 	bool checkSightLine(Position start, Position destination);
+	// Reads the floor path flags, or the map cache of a tile not loaded yet, so no tile is created
+	bool isProjectileBlocked(uint16_t x, uint16_t y, uint8_t z) const;
+
+	// Forgets the sight lines checked by the current task, called when a tile starts or stops blocking projectiles
+	void invalidateSightLines() {
+		++sightVersion;
+	}
+
+	// Forgets the tile descriptions encoded by the current task, called when the items of a tile change
+	void invalidateTileDescriptions() {
+		++tileDescriptionVersion;
+	}
+	uint32_t getTileDescriptionVersion() const {
+		return tileDescriptionVersion;
+	}
+
+	// Called when a tile starts or stops blocking walks or projectiles, creatures excluded
+	void invalidateWalkability() {
+		++walkVersion;
+	}
+	uint32_t getWalkVersion() const {
+		return walkVersion;
+	}
 
 	std::shared_ptr<Tile> canWalkTo(const std::shared_ptr<Creature> &creature, const Position &pos);
+	/**
+	 * Walk cost of a pathfinding neighbour from the floor path flags alone.
+	 * \returns Nothing when the tile itself must be checked.
+	 */
+	std::optional<int_fast32_t> getCachedTileWalkCost(const std::shared_ptr<Creature> &creature, const Position &pos);
 
 	bool getPathMatching(const std::shared_ptr<Creature> &creature, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp);
 	bool getPathMatching(const std::shared_ptr<Creature> &creature, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp);
@@ -138,6 +190,11 @@ public:
 	Towns towns;
 	Houses houses;
 
+	// Long routes beyond the reach of getPathMatching
+	SectorGraph sectorGraph;
+	// Paths shared by the monsters chasing the same target
+	FollowPathCache followPathCache;
+
 	// Storage made by "loadFromXML" of houses, monsters and npcs for custom maps
 	SpawnsMonster spawnsMonsterCustomMaps[50];
 	SpawnsNpc spawnsNpcCustomMaps[50];
@@ -152,6 +209,35 @@ private:
 		setTile(pos.x, pos.y, pos.z, newTile);
 	}
 	std::shared_ptr<Tile> getLoadedTile(uint16_t x, uint16_t y, uint8_t z);
+	bool checkSightClear(const Position &fromPos, const Position &toPos, bool floorCheck);
+
+	// Sight lines already checked by the current serial task, ranged attacks and target checks repeat them
+	struct SightEntry {
+		uint64_t cycle = std::numeric_limits<uint64_t>::max();
+		uint32_t version = 0;
+		Position fromPos;
+		Position toPos;
+		bool floorCheck = false;
+		bool clear = false;
+	};
+	std::array<SightEntry, 256> sightEntries;
+	uint32_t sightVersion = 0;
+	uint32_t tileDescriptionVersion = 0;
+
+	// Runs one slice of an incremental clean, then schedules the next one while tiles are left
+	void cleanStep();
+	// Between the checks of a clean postponed by the dispatcher latency target
+	static constexpr uint32_t CLEAN_POSTPONE_DELAY = 1000;
+
+	struct CleanProgress {
+		int64_t start = 0;
+		size_t items = 0;
+		size_t tiles = 0;
+		size_t skippedTiles = 0;
+	};
+	std::vector<std::shared_ptr<Tile>> cleanQueue;
+	CleanProgress cleanProgress;
+	uint32_t walkVersion = 0;
 
 	std::filesystem::path path;
 	std::string monsterfile;
@@ -19,6 +19,6 @@ static constexpr int8_t MAP_INIT_SURFACE_LAYER = 7; // (MAP_MAX_LAYERS / 2) -1
 static constexpr int8_t MAP_LAYER_VIEW_LIMIT = 2;
 
 // SECTOR_SIZE must be power of 2 value
-// The bigger the SECTOR_SIZE is the less hash map collision there should be but it'll consume more memory
+// The bigger the SECTOR_SIZE is the smaller the sector directory but the more tiles each spectator lookup scans
 static constexpr int32_t SECTOR_SIZE = 16;
 static constexpr int32_t SECTOR_MASK = SECTOR_SIZE - 1;
@@ -21,6 +21,7 @@
 #include "map/map.hpp"
 #include "utils/hash.hpp"
 #include "io/filestream.hpp"
+#include "lib/metrics/metrics.hpp"
 
 #include "io/iomap.hpp"
 
@@ -66,7 +67,7 @@ void MapCache::parseItemAttr(const std::shared_ptr<BasicItem> &BasicItem, std::s
 		item->getContainer()->getDepotLocker()->setDepotId(BasicItem->doorOrDepotId);
 	}
 
-	if (!BasicItem->text.empty()) {
+	if (BasicItem->text) {
 		item->setAttribute(ItemAttribute_t::TEXT, BasicItem->text);
 	}
 
@@ -111,6 +112,12 @@ std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::unique_ptr<F
 
 	std::unique_lock l(floor->getMutex());
 
+	// Another parallel task may have materialized it while this one waited for the lock
+	const auto &[currentTile, currentCache] = floor->getTiles()[x & SECTOR_MASK][y & SECTOR_MASK];
+	if (!currentCache) {
+		return currentTile;
+	}
+
 	const uint8_t z = floor->getZ();
 
 	auto map = static_cast<Map*>(this);
@@ -162,25 +169,35 @@ std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::unique_ptr<F
 	);
 
 	floor->setTile(x, y, tile);
+	floor->setPathFlags(x, y, tile->getPathFlags());
 
 	// Remove Tile from cache
 	floor->setTileCache(x, y, nullptr);
+	floor->setLastMaterialized(OTSYS_TIME());
+	++materializedTiles[z];
+	--cachedTiles[z];
+
+	if (!cachedTile->isHouse() && g_configManager().getNumber(MAP_IDLE_TILE_MINUTES, __FUNCTION__) > 0) {
+		tile->setBasicTile(cachedTile);
+	}
 
 	return tile;
 }
 
-void MapCache::setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &newTile) {
+std::shared_ptr<BasicTile> MapCache::setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &newTile, bool deduplicate /*= true*/) {
 	if (z >= MAP_MAX_LAYERS) {
 		g_logger().error("Attempt to set tile on invalid coordinate: {}", Position(x, y, z).toString());
-		return;
+		return nullptr;
 	}
 
-	const auto tile = static_tryGetTileFromCache(newTile);
-	if (const auto sector = getMapSector(x, y)) {
-		sector->createFloor(z)->setTileCache(x, y, tile);
-	} else {
-		getBestMapSector(x, y)->createFloor(z)->setTileCache(x, y, tile);
+	const auto tile = deduplicate ? static_tryGetTileFromCache(newTile) : newTile;
+	const auto sector = getMapSector(x, y);
+	const auto &floor = (sector ? sector : getBestMapSector(x, y))->createFloor(z);
+	if (!floor->getTileCache(x, y)) {
+		++cachedTiles[z];
 	}
+	floor->setTileCache(x, y, tile);
+	return tile;
 }
 
 std::shared_ptr<BasicItem> MapCache::tryReplaceItemFromCache(const std::shared_ptr<BasicItem> &ref) {
@@ -188,14 +205,19 @@ std::shared_ptr<BasicItem> MapCache::tryReplaceItemFromCache(const std::shared_p
 }
 
 MapSector* MapCache::createMapSector(const uint32_t x, const uint32_t y) {
-	const uint32_t index = x / SECTOR_SIZE | y / SECTOR_SIZE << 16;
-	const auto it = mapSectors.find(index);
-	if (it != mapSectors.end()) {
-		return &it->second;
+	const uint32_t sectorX = x / SECTOR_SIZE;
+	const uint32_t sectorY = y / SECTOR_SIZE;
+	auto &block = sectorBlocks[(sectorY / SECTOR_BLOCK_SIZE) * SECTOR_BLOCKS + sectorX / SECTOR_BLOCK_SIZE];
+	if (!block) {
+		block = std::make_unique<SectorBlock>();
 	}
 
-	MapSector::newSector = true;
-	return &mapSectors[index];
+	auto &sector = (*block)[(sectorY % SECTOR_BLOCK_SIZE) * SECTOR_BLOCK_SIZE + sectorX % SECTOR_BLOCK_SIZE];
+	if (!sector) {
+		MapSector::newSector = true;
+		sector = std::make_unique<MapSector>();
+	}
+	return sector.get();
 }
 
 MapSector* MapCache::getBestMapSector(uint32_t x, uint32_t y) {
@@ -222,11 +244,114 @@ MapSector* MapCache::getBestMapSector(uint32_t x, uint32_t y) {
 		if (const auto eastSector = getMapSector(x + SECTOR_SIZE, y)) {
 			sector->sectorE = eastSector;
 		}
+
+		for (int32_t offsetY = -1; offsetY <= 1; ++offsetY) {
+			for (int32_t offsetX = -1; offsetX <= 1; ++offsetX) {
+				if (const auto nearSector = getMapSector(x + offsetX * SECTOR_SIZE, y + offsetY * SECTOR_SIZE)) {
+					sector->nearbyPlayers += static_cast<uint32_t>(nearSector->player_list.size());
+				}
+			}
+		}
 	}
 
 	return sector;
 }
 
+void MapCache::changeNearbyPlayers(uint32_t x, uint32_t y, int32_t delta) {
+	for (int32_t offsetY = -1; offsetY <= 1; ++offsetY) {
+		for (int32_t offsetX = -1; offsetX <= 1; ++offsetX) {
+			if (const auto nearSector = getMapSector(x + offsetX * SECTOR_SIZE, y + offsetY * SECTOR_SIZE)) {
+				nearSector->nearbyPlayers += delta;
+			}
+		}
+	}
+}
+
+void MapCache::checkTiles() {
+	metrics::method_latency measure(__METHOD_NAME__);
+	if (const auto idleMinutes = g_configManager().getNumber(MAP_IDLE_TILE_MINUTES, __FUNCTION__); idleMinutes > 0) {
+		if (const auto demoted = demoteIdleTiles(static_cast<int64_t>(idleMinutes) * 60000)) {
+			g_logger().debug("[{}] - Demoted {} idle tiles", __FUNCTION__, demoted);
+		}
+	}
+	updateTileMetrics();
+}
+
+uint32_t MapCache::demoteIdleTiles(int64_t idleTime) {
+	const int64_t now = OTSYS_TIME();
+
+	// A player sees further than its own sector, so the sectors around it stay active too
+	forEachSector([this, now](uint32_t sectorX, uint32_t sectorY, MapSector &sector) {
+		if (sector.player_list.empty()) {
+			return;
+		}
+
+		for (int32_t offsetY = -1; offsetY <= 1; ++offsetY) {
+			for (int32_t offsetX = -1; offsetX <= 1; ++offsetX) {
+				const auto x = static_cast<uint32_t>(static_cast<int32_t>(sectorX) + offsetX) * SECTOR_SIZE;
+				const auto y = static_cast<uint32_t>(static_cast<int32_t>(sectorY) + offsetY) * SECTOR_SIZE;
+				if (const auto nearSector = getMapSector(x, y)) {
+					nearSector->lastActive = now;
+				}
+			}
+		}
+	});
+
+	uint32_t demoted = 0;
+	forEachSector([&](uint32_t, uint32_t, MapSector &sector) {
+		if (now - sector.lastActive < idleTime) {
+			return;
+		}
+
+		for (const auto &floor : sector.floors) {
+			if (!floor || now - floor->getLastMaterialized() < idleTime) {
+				continue;
+			}
+
+			std::unique_lock l(floor->getMutex());
+			const uint8_t z = floor->getZ();
+			for (uint16_t x = 0; x < SECTOR_SIZE; ++x) {
+				for (uint16_t y = 0; y < SECTOR_SIZE; ++y) {
+					const auto &[tile, cachedTile] = floor->getTiles()[x][y];
+					// Only the floor may hold the tile, a demoted tile is built again on its next access
+					if (!tile || cachedTile || tile.use_count() != 1 || !tile->canDemote()) {
+						continue;
+					}
+
+					const auto basicTile = tile->getBasicTile();
+					floor->setTileCache(x, y, basicTile);
+					floor->setPathFlags(x, y, 0);
+					floor->setTile(x, y, nullptr);
+					--materializedTiles[z];
+					++cachedTiles[z];
+					++demoted;
+				}
+			}
+		}
+	});
+
+	g_metrics().addCounter("map_tiles_demoted", demoted);
+	return demoted;
+}
+
+void MapCache::updateTileMetrics() {
+	for (uint8_t z = 0; z < MAP_MAX_LAYERS; ++z) {
+		const std::map<std::string, std::string> attrs = { { "floor", std::to_string(z) } };
+
+		const auto materialized = materializedTiles[z].load(std::memory_order_relaxed);
+		if (materialized != publishedMaterializedTiles[z]) {
+			g_metrics().addUpDownCounter("map_tiles_materialized", static_cast<int>(materialized - publishedMaterializedTiles[z]), attrs);
+			publishedMaterializedTiles[z] = materialized;
+		}
+
+		const auto cached = cachedTiles[z].load(std::memory_order_relaxed);
+		if (cached != publishedCachedTiles[z]) {
+			g_metrics().addUpDownCounter("map_tiles_cached", static_cast<int>(cached - publishedCachedTiles[z]), attrs);
+			publishedCachedTiles[z] = cached;
+		}
+	}
+}
+
 void BasicTile::hash(size_t &h) const {
 	std::array<uint32_t, 4> arr = { flags, houseId, type, isStatic };
 	for (const auto v : arr) {
@@ -255,8 +380,8 @@ void BasicItem::hash(size_t &h) const {
 		}
 	}
 
-	if (!text.empty()) {
-		stdext::hash_combine(h, text);
+	if (text) {
+		stdext::hash_combine(h, *text);
 	}
 
 	if (!items.empty()) {
@@ -289,7 +414,8 @@ bool BasicItem::unserializeItemNode(FileStream &stream, uint16_t x, uint16_t y,
 			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Failed to load item.", x, y, z));
 		}
 
-		items.emplace_back(static_tryGetItemFromCache(item));
+		// Cached with its container once the tile is merged into the map
+		items.emplace_back(item);
 
 		if (!stream.endNode()) {
 			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
@@ -337,7 +463,7 @@ void BasicItem::readAttr(FileStream &stream) {
 			case ATTR_TEXT: {
 				const auto str = stream.getString();
 				if (!str.empty()) {
-					text = str;
+					text = g_stringPool().intern(str);
 				}
 			} break;
 
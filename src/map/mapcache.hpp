@@ -11,6 +11,7 @@
 
 #include "items/items_definitions.hpp"
 #include "utils/mapsector.hpp"
+#include "utils/stringpool.hpp"
 
 class Map;
 class Tile;
@@ -20,7 +21,8 @@ class FileStream;
 
 #pragma pack(1)
 struct BasicItem {
-	std::string text;
+	// Interned, nullptr when the item has no text
+	StringPool::Handle text;
 	// size_t description { 0 };
 
 	uint16_t id { 0 };
@@ -83,7 +85,12 @@ class MapCache {
 public:
 	virtual ~MapCache() = default;
 
-	void setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &BasicTile);
+	/**
+	 * Sets the tile waiting at that position to be materialized.
+	 * \param deduplicate false for tiles already unique, as the ones read from a map snapshot.
+	 * \returns The tile stored, the cached copy when an equal tile was set before.
+	 */
+	std::shared_ptr<BasicTile> setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &BasicTile, bool deduplicate = true);
 
 	std::shared_ptr<BasicItem> tryReplaceItemFromCache(const std::shared_ptr<BasicItem> &ref);
 
@@ -96,26 +103,86 @@ public:
 	MapSector* createMapSector(uint32_t x, uint32_t y);
 	MapSector* getBestMapSector(uint32_t x, uint32_t y);
 
+	/**
+	 * Counts a player entering (1) or leaving (-1) the sector of a position for that sector and the eight around it.
+	 */
+	void changeNearbyPlayers(uint32_t x, uint32_t y, int32_t delta);
+
+	/**
+	 * Cheap probe for the view of a position: false when no player is in its sector or the ones around it,
+	 * which cover the view range from any floor.
+	 */
+	bool hasNearbyPlayers(uint32_t x, uint32_t y) const {
+		const auto sector = getMapSector(x, y);
+		return !sector || sector->nearbyPlayers != 0;
+	}
+
+	/**
+	 * Demotes the idle tiles when mapIdleTileMinutes is set and publishes the tile counts of each floor.
+	 * Runs on the dispatcher.
+	 */
+	void checkTiles();
+
 	/**
 	 * Gets a map sector.
 	 * \returns A pointer to that map sector.
 	 */
 	MapSector* getMapSector(const uint32_t x, const uint32_t y) {
-		const auto it = mapSectors.find(x / SECTOR_SIZE | y / SECTOR_SIZE << 16);
-		return it != mapSectors.end() ? &it->second : nullptr;
+		return const_cast<MapSector*>(std::as_const(*this).getMapSector(x, y));
 	}
 
 	const MapSector* getMapSector(const uint32_t x, const uint32_t y) const {
-		const auto it = mapSectors.find(x / SECTOR_SIZE | y / SECTOR_SIZE << 16);
-		return it != mapSectors.end() ? &it->second : nullptr;
+		const uint32_t sectorX = x / SECTOR_SIZE;
+		const uint32_t sectorY = y / SECTOR_SIZE;
+		// Also catches the coordinates wrapped below zero by the neighbour lookups
+		if (sectorX >= SECTOR_GRID_SIZE || sectorY >= SECTOR_GRID_SIZE) {
+			return nullptr;
+		}
+
+		const auto &block = sectorBlocks[(sectorY / SECTOR_BLOCK_SIZE) * SECTOR_BLOCKS + sectorX / SECTOR_BLOCK_SIZE];
+		return block ? (*block)[(sectorY % SECTOR_BLOCK_SIZE) * SECTOR_BLOCK_SIZE + sectorX % SECTOR_BLOCK_SIZE].get() : nullptr;
 	}
 
 protected:
 	std::shared_ptr<Tile> getOrCreateTileFromCache(const std::unique_ptr<Floor> &floor, uint16_t x, uint16_t y);
 
-	std::unordered_map<uint32_t, MapSector> mapSectors;
-
 private:
+	// Two level directory of the sectors, a block of 64x64 sectors is allocated when its first sector is created
+	static constexpr uint32_t SECTOR_GRID_SIZE = (std::numeric_limits<uint16_t>::max() + 1) / SECTOR_SIZE;
+	static constexpr uint32_t SECTOR_BLOCK_SIZE = 64;
+	static constexpr uint32_t SECTOR_BLOCKS = SECTOR_GRID_SIZE / SECTOR_BLOCK_SIZE;
+
+	using SectorBlock = std::array<std::unique_ptr<MapSector>, SECTOR_BLOCK_SIZE * SECTOR_BLOCK_SIZE>;
+
+	std::array<std::unique_ptr<SectorBlock>, SECTOR_BLOCKS * SECTOR_BLOCKS> sectorBlocks;
+
+	// Tiles of each floor built into a Tile and still waiting as a BasicTile
+	std::array<std::atomic<int64_t>, MAP_MAX_LAYERS> materializedTiles {};
+	std::array<std::atomic<int64_t>, MAP_MAX_LAYERS> cachedTiles {};
+	std::array<int64_t, MAP_MAX_LAYERS> publishedMaterializedTiles {};
+	std::array<int64_t, MAP_MAX_LAYERS> publishedCachedTiles {};
+
+	template <typename F>
+	void forEachSector(F &&f) {
+		for (uint32_t blockIndex = 0; blockIndex < sectorBlocks.size(); ++blockIndex) {
+			const auto &block = sectorBlocks[blockIndex];
+			if (!block) {
+				continue;
+			}
+
+			for (uint32_t index = 0; index < block->size(); ++index) {
+				if (const auto &sector = (*block)[index]) {
+					const uint32_t sectorX = (blockIndex % SECTOR_BLOCKS) * SECTOR_BLOCK_SIZE + index % SECTOR_BLOCK_SIZE;
+					const uint32_t sectorY = (blockIndex / SECTOR_BLOCKS) * SECTOR_BLOCK_SIZE + index / SECTOR_BLOCK_SIZE;
+					f(sectorX, sectorY, *sector);
+				}
+			}
+		}
+	}
+
+	uint32_t demoteIdleTiles(int64_t idleTime);
+	void updateTileMetrics();
+
 	void parseItemAttr(const std::shared_ptr<BasicItem> &BasicItem, std::shared_ptr<Item> item);
 	std::shared_ptr<Item> createItem(const std::shared_ptr<BasicItem> &BasicItem, Position position);
 };
@@ -11,36 +11,297 @@
 
 #include "spectators.hpp"
 #include "game/game.hpp"
+#include "lib/metrics/metrics.hpp"
+
+PositionMap<SpectatorsCache> Spectators::spectatorsCache;
+phmap::flat_hash_map<uint32_t, PositionSet> Spectators::sectorCacheIndex;
+
+namespace {
+	// Counters are accumulated locally and pushed in batches, as find() is too hot to touch the metrics lock on every call
+	constexpr uint32_t CACHE_METRICS_FLUSH_INTERVAL = 1024;
+
+	struct SpectatorsCacheMetrics {
+		uint32_t hits { 0 };
+		uint32_t misses { 0 };
+		uint32_t evictions { 0 };
+	} cacheMetrics;
+
+	// Everything flushed since the start, for the cache report
+	struct SpectatorsCacheTotals {
+		uint64_t hits { 0 };
+		uint64_t misses { 0 };
+		uint64_t evictions { 0 };
+	} cacheTotals;
+
+	/**
+	 * Calls the callback with the index of every mirrored position inside the search box.
+	 * A position passes when (z - minZ) <= depth, (x + z - baseX) <= width and (y + z - baseY) <= height,
+	 * all compared as unsigned, which is the same multi-floor offset check done by the scalar path.
+	 */
+	template <typename Callback>
+	void filterSectorPositions(const SectorPositions &positions, int32_t minZ, uint32_t depth, int32_t baseX, uint32_t width, int32_t baseY, uint32_t height, Callback &&callback) {
+		const size_t count = positions.size();
+		const int32_t* px = positions.x.data();
+		const int32_t* py = positions.y.data();
+		const int32_t* pz = positions.z.data();
+		size_t i = 0;
+
+#if defined(__AVX2__)
+		const __m256i minusOne = _mm256_set1_epi32(-1);
+		const __m256i vMinZ = _mm256_set1_epi32(minZ);
+		const __m256i vBaseX = _mm256_set1_epi32(baseX);
+		const __m256i vBaseY = _mm256_set1_epi32(baseY);
+		const __m256i vDepth = _mm256_set1_epi32(static_cast<int32_t>(depth) + 1);
+		const __m256i vWidth = _mm256_set1_epi32(static_cast<int32_t>(width) + 1);
+		const __m256i vHeight = _mm256_set1_epi32(static_cast<int32_t>(height) + 1);
+		for (; i + 8 <= count; i += 8) {
+			const __m256i z = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pz + i));
+			const __m256i dz = _mm256_sub_epi32(z, vMinZ);
+			const __m256i dx = _mm256_sub_epi32(_mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(px + i)), z), vBaseX);
+			const __m256i dy = _mm256_sub_epi32(_mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(py + i)), z), vBaseY);
+
+			__m256i inRange = _mm256_and_si256(_mm256_cmpgt_epi32(dz, minusOne), _mm256_cmpgt_epi32(vDepth, dz));
+			inRange = _mm256_and_si256(inRange, _mm256_and_si256(_mm256_cmpgt_epi32(dx, minusOne), _mm256_cmpgt_epi32(vWidth, dx)));
+			inRange = _mm256_and_si256(inRange, _mm256_and_si256(_mm256_cmpgt_epi32(dy, minusOne), _mm256_cmpgt_epi32(vHeight, dy)));
+
+			auto mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(inRange)));
+			while (mask != 0) {
+				callback(i + _mm_ctz(mask));
+				mask &= mask - 1;
+			}
+		}
+#elif defined(__SSE2__)
+		const __m128i minusOne = _mm_set1_epi32(-1);
+		const __m128i vMinZ = _mm_set1_epi32(minZ);
+		const __m128i vBaseX = _mm_set1_epi32(baseX);
+		const __m128i vBaseY = _mm_set1_epi32(baseY);
+		const __m128i vDepth = _mm_set1_epi32(static_cast<int32_t>(depth) + 1);
+		const __m128i vWidth = _mm_set1_epi32(static_cast<int32_t>(width) + 1);
+		const __m128i vHeight = _mm_set1_epi32(static_cast<int32_t>(height) + 1);
+		for (; i + 4 <= count; i += 4) {
+			const __m128i z = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pz + i));
+			const __m128i dz = _mm_sub_epi32(z, vMinZ);
+			const __m128i dx = _mm_sub_epi32(_mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(px + i)), z), vBaseX);
+			const __m128i dy = _mm_sub_epi32(_mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(py + i)), z), vBaseY);
+
+			__m128i inRange = _mm_and_si128(_mm_cmpgt_epi32(dz, minusOne), _mm_cmpgt_epi32(vDepth, dz));
+			inRange = _mm_and_si128(inRange, _mm_and_si128(_mm_cmpgt_epi32(dx, minusOne), _mm_cmpgt_epi32(vWidth, dx)));
+			inRange = _mm_and_si128(inRange, _mm_and_si128(_mm_cmpgt_epi32(dy, minusOne), _mm_cmpgt_epi32(vHeight, dy)));
+
+			auto mask = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(inRange)));
+			while (mask != 0) {
+				callback(i + _mm_ctz(mask));
+				mask &= mask - 1;
+			}
+		}
+#endif
 
-phmap::flat_hash_map<Position, SpectatorsCache> Spectators::spectatorsCache;
+		for (; i < count; ++i) {
+			if (static_cast<uint32_t>(pz[i] - minZ) <= depth
+			    && static_cast<uint32_t>(px[i] + pz[i] - baseX) <= width
+			    && static_cast<uint32_t>(py[i] + pz[i] - baseY) <= height) {
+				callback(i);
+			}
+		}
+	}
+}
 
 void Spectators::clearCache() {
+	cacheMetrics.evictions += static_cast<uint32_t>(spectatorsCache.size());
 	spectatorsCache.clear();
+	sectorCacheIndex.clear();
+}
+
+void Spectators::clearCache(const Position &pos) {
+	const uint32_t key = getSectorKey(pos.x / SECTOR_SIZE, pos.y / SECTOR_SIZE);
+	const auto indexIt = sectorCacheIndex.find(key);
+	if (indexIt == sectorCacheIndex.end()) {
+		return;
+	}
+
+	uint32_t evictions = 0;
+	for (const auto &centerPos : indexIt->second) {
+		const auto cacheIt = spectatorsCache.find(centerPos);
+		if (cacheIt == spectatorsCache.end()) {
+			continue;
+		}
+
+		unindexCache(centerPos, cacheIt->second, key);
+		spectatorsCache.erase(cacheIt);
+		++evictions;
+	}
+
+	sectorCacheIndex.erase(indexIt);
+	cacheMetrics.evictions += evictions;
+}
+
+void Spectators::indexCache(const Position &centerPos, SpectatorsCache &cache, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+	int32_t minSectorX = x1 / SECTOR_SIZE;
+	int32_t minSectorY = y1 / SECTOR_SIZE;
+	int32_t maxSectorX = x2 / SECTOR_SIZE;
+	int32_t maxSectorY = y2 / SECTOR_SIZE;
+
+	if (cache.indexed) {
+		if (minSectorX >= cache.minSectorX && maxSectorX <= cache.maxSectorX && minSectorY >= cache.minSectorY && maxSectorY <= cache.maxSectorY) {
+			return;
+		}
+
+		minSectorX = std::min<int32_t>(minSectorX, cache.minSectorX);
+		minSectorY = std::min<int32_t>(minSectorY, cache.minSectorY);
+		maxSectorX = std::max<int32_t>(maxSectorX, cache.maxSectorX);
+		maxSectorY = std::max<int32_t>(maxSectorY, cache.maxSectorY);
+	}
+
+	for (int32_t sy = minSectorY; sy <= maxSectorY; ++sy) {
+		for (int32_t sx = minSectorX; sx <= maxSectorX; ++sx) {
+			sectorCacheIndex[getSectorKey(sx, sy)].emplace(centerPos);
+		}
+	}
+
+	cache.indexed = true;
+	cache.minSectorX = minSectorX;
+	cache.minSectorY = minSectorY;
+	cache.maxSectorX = maxSectorX;
+	cache.maxSectorY = maxSectorY;
+}
+
+void Spectators::unindexCache(const Position &centerPos, const SpectatorsCache &cache, uint32_t skipKey) {
+	if (!cache.indexed) {
+		return;
+	}
+
+	for (int32_t sy = cache.minSectorY; sy <= cache.maxSectorY; ++sy) {
+		for (int32_t sx = cache.minSectorX; sx <= cache.maxSectorX; ++sx) {
+			const uint32_t key = getSectorKey(sx, sy);
+			if (key == skipKey) {
+				continue;
+			}
+
+			const auto it = sectorCacheIndex.find(key);
+			if (it == sectorCacheIndex.end()) {
+				continue;
+			}
+
+			it->second.erase(centerPos);
+			if (it->second.empty()) {
+				sectorCacheIndex.erase(it);
+			}
+		}
+	}
 }
 
-Spectators Spectators::insert(const std::shared_ptr<Creature> &creature) {
+void Spectators::addCacheMetric(bool hit) {
+	if (hit) {
+		++cacheMetrics.hits;
+	} else {
+		++cacheMetrics.misses;
+	}
+
+	if (cacheMetrics.hits + cacheMetrics.misses < CACHE_METRICS_FLUSH_INTERVAL) {
+		return;
+	}
+
+	g_metrics().addCounter("spectators_cache_hit", cacheMetrics.hits);
+	g_metrics().addCounter("spectators_cache_miss", cacheMetrics.misses);
+	g_metrics().addCounter("spectators_cache_eviction", cacheMetrics.evictions);
+	cacheTotals.hits += cacheMetrics.hits;
+	cacheTotals.misses += cacheMetrics.misses;
+	cacheTotals.evictions += cacheMetrics.evictions;
+	cacheMetrics = {};
+}
+
+std::string Spectators::getCacheReport() {
+	const uint64_t hits = cacheTotals.hits + cacheMetrics.hits;
+	const uint64_t misses = cacheTotals.misses + cacheMetrics.misses;
+	const uint64_t evictions = cacheTotals.evictions + cacheMetrics.evictions;
+	const double hitRate = hits + misses == 0 ? 0.0 : 100.0 * static_cast<double>(hits) / static_cast<double>(hits + misses);
+	return fmt::format(
+		"Cached positions: {}\nIndexed sectors: {}\nHits: {}\nMisses: {}\nHit rate: {:.2f}%\nEvictions: {}",
+		spectatorsCache.size(), sectorCacheIndex.size(), hits, misses, hitRate, evictions
+	);
+}
+
+Spectators &Spectators::insert(const std::shared_ptr<Creature> &creature) {
 	if (creature) {
 		creatures.emplace_back(creature);
 	}
 	return *this;
 }
 
-Spectators Spectators::insertAll(const CreatureVector &list) {
-	if (!list.empty()) {
-		const bool hasValue = !creatures.empty();
+Spectators &Spectators::insertAll(const CreatureVector &list) {
+	if (list.empty()) {
+		return *this;
+	}
 
-		creatures.insert(creatures.end(), list.begin(), list.end());
+	if (creatures.empty()) {
+		creatures = list;
+		return *this;
+	}
 
-		// Remove duplicate
-		if (hasValue) {
-			std::unordered_set uset(creatures.begin(), creatures.end());
-			creatures.clear();
-			creatures.insert(creatures.end(), uset.begin(), uset.end());
+	// Skips the creatures already listed, keeping the order of both lists
+	phmap::flat_hash_set<const Creature*> listed;
+	listed.reserve(creatures.size() + list.size());
+	for (const auto &creature : creatures) {
+		listed.emplace(creature.get());
+	}
+
+	creatures.reserve(creatures.size() + list.size());
+	for (const auto &creature : list) {
+		if (listed.emplace(creature.get()).second) {
+			creatures.emplace_back(creature);
 		}
 	}
 	return *this;
 }
 
+void Spectators::insertFound(CreatureVector &&found) {
+	if (creatures.empty()) {
+		creatures = std::move(found);
+	} else {
+		insertAll(found);
+	}
+}
+
+std::pair<uint8_t, uint8_t> Spectators::getFloorRange(const Position &centerPos, bool multifloor) {
+	if (!multifloor) {
+		return { centerPos.z, centerPos.z };
+	}
+
+	if (centerPos.z > MAP_INIT_SURFACE_LAYER) {
+		return {
+			static_cast<uint8_t>(std::max<int8_t>(centerPos.z - MAP_LAYER_VIEW_LIMIT, 0u)),
+			static_cast<uint8_t>(std::min<int8_t>(centerPos.z + MAP_LAYER_VIEW_LIMIT, MAP_MAX_LAYERS - 1))
+		};
+	} else if (centerPos.z == MAP_INIT_SURFACE_LAYER - 1) {
+		return { 0, (MAP_INIT_SURFACE_LAYER - 1) + MAP_LAYER_VIEW_LIMIT };
+	} else if (centerPos.z == MAP_INIT_SURFACE_LAYER) {
+		return { 0, MAP_INIT_SURFACE_LAYER + MAP_LAYER_VIEW_LIMIT };
+	}
+	return { 0, MAP_INIT_SURFACE_LAYER };
+}
+
+Spectators Spectators::filterPlayersInView(const Position &centerPos) const {
+	const auto [minRangeZ, maxRangeZ] = getFloorRange(centerPos, true);
+
+	Spectators specs;
+	specs.creatures.reserve(creatures.size());
+	for (const auto &creature : creatures) {
+		if (!creature->getPlayer()) {
+			continue;
+		}
+
+		// The same offset of the other floors as the sector scan of find
+		const auto &pos = creature->getPosition();
+		const int32_t offsetZ = pos.z - centerPos.z;
+		const int32_t dx = pos.x - centerPos.x + offsetZ;
+		const int32_t dy = pos.y - centerPos.y + offsetZ;
+		if (pos.z >= minRangeZ && pos.z <= maxRangeZ && std::abs(dx) <= MAP_MAX_VIEW_PORT_X && std::abs(dy) <= MAP_MAX_VIEW_PORT_Y) {
+			specs.creatures.emplace_back(creature);
+		}
+	}
+	return specs;
+}
+
 bool Spectators::checkCache(const SpectatorsCache::FloorData &specData, bool onlyPlayers, const Position &centerPos, bool checkDistance, bool multifloor, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
 	const auto &list = multifloor || !specData.floor ? specData.multiFloor : specData.floor;
 
@@ -55,7 +316,7 @@ bool Spectators::checkCache(const SpectatorsCache::FloorData &specData, bool onl
 
 	if (checkDistance) {
 		CreatureVector spectators;
-		spectators.reserve(creatures.size());
+		spectators.reserve(list->size());
 		for (const auto &creature : *list) {
 			const auto &specPos = creature->getPosition();
 			if (centerPos.x - specPos.x >= minRangeX
@@ -67,7 +328,7 @@ bool Spectators::checkCache(const SpectatorsCache::FloorData &specData, bool onl
 				spectators.emplace_back(creature);
 			}
 		}
-		insertAll(spectators);
+		insertFound(std::move(spectators));
 	} else {
 		insertAll(*list);
 	}
@@ -75,7 +336,7 @@ bool Spectators::checkCache(const SpectatorsCache::FloorData &specData, bool onl
 	return true;
 }
 
-Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onlyPlayers, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
+Spectators &Spectators::find(const Position &centerPos, bool multifloor, bool onlyPlayers, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
 	minRangeX = (minRangeX == 0 ? -MAP_MAX_VIEW_PORT_X : -minRangeX);
 	maxRangeX = (maxRangeX == 0 ? MAP_MAX_VIEW_PORT_X : maxRangeX);
 	minRangeY = (minRangeY == 0 ? -MAP_MAX_VIEW_PORT_Y : -minRangeY);
@@ -97,39 +358,27 @@ Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onl
 			if (onlyPlayers) {
 				// check players cache
 				if (checkCache(cache.players, true, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
+					addCacheMetric(true);
 					return *this;
 				}
 
 				// if there is no player cache, look for players in the creatures cache.
 				if (checkCache(cache.creatures, true, centerPos, true, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
+					addCacheMetric(true);
 					return *this;
 				}
 
 				// All Creatures
 			} else if (checkCache(cache.creatures, false, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
+				addCacheMetric(true);
 				return *this;
 			}
 		}
 	}
 
-	uint8_t minRangeZ = centerPos.z;
-	uint8_t maxRangeZ = centerPos.z;
+	addCacheMetric(false);
 
-	if (multifloor) {
-		if (centerPos.z > MAP_INIT_SURFACE_LAYER) {
-			minRangeZ = static_cast<uint8_t>(std::max<int8_t>(centerPos.z - MAP_LAYER_VIEW_LIMIT, 0u));
-			maxRangeZ = static_cast<uint8_t>(std::min<int8_t>(centerPos.z + MAP_LAYER_VIEW_LIMIT, MAP_MAX_LAYERS - 1));
-		} else if (centerPos.z == MAP_INIT_SURFACE_LAYER - 1) {
-			minRangeZ = 0;
-			maxRangeZ = (MAP_INIT_SURFACE_LAYER - 1) + MAP_LAYER_VIEW_LIMIT;
-		} else if (centerPos.z == MAP_INIT_SURFACE_LAYER) {
-			minRangeZ = 0;
-			maxRangeZ = MAP_INIT_SURFACE_LAYER + MAP_LAYER_VIEW_LIMIT;
-		} else {
-			minRangeZ = 0;
-			maxRangeZ = MAP_INIT_SURFACE_LAYER;
-		}
-	}
+	const auto [minRangeZ, maxRangeZ] = getFloorRange(centerPos, multifloor);
 
 	const int32_t min_y = centerPos.y + minRangeY;
 	const int32_t min_x = centerPos.x + minRangeX;
@@ -140,6 +389,10 @@ Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onl
 	const auto height = static_cast<uint32_t>(max_y - min_y);
 	const auto depth = static_cast<uint32_t>(maxRangeZ - minRangeZ);
 
+	// x - offsetZ - min_x == x + z - (min_x + centerPos.z), the same for y
+	const int32_t baseX = min_x + centerPos.z;
+	const int32_t baseY = min_y + centerPos.z;
+
 	const int32_t minoffset = centerPos.getZ() - maxRangeZ;
 	const int32_t x1 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, min_x + minoffset));
 	const int32_t y1 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, min_y + minoffset));
@@ -163,15 +416,10 @@ Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onl
 		for (int32_t nx = startx1; nx <= endx2; nx += SECTOR_SIZE) {
 			if (sectorE) {
 				const auto &node_list = onlyPlayers ? sectorE->player_list : sectorE->creature_list;
-				for (const auto &creature : node_list) {
-					const auto &cpos = creature->getPosition();
-					if (static_cast<uint32_t>(static_cast<int32_t>(cpos.z) - minRangeZ) <= depth) {
-						const int_fast16_t offsetZ = Position::getOffsetZ(centerPos, cpos);
-						if (static_cast<uint32_t>(cpos.x - offsetZ - min_x) <= width && static_cast<uint32_t>(cpos.y - offsetZ - min_y) <= height) {
-							spectators.emplace_back(creature);
-						}
-					}
-				}
+				const auto &positions = onlyPlayers ? sectorE->player_positions : sectorE->creature_positions;
+				filterSectorPositions(positions, minRangeZ, depth, baseX, width, baseY, height, [&](size_t index) {
+					spectators.emplace_back(node_list[index]);
+				});
 				sectorE = sectorE->sectorE;
 			} else {
 				sectorE = g_game().map.getMapSector(nx + SECTOR_SIZE, ny);
@@ -187,6 +435,8 @@ Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onl
 
 	// It is necessary to create the cache even if no spectators is found, so that there is no future query.
 	auto &cache = cacheFound ? it->second : spectatorsCache.emplace(centerPos, SpectatorsCache { .minRangeX = minRangeX, .maxRangeX = maxRangeX, .minRangeY = minRangeY, .maxRangeY = maxRangeY, .creatures = {}, .players = {} }).first->second;
+	indexCache(centerPos, cache, x1, y1, x2, y2);
+
 	auto &creaturesCache = onlyPlayers ? cache.players : cache.creatures;
 	auto &creatureList = (multifloor ? creaturesCache.multiFloor : creaturesCache.floor);
 	if (creatureList) {
@@ -196,9 +446,8 @@ Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onl
 	}
 
 	if (!spectators.empty()) {
-		insertAll(spectators);
-
 		creatureList->insert(creatureList->end(), spectators.begin(), spectators.end());
+		insertFound(std::move(spectators));
 	}
 
 	return *this;
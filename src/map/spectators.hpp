@@ -29,26 +29,61 @@ struct SpectatorsCache {
 
 	FloorData creatures;
 	FloorData players;
+
+	// Sector bounds (in sector units) covered by this entry, used by the invalidation index
+	bool indexed { false };
+	int32_t minSectorX { 0 };
+	int32_t maxSectorX { 0 };
+	int32_t minSectorY { 0 };
+	int32_t maxSectorY { 0 };
 };
 
 class Spectators {
 public:
 	static void clearCache();
 
+	/**
+	 * @brief Drops only the cache entries whose scanned area overlaps the sector of the given position.
+	 * @param pos The position where a creature was added or removed.
+	 */
+	static void clearCache(const Position &pos);
+
+	/**
+	 * @brief Summarizes the cache: its size and its hits, misses and evictions since the start.
+	 * Only called on the dispatcher, like the cache itself.
+	 */
+	static std::string getCacheReport();
+
 	template <typename T>
 		requires std::is_same_v<Creature, T> || std::is_same_v<Player, T>
-	Spectators find(const Position &centerPos, bool multifloor = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0) {
+	Spectators &find(const Position &centerPos, bool multifloor = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0) & {
 		constexpr bool onlyPlayers = std::is_same_v<T, Player>;
 		return find(centerPos, multifloor, onlyPlayers, minRangeX, maxRangeX, minRangeY, maxRangeY);
 	}
 
+	// Spectators().find<T>(...) hands its list over instead of copying it
 	template <typename T>
-		requires std::is_base_of_v<Creature, T>
-	Spectators filter();
+		requires std::is_same_v<Creature, T> || std::is_same_v<Player, T>
+	Spectators find(const Position &centerPos, bool multifloor = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0) && {
+		constexpr bool onlyPlayers = std::is_same_v<T, Player>;
+		find(centerPos, multifloor, onlyPlayers, minRangeX, maxRangeX, minRangeY, maxRangeY);
+		return std::move(*this);
+	}
 
-	Spectators insert(const std::shared_ptr<Creature> &creature);
-	Spectators insertAll(const CreatureVector &list);
-	Spectators join(const Spectators &anotherSpectators) {
+	template <typename T>
+		requires std::is_base_of_v<Creature, T>
+	Spectators filter() const;
+
+	/**
+	 * @brief The ones of this list a multi-floor find<Player>(centerPos, true) would find, without a lookup.
+	 * For the viewers of a position out of a list already found over an area covering its view port,
+	 * such as the one of a move; the positions are read now, not when the list was found.
+	 */
+	Spectators filterPlayersInView(const Position &centerPos) const;
+
+	Spectators &insert(const std::shared_ptr<Creature> &creature);
+	Spectators &insertAll(const CreatureVector &list);
+	Spectators &join(const Spectators &anotherSpectators) {
 		return insertAll(anotherSpectators.creatures);
 	}
 
@@ -81,9 +116,23 @@ public:
 	}
 
 private:
-	static phmap::flat_hash_map<Position, SpectatorsCache> spectatorsCache;
+	static PositionMap<SpectatorsCache> spectatorsCache;
+	// Sector key -> center positions of the cache entries that scanned that sector
+	static phmap::flat_hash_map<uint32_t, PositionSet> sectorCacheIndex;
+
+	static uint32_t getSectorKey(int32_t sectorX, int32_t sectorY) {
+		return static_cast<uint32_t>(sectorX) | static_cast<uint32_t>(sectorY) << 16;
+	}
+
+	static void indexCache(const Position &centerPos, SpectatorsCache &cache, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+	static void unindexCache(const Position &centerPos, const SpectatorsCache &cache, uint32_t skipKey);
+	static void addCacheMetric(bool hit);
+	// Floors scanned around centerPos, the visible ones when multifloor
+	static std::pair<uint8_t, uint8_t> getFloorRange(const Position &centerPos, bool multifloor);
 
-	Spectators find(const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0);
+	Spectators &find(const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0);
+	// Same as insertAll, but takes the found list over when nothing was listed yet
+	void insertFound(CreatureVector &&found);
 	bool checkCache(const SpectatorsCache::FloorData &specData, bool onlyPlayers, const Position &centerPos, bool checkDistance, bool multifloor, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY);
 
 	CreatureVector creatures;
@@ -91,22 +140,22 @@ private:
 
 template <typename T>
 	requires std::is_base_of_v<Creature, T>
-Spectators Spectators::filter() {
+Spectators Spectators::filter() const {
 	auto specs = Spectators();
 	specs.creatures.reserve(creatures.size());
 
 	for (const auto &c : creatures) {
 		if constexpr (std::is_same_v<T, Player>) {
 			if (c->getPlayer() != nullptr) {
-				specs.insert(c);
+				specs.creatures.emplace_back(c);
 			}
 		} else if constexpr (std::is_same_v<T, Monster>) {
 			if (c->getMonster() != nullptr) {
-				specs.insert(c);
+				specs.creatures.emplace_back(c);
 			}
 		} else if constexpr (std::is_same_v<T, Npc>) {
 			if (c->getNpc() != nullptr) {
-				specs.insert(c);
+				specs.creatures.emplace_back(c);
 			}
 		}
 	}
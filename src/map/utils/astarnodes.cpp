@@ -35,6 +35,32 @@ AStarNodes::AStarNodes(uint32_t x, uint32_t y, int_fast32_t extraCost) :
 	_mm_sfence();
 #endif
 
+	setStartNode(x, y, extraCost);
+}
+
+AStarNodes &AStarNodes::acquire(uint32_t x, uint32_t y, int_fast32_t extraCost) {
+	thread_local std::unique_ptr<AStarNodes> arena;
+	if (!arena) {
+		arena = std::make_unique<AStarNodes>(x, y, extraCost);
+	} else {
+		arena->reset(x, y, extraCost);
+	}
+	return *arena;
+}
+
+void AStarNodes::reset(uint32_t x, uint32_t y, int_fast32_t extraCost) {
+	// Only the nodes of the previous search are dirty, the vector scans of getBestNode read whole 16 node blocks
+	std::fill_n(openNodes, curNode, false);
+#if defined(__SSE2__)
+	std::fill_n(calculatedNodes, std::min<int32_t>((curNode + 15) & ~15, MAX_NODES), std::numeric_limits<int32_t>::max());
+#endif
+#if defined(FEATURE_ASTAR_BINARY_HEAP)
+	openHeap.clear();
+#endif
+	setStartNode(x, y, extraCost);
+}
+
+void AStarNodes::setStartNode(uint32_t x, uint32_t y, int_fast32_t extraCost) {
 	curNode = 1;
 	closedNodes = 0;
 	openNodes[0] = true;
@@ -50,8 +76,19 @@ AStarNodes::AStarNodes(uint32_t x, uint32_t y, int_fast32_t extraCost) :
 #if defined(__SSE2__)
 	calculatedNodes[0] = 0;
 #endif
+#if defined(FEATURE_ASTAR_BINARY_HEAP)
+	openHeap.reserve(MAX_NODES);
+	pushOpenEntry(0);
+#endif
 }
 
+#if defined(FEATURE_ASTAR_BINARY_HEAP)
+void AStarNodes::pushOpenEntry(int32_t index) {
+	openHeap.emplace_back(nodes[index].f + nodes[index].g, index);
+	std::push_heap(openHeap.begin(), openHeap.end(), std::greater<>());
+}
+#endif
+
 bool AStarNodes::createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f, int_fast32_t heuristic, int_fast32_t extraCost) {
 	if (curNode >= MAX_NODES) {
 		return false;
@@ -70,13 +107,27 @@ bool AStarNodes::createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_f
 	nodesTable[retNode] = (x << 16) | y;
 #if defined(__SSE2__)
 	calculatedNodes[retNode] = f + heuristic;
+#endif
+#if defined(FEATURE_ASTAR_BINARY_HEAP)
+	pushOpenEntry(retNode);
 #endif
 	return true;
 }
 
 AStarNode* AStarNodes::getBestNode() {
+#if defined(FEATURE_ASTAR_BINARY_HEAP)
+	// Ties go to the oldest node, as in the scalar scan
+	while (!openHeap.empty()) {
+		const auto [cost, index] = openHeap.front();
+		if (openNodes[index] && cost == nodes[index].f + nodes[index].g) {
+			return &nodes[index];
+		}
+		std::pop_heap(openHeap.begin(), openHeap.end(), std::greater<>());
+		openHeap.pop_back();
+	}
+	return nullptr;
 // Branchless best node search
-#if defined(__AVX512F__)
+#elif defined(__AVX512F__)
 	const __m512i increment = _mm512_set1_epi32(16);
 	__m512i indices = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
 	__m512i minindices = indices;
@@ -206,6 +257,9 @@ void AStarNodes::openNode(const AStarNode* node) {
 #endif
 	closedNodes -= (openNodes[index] ? 0 : 1);
 	openNodes[index] = true;
+#if defined(FEATURE_ASTAR_BINARY_HEAP)
+	pushOpenEntry(static_cast<int32_t>(index));
+#endif
 }
 
 int32_t AStarNodes::getClosedNodes() const {
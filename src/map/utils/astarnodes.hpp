@@ -23,6 +23,12 @@ class AStarNodes {
 public:
 	AStarNodes(uint32_t x, uint32_t y, int_fast32_t extraCost);
 
+	/**
+	 * @brief Returns the node arena of the calling thread, ready for a search from x, y.
+	 * The arena is reused by every search of the thread, so it must not be held across two searches.
+	 */
+	static AStarNodes &acquire(uint32_t x, uint32_t y, int_fast32_t extraCost);
+
 	bool createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f, int_fast32_t heuristic, int_fast32_t extraCost);
 	AStarNode* getBestNode();
 	void closeNode(const AStarNode* node);
@@ -39,6 +45,9 @@ private:
 	static constexpr int32_t MAP_PREFERDIAGONALWALKCOST = 14;
 	static constexpr int32_t MAP_DIAGONALWALKCOST = 25;
 
+	void reset(uint32_t x, uint32_t y, int_fast32_t extraCost);
+	void setStartNode(uint32_t x, uint32_t y, int_fast32_t extraCost);
+
 #if defined(__SSE2__)
 	alignas(16) uint32_t nodesTable[MAX_NODES];
 	alignas(64) int32_t calculatedNodes[MAX_NODES];
@@ -50,4 +59,13 @@ private:
 	int32_t closedNodes;
 	int32_t curNode;
 	bool openNodes[MAX_NODES];
+
+#if defined(FEATURE_ASTAR_BINARY_HEAP)
+	// Open list as a min heap of (f + g, node), stale entries are skipped when popped
+	using OpenEntry = std::pair<int32_t, int32_t>;
+
+	void pushOpenEntry(int32_t index);
+
+	std::vector<OpenEntry> openHeap;
+#endif
 };
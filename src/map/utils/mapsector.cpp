@@ -10,14 +10,60 @@
 #include "pch.hpp"
 
 #include "creatures/creature.hpp"
+#include "game/scheduling/dispatcher.hpp"
 #include "mapsector.hpp"
 
 bool MapSector::newSector = false;
 
+bool Floor::isSerialRead() {
+	return !g_dispatcher().context().isAsync();
+}
+
+void SectorPositions::add(const Position &pos) {
+	x.emplace_back(pos.x);
+	y.emplace_back(pos.y);
+	z.emplace_back(pos.z);
+}
+
+void SectorPositions::set(size_t index, const Position &pos) {
+	x[index] = pos.x;
+	y[index] = pos.y;
+	z[index] = pos.z;
+}
+
+void SectorPositions::swapRemove(size_t index) {
+	x[index] = x.back();
+	y[index] = y.back();
+	z[index] = z.back();
+	x.pop_back();
+	y.pop_back();
+	z.pop_back();
+}
+
 void MapSector::addCreature(const std::shared_ptr<Creature> &c) {
+	const auto &pos = c->getPosition();
 	creature_list.emplace_back(c);
+	creature_positions.add(pos);
 	if (c->getPlayer()) {
 		player_list.emplace_back(c);
+		player_positions.add(pos);
+	}
+}
+
+void MapSector::updateCreaturePosition(const std::shared_ptr<Creature> &c) {
+	const auto &pos = c->getPosition();
+	auto iter = std::find(creature_list.begin(), creature_list.end(), c);
+	if (iter == creature_list.end()) {
+		return;
+	}
+
+	creature_positions.set(static_cast<size_t>(iter - creature_list.begin()), pos);
+
+	if (c->getPlayer()) {
+		iter = std::find(player_list.begin(), player_list.end(), c);
+		if (iter != player_list.end()) {
+			player_positions.set(static_cast<size_t>(iter - player_list.begin()), pos);
+		}
 	}
 }
 
@@ -29,6 +75,7 @@ void MapSector::removeCreature(const std::shared_ptr<Creature> &c) {
 	}
 
 	assert(iter != creature_list.end());
+	creature_positions.swapRemove(static_cast<size_t>(iter - creature_list.begin()));
 	*iter = creature_list.back();
 	creature_list.pop_back();
 
@@ -40,6 +87,7 @@ void MapSector::removeCreature(const std::shared_ptr<Creature> &c) {
 		}
 
 		assert(iter != player_list.end());
+		player_positions.swapRemove(static_cast<size_t>(iter - player_list.begin()));
 		*iter = player_list.back();
 		player_list.pop_back();
 	}
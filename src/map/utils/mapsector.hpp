@@ -10,16 +10,34 @@
 #pragma once
 
 #include "map/map_const.hpp"
+#include "game/movement/position.hpp"
 
 class Creature;
 class Tile;
 struct BasicTile;
 
 struct Floor {
+	// Path flags of a loaded tile, enough for the pathfinding to skip the tile when it has no creature and no field
+	static constexpr uint8_t PATH_TILE = 1 << 0;
+	static constexpr uint8_t PATH_FIELD = 1 << 1;
+	static constexpr uint8_t PATH_CREATURE = 1 << 2;
+	// Mirror of TILESTATE_BLOCKPROJECTILE, so the sight lines read it without the tile
+	static constexpr uint8_t PATH_BLOCKPROJECTILE = 1 << 3;
+	// Tile a monster never walks on: no ground, floor change, teleport or an immovable blocking item
+	static constexpr uint8_t PATH_BLOCKMONSTER = 1 << 4;
+	// Tile whose walkability depends on the monster: protection zone, movable blocking item or walkable sea
+	static constexpr uint8_t PATH_CHECKMONSTER = 1 << 5;
+	// Flags that decide the walk cost of a tile
+	static constexpr uint8_t PATH_WALK_FLAGS = PATH_TILE | PATH_FIELD | PATH_CREATURE;
+
 	explicit Floor(uint8_t z) :
 		z(z) { }
 
 	std::shared_ptr<Tile> getTile(uint16_t x, uint16_t y) const {
+		if (isSerialRead()) {
+			return tiles[x & SECTOR_MASK][y & SECTOR_MASK].first;
+		}
+
 		std::shared_lock sl(mutex);
 		return tiles[x & SECTOR_MASK][y & SECTOR_MASK].first;
 	}
@@ -29,6 +47,10 @@ struct Floor {
 	}
 
 	std::shared_ptr<BasicTile> getTileCache(uint16_t x, uint16_t y) const {
+		if (isSerialRead()) {
+			return tiles[x & SECTOR_MASK][y & SECTOR_MASK].second;
+		}
+
 		std::shared_lock sl(mutex);
 		return tiles[x & SECTOR_MASK][y & SECTOR_MASK].second;
 	}
@@ -41,20 +63,65 @@ struct Floor {
 		return tiles;
 	}
 
+	// Lock free, a concurrent update is seen either way by the next search
+	uint8_t getPathFlags(uint16_t x, uint16_t y) const {
+		return pathFlags[x & SECTOR_MASK][y & SECTOR_MASK].load(std::memory_order_relaxed);
+	}
+
+	void setPathFlags(uint16_t x, uint16_t y, uint8_t flags) {
+		pathFlags[x & SECTOR_MASK][y & SECTOR_MASK].store(flags, std::memory_order_relaxed);
+	}
+
 	uint8_t getZ() const {
 		return z;
 	}
 
+	// Last time a tile of the floor was materialized, idle tiles are only demoted after it
+	int64_t getLastMaterialized() const {
+		return lastMaterialized.load(std::memory_order_relaxed);
+	}
+
+	void setLastMaterialized(int64_t time) {
+		lastMaterialized.store(time, std::memory_order_relaxed);
+	}
+
 	auto &getMutex() const {
 		return mutex;
 	}
 
 private:
+	/**
+	 * Serial dispatcher tasks never run next to a parallel batch, so no writer can race them and they skip the lock.
+	 * Parallel batches and the other threads read under the shared lock, tiles are materialized under the unique lock.
+	 */
+	static bool isSerialRead();
+
 	std::pair<std::shared_ptr<Tile>, std::shared_ptr<BasicTile>> tiles[SECTOR_SIZE][SECTOR_SIZE] = {};
-	mutable std::shared_mutex mutex;
+	std::atomic<uint8_t> pathFlags[SECTOR_SIZE][SECTOR_SIZE] = {};
+	mutable ProfiledMutex<std::shared_mutex> mutex { "floor" };
+	std::atomic<int64_t> lastMaterialized = 0;
 	uint8_t z { 0 };
 };
 
+/**
+ * Structure-of-arrays mirror of the creature positions of a sector.
+ * Each index matches the same index of the creature list it mirrors, so range
+ * checks can run over packed coordinates without touching the creatures.
+ */
+struct SectorPositions {
+	std::vector<int32_t> x;
+	std::vector<int32_t> y;
+	std::vector<int32_t> z;
+
+	size_t size() const noexcept {
+		return x.size();
+	}
+
+	void add(const Position &pos);
+	void set(size_t index, const Position &pos);
+	void swapRemove(size_t index);
+};
+
 class MapSector {
 public:
 	MapSector() = default;
@@ -77,6 +144,7 @@ public:
 
 	void addCreature(const std::shared_ptr<Creature> &c);
 	void removeCreature(const std::shared_ptr<Creature> &c);
+	void updateCreaturePosition(const std::shared_ptr<Creature> &c);
 
 private:
 	static bool newSector;
@@ -84,8 +152,14 @@ private:
 	MapSector* sectorE = nullptr;
 	std::vector<std::shared_ptr<Creature>> creature_list;
 	std::vector<std::shared_ptr<Creature>> player_list;
+	SectorPositions creature_positions;
+	SectorPositions player_positions;
 	std::unique_ptr<Floor> floors[MAP_MAX_LAYERS] = {};
 	uint32_t floorBits = 0;
+	// Last idle tile check that found a player in or next to this sector
+	int64_t lastActive = 0;
+	// Players in this sector and the eight around it, on any floor
+	uint32_t nearbyPlayers = 0;
 
 	friend class Spectators;
 	friend class MapCache;
@@ -0,0 +1,204 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "map/utils/pathcache.hpp"
+#include "map/utils/astarnodes.hpp"
+#include "creatures/creature.hpp"
+#include "creatures/monsters/monster.hpp"
+#include "game/game.hpp"
+#include "lib/metrics/metrics.hpp"
+
+namespace {
+	// Same costs as AStarNodes::getMapWalkCost
+	constexpr uint32_t STRAIGHT_COST = 10;
+	constexpr uint32_t DIAGONAL_COST = 35;
+
+	constexpr std::array<std::pair<int32_t, int32_t>, 8> NEIGHBORS = { { { -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } } };
+
+	Direction getStepDirection(int32_t dx, int32_t dy) {
+		if (dy < 0) {
+			return dx < 0 ? DIRECTION_NORTHWEST : (dx > 0 ? DIRECTION_NORTHEAST : DIRECTION_NORTH);
+		} else if (dy > 0) {
+			return dx < 0 ? DIRECTION_SOUTHWEST : (dx > 0 ? DIRECTION_SOUTHEAST : DIRECTION_SOUTH);
+		}
+		return dx < 0 ? DIRECTION_WEST : DIRECTION_EAST;
+	}
+}
+
+size_t FollowPathCache::KeyHash::operator()(const Key &key) const {
+	size_t hash = std::hash<const MonsterType*>()(key.monsterType);
+	hash ^= (static_cast<size_t>(key.targetPos.x) | static_cast<size_t>(key.targetPos.y) << 16 | static_cast<size_t>(key.targetPos.z) << 32) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	hash ^= static_cast<size_t>(key.maxSearchDist) << 4 | key.summon << 3 | key.fullPathSearch << 2 | key.clearSight << 1 | key.allowDiagonal;
+	return hash;
+}
+
+uint32_t FollowPathCache::Field::getCost(const Position &pos) const {
+	const int32_t x = pos.x - origin.x;
+	const int32_t y = pos.y - origin.y;
+	if (pos.z != origin.z || x < 0 || y < 0 || x >= size || y >= size) {
+		return UNREACHABLE;
+	}
+	return costs[y * size + x];
+}
+
+std::shared_ptr<const FollowPathCache::Field> FollowPathCache::buildField(const std::shared_ptr<Monster> &monster, const Position &targetPos, int32_t radius) {
+	metrics::method_latency measure(__METHOD_NAME__);
+	auto field = std::make_shared<Field>();
+	field->origin = Position(static_cast<uint16_t>(std::max<int32_t>(targetPos.x - radius, 0)), static_cast<uint16_t>(std::max<int32_t>(targetPos.y - radius, 0)), targetPos.z);
+	field->size = radius * 2 + 1;
+	field->costs.assign(field->size * field->size, UNREACHABLE);
+
+	// Walkability without creatures, they move too often for a shared field
+	std::vector<int8_t> walkable(field->costs.size(), -1);
+	const auto isWalkable = [&](const Position &pos, size_t index) {
+		if (walkable[index] < 0) {
+			const auto &tile = g_game().map.getTile(pos);
+			walkable[index] = tile && tile->queryAdd(0, monster, 1, FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE | FLAG_IGNOREBLOCKCREATURE) == RETURNVALUE_NOERROR;
+		}
+		return walkable[index] == 1;
+	};
+
+	using Node = std::pair<uint32_t, uint32_t>;
+	std::priority_queue<Node, std::vector<Node>, std::greater<>> open;
+
+	// The target tile itself is not walkable for the follower, it is only the seed
+	const auto seed = static_cast<uint32_t>((targetPos.y - field->origin.y) * field->size + (targetPos.x - field->origin.x));
+	field->costs[seed] = 0;
+	open.emplace(0, seed);
+	while (!open.empty()) {
+		const auto [cost, index] = open.top();
+		open.pop();
+		if (cost != field->costs[index]) {
+			continue;
+		}
+
+		const int32_t x = static_cast<int32_t>(index) % field->size;
+		const int32_t y = static_cast<int32_t>(index) / field->size;
+		for (const auto &[dx, dy] : NEIGHBORS) {
+			const int32_t nextX = x + dx;
+			const int32_t nextY = y + dy;
+			if (nextX < 0 || nextY < 0 || nextX >= field->size || nextY >= field->size) {
+				continue;
+			}
+
+			const auto next = static_cast<size_t>(nextY * field->size + nextX);
+			const Position pos(static_cast<uint16_t>(field->origin.x + nextX), static_cast<uint16_t>(field->origin.y + nextY), targetPos.z);
+			if (!isWalkable(pos, next)) {
+				continue;
+			}
+
+			const auto &tile = g_game().map.getTile(pos);
+			const uint32_t nextCost = cost + (dx != 0 && dy != 0 ? DIAGONAL_COST : STRAIGHT_COST) + static_cast<uint32_t>(AStarNodes::getTileWalkCost(monster, tile));
+			if (nextCost < field->costs[next]) {
+				field->costs[next] = nextCost;
+				open.emplace(nextCost, static_cast<uint32_t>(next));
+			}
+		}
+	}
+
+	g_metrics().addCounter("pathfinding_cache_fields", 1);
+	return field;
+}
+
+bool FollowPathCache::getPath(const std::shared_ptr<Monster> &monster, const Position &targetPos, const FindPathParams &fpp, std::vector<Direction> &dirList) {
+	if (fpp.keepDistance || fpp.maxTargetDist != 1 || fpp.maxSearchDist <= 0) {
+		return false;
+	}
+
+	const Position &startPos = monster->getPosition();
+	if (startPos.z != targetPos.z) {
+		return false;
+	}
+
+	const Key key { targetPos, monster->getMonsterType().get(), fpp.maxSearchDist, monster->isSummon(), fpp.fullPathSearch, fpp.clearSight, fpp.allowDiagonal };
+	const int64_t now = OTSYS_TIME();
+	const uint32_t currentVersion = version.load(std::memory_order_relaxed);
+
+	std::shared_ptr<Entry> entry;
+	{
+		std::scoped_lock lock(entriesMutex);
+		if (now - lastPrune > FIELD_TTL) {
+			std::erase_if(entries, [&](const auto &it) {
+				return now - it.second->created > FIELD_TTL || it.second->version != currentVersion;
+			});
+			lastPrune = now;
+		}
+
+		auto &slot = entries[key];
+		if (!slot || now - slot->created > FIELD_TTL || slot->version != currentVersion) {
+			slot = std::make_shared<Entry>();
+			slot->created = now;
+			slot->version = currentVersion;
+		}
+
+		// A lone follower is cheaper with its own search
+		if (++slot->requests < 2) {
+			return false;
+		}
+		entry = slot;
+	}
+
+	std::shared_ptr<const Field> field;
+	{
+		std::scoped_lock lock(entry->buildMutex);
+		if (!entry->field) {
+			entry->field = buildField(monster, targetPos, fpp.maxSearchDist);
+		}
+		field = entry->field;
+	}
+
+	// Walk down the field until a tile where the monster can attack from
+	const FrozenPathingConditionCall pathCondition(targetPos);
+	std::vector<Direction> steps;
+	Position pos = startPos;
+	int32_t bestMatch = 0;
+	while (!pathCondition(startPos, pos, fpp, bestMatch)) {
+		const uint32_t cost = field->getCost(pos);
+		if (cost == UNREACHABLE || steps.size() > static_cast<size_t>(fpp.maxSearchDist) * 2) {
+			return false;
+		}
+
+		uint32_t bestCost = cost;
+		Position bestPos;
+		for (const auto &[dx, dy] : NEIGHBORS) {
+			if (!fpp.allowDiagonal && dx != 0 && dy != 0) {
+				continue;
+			}
+
+			const Position next(static_cast<uint16_t>(pos.x + dx), static_cast<uint16_t>(pos.y + dy), pos.z);
+			if (Position::getDistanceX(startPos, next) > fpp.maxSearchDist || Position::getDistanceY(startPos, next) > fpp.maxSearchDist) {
+				continue;
+			}
+
+			const uint32_t nextCost = field->getCost(next);
+			if (nextCost < bestCost && g_game().map.canWalkTo(monster, next)) {
+				bestCost = nextCost;
+				bestPos = next;
+			}
+		}
+
+		// Blocked by another creature, or a change the field does not know about yet
+		if (bestCost == cost) {
+			return false;
+		}
+
+		steps.emplace_back(getStepDirection(bestPos.x - pos.x, bestPos.y - pos.y));
+		pos = bestPos;
+	}
+
+	if (steps.empty()) {
+		return false;
+	}
+
+	g_metrics().addCounter("pathfinding_cache_hits", 1);
+	dirList.insert(dirList.end(), steps.rbegin(), steps.rend());
+	return true;
+}
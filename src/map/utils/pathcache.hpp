@@ -0,0 +1,93 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/movement/position.hpp"
+
+class Monster;
+class MonsterType;
+struct FindPathParams;
+
+/**
+ * Distance fields shared by the monsters chasing the same target.
+ *
+ * The first melee follower of a target searches alone; once a second
+ * monster of the same type asks for the same target, one Dijkstra field is
+ * built around the target and every follower walks down it instead of
+ * running its own A*. A field lives until the target moves, FIELD_TTL
+ * passes or the static walkability of the map changes.
+ *
+ * The field ignores creatures, every step is still checked against the
+ * follower walk cache, and a follower that finds no way down falls back to
+ * its own search.
+ */
+class FollowPathCache {
+public:
+	static constexpr int64_t FIELD_TTL = 1000;
+
+	/**
+	 * @brief Fills the path in the same reversed order as Map::getPathMatching.
+	 * @return false when the monster must run its own search.
+	 */
+	bool getPath(const std::shared_ptr<Monster> &monster, const Position &targetPos, const FindPathParams &fpp, std::vector<Direction> &dirList);
+
+	// Fields kept, including the expired ones not pruned yet
+	size_t getFieldCount() {
+		std::scoped_lock lock(entriesMutex);
+		return entries.size();
+	}
+
+	// Drops every field, called when an item changes the walkability of a tile
+	void invalidate() {
+		version.fetch_add(1, std::memory_order_relaxed);
+	}
+
+private:
+	static constexpr uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max();
+
+	struct Key {
+		Position targetPos;
+		const MonsterType* monsterType;
+		int32_t maxSearchDist;
+		bool summon;
+		bool fullPathSearch;
+		bool clearSight;
+		bool allowDiagonal;
+
+		bool operator==(const Key &other) const = default;
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key &key) const;
+	};
+
+	struct Field {
+		Position origin;
+		int32_t size = 0;
+		std::vector<uint32_t> costs;
+
+		uint32_t getCost(const Position &pos) const;
+	};
+
+	struct Entry {
+		int64_t created = 0;
+		uint32_t version = 0;
+		uint32_t requests = 0;
+		std::mutex buildMutex;
+		std::shared_ptr<const Field> field;
+	};
+
+	static std::shared_ptr<const Field> buildField(const std::shared_ptr<Monster> &monster, const Position &targetPos, int32_t radius);
+
+	std::unordered_map<Key, std::shared_ptr<Entry>, KeyHash> entries;
+	std::mutex entriesMutex;
+	int64_t lastPrune = 0;
+	std::atomic<uint32_t> version = 0;
+};
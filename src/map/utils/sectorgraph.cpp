@@ -0,0 +1,430 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "map/utils/sectorgraph.hpp"
+#include "map/map.hpp"
+#include "items/tile.hpp"
+#include "creatures/creatures_definitions.hpp"
+#include "lib/metrics/metrics.hpp"
+
+namespace {
+	constexpr uint64_t START_NODE = std::numeric_limits<uint64_t>::max();
+	constexpr uint64_t GOAL_NODE = START_NODE - 1;
+
+	constexpr std::array<std::pair<int32_t, int32_t>, 4> STRAIGHT_STEPS = { { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } } };
+
+	Direction getStepDirection(int32_t dx, int32_t dy) {
+		if (dx > 0) {
+			return DIRECTION_EAST;
+		} else if (dx < 0) {
+			return DIRECTION_WEST;
+		} else if (dy > 0) {
+			return DIRECTION_SOUTH;
+		}
+		return DIRECTION_NORTH;
+	}
+
+	bool blocksPath(uint16_t itemId) {
+		return Item::items.hasFlag(itemId, ITEMTYPE_FLAG_BLOCKSOLID) || Item::items.hasFlag(itemId, ITEMTYPE_FLAG_BLOCKPATHFIND) || Item::items.hasFlag(itemId, ITEMTYPE_FLAG_FLOORCHANGE) || Item::items.hasFlag(itemId, ITEMTYPE_FLAG_TELEPORT);
+	}
+}
+
+bool SectorGraph::affectsWalkability(uint16_t itemId) {
+	return Item::items.hasFlag(itemId, ITEMTYPE_FLAG_GROUNDTILE) || blocksPath(itemId);
+}
+
+void SectorGraph::invalidate(const Position &pos) {
+	std::scoped_lock lock(dirtyMutex);
+	dirtyClusters.emplace(clusterKey(pos.x, pos.y, pos.z));
+}
+
+Position SectorGraph::tilePosition(uint64_t key, uint16_t tile) {
+	return Position(
+		static_cast<uint16_t>((key & 0xFFFF) * SECTOR_SIZE + tile % SECTOR_SIZE),
+		static_cast<uint16_t>((key >> 16 & 0xFFFF) * SECTOR_SIZE + tile / SECTOR_SIZE),
+		static_cast<uint8_t>(key >> 32)
+	);
+}
+
+bool SectorGraph::isWalkable(const Floor &floor, uint16_t x, uint16_t y) {
+	if (const auto tile = floor.getTile(x, y)) {
+		return tile->getGround() && !tile->hasFlag(TILESTATE_BLOCKSOLID | TILESTATE_BLOCKPATH | TILESTATE_FLOORCHANGE | TILESTATE_TELEPORT);
+	}
+
+	// Not loaded yet, read it from the map cache instead of creating the tile
+	const auto cachedTile = floor.getTileCache(x, y);
+	if (!cachedTile || !cachedTile->ground) {
+		return false;
+	}
+
+	const auto blocks = [](const std::shared_ptr<BasicItem> &item) {
+		return blocksPath(item->id);
+	};
+	return !blocks(cachedTile->ground) && std::ranges::none_of(cachedTile->items, blocks);
+}
+
+SectorGraph::Cluster &SectorGraph::getWalkable(Map &map, uint64_t key) {
+	auto &cluster = clusters[key];
+	if (cluster.walkableBuilt) {
+		return cluster;
+	}
+
+	cluster.walkable.reset();
+	const Position base = tilePosition(key, 0);
+	if (const auto sector = map.getMapSector(base.x, base.y)) {
+		if (const auto &floor = sector->getFloor(base.z)) {
+			for (uint16_t tile = 0; tile < CLUSTER_TILES; ++tile) {
+				const Position pos = tilePosition(key, tile);
+				cluster.walkable.set(tile, isWalkable(*floor, pos.x, pos.y));
+			}
+		}
+	}
+
+	cluster.walkableBuilt = true;
+	return cluster;
+}
+
+SectorGraph::Cluster &SectorGraph::getCluster(Map &map, uint64_t key) {
+	auto &cluster = getWalkable(map, key);
+	if (!cluster.portalsBuilt) {
+		buildPortals(map, key, cluster);
+	}
+	return cluster;
+}
+
+void SectorGraph::buildPortals(Map &map, uint64_t key, Cluster &cluster) {
+	cluster.portals.clear();
+	cluster.crossings.clear();
+
+	const auto sectorX = static_cast<int32_t>(key & 0xFFFF);
+	const auto sectorY = static_cast<int32_t>(key >> 16 & 0xFFFF);
+	constexpr int32_t lastSector = std::numeric_limits<uint16_t>::max() / SECTOR_SIZE;
+
+	for (const auto &[dx, dy] : STRAIGHT_STEPS) {
+		const int32_t neighbourX = sectorX + dx;
+		const int32_t neighbourY = sectorY + dy;
+		if (neighbourX < 0 || neighbourY < 0 || neighbourX > lastSector || neighbourY > lastSector) {
+			continue;
+		}
+
+		const uint64_t neighbourKey = static_cast<uint64_t>(neighbourX) | static_cast<uint64_t>(neighbourY) << 16 | (key & 0xFF00000000);
+		// Node based container, the reference to this cluster stays valid
+		const auto &neighbour = getWalkable(map, neighbourKey);
+
+		// Tile at step i along the shared border, on this side or on the neighbour side
+		const auto border = [dx, dy](int32_t i, bool own) {
+			const int32_t edge = (dx + dy > 0) == own ? SECTOR_SIZE - 1 : 0;
+			return static_cast<uint16_t>(dx != 0 ? edge + i * SECTOR_SIZE : i + edge * SECTOR_SIZE);
+		};
+
+		// The neighbour runs the same scan from its side, so both agree on every portal
+		int32_t runStart = -1;
+		for (int32_t i = 0; i <= SECTOR_SIZE; ++i) {
+			if (i < SECTOR_SIZE && cluster.walkable[border(i, true)] && neighbour.walkable[border(i, false)]) {
+				if (runStart < 0) {
+					runStart = i;
+				}
+				continue;
+			}
+
+			if (runStart < 0) {
+				continue;
+			}
+
+			const int32_t middle = (runStart + i - 1) / 2;
+			runStart = -1;
+
+			const uint16_t tile = border(middle, true);
+			const auto it = std::ranges::find(cluster.portals, tile);
+			const auto portal = static_cast<uint16_t>(std::distance(cluster.portals.begin(), it));
+			if (it == cluster.portals.end()) {
+				cluster.portals.emplace_back(tile);
+			}
+			cluster.crossings.push_back({ portal, neighbourKey, border(middle, false) });
+		}
+	}
+
+	const size_t count = cluster.portals.size();
+	cluster.distances.assign(count * count, UNREACHABLE);
+
+	Distances distances;
+	for (size_t from = 0; from < count; ++from) {
+		search(cluster, cluster.portals[from], distances);
+		for (size_t to = 0; to < count; ++to) {
+			cluster.distances[from * count + to] = distances[cluster.portals[to]];
+		}
+	}
+
+	cluster.portalsBuilt = true;
+}
+
+void SectorGraph::applyInvalidations() {
+	std::unordered_set<uint64_t> dirty;
+	{
+		std::scoped_lock lock(dirtyMutex);
+		dirty.swap(dirtyClusters);
+	}
+
+	for (const uint64_t key : dirty) {
+		if (const auto it = clusters.find(key); it != clusters.end()) {
+			it->second.walkableBuilt = false;
+			it->second.portalsBuilt = false;
+		}
+
+		// The entrances on the shared borders may have moved too
+		const auto sectorX = static_cast<int64_t>(key & 0xFFFF);
+		const auto sectorY = static_cast<int64_t>(key >> 16 & 0xFFFF);
+		for (const auto &[dx, dy] : STRAIGHT_STEPS) {
+			if (sectorX + dx < 0 || sectorY + dy < 0) {
+				continue;
+			}
+
+			const uint64_t neighbourKey = static_cast<uint64_t>(sectorX + dx) | static_cast<uint64_t>(sectorY + dy) << 16 | (key & 0xFF00000000);
+			if (const auto it = clusters.find(neighbourKey); it != clusters.end()) {
+				it->second.portalsBuilt = false;
+			}
+		}
+	}
+}
+
+void SectorGraph::search(const Cluster &cluster, uint16_t source, Distances &distances, Parents* parents) {
+	distances.fill(UNREACHABLE);
+
+	std::array<uint16_t, CLUSTER_TILES> queue;
+	size_t head = 0;
+	size_t tail = 0;
+
+	// The source does not need to be walkable, a creature can stand on a tile it could not path into
+	distances[source] = 0;
+	queue[tail++] = source;
+	while (head < tail) {
+		const uint16_t tile = queue[head++];
+		const int32_t x = tile % SECTOR_SIZE;
+		const int32_t y = tile / SECTOR_SIZE;
+		for (const auto &[dx, dy] : STRAIGHT_STEPS) {
+			const int32_t nextX = x + dx;
+			const int32_t nextY = y + dy;
+			if (nextX < 0 || nextY < 0 || nextX >= SECTOR_SIZE || nextY >= SECTOR_SIZE) {
+				continue;
+			}
+
+			const auto next = static_cast<uint16_t>(nextX + nextY * SECTOR_SIZE);
+			if (!cluster.walkable[next] || distances[next] != UNREACHABLE) {
+				continue;
+			}
+
+			distances[next] = distances[tile] + 1;
+			if (parents) {
+				(*parents)[next] = tile;
+			}
+			queue[tail++] = next;
+		}
+	}
+}
+
+bool SectorGraph::appendSteps(const Cluster &cluster, uint64_t key, uint16_t from, uint16_t to, std::vector<Direction> &steps) {
+	Distances distances;
+	Parents parents;
+	search(cluster, from, distances, &parents);
+	if (distances[to] == UNREACHABLE) {
+		return false;
+	}
+
+	const size_t first = steps.size();
+	for (uint16_t tile = to; tile != from; tile = parents[tile]) {
+		const Position pos = tilePosition(key, tile);
+		const Position parentPos = tilePosition(key, parents[tile]);
+		steps.emplace_back(getStepDirection(pos.x - parentPos.x, pos.y - parentPos.y));
+	}
+	std::reverse(steps.begin() + static_cast<std::ptrdiff_t>(first), steps.end());
+	return true;
+}
+
+bool SectorGraph::findPath(Map &map, const Position &startPos, const Position &targetPos, const FindPathParams &fpp, std::vector<Direction> &dirList) {
+	metrics::method_latency measure(__METHOD_NAME__);
+	if (startPos.z != targetPos.z || startPos == targetPos) {
+		return false;
+	}
+
+	const int32_t distance = std::max(Position::getDistanceX(startPos, targetPos), Position::getDistanceY(startPos, targetPos));
+	if (distance > MAX_DISTANCE || (fpp.maxSearchDist != 0 && distance > fpp.maxSearchDist)) {
+		return false;
+	}
+
+	std::scoped_lock lock(mutex);
+	applyInvalidations();
+
+	const auto isWalkablePosition = [&](const Position &pos) {
+		return getWalkable(map, clusterKey(pos.x, pos.y, pos.z)).walkable[localTile(pos.x, pos.y)];
+	};
+
+	// The target itself, or the walkable tile next to it nearest to the start when it is a counter, a wall...
+	Position goalPos;
+	bool hasGoal = false;
+	if (fpp.minTargetDist <= 0 && isWalkablePosition(targetPos)) {
+		goalPos = targetPos;
+		hasGoal = true;
+	} else if (fpp.maxTargetDist != 0 && fpp.minTargetDist <= 1) {
+		int32_t bestDistance = std::numeric_limits<int32_t>::max();
+		for (int32_t dy = -1; dy <= 1; ++dy) {
+			for (int32_t dx = -1; dx <= 1; ++dx) {
+				if ((dx == 0 && dy == 0) || (dx < 0 && targetPos.x == 0) || (dy < 0 && targetPos.y == 0)) {
+					continue;
+				}
+
+				const Position pos(static_cast<uint16_t>(targetPos.x + dx), static_cast<uint16_t>(targetPos.y + dy), targetPos.z);
+				const int32_t posDistance = Position::getDistanceX(startPos, pos) + Position::getDistanceY(startPos, pos);
+				if (posDistance < bestDistance && isWalkablePosition(pos)) {
+					bestDistance = posDistance;
+					goalPos = pos;
+					hasGoal = true;
+				}
+			}
+		}
+	}
+
+	if (!hasGoal || goalPos == startPos) {
+		return false;
+	}
+
+	const uint64_t startKey = clusterKey(startPos.x, startPos.y, startPos.z);
+	const uint64_t goalKey = clusterKey(goalPos.x, goalPos.y, goalPos.z);
+	const uint16_t startTile = localTile(startPos.x, startPos.y);
+	const uint16_t goalTile = localTile(goalPos.x, goalPos.y);
+	const auto &startCluster = getCluster(map, startKey);
+	const auto &goalCluster = getCluster(map, goalKey);
+
+	std::vector<Direction> steps;
+	if (startKey != goalKey || !appendSteps(startCluster, startKey, startTile, goalTile, steps)) {
+		Distances startDistances;
+		Distances goalDistances;
+		search(startCluster, startTile, startDistances);
+		search(goalCluster, goalTile, goalDistances);
+
+		struct Visit {
+			uint32_t cost;
+			uint64_t parent;
+			bool closed;
+		};
+		using Entry = std::tuple<uint32_t, uint32_t, uint64_t>;
+
+		// A portal node is its cluster key followed by the portal index
+		std::unordered_map<uint64_t, Visit> visits;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<>> open;
+
+		const auto relax = [&](uint64_t node, const Position &pos, uint32_t cost, uint64_t parent) {
+			const auto [it, inserted] = visits.try_emplace(node, Visit { cost, parent, false });
+			if (!inserted) {
+				if (it->second.closed || it->second.cost <= cost) {
+					return;
+				}
+				it->second.cost = cost;
+				it->second.parent = parent;
+			}
+
+			const auto heuristic = static_cast<uint32_t>(Position::getDistanceX(pos, goalPos) + Position::getDistanceY(pos, goalPos));
+			open.emplace(cost + heuristic, cost, node);
+		};
+
+		visits.try_emplace(START_NODE, Visit { 0, START_NODE, true });
+		for (uint16_t portal = 0; portal < startCluster.portals.size(); ++portal) {
+			const uint16_t portalDistance = startDistances[startCluster.portals[portal]];
+			if (portalDistance != UNREACHABLE) {
+				relax(startKey << 16 | portal, tilePosition(startKey, startCluster.portals[portal]), portalDistance, START_NODE);
+			}
+		}
+
+		bool found = false;
+		size_t expanded = 0;
+		while (!open.empty() && expanded < MAX_EXPANDED_NODES) {
+			const auto [estimate, cost, node] = open.top();
+			open.pop();
+
+			auto &visit = visits[node];
+			if (visit.closed || visit.cost != cost) {
+				continue;
+			}
+			visit.closed = true;
+
+			if (node == GOAL_NODE) {
+				found = true;
+				break;
+			}
+			++expanded;
+
+			const uint64_t key = node >> 16;
+			const auto portal = static_cast<uint16_t>(node & 0xFFFF);
+			const auto &cluster = getCluster(map, key);
+			const size_t count = cluster.portals.size();
+			for (uint16_t other = 0; other < count; ++other) {
+				const uint16_t portalDistance = cluster.distances[portal * count + other];
+				if (other != portal && portalDistance != UNREACHABLE) {
+					relax(key << 16 | other, tilePosition(key, cluster.portals[other]), cost + portalDistance, node);
+				}
+			}
+
+			if (key == goalKey && goalDistances[cluster.portals[portal]] != UNREACHABLE) {
+				relax(GOAL_NODE, goalPos, cost + goalDistances[cluster.portals[portal]], node);
+			}
+
+			for (const auto &crossing : cluster.crossings) {
+				if (crossing.portal != portal) {
+					continue;
+				}
+
+				const auto &neighbour = getCluster(map, crossing.cluster);
+				const auto it = std::ranges::find(neighbour.portals, crossing.tile);
+				if (it != neighbour.portals.end()) {
+					const auto neighbourPortal = static_cast<uint64_t>(std::distance(neighbour.portals.begin(), it));
+					relax(crossing.cluster << 16 | neighbourPortal, tilePosition(crossing.cluster, crossing.tile), cost + 1, node);
+				}
+			}
+		}
+
+		if (!found) {
+			g_metrics().addCounter("pathfinding_hierarchical_failed", 1);
+			return false;
+		}
+
+		std::vector<uint64_t> route;
+		for (uint64_t node = visits[GOAL_NODE].parent; node != START_NODE; node = visits[node].parent) {
+			route.emplace_back(node);
+		}
+
+		// Refine the portal route, a straight step across each entrance and a local search inside each cluster
+		uint64_t currentKey = startKey;
+		uint16_t currentTile = startTile;
+		for (auto it = route.rbegin(); it != route.rend(); ++it) {
+			const uint64_t key = *it >> 16;
+			const uint16_t tile = getCluster(map, key).portals[*it & 0xFFFF];
+			if (key == currentKey) {
+				if (!appendSteps(getCluster(map, key), key, currentTile, tile, steps)) {
+					return false;
+				}
+			} else {
+				const Position from = tilePosition(currentKey, currentTile);
+				const Position to = tilePosition(key, tile);
+				steps.emplace_back(getStepDirection(to.x - from.x, to.y - from.y));
+			}
+
+			currentKey = key;
+			currentTile = tile;
+		}
+
+		if (currentKey != goalKey || !appendSteps(goalCluster, goalKey, currentTile, goalTile, steps)) {
+			return false;
+		}
+	}
+
+	g_metrics().addCounter("pathfinding_hierarchical_routes", 1);
+	dirList.insert(dirList.end(), steps.rbegin(), steps.rend());
+	return true;
+}
@@ -0,0 +1,113 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "map/map_const.hpp"
+#include "game/movement/position.hpp"
+
+class Map;
+struct Floor;
+struct FindPathParams;
+
+/**
+ * Hierarchical pathfinding (HPA*) over the map sectors.
+ *
+ * Every sector of a floor is a cluster. The border tiles walkable on both
+ * sides are grouped in entrances, each entrance gets one portal in its middle
+ * and the walking distance between the portals of a cluster is precomputed.
+ * A long route is searched over this portal graph and then refined cluster by
+ * cluster, so its cost follows the sectors crossed instead of the tiles.
+ *
+ * Only the static walkability is modelled (ground, blocking items, floor
+ * changes and teleports), creatures and fields are left to the walk itself.
+ * A cluster is built on first use and again after an item changing the
+ * walkability of one of its tiles is added, removed or transformed.
+ */
+class SectorGraph {
+public:
+	// Farthest target, in tiles on each axis, a route is searched for
+	static constexpr int32_t MAX_DISTANCE = 512;
+
+	/**
+	 * @brief Finds a route on the same floor, in the same reversed order as Map::getPathMatching.
+	 * The route ends on the target, or next to it when the target is not walkable and fpp allows it.
+	 */
+	bool findPath(Map &map, const Position &startPos, const Position &targetPos, const FindPathParams &fpp, std::vector<Direction> &dirList);
+
+	/**
+	 * @brief Marks the cluster of the position to be built again on its next use.
+	 * Safe from any thread, including while a floor lock is held.
+	 */
+	void invalidate(const Position &pos);
+
+	static bool affectsWalkability(uint16_t itemId);
+
+	// Clusters built so far, the graph grows as routes reach new sectors
+	size_t getClusterCount() {
+		std::scoped_lock lock(mutex);
+		return clusters.size();
+	}
+
+private:
+	static constexpr size_t CLUSTER_TILES = SECTOR_SIZE * SECTOR_SIZE;
+	static constexpr uint16_t UNREACHABLE = std::numeric_limits<uint16_t>::max();
+	static constexpr size_t MAX_EXPANDED_NODES = 8192;
+
+	struct Crossing {
+		uint16_t portal;
+		uint64_t cluster;
+		// Tile of the neighbour cluster the portal leads to
+		uint16_t tile;
+	};
+
+	struct Cluster {
+		std::bitset<CLUSTER_TILES> walkable;
+		// Local tile index of each portal
+		std::vector<uint16_t> portals;
+		std::vector<Crossing> crossings;
+		// Walking distance between every two portals, row major
+		std::vector<uint16_t> distances;
+		bool walkableBuilt = false;
+		bool portalsBuilt = false;
+	};
+
+	using Distances = std::array<uint16_t, CLUSTER_TILES>;
+	using Parents = std::array<uint16_t, CLUSTER_TILES>;
+
+	static uint64_t clusterKey(uint16_t x, uint16_t y, uint8_t z) {
+		return static_cast<uint64_t>(x / SECTOR_SIZE) | static_cast<uint64_t>(y / SECTOR_SIZE) << 16 | static_cast<uint64_t>(z) << 32;
+	}
+
+	static uint16_t localTile(uint16_t x, uint16_t y) {
+		return static_cast<uint16_t>((x & SECTOR_MASK) + (y & SECTOR_MASK) * SECTOR_SIZE);
+	}
+
+	static Position tilePosition(uint64_t key, uint16_t tile);
+	static bool isWalkable(const Floor &floor, uint16_t x, uint16_t y);
+
+	Cluster &getWalkable(Map &map, uint64_t key);
+	Cluster &getCluster(Map &map, uint64_t key);
+	void buildPortals(Map &map, uint64_t key, Cluster &cluster);
+	void applyInvalidations();
+
+	/**
+	 * @brief Breadth first search inside one cluster, walking only on straight steps.
+	 * Diagonal steps cost more than two straight ones, so they never shorten a route.
+	 */
+	static void search(const Cluster &cluster, uint16_t source, Distances &distances, Parents* parents = nullptr);
+	static bool appendSteps(const Cluster &cluster, uint64_t key, uint16_t from, uint16_t to, std::vector<Direction> &steps);
+
+	std::unordered_map<uint64_t, Cluster> clusters;
+	std::mutex mutex;
+
+	// Kept apart from the graph lock, tiles invalidate while holding their floor lock
+	std::unordered_set<uint64_t> dirtyClusters;
+	std::mutex dirtyMutex;
+};
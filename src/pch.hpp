@@ -25,6 +25,7 @@
 // STL Includes
 // --------------------
 
+#include <bit>
 #include <bitset>
 #include <charconv>
 #include <filesystem>
@@ -46,6 +47,7 @@
 #include <cmath>
 #include <mutex>
 #include <stack>
+#include <span>
 
 // --------------------
 // System Includes
@@ -68,6 +70,7 @@
 // --------------------
 
 // ABSL
+#include <absl/container/inlined_vector.h>
 #include <absl/numeric/int128.h>
 
 // ASIO
@@ -165,6 +168,8 @@ struct fmt::formatter<E, std::enable_if_t<std::is_enum_v<E>, char>> : formatter<
 #include "lib/messaging/command.hpp"
 #include "lib/messaging/event.hpp"
 #include "lib/logging/log_with_spd_log.hpp"
+#include "lib/memory/memory_accounting.hpp"
+#include "lib/metrics/profiled_mutex.hpp"
 
 #include <eventpp/utilities/scopedremover.h>
 #include <eventpp/eventdispatcher.h>
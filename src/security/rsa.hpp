@@ -26,6 +26,8 @@ public:
 
 	void setKey(const char* pString, const char* qString, int base = 10);
 	void decrypt(char* msg) const;
+	// Encrypts a 128 bytes block with the public key, as a client does; used by the replay tool
+	void encrypt(char* msg) const;
 
 	std::string base64Decrypt(const std::string &input) const;
 	uint16_t decodeLength(char*&pos) const;
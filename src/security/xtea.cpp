@@ -0,0 +1,188 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "security/xtea.hpp"
+
+namespace xtea {
+	namespace {
+		constexpr uint32_t delta = 0x61C88647;
+
+#if defined(__AVX2__)
+		size_t encryptVector(uint8_t* data, size_t length, const round_keys &keys) {
+			size_t pos = 0;
+			for (; pos + 64 <= length; pos += 64) {
+				// Within each 128-bit lane the first and second words of the blocks are split apart
+				const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+				const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + 32));
+				__m256i v0 = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi), _MM_SHUFFLE(2, 0, 2, 0)));
+				__m256i v1 = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi), _MM_SHUFFLE(3, 1, 3, 1)));
+				for (size_t i = 0; i < 32; ++i) {
+					const __m256i k0 = _mm256_set1_epi32(static_cast<int>(keys[i * 2]));
+					const __m256i k1 = _mm256_set1_epi32(static_cast<int>(keys[i * 2 + 1]));
+					v0 = _mm256_add_epi32(v0, _mm256_xor_si256(_mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v1, 4), _mm256_srli_epi32(v1, 5)), v1), k0));
+					v1 = _mm256_add_epi32(v1, _mm256_xor_si256(_mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v0, 4), _mm256_srli_epi32(v0, 5)), v0), k1));
+				}
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + pos), _mm256_unpacklo_epi32(v0, v1));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + pos + 32), _mm256_unpackhi_epi32(v0, v1));
+			}
+			return pos;
+		}
+
+		size_t decryptVector(uint8_t* data, size_t length, const round_keys &keys) {
+			size_t pos = 0;
+			for (; pos + 64 <= length; pos += 64) {
+				const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+				const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + 32));
+				__m256i v0 = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi), _MM_SHUFFLE(2, 0, 2, 0)));
+				__m256i v1 = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi), _MM_SHUFFLE(3, 1, 3, 1)));
+				for (size_t i = 0; i < 32; ++i) {
+					const __m256i k0 = _mm256_set1_epi32(static_cast<int>(keys[i * 2]));
+					const __m256i k1 = _mm256_set1_epi32(static_cast<int>(keys[i * 2 + 1]));
+					v1 = _mm256_sub_epi32(v1, _mm256_xor_si256(_mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v0, 4), _mm256_srli_epi32(v0, 5)), v0), k0));
+					v0 = _mm256_sub_epi32(v0, _mm256_xor_si256(_mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v1, 4), _mm256_srli_epi32(v1, 5)), v1), k1));
+				}
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + pos), _mm256_unpacklo_epi32(v0, v1));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + pos + 32), _mm256_unpackhi_epi32(v0, v1));
+			}
+			return pos;
+		}
+#elif defined(__SSE2__)
+		size_t encryptVector(uint8_t* data, size_t length, const round_keys &keys) {
+			size_t pos = 0;
+			for (; pos + 32 <= length; pos += 32) {
+				const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+				const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 16));
+				__m128i v0 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2, 0, 2, 0)));
+				__m128i v1 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(3, 1, 3, 1)));
+				for (size_t i = 0; i < 32; ++i) {
+					const __m128i k0 = _mm_set1_epi32(static_cast<int>(keys[i * 2]));
+					const __m128i k1 = _mm_set1_epi32(static_cast<int>(keys[i * 2 + 1]));
+					v0 = _mm_add_epi32(v0, _mm_xor_si128(_mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v1, 4), _mm_srli_epi32(v1, 5)), v1), k0));
+					v1 = _mm_add_epi32(v1, _mm_xor_si128(_mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v0, 4), _mm_srli_epi32(v0, 5)), v0), k1));
+				}
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(data + pos), _mm_unpacklo_epi32(v0, v1));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(data + pos + 16), _mm_unpackhi_epi32(v0, v1));
+			}
+			return pos;
+		}
+
+		size_t decryptVector(uint8_t* data, size_t length, const round_keys &keys) {
+			size_t pos = 0;
+			for (; pos + 32 <= length; pos += 32) {
+				const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+				const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 16));
+				__m128i v0 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2, 0, 2, 0)));
+				__m128i v1 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(3, 1, 3, 1)));
+				for (size_t i = 0; i < 32; ++i) {
+					const __m128i k0 = _mm_set1_epi32(static_cast<int>(keys[i * 2]));
+					const __m128i k1 = _mm_set1_epi32(static_cast<int>(keys[i * 2 + 1]));
+					v1 = _mm_sub_epi32(v1, _mm_xor_si128(_mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v0, 4), _mm_srli_epi32(v0, 5)), v0), k0));
+					v0 = _mm_sub_epi32(v0, _mm_xor_si128(_mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v1, 4), _mm_srli_epi32(v1, 5)), v1), k1));
+				}
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(data + pos), _mm_unpacklo_epi32(v0, v1));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(data + pos + 16), _mm_unpackhi_epi32(v0, v1));
+			}
+			return pos;
+		}
+#elif defined(__NEON__)
+		size_t encryptVector(uint8_t* data, size_t length, const round_keys &keys) {
+			size_t pos = 0;
+			for (; pos + 32 <= length; pos += 32) {
+				// The structured load already splits the first and second words of 4 blocks
+				uint32x4x2_t v = vld2q_u32(reinterpret_cast<const uint32_t*>(data + pos));
+				for (size_t i = 0; i < 32; ++i) {
+					v.val[0] = vaddq_u32(v.val[0], veorq_u32(vaddq_u32(veorq_u32(vshlq_n_u32(v.val[1], 4), vshrq_n_u32(v.val[1], 5)), v.val[1]), vdupq_n_u32(keys[i * 2])));
+					v.val[1] = vaddq_u32(v.val[1], veorq_u32(vaddq_u32(veorq_u32(vshlq_n_u32(v.val[0], 4), vshrq_n_u32(v.val[0], 5)), v.val[0]), vdupq_n_u32(keys[i * 2 + 1])));
+				}
+				vst2q_u32(reinterpret_cast<uint32_t*>(data + pos), v);
+			}
+			return pos;
+		}
+
+		size_t decryptVector(uint8_t* data, size_t length, const round_keys &keys) {
+			size_t pos = 0;
+			for (; pos + 32 <= length; pos += 32) {
+				uint32x4x2_t v = vld2q_u32(reinterpret_cast<const uint32_t*>(data + pos));
+				for (size_t i = 0; i < 32; ++i) {
+					v.val[1] = vsubq_u32(v.val[1], veorq_u32(vaddq_u32(veorq_u32(vshlq_n_u32(v.val[0], 4), vshrq_n_u32(v.val[0], 5)), v.val[0]), vdupq_n_u32(keys[i * 2])));
+					v.val[0] = vsubq_u32(v.val[0], veorq_u32(vaddq_u32(veorq_u32(vshlq_n_u32(v.val[1], 4), vshrq_n_u32(v.val[1], 5)), v.val[1]), vdupq_n_u32(keys[i * 2 + 1])));
+				}
+				vst2q_u32(reinterpret_cast<uint32_t*>(data + pos), v);
+			}
+			return pos;
+		}
+#else
+		size_t encryptVector(uint8_t*, size_t, const round_keys &) {
+			return 0;
+		}
+
+		size_t decryptVector(uint8_t*, size_t, const round_keys &) {
+			return 0;
+		}
+#endif
+	}
+
+	round_keys expandEncryptKeys(const key_type &key) {
+		round_keys keys;
+		uint32_t sum = 0;
+		for (size_t i = 0; i < 32; ++i) {
+			keys[i * 2] = sum + key[sum & 3];
+			sum -= delta;
+			keys[i * 2 + 1] = sum + key[(sum >> 11) & 3];
+		}
+		return keys;
+	}
+
+	round_keys expandDecryptKeys(const key_type &key) {
+		round_keys keys;
+		uint32_t sum = 0xC6EF3720;
+		for (size_t i = 0; i < 32; ++i) {
+			keys[i * 2] = sum + key[(sum >> 11) & 3];
+			sum += delta;
+			keys[i * 2 + 1] = sum + key[sum & 3];
+		}
+		return keys;
+	}
+
+	void encryptScalar(uint8_t* data, size_t length, const round_keys &keys) {
+		for (size_t pos = 0; pos + 8 <= length; pos += 8) {
+			std::array<uint32_t, 2> vData = {};
+			memcpy(vData.data(), data + pos, 8);
+			for (size_t i = 0; i < 32; ++i) {
+				vData[0] += ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ keys[i * 2];
+				vData[1] += ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ keys[i * 2 + 1];
+			}
+			memcpy(data + pos, vData.data(), 8);
+		}
+	}
+
+	void decryptScalar(uint8_t* data, size_t length, const round_keys &keys) {
+		for (size_t pos = 0; pos + 8 <= length; pos += 8) {
+			std::array<uint32_t, 2> vData = {};
+			memcpy(vData.data(), data + pos, 8);
+			for (size_t i = 0; i < 32; ++i) {
+				vData[1] -= ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ keys[i * 2];
+				vData[0] -= ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ keys[i * 2 + 1];
+			}
+			memcpy(data + pos, vData.data(), 8);
+		}
+	}
+
+	void encrypt(uint8_t* data, size_t length, const round_keys &keys) {
+		const size_t done = encryptVector(data, length, keys);
+		encryptScalar(data + done, length - done, keys);
+	}
+
+	void decrypt(uint8_t* data, size_t length, const round_keys &keys) {
+		const size_t done = decryptVector(data, length, keys);
+		decryptScalar(data + done, length - done, keys);
+	}
+}
@@ -0,0 +1,39 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * XTEA as used by the game protocol, 32 cycles over little-endian blocks.
+ *
+ * The per-round key additions are expanded once per key. Blocks are
+ * independent, so the vector kernels run 4 (SSE2/NEON) or 8 (AVX2)
+ * blocks at once; which one is used is decided at build time through
+ * utils/simd.hpp, the remainder always goes through the scalar path.
+ */
+namespace xtea {
+	using key_type = std::array<uint32_t, 4>;
+	using round_keys = std::array<uint32_t, 64>;
+
+	round_keys expandEncryptKeys(const key_type &key);
+	round_keys expandDecryptKeys(const key_type &key);
+
+	/**
+	 * @brief Encrypts the buffer in place, the length must be a multiple of 8.
+	 */
+	void encrypt(uint8_t* data, size_t length, const round_keys &keys);
+	/**
+	 * @brief Decrypts the buffer in place, the length must be a multiple of 8.
+	 */
+	void decrypt(uint8_t* data, size_t length, const round_keys &keys);
+
+	// Reference implementation, kept for tests
+	void encryptScalar(uint8_t* data, size_t length, const round_keys &keys);
+	void decryptScalar(uint8_t* data, size_t length, const round_keys &keys);
+}
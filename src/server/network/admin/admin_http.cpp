@@ -0,0 +1,292 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server/network/admin/admin_http.hpp"
+#include "server/server.hpp"
+#include "config/configmanager.hpp"
+#include "game/game.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/profiling/sampling_profiler.hpp"
+#include "lua/scripts/lua_profiler.hpp"
+#include "map/spectators.hpp"
+#include "utils/tools.hpp"
+
+namespace {
+	// A request is only its line and a few headers
+	constexpr size_t MAX_REQUEST_SIZE = 8 * 1024;
+	constexpr auto REQUEST_TIMEOUT = std::chrono::seconds(5);
+
+	constexpr std::string_view INDEX = "/dispatcher?cycles=20 - last dispatcher cycles: duration, phases, tasks per group and slowest tasks\n"
+		"/memory - memory accounting per category\n"
+		"/traffic?player=&limit=20 - bytes sent per connection, or the packets of one player\n"
+		"/spectators - spectator cache size and hit rate\n"
+		"/pathfinding - sector graph and follow path cache sizes\n"
+		"/profiler/lua?limit=20 - Lua profiler report\n"
+		"/profiler/samples - sampling profiler stacks, in the collapsed stack format";
+
+	std::string_view getReason(uint16_t status) {
+		switch (status) {
+			case 200:
+				return "OK";
+			case 400:
+				return "Bad Request";
+			case 401:
+				return "Unauthorized";
+			case 404:
+				return "Not Found";
+			case 405:
+				return "Method Not Allowed";
+			default:
+				return "Internal Server Error";
+		}
+	}
+
+	size_t getNumberParam(const AdminHttpServer::Params &params, const std::string &name, size_t defaultValue) {
+		const auto it = params.find(name);
+		if (it == params.end()) {
+			return defaultValue;
+		}
+
+		size_t value = defaultValue;
+		std::from_chars(it->second.data(), it->second.data() + it->second.size(), value);
+		return value;
+	}
+
+	std::string getParam(const AdminHttpServer::Params &params, const std::string &name) {
+		const auto it = params.find(name);
+		return it == params.end() ? std::string() : it->second;
+	}
+
+	std::string getSamplingProfilerDump() {
+		if (g_samplingProfiler().getSampleCount() == 0) {
+			return "No samples, start the sampling profiler first";
+		}
+
+		const auto path = std::filesystem::temp_directory_path() / fmt::format("canary-samples-{}.folded", OTSYS_TIME());
+		if (!g_samplingProfiler().dump(path.string())) {
+			return "The samples could not be written";
+		}
+
+		std::ifstream file(path, std::ios::binary);
+		std::string samples((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		file.close();
+		std::error_code ignored;
+		std::filesystem::remove(path, ignored);
+		return samples;
+	}
+}
+
+class AdminHttpServer::Session : public std::enable_shared_from_this<Session> {
+public:
+	explicit Session(asio::io_service &context) :
+		socket(context), timer(context), request(MAX_REQUEST_SIZE) { }
+
+	void start() {
+		timer.expires_from_now(REQUEST_TIMEOUT);
+		timer.async_wait([self = shared_from_this()](const std::error_code &error) {
+			if (!error) {
+				self->close();
+			}
+		});
+		asio::async_read_until(socket, request, "\r\n\r\n", [self = shared_from_this()](const std::error_code &error, size_t) {
+			self->onRead(error);
+		});
+	}
+
+	asio::ip::tcp::socket socket;
+
+private:
+	void onRead(const std::error_code &error) {
+		if (error) {
+			close();
+			return;
+		}
+
+		const std::string head(asio::buffers_begin(request.data()), asio::buffers_end(request.data()));
+		const std::string_view line(head.data(), head.find("\r\n"));
+		const auto methodEnd = line.find(' ');
+		const auto targetEnd = methodEnd == std::string_view::npos ? std::string_view::npos : line.find(' ', methodEnd + 1);
+		if (targetEnd == std::string_view::npos) {
+			respond({ 400, "Malformed request line" });
+			return;
+		}
+
+		if (line.substr(0, methodEnd) != "GET") {
+			respond({ 405, "Only GET is served" });
+			return;
+		}
+
+		if (!isAuthorized(head)) {
+			respond({ 401, "Missing or wrong token" });
+			return;
+		}
+
+		g_dispatcher().addEvent(
+			[self = shared_from_this(), target = std::string(line.substr(methodEnd + 1, targetEnd - methodEnd - 1))] {
+				auto response = AdminHttpServer::route(target);
+				asio::post(self->socket.get_executor(), [self, response = std::move(response)]() mutable {
+					self->respond(std::move(response));
+				});
+			},
+			"AdminHttpServer::route"
+		);
+	}
+
+	static bool isAuthorized(std::string_view head) {
+		const auto &token = g_configManager().getString(ADMIN_HTTP_TOKEN, __FUNCTION__);
+		if (token.empty()) {
+			return true;
+		}
+
+		constexpr std::string_view header = "authorization: bearer ";
+		for (size_t lineStart = head.find("\r\n"); lineStart != std::string_view::npos;) {
+			lineStart += 2;
+			const auto lineEnd = head.find("\r\n", lineStart);
+			const auto line = head.substr(lineStart, lineEnd - lineStart);
+			if (line.size() > header.size() && asLowerCaseString(std::string(line.substr(0, header.size()))) == header) {
+				return line.substr(header.size()) == token;
+			}
+			lineStart = lineEnd;
+		}
+		return false;
+	}
+
+	void respond(Response response) {
+		timer.cancel();
+		reply = fmt::format(
+			"HTTP/1.1 {} {}\r\nContent-Type: text/plain; charset=utf-8\r\nContent-Length: {}\r\nCache-Control: no-store\r\nConnection: close\r\n\r\n{}",
+			response.status, getReason(response.status), response.body.size(), response.body
+		);
+		asio::async_write(socket, asio::buffer(reply), [self = shared_from_this()](const std::error_code &, size_t) {
+			self->close();
+		});
+	}
+
+	void close() {
+		std::error_code ignored;
+		socket.shutdown(asio::ip::tcp::socket::shutdown_both, ignored);
+		socket.close(ignored);
+		timer.cancel();
+	}
+
+	asio::high_resolution_timer timer;
+	asio::streambuf request;
+	std::string reply;
+};
+
+bool AdminHttpServer::open(const std::string &address, uint16_t port) {
+	close();
+
+	try {
+		acceptor = std::make_unique<asio::ip::tcp::acceptor>(io_service, asio::ip::tcp::endpoint(asio::ip::make_address(address), port));
+	} catch (const std::system_error &e) {
+		g_logger().warn("[AdminHttpServer::open] - Could not listen on {}:{}: {}", address, port, e.what());
+		acceptor.reset();
+		return false;
+	}
+
+	g_logger().info("Admin HTTP endpoint listening on {}:{}", address, port);
+	accept();
+	return true;
+}
+
+void AdminHttpServer::close() {
+	if (acceptor && acceptor->is_open()) {
+		std::error_code error;
+		acceptor->close(error);
+	}
+}
+
+void AdminHttpServer::accept() {
+	if (!acceptor) {
+		return;
+	}
+
+	auto session = std::make_shared<Session>(manager.getConnectionContext());
+	acceptor->async_accept(session->socket, [self = shared_from_this(), session](const std::error_code &error) {
+		if (error) {
+			if (error != asio::error::operation_aborted) {
+				g_logger().warn("[AdminHttpServer::accept] - Stopped accepting: {}", error.message());
+			}
+			return;
+		}
+
+		// The session may run on another context, start it from there
+		asio::post(session->socket.get_executor(), [session] { session->start(); });
+		self->accept();
+	});
+}
+
+AdminHttpServer::Params AdminHttpServer::parseQuery(std::string_view query) {
+	const auto decode = [](std::string_view text) {
+		std::string decoded;
+		decoded.reserve(text.size());
+		for (size_t i = 0; i < text.size(); ++i) {
+			if (text[i] == '+') {
+				decoded.push_back(' ');
+			} else if (text[i] == '%' && i + 2 < text.size() && std::isxdigit(static_cast<unsigned char>(text[i + 1])) && std::isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+				uint8_t value = 0;
+				std::from_chars(text.data() + i + 1, text.data() + i + 3, value, 16);
+				decoded.push_back(static_cast<char>(value));
+				i += 2;
+			} else {
+				decoded.push_back(text[i]);
+			}
+		}
+		return decoded;
+	};
+
+	Params params;
+	while (!query.empty()) {
+		const auto pairEnd = query.find('&');
+		const auto pair = query.substr(0, pairEnd);
+		if (const auto separator = pair.find('='); separator != std::string_view::npos) {
+			params[decode(pair.substr(0, separator))] = decode(pair.substr(separator + 1));
+		} else if (!pair.empty()) {
+			params[decode(pair)] = std::string();
+		}
+		query = pairEnd == std::string_view::npos ? std::string_view() : query.substr(pairEnd + 1);
+	}
+	return params;
+}
+
+AdminHttpServer::Response AdminHttpServer::route(std::string_view target) {
+	const auto queryStart = target.find('?');
+	const auto path = target.substr(0, queryStart);
+	const auto params = parseQuery(queryStart == std::string_view::npos ? std::string_view() : target.substr(queryStart + 1));
+
+	if (path == "/") {
+		return { 200, std::string(INDEX) };
+	}
+	if (path == "/dispatcher") {
+		return { 200, g_dispatcher().getFlightRecorder().getReport(getNumberParam(params, "cycles", 20)) };
+	}
+	if (path == "/memory") {
+		return { 200, g_game().getMemoryReport() };
+	}
+	if (path == "/traffic") {
+		return { 200, g_game().getTrafficReport(getParam(params, "player"), getNumberParam(params, "limit", 20)) };
+	}
+	if (path == "/spectators") {
+		return { 200, Spectators::getCacheReport() };
+	}
+	if (path == "/pathfinding") {
+		auto &map = g_game().map;
+		return { 200, fmt::format("Sector graph clusters: {}\nFollow path fields: {}", map.sectorGraph.getClusterCount(), map.followPathCache.getFieldCount()) };
+	}
+	if (path == "/profiler/lua") {
+		return { 200, g_luaProfiler().getReport(getNumberParam(params, "limit", 20)) };
+	}
+	if (path == "/profiler/samples") {
+		return { 200, getSamplingProfilerDump() };
+	}
+	return { 404, fmt::format("Unknown report {}, the reports are:\n{}", path, INDEX) };
+}
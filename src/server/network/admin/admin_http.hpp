@@ -0,0 +1,57 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class ServiceManager;
+
+/**
+ * Read-only HTTP endpoint serving the engine reports as plain text, for
+ * triage on a live server without a debugger or a metrics rebuild.
+ *
+ * It accepts on the main network thread and serves each request from a
+ * network thread; the reports themselves are built in a dispatcher task,
+ * like the scripts asking for them, and only the answer goes back to the
+ * connection. One GET request per connection, closed once answered.
+ */
+class AdminHttpServer : public std::enable_shared_from_this<AdminHttpServer> {
+public:
+	explicit AdminHttpServer(asio::io_service &io_service, ServiceManager &manager) :
+		io_service(io_service), manager(manager) { }
+
+	// non-copyable
+	AdminHttpServer(const AdminHttpServer &) = delete;
+	AdminHttpServer &operator=(const AdminHttpServer &) = delete;
+
+	bool open(const std::string &address, uint16_t port);
+	void close();
+
+	using Params = phmap::flat_hash_map<std::string, std::string>;
+
+	struct Response {
+		uint16_t status = 200;
+		std::string body;
+	};
+
+	/**
+	 * @brief Builds the answer of a request target, such as "/dispatcher?cycles=10".
+	 * Touches game state, must run on the dispatcher.
+	 */
+	static Response route(std::string_view target);
+	static Params parseQuery(std::string_view query);
+
+private:
+	class Session;
+
+	void accept();
+
+	asio::io_service &io_service;
+	ServiceManager &manager;
+	std::unique_ptr<asio::ip::tcp::acceptor> acceptor;
+};
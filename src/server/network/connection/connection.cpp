@@ -13,6 +13,8 @@
 #include "server/network/message/outputmessage.hpp"
 #include "server/network/protocol/protocol.hpp"
 #include "game/scheduling/dispatcher.hpp"
+#include "lib/metrics/metrics.hpp"
+#include "lib/thread/thread_pool.hpp"
 #include "server/server.hpp"
 
 Connection_ptr ConnectionManager::createConnection(asio::io_service &io_service, ConstServicePort_ptr servicePort) {
@@ -25,6 +27,22 @@ void ConnectionManager::releaseConnection(const Connection_ptr &connection) {
 	connections.erase(connection);
 }
 
+size_t ConnectionManager::closeExpired() {
+	const auto now = Connection::getTimeoutClock();
+	std::vector<Connection_ptr> expired;
+	connections.for_each([now, &expired](const Connection_ptr &connection) {
+		if (connection->isExpired(now)) {
+			expired.emplace_back(connection);
+		}
+	});
+
+	// Closed from their own context, the set can't be changed while it is walked
+	for (const auto &connection : expired) {
+		asio::post(connection->socket.get_executor(), [connection] { connection->onTimeout(); });
+	}
+	return expired.size();
+}
+
 void ConnectionManager::closeAll() {
 	connections.for_each([&](const Connection_ptr &connection) {
 		if (connection->socket.is_open()) {
@@ -44,8 +62,7 @@ void ConnectionManager::closeAll() {
 }
 
 Connection::Connection(asio::io_service &initIoService, ConstServicePort_ptr initservicePort) :
-	readTimer(initIoService),
-	writeTimer(initIoService),
+	parallelEncoding(g_configManager().getBoolean(PARALLEL_PACKET_ENCODING, __FUNCTION__)),
 	service_port(std::move(initservicePort)),
 	socket(initIoService) {
 }
@@ -76,8 +93,8 @@ void Connection::closeSocket() {
 	}
 
 	try {
-		readTimer.cancel();
-		writeTimer.cancel();
+		clearTimeout(readDeadline);
+		clearTimeout(writeDeadline);
 		socket.cancel();
 
 		std::error_code error;
@@ -103,9 +120,17 @@ void Connection::accept(Protocol_ptr protocolPtr) {
 	acceptInternal(false);
 }
 
+NetworkMessage &Connection::recvMessage() {
+	auto &message = recvMessages[recvSlot];
+	if (!message) {
+		message = std::make_unique<NetworkMessage>();
+	}
+	return *message;
+}
+
 void Connection::acceptInternal(bool toggleParseHeader) {
-	readTimer.expires_from_now(std::chrono::seconds(CONNECTION_READ_TIMEOUT));
-	readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
+	auto &msg = recvMessage();
+	setTimeout(readDeadline, CONNECTION_READ_TIMEOUT);
 
 	try {
 		asio::async_read(socket, asio::buffer(msg.getBuffer(), HEADER_LENGTH), [self = shared_from_this(), toggleParseHeader](const std::error_code &error, std::size_t N) {
@@ -122,7 +147,7 @@ void Connection::acceptInternal(bool toggleParseHeader) {
 }
 void Connection::parseProxyIdentification(const std::error_code &error) {
 	std::scoped_lock lock(connectionLock);
-	readTimer.cancel();
+	clearTimeout(readDeadline);
 
 	if (error || connectionState == CONNECTION_STATE_CLOSED) {
 		if (error != asio::error::operation_aborted && error != asio::error::eof && error != asio::error::connection_reset) {
@@ -132,6 +157,7 @@ void Connection::parseProxyIdentification(const std::error_code &error) {
 		return;
 	}
 
+	auto &msg = recvMessage();
 	uint8_t* msgBuffer = msg.getBuffer();
 	auto charData = static_cast<char*>(static_cast<void*>(msgBuffer));
 	std::string serverName = g_configManager().getString(SERVER_NAME, __FUNCTION__) + "\n";
@@ -146,8 +172,7 @@ void Connection::parseProxyIdentification(const std::error_code &error) {
 			if (remainder > 0) {
 				connectionState = CONNECTION_STATE_READINGS;
 				try {
-					readTimer.expires_from_now(std::chrono::seconds(CONNECTION_READ_TIMEOUT));
-					readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
+					setTimeout(readDeadline, CONNECTION_READ_TIMEOUT);
 
 					// Read the remainder of proxy identification
 					asio::async_read(socket, asio::buffer(msg.getBuffer(), remainder), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseProxyIdentification(error); });
@@ -176,7 +201,7 @@ void Connection::parseProxyIdentification(const std::error_code &error) {
 
 void Connection::parseHeader(const std::error_code &error) {
 	std::scoped_lock lock(connectionLock);
-	readTimer.cancel();
+	clearTimeout(readDeadline);
 
 	if (error) {
 		if (error != asio::error::operation_aborted && error != asio::error::eof && error != asio::error::connection_reset) {
@@ -190,7 +215,8 @@ void Connection::parseHeader(const std::error_code &error) {
 
 	uint32_t timePassed = std::max<uint32_t>(1, (time(nullptr) - timeConnected) + 1);
 	if ((++packetsSent / timePassed) > static_cast<uint32_t>(g_configManager().getNumber(MAX_PACKETS_PER_SECOND, __FUNCTION__))) {
-		g_logger().warn("[Connection::parseHeader] - {} disconnected for exceeding packet per second limit.", convertIPToString(getIP()));
+		static LogRateLimiter floodDisconnects;
+		g_logger().warn(floodDisconnects, "[Connection::parseHeader] - {} disconnected for exceeding packet per second limit.", convertIPToString(getIP()));
 		close();
 		return;
 	}
@@ -200,6 +226,7 @@ void Connection::parseHeader(const std::error_code &error) {
 		packetsSent = 0;
 	}
 
+	auto &msg = recvMessage();
 	uint16_t size = msg.getLengthHeader();
 	if (size == 0 || size > INPUTMESSAGE_MAXSIZE) {
 		close(FORCE_CLOSE);
@@ -207,8 +234,7 @@ void Connection::parseHeader(const std::error_code &error) {
 	}
 
 	try {
-		readTimer.expires_from_now(std::chrono::seconds(CONNECTION_READ_TIMEOUT));
-		readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
+		setTimeout(readDeadline, CONNECTION_READ_TIMEOUT);
 
 		// Read packet content
 		msg.setLength(size + HEADER_LENGTH);
@@ -222,7 +248,7 @@ void Connection::parseHeader(const std::error_code &error) {
 
 void Connection::parsePacket(const std::error_code &error) {
 	std::scoped_lock lock(connectionLock);
-	readTimer.cancel();
+	clearTimeout(readDeadline);
 
 	if (error || connectionState == CONNECTION_STATE_CLOSED) {
 		if (error) {
@@ -232,6 +258,7 @@ void Connection::parsePacket(const std::error_code &error) {
 		return;
 	}
 
+	auto &msg = recvMessage();
 	bool skipReadingNextPacket = false;
 	if (!receivedFirst) {
 		// First message received
@@ -269,17 +296,24 @@ void Connection::parsePacket(const std::error_code &error) {
 
 		protocol->onRecvFirstMessage(msg);
 	} else {
-		// Send the packet to the current protocol
-		skipReadingNextPacket = protocol->onRecvMessage(msg);
+		// Send the packet to the current protocol, once it is queued on the dispatcher the next one goes to another buffer
+		if (protocol->onRecvMessage(msg)) {
+			recvSlot = (recvSlot + 1) % MAX_PENDING_PACKETS;
+			skipReadingNextPacket = ++pendingPackets == MAX_PENDING_PACKETS;
+			readPaused = skipReadingNextPacket;
+			if (readPaused) {
+				// The client sends faster than the dispatcher parses, its next packets wait in the socket
+				g_metrics().addCounter("connection_read_paused", 1);
+			}
+		}
 	}
 
 	try {
-		readTimer.expires_from_now(std::chrono::seconds(CONNECTION_READ_TIMEOUT));
-		readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
+		setTimeout(readDeadline, CONNECTION_READ_TIMEOUT);
 
 		if (!skipReadingNextPacket) {
 			// Wait to the next packet
-			asio::async_read(socket, asio::buffer(msg.getBuffer(), HEADER_LENGTH), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseHeader(error); });
+			asio::async_read(socket, asio::buffer(recvMessage().getBuffer(), HEADER_LENGTH), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseHeader(error); });
 		}
 	} catch (const std::system_error &e) {
 		g_logger().error("[Connection::parsePacket] - error: {}", e.what());
@@ -288,17 +322,32 @@ void Connection::parsePacket(const std::error_code &error) {
 }
 
 void Connection::resumeWork() {
-	readTimer.expires_from_now(std::chrono::seconds(CONNECTION_READ_TIMEOUT));
-	readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
+	std::scoped_lock lock(connectionLock);
+	if (pendingPackets > 0) {
+		--pendingPackets;
+	}
+
+	// Reading only stops when every buffer is waiting on the dispatcher, otherwise it never paused
+	if (!readPaused || connectionState == CONNECTION_STATE_CLOSED) {
+		return;
+	}
+	readPaused = false;
+
+	setTimeout(readDeadline, CONNECTION_READ_TIMEOUT);
 
 	try {
-		asio::async_read(socket, asio::buffer(msg.getBuffer(), HEADER_LENGTH), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseHeader(error); });
+		asio::async_read(socket, asio::buffer(recvMessage().getBuffer(), HEADER_LENGTH), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseHeader(error); });
 	} catch (const std::system_error &e) {
 		g_logger().error("[Connection::resumeWork] - Exception in async_read: {}", e.what());
 		close(FORCE_CLOSE);
 	}
 }
 
+size_t Connection::getQueuedMessages() {
+	std::scoped_lock lock(connectionLock);
+	return messageQueue.size();
+}
+
 void Connection::send(const OutputMessage_ptr &outputMessage) {
 	std::scoped_lock lock(connectionLock);
 	if (connectionState == CONNECTION_STATE_CLOSED) {
@@ -308,6 +357,17 @@ void Connection::send(const OutputMessage_ptr &outputMessage) {
 	bool noPendingWrite = messageQueue.empty();
 	messageQueue.emplace_back(outputMessage);
 
+	if (parallelEncoding) {
+		if (!socket.is_open()) {
+			g_logger().error("[Connection::send] - Socket is not open for writing.");
+			close(FORCE_CLOSE);
+		} else if (!encodingScheduled) {
+			encodingScheduled = true;
+			inject<ThreadPool>().detach_task([self = shared_from_this()] { self->encodeMessages(); });
+		}
+		return;
+	}
+
 	if (noPendingWrite) {
 		if (socket.is_open()) {
 			try {
@@ -332,12 +392,45 @@ void Connection::internalWorker() {
 		return;
 	}
 
-	const auto &outputMessage = messageQueue.front();
-	lock.unlock();
-	protocol->onSendMessage(outputMessage);
-	lock.lock();
+	if (!parallelEncoding && !encodeQueued(lock)) {
+		return;
+	}
+
+	writeEncoded();
+}
+
+bool Connection::encodeQueued(std::unique_lock<std::recursive_mutex> &lock) {
+	while (encodedMessages < messageQueue.size()) {
+		// Only the write path pops the queue, and it never pops a message that is not encoded yet
+		auto outputMessage = messageQueue[encodedMessages];
+		lock.unlock();
+		protocol->onSendMessage(outputMessage);
+		lock.lock();
+
+		// A write error clears the queue and closes the connection
+		if (messageQueue.empty()) {
+			return false;
+		}
 
-	internalSend(outputMessage);
+		++encodedMessages;
+		if (parallelEncoding && !writing) {
+			writing = true;
+			try {
+				asio::post(socket.get_executor(), [self = shared_from_this()] { self->internalWorker(); });
+			} catch (const std::system_error &e) {
+				g_logger().error("[Connection::encodeQueued] - Exception in posting write operation: {}", e.what());
+				close(FORCE_CLOSE);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void Connection::encodeMessages() {
+	std::unique_lock lock(connectionLock);
+	encodeQueued(lock);
+	encodingScheduled = false;
 }
 
 uint32_t Connection::getIP() {
@@ -356,12 +449,24 @@ uint32_t Connection::getIP() {
 	return ip;
 }
 
-void Connection::internalSend(const OutputMessage_ptr &outputMessage) {
-	writeTimer.expires_from_now(std::chrono::seconds(CONNECTION_WRITE_TIMEOUT));
-	writeTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
+void Connection::writeEncoded() {
+	// Every encoded message at the front of the queue goes out in a single gathered write
+	const auto count = std::min(encodedMessages, MAX_WRITE_BATCH);
+	writeBuffers.clear();
+	for (size_t i = 0; i < count; ++i) {
+		const auto &outputMessage = messageQueue[i];
+		writeBuffers.emplace_back(outputMessage->getOutputBuffer(), outputMessage->getLength());
+	}
+	writtenMessages = count;
+
+	internalSend();
+}
+
+void Connection::internalSend() {
+	setTimeout(writeDeadline, CONNECTION_WRITE_TIMEOUT);
 
 	try {
-		asio::async_write(socket, asio::buffer(outputMessage->getOutputBuffer(), outputMessage->getLength()), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->onWriteOperation(error); });
+		asio::async_write(socket, writeBuffers, [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->onWriteOperation(error); });
 	} catch (const std::system_error &e) {
 		g_logger().error("[Connection::internalSend] - Exception in async_write: {}", e.what());
 		close(FORCE_CLOSE);
@@ -370,39 +475,53 @@ void Connection::internalSend(const OutputMessage_ptr &outputMessage) {
 
 void Connection::onWriteOperation(const std::error_code &error) {
 	std::unique_lock lock(connectionLock);
-	writeTimer.cancel();
+	clearTimeout(writeDeadline);
 
 	if (error) {
 		g_logger().error("[Connection::onWriteOperation] - Write error: {}", error.message());
 		messageQueue.clear();
+		encodedMessages = 0;
 		close(FORCE_CLOSE);
 		return;
 	}
 
-	messageQueue.pop_front();
+	messageQueue.erase(messageQueue.begin(), messageQueue.begin() + static_cast<std::ptrdiff_t>(writtenMessages));
+	encodedMessages -= writtenMessages;
+	writtenMessages = 0;
 
-	if (!messageQueue.empty()) {
-		const auto &outputMessage = messageQueue.front();
-		lock.unlock();
-		protocol->onSendMessage(outputMessage);
-		lock.lock();
-		internalSend(outputMessage);
-	} else if (connectionState == CONNECTION_STATE_CLOSED) {
+	if (!parallelEncoding && !messageQueue.empty()) {
+		if (encodeQueued(lock)) {
+			writeEncoded();
+		}
+		return;
+	}
+
+	if (encodedMessages > 0) {
+		writeEncoded();
+		return;
+	}
+
+	// The encoder posts the next write once it is ready
+	writing = false;
+	if (messageQueue.empty() && connectionState == CONNECTION_STATE_CLOSED) {
 		closeSocket();
 	}
 }
 
-void Connection::handleTimeout(ConnectionWeak_ptr connectionWeak, const std::error_code &error) {
-	if (error == asio::error::operation_aborted) {
+bool Connection::isExpired(int64_t now) const {
+	const auto expired = [now](const std::atomic<int64_t> &deadline) {
+		const auto value = deadline.load(std::memory_order_relaxed);
+		return value != 0 && value <= now;
+	};
+	return expired(readDeadline) || expired(writeDeadline);
+}
+
+void Connection::onTimeout() {
+	// The operation may have completed since the sweep saw the deadline
+	if (!isExpired(getTimeoutClock())) {
 		return;
 	}
 
-	if (auto connection = connectionWeak.lock()) {
-		if (!error) {
-			g_logger().debug("Connection Timeout, IP: {}", convertIPToString(connection->getIP()));
-		} else {
-			g_logger().debug("Connection Timeout or error: {}, IP: {}", error.message(), convertIPToString(connection->getIP()));
-		}
-		connection->close(FORCE_CLOSE);
-	}
+	g_logger().debug("Connection Timeout, IP: {}", convertIPToString(getIP()));
+	close(FORCE_CLOSE);
 }
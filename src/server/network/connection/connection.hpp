@@ -15,6 +15,8 @@
 
 static constexpr int32_t CONNECTION_WRITE_TIMEOUT = 30;
 static constexpr int32_t CONNECTION_READ_TIMEOUT = 30;
+// The timeouts are checked at this granularity, a connection may outlive its deadline by as much
+static constexpr auto CONNECTION_TIMEOUT_SWEEP_INTERVAL = std::chrono::seconds(1);
 
 class Protocol;
 using Protocol_ptr = std::shared_ptr<Protocol>;
@@ -41,6 +43,12 @@ public:
 	void releaseConnection(const Connection_ptr &connection);
 	void closeAll();
 
+	/**
+	 * @brief Closes the connections past their read or write deadline, returns how many.
+	 * One sweep for all of them instead of a timer per connection, see ServiceManager::sweepConnectionTimeouts.
+	 */
+	size_t closeExpired();
+
 private:
 	phmap::parallel_flat_hash_set_m<Connection_ptr> connections;
 };
@@ -67,6 +75,9 @@ public:
 
 	void send(const OutputMessage_ptr &outputMessage);
 
+	// Messages not written to the socket yet, including the ones being written
+	size_t getQueuedMessages();
+
 	uint32_t getIP();
 
 private:
@@ -76,24 +87,69 @@ private:
 
 	void onWriteOperation(const std::error_code &error);
 
-	static void handleTimeout(ConnectionWeak_ptr connectionWeak, const std::error_code &error);
+	static int64_t getTimeoutClock() {
+		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+	// A deadline is armed and cleared with a plain store, at every read and write
+	static void setTimeout(std::atomic<int64_t> &deadline, int32_t seconds) {
+		deadline.store(getTimeoutClock() + seconds * 1000, std::memory_order_relaxed);
+	}
+	static void clearTimeout(std::atomic<int64_t> &deadline) {
+		deadline.store(0, std::memory_order_relaxed);
+	}
+	bool isExpired(int64_t now) const;
+	void onTimeout();
 
 	void closeSocket();
 	void internalWorker();
-	void internalSend(const OutputMessage_ptr &outputMessage);
+	void internalSend();
+	void writeEncoded();
+	/**
+	 * @brief Encodes the queued messages that are not encoded yet, in queue order.
+	 * @return false when the connection was closed meanwhile.
+	 */
+	bool encodeQueued(std::unique_lock<std::recursive_mutex> &lock);
+	/**
+	 * @brief Encodes the queued messages on the thread pool, in queue order.
+	 * Every encoded message is handed back to the socket executor to be written.
+	 */
+	void encodeMessages();
 
 	asio::ip::tcp::socket &getSocket() {
 		return socket;
 	}
 
-	NetworkMessage msg;
+	/**
+	 * @brief The buffer the next packet is read into.
+	 * A packet handed to the dispatcher keeps its buffer until the dispatcher
+	 * calls resumeWork, meanwhile the next packets are read into the next slots.
+	 */
+	NetworkMessage &recvMessage();
+
+	// Packets read ahead of the dispatcher, reading pauses when all of them are waiting there
+	static constexpr size_t MAX_PENDING_PACKETS = 4;
+	std::array<std::unique_ptr<NetworkMessage>, MAX_PENDING_PACKETS> recvMessages;
+	size_t recvSlot = 0;
+	size_t pendingPackets = 0;
+	bool readPaused = false;
 
-	asio::high_resolution_timer readTimer;
-	asio::high_resolution_timer writeTimer;
+	// Steady clock milliseconds, 0 while nothing is awaited
+	std::atomic<int64_t> readDeadline { 0 };
+	std::atomic<int64_t> writeDeadline { 0 };
 
 	std::recursive_mutex connectionLock;
 
-	std::list<OutputMessage_ptr> messageQueue;
+	std::deque<OutputMessage_ptr> messageQueue;
+
+	// The first encodedMessages of the queue are ready to be written, the first writtenMessages are being written
+	static constexpr size_t MAX_WRITE_BATCH = 32;
+	std::vector<asio::const_buffer> writeBuffers;
+	size_t encodedMessages = 0;
+	size_t writtenMessages = 0;
+
+	const bool parallelEncoding;
+	bool encodingScheduled = false;
+	bool writing = false;
 
 	ConstServicePort_ptr service_port;
 	Protocol_ptr protocol;
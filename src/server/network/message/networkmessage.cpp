@@ -19,17 +19,21 @@ int32_t NetworkMessage::decodeHeader() {
 }
 
 std::string NetworkMessage::getString(uint16_t stringLen /* = 0*/) {
+	return std::string(getStringView(stringLen));
+}
+
+std::string_view NetworkMessage::getStringView(uint16_t stringLen /* = 0*/) {
 	if (stringLen == 0) {
 		stringLen = get<uint16_t>();
 	}
 
 	if (!canRead(stringLen)) {
-		return std::string();
+		return {};
 	}
 
-	char* v = reinterpret_cast<char*>(buffer) + info.position; // does not break strict aliasing
+	const char* v = reinterpret_cast<const char*>(buffer) + info.position; // does not break strict aliasing
 	info.position += stringLen;
-	return std::string(v, stringLen);
+	return { v, stringLen };
 }
 
 Position NetworkMessage::getPosition() {
@@ -40,7 +44,7 @@ Position NetworkMessage::getPosition() {
 	return pos;
 }
 
-void NetworkMessage::addString(const std::string &value, const std::string &function /* = ""*/) {
+void NetworkMessage::addString(std::string_view value, std::string_view function /* = {}*/) {
 	size_t stringLen = value.length();
 	if (value.empty() && !function.empty()) {
 		g_logger().debug("[NetworkMessage::addString] - Value string is empty, function '{}'", function);
@@ -55,7 +59,7 @@ void NetworkMessage::addString(const std::string &value, const std::string &func
 	}
 
 	add<uint16_t>(stringLen);
-	memcpy(buffer + info.position, value.c_str(), stringLen);
+	memcpy(buffer + info.position, value.data(), stringLen);
 	info.position += stringLen;
 	info.length += stringLen;
 }
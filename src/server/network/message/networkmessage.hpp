@@ -59,6 +59,11 @@ public:
 	}
 
 	std::string getString(uint16_t stringLen = 0);
+	/**
+	 * @brief Reads a string without copying it, the view points into the message buffer.
+	 * Only valid until the message is reused, copy it to keep it past the parse call.
+	 */
+	std::string_view getStringView(uint16_t stringLen = 0);
 	Position getPosition();
 
 	// skips count unknown/unused bytes in an incoming message
@@ -103,7 +108,27 @@ public:
 	 * making it easier to diagnose issues related to network message construction,
 	 * especially in complex systems where the same method might be called from multiple places.
 	 */
-	void addString(const std::string &value, const std::string &function = "");
+	void addString(std::string_view value, std::string_view function = {});
+
+	/**
+	 * Adds a string formatted straight into the message buffer, without building it first.
+	 * Nothing is added when the formatted text doesn't fit in the message.
+	 */
+	template <typename... Args>
+	void addFormattedString(fmt::format_string<Args...> format, Args &&... args) {
+		// Room left after the length, canAdd keeps one byte free
+		const size_t available = info.position + 3 < MAX_BODY_LENGTH ? MAX_BODY_LENGTH - info.position - 3 : 0;
+		auto* target = reinterpret_cast<char*>(buffer + info.position + 2);
+		const auto result = fmt::format_to_n(target, available, format, std::forward<Args>(args)...);
+		if (result.size > available) {
+			g_logger().error("[NetworkMessage::addFormattedString] - NetworkMessage size is wrong: {}", result.size);
+			return;
+		}
+
+		add<uint16_t>(static_cast<uint16_t>(result.size));
+		info.position += static_cast<MsgSize_t>(result.size);
+		info.length += static_cast<MsgSize_t>(result.size);
+	}
 
 	void addDouble(double value, uint8_t precision = 2);
 
@@ -15,6 +15,124 @@
 
 const std::chrono::milliseconds OUTPUTMESSAGE_AUTOSEND_DELAY { 10 };
 
+namespace {
+	/**
+	 * Bounded lock-free queue of free message blocks. Messages are built on the
+	 * dispatcher and released on the network thread once written, so the blocks
+	 * have to cross threads; every cell carries a sequence number that tells the
+	 * producers and consumers whose turn it is.
+	 */
+	class FreeBlocks {
+	public:
+		static constexpr size_t CAPACITY = 256;
+
+		FreeBlocks() {
+			for (size_t i = 0; i < CAPACITY; ++i) {
+				cells[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		~FreeBlocks() {
+			void* block;
+			while (pop(block)) {
+				::operator delete(block);
+			}
+		}
+
+		bool push(void* block) {
+			auto pos = pushPos.load(std::memory_order_relaxed);
+			Cell* cell;
+			while (true) {
+				cell = &cells[pos & MASK];
+				const auto diff = static_cast<intptr_t>(cell->sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos);
+				if (diff == 0) {
+					if (pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						break;
+					}
+				} else if (diff < 0) {
+					return false;
+				} else {
+					pos = pushPos.load(std::memory_order_relaxed);
+				}
+			}
+			cell->block = block;
+			cell->sequence.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool pop(void*&block) {
+			auto pos = popPos.load(std::memory_order_relaxed);
+			Cell* cell;
+			while (true) {
+				cell = &cells[pos & MASK];
+				const auto diff = static_cast<intptr_t>(cell->sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos + 1);
+				if (diff == 0) {
+					if (popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						break;
+					}
+				} else if (diff < 0) {
+					return false;
+				} else {
+					pos = popPos.load(std::memory_order_relaxed);
+				}
+			}
+			block = cell->block;
+			cell->sequence.store(pos + CAPACITY, std::memory_order_release);
+			return true;
+		}
+
+	private:
+		static constexpr size_t MASK = CAPACITY - 1;
+		static_assert((CAPACITY & MASK) == 0, "CAPACITY must be a power of two");
+
+		struct Cell {
+			std::atomic<size_t> sequence;
+			void* block = nullptr;
+		};
+
+		std::array<Cell, CAPACITY> cells;
+		alignas(64) std::atomic<size_t> pushPos { 0 };
+		alignas(64) std::atomic<size_t> popPos { 0 };
+	};
+
+	template <typename T>
+	struct OutputMessageAllocator {
+		using value_type = T;
+
+		OutputMessageAllocator() noexcept = default;
+
+		template <typename U>
+		OutputMessageAllocator(const OutputMessageAllocator<U> &) noexcept { }
+
+		T* allocate(size_t n) {
+			void* block;
+			if (n == 1 && getFreeBlocks().pop(block)) {
+				return static_cast<T*>(block);
+			}
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+
+		void deallocate(T* block, size_t n) noexcept {
+			if (n == 1 && getFreeBlocks().push(block)) {
+				return;
+			}
+			::operator delete(block);
+		}
+
+		template <typename U>
+		bool operator==(const OutputMessageAllocator<U> &) const noexcept {
+			return true;
+		}
+
+	private:
+		static FreeBlocks &getFreeBlocks() {
+			// Never destroyed, messages can still be released during the static destruction
+			static auto* freeBlocks = new FreeBlocks();
+			return *freeBlocks;
+		}
+	};
+}
+
 void OutputMessagePool::scheduleSendAll() {
 	g_dispatcher().scheduleEvent(
 		OUTPUTMESSAGE_AUTOSEND_DELAY.count(), [this] { sendAll(); }, "OutputMessagePool::sendAll"
@@ -23,35 +141,52 @@ void OutputMessagePool::scheduleSendAll() {
 
 void OutputMessagePool::sendAll() {
 	// dispatcher thread
-	for (auto &protocol : bufferedProtocols) {
+	std::swap(bufferedProtocols, sendingProtocols);
+	for (const auto &protocol : sendingProtocols) {
+		protocol->autosendQueued = false;
+		if (!protocol->autosend) {
+			continue;
+		}
+
 		auto &msg = protocol->getCurrentBuffer();
 		if (msg) {
 			protocol->send(std::move(msg));
 		}
-	}
 
-	if (!bufferedProtocols.empty()) {
-		scheduleSendAll();
+		// Whatever the congested connection has no room for goes on the next tick
+		if (protocol->sendBulkBuffers()) {
+			markProtocolBuffered(protocol);
+		}
 	}
+	sendingProtocols.clear();
 }
 
-void OutputMessagePool::addProtocolToAutosend(Protocol_ptr protocol) {
+void OutputMessagePool::addProtocolToAutosend(const Protocol_ptr &protocol) {
 	// dispatcher thread
-	if (bufferedProtocols.empty()) {
-		scheduleSendAll();
+	protocol->autosend = true;
+	if (protocol->getCurrentBuffer() || !protocol->bulkBuffers.empty()) {
+		markProtocolBuffered(protocol);
 	}
-	bufferedProtocols.emplace_back(protocol);
 }
 
 void OutputMessagePool::removeProtocolFromAutosend(const Protocol_ptr &protocol) {
+	// dispatcher thread, a queued entry is skipped by the next sendAll
+	protocol->autosend = false;
+}
+
+void OutputMessagePool::markProtocolBuffered(const Protocol_ptr &protocol) {
 	// dispatcher thread
-	auto it = std::ranges::find(bufferedProtocols.begin(), bufferedProtocols.end(), protocol);
-	if (it != bufferedProtocols.end()) {
-		*it = bufferedProtocols.back();
-		bufferedProtocols.pop_back();
+	if (!protocol->autosend || protocol->autosendQueued) {
+		return;
 	}
+
+	protocol->autosendQueued = true;
+	if (bufferedProtocols.empty()) {
+		scheduleSendAll();
+	}
+	bufferedProtocols.emplace_back(protocol);
 }
 
 OutputMessage_ptr OutputMessagePool::getOutputMessage() {
-	return std::make_shared<OutputMessage>();
+	return std::allocate_shared<OutputMessage>(OutputMessageAllocator<OutputMessage>());
 }
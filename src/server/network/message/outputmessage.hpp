@@ -15,9 +15,10 @@
 
 class Protocol;
 
-class OutputMessage : public NetworkMessage {
+class OutputMessage : public NetworkMessage, private MemoryTracked<OutputMessage, MemoryCategory::NetworkBuffers> {
 public:
-	OutputMessage() = default;
+	// User-provided, so a recycled block is not zeroed: only the written part of the buffer is ever sent
+	OutputMessage() { }
 
 	// non-copyable
 	OutputMessage(const OutputMessage &) = delete;
@@ -88,11 +89,17 @@ public:
 
 	static OutputMessage_ptr getOutputMessage();
 
-	void addProtocolToAutosend(Protocol_ptr protocol);
+	void addProtocolToAutosend(const Protocol_ptr &protocol);
 	void removeProtocolFromAutosend(const Protocol_ptr &protocol);
 
+	/**
+	 * @brief Queues the protocol for the next autosend, called when its output buffer stops being empty.
+	 */
+	void markProtocolBuffered(const Protocol_ptr &protocol);
+
 private:
-	// NOTE: A vector is used here because this container is mostly read
-	// and relatively rarely modified (only when a client connects/disconnects)
+	// Only the autosend protocols that have something buffered, so a tick costs nothing for idle clients
 	std::vector<Protocol_ptr> bufferedProtocols;
+	// Swapped with bufferedProtocols on every tick, keeps both allocations alive
+	std::vector<Protocol_ptr> sendingProtocols;
 };
@@ -0,0 +1,120 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Ids of the creatures a client knows, at most the client's limit plus the one being added.
+ *
+ * A fixed open addressing table kept inline in the protocol, with linear
+ * probing and backward shift erase, so the lookups of every map description
+ * never allocate or chase nodes. Id 0 is never a creature and marks a free slot.
+ */
+class KnownCreatureSet {
+public:
+	// The client forgets a creature for each one it learns past this many
+	static constexpr size_t CLIENT_LIMIT = 1300;
+
+	bool contains(uint32_t id) const {
+		return slots[find(id)] == id && id != 0;
+	}
+
+	/**
+	 * @return False when the creature was already known.
+	 */
+	bool insert(uint32_t id) {
+		const auto slot = find(id);
+		if (slots[slot] == id) {
+			return false;
+		}
+
+		slots[slot] = id;
+		++count;
+		return true;
+	}
+
+	void erase(uint32_t id) {
+		auto slot = find(id);
+		if (slots[slot] != id) {
+			return;
+		}
+
+		// Pulls back the entries of the probe run, so no tombstone is left behind
+		for (auto next = (slot + 1) & MASK; slots[next] != 0; next = (next + 1) & MASK) {
+			const auto home = getHome(slots[next]);
+			const bool between = slot <= next ? (slot < home && home <= next) : (slot < home || home <= next);
+			if (!between) {
+				slots[slot] = slots[next];
+				slot = next;
+			}
+		}
+		slots[slot] = 0;
+		--count;
+	}
+
+	size_t size() const {
+		return count;
+	}
+
+	/**
+	 * @brief Forgets one creature other than keep, the first one canEvict accepts or else any.
+	 * The scan resumes where the last one stopped, so the same entries are not checked each time.
+	 * @return Id of the forgotten creature, 0 when there was none.
+	 */
+	template <typename Predicate>
+	uint32_t evict(uint32_t keep, Predicate &&canEvict) {
+		uint32_t fallback = 0;
+		for (size_t i = 0; i < SLOTS; ++i) {
+			const auto slot = (cursor + i) & MASK;
+			const auto id = slots[slot];
+			if (id == 0 || id == keep) {
+				continue;
+			}
+
+			if (canEvict(id)) {
+				cursor = (slot + 1) & MASK;
+				erase(id);
+				return id;
+			}
+
+			if (fallback == 0) {
+				fallback = id;
+			}
+		}
+
+		if (fallback != 0) {
+			erase(fallback);
+		}
+		return fallback;
+	}
+
+private:
+	// Twice the next power of two over the limit, probe runs stay short
+	static constexpr size_t SLOTS = 4096;
+	static constexpr size_t MASK = SLOTS - 1;
+	static_assert(SLOTS > CLIENT_LIMIT * 2);
+
+	static size_t getHome(uint32_t id) {
+		// Fibonacci hashing spreads the sequential creature ids
+		return static_cast<size_t>((id * 2654435769u) >> 20) & MASK;
+	}
+
+	// Slot of the id, or the free slot ending its probe run
+	size_t find(uint32_t id) const {
+		auto slot = getHome(id);
+		while (slots[slot] != 0 && slots[slot] != id) {
+			slot = (slot + 1) & MASK;
+		}
+		return slot;
+	}
+
+	std::array<uint32_t, SLOTS> slots {};
+	size_t count = 0;
+	size_t cursor = 0;
+};
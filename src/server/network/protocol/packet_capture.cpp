@@ -0,0 +1,109 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server/network/protocol/packet_capture.hpp"
+#include "server/network/message/networkmessage.hpp"
+#include "config/configmanager.hpp"
+
+namespace {
+	template <typename T>
+	void append(std::vector<char> &buffer, T value) {
+		const auto* bytes = reinterpret_cast<const char*>(&value);
+		buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+	}
+
+	template <typename T>
+	bool read(std::ifstream &file, T &value) {
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+}
+
+std::unique_ptr<PacketCapture> PacketCapture::open(const std::string &characterName, uint16_t clientVersion) {
+	static std::atomic<uint32_t> sessions = 0;
+
+	const std::filesystem::path directory = g_configManager().getString(PACKET_CAPTURE_DIRECTORY, __FUNCTION__);
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+
+	std::string name = characterName;
+	std::ranges::replace_if(name, [](char c) { return !std::isalnum(static_cast<unsigned char>(c)); }, '_');
+	const auto path = directory / fmt::format("{}-{}-{}.cap", time(nullptr), ++sessions, name);
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		g_logger().warn("[PacketCapture::open] - Failed to create {}", path.string());
+		return nullptr;
+	}
+
+	auto capture = std::make_unique<PacketCapture>(std::move(file));
+	append(capture->buffer, MAGIC);
+	append(capture->buffer, FORMAT_VERSION);
+	append(capture->buffer, clientVersion);
+	append(capture->buffer, capture->startMs);
+	return capture;
+}
+
+bool PacketCapture::load(const std::string &path, std::vector<Packet> &packets, uint16_t &clientVersion) {
+	std::ifstream file(path, std::ios::binary);
+	uint32_t magic = 0;
+	uint16_t formatVersion = 0;
+	int64_t startMs = 0;
+	if (!read(file, magic) || magic != MAGIC || !read(file, formatVersion) || formatVersion != FORMAT_VERSION || !read(file, clientVersion) || !read(file, startMs)) {
+		return false;
+	}
+
+	Packet packet;
+	uint16_t length = 0;
+	while (read(file, packet.offsetMs) && read(file, length)) {
+		packet.data.resize(length);
+		if (!file.read(reinterpret_cast<char*>(packet.data.data()), length)) {
+			// Cut by a crash, what was written before is still good
+			return false;
+		}
+		packets.emplace_back(packet);
+	}
+	return true;
+}
+
+PacketCapture::PacketCapture(std::ofstream &&file) :
+	file(std::move(file)), startMs(OTSYS_TIME()) {
+	buffer.reserve(FLUSH_SIZE * 2);
+}
+
+PacketCapture::~PacketCapture() {
+	flush();
+}
+
+void PacketCapture::record(const NetworkMessage &msg) {
+	const auto position = msg.getBufferPosition();
+	const auto end = msg.getLength() + NetworkMessage::INITIAL_BUFFER_POSITION;
+	if (end <= position) {
+		return;
+	}
+
+	const auto length = static_cast<uint16_t>(end - position);
+	append(buffer, static_cast<uint32_t>(OTSYS_TIME() - startMs));
+	append(buffer, length);
+	const auto* data = reinterpret_cast<const char*>(msg.getBuffer() + position);
+	buffer.insert(buffer.end(), data, data + length);
+
+	if (buffer.size() >= FLUSH_SIZE) {
+		flush();
+	}
+}
+
+void PacketCapture::flush() {
+	if (buffer.empty()) {
+		return;
+	}
+	file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	file.flush();
+	buffer.clear();
+}
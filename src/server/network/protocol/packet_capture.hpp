@@ -0,0 +1,64 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class NetworkMessage;
+
+/**
+ * Log of the decrypted packets a game session received, for the replay tool.
+ *
+ * One file per session, a header ("CPKT", format version, client version and
+ * the start of the session in milliseconds) followed by one record per packet:
+ * milliseconds since the start, length and the bytes parsePacket got. The
+ * login message is never recorded, so a capture holds no credentials, but it
+ * still holds what the player said. Written from the dispatcher thread.
+ */
+class PacketCapture {
+public:
+	struct Packet {
+		uint32_t offsetMs = 0;
+		std::vector<uint8_t> data;
+	};
+
+	static constexpr uint32_t MAGIC = 0x544B5043; // "CPKT"
+	static constexpr uint16_t FORMAT_VERSION = 1;
+
+	/**
+	 * @brief Opens the capture of a new session in the packetCaptureDirectory config.
+	 * @return nullptr when the file can't be created.
+	 */
+	static std::unique_ptr<PacketCapture> open(const std::string &characterName, uint16_t clientVersion);
+
+	/**
+	 * @brief Reads a capture written by a PacketCapture.
+	 * @return False when the file is not a capture, the packets read until then are kept.
+	 */
+	static bool load(const std::string &path, std::vector<Packet> &packets, uint16_t &clientVersion);
+
+	explicit PacketCapture(std::ofstream &&file);
+	~PacketCapture();
+
+	// non-copyable
+	PacketCapture(const PacketCapture &) = delete;
+	PacketCapture &operator=(const PacketCapture &) = delete;
+
+	// Records what is left to read of the message, which is the whole packet before parsePacket reads it
+	void record(const NetworkMessage &msg);
+
+private:
+	// The records are buffered and written a few KB at a time
+	static constexpr size_t FLUSH_SIZE = 16384;
+
+	void flush();
+
+	std::ofstream file;
+	std::vector<char> buffer;
+	int64_t startMs = 0;
+};
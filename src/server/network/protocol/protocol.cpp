@@ -13,10 +13,11 @@
 #include "server/network/message/outputmessage.hpp"
 #include "security/rsa.hpp"
 #include "game/scheduling/dispatcher.hpp"
+#include "lib/metrics/metrics.hpp"
 
 void Protocol::onSendMessage(const OutputMessage_ptr &msg) {
 	if (!rawMessages) {
-		const uint32_t sendMessageChecksum = msg->getLength() >= 128 && compression(*msg) ? (1U << 31) : 0;
+		const uint32_t sendMessageChecksum = compression(*msg) ? (1U << 31) : 0;
 
 		msg->writeMessageLength();
 
@@ -36,6 +37,9 @@ void Protocol::onSendMessage(const OutputMessage_ptr &msg) {
 			}
 		}
 	}
+
+	bytesSent.fetch_add(msg->getLength(), std::memory_order_relaxed);
+	packetsSent.fetch_add(1, std::memory_order_relaxed);
 }
 
 bool Protocol::sendRecvMessageCallback(NetworkMessage &msg) {
@@ -44,11 +48,28 @@ bool Protocol::sendRecvMessageCallback(NetworkMessage &msg) {
 		return false;
 	}
 
+	const auto group = getSupersedeGroup(msg);
+	uint32_t sequence = 0;
+	if (group >= 0 && static_cast<size_t>(group) < MAX_SUPERSEDE_GROUPS) {
+		// Never 0, which marks the packets outside of a group
+		if (++supersedeSequence == 0) {
+			supersedeSequence = 1;
+		}
+		sequence = supersedeSequence;
+		lastSupersedeSequence[group].store(sequence, std::memory_order_relaxed);
+	}
+
+	// The connection does not reuse the buffer before resumeWork, it reads the next packets into other ones meanwhile
 	g_dispatcher().addEvent(
-		[&msg, protocolWeak = std::weak_ptr<Protocol>(shared_from_this())]() {
+		[&msg, group, sequence, protocolWeak = std::weak_ptr<Protocol>(shared_from_this())]() {
 			if (auto protocol = protocolWeak.lock()) {
 				if (auto protocolConnection = protocol->getConnection()) {
-					protocol->parsePacket(msg);
+					if (sequence != 0 && protocol->lastSupersedeSequence[group].load(std::memory_order_relaxed) != sequence) {
+						// A later packet of the group is queued, it replaces this one
+						g_metrics().addCounter("dispatcher_packet_superseded", 1);
+					} else {
+						protocol->parsePacket(msg);
+					}
 					protocolConnection->resumeWork();
 				}
 			}
@@ -60,6 +81,9 @@ bool Protocol::sendRecvMessageCallback(NetworkMessage &msg) {
 }
 
 bool Protocol::onRecvMessage(NetworkMessage &msg) {
+	bytesReceived.fetch_add(msg.getLength(), std::memory_order_relaxed);
+	packetsReceived.fetch_add(1, std::memory_order_relaxed);
+
 	if (checksumMethod != CHECKSUM_METHOD_NONE) {
 		uint32_t recvChecksum = msg.get<uint32_t>();
 		if (checksumMethod == CHECKSUM_METHOD_SEQUENCE) {
@@ -100,46 +124,65 @@ bool Protocol::onRecvMessage(NetworkMessage &msg) {
 
 OutputMessage_ptr Protocol::getOutputBuffer(int32_t size) {
 	// dispatcher thread
+	int32_t flushSize = g_configManager().getNumber(AUTOSEND_FLUSH_SIZE, __FUNCTION__);
+	if (flushSize <= 0 || flushSize > MAX_PROTOCOL_BODY_LENGTH) {
+		flushSize = MAX_PROTOCOL_BODY_LENGTH;
+	}
+
 	if (!outputBuffer) {
 		outputBuffer = OutputMessagePool::getOutputMessage();
-	} else if ((outputBuffer->getLength() + size) > MAX_PROTOCOL_BODY_LENGTH) {
+		OutputMessagePool::getInstance().markProtocolBuffered(shared_from_this());
+	} else if ((outputBuffer->getLength() + size) > flushSize) {
+		// Already queued for autosend, the new buffer is sent on that tick
 		send(outputBuffer);
 		outputBuffer = OutputMessagePool::getOutputMessage();
 	}
 	return outputBuffer;
 }
 
-void Protocol::XTEA_encrypt(OutputMessage &msg) const {
-	const uint32_t delta = 0x61C88647;
+OutputMessage_ptr Protocol::getBulkOutputBuffer(int32_t size) {
+	// dispatcher thread
+	if (bulkBuffers.empty() || (bulkBuffers.back()->getLength() + size) > MAX_PROTOCOL_BODY_LENGTH) {
+		bulkBuffers.emplace_back(OutputMessagePool::getOutputMessage());
+	}
+
+	OutputMessagePool::getInstance().markProtocolBuffered(shared_from_this());
+	return bulkBuffers.back();
+}
+
+bool Protocol::sendBulkBuffers() {
+	// dispatcher thread
+	const auto connection = getConnection();
+	if (!connection) {
+		bulkBuffers.clear();
+		return false;
+	}
+
+	// Held back while the dispatcher is over its latency target, they are sent once it recovers
+	if (g_dispatcher().getTickGovernor().isActive(TickGovernor::Degradation::LowPriorityPackets)) {
+		return !bulkBuffers.empty();
+	}
+
+	while (!bulkBuffers.empty() && connection->getQueuedMessages() < BULK_MAX_QUEUED_MESSAGES) {
+		connection->send(bulkBuffers.front());
+		bulkBuffers.pop_front();
+	}
+
+	if (!bulkBuffers.empty()) {
+		g_metrics().addCounter("network_bulk_deferred", 1);
+		return true;
+	}
+	return false;
+}
 
+void Protocol::XTEA_encrypt(OutputMessage &msg) const {
 	// The message must be a multiple of 8
 	size_t paddingBytes = msg.getLength() & 7;
 	if (paddingBytes != 0) {
 		msg.addPaddingBytes(8 - paddingBytes);
 	}
 
-	uint8_t* buffer = msg.getOutputBuffer();
-	auto messageLength = static_cast<int32_t>(msg.getLength());
-	int32_t readPos = 0;
-	const std::array<uint32_t, 4> newKey = { key[0], key[1], key[2], key[3] };
-	// TODO: refactor this for not use c-style
-	uint32_t precachedControlSum[32][2];
-	uint32_t sum = 0;
-	for (int32_t i = 0; i < 32; ++i) {
-		precachedControlSum[i][0] = (sum + newKey[sum & 3]);
-		sum -= delta;
-		precachedControlSum[i][1] = (sum + newKey[(sum >> 11) & 3]);
-	}
-	while (readPos < messageLength) {
-		std::array<uint32_t, 2> vData = {};
-		memcpy(vData.data(), buffer + readPos, 8);
-		for (int32_t i = 0; i < 32; ++i) {
-			vData[0] += ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ precachedControlSum[i][0];
-			vData[1] += ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ precachedControlSum[i][1];
-		}
-		memcpy(buffer + readPos, vData.data(), 8);
-		readPos += 8;
-	}
+	xtea::encrypt(msg.getOutputBuffer(), msg.getLength(), encryptKeys);
 }
 
 bool Protocol::XTEA_decrypt(NetworkMessage &msg) const {
@@ -148,30 +191,7 @@ bool Protocol::XTEA_decrypt(NetworkMessage &msg) const {
 		return false;
 	}
 
-	const uint32_t delta = 0x61C88647;
-
-	uint8_t* buffer = msg.getBuffer() + msg.getBufferPosition();
-	auto messageLength = static_cast<int32_t>(msgLength);
-	int32_t readPos = 0;
-	const std::array<uint32_t, 4> newKey = { key[0], key[1], key[2], key[3] };
-	// TODO: refactor this for not use c-style
-	uint32_t precachedControlSum[32][2];
-	uint32_t sum = 0xC6EF3720;
-	for (int32_t i = 0; i < 32; ++i) {
-		precachedControlSum[i][0] = (sum + newKey[(sum >> 11) & 3]);
-		sum += delta;
-		precachedControlSum[i][1] = (sum + newKey[sum & 3]);
-	}
-	while (readPos < messageLength) {
-		std::array<uint32_t, 2> vData = {};
-		memcpy(vData.data(), buffer + readPos, 8);
-		for (int32_t i = 0; i < 32; ++i) {
-			vData[1] -= ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ precachedControlSum[i][0];
-			vData[0] -= ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ precachedControlSum[i][1];
-		}
-		memcpy(buffer + readPos, vData.data(), 8);
-		readPos += 8;
-	}
+	xtea::decrypt(msg.getBuffer() + msg.getBufferPosition(), msgLength, decryptKeys);
 
 	uint16_t innerLength = msg.get<uint16_t>();
 	if (std::cmp_greater(innerLength, msgLength - 2)) {
@@ -201,39 +221,73 @@ uint32_t Protocol::getIP() const {
 	return 0;
 }
 
-bool Protocol::compression(OutputMessage &msg) const {
+bool Protocol::compression(OutputMessage &msg) {
 	if (checksumMethod != CHECKSUM_METHOD_SEQUENCE) {
 		return false;
 	}
 
-	static const thread_local auto &compress = std::make_unique<ZStream>();
-	if (!compress->stream) {
+	const auto outputMessageSize = msg.getLength();
+	if (std::cmp_less(outputMessageSize, g_configManager().getNumber(COMPRESSION_MIN_SIZE, __FUNCTION__))) {
+		return false;
+	}
+
+	if (compressionSkip > 0) {
+		--compressionSkip;
 		return false;
 	}
 
-	const auto outputMessageSize = msg.getLength();
 	if (outputMessageSize > NETWORKMESSAGE_MAXSIZE) {
 		g_logger().error("[NetworkMessage::compression] - Exceded NetworkMessage max size: {}, actually size: {}", NETWORKMESSAGE_MAXSIZE, outputMessageSize);
 		return false;
 	}
 
+	metrics::method_latency measure(__METHOD_NAME__);
+	// A streaming context keeps its history, so every packet it deflates must be sent compressed
+	const bool streaming = g_configManager().getBoolean(COMPRESSION_STREAMING, __FUNCTION__);
+	static const thread_local auto &threadCompress = std::make_unique<ZStream>();
+	if (streaming && !compressionStream) {
+		compressionStream = std::make_unique<ZStream>();
+	}
+
+	const auto &compress = streaming ? compressionStream : threadCompress;
+	if (!compress->stream) {
+		return false;
+	}
+
 	compress->stream->next_in = msg.getOutputBuffer();
 	compress->stream->avail_in = outputMessageSize;
 	compress->stream->next_out = reinterpret_cast<Bytef*>(compress->buffer.data());
 	compress->stream->avail_out = NETWORKMESSAGE_MAXSIZE;
 
-	const int32_t ret = deflate(compress->stream.get(), Z_FINISH);
-	if (ret != Z_OK && ret != Z_STREAM_END) {
+	const int32_t ret = deflate(compress->stream.get(), streaming ? Z_SYNC_FLUSH : Z_FINISH);
+	if ((ret != Z_OK && ret != Z_STREAM_END) || compress->stream->avail_out == 0) {
+		// A fresh context never refers to data the client has not seen
+		deflateReset(compress->stream.get());
 		return false;
 	}
 
-	const auto totalSize = compress->stream->total_out;
-	deflateReset(compress->stream.get());
+	const auto totalSize = NETWORKMESSAGE_MAXSIZE - compress->stream->avail_out;
+	if (!streaming) {
+		deflateReset(compress->stream.get());
+	}
+
+	g_metrics().addCounter("network_compression_bytes_in", outputMessageSize);
+	g_metrics().addCounter("network_compression_bytes_out", totalSize);
+
+	// Data that does not compress well (already packed, or too small) is not worth the CPU for a while
+	if (totalSize * 100 > outputMessageSize * static_cast<uint32_t>(g_configManager().getNumber(COMPRESSION_MAX_RATIO, __FUNCTION__))) {
+		compressionSkip = compressionBackoff;
+		compressionBackoff = std::min<uint32_t>(compressionBackoff * 2, 64);
+	} else {
+		compressionBackoff = 1;
+	}
 
-	if (totalSize == 0) {
+	if (totalSize == 0 || (!streaming && totalSize >= outputMessageSize)) {
 		return false;
 	}
 
+	// A streaming context can grow a packet it could not compress
+	compressionSaved.fetch_add(static_cast<int64_t>(outputMessageSize) - static_cast<int64_t>(totalSize), std::memory_order_relaxed);
 	msg.reset();
 	msg.addBytes(compress->buffer.data(), totalSize);
 
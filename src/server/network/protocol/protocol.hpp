@@ -11,6 +11,7 @@
 
 #include "server/network/connection/connection.hpp"
 #include "config/configmanager.hpp"
+#include "security/xtea.hpp"
 
 class Protocol : public std::enable_shared_from_this<Protocol> {
 public:
@@ -48,6 +49,38 @@ public:
 		return outputBuffer;
 	}
 
+	/**
+	 * @brief Same as getOutputBuffer, for low priority messages.
+	 * They are sent after the regular buffer and only while the connection
+	 * has almost nothing queued, so they never delay movement or combat updates.
+	 */
+	OutputMessage_ptr getBulkOutputBuffer(int32_t size);
+
+	/**
+	 * @brief Sends the bulk buffers the connection has room for.
+	 * @return true when some of them are still waiting.
+	 */
+	bool sendBulkBuffers();
+
+	struct TrafficStats {
+		uint64_t bytesReceived = 0;
+		uint64_t bytesSent = 0;
+		uint64_t packetsReceived = 0;
+		uint64_t packetsSent = 0;
+		// Bytes that compression took off the sent packets
+		int64_t compressionSaved = 0;
+	};
+
+	TrafficStats getTrafficStats() const {
+		return {
+			bytesReceived.load(std::memory_order_relaxed),
+			bytesSent.load(std::memory_order_relaxed),
+			packetsReceived.load(std::memory_order_relaxed),
+			packetsSent.load(std::memory_order_relaxed),
+			compressionSaved.load(std::memory_order_relaxed),
+		};
+	}
+
 	void send(OutputMessage_ptr msg) const {
 		if (auto connection = getConnection();
 		    connection != nullptr) {
@@ -66,7 +99,10 @@ protected:
 		encryptionEnabled = true;
 	}
 	void setXTEAKey(const uint32_t* newKey) {
-		memcpy(this->key.data(), newKey, sizeof(*newKey) * 4);
+		xtea::key_type key;
+		memcpy(key.data(), newKey, sizeof(*newKey) * 4);
+		encryptKeys = xtea::expandEncryptKeys(key);
+		decryptKeys = xtea::expandDecryptKeys(key);
 	}
 	void setChecksumMethod(ChecksumMethods_t method) {
 		checksumMethod = method;
@@ -80,6 +116,17 @@ protected:
 
 	virtual void release() { }
 
+	/**
+	 * @brief Group of a packet that replaces the packets of the same group still waiting on the dispatcher, or -1.
+	 * Only for packets whose effect a later one of the group undoes, like a new walk path or turn.
+	 * @param msg The decrypted packet, read from its first byte.
+	 */
+	virtual int8_t getSupersedeGroup(const NetworkMessage &) const {
+		return -1;
+	}
+
+	static constexpr size_t MAX_SUPERSEDE_GROUPS = 4;
+
 private:
 	struct ZStream {
 		ZStream() noexcept {
@@ -109,17 +156,40 @@ private:
 
 	void XTEA_encrypt(OutputMessage &msg) const;
 	bool XTEA_decrypt(NetworkMessage &msg) const;
-	bool compression(OutputMessage &msg) const;
+	bool compression(OutputMessage &msg);
 
 	OutputMessage_ptr outputBuffer;
+	std::deque<OutputMessage_ptr> bulkBuffers;
+
+	// Bulk buffers are held back while the connection has this many messages waiting to be written
+	static constexpr size_t BULK_MAX_QUEUED_MESSAGES = 2;
 
 	const ConnectionWeak_ptr connectionPtr;
-	std::array<uint32_t, 4> key = {};
+	xtea::round_keys encryptKeys = {};
+	xtea::round_keys decryptKeys = {};
 	uint32_t serverSequenceNumber = 0;
 	uint32_t clientSequenceNumber = 0;
+	// Packets of a supersede group, numbered by the connection thread; a queued one runs only while it is still the last of its group
+	uint32_t supersedeSequence = 0;
+	std::array<std::atomic<uint32_t>, MAX_SUPERSEDE_GROUPS> lastSupersedeSequence {};
+	// Per connection deflate context, only with streaming compression
+	std::unique_ptr<ZStream> compressionStream;
+	// Packets still sent raw after a poor ratio, and the length of the next back-off
+	uint32_t compressionSkip = 0;
+	uint32_t compressionBackoff = 1;
+	// Counted by the connection threads, read by the dispatcher
+	std::atomic<uint64_t> bytesReceived = 0;
+	std::atomic<uint64_t> bytesSent = 0;
+	std::atomic<uint64_t> packetsReceived = 0;
+	std::atomic<uint64_t> packetsSent = 0;
+	std::atomic<int64_t> compressionSaved = 0;
 	std::underlying_type_t<ChecksumMethods_t> checksumMethod = CHECKSUM_METHOD_NONE;
 	bool encryptionEnabled = false;
 	bool rawMessages = false;
+	// Owned by OutputMessagePool, on the dispatcher thread
+	bool autosend = false;
+	bool autosendQueued = false;
 
 	friend class Connection;
+	friend class OutputMessagePool;
 };
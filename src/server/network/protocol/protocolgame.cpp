@@ -11,6 +11,7 @@
 
 #include "creatures/players/management/ban.hpp"
 #include "core.hpp"
+#include "database/databasetasks.hpp"
 #include "declarations.hpp"
 #include "game/game.hpp"
 #include "creatures/players/imbuements/imbuements.hpp"
@@ -18,6 +19,7 @@
 #include "io/iobestiary.hpp"
 #include "io/io_bosstiary.hpp"
 #include "io/iologindata.hpp"
+#include "lib/thread/thread_pool.hpp"
 #include "io/iomarket.hpp"
 #include "lua/modules/modules.hpp"
 #include "creatures/monsters/monster.hpp"
@@ -53,6 +55,17 @@
 // This "getIteration" function will allow us to get the total number of iterations that run within a specific map
 // Very useful to send the total amount in certain bytes in the ProtocolGame class
 namespace {
+	// Bytes of the creature free tiles described by the current task, a mass teleport encodes them once
+	struct TileDescriptionEntry {
+		const Tile* tile = nullptr;
+		uint64_t cycle = std::numeric_limits<uint64_t>::max();
+		uint32_t version = 0;
+		bool oldProtocol = false;
+		uint8_t length = 0;
+		std::array<uint8_t, 64> bytes {};
+	};
+	std::array<TileDescriptionEntry, 4096> tileDescriptions;
+
 	template <typename T>
 	uint16_t getIterationIncreaseCount(T &map) {
 		uint16_t totalIterationCount = 0;
@@ -252,12 +265,33 @@ ProtocolGame::ProtocolGame(Connection_ptr initConnection) :
 	version = CLIENT_VERSION;
 }
 
+const ProtocolGame::Encoders ProtocolGame::currentEncoders {
+	&ProtocolGame::addItemBytes<ProtocolVariant::Current>,
+	&ProtocolGame::addItemBytes<ProtocolVariant::Current>,
+	&ProtocolGame::addTileDescriptionBytes<ProtocolVariant::Current>
+};
+
+const ProtocolGame::Encoders ProtocolGame::oldEncoders {
+	&ProtocolGame::addItemBytes<ProtocolVariant::Old>,
+	&ProtocolGame::addItemBytes<ProtocolVariant::Old>,
+	&ProtocolGame::addTileDescriptionBytes<ProtocolVariant::Old>
+};
+
 void ProtocolGame::AddItem(NetworkMessage &msg, uint16_t id, uint8_t count, uint8_t tier) {
+	(this->*encoders->addItemById)(msg, id, count, tier);
+}
+
+void ProtocolGame::AddItem(NetworkMessage &msg, std::shared_ptr<Item> item) {
+	(this->*encoders->addItem)(msg, item);
+}
+
+template <ProtocolGame::ProtocolVariant Variant>
+void ProtocolGame::addItemBytes(NetworkMessage &msg, uint16_t id, uint8_t count, uint8_t tier) {
 	const ItemType &it = Item::items[id];
 
 	msg.add<uint16_t>(it.id);
 
-	if (oldProtocol) {
+	if constexpr (Variant == ProtocolVariant::Old) {
 		msg.addByte(0xFF);
 	}
 
@@ -269,7 +303,7 @@ void ProtocolGame::AddItem(NetworkMessage &msg, uint16_t id, uint8_t count, uint
 		msg.addByte(count);
 	}
 
-	if (oldProtocol) {
+	if constexpr (Variant == ProtocolVariant::Old) {
 		if (it.animationType == ANIMATION_RANDOM) {
 			msg.addByte(0xFE);
 		} else if (it.animationType == ANIMATION_DESYNC) {
@@ -306,12 +340,13 @@ void ProtocolGame::AddItem(NetworkMessage &msg, uint16_t id, uint8_t count, uint
 		msg.addByte(0x01); // Brand-new
 	}
 
-	if (it.isWrapKit && !oldProtocol) {
+	if (it.isWrapKit) {
 		msg.add<uint16_t>(0x00);
 	}
 }
 
-void ProtocolGame::AddItem(NetworkMessage &msg, std::shared_ptr<Item> item) {
+template <ProtocolGame::ProtocolVariant Variant>
+void ProtocolGame::addItemBytes(NetworkMessage &msg, const std::shared_ptr<Item> &item) {
 	if (!item) {
 		return;
 	}
@@ -320,7 +355,7 @@ void ProtocolGame::AddItem(NetworkMessage &msg, std::shared_ptr<Item> item) {
 
 	msg.add<uint16_t>(it.id);
 
-	if (oldProtocol) {
+	if constexpr (Variant == ProtocolVariant::Old) {
 		msg.addByte(0xFF);
 	}
 
@@ -332,7 +367,7 @@ void ProtocolGame::AddItem(NetworkMessage &msg, std::shared_ptr<Item> item) {
 		msg.addByte(item->getAttribute<uint8_t>(ItemAttribute_t::FLUIDTYPE));
 	}
 
-	if (oldProtocol) {
+	if constexpr (Variant == ProtocolVariant::Old) {
 		if (it.animationType == ANIMATION_RANDOM) {
 			msg.addByte(0xFE);
 		} else if (it.animationType == ANIMATION_DESYNC) {
@@ -445,7 +480,7 @@ void ProtocolGame::AddItem(NetworkMessage &msg, std::shared_ptr<Item> item) {
 		}
 	}
 
-	if (it.isWrapKit && !oldProtocol) {
+	if (it.isWrapKit) {
 		uint16_t unWrapId = item->getCustomAttribute("unWrapId") ? static_cast<uint16_t>(item->getCustomAttribute("unWrapId")->getInteger()) : 0;
 		if (unWrapId != 0) {
 			msg.add<uint16_t>(unWrapId);
@@ -463,6 +498,7 @@ void ProtocolGame::release() {
 	}
 
 	OutputMessagePool::getInstance().removeProtocolFromAutosend(shared_from_this());
+	packetCapture.reset();
 	Protocol::release();
 }
 
@@ -576,44 +612,27 @@ void ProtocolGame::login(const std::string &name, uint32_t accountId, OperatingS
 			return;
 		}
 
-		if (!IOLoginData::loadPlayerById(player, player->getGUID(), false)) {
-			g_game().removePlayerUniqueLogin(player);
-			disconnectClient("Your character could not be loaded.");
-			g_logger().warn("Player {} could not be loaded", player->getName());
+		if (!g_configManager().getBoolean(PREFETCH_LOGIN_QUERIES, __FUNCTION__)) {
+			DBResultPrefetch prefetch;
+			enterGame(player, operatingSystem, prefetch);
 			return;
 		}
 
-		player->setOperatingSystem(operatingSystem);
-
-		const auto tile = g_game().map.getOrCreateTile(player->getLoginPosition());
-		// moving from a pz tile to a non-pz tile
-		if (maxOnline > 1 && player->getAccountType() < ACCOUNT_TYPE_GAMEMASTER && !tile->hasFlag(TILESTATE_PROTECTIONZONE)) {
-			auto maxOutsizePZ = g_configManager().getNumber(MAX_PLAYERS_OUTSIDE_PZ_PER_ACCOUNT, __FUNCTION__);
-			auto accountPlayers = g_game().getPlayersByAccount(player->getAccount());
-			int countOutsizePZ = 0;
-			for (const auto &accountPlayer : accountPlayers) {
-				if (accountPlayer != player && accountPlayer->getTile() && !accountPlayer->getTile()->hasFlag(TILESTATE_PROTECTIONZONE)) {
-					++countOutsizePZ;
-				}
-			}
-			if (countOutsizePZ >= maxOutsizePZ) {
-				g_game().removePlayerUniqueLogin(player);
-				disconnectClient(fmt::format("You can only have {} character{} from your account outside of a protection zone.", maxOutsizePZ == 1 ? "one" : std::to_string(maxOutsizePZ), maxOutsizePZ > 1 ? "s" : ""));
-				return;
+		// The reads run on the database connections meanwhile, the dispatcher only builds the player
+		g_databaseTasks().prefetch(
+			IOLoginData::getLoadQueries(player->getGUID(), player->getAccountId()),
+			[self = getThis(), loadingPlayer = player, operatingSystem](const std::shared_ptr<DBResultPrefetch> &prefetch) {
+				self->enterGame(loadingPlayer, operatingSystem, *prefetch);
 			}
-		}
-
-		if (!g_game().placeCreature(player, player->getLoginPosition()) && !g_game().placeCreature(player, player->getTemplePosition(), false, true)) {
-			g_game().removePlayerUniqueLogin(player);
-			disconnectClient("Temple position is wrong. Please, contact the administrator.");
-			g_logger().warn("Player {} temple position is wrong", player->getName());
+		);
+		return;
+	} else {
+		if (!foundPlayer->getTile()) {
+			// Still waiting for its load, there is no character to take over yet
+			disconnectClient("Your character is still being loaded.\nPlease try again.");
 			return;
 		}
 
-		player->lastIP = player->getIP();
-		player->lastLoginSaved = std::max<time_t>(time(nullptr), player->lastLoginSaved + 1);
-		acceptPackets = true;
-	} else {
 		if (eventConnect != 0 || !g_configManager().getBoolean(REPLACE_KICK_ON_LOGIN, __FUNCTION__)) {
 			// Already trying to connect
 			disconnectClient("You are already logged in.");
@@ -636,6 +655,63 @@ void ProtocolGame::login(const std::string &name, uint32_t accountId, OperatingS
 	sendBosstiaryCooldownTimer();
 }
 
+void ProtocolGame::enterGame(const std::shared_ptr<Player> &loadingPlayer, OperatingSystem_t operatingSystem, DBResultPrefetch &prefetch) {
+	if (isConnectionExpired()) {
+		// The client left while the load was in flight
+		g_game().removePlayerUniqueLogin(loadingPlayer);
+		return;
+	}
+
+	player = loadingPlayer;
+	bool loaded;
+	{
+		DBResultPrefetch::Use use(prefetch);
+		loaded = IOLoginData::loadPlayerById(player, player->getGUID(), false);
+	}
+
+	if (!loaded) {
+		g_game().removePlayerUniqueLogin(player);
+		disconnectClient("Your character could not be loaded.");
+		g_logger().warn("Player {} could not be loaded", player->getName());
+		return;
+	}
+
+	player->setOperatingSystem(operatingSystem);
+
+	const auto maxOnline = g_configManager().getNumber(MAX_PLAYERS_PER_ACCOUNT, __FUNCTION__);
+	const auto tile = g_game().map.getOrCreateTile(player->getLoginPosition());
+	// moving from a pz tile to a non-pz tile
+	if (maxOnline > 1 && player->getAccountType() < ACCOUNT_TYPE_GAMEMASTER && !tile->hasFlag(TILESTATE_PROTECTIONZONE)) {
+		auto maxOutsizePZ = g_configManager().getNumber(MAX_PLAYERS_OUTSIDE_PZ_PER_ACCOUNT, __FUNCTION__);
+		auto accountPlayers = g_game().getPlayersByAccount(player->getAccount());
+		int countOutsizePZ = 0;
+		for (const auto &accountPlayer : accountPlayers) {
+			if (accountPlayer != player && accountPlayer->getTile() && !accountPlayer->getTile()->hasFlag(TILESTATE_PROTECTIONZONE)) {
+				++countOutsizePZ;
+			}
+		}
+		if (countOutsizePZ >= maxOutsizePZ) {
+			g_game().removePlayerUniqueLogin(player);
+			disconnectClient(fmt::format("You can only have {} character{} from your account outside of a protection zone.", maxOutsizePZ == 1 ? "one" : std::to_string(maxOutsizePZ), maxOutsizePZ > 1 ? "s" : ""));
+			return;
+		}
+	}
+
+	if (!g_game().placeCreature(player, player->getLoginPosition()) && !g_game().placeCreature(player, player->getTemplePosition(), false, true)) {
+		g_game().removePlayerUniqueLogin(player);
+		disconnectClient("Temple position is wrong. Please, contact the administrator.");
+		g_logger().warn("Player {} temple position is wrong", player->getName());
+		return;
+	}
+
+	player->lastIP = player->getIP();
+	player->lastLoginSaved = std::max<time_t>(time(nullptr), player->lastLoginSaved + 1);
+	acceptPackets = true;
+	startPacketCapture();
+	OutputMessagePool::getInstance().addProtocolToAutosend(shared_from_this());
+	sendBosstiaryCooldownTimer();
+}
+
 void ProtocolGame::connect(const std::string &playerName, OperatingSystem_t operatingSystem) {
 	eventConnect = 0;
 
@@ -666,6 +742,13 @@ void ProtocolGame::connect(const std::string &playerName, OperatingSystem_t oper
 	player->lastLoginSaved = std::max<time_t>(time(nullptr), player->lastLoginSaved + 1);
 	player->resetIdleTime();
 	acceptPackets = true;
+	startPacketCapture();
+}
+
+void ProtocolGame::startPacketCapture() {
+	if (!packetCapture && g_configManager().getBoolean(PACKET_CAPTURE, __FUNCTION__)) {
+		packetCapture = PacketCapture::open(player->getName(), version);
+	}
 }
 
 void ProtocolGame::logout(bool displayEffect, bool forced) {
@@ -707,12 +790,19 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
 		return;
 	}
 
+	// Refused before the RSA decrypt, the cheapest point to drop a login flood
+	if (!inject<Ban>().acceptLogin(getIP())) {
+		disconnect();
+		return;
+	}
+
 	OperatingSystem_t operatingSystem = static_cast<OperatingSystem_t>(msg.get<uint16_t>());
 	version = msg.get<uint16_t>(); // Protocol version
 	g_logger().trace("Protocol version: {}", version);
 
 	// Old protocol support
 	oldProtocol = g_configManager().getBoolean(OLD_PROTOCOL, __FUNCTION__) && version <= 1100;
+	encoders = oldProtocol ? &oldEncoders : &currentEncoders;
 
 	if (oldProtocol) {
 		setChecksumMethod(CHECKSUM_METHOD_ADLER32);
@@ -723,10 +813,10 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
 	clientVersion = static_cast<int32_t>(msg.get<uint32_t>());
 
 	if (!oldProtocol) {
-		auto clientVersionString = msg.getString(); // Client version (String)
+		auto clientVersionString = msg.getStringView(); // Client version (String)
 		g_logger().trace("Client version: {}", clientVersionString);
 		if (version >= 1334) {
-			auto assetHashIdentifier = msg.getString(); // Assets hash identifier
+			auto assetHashIdentifier = msg.getStringView(); // Assets hash identifier
 			g_logger().trace("Client asset hash identifier: {}", assetHashIdentifier);
 		}
 	}
@@ -777,8 +867,8 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
 
 	if (!oldProtocol && operatingSystem == CLIENTOS_NEW_LINUX) {
 		// TODO: check what new info for linux is send
-		msg.getString();
-		msg.getString();
+		msg.getStringView();
+		msg.getStringView();
 	}
 
 	std::string characterName = msg.getString();
@@ -827,39 +917,42 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
 		return;
 	}
 
-	BanInfo banInfo;
-	if (IOBan::isIpBanned(getIP(), banInfo)) {
-		if (banInfo.reason.empty()) {
-			banInfo.reason = "(none)";
+	// The ban lookup, the account queries and the password hash run on the thread pool, off the network threads and the dispatcher
+	inject<ThreadPool>().detach_task([self = getThis(), accountDescriptor, password, characterName, operatingSystem, authType] {
+		std::ostringstream ss;
+		BanInfo banInfo;
+		if (IOBan::isIpBanned(self->getIP(), banInfo)) {
+			if (banInfo.reason.empty()) {
+				banInfo.reason = "(none)";
+			}
+
+			ss << "Your IP has been banned until " << formatDateShort(banInfo.expiresAt) << " by " << banInfo.bannedBy << ".\n\nReason specified:\n"
+			   << banInfo.reason;
+			self->disconnectClient(ss.str());
+			return;
 		}
 
-		ss.str(std::string());
-		ss << "Your IP has been banned until " << formatDateShort(banInfo.expiresAt) << " by " << banInfo.bannedBy << ".\n\nReason specified:\n"
-		   << banInfo.reason;
-		disconnectClient(ss.str());
-		return;
-	}
+		uint32_t accountId;
+		std::string name = characterName;
+		if (!IOLoginData::gameWorldAuthentication(accountDescriptor, password, name, accountId, self->oldProtocol, self->getIP())) {
+			if (authType == "session") {
+				ss << "Your session has expired. Please log in again.";
+			} else { // authType == "password"
+				ss << "Your " << (self->oldProtocol ? "username" : "email") << " or password is not correct.";
+			}
 
-	uint32_t accountId;
-	if (!IOLoginData::gameWorldAuthentication(accountDescriptor, password, characterName, accountId, oldProtocol, getIP())) {
-		ss.str(std::string());
-		if (authType == "session") {
-			ss << "Your session has expired. Please log in again.";
-		} else { // authType == "password"
-			ss << "Your " << (oldProtocol ? "username" : "email") << " or password is not correct.";
+			auto output = OutputMessagePool::getOutputMessage();
+			output->addByte(0x14);
+			output->addString(ss.str(), "ProtocolGame::onRecvFirstMessage - ss.str()");
+			self->send(output);
+			g_dispatcher().scheduleEvent(
+				1000, [self] { self->disconnect(); }, "ProtocolGame::disconnect"
+			);
+			return;
 		}
 
-		auto output = OutputMessagePool::getOutputMessage();
-		output->addByte(0x14);
-		output->addString(ss.str(), "ProtocolGame::onRecvFirstMessage - ss.str()");
-		send(output);
-		g_dispatcher().scheduleEvent(
-			1000, [self = getThis()] { self->disconnect(); }, "ProtocolGame::disconnect"
-		);
-		return;
-	}
-
-	g_dispatcher().addEvent([self = getThis(), characterName, accountId, operatingSystem] { self->login(characterName, accountId, operatingSystem); }, __FUNCTION__);
+		g_dispatcher().addEvent([self, name, accountId, operatingSystem] { self->login(name, accountId, operatingSystem); }, "ProtocolGame::onRecvFirstMessage");
+	});
 }
 
 void ProtocolGame::onConnect() {
@@ -903,12 +996,39 @@ void ProtocolGame::writeToOutputBuffer(const NetworkMessage &msg) {
 	out->append(msg);
 }
 
+void ProtocolGame::writeToBulkOutputBuffer(const NetworkMessage &msg) {
+	auto out = getBulkOutputBuffer(msg.getLength());
+	out->append(msg);
+}
+
+void ProtocolGame::writeToOutputBuffer(BroadcastMessage* broadcast, const std::function<void(NetworkMessage &)> &build) {
+	if (!broadcast) {
+		NetworkMessage msg;
+		build(msg);
+		writeToOutputBuffer(msg);
+		return;
+	}
+
+	// The builder may only depend on the client protocol
+	auto &msg = broadcast->messages[oldProtocol ? 1 : 0];
+	if (!msg) {
+		msg = std::make_unique<NetworkMessage>();
+		build(*msg);
+	}
+	writeToOutputBuffer(*msg);
+}
+
 void ProtocolGame::parsePacket(NetworkMessage &msg) {
 	if (!acceptPackets || g_game().getGameState() == GAME_STATE_SHUTDOWN || msg.getLength() <= 0) {
 		return;
 	}
 
+	if (packetCapture) {
+		packetCapture->record(msg);
+	}
+
 	uint8_t recvbyte = msg.getByte();
+	++packetsByOpcode[recvbyte];
 
 	if (!player || player->isRemoved()) {
 		if (recvbyte == 0x0F) {
@@ -933,7 +1053,53 @@ void ProtocolGame::parsePacket(NetworkMessage &msg) {
 		g_modules().executeOnRecvbyte(player->getID(), msg, recvbyte);
 	}
 
+	const auto start = std::chrono::steady_clock::now();
 	parsePacketFromDispatcher(msg, recvbyte);
+	dispatcherTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string ProtocolGame::getTrafficReport() const {
+	const auto stats = getTrafficStats();
+	std::string report = fmt::format(
+		"Received: {} packets, {:.1f} KB\nSent: {} packets, {:.1f} KB, {:.1f} KB saved by compression\nDispatcher time: {:.2f} ms\n\nPackets by opcode:",
+		stats.packetsReceived, static_cast<double>(stats.bytesReceived) / 1024.0,
+		stats.packetsSent, static_cast<double>(stats.bytesSent) / 1024.0, static_cast<double>(stats.compressionSaved) / 1024.0,
+		static_cast<double>(dispatcherTimeNs) / 1000000.0
+	);
+
+	std::vector<std::pair<uint8_t, uint32_t>> opcodes;
+	for (size_t opcode = 0; opcode < packetsByOpcode.size(); ++opcode) {
+		if (packetsByOpcode[opcode] != 0) {
+			opcodes.emplace_back(static_cast<uint8_t>(opcode), packetsByOpcode[opcode]);
+		}
+	}
+	std::ranges::sort(opcodes, [](const auto &a, const auto &b) {
+		return a.second > b.second;
+	});
+	for (const auto &[opcode, count] : opcodes) {
+		report += fmt::format("\n0x{:02X} - {}", opcode, count);
+	}
+	return report;
+}
+
+int8_t ProtocolGame::getSupersedeGroup(const NetworkMessage &msg) const {
+	if (msg.getLength() <= 0) {
+		return -1;
+	}
+
+	switch (msg.getBuffer()[msg.getBufferPosition()]) {
+		// A new path replaces the one being walked
+		case 0x64:
+			return 0;
+		// Only the last direction is seen
+		case 0x6F:
+		case 0x70:
+		case 0x71:
+		case 0x72:
+			return 1;
+		default:
+			return -1;
+	}
 }
 
 void ProtocolGame::parsePacketDead(uint8_t recvbyte) {
@@ -984,7 +1150,7 @@ void ProtocolGame::addBless() {
 	player->checkAndShowBlessingMessage();
 }
 
-void ProtocolGame::parsePacketFromDispatcher(NetworkMessage msg, uint8_t recvbyte) {
+void ProtocolGame::parsePacketFromDispatcher(NetworkMessage &msg, uint8_t recvbyte) {
 	if (!acceptPackets || g_game().getGameState() == GAME_STATE_SHUTDOWN) {
 		return;
 	}
@@ -1386,14 +1552,51 @@ void ProtocolGame::parseHotkeyEquip(NetworkMessage &msg) {
 }
 
 void ProtocolGame::GetTileDescription(std::shared_ptr<Tile> tile, NetworkMessage &msg) {
-	if (oldProtocol) {
+	// Without creatures the bytes only depend on the items, every player of a task can share them
+	const CreatureVector* creatures = tile->getCreatures();
+	if ((creatures && !creatures->empty()) || tile->getPosition() == player->getPosition() || g_dispatcher().context().isAsync()) {
+		AddTileDescription(tile, msg);
+		return;
+	}
+
+	const auto &pos = tile->getPosition();
+	auto &entry = tileDescriptions[(pos.x * 31 + pos.y * 17 + pos.z) % tileDescriptions.size()];
+	const auto cycle = g_dispatcher().getDispatcherCycle();
+	const auto version = g_game().map.getTileDescriptionVersion();
+	if (entry.tile == tile.get() && entry.cycle == cycle && entry.version == version && entry.oldProtocol == oldProtocol) {
+		msg.addBytes(reinterpret_cast<const char*>(entry.bytes.data()), entry.length);
+		return;
+	}
+
+	const auto start = msg.getBufferPosition();
+	AddTileDescription(tile, msg);
+	const auto length = msg.getBufferPosition() - start;
+	if (length > entry.bytes.size()) {
+		return;
+	}
+
+	entry.tile = tile.get();
+	entry.cycle = cycle;
+	entry.version = version;
+	entry.oldProtocol = oldProtocol;
+	entry.length = static_cast<uint8_t>(length);
+	std::memcpy(entry.bytes.data(), msg.getBuffer() + start, length);
+}
+
+void ProtocolGame::AddTileDescription(const std::shared_ptr<Tile> &tile, NetworkMessage &msg) {
+	(this->*encoders->addTileDescription)(tile, msg);
+}
+
+template <ProtocolGame::ProtocolVariant Variant>
+void ProtocolGame::addTileDescriptionBytes(const std::shared_ptr<Tile> &tile, NetworkMessage &msg) {
+	if constexpr (Variant == ProtocolVariant::Old) {
 		msg.add<uint16_t>(0x00); // Env effects
 	}
 
 	int32_t count;
 	std::shared_ptr<Item> ground = tile->getGround();
 	if (ground) {
-		AddItem(msg, ground);
+		addItemBytes<Variant>(msg, ground);
 		count = 1;
 	} else {
 		count = 0;
@@ -1402,7 +1605,7 @@ void ProtocolGame::GetTileDescription(std::shared_ptr<Tile> tile, NetworkMessage
 	const TileItemVector* items = tile->getItemList();
 	if (items) {
 		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
-			AddItem(msg, *it);
+			addItemBytes<Variant>(msg, *it);
 
 			count++;
 			if (count == 9 && tile->getPosition() == player->getPosition()) {
@@ -1443,7 +1646,7 @@ void ProtocolGame::GetTileDescription(std::shared_ptr<Tile> tile, NetworkMessage
 
 	if (items) {
 		for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
-			AddItem(msg, *it);
+			addItemBytes<Variant>(msg, *it);
 
 			if (++count == 10) {
 				return;
@@ -1500,42 +1703,22 @@ void ProtocolGame::GetFloorDescription(NetworkMessage &msg, int32_t x, int32_t y
 }
 
 void ProtocolGame::checkCreatureAsKnown(uint32_t id, bool &known, uint32_t &removedKnown) {
-	if (auto [creatureKnown, creatureInserted] = knownCreatureSet.insert(id);
-	    !creatureInserted) {
+	if (!knownCreatureSet.insert(id)) {
 		known = true;
 		return;
 	}
 	known = false;
-	if (knownCreatureSet.size() > 1300) {
-		// Look for a creature to remove
-		for (auto it = knownCreatureSet.begin(), end = knownCreatureSet.end(); it != end; ++it) {
-			if (*it == id) {
-				continue;
-			}
+	if (knownCreatureSet.size() > KnownCreatureSet::CLIENT_LIMIT) {
+		// Look for a creature to remove, or just anyone in a bad situation
+		removedKnown = knownCreatureSet.evict(id, [this](uint32_t knownId) {
+			std::shared_ptr<Creature> creature = g_game().getCreatureByID(knownId);
 			// We need to protect party players from removing
-			std::shared_ptr<Creature> creature = g_game().getCreatureByID(*it);
 			if (std::shared_ptr<Player> checkPlayer;
 			    creature && (checkPlayer = creature->getPlayer()) != nullptr) {
-				if (player->getParty() != checkPlayer->getParty() && !canSee(creature)) {
-					removedKnown = *it;
-					knownCreatureSet.erase(it);
-					return;
-				}
-			} else if (!canSee(creature)) {
-				removedKnown = *it;
-				knownCreatureSet.erase(it);
-				return;
+				return player->getParty() != checkPlayer->getParty() && !canSee(creature);
 			}
-		}
-
-		// Bad situation. Let's just remove anyone.
-		auto it = knownCreatureSet.begin();
-		if (*it == id) {
-			++it;
-		}
-
-		removedKnown = *it;
-		knownCreatureSet.erase(it);
+			return !canSee(creature);
+		});
 	} else {
 		removedKnown = 0;
 	}
@@ -2112,7 +2295,12 @@ void ProtocolGame::sendItemInspection(uint16_t itemId, uint8_t itemCount, std::s
 	}
 	msg.addByte(0);
 
-	auto descriptions = Item::getDescriptions(it, item);
+	// Without an item the lines only depend on the type, built once
+	std::vector<std::pair<std::string, std::string>> itemDescriptions;
+	if (item) {
+		itemDescriptions = Item::getDescriptions(it, item);
+	}
+	const auto &descriptions = item ? itemDescriptions : Item::items.getTypeDescriptions(it);
 	msg.addByte(descriptions.size());
 	for (const auto &description : descriptions) {
 		msg.addString(description.first, "ProtocolGame::sendItemInspection - description.first");
@@ -2193,7 +2381,7 @@ void ProtocolGame::sendHighscoresNoData() {
 	NetworkMessage msg;
 	msg.addByte(0xB1);
 	msg.addByte(0x01); // No data available
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendHighscores(const std::vector<HighscoreCharacter> &characters, uint8_t categoryId, uint32_t vocationId, uint16_t page, uint16_t pages, uint32_t updateTimer) {
@@ -2270,7 +2458,7 @@ void ProtocolGame::sendHighscores(const std::vector<HighscoreCharacter> &charact
 	msg.add<uint32_t>(updateTimer); // Last Update
 	msg.setBufferPosition(vocationPosition);
 	msg.addByte(vocations);
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::parseConfigureShowOffSocket(NetworkMessage &msg) {
@@ -2308,26 +2496,14 @@ void ProtocolGame::parseBestiarysendRaces() {
 	NetworkMessage msg;
 	msg.addByte(0xd5);
 	msg.add<uint16_t>(BESTY_RACE_LAST);
-	std::map<uint16_t, std::string> mtype_list = g_game().getBestiaryList();
+	const auto &bestiaryIndex = g_iobestiary().getBestiaryIndex();
+	const auto &progress = g_iobestiary().getBestiaryProgress(player);
 	for (uint8_t i = BESTY_RACE_FIRST; i <= BESTY_RACE_LAST; i++) {
-		std::string BestClass = "";
-		uint16_t count = 0;
-		for (const auto &rit : mtype_list) {
-			const auto mtype = g_monsters().getMonsterType(rit.second);
-			if (!mtype) {
-				return;
-			}
-			if (mtype->info.bestiaryRace == static_cast<BestiaryType_t>(i)) {
-				count += 1;
-				BestClass = mtype->info.bestiaryClass;
-			}
-		}
-		msg.addString(BestClass, "ProtocolGame::parseBestiarysendRaces - BestClass");
-		msg.add<uint16_t>(count);
-		uint16_t unlockedCount = g_iobestiary().getBestiaryRaceUnlocked(player, static_cast<BestiaryType_t>(i));
-		msg.add<uint16_t>(unlockedCount);
+		msg.addString(bestiaryIndex.classNames[i], "ProtocolGame::parseBestiarysendRaces - BestClass");
+		msg.add<uint16_t>(bestiaryIndex.byRace[i].size());
+		msg.add<uint16_t>(progress.unlocked[i]);
 	}
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 
 	player->BestiarysendCharms();
 }
@@ -2467,7 +2643,7 @@ void ProtocolGame::parseBestiarysendMonsterData(NetworkMessage &msg) {
 		}
 	}
 
-	writeToOutputBuffer(newmsg);
+	writeToBulkOutputBuffer(newmsg);
 }
 
 void ProtocolGame::parseCyclopediaMonsterTracker(NetworkMessage &msg) {
@@ -2947,7 +3123,7 @@ void ProtocolGame::BestiarysendCharms() {
 		msg.add<uint16_t>(raceid_tmp);
 	}
 
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::parseBestiarysendCreatures(NetworkMessage &msg) {
@@ -2962,7 +3138,7 @@ void ProtocolGame::parseBestiarysendCreatures(NetworkMessage &msg) {
 
 	if (search == 1) {
 		uint16_t monsterAmount = msg.get<uint16_t>();
-		std::map<uint16_t, std::string> mtype_list = g_game().getBestiaryList();
+		const auto &mtype_list = g_game().getBestiaryList();
 		for (uint16_t monsterCount = 1; monsterCount <= monsterAmount; monsterCount++) {
 			uint16_t raceid = msg.get<uint16_t>();
 			if (player->getBestiaryKillCount(raceid) > 0) {
@@ -2988,7 +3164,6 @@ void ProtocolGame::parseBestiarysendCreatures(NetworkMessage &msg) {
 	newmsg.addByte(0xd6);
 	newmsg.addString(text, "ProtocolGame::parseBestiarysendCreatures - text");
 	newmsg.add<uint16_t>(race.size());
-	std::map<uint16_t, uint32_t> creaturesKilled = g_iobestiary().getBestiaryKillCountByMonsterIDs(player, race);
 
 	for (const auto &it_ : race) {
 		uint16_t raceid_ = it_.first;
@@ -2996,15 +3171,13 @@ void ProtocolGame::parseBestiarysendCreatures(NetworkMessage &msg) {
 
 		uint8_t progress = 0;
 		uint8_t occurrence = 0;
-		for (const auto &_it : creaturesKilled) {
-			if (_it.first == raceid_) {
-				const auto tmpType = g_monsters().getMonsterType(it_.second);
-				if (!tmpType) {
-					return;
-				}
-				progress = g_iobestiary().getKillStatus(tmpType, _it.second);
-				occurrence = tmpType->info.bestiaryOccurrence;
+		if (const uint32_t killCount = player->getBestiaryKillCount(raceid_); killCount > 0) {
+			const auto tmpType = g_monsters().getMonsterType(it_.second);
+			if (!tmpType) {
+				return;
 			}
+			progress = g_iobestiary().getKillStatus(tmpType, killCount);
+			occurrence = tmpType->info.bestiaryOccurrence;
 		}
 
 		if (progress > 0) {
@@ -3019,7 +3192,7 @@ void ProtocolGame::parseBestiarysendCreatures(NetworkMessage &msg) {
 
 	newmsg.add<uint16_t>(0); // Animus Mastery Points
 
-	writeToOutputBuffer(newmsg);
+	writeToBulkOutputBuffer(newmsg);
 }
 
 void ProtocolGame::parseBugReport(NetworkMessage &msg) {
@@ -3305,22 +3478,27 @@ void ProtocolGame::sendCreatureIcon(std::shared_ptr<Creature> creature) {
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendWorldLight(const LightInfo &lightInfo) {
-	NetworkMessage msg;
-	AddWorldLight(msg, lightInfo);
-	writeToOutputBuffer(msg);
+void ProtocolGame::sendWorldLight(const LightInfo &lightInfo, BroadcastMessage* broadcast /* = nullptr*/) {
+	// The access players see the world lit, not the shared packet
+	if (player && player->isAccessPlayer()) {
+		broadcast = nullptr;
+	}
+
+	writeToOutputBuffer(broadcast, [&](NetworkMessage &msg) {
+		AddWorldLight(msg, lightInfo);
+	});
 }
 
-void ProtocolGame::sendTibiaTime(int32_t time) {
+void ProtocolGame::sendTibiaTime(int32_t time, BroadcastMessage* broadcast /* = nullptr*/) {
 	if (!player || oldProtocol) {
 		return;
 	}
 
-	NetworkMessage msg;
-	msg.addByte(0xEF);
-	msg.addByte(time / 60);
-	msg.addByte(time % 60);
-	writeToOutputBuffer(msg);
+	writeToOutputBuffer(broadcast, [&](NetworkMessage &msg) {
+		msg.addByte(0xEF);
+		msg.addByte(time / 60);
+		msg.addByte(time % 60);
+	});
 }
 
 void ProtocolGame::sendCreatureWalkthrough(std::shared_ptr<Creature> creature, bool walkthrough) {
@@ -3439,6 +3617,38 @@ void ProtocolGame::sendAddMarker(const Position &pos, uint8_t markType, const st
 	writeToOutputBuffer(msg);
 }
 
+bool ProtocolGame::sendCachedCyclopediaCharacterInfo(CyclopediaCharacterInfoType_t characterInfoType) {
+	if (!player || oldProtocol) {
+		return false;
+	}
+
+	auto it = cyclopediaCache.find(characterInfoType);
+	if (it == cyclopediaCache.end()) {
+		return false;
+	}
+
+	// Depot and inbox changes made away from the player don't bump the revision, the lifetime bounds them
+	const auto &entry = it->second;
+	if (entry.revision != player->getCyclopediaRevision() || entry.expiresAt < OTSYS_TIME()) {
+		cyclopediaCache.erase(it);
+		return false;
+	}
+
+	NetworkMessage msg;
+	msg.addBytes(entry.bytes.data(), entry.bytes.size());
+	writeToBulkOutputBuffer(msg);
+	return true;
+}
+
+void ProtocolGame::cacheCyclopediaCharacterInfo(CyclopediaCharacterInfoType_t characterInfoType, const NetworkMessage &msg) {
+	static constexpr int64_t CYCLOPEDIA_CACHE_DURATION = 10000;
+
+	auto &entry = cyclopediaCache[characterInfoType];
+	entry.revision = player->getCyclopediaRevision();
+	entry.expiresAt = OTSYS_TIME() + CYCLOPEDIA_CACHE_DURATION;
+	entry.bytes.assign(reinterpret_cast<const char*>(msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION), msg.getLength());
+}
+
 void ProtocolGame::sendCyclopediaCharacterNoData(CyclopediaCharacterInfoType_t characterInfoType, uint8_t errorCode) {
 	if (!player || oldProtocol) {
 		return;
@@ -3448,7 +3658,7 @@ void ProtocolGame::sendCyclopediaCharacterNoData(CyclopediaCharacterInfoType_t c
 	msg.addByte(0xDA);
 	msg.addByte(static_cast<uint8_t>(characterInfoType));
 	msg.addByte(errorCode);
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCyclopediaCharacterBaseInformation() {
@@ -3467,7 +3677,7 @@ void ProtocolGame::sendCyclopediaCharacterBaseInformation() {
 
 	msg.addByte(0x01); // Store summary & Character titles
 	msg.addString(player->title()->getCurrentTitleName(), "ProtocolGame::sendCyclopediaCharacterBaseInformation - player->title()->getCurrentTitleName()"); // character title
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCyclopediaCharacterGeneralStats() {
@@ -3538,7 +3748,7 @@ void ProtocolGame::sendCyclopediaCharacterGeneralStats() {
 	}
 	msg.setBufferPosition(bufferPosition);
 	msg.addByte(total);
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCyclopediaCharacterCombatStats() {
@@ -3694,7 +3904,7 @@ void ProtocolGame::sendCyclopediaCharacterCombatStats() {
 	msg.setBufferPosition(startConcoctions);
 	msg.addByte(concoctions);
 
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCyclopediaCharacterRecentDeaths(uint16_t page, uint16_t pages, const std::vector<RecentDeathEntry> &entries) {
@@ -3714,7 +3924,7 @@ void ProtocolGame::sendCyclopediaCharacterRecentDeaths(uint16_t page, uint16_t p
 		msg.addString(entry.cause, "ProtocolGame::sendCyclopediaCharacterRecentDeaths - entry.cause");
 	}
 
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCyclopediaCharacterRecentPvPKills(uint16_t page, uint16_t pages, const std::vector<RecentPvPKillEntry> &entries) {
@@ -3735,7 +3945,7 @@ void ProtocolGame::sendCyclopediaCharacterRecentPvPKills(uint16_t page, uint16_t
 		msg.addByte(entry.status);
 	}
 
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCyclopediaCharacterAchievements(uint16_t secretsUnlocked, std::vector<std::pair<Achievement, uint32_t>> achievementsUnlocked) {
@@ -3764,7 +3974,8 @@ void ProtocolGame::sendCyclopediaCharacterAchievements(uint16_t secretsUnlocked,
 			msg.addByte(0x00);
 		}
 	}
-	writeToOutputBuffer(msg);
+	cacheCyclopediaCharacterInfo(CYCLOPEDIA_CHARACTERINFO_ACHIEVEMENTS, msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCyclopediaCharacterItemSummary(const ItemsTierCountList &inventoryItems, const ItemsTierCountList &storeInboxItems, const StashItemList &supplyStashItems, const ItemsTierCountList &depotBoxItems, const ItemsTierCountList &inboxItems) {
@@ -3876,7 +4087,8 @@ void ProtocolGame::sendCyclopediaCharacterItemSummary(const ItemsTierCountList &
 	msg.setBufferPosition(startInbox);
 	msg.add<uint16_t>(inboxItemsCount);
 
-	writeToOutputBuffer(msg);
+	cacheCyclopediaCharacterInfo(CYCLOPEDIA_CHARACTERINFO_ITEMSUMMARY, msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCyclopediaCharacterOutfitsMounts() {
@@ -3979,7 +4191,7 @@ void ProtocolGame::sendCyclopediaCharacterOutfitsMounts() {
 	msg.add<uint16_t>(mountSize);
 	msg.setBufferPosition(startFamiliars);
 	msg.add<uint16_t>(familiarsSize);
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCyclopediaCharacterStoreSummary() {
@@ -4061,7 +4273,7 @@ void ProtocolGame::sendCyclopediaCharacterStoreSummary() {
 		msg.addByte(hItem_it.second);
 	}
 
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCyclopediaCharacterInspection() {
@@ -4129,7 +4341,7 @@ void ProtocolGame::sendCyclopediaCharacterInspection() {
 	// Level description
 	playerDescriptionSize++;
 	msg.addString("Level", "ProtocolGame::sendCyclopediaCharacterInspection - Level");
-	msg.addString(std::to_string(player->getLevel()), "ProtocolGame::sendCyclopediaCharacterInspection - std::to_string(player->getLevel())");
+	msg.addFormattedString("{}", player->getLevel());
 
 	// Vocation description
 	playerDescriptionSize++;
@@ -4199,7 +4411,7 @@ void ProtocolGame::sendCyclopediaCharacterInspection() {
 	msg.setBufferPosition(playerDescriptionPosition);
 	msg.addByte(playerDescriptionSize);
 
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCyclopediaCharacterBadges() {
@@ -4233,7 +4445,7 @@ void ProtocolGame::sendCyclopediaCharacterBadges() {
 	msg.setBufferPosition(badgesSizePosition);
 	msg.addByte(badgesSize);
 
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCyclopediaCharacterTitles() {
@@ -4241,7 +4453,7 @@ void ProtocolGame::sendCyclopediaCharacterTitles() {
 		return;
 	}
 
-	auto titles = g_game().getTitles();
+	const auto &titles = g_game().getTitles();
 
 	NetworkMessage msg;
 	msg.addByte(0xDA);
@@ -4262,7 +4474,7 @@ void ProtocolGame::sendCyclopediaCharacterTitles() {
 		msg.addByte(isUnlocked ? 0x01 : 0x00);
 	}
 
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendReLoginWindow(uint8_t unfairFightReduction) {
@@ -4566,16 +4778,16 @@ void ProtocolGame::sendChannel(uint16_t channelId, const std::string &channelNam
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendChannelMessage(const std::string &author, const std::string &text, SpeakClasses type, uint16_t channel) {
-	NetworkMessage msg;
-	msg.addByte(0xAA);
-	msg.add<uint32_t>(0x00);
-	msg.addString(author, "ProtocolGame::sendChannelMessage - author");
-	msg.add<uint16_t>(0x00);
-	msg.addByte(type);
-	msg.add<uint16_t>(channel);
-	msg.addString(text, "ProtocolGame::sendChannelMessage - text");
-	writeToOutputBuffer(msg);
+void ProtocolGame::sendChannelMessage(const std::string &author, const std::string &text, SpeakClasses type, uint16_t channel, BroadcastMessage* broadcast /* = nullptr*/) {
+	writeToOutputBuffer(broadcast, [&](NetworkMessage &msg) {
+		msg.addByte(0xAA);
+		msg.add<uint32_t>(0x00);
+		msg.addString(author, "ProtocolGame::sendChannelMessage - author");
+		msg.add<uint16_t>(0x00);
+		msg.addByte(type);
+		msg.add<uint16_t>(channel);
+		msg.addString(text, "ProtocolGame::sendChannelMessage - text");
+	});
 }
 
 void ProtocolGame::sendIcons(const std::unordered_set<PlayerIcon> &iconSet, const IconBakragore iconBakragore) {
@@ -4808,7 +5020,7 @@ void ProtocolGame::sendShop(std::shared_ptr<Npc> npc) {
 
 	if (!oldProtocol) {
 		msg.add<uint16_t>(npc->getCurrency());
-		msg.addString(std::string()); // Currency name
+		msg.addString(""); // Currency name
 	}
 
 	const auto &shoplist = npc->getShopItemVector(player->getGUID());
@@ -4817,17 +5029,19 @@ void ProtocolGame::sendShop(std::shared_ptr<Npc> npc) {
 
 	// Initialize before the loop to avoid database overload on each iteration
 	auto talkactionHidden = player->kv()->get("npc-shop-hidden-sell-item");
-	// Initialize the inventoryMap outside the loop to avoid creation on each iteration
+	const bool hideMissingSellItems = talkactionHidden && talkactionHidden->get<bool>();
+	// Initialize the inventoryMap outside the loop to avoid creation on each iteration, only the hidden sell items read it
 	std::map<uint16_t, uint16_t> inventoryMap;
-	player->getAllSaleItemIdAndCount(inventoryMap);
-	uint16_t i = 0;
-	for (const ShopBlock &shopBlock : shoplist) {
-		if (++i > itemsToSend) {
-			break;
-		}
+	if (hideMissingSellItems) {
+		player->getAllSaleItemIdAndCount(inventoryMap);
+	}
 
+	// Players trading the shop of the type copy its items as encoded on the first trade
+	const EncodedShop* encodedShop = &shoplist == &npc->getShopItemVector(0) ? &getEncodedShop(npc) : nullptr;
+	for (uint16_t i = 0; i < itemsToSend; ++i) {
+		const ShopBlock &shopBlock = shoplist[i];
 		// Hidden sell items from the shop if they are not in the player's inventory
-		if (talkactionHidden && talkactionHidden->get<bool>()) {
+		if (hideMissingSellItems) {
 			const auto &foundItem = inventoryMap.find(shopBlock.itemId);
 			if (foundItem == inventoryMap.end() && shopBlock.itemSellPrice > 0 && shopBlock.itemBuyPrice == 0) {
 				AddHiddenShopItem(msg);
@@ -4835,7 +5049,13 @@ void ProtocolGame::sendShop(std::shared_ptr<Npc> npc) {
 			}
 		}
 
-		AddShopItem(msg, shopBlock);
+		if (!encodedShop || (shopBlock.itemStorageKey != 0 && player->getStorageValue(shopBlock.itemStorageKey) < shopBlock.itemStorageValue)) {
+			AddShopItem(msg, shopBlock);
+			continue;
+		}
+
+		const auto begin = encodedShop->offsets[i];
+		msg.addBytes(encodedShop->bytes.data() + begin, encodedShop->offsets[i + 1] - begin);
 	}
 
 	writeToOutputBuffer(msg);
@@ -5102,7 +5322,7 @@ void ProtocolGame::sendMarketBrowseItem(uint16_t itemId, const MarketOfferList &
 	}
 
 	updateCoinBalance();
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendMarketAcceptOffer(const MarketOfferEx &offer) {
@@ -5187,7 +5407,7 @@ void ProtocolGame::sendMarketBrowseOwnOffers(const MarketOfferList &buyOffers, c
 		}
 	}
 
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendMarketCancelOffer(const MarketOfferEx &offer) {
@@ -5281,7 +5501,7 @@ void ProtocolGame::sendMarketBrowseOwnHistory(const HistoryMarketOfferList &buyO
 		msg.addByte(it->state);
 	}
 
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendForgingData() {
@@ -5731,7 +5951,7 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 	}
 
 	if (it.armor != 0) {
-		msg.addString(std::to_string(it.armor), "ProtocolGame::sendMarketDetail - std::to_string(it.armor)");
+		msg.addFormattedString("{}", it.armor);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
@@ -5766,14 +5986,14 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 			ss << it.attack << " physical +" << it.abilities->elementDamage << ' ' << getCombatName(it.abilities->elementType);
 			msg.addString(ss.str(), "ProtocolGame::sendMarketDetail - ss.str()");
 		} else {
-			msg.addString(std::to_string(it.attack), "ProtocolGame::sendMarketDetail - std::to_string(it.attack)");
+			msg.addFormattedString("{}", it.attack);
 		}
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
 
 	if (it.isContainer()) {
-		msg.addString(std::to_string(it.maxItems), "ProtocolGame::sendMarketDetail - std::to_string(it.maxItems)");
+		msg.addFormattedString("{}", it.maxItems);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
@@ -5784,7 +6004,7 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 			ss << it.defense << ' ' << std::showpos << it.extraDefense << std::noshowpos;
 			msg.addString(ss.str(), "ProtocolGame::sendMarketDetail - ss.str()");
 		} else {
-			msg.addString(std::to_string(it.defense), "ProtocolGame::sendMarketDetail - std::to_string(it.defense)");
+			msg.addFormattedString("{}", it.defense);
 		}
 	} else {
 		msg.add<uint16_t>(0x00);
@@ -5833,13 +6053,13 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 	}
 
 	if (it.minReqLevel != 0) {
-		msg.addString(std::to_string(it.minReqLevel), "ProtocolGame::sendMarketDetail - std::to_string(it.minReqLevel)");
+		msg.addFormattedString("{}", it.minReqLevel);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
 
 	if (it.minReqMagicLevel != 0) {
-		msg.addString(std::to_string(it.minReqMagicLevel), "ProtocolGame::sendMarketDetail - std::to_string(it.minReqMagicLevel)");
+		msg.addFormattedString("{}", it.minReqMagicLevel);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
@@ -5917,7 +6137,7 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 	}
 
 	if (it.charges != 0) {
-		msg.addString(std::to_string(it.charges), "ProtocolGame::sendMarketDetail - std::to_string(it.charges)");
+		msg.addFormattedString("{}", it.charges);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
@@ -5961,7 +6181,7 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 	}
 
 	if (it.imbuementSlot > 0) {
-		msg.addString(std::to_string(it.imbuementSlot), "ProtocolGame::sendMarketDetail - std::to_string(it.imbuementSlot)");
+		msg.addFormattedString("{}", it.imbuementSlot);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
@@ -6015,7 +6235,7 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 
 		// Upgrade and tier detail modifier
 		if (it.upgradeClassification > 0 && tier > 0) {
-			msg.addString(std::to_string(it.upgradeClassification), "ProtocolGame::sendMarketDetail - std::to_string(it.upgradeClassification)");
+			msg.addFormattedString("{}", it.upgradeClassification);
 			std::ostringstream ss;
 
 			double chance;
@@ -6031,8 +6251,8 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 			}
 			msg.addString(ss.str(), "ProtocolGame::sendMarketDetail - ss.str()");
 		} else if (it.upgradeClassification > 0 && tier == 0) {
-			msg.addString(std::to_string(it.upgradeClassification), "ProtocolGame::sendMarketDetail - std::to_string(it.upgradeClassification)");
-			msg.addString(std::to_string(tier), "ProtocolGame::sendMarketDetail - std::to_string(tier)");
+			msg.addFormattedString("{}", it.upgradeClassification);
+			msg.addFormattedString("{}", tier);
 		} else {
 			msg.add<uint16_t>(0x00);
 			msg.add<uint16_t>(0x00);
@@ -6089,7 +6309,7 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 		msg.addByte(0x00); // send to old protocol ?
 	}
 
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::sendTradeItemRequest(const std::string &traderName, std::shared_ptr<Item> item, bool ack) {
@@ -6159,82 +6379,83 @@ void ProtocolGame::sendCreatureTurn(std::shared_ptr<Creature> creature, uint32_t
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, const Position* pos /* = nullptr*/) {
-	NetworkMessage msg;
-	msg.addByte(0xAA);
+void ProtocolGame::sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, const Position* pos /* = nullptr*/, BroadcastMessage* broadcast /* = nullptr*/) {
+	writeToOutputBuffer(broadcast, [&](NetworkMessage &msg) {
+		msg.addByte(0xAA);
 
-	static uint32_t statementId = 0;
-	msg.add<uint32_t>(++statementId);
+		static uint32_t statementId = 0;
+		msg.add<uint32_t>(++statementId);
 
-	msg.addString(creature->getName(), "ProtocolGame::sendCreatureSay - creature->getName()");
+		msg.addString(creature->getName(), "ProtocolGame::sendCreatureSay - creature->getName()");
 
-	if (!oldProtocol) {
-		msg.addByte(0x00); // Show (Traded)
-	}
+		if (!oldProtocol) {
+			msg.addByte(0x00); // Show (Traded)
+		}
 
-	// Add level only for players
-	if (std::shared_ptr<Player> speaker = creature->getPlayer()) {
-		msg.add<uint16_t>(speaker->getLevel());
-	} else {
-		msg.add<uint16_t>(0x00);
-	}
+		// Add level only for players
+		if (std::shared_ptr<Player> speaker = creature->getPlayer()) {
+			msg.add<uint16_t>(speaker->getLevel());
+		} else {
+			msg.add<uint16_t>(0x00);
+		}
 
-	if (oldProtocol && type >= TALKTYPE_MONSTER_LAST_OLDPROTOCOL && type != TALKTYPE_CHANNEL_R2) {
-		msg.addByte(TALKTYPE_MONSTER_SAY);
-	} else {
-		msg.addByte(type);
-	}
+		if (oldProtocol && type >= TALKTYPE_MONSTER_LAST_OLDPROTOCOL && type != TALKTYPE_CHANNEL_R2) {
+			msg.addByte(TALKTYPE_MONSTER_SAY);
+		} else {
+			msg.addByte(type);
+		}
 
-	if (pos) {
-		msg.addPosition(*pos);
-	} else {
-		msg.addPosition(creature->getPosition());
-	}
+		if (pos) {
+			msg.addPosition(*pos);
+		} else {
+			msg.addPosition(creature->getPosition());
+		}
 
-	msg.addString(text, "ProtocolGame::sendCreatureSay - text");
-	writeToOutputBuffer(msg);
+		msg.addString(text, "ProtocolGame::sendCreatureSay - text");
+	});
 }
 
-void ProtocolGame::sendToChannel(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, uint16_t channelId) {
-	NetworkMessage msg;
-	msg.addByte(0xAA);
+void ProtocolGame::sendToChannel(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, uint16_t channelId, BroadcastMessage* broadcast /* = nullptr*/) {
+	writeToOutputBuffer(broadcast, [&](NetworkMessage &msg) {
+		msg.addByte(0xAA);
 
-	static uint32_t statementId = 0;
-	msg.add<uint32_t>(++statementId);
-	if (!creature) {
-		msg.add<uint32_t>(0x00);
-		if (!oldProtocol && statementId != 0) {
-			msg.addByte(0x00); // Show (Traded)
-		}
-	} else if (type == TALKTYPE_CHANNEL_R2) {
-		msg.add<uint32_t>(0x00);
-		if (!oldProtocol && statementId != 0) {
-			msg.addByte(0x00); // Show (Traded)
-		}
-		type = TALKTYPE_CHANNEL_R1;
-	} else {
-		msg.addString(creature->getName(), "ProtocolGame::sendToChannel - creature->getName()");
-		if (!oldProtocol && statementId != 0) {
-			msg.addByte(0x00); // Show (Traded)
+		static uint32_t statementId = 0;
+		msg.add<uint32_t>(++statementId);
+		SpeakClasses talkType = type;
+		if (!creature) {
+			msg.add<uint32_t>(0x00);
+			if (!oldProtocol && statementId != 0) {
+				msg.addByte(0x00); // Show (Traded)
+			}
+		} else if (talkType == TALKTYPE_CHANNEL_R2) {
+			msg.add<uint32_t>(0x00);
+			if (!oldProtocol && statementId != 0) {
+				msg.addByte(0x00); // Show (Traded)
+			}
+			talkType = TALKTYPE_CHANNEL_R1;
+		} else {
+			msg.addString(creature->getName(), "ProtocolGame::sendToChannel - creature->getName()");
+			if (!oldProtocol && statementId != 0) {
+				msg.addByte(0x00); // Show (Traded)
+			}
+
+			// Add level only for players
+			if (std::shared_ptr<Player> speaker = creature->getPlayer()) {
+				msg.add<uint16_t>(speaker->getLevel());
+			} else {
+				msg.add<uint16_t>(0x00);
+			}
 		}
 
-		// Add level only for players
-		if (std::shared_ptr<Player> speaker = creature->getPlayer()) {
-			msg.add<uint16_t>(speaker->getLevel());
+		if (oldProtocol && talkType >= TALKTYPE_MONSTER_LAST_OLDPROTOCOL && talkType != TALKTYPE_CHANNEL_R2) {
+			msg.addByte(TALKTYPE_CHANNEL_O);
 		} else {
-			msg.add<uint16_t>(0x00);
+			msg.addByte(talkType);
 		}
-	}
-
-	if (oldProtocol && type >= TALKTYPE_MONSTER_LAST_OLDPROTOCOL && type != TALKTYPE_CHANNEL_R2) {
-		msg.addByte(TALKTYPE_CHANNEL_O);
-	} else {
-		msg.addByte(type);
-	}
 
-	msg.add<uint16_t>(channelId);
-	msg.addString(text, "ProtocolGame::sendToChannel - text");
-	writeToOutputBuffer(msg);
+		msg.add<uint16_t>(channelId);
+		msg.addString(text, "ProtocolGame::sendToChannel - text");
+	});
 }
 
 void ProtocolGame::sendPrivateMessage(std::shared_ptr<Player> speaker, SpeakClasses type, const std::string &text) {
@@ -6310,26 +6531,26 @@ void ProtocolGame::sendPingBack() {
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, uint16_t type) {
+void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, uint16_t type, BroadcastMessage* broadcast /* = nullptr*/) {
 	if (oldProtocol && type > 0xFF) {
 		return;
 	}
-	NetworkMessage msg;
-	if (oldProtocol) {
-		msg.addByte(0x85);
-		msg.addPosition(from);
-		msg.addPosition(to);
-		msg.addByte(static_cast<uint8_t>(type));
-	} else {
-		msg.addByte(0x83);
-		msg.addPosition(from);
-		msg.addByte(MAGIC_EFFECTS_CREATE_DISTANCEEFFECT);
-		msg.add<uint16_t>(type);
-		msg.addByte(static_cast<uint8_t>(static_cast<int8_t>(static_cast<int32_t>(to.x) - static_cast<int32_t>(from.x))));
-		msg.addByte(static_cast<uint8_t>(static_cast<int8_t>(static_cast<int32_t>(to.y) - static_cast<int32_t>(from.y))));
-		msg.addByte(MAGIC_EFFECTS_END_LOOP);
-	}
-	writeToOutputBuffer(msg);
+	writeToOutputBuffer(broadcast, [&](NetworkMessage &msg) {
+		if (oldProtocol) {
+			msg.addByte(0x85);
+			msg.addPosition(from);
+			msg.addPosition(to);
+			msg.addByte(static_cast<uint8_t>(type));
+		} else {
+			msg.addByte(0x83);
+			msg.addPosition(from);
+			msg.addByte(MAGIC_EFFECTS_CREATE_DISTANCEEFFECT);
+			msg.add<uint16_t>(type);
+			msg.addByte(static_cast<uint8_t>(static_cast<int8_t>(static_cast<int32_t>(to.x) - static_cast<int32_t>(from.x))));
+			msg.addByte(static_cast<uint8_t>(static_cast<int8_t>(static_cast<int32_t>(to.y) - static_cast<int32_t>(from.y))));
+			msg.addByte(MAGIC_EFFECTS_END_LOOP);
+		}
+	});
 }
 
 void ProtocolGame::sendRestingStatus(uint8_t protection) {
@@ -6377,24 +6598,24 @@ void ProtocolGame::sendRestingStatus(uint8_t protection) {
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type) {
+void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type, BroadcastMessage* broadcast /* = nullptr*/) {
 	if (!canSee(pos) || (oldProtocol && type > 0xFF)) {
 		return;
 	}
 
-	NetworkMessage msg;
-	if (oldProtocol) {
-		msg.addByte(0x83);
-		msg.addPosition(pos);
-		msg.addByte(static_cast<uint8_t>(type));
-	} else {
-		msg.addByte(0x83);
-		msg.addPosition(pos);
-		msg.addByte(MAGIC_EFFECTS_CREATE_EFFECT);
-		msg.add<uint16_t>(type);
-		msg.addByte(MAGIC_EFFECTS_END_LOOP);
-	}
-	writeToOutputBuffer(msg);
+	writeToOutputBuffer(broadcast, [&](NetworkMessage &msg) {
+		if (oldProtocol) {
+			msg.addByte(0x83);
+			msg.addPosition(pos);
+			msg.addByte(static_cast<uint8_t>(type));
+		} else {
+			msg.addByte(0x83);
+			msg.addPosition(pos);
+			msg.addByte(MAGIC_EFFECTS_CREATE_EFFECT);
+			msg.add<uint16_t>(type);
+			msg.addByte(MAGIC_EFFECTS_END_LOOP);
+		}
+	});
 }
 
 void ProtocolGame::removeMagicEffect(const Position &pos, uint16_t type) {
@@ -6412,21 +6633,16 @@ void ProtocolGame::removeMagicEffect(const Position &pos, uint16_t type) {
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendCreatureHealth(std::shared_ptr<Creature> creature) {
+void ProtocolGame::sendCreatureHealth(std::shared_ptr<Creature> creature, BroadcastMessage* broadcast /* = nullptr*/) {
 	if (creature->isHealthHidden()) {
 		return;
 	}
 
-	NetworkMessage msg;
-	msg.addByte(0x8C);
-	msg.add<uint32_t>(creature->getID());
-	if (creature->isHealthHidden()) {
-		msg.addByte(0x00);
-	} else {
+	writeToOutputBuffer(broadcast, [&](NetworkMessage &msg) {
+		msg.addByte(0x8C);
+		msg.add<uint32_t>(creature->getID());
 		msg.addByte(static_cast<uint8_t>(std::min<double>(100, std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100))));
-	}
-
-	writeToOutputBuffer(msg);
+	});
 }
 
 void ProtocolGame::sendPartyCreatureUpdate(std::shared_ptr<Creature> target) {
@@ -7654,7 +7870,7 @@ void ProtocolGame::AddCreature(NetworkMessage &msg, std::shared_ptr<Creature> cr
 		}
 
 		if (!oldProtocol && creature->isHealthHidden()) {
-			msg.addString(std::string());
+			msg.addString("");
 		} else {
 			msg.addString(creature->getName(), "ProtocolGame::AddCreature - creature->getName()");
 		}
@@ -7875,10 +8091,9 @@ void ProtocolGame::addImbuementInfo(NetworkMessage &msg, uint16_t imbuementId) c
 	const CategoryImbuement* categoryImbuement = g_imbuements().getCategoryByID(imbuement->getCategory());
 
 	msg.add<uint32_t>(imbuementId);
-	msg.addString(baseImbuement->name + " " + imbuement->getName(), "ProtocolGame::addImbuementInfo - baseImbuement->name + "
-	                                                                " + imbuement->getName()");
+	msg.addFormattedString("{} {}", baseImbuement->name, imbuement->getName());
 	msg.addString(imbuement->getDescription(), "ProtocolGame::addImbuementInfo - imbuement->getDescription()");
-	msg.addString(categoryImbuement->name + imbuement->getSubGroup(), "ProtocolGame::addImbuementInfo - categoryImbuement->name + imbuement->getSubGroup()");
+	msg.addFormattedString("{}{}", categoryImbuement->name, imbuement->getSubGroup());
 
 	msg.add<uint16_t>(imbuement->getIconID());
 	msg.add<uint32_t>(baseImbuement->duration);
@@ -8300,7 +8515,7 @@ void ProtocolGame::AddHiddenShopItem(NetworkMessage &msg) {
 	// Empty bytes from AddShopItem
 	msg.add<uint16_t>(0);
 	msg.addByte(0);
-	msg.addString(std::string());
+	msg.addString("");
 	msg.add<uint32_t>(0);
 	msg.add<uint32_t>(0);
 	msg.add<uint32_t>(0);
@@ -8313,6 +8528,10 @@ void ProtocolGame::AddShopItem(NetworkMessage &msg, const ShopBlock &shopBlock)
 		return;
 	}
 
+	encodeShopItem(msg, shopBlock);
+}
+
+void ProtocolGame::encodeShopItem(NetworkMessage &msg, const ShopBlock &shopBlock) {
 	const ItemType &it = Item::items[shopBlock.itemId];
 	msg.add<uint16_t>(shopBlock.itemId);
 	if (it.isSplash() || it.isFluidContainer()) {
@@ -8332,6 +8551,26 @@ void ProtocolGame::AddShopItem(NetworkMessage &msg, const ShopBlock &shopBlock)
 	msg.add<uint32_t>(shopBlock.itemSellPrice == 4294967295 ? 0 : shopBlock.itemSellPrice);
 }
 
+const EncodedShop &ProtocolGame::getEncodedShop(const std::shared_ptr<Npc> &npc) {
+	auto &encodedShop = npc->getEncodedShop();
+	const auto &shoplist = npc->getShopItemVector(0);
+	if (encodedShop.offsets.size() == shoplist.size() + 1) {
+		return encodedShop;
+	}
+
+	NetworkMessage msg;
+	const auto start = msg.getBufferPosition();
+	encodedShop.offsets.clear();
+	encodedShop.offsets.reserve(shoplist.size() + 1);
+	for (const ShopBlock &shopBlock : shoplist) {
+		encodedShop.offsets.emplace_back(msg.getBufferPosition() - start);
+		encodeShopItem(msg, shopBlock);
+	}
+	encodedShop.offsets.emplace_back(msg.getBufferPosition() - start);
+	encodedShop.bytes.assign(reinterpret_cast<const char*>(msg.getBuffer() + start), msg.getBufferPosition() - start);
+	return encodedShop;
+}
+
 void ProtocolGame::parseExtendedOpcode(NetworkMessage &msg) {
 	uint8_t opcode = msg.getByte();
 	const std::string &buffer = msg.getString();
@@ -8407,8 +8646,7 @@ void ProtocolGame::sendInventoryImbuements(const std::map<Slots_t, std::shared_p
 
 			const BaseImbuement* baseImbuement = g_imbuements().getBaseByID(imbuement->getBaseID());
 			msg.addByte(0x01);
-			msg.addString(baseImbuement->name + " " + imbuement->getName(), "ProtocolGame::sendInventoryImbuements - baseImbuement->name + "
-			                                                                " + imbuement->getName()");
+			msg.addFormattedString("{} {}", baseImbuement->name, imbuement->getName());
 			msg.add<uint16_t>(imbuement->getIconID());
 			msg.add<uint32_t>(imbuementInfo.duration);
 
@@ -8841,7 +9079,7 @@ void ProtocolGame::parseSendBosstiary() {
 	msg.setBufferPosition(bossesBuffer);
 	msg.add<uint16_t>(bossesCount);
 
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 }
 
 void ProtocolGame::parseSendBosstiarySlots() {
@@ -8971,7 +9209,7 @@ void ProtocolGame::parseSendBosstiarySlots() {
 		msg.add<uint16_t>(bossesCount);
 	}
 
-	writeToOutputBuffer(msg);
+	writeToBulkOutputBuffer(msg);
 	parseSendResourceBalance();
 }
 
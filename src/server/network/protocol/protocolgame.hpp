@@ -10,6 +10,8 @@
 #pragma once
 
 #include "server/network/protocol/protocol.hpp"
+#include "server/network/protocol/known_creature_set.hpp"
+#include "server/network/protocol/packet_capture.hpp"
 #include "creatures/interactions/chat.hpp"
 #include "creatures/creature.hpp"
 #include "enums/forge_conversion.hpp"
@@ -26,6 +28,7 @@ class Container;
 class Tile;
 class Connection;
 class Quest;
+class DBResultPrefetch;
 class ProtocolGame;
 class PreySlot;
 class TaskHuntingSlot;
@@ -35,6 +38,7 @@ struct ModalWindow;
 struct Achievement;
 struct Badge;
 struct Title;
+struct EncodedShop;
 
 using ProtocolGame_ptr = std::shared_ptr<ProtocolGame>;
 
@@ -54,6 +58,16 @@ struct TextMessage {
 	} primary, secondary;
 };
 
+/**
+ * A packet that is the same for every viewer, built at most once per
+ * client protocol and then copied into the buffer of each viewer.
+ * Packets with viewer-specific fields, like the known creature cache,
+ * must not go through it.
+ */
+struct BroadcastMessage {
+	std::array<std::unique_ptr<NetworkMessage>, 2> messages;
+};
+
 class ProtocolGame final : public Protocol {
 public:
 	// Static protocol information.
@@ -78,13 +92,32 @@ public:
 		return version;
 	}
 
+	// Packets received per opcode, counted on the dispatcher thread
+	const std::array<uint32_t, 256> &getPacketsByOpcode() const {
+		return packetsByOpcode;
+	}
+	// Time the dispatcher spent handling the packets of this player
+	int64_t getDispatcherTimeNs() const {
+		return dispatcherTimeNs;
+	}
+	std::string getTrafficReport() const;
+
 private:
 	ProtocolGame_ptr getThis() {
 		return std::static_pointer_cast<ProtocolGame>(shared_from_this());
 	}
 	void connect(const std::string &playerName, OperatingSystem_t operatingSystem);
+	/**
+	 * @brief Loads a new character, reading the prefetched results first, and places it in the world.
+	 */
+	void enterGame(const std::shared_ptr<Player> &loadingPlayer, OperatingSystem_t operatingSystem, DBResultPrefetch &prefetch);
 	void disconnectClient(const std::string &message) const;
 	void writeToOutputBuffer(const NetworkMessage &msg);
+	void writeToOutputBuffer(BroadcastMessage* broadcast, const std::function<void(NetworkMessage &)> &build);
+	// Large responses (market, cyclopedia, bestiary...) that may wait while the connection is congested
+	void writeToBulkOutputBuffer(const NetworkMessage &msg);
+	// Keeps the encoded section for the next open, see sendCachedCyclopediaCharacterInfo
+	void cacheCyclopediaCharacterInfo(CyclopediaCharacterInfoType_t characterInfoType, const NetworkMessage &msg);
 
 	void release() override;
 
@@ -96,9 +129,10 @@ private:
 
 	// we have all the parse methods
 	void parsePacket(NetworkMessage &msg) override;
-	void parsePacketFromDispatcher(NetworkMessage msg, uint8_t recvbyte);
+	void parsePacketFromDispatcher(NetworkMessage &msg, uint8_t recvbyte);
 	void onRecvFirstMessage(NetworkMessage &msg) override;
 	void onConnect() override;
+	int8_t getSupersedeGroup(const NetworkMessage &msg) const override;
 
 	// Parse methods
 	void parseAutoWalk(NetworkMessage &msg);
@@ -232,7 +266,7 @@ private:
 	void addImbuementInfo(NetworkMessage &msg, uint16_t imbuementId) const;
 
 	// Send functions
-	void sendChannelMessage(const std::string &author, const std::string &text, SpeakClasses type, uint16_t channel);
+	void sendChannelMessage(const std::string &author, const std::string &text, SpeakClasses type, uint16_t channel, BroadcastMessage* broadcast = nullptr);
 	void sendChannelEvent(uint16_t channelId, const std::string &playerName, ChannelEvent_t channelEvent);
 	void sendClosePrivate(uint16_t channelId);
 	void sendCreatePrivateChannel(uint16_t channelId, const std::string &channelName);
@@ -240,7 +274,7 @@ private:
 	void sendChannel(uint16_t channelId, const std::string &channelName, const UsersMap* channelUsers, const InvitedMap* invitedUsers);
 	void sendOpenPrivateChannel(const std::string &receiver);
 	void sendExperienceTracker(int64_t rawExp, int64_t finalExp);
-	void sendToChannel(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, uint16_t channelId);
+	void sendToChannel(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, uint16_t channelId, BroadcastMessage* broadcast = nullptr);
 	void sendPrivateMessage(std::shared_ptr<Player> speaker, SpeakClasses type, const std::string &text);
 	void sendIcons(const std::unordered_set<PlayerIcon> &iconSet, const IconBakragore iconBakragore);
 	void sendIconBakragore(const IconBakragore icon);
@@ -282,11 +316,11 @@ private:
 	void sendBosstiaryEntryChanged(uint32_t bossid);
 
 	void sendAllowBugReport();
-	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type);
-	void sendMagicEffect(const Position &pos, uint16_t type);
+	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type, BroadcastMessage* broadcast = nullptr);
+	void sendMagicEffect(const Position &pos, uint16_t type, BroadcastMessage* broadcast = nullptr);
 	void removeMagicEffect(const Position &pos, uint16_t type);
 	void sendRestingStatus(uint8_t protection);
-	void sendCreatureHealth(std::shared_ptr<Creature> creature);
+	void sendCreatureHealth(std::shared_ptr<Creature> creature, BroadcastMessage* broadcast = nullptr);
 	void sendPartyCreatureUpdate(std::shared_ptr<Creature> target);
 	void sendPartyCreatureShield(std::shared_ptr<Creature> target);
 	void sendPartyCreatureSkull(std::shared_ptr<Creature> target);
@@ -299,7 +333,7 @@ private:
 	void sendPing();
 	void sendPingBack();
 	void sendCreatureTurn(std::shared_ptr<Creature> creature, uint32_t stackpos);
-	void sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, const Position* pos = nullptr);
+	void sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, const Position* pos = nullptr, BroadcastMessage* broadcast = nullptr);
 
 	// Unjust Panel
 	void sendUnjustifiedPoints(const uint8_t &dayProgress, const uint8_t &dayLeft, const uint8_t &weekProgress, const uint8_t &weekLeft, const uint8_t &monthProgress, const uint8_t &monthLeft, const uint8_t &skullDuration);
@@ -316,6 +350,7 @@ private:
 	void sendTutorial(uint8_t tutorialId);
 	void sendAddMarker(const Position &pos, uint8_t markType, const std::string &desc);
 
+	bool sendCachedCyclopediaCharacterInfo(CyclopediaCharacterInfoType_t characterInfoType);
 	void sendCyclopediaCharacterNoData(CyclopediaCharacterInfoType_t characterInfoType, uint8_t errorCode);
 	void sendCyclopediaCharacterBaseInformation();
 	void sendCyclopediaCharacterGeneralStats();
@@ -374,8 +409,8 @@ private:
 	void sendCreatureLight(std::shared_ptr<Creature> creature);
 	void sendCreatureIcon(std::shared_ptr<Creature> creature);
 	void sendUpdateCreature(std::shared_ptr<Creature> creature);
-	void sendWorldLight(const LightInfo &lightInfo);
-	void sendTibiaTime(int32_t time);
+	void sendWorldLight(const LightInfo &lightInfo, BroadcastMessage* broadcast = nullptr);
+	void sendTibiaTime(int32_t time, BroadcastMessage* broadcast = nullptr);
 
 	void sendCreatureSquare(std::shared_ptr<Creature> creature, SquareColor_t color);
 
@@ -432,6 +467,7 @@ private:
 	// Help functions
 	// translate a tile to clientreadable format
 	void GetTileDescription(std::shared_ptr<Tile> tile, NetworkMessage &msg);
+	void AddTileDescription(const std::shared_ptr<Tile> &tile, NetworkMessage &msg);
 
 	// translate a floor to clientreadable format
 	void GetFloorDescription(NetworkMessage &msg, int32_t x, int32_t y, int32_t z, int32_t width, int32_t height, int32_t offset, int32_t &skip);
@@ -460,6 +496,9 @@ private:
 	// shop
 	void AddHiddenShopItem(NetworkMessage &msg);
 	void AddShopItem(NetworkMessage &msg, const ShopBlock &shopBlock);
+	// The part of AddShopItem that is the same for every player
+	static void encodeShopItem(NetworkMessage &msg, const ShopBlock &shopBlock);
+	static const EncodedShop &getEncodedShop(const std::shared_ptr<Npc> &npc);
 
 	// otclient
 	void parseExtendedOpcode(NetworkMessage &msg);
@@ -485,7 +524,7 @@ private:
 	friend class PlayerWheel;
 	friend class PlayerVIP;
 
-	std::unordered_set<uint32_t> knownCreatureSet;
+	KnownCreatureSet knownCreatureSet;
 	std::shared_ptr<Player> player = nullptr;
 
 	uint32_t eventConnect = 0;
@@ -503,9 +542,46 @@ private:
 
 	bool oldProtocol = false;
 
+	// The bytes sent for the most common things differ between the protocols, their encoders are
+	// compiled once for each and the ones of the connection are picked at login
+	enum class ProtocolVariant : uint8_t {
+		Current,
+		Old
+	};
+
+	template <ProtocolVariant Variant>
+	void addItemBytes(NetworkMessage &msg, uint16_t id, uint8_t count, uint8_t tier);
+	template <ProtocolVariant Variant>
+	void addItemBytes(NetworkMessage &msg, const std::shared_ptr<Item> &item);
+	template <ProtocolVariant Variant>
+	void addTileDescriptionBytes(const std::shared_ptr<Tile> &tile, NetworkMessage &msg);
+
+	struct Encoders {
+		void (ProtocolGame::*addItemById)(NetworkMessage &, uint16_t, uint8_t, uint8_t);
+		void (ProtocolGame::*addItem)(NetworkMessage &, const std::shared_ptr<Item> &);
+		void (ProtocolGame::*addTileDescription)(const std::shared_ptr<Tile> &, NetworkMessage &);
+	};
+	static const Encoders currentEncoders;
+	static const Encoders oldEncoders;
+	const Encoders* encoders = &currentEncoders;
+
+	struct CyclopediaCacheEntry {
+		uint32_t revision = 0;
+		int64_t expiresAt = 0;
+		std::string bytes;
+	};
+	// Encoded item summary and achievements sections, by section type
+	phmap::flat_hash_map<uint8_t, CyclopediaCacheEntry> cyclopediaCache;
+
 	uint16_t otclientV8 = 0;
 	bool isOTC = false;
 
+	std::unique_ptr<PacketCapture> packetCapture;
+	void startPacketCapture();
+
+	std::array<uint32_t, 256> packetsByOpcode {};
+	int64_t dispatcherTimeNs = 0;
+
 	void sendInventory();
 	void sendOpenStash();
 	void parseStashWithdraw(NetworkMessage &msg);
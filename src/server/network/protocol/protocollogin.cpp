@@ -12,6 +12,7 @@
 #include "server/network/protocol/protocollogin.hpp"
 #include "server/network/message/outputmessage.hpp"
 #include "game/scheduling/dispatcher.hpp"
+#include "lib/thread/thread_pool.hpp"
 #include "account/account.hpp"
 #include "io/iologindata.hpp"
 #include "creatures/players/management/ban.hpp"
@@ -62,7 +63,7 @@ void ProtocolLogin::getCharacterList(const std::string &accountDescriptor, const
 
 	// Add session key
 	output->addByte(0x28);
-	output->addString(accountDescriptor + "\n" + password, "ProtocolLogin::getCharacterList - accountDescriptor + password");
+	output->addFormattedString("{}\n{}", accountDescriptor, password);
 
 	// Add char list
 	auto [players, result] = account.getAccountPlayers();
@@ -105,6 +106,12 @@ void ProtocolLogin::onRecvFirstMessage(NetworkMessage &msg) {
 		return;
 	}
 
+	// Refused before the RSA decrypt, the cheapest point to drop a login flood
+	if (auto curConnection = getConnection(); !curConnection || !inject<Ban>().acceptLogin(curConnection->getIP())) {
+		disconnect();
+		return;
+	}
+
 	msg.skipBytes(2); // client OS
 
 	uint16_t version = msg.get<uint16_t>();
@@ -142,24 +149,6 @@ void ProtocolLogin::onRecvFirstMessage(NetworkMessage &msg) {
 		return;
 	}
 
-	BanInfo banInfo;
-	auto curConnection = getConnection();
-	if (!curConnection) {
-		return;
-	}
-
-	if (IOBan::isIpBanned(curConnection->getIP(), banInfo)) {
-		if (banInfo.reason.empty()) {
-			banInfo.reason = "(none)";
-		}
-
-		std::ostringstream ss;
-		ss << "Your IP has been banned until " << formatDateShort(banInfo.expiresAt) << " by " << banInfo.bannedBy << ".\n\nReason specified:\n"
-		   << banInfo.reason;
-		disconnectClient(ss.str());
-		return;
-	}
-
 	std::string accountDescriptor = msg.getString();
 	if (accountDescriptor.empty()) {
 		std::ostringstream ss;
@@ -174,10 +163,21 @@ void ProtocolLogin::onRecvFirstMessage(NetworkMessage &msg) {
 		return;
 	}
 
-	g_dispatcher().addEvent(
-		[self = std::static_pointer_cast<ProtocolLogin>(shared_from_this()), accountDescriptor, password] {
-			self->getCharacterList(accountDescriptor, password);
-		},
-		__FUNCTION__
-	);
+	// The ban lookup, the account query and the password hash run on the thread pool, off the network threads and the dispatcher
+	inject<ThreadPool>().detach_task([self = std::static_pointer_cast<ProtocolLogin>(shared_from_this()), ip = getIP(), accountDescriptor, password] {
+		BanInfo banInfo;
+		if (IOBan::isIpBanned(ip, banInfo)) {
+			if (banInfo.reason.empty()) {
+				banInfo.reason = "(none)";
+			}
+
+			std::ostringstream ss;
+			ss << "Your IP has been banned until " << formatDateShort(banInfo.expiresAt) << " by " << banInfo.bannedBy << ".\n\nReason specified:\n"
+			   << banInfo.reason;
+			self->disconnectClient(ss.str());
+			return;
+		}
+
+		self->getCharacterList(accountDescriptor, password);
+	});
 }
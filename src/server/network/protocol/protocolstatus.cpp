@@ -15,6 +15,7 @@
 
 #include "config/configmanager.hpp"
 #include "game/game.hpp"
+#include "game/game_snapshot.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "server/network/message/outputmessage.hpp"
 
@@ -23,10 +24,14 @@ std::string ProtocolStatus::SERVER_VERSION = "3.0";
 std::string ProtocolStatus::SERVER_DEVELOPERS = "OpenTibiaBR Organization";
 
 std::map<uint32_t, int64_t> ProtocolStatus::ipConnectMap;
+std::mutex ProtocolStatus::ipConnectMapMutex;
+ProtocolStatus::ResponseCache ProtocolStatus::responseCache;
+std::mutex ProtocolStatus::responseCacheMutex;
 const uint64_t ProtocolStatus::start = OTSYS_TIME(true);
 
 void ProtocolStatus::onRecvFirstMessage(NetworkMessage &msg) {
 	uint32_t ip = getIP();
+	std::unique_lock ipConnectLock(ipConnectMapMutex);
 	if (ip != 0x0100007F) {
 		std::string ipStr = convertIPToString(ip);
 		if (ipStr != g_configManager().getString(IP, __FUNCTION__)) {
@@ -39,17 +44,15 @@ void ProtocolStatus::onRecvFirstMessage(NetworkMessage &msg) {
 	}
 
 	ipConnectMap[ip] = OTSYS_TIME();
+	ipConnectLock.unlock();
 
 	switch (msg.getByte()) {
 		// XML info protocol
 		case 0xFF: {
 			if (msg.getString(4) == "info") {
-				g_dispatcher().addEvent(
-					[self = std::static_pointer_cast<ProtocolStatus>(shared_from_this())] {
-						self->sendStatusString();
-					},
-					__FUNCTION__
-				);
+				withSnapshot([self = std::static_pointer_cast<ProtocolStatus>(shared_from_this())](const GameSnapshot &snapshot) {
+					self->sendStatusString(snapshot);
+				});
 				return;
 			}
 			break;
@@ -62,12 +65,9 @@ void ProtocolStatus::onRecvFirstMessage(NetworkMessage &msg) {
 			if (requestedInfo & REQUEST_PLAYER_STATUS_INFO) {
 				characterName = msg.getString();
 			}
-			g_dispatcher().addEvent(
-				[self = std::static_pointer_cast<ProtocolStatus>(shared_from_this()), requestedInfo, characterName] {
-					self->sendInfo(requestedInfo, characterName);
-				},
-				__FUNCTION__
-			);
+			withSnapshot([self = std::static_pointer_cast<ProtocolStatus>(shared_from_this()), requestedInfo, characterName](const GameSnapshot &snapshot) {
+				self->sendInfo(snapshot, requestedInfo, characterName);
+			});
 
 			return;
 		}
@@ -78,11 +78,50 @@ void ProtocolStatus::onRecvFirstMessage(NetworkMessage &msg) {
 	disconnect();
 }
 
-void ProtocolStatus::sendStatusString() {
+void ProtocolStatus::withSnapshot(std::function<void(const GameSnapshot &)> &&answer) {
+	// Answered right away on the network thread from the published snapshot, or from a fresh one on the dispatcher
+	if (const auto snapshot = g_game().getSnapshot()) {
+		answer(*snapshot);
+		return;
+	}
+
+	g_dispatcher().addEvent(
+		[answer = std::move(answer)] {
+			GameSnapshot snapshot;
+			snapshot.capture();
+			answer(snapshot);
+		},
+		"ProtocolStatus::withSnapshot"
+	);
+}
+
+void ProtocolStatus::sendStatusString(const GameSnapshot &snapshot) {
 	auto output = OutputMessagePool::getOutputMessage();
 
 	setRawMessages(true);
 
+	std::unique_lock cacheLock(responseCacheMutex);
+	if (responseCache.time != snapshot.getTime()) {
+		responseCache = { snapshot.getTime() };
+	}
+	if (responseCache.statusString.empty()) {
+		cacheLock.unlock();
+		auto data = encodeStatusString(snapshot);
+		cacheLock.lock();
+		if (responseCache.time == snapshot.getTime()) {
+			responseCache.statusString = data;
+		}
+		output->addBytes(data.c_str(), data.size());
+	} else {
+		output->addBytes(responseCache.statusString.c_str(), responseCache.statusString.size());
+	}
+	cacheLock.unlock();
+
+	send(output);
+	disconnect();
+}
+
+std::string ProtocolStatus::encodeStatusString(const GameSnapshot &snapshot) {
 	pugi::xml_document doc;
 
 	pugi::xml_node decl = doc.prepend_child(pugi::node_declaration);
@@ -110,29 +149,29 @@ void ProtocolStatus::sendStatusString() {
 	pugi::xml_node players = tsqp.append_child("players");
 	uint32_t real = 0;
 	std::map<uint32_t, uint32_t> listIP;
-	for (const auto &[key, player] : g_game().getPlayers()) {
-		if (player->getIP() != 0) {
-			auto ip = listIP.find(player->getIP());
+	for (const auto &player : snapshot.getPlayers()) {
+		if (player.ip != 0) {
+			auto ip = listIP.find(player.ip);
 			if (ip != listIP.end()) {
-				listIP[player->getIP()]++;
-				if (listIP[player->getIP()] < 5) {
+				listIP[player.ip]++;
+				if (listIP[player.ip] < 5) {
 					real++;
 				}
 			} else {
-				listIP[player->getIP()] = 1;
+				listIP[player.ip] = 1;
 				real++;
 			}
 		}
 	}
 	players.append_attribute("online") = std::to_string(real).c_str();
 	players.append_attribute("max") = std::to_string(g_configManager().getNumber(MAX_PLAYERS, __FUNCTION__)).c_str();
-	players.append_attribute("peak") = std::to_string(g_game().getPlayersRecord()).c_str();
+	players.append_attribute("peak") = std::to_string(snapshot.getPlayersRecord()).c_str();
 
 	pugi::xml_node monsters = tsqp.append_child("monsters");
-	monsters.append_attribute("total") = std::to_string(g_game().getMonstersOnline()).c_str();
+	monsters.append_attribute("total") = std::to_string(snapshot.getMonstersOnline()).c_str();
 
 	pugi::xml_node npcs = tsqp.append_child("npcs");
-	npcs.append_attribute("total") = std::to_string(g_game().getNpcsOnline()).c_str();
+	npcs.append_attribute("total") = std::to_string(snapshot.getNpcsOnline()).c_str();
 
 	pugi::xml_node rates = tsqp.append_child("rates");
 	rates.append_attribute("experience") = std::to_string(g_configManager().getNumber(RATE_EXPERIENCE, __FUNCTION__)).c_str();
@@ -145,31 +184,66 @@ void ProtocolStatus::sendStatusString() {
 	map.append_attribute("name") = g_configManager().getString(MAP_NAME, __FUNCTION__).c_str();
 	map.append_attribute("author") = g_configManager().getString(MAP_AUTHOR, __FUNCTION__).c_str();
 
-	uint32_t mapWidth, mapHeight;
-	g_game().getMapDimensions(mapWidth, mapHeight);
-	map.append_attribute("width") = std::to_string(mapWidth).c_str();
-	map.append_attribute("height") = std::to_string(mapHeight).c_str();
+	map.append_attribute("width") = std::to_string(snapshot.getMapWidth()).c_str();
+	map.append_attribute("height") = std::to_string(snapshot.getMapHeight()).c_str();
 
 	pugi::xml_node motd = tsqp.append_child("motd");
 	motd.text() = g_configManager().getString(SERVER_MOTD, __FUNCTION__).c_str();
 
 	std::ostringstream ss;
 	doc.save(ss, "", pugi::format_raw);
+	return ss.str();
+}
+
+void ProtocolStatus::sendInfo(const GameSnapshot &snapshot, uint16_t requestedInfo, const std::string &characterName) {
+	auto output = OutputMessagePool::getOutputMessage();
+
+	const uint16_t serverInfo = requestedInfo & ~(REQUEST_PLAYER_STATUS_INFO | REQUEST_SERVER_SOFTWARE_INFO);
+	std::unique_lock cacheLock(responseCacheMutex);
+	if (responseCache.time != snapshot.getTime()) {
+		responseCache = { snapshot.getTime() };
+	}
+	if (const auto it = responseCache.serverInfo.find(serverInfo);
+	    it != responseCache.serverInfo.end()) {
+		output->addBytes(it->second.c_str(), it->second.size());
+		cacheLock.unlock();
+	} else {
+		cacheLock.unlock();
+		// A fresh message, its body starts at the initial position
+		addServerInfo(output, snapshot, serverInfo);
+		std::string data(reinterpret_cast<const char*>(output->getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION), output->getLength());
+		cacheLock.lock();
+		if (responseCache.time == snapshot.getTime()) {
+			responseCache.serverInfo.try_emplace(serverInfo, std::move(data));
+		}
+		cacheLock.unlock();
+	}
+
+	if (requestedInfo & REQUEST_PLAYER_STATUS_INFO) {
+		output->addByte(0x22); // players info - online status info of a player
+		if (snapshot.getPlayerByName(characterName) != nullptr) {
+			output->addByte(0x01);
+		} else {
+			output->addByte(0x00);
+		}
+	}
 
-	std::string data = ss.str();
-	output->addBytes(data.c_str(), data.size());
+	if (requestedInfo & REQUEST_SERVER_SOFTWARE_INFO) {
+		output->addByte(0x23); // server software info
+		output->addString(ProtocolStatus::SERVER_NAME, "ProtocolStatus::sendInfo - ProtocolStatus::SERVER_NAME");
+		output->addString(ProtocolStatus::SERVER_VERSION, "ProtocolStatus::sendInfo - ProtocolStatus::SERVER_VERSION)");
+		output->addFormattedString("{}.{}", CLIENT_VERSION_UPPER, CLIENT_VERSION_LOWER);
+	}
 	send(output);
 	disconnect();
 }
 
-void ProtocolStatus::sendInfo(uint16_t requestedInfo, const std::string &characterName) {
-	auto output = OutputMessagePool::getOutputMessage();
-
+void ProtocolStatus::addServerInfo(const OutputMessage_ptr &output, const GameSnapshot &snapshot, uint16_t requestedInfo) {
 	if (requestedInfo & REQUEST_BASIC_SERVER_INFO) {
 		output->addByte(0x10);
 		output->addString(g_configManager().getString(ConfigKey_t::SERVER_NAME, __FUNCTION__), "ProtocolStatus::sendInfo - g_configManager().getString(stringConfig_t::SERVER_NAME)");
 		output->addString(g_configManager().getString(IP, __FUNCTION__), "ProtocolStatus::sendInfo - g_configManager().getString(IP)");
-		output->addString(std::to_string(g_configManager().getNumber(LOGIN_PORT, __FUNCTION__)), "ProtocolStatus::sendInfo - std::to_string(g_configManager().getNumber(LOGIN_PORT))");
+		output->addFormattedString("{}", g_configManager().getNumber(LOGIN_PORT, __FUNCTION__));
 	}
 
 	if (requestedInfo & REQUEST_OWNER_SERVER_INFO) {
@@ -188,47 +262,27 @@ void ProtocolStatus::sendInfo(uint16_t requestedInfo, const std::string &charact
 
 	if (requestedInfo & REQUEST_PLAYERS_INFO) {
 		output->addByte(0x20);
-		output->add<uint32_t>(static_cast<uint32_t>(g_game().getPlayersOnline()));
+		output->add<uint32_t>(static_cast<uint32_t>(snapshot.getPlayers().size()));
 		output->add<uint32_t>(g_configManager().getNumber(MAX_PLAYERS, __FUNCTION__));
-		output->add<uint32_t>(g_game().getPlayersRecord());
+		output->add<uint32_t>(snapshot.getPlayersRecord());
 	}
 
 	if (requestedInfo & REQUEST_MAP_INFO) {
 		output->addByte(0x30);
 		output->addString(g_configManager().getString(MAP_NAME, __FUNCTION__), "ProtocolStatus::sendInfo - g_configManager().getString(MAP_NAME)");
 		output->addString(g_configManager().getString(MAP_AUTHOR, __FUNCTION__), "ProtocolStatus::sendInfo - g_configManager().getString(MAP_AUTHOR)");
-		uint32_t mapWidth, mapHeight;
-		g_game().getMapDimensions(mapWidth, mapHeight);
-		output->add<uint16_t>(mapWidth);
-		output->add<uint16_t>(mapHeight);
+		output->add<uint16_t>(snapshot.getMapWidth());
+		output->add<uint16_t>(snapshot.getMapHeight());
 	}
 
 	if (requestedInfo & REQUEST_EXT_PLAYERS_INFO) {
 		output->addByte(0x21); // players info - online players list
 
-		const auto players = g_game().getPlayers();
+		const auto &players = snapshot.getPlayers();
 		output->add<uint32_t>(players.size());
-		for (const auto &it : players) {
-			output->addString(it.second->getName(), "ProtocolStatus::sendInfo - it.second->getName()");
-			output->add<uint32_t>(it.second->getLevel());
+		for (const auto &player : players) {
+			output->addString(player.name, "ProtocolStatus::sendInfo - player.name");
+			output->add<uint32_t>(player.level);
 		}
 	}
-
-	if (requestedInfo & REQUEST_PLAYER_STATUS_INFO) {
-		output->addByte(0x22); // players info - online status info of a player
-		if (g_game().getPlayerByName(characterName) != nullptr) {
-			output->addByte(0x01);
-		} else {
-			output->addByte(0x00);
-		}
-	}
-
-	if (requestedInfo & REQUEST_SERVER_SOFTWARE_INFO) {
-		output->addByte(0x23); // server software info
-		output->addString(ProtocolStatus::SERVER_NAME, "ProtocolStatus::sendInfo - ProtocolStatus::SERVER_NAME");
-		output->addString(ProtocolStatus::SERVER_VERSION, "ProtocolStatus::sendInfo - ProtocolStatus::SERVER_VERSION)");
-		output->addString(fmt::format("{}.{}", CLIENT_VERSION_UPPER, CLIENT_VERSION_LOWER), "ProtocolStatus::sendInfo - fmt::format(CLIENT_VERSION_UPPER, CLIENT_VERSION_LOWER)");
-	}
-	send(output);
-	disconnect();
 }
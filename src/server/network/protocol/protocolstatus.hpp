@@ -12,6 +12,8 @@
 #include "server/network/message/networkmessage.hpp"
 #include "server/network/protocol/protocol.hpp"
 
+class GameSnapshot;
+
 class ProtocolStatus final : public Protocol {
 public:
 	// static protocol information
@@ -27,8 +29,8 @@ public:
 
 	void onRecvFirstMessage(NetworkMessage &msg) override;
 
-	void sendStatusString();
-	void sendInfo(uint16_t requestedInfo, const std::string &characterName);
+	void sendStatusString(const GameSnapshot &snapshot);
+	void sendInfo(const GameSnapshot &snapshot, uint16_t requestedInfo, const std::string &characterName);
 
 	static const uint64_t start;
 
@@ -37,5 +39,22 @@ public:
 	static std::string SERVER_DEVELOPERS;
 
 private:
+	static void withSnapshot(std::function<void(const GameSnapshot &)> &&answer);
+
+	static std::string encodeStatusString(const GameSnapshot &snapshot);
+	// The info blocks that read the same for every query of a snapshot, all but the player status and software
+	static void addServerInfo(const OutputMessage_ptr &output, const GameSnapshot &snapshot, uint16_t requestedInfo);
+
+	// Encoded answers of the snapshot captured at `time`, shared by the queries until a newer one is used
+	struct ResponseCache {
+		int64_t time = -1;
+		std::string statusString;
+		phmap::flat_hash_map<uint16_t, std::string> serverInfo;
+	};
+	static ResponseCache responseCache;
+	static std::mutex responseCacheMutex;
+
 	static std::map<uint32_t, int64_t> ipConnectMap;
+	// Status requests can arrive on several network threads
+	static std::mutex ipConnectMapMutex;
 };
@@ -14,6 +14,7 @@
 #include "game/scheduling/dispatcher.hpp"
 #include "utils/tools.hpp"
 #include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
 
 Webhook::Webhook(ThreadPool &threadPool) :
 	threadPool(threadPool) {
@@ -46,7 +47,14 @@ void Webhook::run() {
 
 void Webhook::sendPayload(const std::string &payload, std::string url) {
 	std::scoped_lock lock { taskLock };
-	webhooks.push_back(std::make_shared<WebhookTask>(payload, url));
+	if (webhooks.size() >= MAX_QUEUED_WEBHOOKS) {
+		static LogRateLimiter droppedLogs;
+		g_metrics().addCounter("webhook_dropped", 1);
+		g_logger().warn(droppedLogs, "Webhook queue is full ({} messages), dropping message to {}", webhooks.size(), url);
+		return;
+	}
+
+	webhooks.push_back(std::make_shared<WebhookTask>(payload, std::move(url)));
 }
 
 void Webhook::sendMessage(const std::string &title, const std::string &message, int color, std::string url, bool embed) {
@@ -73,14 +81,18 @@ void Webhook::sendMessage(const std::string &message, std::string url) {
 	sendPayload(getPayload("", message, -1, false), url);
 }
 
-int Webhook::sendRequest(const char* url, const char* payload, std::string* response_body) const {
-	CURL* curl = curl_easy_init();
+int Webhook::sendRequest(const char* url, const char* payload, std::string* response_body) {
 	if (!curl) {
-		g_logger().error("Failed to send webhook message; curl_easy_init failed");
-		return -1;
+		curl = curl_easy_init();
+		if (!curl) {
+			g_logger().error("Failed to send webhook message; curl_easy_init failed");
+			return -1;
+		}
 	}
 
 	curl_easy_setopt(curl, CURLOPT_URL, url);
+	// Falls back to HTTP/1.1 when libcurl or the server doesn't speak HTTP/2
+	curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
 	curl_easy_setopt(curl, CURLOPT_SSLVERSION, CURL_SSLVERSION_TLSv1_2);
 	curl_easy_setopt(curl, CURLOPT_POST, 1L);
 	curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload);
@@ -93,17 +105,17 @@ int Webhook::sendRequest(const char* url, const char* payload, std::string* resp
 
 	if (res != CURLE_OK) {
 		g_logger().error("Failed to send webhook message with the error: {}", curl_easy_strerror(res));
+		// A broken connection is not reused
 		curl_easy_cleanup(curl);
+		curl = nullptr;
 
 		return -1;
 	}
 
-	int response_code;
-
+	long response_code = 0;
 	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
-	curl_easy_cleanup(curl);
 
-	return response_code;
+	return static_cast<int>(response_code);
 }
 
 size_t Webhook::writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
@@ -144,27 +156,38 @@ std::string Webhook::getPayload(const std::string &title, const std::string &mes
 }
 
 void Webhook::sendWebhook() {
-	std::scoped_lock lock { taskLock };
-	if (webhooks.empty()) {
+	// A slow endpoint can outlast the delay between runs, the next run then finds the worker busy
+	if (sending.exchange(true)) {
 		return;
 	}
 
-	auto task = webhooks.front();
+	std::shared_ptr<WebhookTask> task;
+	{
+		std::scoped_lock lock { taskLock };
+		if (webhooks.empty()) {
+			sending = false;
+			return;
+		}
+
+		task = webhooks.front();
+		webhooks.pop_front();
+	}
 
 	std::string response_body;
 	auto response_code = sendRequest(task->url.c_str(), task->payload.c_str(), &response_body);
 
-	if (response_code == -1) {
-		return;
-	}
-
-	if (response_code == 429 || response_code == 504) {
-		g_logger().warn("Webhook encountered error code {}, re-queueing task.", response_code);
+	if (response_code == -1 || response_code == 429 || response_code == 504) {
+		if (response_code != -1) {
+			g_logger().warn("Webhook encountered error code {}, re-queueing task.", response_code);
+		}
 
+		std::scoped_lock lock { taskLock };
+		webhooks.push_front(task);
+		sending = false;
 		return;
 	}
 
-	webhooks.pop_front();
+	sending = false;
 
 	if (response_code >= 300) {
 		g_logger().error(
@@ -19,6 +19,8 @@ struct WebhookTask {
 class Webhook {
 public:
 	static constexpr size_t DEFAULT_DELAY_MS = 1000;
+	// Messages past this many waiting ones are dropped, a webhook that keeps failing must not grow the queue forever
+	static constexpr size_t MAX_QUEUED_WEBHOOKS = 1000;
 
 	explicit Webhook(ThreadPool &threadPool);
 
@@ -35,14 +37,19 @@ public:
 	void sendMessage(const std::string &message, std::string url = "");
 
 private:
+	// Only guards the queue, never held while a request is in flight
 	std::mutex taskLock;
 	ThreadPool &threadPool;
 	std::deque<std::shared_ptr<WebhookTask>> webhooks;
 	curl_slist* headers = nullptr;
 
+	// Set while a worker sends, the handle is reused by the next one to keep the connection open
+	std::atomic_bool sending = false;
+	CURL* curl = nullptr;
+
 	void sendWebhook();
 
-	int sendRequest(const char* url, const char* payload, std::string* response_body) const;
+	int sendRequest(const char* url, const char* payload, std::string* response_body);
 	static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp);
 	std::string getPayload(const std::string &title, const std::string &message, int color, bool embed = true) const;
 };
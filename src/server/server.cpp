@@ -11,6 +11,7 @@
 
 #include "server/network/message/outputmessage.hpp"
 #include "server/server.hpp"
+#include "server/network/admin/admin_http.hpp"
 #include "config/configmanager.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "creatures/players/management/ban.hpp"
@@ -21,10 +22,54 @@ ServiceManager::~ServiceManager() {
 	} catch (std::exception &exception) {
 		g_logger().error("{} - Catch exception error: {}", __FUNCTION__, exception.what());
 	}
+	stopConnectionContexts();
 }
 
 void ServiceManager::die() {
 	io_service.stop();
+	stopConnectionContexts();
+}
+
+asio::io_service &ServiceManager::getConnectionContext() {
+	std::call_once(connectionContextsFlag, [this] { startConnectionContexts(); });
+	if (connectionContexts.empty()) {
+		return io_service;
+	}
+
+	return *connectionContexts[nextConnectionContext.fetch_add(1, std::memory_order_relaxed) % connectionContexts.size()];
+}
+
+void ServiceManager::startConnectionContexts() {
+	const auto threads = g_configManager().getNumber(NETWORK_THREADS, __FUNCTION__);
+	const auto &cpus = g_configManager().getString(NETWORK_CPUS, __FUNCTION__);
+	for (int32_t i = 0; i < threads; ++i) {
+		auto &context = connectionContexts.emplace_back(std::make_unique<asio::io_service>(1));
+		// Keeps the context running while it has no connection
+		connectionWork.emplace_back(asio::make_work_guard(*context));
+		connectionThreads.emplace_back([&context = *context, cpus] {
+			if (!cpus.empty() && !ThreadPool::pinCurrentThread(cpus)) {
+				g_logger().warn("[ServiceManager::startConnectionContexts] - Could not pin a network thread to cpus '{}'", cpus);
+			}
+			context.run();
+		});
+	}
+
+	if (threads > 0) {
+		g_logger().info("Network connections spread on {} threads", threads);
+	}
+}
+
+void ServiceManager::stopConnectionContexts() {
+	connectionWork.clear();
+	for (const auto &context : connectionContexts) {
+		context->stop();
+	}
+	for (auto &thread : connectionThreads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+	connectionThreads.clear();
 }
 
 void ServiceManager::run() {
@@ -35,9 +80,35 @@ void ServiceManager::run() {
 
 	assert(!running);
 	running = true;
+#if defined(ASIO_HAS_IO_URING)
+	g_logger().info("Network using io_uring");
+#endif
+	const auto &cpus = g_configManager().getString(NETWORK_CPUS, __FUNCTION__);
+	if (!cpus.empty()) {
+		if (ThreadPool::pinCurrentThread(cpus)) {
+			g_logger().info("Network threads pinned to cpus {}", cpus);
+		} else {
+			g_logger().warn("[{}] - Could not pin the network thread to cpus '{}'", __FUNCTION__, cpus);
+		}
+	}
+	sweepConnectionTimeouts();
 	io_service.run();
 }
 
+void ServiceManager::sweepConnectionTimeouts() {
+	timeoutTimer.expires_from_now(CONNECTION_TIMEOUT_SWEEP_INTERVAL);
+	timeoutTimer.async_wait([this](const std::error_code &error) {
+		if (error || !running) {
+			return;
+		}
+
+		if (const auto closed = ConnectionManager::getInstance().closeExpired(); closed > 0) {
+			g_metrics().addCounter("connection_timeouts", static_cast<double>(closed));
+		}
+		sweepConnectionTimeouts();
+	});
+}
+
 void ServiceManager::stop() {
 	if (!running) {
 		return;
@@ -55,12 +126,25 @@ void ServiceManager::stop() {
 
 	acceptors.clear();
 
+	if (adminHttp) {
+		io_service.post([adminHttp = std::move(adminHttp)] { adminHttp->close(); });
+	}
+
 	death_timer.expires_from_now(std::chrono::seconds(3));
 	death_timer.async_wait([this](const std::error_code &err) {
 		die();
 	});
 }
 
+bool ServiceManager::openAdminHttp(const std::string &address, uint16_t port) {
+	adminHttp = std::make_shared<AdminHttpServer>(io_service, *this);
+	if (!adminHttp->open(address, port)) {
+		adminHttp.reset();
+		return false;
+	}
+	return true;
+}
+
 ServicePort::~ServicePort() {
 	close();
 }
@@ -88,7 +172,7 @@ void ServicePort::accept() {
 		return;
 	}
 
-	auto connection = ConnectionManager::getInstance().createConnection(io_service, shared_from_this());
+	auto connection = ConnectionManager::getInstance().createConnection(manager.getConnectionContext(), shared_from_this());
 	acceptor->async_accept(connection->getSocket(), [self = shared_from_this(), connection](const std::error_code &error) { self->onAccept(connection, error); });
 }
 
@@ -99,16 +183,17 @@ void ServicePort::onAccept(Connection_ptr connection, const std::error_code &err
 		}
 
 		auto remote_ip = connection->getIP();
-		if (remote_ip != 0 && inject<Ban>().acceptConnection(remote_ip)) {
-			Service_ptr service = services.front();
-			if (service->is_single_socket()) {
+		const bool accepted = remote_ip != 0 && inject<Ban>().acceptConnection(remote_ip);
+		// The connection may run on another context, start it from there
+		asio::post(connection->getSocket().get_executor(), [connection, accepted, service = services.front()] {
+			if (!accepted) {
+				connection->close(FORCE_CLOSE);
+			} else if (service->is_single_socket()) {
 				connection->accept(service->make_protocol(connection));
 			} else {
 				connection->acceptInternal();
 			}
-		} else {
-			connection->close(FORCE_CLOSE);
-		}
+		});
 
 		accept();
 	} else if (error != asio::error::operation_aborted) {
@@ -14,7 +14,9 @@
 #include "server/network/connection/connection.hpp"
 #include "server/signals.hpp"
 
+class AdminHttpServer;
 class Protocol;
+class ServiceManager;
 
 class ServiceBase {
 public:
@@ -49,8 +51,8 @@ public:
 
 class ServicePort : public std::enable_shared_from_this<ServicePort> {
 public:
-	explicit ServicePort(asio::io_service &init_io_service) :
-		io_service(init_io_service) { }
+	explicit ServicePort(asio::io_service &init_io_service, ServiceManager &init_manager) :
+		io_service(init_io_service), manager(init_manager) { }
 	~ServicePort();
 
 	// non-copyable
@@ -73,6 +75,7 @@ private:
 	void accept();
 
 	asio::io_service &io_service;
+	ServiceManager &manager;
 	std::unique_ptr<asio::ip::tcp::acceptor> acceptor;
 	std::vector<Service_ptr> services;
 
@@ -95,19 +98,43 @@ public:
 	template <typename ProtocolType>
 	bool add(uint16_t port);
 
+	/**
+	 * @brief Opens the read-only admin HTTP endpoint, closed with the other acceptors.
+	 */
+	bool openAdminHttp(const std::string &address, uint16_t port);
+
 	bool is_running() const {
 		return acceptors.empty() == false;
 	}
 
+	/**
+	 * @brief The context a new connection runs on.
+	 * With networkThreads, connections are spread round-robin over a pool of
+	 * contexts, each run by its own thread; the acceptors stay on the main one.
+	 */
+	asio::io_service &getConnectionContext();
+
 private:
 	void die();
+	// Closes the connections past their deadlines once a second, while running
+	void sweepConnectionTimeouts();
+	void startConnectionContexts();
+	void stopConnectionContexts();
 
 	phmap::flat_hash_map<uint16_t, ServicePort_ptr> acceptors;
+	std::shared_ptr<AdminHttpServer> adminHttp;
 
 	asio::io_service io_service;
 	Signals signals { io_service };
 	asio::high_resolution_timer death_timer { io_service };
+	asio::high_resolution_timer timeoutTimer { io_service };
 	bool running = false;
+
+	std::once_flag connectionContextsFlag;
+	std::vector<std::unique_ptr<asio::io_service>> connectionContexts;
+	std::vector<asio::executor_work_guard<asio::io_service::executor_type>> connectionWork;
+	std::vector<std::thread> connectionThreads;
+	std::atomic<size_t> nextConnectionContext = 0;
 };
 
 template <typename ProtocolType>
@@ -124,7 +151,7 @@ bool ServiceManager::add(uint16_t port) {
 	auto foundServicePort = acceptors.find(port);
 
 	if (foundServicePort == acceptors.end()) {
-		service_port = std::make_shared<ServicePort>(io_service);
+		service_port = std::make_shared<ServicePort>(io_service, *this);
 		service_port->open(port);
 		acceptors[port] = service_port;
 	} else {
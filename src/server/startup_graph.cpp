@@ -0,0 +1,138 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server/startup_graph.hpp"
+
+namespace {
+	int64_t elapsedMs(std::chrono::steady_clock::time_point since) {
+		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - since).count();
+	}
+}
+
+void StartupGraph::add(std::string name, std::initializer_list<std::string_view> dependencies, Thread thread, std::function<void()> load) {
+	Phase phase { std::move(name), {}, thread, std::move(load) };
+	for (const auto &dependency : dependencies) {
+		const auto it = std::ranges::find_if(phases, [&dependency](const Phase &added) {
+			return added.name == dependency;
+		});
+		if (it == phases.end()) {
+			throw std::invalid_argument(fmt::format("Startup phase '{}' depends on '{}', which is not added before it", phase.name, dependency));
+		}
+		phase.dependencies.emplace_back(static_cast<size_t>(std::distance(phases.begin(), it)));
+	}
+	phases.emplace_back(std::move(phase));
+}
+
+void StartupGraph::execute(Phase &phase) {
+	phase.startMs = elapsedMs(begin);
+	const auto start = std::chrono::steady_clock::now();
+	phase.load();
+	phase.durationMs = elapsedMs(start);
+}
+
+bool StartupGraph::isDone(const Phase &phase) const {
+	return phase.started && phase.done.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void StartupGraph::startBackground(size_t index) {
+	auto &phase = phases[index];
+	phase.started = true;
+	// The dependencies on other background phases are waited on its own thread
+	std::vector<std::shared_future<void>> dependencies;
+	for (const auto dependency : phase.dependencies) {
+		dependencies.emplace_back(phases[dependency].done);
+	}
+	phase.done = std::async(std::launch::async, [this, &phase, dependencies = std::move(dependencies)] {
+		for (const auto &dependency : dependencies) {
+			dependency.get();
+		}
+		execute(phase);
+	}).share();
+}
+
+void StartupGraph::run(bool parallel) {
+	begin = std::chrono::steady_clock::now();
+	ranParallel = parallel;
+
+	if (!parallel) {
+		for (auto &phase : phases) {
+			execute(phase);
+		}
+		totalMs = elapsedMs(begin);
+		return;
+	}
+
+	// Starts the background phases whose dispatcher dependencies are done
+	const auto startReady = [this] {
+		for (size_t index = 0; index < phases.size(); ++index) {
+			auto &phase = phases[index];
+			if (phase.thread != Thread::Background || phase.started) {
+				continue;
+			}
+			const bool ready = std::ranges::all_of(phase.dependencies, [this](size_t dependency) {
+				const auto &needed = phases[dependency];
+				return needed.thread == Thread::Background ? needed.started : isDone(needed);
+			});
+			if (ready) {
+				startBackground(index);
+			}
+		}
+	};
+
+	// A failure is only thrown once the background threads stopped using the graph
+	const auto waitAll = [this] {
+		for (const auto &phase : phases) {
+			if (phase.started) {
+				phase.done.wait();
+			}
+		}
+	};
+
+	try {
+		startReady();
+		for (auto &phase : phases) {
+			if (phase.thread != Thread::Dispatcher) {
+				continue;
+			}
+			for (const auto dependency : phase.dependencies) {
+				phases[dependency].done.get();
+			}
+
+			std::promise<void> promise;
+			phase.done = promise.get_future().share();
+			phase.started = true;
+			execute(phase);
+			promise.set_value();
+			startReady();
+		}
+
+		for (const auto &phase : phases) {
+			phase.done.get();
+		}
+	} catch (...) {
+		waitAll();
+		throw;
+	}
+	totalMs = elapsedMs(begin);
+}
+
+std::string StartupGraph::getReport() const {
+	int64_t sumMs = 0;
+	std::string report;
+	for (const auto &phase : phases) {
+		sumMs += phase.durationMs;
+		report += fmt::format(
+			"\n{:<20} {:>6} ms (from {} ms{})",
+			phase.name, phase.durationMs, phase.startMs, ranParallel && phase.thread == Thread::Background ? ", background" : ""
+		);
+	}
+	return fmt::format("Startup took {} ms, {} ms of phases:{}", totalMs, sumMs, report);
+}
@@ -0,0 +1,60 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * The startup phases and what each one needs loaded before it.
+ *
+ * The phases that touch the Lua state or the game run on the dispatcher
+ * thread in the order they were added. The others are marked Background:
+ * when the graph runs in parallel, each of them starts on its own thread
+ * as soon as its dependencies are done, next to the dispatcher phases.
+ * Otherwise every phase runs in order on the calling thread. Either way
+ * each phase is timed for the report.
+ */
+class StartupGraph {
+public:
+	enum class Thread : uint8_t {
+		Dispatcher,
+		Background,
+	};
+
+	/**
+	 * @brief Adds a phase, its dependencies must have been added before.
+	 * @param load Throws to fail the startup, the exception reaches run.
+	 */
+	void add(std::string name, std::initializer_list<std::string_view> dependencies, Thread thread, std::function<void()> load);
+
+	void run(bool parallel);
+
+	std::string getReport() const;
+
+private:
+	struct Phase {
+		std::string name;
+		std::vector<size_t> dependencies;
+		Thread thread = Thread::Dispatcher;
+		std::function<void()> load;
+		std::shared_future<void> done;
+		bool started = false;
+		// Milliseconds since the start of the run
+		int64_t startMs = 0;
+		int64_t durationMs = 0;
+	};
+
+	void execute(Phase &phase);
+	void startBackground(size_t index);
+	bool isDone(const Phase &phase) const;
+
+	std::vector<Phase> phases;
+	std::chrono::steady_clock::time_point begin;
+	int64_t totalMs = 0;
+	bool ranParallel = false;
+};
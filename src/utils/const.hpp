@@ -23,6 +23,12 @@ static constexpr int32_t CHANNEL_PRIVATE = 0xFFFF;
 
 // This is in miliseconds
 static constexpr int32_t EVENT_IMBUEMENT_INTERVAL = 1000;
+static constexpr int32_t EVENT_MAP_TILES_INTERVAL = 60000;
+static constexpr int32_t EVENT_ITEM_POOL_METRICS_INTERVAL = 60000;
+static constexpr int32_t EVENT_MEMORY_METRICS_INTERVAL = 60000;
+static constexpr int32_t EVENT_TRAFFIC_METRICS_INTERVAL = 60000;
+static constexpr int32_t EVENT_DECAYINTERVAL = 250;
+static constexpr int32_t EVENT_DECAY_BUCKETS = 4;
 static constexpr uint8_t IMBUEMENT_MAX_TIER = 3;
 
 static constexpr int32_t STORAGEVALUE_EMOTE = 30008;
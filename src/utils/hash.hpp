@@ -17,19 +17,19 @@ namespace stdext {
 		seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 	}
 
-	void hash_combine(size_t &seed, uint64_t v) {
+	inline void hash_combine(size_t &seed, uint64_t v) {
 		hash_union(seed, hash_int(v));
 	}
 
-	void hash_combine(size_t &seed, uint32_t v) {
+	inline void hash_combine(size_t &seed, uint32_t v) {
 		hash_union(seed, hash_int(v));
 	}
 
-	void hash_combine(size_t &seed, uint16_t v) {
+	inline void hash_combine(size_t &seed, uint16_t v) {
 		hash_union(seed, hash_int(v));
 	}
 
-	void hash_combine(size_t &seed, uint8_t v) {
+	inline void hash_combine(size_t &seed, uint8_t v) {
 		hash_union(seed, hash_int(v));
 	}
 
@@ -0,0 +1,74 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Set kept contiguous for random picks, with constant time insert, erase
+ * and lookup. Erasing moves the last value into the freed place, so the
+ * order is not kept.
+ */
+template <typename T>
+class IndexedSet {
+public:
+	bool insert(const T &value) {
+		if (!indexes.try_emplace(value, values.size()).second) {
+			return false;
+		}
+		values.push_back(value);
+		return true;
+	}
+
+	bool erase(const T &value) {
+		const auto it = indexes.find(value);
+		if (it == indexes.end()) {
+			return false;
+		}
+
+		const size_t index = it->second;
+		indexes.erase(it);
+		if (index != values.size() - 1) {
+			values[index] = std::move(values.back());
+			indexes[values[index]] = index;
+		}
+		values.pop_back();
+		return true;
+	}
+
+	bool contains(const T &value) const {
+		return indexes.contains(value);
+	}
+
+	const T &at(size_t index) const {
+		return values.at(index);
+	}
+
+	size_t size() const {
+		return values.size();
+	}
+	bool empty() const {
+		return values.empty();
+	}
+
+	void clear() {
+		values.clear();
+		indexes.clear();
+	}
+
+	auto begin() const {
+		return values.cbegin();
+	}
+	auto end() const {
+		return values.cend();
+	}
+
+private:
+	std::vector<T> values;
+	phmap::flat_hash_map<T, size_t> indexes;
+};
@@ -0,0 +1,89 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * xoshiro256++, a UniformRandomBitGenerator with 32 bytes of state that is
+ * stepped with a few shifts and xors, cheap enough to keep one per thread.
+ * The state is filled from the seed with splitmix64, so any seed, zero
+ * included, gives a usable generator.
+ */
+class RandomGenerator {
+public:
+	using result_type = uint64_t;
+
+	RandomGenerator() {
+		seed(0);
+	}
+	explicit RandomGenerator(uint64_t value) {
+		seed(value);
+	}
+
+	void seed(uint64_t value) {
+		for (auto &word : state) {
+			value += 0x9E3779B97F4A7C15ULL;
+			uint64_t mixed = value;
+			mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+			word = mixed ^ (mixed >> 31);
+		}
+	}
+
+	static constexpr result_type min() {
+		return 0;
+	}
+	static constexpr result_type max() {
+		return std::numeric_limits<result_type>::max();
+	}
+
+	result_type operator()() {
+		const uint64_t result = std::rotl(state[0] + state[3], 23) + state[0];
+		const uint64_t shifted = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= shifted;
+		state[3] = std::rotl(state[3], 45);
+		return result;
+	}
+
+	/**
+	 * @brief Returns a number in [0, bound), without the bias of a modulo.
+	 * Lemire's multiply and shift, the rare values past the last whole multiple of bound are drawn again.
+	 */
+	uint32_t nextBelow(uint32_t bound) {
+		uint64_t product = static_cast<uint64_t>(nextUint32()) * bound;
+		auto low = static_cast<uint32_t>(product);
+		if (low < bound) {
+			const uint32_t threshold = (0u - bound) % bound;
+			while (low < threshold) {
+				product = static_cast<uint64_t>(nextUint32()) * bound;
+				low = static_cast<uint32_t>(product);
+			}
+		}
+		return static_cast<uint32_t>(product >> 32);
+	}
+
+	uint32_t nextUint32() {
+		// The high bits are the strongest ones
+		return static_cast<uint32_t>(operator()() >> 32);
+	}
+
+	/**
+	 * @brief Returns a number in [0, 1), from the 53 high bits.
+	 */
+	double nextDouble() {
+		return static_cast<double>(operator()() >> 11) * 0x1.0p-53;
+	}
+
+private:
+	std::array<uint64_t, 4> state {};
+};
@@ -0,0 +1,57 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "utils/stringpool.hpp"
+
+StringPool &StringPool::getInstance() {
+	// Never destroyed, handles can be released by other statics during shutdown
+	static auto* pool = new StringPool();
+	return *pool;
+}
+
+StringPool::Handle StringPool::intern(std::string_view value) {
+	static const Handle empty = std::make_shared<const std::string>();
+	if (value.empty()) {
+		return empty;
+	}
+
+	std::scoped_lock lock(mutex);
+	if (const auto it = strings.find(value); it != strings.end()) {
+		if (auto handle = it->second.handle.lock()) {
+			return handle;
+		}
+
+		// The last handle is gone but its release is still waiting for the lock
+		strings.erase(it);
+	}
+
+	Handle handle(new std::string(value), [this](const std::string* pooled) {
+		release(pooled);
+	});
+	strings.emplace(std::string_view(*handle), Entry { handle.get(), handle });
+	return handle;
+}
+
+size_t StringPool::size() const {
+	std::scoped_lock lock(mutex);
+	return strings.size();
+}
+
+void StringPool::release(const std::string* value) {
+	{
+		std::scoped_lock lock(mutex);
+		// A new copy may already be pooled under the same text
+		if (const auto it = strings.find(std::string_view(*value)); it != strings.end() && it->second.value == value) {
+			strings.erase(it);
+		}
+	}
+	delete value;
+}
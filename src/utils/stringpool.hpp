@@ -0,0 +1,48 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Process wide pool of immutable strings.
+ *
+ * Equal strings interned anywhere share one copy, held by reference counted
+ * handles; the copy leaves the pool when its last handle is dropped. Safe to
+ * use from any thread.
+ */
+class StringPool {
+public:
+	using Handle = std::shared_ptr<const std::string>;
+
+	StringPool() = default;
+
+	// Ensures that we don't accidentally copy it
+	StringPool(const StringPool &) = delete;
+	StringPool &operator=(const StringPool &) = delete;
+
+	static StringPool &getInstance();
+
+	Handle intern(std::string_view value);
+
+	size_t size() const;
+
+private:
+	struct Entry {
+		const std::string* value;
+		std::weak_ptr<const std::string> handle;
+	};
+
+	void release(const std::string* value);
+
+	// Keyed by the pooled copy itself
+	phmap::flat_hash_map<std::string_view, Entry> strings;
+	mutable std::mutex mutex;
+};
+
+constexpr auto g_stringPool = StringPool::getInstance;
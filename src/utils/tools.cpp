@@ -389,36 +389,102 @@ IntegerVector vectorAtoi(const StringVector &stringVector) {
 	return returnVector;
 }
 
-std::mt19937 &getRandomGenerator() {
-	static std::random_device rd;
-	static std::mt19937 generator(rd());
-	return generator;
+namespace {
+	// Bumped by seedRandomGenerators, a thread whose generator was seeded before reseeds on its next draw
+	std::atomic<uint32_t> randomSeedEpoch = 0;
+	std::atomic<bool> randomSeedFixed = false;
+	std::atomic<uint64_t> randomSeed = 0;
+	// Threads seeded from the fixed seed since it was set, each one gets its own stream
+	std::atomic<uint64_t> randomSeededThreads = 0;
+
+	struct ThreadRandomGenerator {
+		RandomGenerator generator;
+		uint32_t epoch = std::numeric_limits<uint32_t>::max();
+	};
+
+	uint64_t nextThreadSeed() {
+		if (randomSeedFixed.load(std::memory_order_acquire)) {
+			return randomSeed.load(std::memory_order_relaxed) + randomSeededThreads.fetch_add(1, std::memory_order_relaxed);
+		}
+		std::random_device device;
+		return (static_cast<uint64_t>(device()) << 32) | device();
+	}
+
+	int32_t uniformRoll(RandomGenerator &generator, int32_t minNumber, int32_t maxNumber) {
+		const auto range = static_cast<uint64_t>(static_cast<int64_t>(maxNumber) - minNumber) + 1;
+		if (range > std::numeric_limits<uint32_t>::max()) {
+			// The whole int32_t range, any 32 bits will do
+			return static_cast<int32_t>(generator.nextUint32());
+		}
+		return static_cast<int32_t>(minNumber + static_cast<int64_t>(generator.nextBelow(static_cast<uint32_t>(range))));
+	}
+
+	int32_t normalRoll(RandomGenerator &generator, int32_t minNumber, int32_t maxNumber) {
+		thread_local std::normal_distribution<float> normalRand(0.5f, 0.25f);
+		float v;
+		do {
+			v = normalRand(generator);
+		} while (v < 0.0 || v > 1.0);
+
+		auto &&[a, b] = std::minmax(minNumber, maxNumber);
+		return a + std::lround(v * (b - a));
+	}
+}
+
+RandomGenerator &getRandomGenerator() {
+	thread_local ThreadRandomGenerator local;
+	if (const auto epoch = randomSeedEpoch.load(std::memory_order_acquire); local.epoch != epoch) {
+		local.epoch = epoch;
+		local.generator.seed(nextThreadSeed());
+	}
+	return local.generator;
+}
+
+void seedRandomGenerators(uint64_t seed) {
+	randomSeed = seed;
+	randomSeededThreads = 0;
+	randomSeedFixed.store(true, std::memory_order_release);
+	randomSeedEpoch.fetch_add(1, std::memory_order_acq_rel);
+	// The caller takes the first stream
+	getRandomGenerator();
 }
 
 int32_t uniform_random(int32_t minNumber, int32_t maxNumber) {
-	static std::uniform_int_distribution<int32_t> uniformRand;
 	if (minNumber == maxNumber) {
 		return minNumber;
 	} else if (minNumber > maxNumber) {
 		std::swap(minNumber, maxNumber);
 	}
-	return uniformRand(getRandomGenerator(), std::uniform_int_distribution<int32_t>::param_type(minNumber, maxNumber));
+	return uniformRoll(getRandomGenerator(), minNumber, maxNumber);
 }
 
 int32_t normal_random(int32_t minNumber, int32_t maxNumber) {
-	static std::normal_distribution<float> normalRand(0.5f, 0.25f);
-	float v;
-	do {
-		v = normalRand(getRandomGenerator());
-	} while (v < 0.0 || v > 1.0);
-
-	auto &&[a, b] = std::minmax(minNumber, maxNumber);
-	return a + std::lround(v * (b - a));
+	return normalRoll(getRandomGenerator(), minNumber, maxNumber);
 }
 
 bool boolean_random(double probability /* = 0.5*/) {
-	static std::bernoulli_distribution booleanRand;
-	return booleanRand(getRandomGenerator(), std::bernoulli_distribution::param_type(probability));
+	return getRandomGenerator().nextDouble() < probability;
+}
+
+void uniform_random_fill(std::span<int32_t> values, int32_t minNumber, int32_t maxNumber) {
+	if (minNumber == maxNumber) {
+		std::ranges::fill(values, minNumber);
+		return;
+	} else if (minNumber > maxNumber) {
+		std::swap(minNumber, maxNumber);
+	}
+
+	auto &generator = getRandomGenerator();
+	for (auto &value : values) {
+		value = uniformRoll(generator, minNumber, maxNumber);
+	}
+}
+
+void normal_random_fill(std::span<int32_t> values, int32_t minNumber, int32_t maxNumber) {
+	auto &generator = getRandomGenerator();
+	for (auto &value : values) {
+		value = normalRoll(generator, minNumber, maxNumber);
+	}
 }
 
 void trimString(std::string &str) {
@@ -14,6 +14,7 @@
 #include "enums/item_attribute.hpp"
 #include "game/movement/position.hpp"
 #include "enums/object_category.hpp"
+#include "utils/random_generator.hpp"
 
 namespace pugi {
 	class xml_parse_result;
@@ -55,10 +56,21 @@ constexpr bool hasBitSet(uint32_t flag, uint32_t flags) {
 	return (flags & flag) != 0;
 }
 
-std::mt19937 &getRandomGenerator();
+/**
+ * @brief Returns the generator of the calling thread, each thread draws from its own.
+ */
+RandomGenerator &getRandomGenerator();
+/**
+ * @brief Makes every thread reseed from the seed on its next draw, the caller first and the others in the order they draw.
+ * For the benchmark and replay runs, the rolls are repeatable as long as the threads draw in the same order.
+ */
+void seedRandomGenerators(uint64_t seed);
 int32_t uniform_random(int32_t minNumber, int32_t maxNumber);
 int32_t normal_random(int32_t minNumber, int32_t maxNumber);
 bool boolean_random(double probability = 0.5);
+// Fill values with rolls like the functions above, reaching the generator once for all of them
+void uniform_random_fill(std::span<int32_t> values, int32_t minNumber, int32_t maxNumber);
+void normal_random_fill(std::span<int32_t> values, int32_t minNumber, int32_t maxNumber);
 
 BedItemPart_t getBedPart(const std::string_view string);
 Direction getDirection(const std::string &string);
@@ -11,100 +11,31 @@
 
 #include "utils/wildcardtree.hpp"
 
-std::shared_ptr<WildcardTreeNode> WildcardTreeNode::getChild(char ch) {
-	auto it = children.find(ch);
-	if (it == children.end()) {
-		return nullptr;
+void WildcardTree::insert(const std::string &str) {
+	const auto it = std::ranges::lower_bound(names, str);
+	if (it == names.end() || *it != str) {
+		names.insert(it, str);
 	}
-	return it->second;
 }
 
-std::shared_ptr<WildcardTreeNode> WildcardTreeNode::getChild(char ch) const {
-	auto it = children.find(ch);
-	if (it == children.end()) {
-		return nullptr;
+void WildcardTree::remove(const std::string &str) {
+	const auto it = std::ranges::lower_bound(names, str);
+	if (it != names.end() && *it == str) {
+		names.erase(it);
 	}
-	return it->second;
 }
 
-std::shared_ptr<WildcardTreeNode> WildcardTreeNode::addChild(char ch, bool breakp) {
-	std::shared_ptr<WildcardTreeNode> child = getChild(ch);
-	if (child) {
-		if (breakp && !child->breakpoint) {
-			child->breakpoint = true;
-		}
-	} else {
-		auto pair = children.emplace(std::piecewise_construct, std::forward_as_tuple(ch), std::forward_as_tuple(std::make_shared<WildcardTreeNode>(breakp)));
-		child = pair.first->second;
+ReturnValue WildcardTree::findOne(const std::string &query, std::string &result) const {
+	// The names starting with the query follow the first one not below it
+	const auto it = std::ranges::lower_bound(names, query);
+	if (it == names.end() || !it->starts_with(query)) {
+		return RETURNVALUE_PLAYERWITHTHISNAMEISNOTONLINE;
 	}
-	return child;
-}
-
-void WildcardTreeNode::insert(const std::string &str) {
-	std::shared_ptr<WildcardTreeNode> cur = static_self_cast<WildcardTreeNode>();
 
-	size_t length = str.length() - 1;
-	for (size_t pos = 0; pos < length; ++pos) {
-		cur = cur->addChild(str[pos], false);
+	if (const auto next = std::next(it); next != names.end() && next->starts_with(query)) {
+		return RETURNVALUE_NAMEISTOOAMBIGUOUS;
 	}
 
-	cur->addChild(str[length], true);
-}
-
-void WildcardTreeNode::remove(const std::string &str) {
-	std::shared_ptr<WildcardTreeNode> cur = static_self_cast<WildcardTreeNode>();
-
-	std::stack<std::shared_ptr<WildcardTreeNode>> path;
-	path.push(cur);
-	size_t len = str.length();
-	for (size_t pos = 0; pos < len; ++pos) {
-		cur = cur->getChild(str[pos]);
-		if (!cur) {
-			return;
-		}
-		path.push(cur);
-	}
-
-	cur->breakpoint = false;
-
-	do {
-		cur = path.top();
-		path.pop();
-
-		if (!cur->children.empty() || cur->breakpoint || path.empty()) {
-			break;
-		}
-
-		cur = path.top();
-
-		auto it = cur->children.find(str[--len]);
-		if (it != cur->children.end()) {
-			cur->children.erase(it);
-		}
-	} while (true);
-}
-
-ReturnValue WildcardTreeNode::findOne(const std::string &query, std::string &result) const {
-	auto cur = static_self_cast<const WildcardTreeNode>();
-	for (char pos : query) {
-		cur = cur->getChild(pos);
-		if (!cur) {
-			return RETURNVALUE_PLAYERWITHTHISNAMEISNOTONLINE;
-		}
-	}
-
-	result = query;
-
-	do {
-		size_t size = cur->children.size();
-		if (size == 0) {
-			return RETURNVALUE_NOERROR;
-		} else if (size > 1 || cur->breakpoint) {
-			return RETURNVALUE_NAMEISTOOAMBIGUOUS;
-		}
-
-		auto it = cur->children.begin();
-		result += it->first;
-		cur = it->second;
-	} while (true);
+	result = *it;
+	return RETURNVALUE_NOERROR;
 }
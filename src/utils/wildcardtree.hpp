@@ -11,26 +11,28 @@
 
 #include "declarations.hpp"
 
-class WildcardTreeNode : public SharedObject {
+/**
+ * Names of the online players, sorted in one vector.
+ * A wildcard query is a binary search for the range of names starting with it,
+ * instead of a walk through one allocated node per character.
+ */
+class WildcardTree {
 public:
-	explicit WildcardTreeNode(bool initBreakpoint) :
-		breakpoint(initBreakpoint) { }
-	WildcardTreeNode(WildcardTreeNode &&other) noexcept = default;
+	WildcardTree() = default;
 
 	// non-copyable
-	WildcardTreeNode(const WildcardTreeNode &) = delete;
-	WildcardTreeNode &operator=(const WildcardTreeNode &) = delete;
-
-	std::shared_ptr<WildcardTreeNode> getChild(char ch);
-	std::shared_ptr<WildcardTreeNode> getChild(char ch) const;
-	std::shared_ptr<WildcardTreeNode> addChild(char ch, bool breakpoint);
+	WildcardTree(const WildcardTree &) = delete;
+	WildcardTree &operator=(const WildcardTree &) = delete;
 
 	void insert(const std::string &str);
 	void remove(const std::string &str);
 
+	/**
+	 * @brief Completes the query to the only name starting with it.
+	 * @return RETURNVALUE_NAMEISTOOAMBIGUOUS when several names start with it.
+	 */
 	ReturnValue findOne(const std::string &query, std::string &result) const;
 
 private:
-	std::map<char, std::shared_ptr<WildcardTreeNode>> children;
-	bool breakpoint;
+	std::vector<std::string> names;
 };
@@ -0,0 +1,351 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "config/configmanager.hpp"
+#include "creatures/monsters/monster.hpp"
+#include "creatures/monsters/monsters.hpp"
+#include "creatures/players/player.hpp"
+#include "creatures/players/vocations/vocation.hpp"
+#include "game/game.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "items/tile.hpp"
+#include "lib/thread/thread_pool.hpp"
+#include "lua/scripts/lua_environment.hpp"
+#include "map/spectators.hpp"
+
+/**
+ * Headless load benchmark of the game loop.
+ *
+ * Loads the items and the vocations of the core folder, builds a flat
+ * synthetic map and fills it with players without client, driven by bots
+ * that walk, talk, use items and fight, and with monsters that chase them.
+ * Every tick runs the bots and Game::checkCreatures on the dispatcher, and
+ * the report gives the tick time percentiles, the resident memory and how
+ * many players would have been told about the bots' actions, which is what
+ * the protocol would have sent. The database and the scripts are not
+ * loaded, so neither is measured. Runs from the folder of config.lua:
+ *
+ * canary_bench [--players 200] [--monsters 400] [--ticks 600] [--size 128] [--interval 100] [--seed 1] [--ground 4526] [--config config.lua]
+ */
+
+namespace {
+	constexpr uint16_t ORIGIN = 1000;
+	constexpr uint8_t FLOOR = 7;
+	constexpr uint16_t BOT_VOCATION = 4;
+	const std::string MONSTER_NAME = "Benchmark Dummy";
+
+	struct Options {
+		uint32_t players = 200;
+		uint32_t monsters = 400;
+		uint32_t ticks = 600;
+		uint16_t size = 128;
+		uint32_t interval = EVENT_CHECK_CREATURE_INTERVAL;
+		uint32_t seed = 1;
+		uint16_t ground = 4526;
+		std::string config = "config.lua";
+	};
+
+	bool parseOptions(int argc, char* argv[], Options &options) {
+		for (int i = 1; i + 1 < argc; i += 2) {
+			const std::string_view name = argv[i];
+			const std::string value = argv[i + 1];
+			if (name == "--players") {
+				options.players = static_cast<uint32_t>(std::stoul(value));
+			} else if (name == "--monsters") {
+				options.monsters = static_cast<uint32_t>(std::stoul(value));
+			} else if (name == "--ticks") {
+				options.ticks = std::max<uint32_t>(1, static_cast<uint32_t>(std::stoul(value)));
+			} else if (name == "--size") {
+				options.size = static_cast<uint16_t>(std::clamp<unsigned long>(std::stoul(value), 16, 2048));
+			} else if (name == "--interval") {
+				options.interval = static_cast<uint32_t>(std::stoul(value));
+			} else if (name == "--seed") {
+				options.seed = static_cast<uint32_t>(std::stoul(value));
+			} else if (name == "--ground") {
+				options.ground = static_cast<uint16_t>(std::stoul(value));
+			} else if (name == "--config") {
+				options.config = value;
+			} else {
+				return false;
+			}
+		}
+		return argc % 2 == 1;
+	}
+
+	int64_t getResidentKb() {
+#ifdef __linux__
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		while (std::getline(status, line)) {
+			if (line.starts_with("VmRSS:")) {
+				return std::stoll(line.substr(6));
+			}
+		}
+#endif
+		return 0;
+	}
+
+	double percentile(const std::vector<int64_t> &sorted, double rank) {
+		if (sorted.empty()) {
+			return 0;
+		}
+		const auto index = static_cast<size_t>(rank * static_cast<double>(sorted.size() - 1));
+		return static_cast<double>(sorted[index]) / 1000000.0;
+	}
+
+	class SyntheticLoad {
+	public:
+		explicit SyntheticLoad(const Options &options) :
+			options(options), random(options.seed) { }
+
+		bool load() {
+			g_configManager().setConfigFileLua(std::filesystem::exists(options.config) ? options.config : options.config + ".dist");
+			if (!g_configManager().load()) {
+				g_logger().error("[canary_bench] - Failed to load {}", g_configManager().getConfigFileLua());
+				return false;
+			}
+
+			if (!g_luaEnvironment().getLuaState()) {
+				g_luaEnvironment().initState();
+			}
+
+			const auto &coreFolder = g_configManager().getString(CORE_DIRECTORY, __FUNCTION__);
+			if (g_game().loadAppearanceProtobuf(coreFolder + "/items/appearances.dat") != ERROR_NONE || !Item::items.loadFromXml()
+			    || !g_vocations().loadFromXml() || !g_game().groups.load()) {
+				g_logger().error("[canary_bench] - Failed to load the items, vocations or groups of {}", coreFolder);
+				return false;
+			}
+
+			// Seeds the generators used by the engine, the runs are repeatable
+			seedRandomGenerators(options.seed);
+			return true;
+		}
+
+		bool populate() {
+			if (!Item::items.getItemType(options.ground).isGroundTile()) {
+				g_logger().error("[canary_bench] - Item {} is not a ground", options.ground);
+				return false;
+			}
+
+			for (uint16_t x = 0; x < options.size; ++x) {
+				for (uint16_t y = 0; y < options.size; ++y) {
+					const auto tile = std::make_shared<DynamicTile>(ORIGIN + x, ORIGIN + y, FLOOR);
+					tile->internalAddThing(Item::CreateItem(options.ground));
+					g_game().map.setTile(ORIGIN + x, ORIGIN + y, FLOOR, tile);
+				}
+			}
+
+			const auto monsterType = std::make_shared<MonsterType>(MONSTER_NAME);
+			monsterType->info.health = monsterType->info.healthMax = 300;
+			monsterType->info.experience = 10;
+			monsterType->info.outfit.lookType = 21;
+			monsterType->info.targetDistance = 1;
+			if (!g_monsters().tryAddMonsterType(MONSTER_NAME, monsterType)) {
+				return false;
+			}
+
+			const auto group = g_game().groups.getGroup(1);
+			for (uint32_t i = 0; i < options.players; ++i) {
+				const auto player = std::make_shared<Player>(nullptr);
+				player->setName(fmt::format("Bot {}", i + 1));
+				player->setGUID(i + 1);
+				player->setGroup(group);
+				player->setVocation(BOT_VOCATION);
+				// Game::placeCreature runs the login of a connected player, the bots have no client
+				if (g_game().internalPlaceCreature(player, randomPosition(), true, false, true)) {
+					bots.emplace_back(player);
+				}
+			}
+
+			for (uint32_t i = 0; i < options.monsters; ++i) {
+				spawnMonster();
+			}
+
+			g_logger().info("[canary_bench] - {}x{} tiles, {} players, {} monsters, {} KB resident", options.size, options.size, bots.size(), monsters.size(), getResidentKb());
+			return !bots.empty();
+		}
+
+		void start(std::function<void(void)> &&onFinish) {
+			finish = std::move(onFinish);
+			startNs = now();
+			startMemory = getResidentKb();
+			tickDurations.reserve(options.ticks);
+			scheduleTick();
+		}
+
+	private:
+		static int64_t now() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		Position randomPosition() {
+			std::uniform_int_distribution<uint16_t> coordinate(0, options.size - 1);
+			return Position(ORIGIN + coordinate(random), ORIGIN + coordinate(random), FLOOR);
+		}
+
+		void spawnMonster() {
+			const auto monster = Monster::createMonster(MONSTER_NAME);
+			if (monster && g_game().placeCreature(monster, randomPosition(), true, true)) {
+				monsters.emplace_back(monster);
+			}
+		}
+
+		void scheduleTick() {
+			if (options.interval == 0) {
+				g_dispatcher().addEvent([this] { tick(); }, "SyntheticLoad::tick");
+			} else {
+				g_dispatcher().scheduleEvent(
+					options.interval, [this] { tick(); }, "SyntheticLoad::tick"
+				);
+			}
+		}
+
+		void tick() {
+			const auto tickStart = now();
+			const auto actions = runBots();
+			g_game().checkCreatures();
+			tickDurations.emplace_back(now() - tickStart);
+
+			// Counted outside of the tick, the players that would receive a packet for each action
+			for (const auto &position : actionPositions) {
+				notifications += Spectators().find<Player>(position).size();
+			}
+			actionPositions.clear();
+			totalActions += actions;
+
+			if (tickDurations.size() < options.ticks) {
+				scheduleTick();
+				return;
+			}
+
+			report();
+			if (finish) {
+				finish();
+			}
+		}
+
+		size_t runBots() {
+			std::erase_if(monsters, [](const auto &monster) {
+				return monster->isRemoved() || monster->isDead();
+			});
+			while (monsters.size() < options.monsters) {
+				const auto before = monsters.size();
+				spawnMonster();
+				if (monsters.size() == before) {
+					break;
+				}
+			}
+
+			std::uniform_int_distribution<uint32_t> action(0, 99);
+			std::uniform_int_distribution<int> direction(DIRECTION_NORTH, DIRECTION_WEST);
+			size_t actions = 0;
+			for (const auto &player : bots) {
+				if (player->isRemoved()) {
+					continue;
+				}
+
+				// Answers the pings as a client would
+				player->receivePing();
+				const auto roll = action(random);
+				const auto &position = player->getPosition();
+				if (roll < 30) {
+					g_game().playerMove(player->getID(), static_cast<Direction>(direction(random)));
+				} else if (roll < 35) {
+					g_game().playerSay(player->getID(), 0, TALKTYPE_SAY, "", "hello");
+				} else if (roll < 40) {
+					g_game().playerUseItem(player->getID(), getNextPosition(player->getDirection(), position), 0, 0, options.ground);
+				} else if (roll < 45 && !player->getAttackedCreature()) {
+					const auto target = getNearestMonster(position);
+					if (!target) {
+						continue;
+					}
+					g_game().playerSetAttackedCreature(player->getID(), target->getID());
+				} else {
+					continue;
+				}
+				actionPositions.emplace_back(position);
+				++actions;
+			}
+			return actions;
+		}
+
+		std::shared_ptr<Monster> getNearestMonster(const Position &position) const {
+			for (const auto &spectator : Spectators().find<Monster>(position)) {
+				if (const auto &monster = spectator->getMonster(); monster && !monster->isDead()) {
+					return monster;
+				}
+			}
+			return nullptr;
+		}
+
+		void report() const {
+			std::vector<int64_t> sorted = tickDurations;
+			std::ranges::sort(sorted);
+			const auto seconds = static_cast<double>(now() - startNs) / 1000000000.0;
+			const auto total = std::accumulate(sorted.begin(), sorted.end(), int64_t { 0 });
+
+			g_logger().info(
+				"[canary_bench] - {} ticks in {:.2f} s, tick ms: mean {:.3f}, p50 {:.3f}, p90 {:.3f}, p99 {:.3f}, max {:.3f}",
+				sorted.size(), seconds, static_cast<double>(total) / static_cast<double>(sorted.size()) / 1000000.0,
+				percentile(sorted, 0.5), percentile(sorted, 0.9), percentile(sorted, 0.99), percentile(sorted, 1.0)
+			);
+			g_logger().info(
+				"[canary_bench] - {} players, {} monsters, {:.0f} actions/s, {:.0f} notifications/s, {} KB resident ({:+} KB)",
+				g_game().getPlayersOnline(), g_game().getMonstersOnline(), static_cast<double>(totalActions) / seconds,
+				static_cast<double>(notifications) / seconds, getResidentKb(), getResidentKb() - startMemory
+			);
+			g_logger().info("[canary_bench] - Dispatcher:\n{}", g_dispatcher().getFlightRecorder().getReport(0));
+		}
+
+		const Options &options;
+		std::mt19937 random;
+		std::vector<std::shared_ptr<Player>> bots;
+		std::vector<std::shared_ptr<Monster>> monsters;
+		std::vector<Position> actionPositions;
+		std::vector<int64_t> tickDurations;
+		std::function<void(void)> finish;
+		int64_t startNs = 0;
+		int64_t startMemory = 0;
+		uint64_t totalActions = 0;
+		uint64_t notifications = 0;
+	};
+}
+
+int main(int argc, char* argv[]) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		std::cerr << "Usage: canary_bench [--players N] [--monsters N] [--ticks N] [--size N] [--interval ms] [--seed N] [--ground id] [--config path]" << std::endl;
+		return 1;
+	}
+
+	g_game().setGameState(GAME_STATE_STARTUP);
+	g_dispatcher().init();
+
+	SyntheticLoad load(options);
+	std::promise<int> result;
+	g_dispatcher().addEvent(
+		[&] {
+			if (!load.load() || !load.populate()) {
+				result.set_value(1);
+				return;
+			}
+			g_game().setGameState(GAME_STATE_NORMAL);
+			load.start([&result] { result.set_value(0); });
+		},
+		__FUNCTION__
+	);
+
+	const int code = result.get_future().get();
+	g_dispatcher().shutdown();
+	inject<ThreadPool>().shutdown();
+	// The players were never saved nor removed, exits without tearing the game down
+	std::_Exit(code);
+}
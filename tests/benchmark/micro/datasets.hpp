@@ -0,0 +1,38 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Datasets of the microbenchmarks, generated from a fixed seed so that every
+ * run, on every machine, measures the same positions, keys and payloads.
+ */
+namespace datasets {
+	constexpr uint32_t SEED = 20240601;
+
+	inline std::mt19937 generator(uint32_t salt) {
+		return std::mt19937(SEED ^ salt);
+	}
+
+	// Bytes of a map description like payload: runs of a few ids with some noise, it compresses like the real packets
+	inline std::vector<uint8_t> packet(size_t size, uint32_t salt) {
+		auto random = generator(salt);
+		std::uniform_int_distribution<int> noise(0, 99);
+		std::uniform_int_distribution<int> value(0, 255);
+		std::vector<uint8_t> bytes(size);
+		uint8_t current = 0;
+		for (auto &byte : bytes) {
+			if (noise(random) < 20) {
+				current = static_cast<uint8_t>(value(random) % 16);
+			}
+			byte = current;
+		}
+		return bytes;
+	}
+}
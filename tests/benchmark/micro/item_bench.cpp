@@ -0,0 +1,98 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include "io/fileloader.hpp"
+#include "items/decay/decay.hpp"
+#include "items/item.hpp"
+#include "items/tile.hpp"
+
+namespace {
+	constexpr uint16_t GROUND = 4526;
+
+	// An item with the attributes of a written and renamed one, placed on a tile so it can decay
+	std::shared_ptr<Item> createItem(uint16_t itemId, const std::shared_ptr<Tile> &tile) {
+		const auto item = Item::CreateItem(itemId);
+		item->setAttribute(ItemAttribute_t::ACTIONID, 1000);
+		item->setAttribute(ItemAttribute_t::DESCRIPTION, "A benchmark item with a long enough description.");
+		item->setAttribute(ItemAttribute_t::TEXT, "Written on by the benchmark.");
+		item->setAttribute(ItemAttribute_t::WRITER, "Benchmark");
+		item->setAttribute(ItemAttribute_t::DATE, 1700000000);
+		item->setAttribute(ItemAttribute_t::CHARGES, 5);
+		tile->internalAddThing(item);
+		return item;
+	}
+
+	// The first item of the loaded items that decays, the order of items.xml is fixed
+	uint16_t getDecayingItemId() {
+		for (size_t id = 100, size = Item::items.size(); id < size; ++id) {
+			const auto &itemType = Item::items.getItemType(id);
+			if (itemType.decayTime > 0 && itemType.decayTo >= 0) {
+				return static_cast<uint16_t>(id);
+			}
+		}
+		return 0;
+	}
+
+	void BM_Item_getAttribute(benchmark::State &state) {
+		const auto tile = std::make_shared<DynamicTile>(100, 100, 7);
+		const auto item = createItem(GROUND, tile);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(item->getAttribute<uint16_t>(ItemAttribute_t::ACTIONID));
+			benchmark::DoNotOptimize(item->getString(ItemAttribute_t::DESCRIPTION).size());
+			benchmark::DoNotOptimize(item->hasAttribute(ItemAttribute_t::UNIQUEID));
+		}
+	}
+
+	void BM_Item_setAttribute(benchmark::State &state) {
+		const auto tile = std::make_shared<DynamicTile>(100, 100, 7);
+		const auto item = createItem(GROUND, tile);
+		int64_t value = 0;
+		for (auto _ : state) {
+			item->setAttribute(ItemAttribute_t::ACTIONID, ++value & 0xFFFF);
+		}
+	}
+
+	void BM_PropWriteStream_serializeAttr(benchmark::State &state) {
+		const auto tile = std::make_shared<DynamicTile>(100, 100, 7);
+		const auto item = createItem(GROUND, tile);
+		PropWriteStream stream;
+		size_t size = 0;
+		for (auto _ : state) {
+			stream.clear();
+			item->serializeAttr(stream);
+			benchmark::DoNotOptimize(stream.getStream(size));
+		}
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+	}
+
+	void BM_Decay_startStop(benchmark::State &state) {
+		const auto itemId = getDecayingItemId();
+		if (itemId == 0) {
+			state.SkipWithError("No decaying item loaded");
+			return;
+		}
+
+		const auto tile = std::make_shared<DynamicTile>(100, 100, 7);
+		const auto item = createItem(itemId, tile);
+		item->setDuration(60000);
+		for (auto _ : state) {
+			g_decay().startDecay(item);
+			g_decay().stopDecay(item);
+		}
+	}
+}
+
+BENCHMARK(BM_Item_getAttribute);
+BENCHMARK(BM_Item_setAttribute);
+BENCHMARK(BM_PropWriteStream_serializeAttr);
+BENCHMARK(BM_Decay_startStop);
@@ -0,0 +1,70 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include "datasets.hpp"
+#include "kv/in_memory_kv.hpp"
+
+namespace {
+	constexpr size_t KEYS = 4096;
+
+	std::vector<std::string> keys() {
+		std::vector<std::string> result;
+		result.reserve(KEYS);
+		for (size_t i = 0; i < KEYS; ++i) {
+			result.emplace_back(fmt::format("player.{}.storage.{}", i % 256, i));
+		}
+		return result;
+	}
+
+	void BM_KVStore_get(benchmark::State &state) {
+		KVMemory kv(g_logger());
+		const auto dataset = keys();
+		for (size_t i = 0; i < dataset.size(); ++i) {
+			kv.set(dataset[i], static_cast<int>(i));
+		}
+
+		auto random = datasets::generator(20);
+		std::uniform_int_distribution<size_t> index(0, dataset.size() - 1);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(kv.get(dataset[index(random)]));
+		}
+	}
+
+	void BM_KVStore_set(benchmark::State &state) {
+		KVMemory kv(g_logger());
+		const auto dataset = keys();
+		size_t index = 0;
+		for (auto _ : state) {
+			kv.set(dataset[index % dataset.size()], static_cast<int>(index));
+			++index;
+		}
+	}
+
+	// The way the scripts reach a value, through a scope per player
+	void BM_KVStore_scopedGet(benchmark::State &state) {
+		KVMemory kv(g_logger());
+		for (int player = 0; player < 256; ++player) {
+			kv.scoped("player")->scoped(std::to_string(player))->set("storage", player);
+		}
+
+		auto random = datasets::generator(21);
+		std::uniform_int_distribution<int> player(0, 255);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(kv.scoped("player")->scoped(std::to_string(player(random)))->get("storage"));
+		}
+	}
+}
+
+BENCHMARK(BM_KVStore_get);
+BENCHMARK(BM_KVStore_set);
+BENCHMARK(BM_KVStore_scopedGet);
@@ -0,0 +1,41 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include "config/configmanager.hpp"
+#include "game/game.hpp"
+#include "items/items.hpp"
+
+// Runs from the folder of config.lua, like the server, to read the config and the items of the core folder
+int main(int argc, char** argv) {
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+		return 1;
+	}
+
+	g_configManager().setConfigFileLua(std::filesystem::exists("config.lua") ? "config.lua" : "config.lua.dist");
+	if (!g_configManager().load()) {
+		g_logger().error("[canary_microbench] - Failed to load {}", g_configManager().getConfigFileLua());
+		return 1;
+	}
+
+	const auto &coreFolder = g_configManager().getString(CORE_DIRECTORY, __FUNCTION__);
+	if (g_game().loadAppearanceProtobuf(coreFolder + "/items/appearances.dat") != ERROR_NONE || !Item::items.loadFromXml()) {
+		g_logger().error("[canary_microbench] - Failed to load the items of {}", coreFolder);
+		return 1;
+	}
+
+	UPDATE_OTSYS_TIME();
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
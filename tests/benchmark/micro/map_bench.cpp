@@ -0,0 +1,140 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include "creatures/monsters/monster.hpp"
+#include "creatures/monsters/monsters.hpp"
+#include "datasets.hpp"
+#include "game/game.hpp"
+#include "items/tile.hpp"
+#include "map/spectators.hpp"
+
+namespace {
+	constexpr uint16_t ORIGIN = 1000;
+	constexpr uint16_t SIZE = 256;
+	constexpr uint8_t FLOOR = 7;
+	constexpr uint16_t GROUND = 4526;
+	constexpr uint32_t MONSTERS = 2000;
+	// One tile in ten is left out, the paths have to go around them
+	constexpr int HOLE_PERCENT = 10;
+	constexpr size_t POSITIONS = 4096;
+
+	// Flat floor of grass with holes and monsters, built once for all the benchmarks of the file
+	void buildMap() {
+		static std::once_flag built;
+		std::call_once(built, [] {
+			auto random = datasets::generator(10);
+			std::uniform_int_distribution<int> percent(0, 99);
+			for (uint16_t x = 0; x < SIZE; ++x) {
+				for (uint16_t y = 0; y < SIZE; ++y) {
+					if (percent(random) < HOLE_PERCENT) {
+						continue;
+					}
+					const auto tile = std::make_shared<DynamicTile>(ORIGIN + x, ORIGIN + y, FLOOR);
+					tile->internalAddThing(Item::CreateItem(GROUND));
+					g_game().map.setTile(ORIGIN + x, ORIGIN + y, FLOOR, tile);
+				}
+			}
+
+			const std::string name = "Benchmark Dummy";
+			const auto monsterType = std::make_shared<MonsterType>(name);
+			monsterType->info.outfit.lookType = 21;
+			g_monsters().tryAddMonsterType(name, monsterType);
+
+			std::uniform_int_distribution<int> coordinate(0, SIZE - 1);
+			for (uint32_t i = 0; i < MONSTERS; ++i) {
+				const auto monster = Monster::createMonster(name);
+				g_game().internalPlaceCreature(monster, Position(ORIGIN + coordinate(random), ORIGIN + coordinate(random), FLOOR), true, true);
+			}
+		});
+	}
+
+	std::vector<Position> positions(uint32_t salt, int32_t margin = 0) {
+		auto random = datasets::generator(salt);
+		std::uniform_int_distribution<int> coordinate(margin, SIZE - 1 - margin);
+		std::vector<Position> result(POSITIONS);
+		for (auto &position : result) {
+			position = Position(ORIGIN + coordinate(random), ORIGIN + coordinate(random), FLOOR);
+		}
+		return result;
+	}
+
+	void BM_Map_getTile(benchmark::State &state) {
+		buildMap();
+		const auto dataset = positions(11);
+		size_t index = 0;
+		for (auto _ : state) {
+			const auto &position = dataset[index++ % dataset.size()];
+			benchmark::DoNotOptimize(g_game().map.getTile(position.x, position.y, position.z));
+		}
+	}
+
+	// The same few positions asked again and again, as the spectators of a crowded area are
+	void BM_Spectators_find_cached(benchmark::State &state) {
+		buildMap();
+		const auto dataset = positions(12);
+		const auto distinct = static_cast<size_t>(state.range(0));
+		size_t index = 0;
+		for (auto _ : state) {
+			const auto &spectators = Spectators().find<Creature>(dataset[index++ % distinct]);
+			benchmark::DoNotOptimize(spectators.size());
+		}
+	}
+
+	void BM_Spectators_find_uncached(benchmark::State &state) {
+		buildMap();
+		const auto dataset = positions(13);
+		const bool multifloor = state.range(0) != 0;
+		size_t index = 0;
+		for (auto _ : state) {
+			Spectators::clearCache();
+			const auto &spectators = Spectators().find<Creature>(dataset[index++ % dataset.size()], multifloor);
+			benchmark::DoNotOptimize(spectators.size());
+		}
+	}
+
+	// A* through Map::getPathMatching, towards a target up to range tiles away
+	void BM_AStarNodes_path(benchmark::State &state) {
+		buildMap();
+		const auto range = static_cast<int32_t>(state.range(0));
+		const auto starts = positions(14, range);
+		auto random = datasets::generator(15);
+		std::uniform_int_distribution<int32_t> offset(-range, range);
+		std::vector<Position> targets;
+		targets.reserve(starts.size());
+		for (const auto &start : starts) {
+			targets.emplace_back(start.x + offset(random), start.y + offset(random), FLOOR);
+		}
+
+		FindPathParams fpp;
+		fpp.maxSearchDist = range * 2;
+		fpp.minTargetDist = 0;
+		fpp.maxTargetDist = 1;
+		fpp.clearSight = false;
+
+		std::vector<Direction> dirList;
+		size_t index = 0;
+		int64_t found = 0;
+		for (auto _ : state) {
+			const auto current = index++ % starts.size();
+			dirList.clear();
+			found += g_game().map.getPathMatching(starts[current], dirList, FrozenPathingConditionCall(targets[current]), fpp) ? 1 : 0;
+			benchmark::DoNotOptimize(dirList.data());
+		}
+		state.counters["found"] = benchmark::Counter(static_cast<double>(found), benchmark::Counter::kAvgIterations);
+	}
+}
+
+BENCHMARK(BM_Map_getTile);
+BENCHMARK(BM_Spectators_find_cached)->Arg(16)->Arg(256);
+BENCHMARK(BM_Spectators_find_uncached)->Arg(0)->Arg(1);
+BENCHMARK(BM_AStarNodes_path)->Arg(4)->Arg(8)->Arg(12);
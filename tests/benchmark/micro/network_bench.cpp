@@ -0,0 +1,74 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include "datasets.hpp"
+#include "security/xtea.hpp"
+#include "server/network/message/outputmessage.hpp"
+#include "server/network/protocol/protocol.hpp"
+
+namespace {
+	constexpr xtea::key_type KEY = { 0x01234567, 0x89ABCDEF, 0xFEDCBA98, 0x76543210 };
+
+	// Without connection, what it sends is encoded and dropped
+	class BenchProtocol final : public Protocol {
+	public:
+		BenchProtocol() :
+			Protocol(nullptr) {
+			setXTEAKey(KEY.data());
+			enableXTEAEncryption();
+			setChecksumMethod(CHECKSUM_METHOD_SEQUENCE);
+		}
+
+		void onRecvFirstMessage(NetworkMessage &) override { }
+	};
+
+	void BM_XTEA_encrypt(benchmark::State &state) {
+		const auto size = static_cast<size_t>(state.range(0));
+		auto data = datasets::packet(size, 1);
+		const auto keys = xtea::expandEncryptKeys(KEY);
+		for (auto _ : state) {
+			xtea::encrypt(data.data(), data.size(), keys);
+			benchmark::ClobberMemory();
+		}
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+	}
+
+	void BM_XTEA_decrypt(benchmark::State &state) {
+		const auto size = static_cast<size_t>(state.range(0));
+		auto data = datasets::packet(size, 2);
+		const auto keys = xtea::expandDecryptKeys(KEY);
+		for (auto _ : state) {
+			xtea::decrypt(data.data(), data.size(), keys);
+			benchmark::ClobberMemory();
+		}
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+	}
+
+	// Compression, length, XTEA and sequence header: all that Protocol does to a packet before sending it
+	void BM_Protocol_onSendMessage(benchmark::State &state) {
+		const auto size = static_cast<size_t>(state.range(0));
+		const auto payload = datasets::packet(size, 3);
+		const auto protocol = std::make_shared<BenchProtocol>();
+		for (auto _ : state) {
+			const auto msg = OutputMessagePool::getOutputMessage();
+			msg->addBytes(reinterpret_cast<const char*>(payload.data()), payload.size());
+			protocol->onSendMessage(msg);
+			benchmark::DoNotOptimize(msg->getLength());
+		}
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+	}
+}
+
+BENCHMARK(BM_XTEA_encrypt)->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK(BM_XTEA_decrypt)->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK(BM_Protocol_onSendMessage)->Arg(64)->Arg(1024)->Arg(16384);
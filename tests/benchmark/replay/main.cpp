@@ -0,0 +1,375 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "core.hpp"
+#include "creatures/creatures_definitions.hpp"
+#include "lib/di/container.hpp"
+#include "security/rsa.hpp"
+#include "security/xtea.hpp"
+#include "server/network/protocol/packet_capture.hpp"
+#include "utils/tools.hpp"
+
+/**
+ * Replays the packet captures of a server with packetCapture on against a
+ * test server, through many concurrent connections.
+ *
+ * Each connection logs in as a character of the accounts file, a line of
+ * "account password character" each, with the RSA key of the key.pem of the
+ * current folder, then sends the packets of a capture at the times they were
+ * received, scaled by the speed, and reads and drops what the server sends.
+ * The connections take the captures and the accounts in turn.
+ *
+ * canary_replay [--host 127.0.0.1] [--port 7172] [--connections 10] [--speed 1.0] --accounts accounts.txt capture.cap...
+ */
+
+namespace {
+	struct Options {
+		std::string host = "127.0.0.1";
+		uint16_t port = 7172;
+		uint32_t connections = 10;
+		double speed = 1.0;
+		std::string accounts;
+		std::vector<std::string> captures;
+	};
+
+	struct Account {
+		std::string name;
+		std::string password;
+		std::string character;
+	};
+
+	struct Capture {
+		std::string path;
+		std::vector<PacketCapture::Packet> packets;
+	};
+
+	struct Statistics {
+		std::atomic<uint32_t> loggedIn = 0;
+		std::atomic<uint32_t> finished = 0;
+		std::atomic<uint32_t> failed = 0;
+		std::atomic<uint64_t> packetsSent = 0;
+		std::atomic<uint64_t> packetsReceived = 0;
+		std::atomic<uint64_t> bytesReceived = 0;
+	};
+
+	Statistics statistics;
+
+	class Writer {
+	public:
+		template <typename T>
+		void add(T value) {
+			const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+			data.insert(data.end(), bytes, bytes + sizeof(T));
+		}
+
+		void addString(const std::string &value) {
+			add<uint16_t>(static_cast<uint16_t>(value.size()));
+			data.insert(data.end(), value.begin(), value.end());
+		}
+
+		void addBytes(const uint8_t* bytes, size_t size) {
+			data.insert(data.end(), bytes, bytes + size);
+		}
+
+		std::vector<uint8_t> data;
+	};
+
+	class ReplaySession : public std::enable_shared_from_this<ReplaySession> {
+	public:
+		ReplaySession(asio::io_context &context, const Account &account, const Capture &capture, double speed) :
+			socket(context), timer(context), account(account), capture(capture), speed(speed) {
+			std::random_device device;
+			for (auto &part : key) {
+				part = device();
+			}
+			encryptKeys = xtea::expandEncryptKeys(key);
+		}
+
+		void start(const asio::ip::tcp::endpoint &endpoint) {
+			socket.async_connect(endpoint, [self = shared_from_this()](const std::error_code &error) {
+				if (error) {
+					self->fail(fmt::format("connect: {}", error.message()));
+					return;
+				}
+				self->readHeader();
+			});
+		}
+
+	private:
+		void fail(const std::string &reason) {
+			if (done) {
+				return;
+			}
+			done = true;
+			++statistics.failed;
+			g_logger().warn("[canary_replay] - {} ({}): {}", account.character, capture.path, reason);
+			close();
+		}
+
+		void close() {
+			std::error_code error;
+			timer.cancel();
+			socket.close(error);
+		}
+
+		void readHeader() {
+			asio::async_read(socket, asio::buffer(header), [self = shared_from_this()](const std::error_code &error, size_t) {
+				if (error) {
+					if (!self->done) {
+						self->fail(fmt::format("read: {}", error.message()));
+					}
+					return;
+				}
+				self->body.resize(static_cast<uint16_t>(self->header[0] | self->header[1] << 8));
+				self->readBody();
+			});
+		}
+
+		void readBody() {
+			asio::async_read(socket, asio::buffer(body), [self = shared_from_this()](const std::error_code &error, size_t size) {
+				if (error) {
+					if (!self->done) {
+						self->fail(fmt::format("read: {}", error.message()));
+					}
+					return;
+				}
+				self->onPacket(size);
+				self->readHeader();
+			});
+		}
+
+		void onPacket(size_t size) {
+			++statistics.packetsReceived;
+			statistics.bytesReceived += size + header.size();
+
+			if (!challengeReceived) {
+				// Checksum, length, 0x1F, timestamp and random number, still unencrypted
+				if (body.size() < 12 || body[6] != 0x1F) {
+					fail("no login challenge");
+					return;
+				}
+				challengeReceived = true;
+				uint32_t timestamp;
+				std::memcpy(&timestamp, body.data() + 7, sizeof(timestamp));
+				sendLogin(timestamp, body[11]);
+				return;
+			}
+
+			// The first answer to the login, the session is in game or was told why not
+			if (!replaying) {
+				replaying = true;
+				++statistics.loggedIn;
+				startTime = std::chrono::steady_clock::now();
+				scheduleNext();
+			}
+		}
+
+		void sendLogin(uint32_t timestamp, uint8_t random) {
+			Writer block;
+			block.add<uint8_t>(0);
+			for (const auto part : key) {
+				block.add<uint32_t>(part);
+			}
+			block.add<uint8_t>(0); // Game master flag
+			block.addString(account.name + "\n" + account.password);
+			block.addString(account.character);
+			block.add<uint32_t>(timestamp);
+			block.add<uint8_t>(random);
+			if (block.data.size() > 128) {
+				fail("account or character name too long");
+				return;
+			}
+			// Zeroed, the server reads no OTCv8 identification from it
+			block.data.resize(128, 0);
+			g_RSA().encrypt(reinterpret_cast<char*>(block.data.data()));
+
+			Writer message;
+			message.add<uint8_t>(0x0A); // Game protocol
+			message.add<uint16_t>(CLIENTOS_NEW_WINDOWS);
+			message.add<uint16_t>(CLIENT_VERSION);
+			message.add<uint32_t>(CLIENT_VERSION);
+			message.addString(fmt::format("{}.{}", CLIENT_VERSION_UPPER, CLIENT_VERSION_LOWER));
+			message.addString(""); // Assets hash
+			message.add<uint8_t>(0); // Game preview state
+			message.addBytes(block.data.data(), block.data.size());
+
+			Writer packet;
+			packet.add<uint16_t>(static_cast<uint16_t>(message.data.size() + sizeof(uint32_t)));
+			packet.add<uint32_t>(adlerChecksum(message.data.data(), message.data.size()));
+			packet.addBytes(message.data.data(), message.data.size());
+			write(std::move(packet.data));
+		}
+
+		// Length, sequence number and the XTEA encrypted length and payload, as the client sends them
+		void sendPacket(const std::vector<uint8_t> &payload) {
+			Writer inner;
+			inner.add<uint16_t>(static_cast<uint16_t>(payload.size()));
+			inner.addBytes(payload.data(), payload.size());
+			inner.data.resize((inner.data.size() + 7) & ~size_t { 7 }, 0);
+			xtea::encrypt(inner.data.data(), inner.data.size(), encryptKeys);
+
+			Writer packet;
+			packet.add<uint16_t>(static_cast<uint16_t>(inner.data.size() + sizeof(uint32_t)));
+			packet.add<uint32_t>(++sequence);
+			packet.addBytes(inner.data.data(), inner.data.size());
+			write(std::move(packet.data));
+			++statistics.packetsSent;
+		}
+
+		void scheduleNext() {
+			if (next >= capture.packets.size()) {
+				// Some time for the server to handle the last ones, the capture usually ends with a logout
+				timer.expires_after(std::chrono::seconds(2));
+				timer.async_wait([self = shared_from_this()](const std::error_code &error) {
+					if (!error && !self->done) {
+						self->done = true;
+						++statistics.finished;
+						self->close();
+					}
+				});
+				return;
+			}
+
+			const auto offset = std::chrono::milliseconds(static_cast<int64_t>(capture.packets[next].offsetMs / speed));
+			timer.expires_at(startTime + offset);
+			timer.async_wait([self = shared_from_this()](const std::error_code &error) {
+				if (error || self->done) {
+					return;
+				}
+				self->sendPacket(self->capture.packets[self->next++].data);
+				self->scheduleNext();
+			});
+		}
+
+		void write(std::vector<uint8_t> &&data) {
+			writeQueue.emplace_back(std::move(data));
+			if (writeQueue.size() == 1) {
+				writeFront();
+			}
+		}
+
+		void writeFront() {
+			asio::async_write(socket, asio::buffer(writeQueue.front()), [self = shared_from_this()](const std::error_code &error, size_t) {
+				if (error) {
+					self->fail(fmt::format("write: {}", error.message()));
+					return;
+				}
+				self->writeQueue.pop_front();
+				if (!self->writeQueue.empty()) {
+					self->writeFront();
+				}
+			});
+		}
+
+		asio::ip::tcp::socket socket;
+		asio::steady_timer timer;
+		const Account &account;
+		const Capture &capture;
+		const double speed;
+
+		xtea::key_type key {};
+		xtea::round_keys encryptKeys {};
+		uint32_t sequence = 0;
+
+		std::array<uint8_t, 2> header {};
+		std::vector<uint8_t> body;
+		std::deque<std::vector<uint8_t>> writeQueue;
+
+		bool challengeReceived = false;
+		bool replaying = false;
+		bool done = false;
+		size_t next = 0;
+		std::chrono::steady_clock::time_point startTime;
+	};
+
+	bool parseOptions(int argc, char* argv[], Options &options) {
+		for (int i = 1; i < argc; ++i) {
+			const std::string_view name = argv[i];
+			if (!name.starts_with("--")) {
+				options.captures.emplace_back(name);
+				continue;
+			}
+			if (i + 1 >= argc) {
+				return false;
+			}
+
+			const std::string value = argv[++i];
+			if (name == "--host") {
+				options.host = value;
+			} else if (name == "--port") {
+				options.port = static_cast<uint16_t>(std::stoul(value));
+			} else if (name == "--connections") {
+				options.connections = std::max<uint32_t>(1, static_cast<uint32_t>(std::stoul(value)));
+			} else if (name == "--speed") {
+				options.speed = std::max(0.01, std::stod(value));
+			} else if (name == "--accounts") {
+				options.accounts = value;
+			} else {
+				return false;
+			}
+		}
+		return !options.accounts.empty() && !options.captures.empty();
+	}
+}
+
+int main(int argc, char* argv[]) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		std::cerr << "Usage: canary_replay [--host ip] [--port port] [--connections N] [--speed factor] --accounts file capture..." << std::endl;
+		return 1;
+	}
+
+	std::vector<Account> accounts;
+	std::ifstream accountsFile(options.accounts);
+	for (Account account; accountsFile >> account.name >> account.password >> std::ws && std::getline(accountsFile, account.character);) {
+		accounts.emplace_back(account);
+	}
+
+	std::vector<Capture> captures;
+	for (const auto &path : options.captures) {
+		Capture capture { path, {} };
+		uint16_t clientVersion = 0;
+		if (!PacketCapture::load(path, capture.packets, clientVersion) && capture.packets.empty()) {
+			g_logger().warn("[canary_replay] - {} is not a capture", path);
+			continue;
+		}
+		if (clientVersion != CLIENT_VERSION) {
+			g_logger().warn("[canary_replay] - {} was captured from protocol {}, replayed as {}", path, clientVersion, CLIENT_VERSION);
+		}
+		captures.emplace_back(std::move(capture));
+	}
+
+	if (accounts.empty() || captures.empty()) {
+		g_logger().error("[canary_replay] - Needs at least one account and one capture");
+		return 1;
+	}
+
+	g_RSA().start();
+
+	asio::io_context context;
+	asio::ip::tcp::resolver resolver(context);
+	const auto endpoint = *resolver.resolve(options.host, std::to_string(options.port)).begin();
+	for (uint32_t i = 0; i < options.connections; ++i) {
+		std::make_shared<ReplaySession>(context, accounts[i % accounts.size()], captures[i % captures.size()], options.speed)->start(endpoint);
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	context.run();
+	const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	g_logger().info(
+		"[canary_replay] - {} connections in {:.1f} s: {} logged in, {} finished, {} failed; {} packets sent ({:.0f}/s), {} packets and {} bytes received ({:.0f}/s)",
+		options.connections, seconds, statistics.loggedIn.load(), statistics.finished.load(), statistics.failed.load(),
+		statistics.packetsSent.load(), static_cast<double>(statistics.packetsSent) / seconds,
+		statistics.packetsReceived.load(), statistics.bytesReceived.load(), static_cast<double>(statistics.packetsReceived) / seconds
+	);
+	return statistics.failed > 0 ? 1 : 0;
+}
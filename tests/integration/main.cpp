@@ -159,4 +159,21 @@ int main() {
 		// sessionExpires is not saved
 		expect(eq(acc2.sessionExpires, 0));
 	});
+
+	test("Database::storeStatement reads the rows bound by executeStatement") = databaseTest(db, [&db] {
+		const std::string name = "it's a \"test\"";
+		expect(db.executeStatement(
+			"INSERT INTO `accounts` (`id`, `name`, `email`, `password`, `type`, `premdays`, `lastday`, `premdays_purchased`, `creation`) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)",
+			{ 112, name, "@statement", "", 1, 0, 0, 0, 0 }
+		));
+
+		const auto result = db.storeStatement("SELECT `id`, `name`, `lastday` FROM `accounts` WHERE `name` = ?", { name });
+		expect((result != nullptr) >> fatal);
+		expect(eq(result->countResults(), 1));
+		expect(eq(result->getNumber<uint32_t>("id"), 112));
+		expect(eq(result->getString("name"), name));
+		expect(!result->next());
+
+		expect(db.storeStatement("SELECT `id` FROM `accounts` WHERE `name` = ?", { "missing" }) == nullptr);
+	});
 }
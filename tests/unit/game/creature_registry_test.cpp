@@ -0,0 +1,66 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/creature_registry.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	struct FakeCreature {
+		explicit FakeCreature(uint32_t id) :
+			id(id) { }
+
+		uint32_t getID() const {
+			return id;
+		}
+
+		uint32_t id;
+	};
+}
+
+suite<"game"> creatureRegistryTest = [] {
+	test("CreatureRegistry finds live ids and forgets removed ones") = [] {
+		CreatureRegistry<FakeCreature> registry(0x50000001, 0x7FFFFFFF);
+		const auto first = std::make_shared<FakeCreature>(registry.nextId());
+		const auto second = std::make_shared<FakeCreature>(registry.nextId());
+		registry.add(first);
+		registry.add(second);
+		expect(eq(size_t { 2 }, registry.size()));
+		expect(registry.find(first->getID()) == first);
+
+		registry.remove(first->getID());
+		expect(registry.find(first->getID()) == nullptr);
+		expect(registry.find(second->getID()) == second);
+		expect(registry.find(0x10000001) == nullptr);
+	};
+
+	test("CreatureRegistry skips ids whose slot is still taken") = [] {
+		CreatureRegistry<FakeCreature> registry(0x50000001, 0x7FFFFFFF);
+		const auto oldest = std::make_shared<FakeCreature>(registry.nextId());
+		registry.add(oldest);
+		for (uint32_t i = 0; i < 5000; ++i) {
+			const auto creature = std::make_shared<FakeCreature>(registry.nextId());
+			expect(registry.find(creature->getID()) == nullptr);
+			registry.add(creature);
+			registry.remove(creature->getID());
+		}
+		expect(registry.find(oldest->getID()) == oldest);
+		expect(eq(size_t { 1 }, registry.size()));
+	};
+
+	test("CreatureRegistry keeps every id reachable while it grows") = [] {
+		CreatureRegistry<FakeCreature> registry(0x80000000, 0xFFFFFFFE);
+		std::vector<std::shared_ptr<FakeCreature>> creatures;
+		for (uint32_t i = 0; i < 3000; ++i) {
+			registry.add(creatures.emplace_back(std::make_shared<FakeCreature>(registry.nextId())));
+		}
+		for (size_t i = 0; i < creatures.size(); i += 2) {
+			registry.remove(creatures[i]->getID());
+		}
+		for (size_t i = 1; i < creatures.size(); i += 2) {
+			expect(registry.find(creatures[i]->getID()) == creatures[i]);
+		}
+		expect(eq(size_t { 1500 }, registry.size()));
+	};
+};
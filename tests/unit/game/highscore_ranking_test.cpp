@@ -0,0 +1,46 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/highscores/highscores.hpp"
+
+using namespace boost::ut;
+
+suite<"game"> highscoreRankingTest = [] {
+	test("HighscoreRanking lists the most points first, ties by guid") = [] {
+		HighscoreRanking ranking;
+		ranking.set(3, 100);
+		ranking.set(1, 50);
+		ranking.set(2, 100);
+		expect(eq(size_t { 3 }, ranking.size()));
+		expect(eq(uint32_t { 2 }, ranking.getEntries()[0].guid));
+		expect(eq(uint32_t { 3 }, ranking.getEntries()[1].guid));
+		expect(eq(uint32_t { 1 }, ranking.getEntries()[2].guid));
+		expect(eq(size_t { 2 }, *ranking.getPosition(1)));
+	};
+
+	test("HighscoreRanking moves a changed score both ways") = [] {
+		HighscoreRanking ranking;
+		for (uint32_t guid = 1; guid <= 5; ++guid) {
+			ranking.set(guid, guid * 10);
+		}
+		ranking.set(1, 45);
+		expect(eq(size_t { 1 }, *ranking.getPosition(1)));
+		ranking.set(5, 5);
+		expect(eq(size_t { 4 }, *ranking.getPosition(5)));
+		expect(eq(uint32_t { 1 }, ranking.getEntries()[0].guid));
+	};
+
+	test("HighscoreRanking ranks tied points together") = [] {
+		HighscoreRanking ranking;
+		ranking.set(1, 30);
+		ranking.set(2, 20);
+		ranking.set(3, 20);
+		ranking.set(4, 10);
+		expect(eq(size_t { 1 }, ranking.countAbove(20)));
+		expect(eq(size_t { 3 }, ranking.countAbove(10)));
+		ranking.erase(2);
+		expect(!ranking.getPosition(2).has_value());
+		expect(eq(size_t { 2 }, *ranking.getPosition(4)));
+	};
+};
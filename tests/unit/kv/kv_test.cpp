@@ -112,6 +112,18 @@ suite<"kv"> kvTest = [] {
 		expect(eq(kv.get("scope-name.nested-scope-name.nested-scope-name2.key1")->get<int>(), 1));
 	};
 
+	test("Keys with prefix") = [&injectionFixture] {
+		auto [kv] = injectionFixture.get<KVStore>();
+		for (int i = 0; i < 100; ++i) {
+			kv.set(fmt::format("prefix-keys.key{}", i), i);
+		}
+		kv.set("other-prefix.key1", 1);
+		auto keys = kv.keys("prefix-keys.");
+		expect(eq(keys.size(), 100u));
+		expect(keys.contains("key42"));
+		expect(!keys.contains("other-prefix.key1"));
+	};
+
 	test("Removing an element")
 		= [&injectionFixture] {
 			  auto [kv] = injectionFixture.get<KVStore>();
@@ -0,0 +1,58 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "kv/value_wrapper_flat.hpp"
+
+using namespace boost::ut;
+
+suite<"kv"> flatValueTest = [] {
+	const ValueWrapper nested = {
+		{ "name", std::string("Rat") },
+		{ "level", -42 },
+		{ "ratio", 0.25 },
+		{ "alive", true },
+		{ "loot", ValueWrapper(ArrayType { 1, 2, 3 }) },
+	};
+
+	test("Flat encoding round trips nested values") = [&nested] {
+		const auto encoded = FlatValue::encode(nested);
+		expect(FlatValue::isFlat(encoded));
+
+		const auto decoded = FlatValue::decode(encoded, 7);
+		expect(decoded.has_value() >> fatal);
+		// Maps compare their children by pointer, the decoded ones are new
+		expect(eq(decoded->get<std::string>("name"), std::string("Rat")));
+		expect(eq(decoded->get<int>("level"), -42));
+		expect(eq(decoded->get<double>("ratio"), 0.25));
+		expect(decoded->get<bool>("alive"));
+		expect(decoded->get<ArrayType>("loot") == nested.get<ArrayType>("loot"));
+		expect(eq(decoded->getTimestamp(), uint64_t { 7 }));
+	};
+
+	test("Flat view reads one key without decoding the rest") = [&nested] {
+		const auto encoded = FlatValue::encode(nested);
+		const auto view = FlatValueView::fromEncoded(encoded);
+		expect(view.getType() == FlatValueView::Type::Map);
+		expect(eq(view.size(), size_t { 5 }));
+		expect(view.get("name").getString() == "Rat");
+		expect(eq(view.get("level").getInt(), -42));
+		expect(eq(view.get("loot").at(2).getInt(), 3));
+		expect(not view.get("missing").isValid());
+		expect(not view.get("loot").at(3).isValid());
+	};
+
+	test("Flat decoding refuses truncated rows") = [&nested] {
+		const auto encoded = FlatValue::encode(nested);
+		expect(not FlatValue::decode(std::string_view(encoded).substr(0, encoded.size() - 3), 0).has_value());
+		expect(not FlatValue::isFlat(std::string_view("\x0a\x03", 2)));
+	};
+};
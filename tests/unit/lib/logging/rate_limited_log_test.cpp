@@ -0,0 +1,36 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/di/container.hpp"
+#include "lib/logging/in_memory_logger.hpp"
+
+using namespace boost::ut;
+
+suite<"lib"> rateLimitedLogTest = [] {
+	test("Rate limited warnings drop the burst overflow and count it") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+		auto &logger = dynamic_cast<InMemoryLogger &>(injector.create<Logger &>());
+
+		LogRateLimiter limiter { 2, std::chrono::milliseconds(50) };
+		for (int i = 0; i < 5; ++i) {
+			logger.warn(limiter, "warning {}", i);
+		}
+		expect(eq(2, logger.logCount()) >> fatal);
+		expect(eq(std::string { "warning 1" }, logger.logs[1].message));
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(60));
+		logger.warn(limiter, "warning {}", 5);
+		expect(eq(3, logger.logCount()) >> fatal);
+		expect(eq(std::string { "warning 5 (3 similar messages suppressed)" }, logger.logs[2].message));
+	};
+};
@@ -0,0 +1,49 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "security/xtea.hpp"
+
+using namespace boost::ut;
+
+suite<"security"> xteaTest = [] {
+	const xtea::key_type key = { 0x01234567, 0x89ABCDEF, 0xFEDCBA98, 0x76543210 };
+
+	// Covers the scalar remainder after every vector width, with an unaligned start
+	auto makeBuffer = [](size_t length) {
+		std::vector<uint8_t> buffer(length + 1);
+		for (size_t i = 0; i < buffer.size(); ++i) {
+			buffer[i] = static_cast<uint8_t>(i * 131 + 7);
+		}
+		return buffer;
+	};
+
+	for (size_t length : { 0, 8, 24, 32, 40, 64, 72, 120, 1024 }) {
+		test(fmt::format("XTEA encrypt matches the scalar path for {} bytes", length)) = [&] {
+			auto expected = makeBuffer(length);
+			auto actual = expected;
+			xtea::encryptScalar(expected.data() + 1, length, xtea::expandEncryptKeys(key));
+			xtea::encrypt(actual.data() + 1, length, xtea::expandEncryptKeys(key));
+			expect(expected == actual);
+		};
+
+		test(fmt::format("XTEA decrypt reverses encrypt for {} bytes", length)) = [&] {
+			const auto original = makeBuffer(length);
+			auto buffer = original;
+			xtea::encrypt(buffer.data() + 1, length, xtea::expandEncryptKeys(key));
+			auto expected = buffer;
+			xtea::decryptScalar(expected.data() + 1, length, xtea::expandDecryptKeys(key));
+			xtea::decrypt(buffer.data() + 1, length, xtea::expandDecryptKeys(key));
+			expect(expected == buffer);
+			expect(original == buffer);
+		};
+	}
+};
@@ -0,0 +1,21 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/admin/admin_http.hpp"
+
+using namespace boost::ut;
+
+suite<"server"> adminHttpTest = [] {
+	test("AdminHttpServer::parseQuery decodes the parameters") = [] {
+		const auto params = AdminHttpServer::parseQuery("player=Some+Name%21&limit=5&flag");
+		expect(params.at("player") == "Some Name!");
+		expect(params.at("limit") == "5");
+		expect(params.contains("flag") && params.at("flag").empty());
+	};
+
+	test("AdminHttpServer::parseQuery keeps a truncated escape as is") = [] {
+		const auto params = AdminHttpServer::parseQuery("name=abc%2");
+		expect(params.at("name") == "abc%2");
+	};
+};
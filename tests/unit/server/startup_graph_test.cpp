@@ -0,0 +1,50 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/startup_graph.hpp"
+
+using namespace boost::ut;
+
+suite<"server"> startupGraphTest = [] {
+	test("StartupGraph runs the phases in order when serial") = [] {
+		StartupGraph startup;
+		std::vector<std::string> order;
+		startup.add("first", {}, StartupGraph::Thread::Background, [&order] { order.emplace_back("first"); });
+		startup.add("second", {}, StartupGraph::Thread::Dispatcher, [&order] { order.emplace_back("second"); });
+		startup.add("third", { "first" }, StartupGraph::Thread::Dispatcher, [&order] { order.emplace_back("third"); });
+		startup.run(false);
+		expect(order == std::vector<std::string> { "first", "second", "third" });
+	};
+
+	test("StartupGraph waits for the background dependencies") = [] {
+		StartupGraph startup;
+		std::atomic<bool> loaded = false;
+		bool seen = false;
+		startup.add("file", {}, StartupGraph::Thread::Background, [&loaded] {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			loaded = true;
+		});
+		startup.add("parsed", { "file" }, StartupGraph::Thread::Background, [&loaded, &seen] { seen = loaded; });
+		startup.add("scripts", { "parsed" }, StartupGraph::Thread::Dispatcher, [&loaded, &seen] { seen = seen && loaded; });
+		startup.run(true);
+		expect(seen);
+		expect(startup.getReport().find("background") != std::string::npos);
+	};
+
+	test("StartupGraph rethrows the failure of a background phase") = [] {
+		StartupGraph startup;
+		bool ran = false;
+		startup.add("file", {}, StartupGraph::Thread::Background, [] { throw std::runtime_error("missing"); });
+		startup.add("scripts", { "file" }, StartupGraph::Thread::Dispatcher, [&ran] { ran = true; });
+		expect(throws<std::runtime_error>([&startup] { startup.run(true); }));
+		expect(!ran);
+	};
+
+	test("StartupGraph rejects a dependency added after the phase") = [] {
+		StartupGraph startup;
+		expect(throws<std::invalid_argument>([&startup] {
+			startup.add("scripts", { "file" }, StartupGraph::Thread::Dispatcher, [] { });
+		}));
+	};
+};
@@ -0,0 +1,34 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/indexed_set.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> indexedSetTest = [] {
+	test("IndexedSet keeps the values reachable by index after an erase") = [] {
+		IndexedSet<uint32_t> set;
+		expect(set.insert(10));
+		expect(set.insert(20));
+		expect(set.insert(30));
+		expect(!set.insert(20));
+
+		expect(set.erase(10));
+		expect(!set.erase(10));
+		expect(set.size() == 2_ul);
+		expect(!set.contains(10));
+
+		std::vector<uint32_t> values;
+		for (size_t i = 0; i < set.size(); ++i) {
+			values.push_back(set.at(i));
+		}
+		std::ranges::sort(values);
+		expect(values == std::vector<uint32_t> { 20, 30 });
+
+		// The moved value must still be erasable through its new index
+		expect(set.erase(30));
+		expect(set.size() == 1_ul);
+		expect(set.at(0) == 20_u);
+	};
+};
@@ -0,0 +1,57 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/tools.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> randomGeneratorTest = [] {
+	test("RandomGenerator repeats its sequence for a seed") = [] {
+		RandomGenerator first(42);
+		RandomGenerator second(42);
+		for (int i = 0; i < 100; ++i) {
+			expect(eq(first(), second()));
+		}
+		RandomGenerator other(43);
+		expect(neq(RandomGenerator(42)(), other()));
+	};
+
+	test("RandomGenerator::nextBelow stays below the bound") = [] {
+		RandomGenerator generator(7);
+		std::array<uint32_t, 3> counts {};
+		for (int i = 0; i < 3000; ++i) {
+			const auto value = generator.nextBelow(3);
+			expect(lt(value, 3u) >> fatal);
+			++counts[value];
+		}
+		for (const auto count : counts) {
+			expect(gt(count, 800u));
+		}
+	};
+
+	test("uniform_random and uniform_random_fill stay within the bounds") = [] {
+		seedRandomGenerators(1);
+		expect(eq(5, uniform_random(5, 5)));
+		for (int i = 0; i < 1000; ++i) {
+			const auto value = uniform_random(10, -10);
+			expect(ge(value, -10) and le(value, 10));
+		}
+
+		std::array<int32_t, 64> values {};
+		uniform_random_fill(values, 1, 6);
+		expect(std::ranges::all_of(values, [](int32_t value) { return value >= 1 && value <= 6; }));
+		const auto full = uniform_random(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max());
+		expect(ge(full, std::numeric_limits<int32_t>::min()));
+	};
+
+	test("seedRandomGenerators makes the rolls repeat") = [] {
+		seedRandomGenerators(1234);
+		std::array<int32_t, 16> first {};
+		uniform_random_fill(first, 0, 10000);
+		seedRandomGenerators(1234);
+		std::array<int32_t, 16> second {};
+		uniform_random_fill(second, 0, 10000);
+		expect(first == second);
+	};
+};
@@ -0,0 +1,35 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/stringpool.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> stringPoolTest = [] {
+	test("StringPool shares one copy of equal strings") = [] {
+		StringPool pool;
+		const auto first = pool.intern("Dear diary");
+		const auto second = pool.intern(std::string("Dear ") + "diary");
+		expect(first == second);
+		expect(eq(std::string("Dear diary"), *first));
+		expect(eq(size_t { 1 }, pool.size()));
+	};
+
+	test("StringPool drops a string with its last handle") = [] {
+		StringPool pool;
+		auto handle = pool.intern("label");
+		auto copy = handle;
+		handle.reset();
+		expect(eq(size_t { 1 }, pool.size()));
+		copy.reset();
+		expect(eq(size_t { 0 }, pool.size()));
+		expect(eq(std::string("label"), *pool.intern("label")));
+	};
+
+	test("StringPool keeps the empty string out of the pool") = [] {
+		StringPool pool;
+		expect(pool.intern("")->empty());
+		expect(eq(size_t { 0 }, pool.size()));
+	};
+};
@@ -0,0 +1,37 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/wildcardtree.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> wildcardTreeTest = [] {
+	test("WildcardTree completes the only name starting with the query") = [] {
+		WildcardTree tree;
+		tree.insert("knight");
+		tree.insert("druid");
+
+		std::string result;
+		expect(eq(RETURNVALUE_NOERROR, tree.findOne("kn", result)));
+		expect(eq(std::string("knight"), result));
+		expect(eq(RETURNVALUE_NOERROR, tree.findOne("druid", result)));
+		expect(eq(std::string("druid"), result));
+	};
+
+	test("WildcardTree reports ambiguous and missing names") = [] {
+		WildcardTree tree;
+		tree.insert("bob");
+		tree.insert("bobby");
+		tree.insert("alice");
+
+		std::string result;
+		expect(eq(RETURNVALUE_NAMEISTOOAMBIGUOUS, tree.findOne("bo", result)));
+		expect(eq(RETURNVALUE_NAMEISTOOAMBIGUOUS, tree.findOne("bob", result)));
+		expect(eq(RETURNVALUE_PLAYERWITHTHISNAMEISNOTONLINE, tree.findOne("carl", result)));
+
+		tree.remove("bobby");
+		expect(eq(RETURNVALUE_NOERROR, tree.findOne("bo", result)));
+		expect(eq(std::string("bob"), result));
+	};
+};